@@ -190,6 +190,39 @@ endif()
 # =========== OpenMP ==========
 option(WITH_OPENMP "Use OpenMP" OFF)
 
+# =========== per-step allocation tracking ==========
+# Replaces the global operator new in the kernel by a recording version
+# so that performance tests can assert that the steady state of a
+# simulation step allocates nothing. See SiconosAllocationTracker.hpp.
+option(WITH_ALLOCATION_TRACKING "Track kernel allocations per simulation step" OFF)
+
+# =========== runtime simd dispatch ==========
+# Compiles the batched numerics kernels once per instruction set (object
+# libraries in numerics/CMakeLists.txt) and selects a variant at runtime
+# from the host cpu, so a single binary runs with the best kernels
+# everywhere. See SiconosCpuFeatures.h.
+option(WITH_SIMD_DISPATCH "Build per-instruction-set kernel variants with runtime cpu dispatch" OFF)
+
+# =========== binary solver tracing ==========
+# Compiles in the SN_TRACE points of the numerics solvers: binary event
+# records (solver id, iteration, residual) go to per-thread ring buffers
+# drained in the background, activated at run time by setting
+# SICONOS_TRACE_FILE. See NumericsTrace.h and the numerics_trace_decoder
+# tool.
+option(WITH_NUMERICS_TRACE "Compile in the binary trace points of the numerics solvers" OFF)
+
+if(WITH_SIMD_DISPATCH)
+  include(CheckCCompilerFlag)
+  check_c_compiler_flag("-mavx2 -mfma" C_COMPILER_HAS_AVX2)
+  check_c_compiler_flag("-mavx512f -mavx512dq" C_COMPILER_HAS_AVX512)
+  if(C_COMPILER_HAS_AVX2)
+    set(SICONOS_HAS_AVX2_KERNELS TRUE)
+  endif()
+  if(C_COMPILER_HAS_AVX512)
+    set(SICONOS_HAS_AVX512_KERNELS TRUE)
+  endif()
+endif()
+
 # =========== use ccache if available ===========
 option(WITH_CCACHE "Use ccache" OFF)
 if(WITH_CCACHE)
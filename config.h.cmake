@@ -25,6 +25,14 @@ Example : if cmake is executed with WITH_MPI=ON
 // -- Global options --
 // openmp required and available -
 #cmakedefine WITH_OPENMP
+// per-step allocation tracking in the kernel (developers) -
+#cmakedefine WITH_ALLOCATION_TRACKING
+// runtime cpu dispatch of the batched numerics kernels -
+#cmakedefine WITH_SIMD_DISPATCH
+// binary trace points in the numerics solvers (developers) -
+#cmakedefine WITH_NUMERICS_TRACE
+#cmakedefine SICONOS_HAS_AVX2_KERNELS
+#cmakedefine SICONOS_HAS_AVX512_KERNELS
 // Fortran sources included in the build -
 #cmakedefine HAS_FORTRAN
 // Use c++ to build externals and numerics
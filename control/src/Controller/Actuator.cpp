@@ -18,6 +18,7 @@
 
 #include "SiconosException.hpp"
 #include "Actuator.hpp"
+#include "SimpleMatrix.hpp"
 #include "ActuatorEvent.hpp"
 #include "ControlSensor.hpp"
 #include "TimeDiscretisation.hpp"
@@ -46,6 +47,22 @@ Actuator::~Actuator()
 {
 }
 
+SP::SimpleMatrix Actuator::compressedGain(SP::SimpleMatrix M)
+{
+  if(!M || M->num() == Siconos::SPARSE)
+    return M;
+
+  SP::SimpleMatrix sp(new SimpleMatrix(M->size(0), M->size(1), Siconos::SPARSE));
+  for(unsigned int i = 0; i < M->size(0); ++i)
+    for(unsigned int j = 0; j < M->size(1); ++j)
+    {
+      double value = M->getValue(i, j);
+      if(value != 0.0)
+        sp->setValue(i, j, value);
+    }
+  return sp;
+}
+
 void Actuator::addSensorPtr(SP::ControlSensor newSensor)
 {
   _sensor = newSensor;
@@ -58,6 +75,9 @@ void Actuator::initialize(const NonSmoothDynamicalSystem& nsds, const Simulation
     THROW_EXCEPTION("Actuator::initialize - No Sensor given to the Actuator");
   }
 
+  if(_sparseGains)
+    _B = compressedGain(_B);
+
   // Init the control variable and add the necessary properties
   DynamicalSystemsGraph& DSG0 = *nsds.topology()->dSG(0);
   DynamicalSystemsGraph::VDescriptor dsgVD = DSG0.descriptor(_sensor->getDS());
@@ -96,6 +96,10 @@ protected:
   /** B Matrix */
   SP::SimpleMatrix _B;
 
+  /** when true, the gain matrices are compressed to sparse storage at
+   *  initialization and applied as sparse matrix-vector products */
+  bool _sparseGains = false;
+
   /** name of the plugin for g (nonlinear affine in control system)*/
   std::string _plugingName;
 
@@ -109,6 +113,15 @@ protected:
    */
   Actuator();
 
+  /** Copy a gain matrix into sparse storage, so that applying it goes
+   *  through the sparse matrix-vector product.
+   *
+   *  \param M the gain matrix, may be nullptr or already sparse
+   *  \return a sparse-storage copy of M (M itself when there is
+   *  nothing to do)
+   */
+  static SP::SimpleMatrix compressedGain(SP::SimpleMatrix M);
+
 public:
 
   /** General Constructor
@@ -177,6 +190,25 @@ public:
     _B = B;
   };
 
+  /** Store the gain matrices in sparse form at initialization.
+   *
+   *  Worth enabling when B (and the gains of the derived actuators) are
+   *  mostly-zero selection matrices: the control is then applied with
+   *  sparse matrix-vector products instead of dense ones.
+   *
+   *  \param b true to compress the gains at initialization
+   */
+  inline void setSparseGains(bool b)
+  {
+    _sparseGains = b;
+  };
+
+  /** \return true when the gain matrices are stored in sparse form */
+  inline bool sparseGains() const
+  {
+    return _sparseGains;
+  };
+
   /** Set the name of the plugin for computing g
    *
    *  \param g the name of the plugin to compute g
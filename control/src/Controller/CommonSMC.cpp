@@ -203,6 +203,11 @@ void CommonSMC::initialize(const NonSmoothDynamicalSystem & nsds, const Simulati
     prod(*_Csurface, *_B, *tmpM);
     InvertMatrix(*tmpM->dense(), *_invCB->dense());
   }
+
+  // the sliding surface is usually a sparse selection of the state: with
+  // sparse gains enabled, sigma and ueq are computed with sparse products
+  if(_sparseGains)
+    _Csurface = compressedGain(_Csurface);
   DEBUG_END("CommonSMC::initialize(const NonSmoothDynamicalSystem & nsds, const Simulation & s)\n");
 }
 
@@ -213,17 +218,29 @@ void CommonSMC::computeUeq()
   assert(_Csurface && "CommonSMC::computeUeq the sliding variable should be linear subpsace of the state");
   FirstOrderLinearDS& LinearDS_SMC = *std::static_pointer_cast<FirstOrderLinearDS>(_DS_SMC);
   unsigned int n = LinearDS_SMC.A()->size(1);
-  // equivalent part, explicit contribution
-  SP::SimpleMatrix tmpM1(new SimpleMatrix(_Csurface->size(0), n));
-  SP::SimpleMatrix tmpN(new SimpleMatrix(n, n));
-  SP::SimpleMatrix quasiProjB_A(new SimpleMatrix(_invCB->size(0), n));
-  SP::SimpleMatrix tmpW(new SimpleMatrix(n, n, 0));
-  SP::SiconosVector xTk(new SiconosVector(_sensor->y()));
-  tmpW->eye();
-  prod(*_Csurface, *LinearDS_SMC.A(), *tmpM1);
+  // equivalent part, explicit contribution; the workspace survives the
+  // call so that the per-sample chain does not allocate
+  if(!_workCA)
+  {
+    _workCA.reset(new SimpleMatrix(_Csurface->size(0), n));
+    _workBd.reset(new SimpleMatrix(n, n));
+    _quasiProjB_A.reset(new SimpleMatrix(_invCB->size(0), n));
+    _workW.reset(new SimpleMatrix(n, n, 0));
+    _xTk.reset(new SiconosVector(n));
+  }
+  SimpleMatrix& tmpM1 = *_workCA;
+  SimpleMatrix& tmpN = *_workBd;
+  SimpleMatrix& quasiProjB_A = *_quasiProjB_A;
+  SimpleMatrix& tmpW = *_workW;
+  SiconosVector& xTk = *_xTk;
+  xTk = _sensor->y();
+  tmpW.zero();
+  tmpW.resetFactorizationFlags();
+  tmpW.eye();
+  prod(*_Csurface, *LinearDS_SMC.A(), tmpM1);
   // compute (CB)^{-1}CA
-  prod(*_invCB, *tmpM1, *quasiProjB_A);
-  prod(_thetaSMC-1, *quasiProjB_A, *xTk, *_ueq);
+  prod(*_invCB, tmpM1, quasiProjB_A);
+  prod(_thetaSMC-1, quasiProjB_A, xTk, *_ueq);
 
   // equivalent part, implicit contribution
   // XXX when to call this ?
@@ -231,17 +248,17 @@ void CommonSMC::computeUeq()
   zoh.updateMatrices(_DS_SMC);
 
   // tmpN = B^{*}(CB)^{-1}CA
-  prod(zoh.Bd(_DS_SMC), *quasiProjB_A, *tmpN, true);
+  prod(zoh.Bd(_DS_SMC), quasiProjB_A, tmpN, true);
   // W = I + \theta B^{*})CB)^{-1}CA
-  scal(_thetaSMC, *tmpN, *tmpW, false);
+  scal(_thetaSMC, tmpN, tmpW, false);
   // compute e^{Ah}x_k
-  prod(zoh.Ad(_DS_SMC), *xTk, *xTk);
+  prod(zoh.Ad(_DS_SMC), xTk, xTk);
   // xTk = (e^{Ah}-(1-\theta)\Psi_k\Pi_B A)x_k
-  prod(_thetaSMC-1, *tmpN, _sensor->y(), *xTk, false);
+  prod(_thetaSMC-1, tmpN, _sensor->y(), xTk, false);
   // compute the solution x_{k+1} of the system W*x_{k+1} = x_k
-  tmpW->Solve(*xTk);
+  tmpW.Solve(xTk);
   // add the contribution from the implicit part to ueq
-  prod(-_thetaSMC, *quasiProjB_A, *xTk, *_ueq, false);
+  prod(-_thetaSMC, quasiProjB_A, xTk, *_ueq, false);
   DEBUG_END("void CommonSMC::computeUeq()\n");
 
 }
@@ -110,6 +110,14 @@ protected:
   /** inverse of CB */
   SP::SimpleMatrix _invCB;
 
+  /** workspace of computeUeq, allocated on the first call so that the
+   *  per-sample control computation does not allocate */
+  SP::SimpleMatrix _workCA;
+  SP::SimpleMatrix _workBd;
+  SP::SimpleMatrix _workW;
+  SP::SimpleMatrix _quasiProjB_A;
+  SP::SiconosVector _xTk;
+
   /** Store  \f$ u^{eq} \f$  */
   SP::SiconosVector _ueq;
 
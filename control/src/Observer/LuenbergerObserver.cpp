@@ -124,6 +124,22 @@ void LuenbergerObserver::process()
 {
   if(!_pass)
     _pass = true;
+  else if(_asynchronous)
+  {
+    // the step handed over at the previous sample had the whole sampling
+    // interval to complete: the estimate is one sample stale, the
+    // integration is off the critical path
+    waitForStep();
+
+    *_xHat = _DS->getx();
+
+    prod(*_C, *_xHat, *_e); // e = C*xhat_k
+    *_e -= *_y; // e -= y_k
+
+    // publish the fresh measurement and integrate between samples
+    *_y = _sensor->y();
+    launchStep();
+  }
   else
   {
     prod(*_C, *_xHat, *_e); // e = C*xhat_k
@@ -135,7 +151,7 @@ void LuenbergerObserver::process()
     const SiconosVector& y = _sensor->y();
 
     // TODO theta method on the error
-    _simulation->computeOneStep();
+    integrateStep();
 //    _simulation->nextStep();
 
     // update the current measured value
@@ -20,6 +20,7 @@
 #include "ObserverEvent.hpp"
 #include "TimeDiscretisation.hpp"
 #include "Simulation.hpp"
+#include "TimeStepping.hpp"
 #include "EventsManager.hpp"
 #include <iostream>
 
@@ -42,6 +43,64 @@ Observer::Observer(unsigned int type, SP::ControlSensor sensor, const SiconosVec
 
 Observer::~Observer()
 {
+  stopWorker();
+}
+
+void Observer::integrateStep()
+{
+  _simulation->computeOneStep();
+}
+
+void Observer::setAsynchronous(bool asynchronous)
+{
+  if(!asynchronous)
+    stopWorker();
+  _asynchronous = asynchronous;
+}
+
+void Observer::launchStep()
+{
+  std::unique_lock<std::mutex> lock(_workerMutex);
+  if(!_workerThread.joinable())
+  {
+    _workerThread = std::thread([this]()
+    {
+      std::unique_lock<std::mutex> workerLock(_workerMutex);
+      while(true)
+      {
+        _workerCond.wait(workerLock, [this]() { return _workerStepPending || _workerExit; });
+        if(_workerExit)
+          return;
+        workerLock.unlock();
+        integrateStep();
+        workerLock.lock();
+        _workerStepPending = false;
+        _workerCond.notify_all();
+      }
+    });
+  }
+  _workerStepPending = true;
+  _workerCond.notify_all();
+}
+
+void Observer::waitForStep()
+{
+  std::unique_lock<std::mutex> lock(_workerMutex);
+  _workerCond.wait(lock, [this]() { return !_workerStepPending; });
+}
+
+void Observer::stopWorker()
+{
+  {
+    std::unique_lock<std::mutex> lock(_workerMutex);
+    // let an in-flight step finish before asking the worker to return
+    _workerCond.wait(lock, [this]() { return !_workerStepPending; });
+    _workerExit = true;
+    _workerCond.notify_all();
+  }
+  if(_workerThread.joinable())
+    _workerThread.join();
+  _workerExit = false;
 }
 
 void Observer::initialize(const NonSmoothDynamicalSystem& nsds, const Simulation& s)
@@ -25,6 +25,9 @@
 
 #include <string>
 #include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "SiconosException.hpp"
 #include "SiconosPointers.hpp"
 
@@ -85,6 +88,47 @@ protected:
   /** Integration for integration */
   SP::OneStepIntegrator _integrator;
 
+  /** true: the internal simulation advances on a worker thread between
+      samples, using the last published measurement; the estimate read at
+      actuation time is then one sample staler than in the synchronous
+      mode, but the integration leaves the critical path of the control
+      step */
+  bool _asynchronous = false;
+
+  /** a step has been handed to the worker and is not known finished yet */
+  bool _workerStepPending = false;
+
+  /** ask the worker to return */
+  bool _workerExit = false;
+
+  /** worker advancing the internal simulation in asynchronous mode */
+  std::thread _workerThread;
+
+  /** protects the worker flags */
+  std::mutex _workerMutex;
+
+  /** signals new steps to the worker and completions to waitForStep */
+  std::condition_variable _workerCond;
+
+  /** advance the internal simulation by one step; the default is a plain
+      computeOneStep(), derived classes override it when their per-sample
+      integration is richer.  In asynchronous mode this runs on the worker
+      thread, between samples, so it must only touch the internal
+      simulation and the vectors published at the previous handoff. */
+  virtual void integrateStep();
+
+  /** hand one integrateStep() to the worker (started on first use) */
+  void launchStep();
+
+  /** block until the step handed over at the previous sample is done;
+      this bounds the staleness of the estimate to one sample, and the
+      step had the whole sampling interval to complete so the wait is
+      normally free */
+  void waitForStep();
+
+  /** stop and join the worker; called by the destructor */
+  void stopWorker();
+
   /** default constructor
    */
   Observer();
@@ -192,6 +236,20 @@ public:
    */
   virtual SP::NonSmoothDynamicalSystem getInternalNSDS() const { return _nsds; };
 
+  /** enable or disable the asynchronous mode: the internal simulation
+   *  then advances on a worker thread between samples and process() only
+   *  performs the measurement/estimate handoff
+   *
+   *  \param asynchronous true to integrate off the critical path
+   */
+  void setAsynchronous(bool asynchronous);
+
+  /** \return true if the observer integrates on a worker thread */
+  inline bool asynchronous() const
+  {
+    return _asynchronous;
+  };
+
 };
 
 #endif
@@ -122,6 +122,30 @@ void SlidingReducedOrderObserver::initialize(const NonSmoothDynamicalSystem& nsd
   DEBUG_END(" SlidingReducedOrderObserver::initialize(const NonSmoothDynamicalSystem& nsds, const Simulation& s)\n");
 }
 
+void SlidingReducedOrderObserver::integrateStep()
+{
+  // First pass, set _e to 0, integrate the system
+  // and get the innovation term
+  _e->zero();
+  _simulation->computeOneStep();
+
+  // e = C*xhat_{k+1} - y_{k+1}
+  prod(*_C, _DS->getx(), *_e);
+  *_e -= *_y;
+
+  // Second pass, now we update the state
+  //
+  // But first we need to reset the state to the
+  // previous value (at t_k)
+  DEBUG_EXPR(_DS->xMemory().display(););
+  _DS->setX(_DS->xMemory().getSiconosVector(0));
+  // integrate with the new innovation term
+  _simulation->computeOneStep();
+
+  // We can go one step forward
+  _simulation->nextStep();
+}
+
 void SlidingReducedOrderObserver::process()
 {
   DEBUG_BEGIN("void SlidingReducedOrderObserver::process()\n");
@@ -148,6 +172,20 @@ void SlidingReducedOrderObserver::process()
     DEBUG_EXPR(_DS->display(););
     DEBUG_EXPR(_DS->xMemory().display(););
   }
+  else if(_asynchronous)
+  {
+    DEBUG_PRINT("Second pass (asynchronous)\n");
+    // the two-pass integration handed over at the previous sample had the
+    // whole sampling interval to complete: the estimate is one sample
+    // stale, the integration is off the critical path
+    waitForStep();
+
+    *_xHat = _DS->getx();
+
+    // publish the fresh measurement and integrate between samples
+    *_y = _sensor->y();
+    launchStep();
+  }
   else
   {
     DEBUG_PRINT("Second pass\n");
@@ -166,26 +204,7 @@ void SlidingReducedOrderObserver::process()
 //
 //    tmpC.SolveByLeastSquares(tmpV);
 //    *(_DS->x()) -= tmpV;
-    // First pass, set _e to 0, integrate the system
-    // and get the innovation term
-    _e->zero();
-    _simulation->computeOneStep();
-
-    // e = C*xhat_{k+1} - y_{k+1}
-    prod(*_C, _DS->getx(), *_e);
-    *_e -= *_y;
-
-    // Second pass, now we update the state
-    //
-    // But first we need to reset the state to the
-    // previous value (at t_k)
-    DEBUG_EXPR(_DS->xMemory().display(););
-    _DS->setX(_DS->xMemory().getSiconosVector(0));
-    // integrate with the new innovation term
-    _simulation->computeOneStep();
-
-    // We can go one step forward
-    _simulation->nextStep();
+    integrateStep();
 
     *_xHat = _DS->getx();
   }
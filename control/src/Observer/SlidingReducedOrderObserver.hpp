@@ -48,6 +48,12 @@ protected:
   // clumsy hack to do nothing the first time this Observer is called
   bool _pass;
 
+  /** two-pass integration of one sample: a first step with a zero
+   *  innovation to compute it, a rewind to \f$ t_k \f$ and a second step
+   *  with the new innovation; runs on the worker thread in asynchronous
+   *  mode */
+  virtual void integrateStep();
+
 public:
 
   /** Constructor with the standard interface
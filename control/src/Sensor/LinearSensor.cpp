@@ -86,6 +86,19 @@ void LinearSensor::capture()
     _bufferY.push_back(_storedY);
   }
 }
+void LinearSensor::storeCapturedY(const SiconosVector& y, unsigned int start)
+{
+  setBlock(y, _storedY, _storedY->size(), start, 0);
+  // same bookkeeping as capture()
+  if(_matD)
+    _k++;
+
+  if(_delay > 0)
+  {
+    _bufferY.push_back(_storedY);
+  }
+}
+
 void  LinearSensor::setC(const SimpleMatrix& C)
 {
   *_matC = C;
@@ -82,6 +82,23 @@ public:
    */
   void capture();
 
+  /** Store an output value computed by the batched capture path of the
+   *  ControlManager, with the same bookkeeping as capture()
+   *
+   *  \param y the stacked output of the batched observation operator
+   *  \param start the row where the output of this sensor starts in y
+   */
+  void storeCapturedY(const SiconosVector& y, unsigned int start);
+
+  /** Get the C matrix
+   *
+   *  \return a SP::SimpleMatrix
+   */
+  inline SP::SimpleMatrix C() const
+  {
+    return _matC;
+  };
+
   /** Set the C matrix.
    *
    *  \param C a SimpleMatrix
@@ -87,4 +87,5 @@ void ControlLsodarSimulation::run()
   std::chrono::duration<double, std::milli> fp_s = end - start;
   _elapsedTime = fp_s.count();
   _dataM->resize(k, _nDim + 1);
+  flushAsyncOutput();
 }
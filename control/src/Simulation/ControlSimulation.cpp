@@ -159,6 +159,28 @@ void ControlSimulation::storeData(unsigned indx)
       }
     }
   }
+
+  if(_asyncWriter)
+  {
+    _asyncWriter->push(*_dataM, indx);
+  }
+}
+
+void ControlSimulation::enableAsyncOutput(const std::string& filename, unsigned decimation)
+{
+  if(!_dataM)
+  {
+    THROW_EXCEPTION("enableAsyncOutput must be called after initialize()");
+  }
+  _asyncWriter.reset(new AsyncDataWriter(filename, _nDim + 1, decimation));
+}
+
+void ControlSimulation::flushAsyncOutput()
+{
+  if(_asyncWriter)
+  {
+    _asyncWriter->flush();
+  }
 }
 
 
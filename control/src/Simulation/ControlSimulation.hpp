@@ -31,6 +31,8 @@
 
 #include <string>
 
+class AsyncDataWriter;
+
 class ControlSimulation
 {
 private:
@@ -81,6 +83,9 @@ protected:
   /** Legend for the columns in the matrix _dataM*/
   std::string _dataLegend;
 
+  /** Background writer streaming the saved rows to disk (may be null)*/
+  std::shared_ptr<AsyncDataWriter> _asyncWriter;
+
   /** NonSmoothDynamicalSystem */
   SP::NonSmoothDynamicalSystem _nsds;
 
@@ -144,6 +149,23 @@ public:
    */
   void storeData(unsigned indx);
 
+  /** Stream the saved rows to a file while the simulation runs.  Each
+   * call to storeData also hands the freshly filled row of _dataM to a
+   * background thread which appends it to the file (in the "noDim"
+   * ascii format of ioMatrix), so the stepping thread never waits on
+   * disk IO.  Must be called after initialize().
+   * \param filename the output file, truncated on opening
+   * \param decimation write only one row out of decimation (default 1,
+   * i.e. every row)
+   */
+  void enableAsyncOutput(const std::string& filename, unsigned decimation = 1);
+
+  /** Wait until every row saved so far has reached the output file.
+   * Called at the end of run(); calling it during the simulation gives
+   * a consistent on-disk snapshot.
+   */
+  void flushAsyncOutput();
+
   /** Return the Simulation
    * \return the simulation for the main simulation
   */
@@ -23,13 +23,120 @@
 #ifndef ControlSimulation_impl_hpp
 #define ControlSimulation_impl_hpp
 
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "SimulationTypeDef.hpp"
+#include "SimpleMatrix.hpp"
+#include "SiconosException.hpp"
 
 #include <SiconosConfig.h>
 #define TO_STR(x) std::to_string(x)
 
+/** Double-buffered writer draining the saved simulation rows to disk.
+ *
+ * The stepping thread appends rows to the front buffer under a short
+ * lock (a plain copy, no IO); a background thread swaps the buffers and
+ * streams the back buffer to the file. The stepping thread therefore
+ * never waits on disk IO: if the writer falls behind, the front buffer
+ * simply grows until the writer catches up.
+ */
+class AsyncDataWriter
+{
+public:
+  /** \param filename the output file (truncated on opening); one line per
+   * row, in the "noDim" ascii format of ioMatrix
+   * \param rowSize number of columns of a row
+   * \param decimation keep one row out of decimation
+   */
+  AsyncDataWriter(const std::string& filename, unsigned rowSize, unsigned decimation):
+    _rowSize(rowSize), _decimation(decimation > 0 ? decimation : 1), _counter(0),
+    _draining(false), _done(false), _outfile(filename.c_str(), std::ofstream::out)
+  {
+    if(!_outfile.good())
+      THROW_EXCEPTION("AsyncDataWriter: cannot open file " + filename);
+    _outfile.precision(15);
+    _outfile.setf(std::ios::scientific);
+    _writer = std::thread(&AsyncDataWriter::drain, this);
+  }
+
+  ~AsyncDataWriter()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _done = true;
+    }
+    _dataReady.notify_one();
+    _writer.join();
+  }
+
+  /** enqueue row indx of data; called from the stepping thread */
+  void push(const SimpleMatrix& data, unsigned indx)
+  {
+    if(_counter++ % _decimation != 0)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::size_t pos = _front.size();
+      _front.resize(pos + _rowSize);
+      for(unsigned j = 0; j < _rowSize; ++j)
+        _front[pos + j] = data(indx, j);
+    }
+    _dataReady.notify_one();
+  }
+
+  /** block until every enqueued row has reached the file */
+  void flush()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _rowsWritten.wait(lock, [this] { return _front.empty() && !_draining; });
+    _outfile.flush();
+  }
+
+private:
+  /** body of the writer thread */
+  void drain()
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(!_front.empty() || !_done)
+    {
+      _dataReady.wait(lock, [this] { return !_front.empty() || _done; });
+      if(_front.empty())
+        continue;
+      _back.clear();
+      _back.swap(_front);
+      _draining = true;
+      lock.unlock();
+      for(std::size_t pos = 0; pos < _back.size(); pos += _rowSize)
+      {
+        for(unsigned j = 0; j < _rowSize; ++j)
+          _outfile << _back[pos + j] << " ";
+        _outfile << std::endl;
+      }
+      lock.lock();
+      _draining = false;
+      _rowsWritten.notify_all();
+    }
+  }
+
+  unsigned _rowSize;
+  unsigned _decimation;
+  unsigned _counter;
+  bool _draining;
+  bool _done;
+  std::ofstream _outfile;
+  std::vector<double> _front;
+  std::vector<double> _back;
+  std::mutex _mutex;
+  std::condition_variable _dataReady;
+  std::condition_variable _rowsWritten;
+  std::thread _writer;
+};
+
 static inline std::pair<unsigned, std::string> getNumberOfStates(DynamicalSystemsGraph& DSG0, InteractionsGraph& IG0)
 {
   std::string legend;
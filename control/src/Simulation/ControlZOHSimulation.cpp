@@ -90,5 +90,6 @@ void ControlZOHSimulation::run()
   _elapsedTime = fp_s.count();
 
   _dataM->resize(k, _nDim + 1);
+  flushAsyncOutput();
   DEBUG_END("void ControlZOHSimulation::run()\n");
 }
@@ -26,6 +26,9 @@ using namespace EventFactory;
 void ActuatorEvent::process(Simulation& sim)
 {
   _actuator->actuate();
+  for(std::vector<SP::Actuator>::iterator it = _coalescedActuators.begin();
+      it != _coalescedActuators.end(); ++it)
+    (*it)->actuate();
 }
 
 AUTO_REGISTER_EVENT(ACTUATOR_EVENT, ActuatorEvent)
@@ -25,6 +25,8 @@
 #include "SiconosControlFwd.hpp"
 #include "ControlTypeDef.hpp"
 
+#include <vector>
+
 /** Events when sensor data capture is done.
  *
  */
@@ -38,6 +40,11 @@ private:
   /** The actuator linked to the present event */
   SP::Actuator _actuator;
 
+  /** further actuators sharing this event, when the ControlManager
+   *  coalesces device scheduling: one event per (rate, phase) group
+   *  instead of one per device */
+  std::vector<SP::Actuator> _coalescedActuators;
+
   /** Default constructor */
   ActuatorEvent(): Event(0.0, ACTUATOR_EVENT, true) {};
 
@@ -69,7 +76,15 @@ public:
     _actuator = newActuator;
   };
 
-  /** Call the actuate method of the Actuator
+  /** add an Actuator to the group dispatched by this Event
+   *  \param newActuator the Actuator to add.
+   */
+  void addActuatorPtr(SP::Actuator newActuator)
+  {
+    _coalescedActuators.push_back(newActuator);
+  };
+
+  /** Call the actuate method of the Actuator(s)
    *  \param sim ignored argument.
    */
   void process(Simulation& sim);
@@ -25,6 +25,11 @@
 
 #include "ControlManager.hpp"
 #include "Sensor.hpp"
+#include "LinearSensor.hpp"
+#include "SimpleMatrix.hpp"
+#include "SiconosVector.hpp"
+#include "SiconosAlgebraProd.hpp"
+#include "DynamicalSystem.hpp"
 #include "SensorFactory.hpp"
 #include "ActuatorFactory.hpp"
 #include "Observer.hpp"
@@ -86,6 +91,18 @@ void ControlManager::initialize(const NonSmoothDynamicalSystem& nsds)
       (*itosi)->extraAdditionalTerms()->init(DSG0, nsds, _sim->eventsManager()->timeDiscretisation());
     }
   }
+
+  // When all the sensors fire in one coalesced group and all of them are
+  // covered by the batched capture, route the composite event through
+  // captureBatched(): one sparse product per sample instant.
+  if(_coalesceDeviceEvents && _sensorGroupEvents.size() == 1
+      && !_allSensors.empty())
+  {
+    buildBatchedCapture();
+    if(_batchSensors.size() == _allSensors.size())
+      static_cast<SensorEvent*>(_sensorGroupEvents.begin()->second)
+      ->setBatchedCaptureManager(this);
+  }
   DEBUG_END("ControlManager::initialize(const NonSmoothDynamicalSystem& nsds)\n");
 }
 
@@ -199,16 +216,42 @@ void ControlManager::addAndRecordObserverPtr(SP::Observer obs, SP::TimeDiscretis
 
 void ControlManager::linkSensorSimulation(SP::Sensor s, SP::TimeDiscretisation td)
 {
+  if(_coalesceDeviceEvents)
+  {
+    std::map<SP::TimeDiscretisation, Event*>::iterator it = _sensorGroupEvents.find(td);
+    if(it != _sensorGroupEvents.end())
+    {
+      // join the composite event of the (rate, phase) group
+      static_cast<SensorEvent*>(it->second)->addSensorPtr(s);
+      s->setTimeDiscretisation(*td);
+      return;
+    }
+  }
   Event& ev = _sim->eventsManager()->insertEvent(SENSOR_EVENT, td);
   static_cast<SensorEvent&>(ev).setSensorPtr(s);
   s->setTimeDiscretisation(*td);
+  if(_coalesceDeviceEvents)
+    _sensorGroupEvents[td] = &ev;
 }
 
 void ControlManager::linkActuatorSimulation(SP::Actuator act, SP::TimeDiscretisation td)
 {
+  if(_coalesceDeviceEvents)
+  {
+    std::map<SP::TimeDiscretisation, Event*>::iterator it = _actuatorGroupEvents.find(td);
+    if(it != _actuatorGroupEvents.end())
+    {
+      // join the composite event of the (rate, phase) group
+      static_cast<ActuatorEvent*>(it->second)->addActuatorPtr(act);
+      act->setTimeDiscretisation(*td);
+      return;
+    }
+  }
   Event& ev = _sim->eventsManager()->insertEvent(ACTUATOR_EVENT, td);
   static_cast<ActuatorEvent&>(ev).setActuatorPtr(act);
   act->setTimeDiscretisation(*td);
+  if(_coalesceDeviceEvents)
+    _actuatorGroupEvents[td] = &ev;
 }
 
 void ControlManager::linkObserverSimulation(SP::Observer obs, SP::TimeDiscretisation td)
@@ -218,6 +261,90 @@ void ControlManager::linkObserverSimulation(SP::Observer obs, SP::TimeDiscretisa
   obs->setTimeDiscretisation(*td);
 }
 
+void ControlManager::buildBatchedCapture()
+{
+  _batchSensors.clear();
+  _batchRowOffsets.clear();
+  _batchStates.clear();
+  _batchStateOffsets.clear();
+  _batchC.reset();
+  _batchX.reset();
+  _batchY.reset();
+
+  // collect the linear sensors; sensors of other types keep their own capture()
+  unsigned int rows = 0;
+  for(SensorsIterator itS = _allSensors.begin();
+      itS != _allSensors.end(); ++itS)
+  {
+    SP::LinearSensor ls = std::dynamic_pointer_cast<LinearSensor>(*itS);
+    if(!ls || !ls->C()) continue;
+    _batchSensors.push_back(ls);
+    rows += ls->C()->size(0);
+  }
+  if(_batchSensors.empty()) return;
+
+  // one column block per distinct observed state: sensors watching the
+  // same DynamicalSystem share their columns
+  std::vector<unsigned int> colOffset(_batchSensors.size());
+  unsigned int cols = 0;
+  for(size_t s = 0; s < _batchSensors.size(); ++s)
+  {
+    SP::SiconosVector x = _batchSensors[s]->getDS()->x();
+    size_t b = 0;
+    for(; b < _batchStates.size(); ++b)
+      if(_batchStates[b] == x) break;
+    if(b == _batchStates.size())
+    {
+      _batchStates.push_back(x);
+      _batchStateOffsets.push_back(cols);
+      cols += x->size();
+    }
+    colOffset[s] = _batchStateOffsets[b];
+  }
+
+  // stack the observation matrices into one sparse operator, one row
+  // block per sensor
+  _batchC.reset(new SimpleMatrix(rows, cols, Siconos::SPARSE));
+  unsigned int row = 0;
+  for(size_t s = 0; s < _batchSensors.size(); ++s)
+  {
+    const SimpleMatrix& C = *_batchSensors[s]->C();
+    for(unsigned int i = 0; i < C.size(0); ++i)
+    {
+      for(unsigned int j = 0; j < C.size(1); ++j)
+      {
+        double value = C.getValue(i, j);
+        if(value != 0.0)
+          _batchC->setValue(row + i, colOffset[s] + j, value);
+      }
+    }
+    _batchRowOffsets.push_back(row);
+    row += C.size(0);
+  }
+
+  _batchX.reset(new SiconosVector(cols));
+  _batchY.reset(new SiconosVector(rows));
+}
+
+void ControlManager::captureBatched()
+{
+  if(!_batchC)
+    buildBatchedCapture();
+  if(!_batchC)  // no LinearSensor in the manager
+    return;
+
+  // gather the observed states into the stacked state
+  for(size_t b = 0; b < _batchStates.size(); ++b)
+    _batchX->setBlock(_batchStateOffsets[b], *_batchStates[b]);
+
+  // a single sparse product covers every sensor
+  prod(*_batchC, *_batchX, *_batchY, true);
+
+  // scatter the stacked output back to the sensor buffers
+  for(size_t s = 0; s < _batchSensors.size(); ++s)
+    _batchSensors[s]->storeCapturedY(*_batchY, _batchRowOffsets[s]);
+}
+
 void ControlManager::display() const
 {
   std::cout << "=========> ControlManager " ;
@@ -24,9 +24,11 @@
 #define ControlManager_H
 
 #include "Actuator.hpp"
+#include "SiconosControlFwd.hpp"
 
-
+#include <map>
 #include <set>
+#include <vector>
 
 /** A set of Sensors */
 typedef std::set<SP::Sensor> Sensors;
@@ -86,6 +88,40 @@ protected:
   /** The simulation linked to this ControlManager */
   SP::Simulation _sim;
 
+  /** sensors taking part in the batched capture, in row block order of _batchC */
+  std::vector<SP::LinearSensor> _batchSensors;
+
+  /** row offset of each batched sensor in the stacked output */
+  std::vector<unsigned int> _batchRowOffsets;
+
+  /** distinct states observed by the batched sensors, in column block order of _batchC */
+  std::vector<SP::SiconosVector> _batchStates;
+
+  /** column offset of each observed state in the stacked state */
+  std::vector<unsigned int> _batchStateOffsets;
+
+  /** stacked observation operator of all the LinearSensors */
+  SP::SimpleMatrix _batchC;
+
+  /** work vector for the stacked observed state */
+  SP::SiconosVector _batchX;
+
+  /** work vector for the stacked sensor output */
+  SP::SiconosVector _batchY;
+
+  /** schedule one composite event per (rate, phase) group instead of one
+   *  event per device. Devices are grouped when they are given the same
+   *  TimeDiscretisation object. */
+  bool _coalesceDeviceEvents = true;
+
+  /** composite sensor event of each group, keyed by the shared
+   *  TimeDiscretisation */
+  std::map<SP::TimeDiscretisation, Event*> _sensorGroupEvents;
+
+  /** composite actuator event of each group, keyed by the shared
+   *  TimeDiscretisation */
+  std::map<SP::TimeDiscretisation, Event*> _actuatorGroupEvents;
+
   /** default constructor
    */
   ControlManager(): _sim(SP::Simulation()) {};
@@ -288,6 +324,37 @@ public:
    */
   void initialize(const NonSmoothDynamicalSystem& nsds);
 
+  /** Stack the observation matrices of all the LinearSensors into one
+   *  sparse operator for captureBatched(). Sensors observing the same
+   *  DynamicalSystem share a column block. Called lazily by
+   *  captureBatched(); call it again after adding or removing sensors.
+   */
+  void buildBatchedCapture();
+
+  /** Capture the output of all the LinearSensors at once: gather the
+   *  observed states, apply the stacked observation operator in a single
+   *  sparse product and scatter the result to the sensor buffers. With
+   *  many sensors sampling at the same instants this replaces one matrix
+   *  vector product per sensor per sample with one product per sample.
+   *  Sensors of other types are not affected and keep their own capture().
+   */
+  void captureBatched();
+
+  /** enable or disable device event coalescing (default: enabled).
+   *  When enabled, all the sensors (resp. actuators) registered with the
+   *  same TimeDiscretisation object share one composite event, so the
+   *  event machinery overhead scales with the number of distinct sample
+   *  rates instead of the number of devices. Must be set before the
+   *  devices are added; devices registered afterwards with the
+   *  TimeDiscretisation of an existing group join its event.
+   *
+   *  \param choice true to coalesce
+   */
+  inline void setCoalesceDeviceEvents(bool choice)
+  {
+    _coalesceDeviceEvents = choice;
+  };
+
   /** display the data of the ControlManager on the standard output
    */
   void display() const;
@@ -17,6 +17,7 @@
 */
 #include "SensorEvent.hpp"
 #include "Sensor.hpp"
+#include "ControlManager.hpp"
 #include "EventFactory.hpp"
 #include "TimeDiscretisation.hpp"
 
@@ -24,7 +25,16 @@ using namespace EventFactory;
 
 void SensorEvent::process(Simulation& sim)
 {
+  if(_batchedCaptureManager)
+  {
+    // the group covers exactly the manager batch: one product for all
+    _batchedCaptureManager->captureBatched();
+    return;
+  }
   _sensor->capture();
+  for(std::vector<SP::Sensor>::iterator it = _coalescedSensors.begin();
+      it != _coalescedSensors.end(); ++it)
+    (*it)->capture();
 }
 
 AUTO_REGISTER_EVENT(SENSOR_EVENT, SensorEvent)
@@ -25,6 +25,8 @@
 #include "SiconosControlFwd.hpp"
 #include "ControlTypeDef.hpp"
 
+#include <vector>
+
 /** Events when sensor data capture is done.
  *
  */
@@ -32,13 +34,22 @@ class SensorEvent : public Event
 {
 
 private:
-  
+
   ACCEPT_SERIALIZATION(SensorEvent);
 
 
   /** The sensor linked to the present event */
   SP::Sensor _sensor;
 
+  /** further sensors sharing this event, when the ControlManager
+   *  coalesces device scheduling: one event per (rate, phase) group
+   *  instead of one per device */
+  std::vector<SP::Sensor> _coalescedSensors;
+
+  /** when set, all the sensors of the group are captured through the
+   *  batched pipeline of this manager (one product per sample instant) */
+  ControlManager* _batchedCaptureManager = nullptr;
+
   /** Default constructor */
   SensorEvent(): Event(0.0, SENSOR_EVENT, true) {};
 
@@ -70,7 +81,25 @@ public:
     _sensor = newSensor;
   };
 
-  /** Call the capture method of the linked Sensor
+  /** add a Sensor to the group dispatched by this Event
+   *  \param newSensor the SP::Sensor
+   */
+  void addSensorPtr(SP::Sensor newSensor)
+  {
+    _coalescedSensors.push_back(newSensor);
+  };
+
+  /** route the captures of the whole group through the batched capture
+   *  of the given manager. Only valid when the group covers exactly the
+   *  sensors of the manager batch (checked by ControlManager::initialize).
+   *  \param manager the ControlManager owning the batch
+   */
+  void setBatchedCaptureManager(ControlManager* manager)
+  {
+    _batchedCaptureManager = manager;
+  };
+
+  /** Call the capture method of the linked Sensor(s)
    *  \param sim a SP::Simulation (ignored).
    */
   void process(Simulation& sim);
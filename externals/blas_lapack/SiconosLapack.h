@@ -188,6 +188,31 @@ extern "C"
     *INFO = C_INFO;
   }
 
+/* SGETRF/SGETRS - single precision counterparts of DGETRF/DGETRS, used
+ * by the mixed-precision iterative refinement solve. The wrapping macros
+ * only forward their arguments, so they are reused as-is.
+ */
+  static inline void SGETRF(lapack_int M, lapack_int N, float* A, lapack_int LDA, lapack_int* IPIV, lapack_int* INFO)
+  {
+    lapack_int C_M = M;
+    lapack_int C_N = N;
+    lapack_int C_LDA = LDA;
+    lapack_int C_INFO = 0;
+    WRAP_DGETRF(LAPACK_NAME(sgetrf), INTEGER(C_M), INTEGER(C_N), A, INTEGER(C_LDA), INTEGERP(IPIV), INTEGER(C_INFO));
+    *INFO = C_INFO;
+  }
+
+  static inline void SGETRS(char TRANS, lapack_int N, lapack_int NRHS, float* A, lapack_int LDA, lapack_int* IPIV, float* B, lapack_int LDB, lapack_int* INFO)
+  {
+    lapack_int C_N = N;
+    lapack_int C_NRHS = NRHS;
+    lapack_int C_LDA = LDA;
+    lapack_int C_LDB = LDB;
+    lapack_int C_INFO = 0;
+    WRAP_DGETRS(LAPACK_NAME(sgetrs), CHAR(TRANS), INTEGER(C_N), INTEGER(C_NRHS), A, INTEGER(C_LDA), INTEGERP(IPIV), B, INTEGER(C_LDB), INTEGER(C_INFO));
+    *INFO = C_INFO;
+  }
+
 
 /*
   DGELS - The routine solves overdetermined or underdetermined real linear
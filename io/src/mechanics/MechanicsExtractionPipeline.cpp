@@ -0,0 +1,140 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "MechanicsExtractionPipeline.hpp"
+#include <SiconosException.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+unsigned int MechanicsExtractionPipeline::subscribe(const Policy& policy)
+{
+  Subscriber sub;
+  sub.id = _nextId++;
+  sub.policy = policy;
+  /* sorted subscription lists are looked up by binary search in the
+     frame loop */
+  std::sort(sub.policy.bodies.begin(), sub.policy.bodies.end());
+  _subscribers.push_back(sub);
+  return sub.id;
+}
+
+void MechanicsExtractionPipeline::unsubscribe(unsigned int id)
+{
+  for(auto it = _subscribers.begin(); it != _subscribers.end(); ++it)
+  {
+    if(it->id == id)
+    {
+      _subscribers.erase(it);
+      return;
+    }
+  }
+  THROW_EXCEPTION("MechanicsExtractionPipeline::unsubscribe, unknown subscription identifier");
+}
+
+MechanicsExtractionPipeline::Subscriber&
+MechanicsExtractionPipeline::subscriber(unsigned int id)
+{
+  for(auto& sub : _subscribers)
+    if(sub.id == id) return sub;
+  THROW_EXCEPTION("MechanicsExtractionPipeline::subscriber, unknown subscription identifier");
+}
+
+MechanicsExtractionPipeline::Policy&
+MechanicsExtractionPipeline::policy(unsigned int id)
+{
+  return subscriber(id).policy;
+}
+
+const MechanicsExtractionPipeline::Frame&
+MechanicsExtractionPipeline::frame(unsigned int id) const
+{
+  for(const auto& sub : _subscribers)
+    if(sub.id == id) return sub.frame;
+  THROW_EXCEPTION("MechanicsExtractionPipeline::frame, unknown subscription identifier");
+}
+
+void MechanicsExtractionPipeline::extract(const NonSmoothDynamicalSystem& nsds)
+{
+  /* one traversal of the DS graph for all the subscribers, into the
+     scene-wide reusable buffers */
+  _io.positions(nsds, _allPositions);
+  _io.velocities(nsds, _allVelocities);
+
+  unsigned int nb_rows = _allPositions.size(0);
+  unsigned int pos_cols = _allPositions.size(1);
+  unsigned int vel_cols = _allVelocities.size(1);
+  /* translational part of the rows: column 0 is the body number */
+  unsigned int space_dim = std::min(3u, pos_cols - 1);
+  unsigned int vel_dim = std::min(3u, vel_cols - 1);
+
+  for(auto& sub : _subscribers)
+  {
+    const Policy& policy = sub.policy;
+    Frame& frame = sub.frame;
+    /* grow-only preallocation: a steady subscriber keeps its buffers */
+    if(frame.positions.size(0) < nb_rows || frame.positions.size(1) != pos_cols)
+      frame.positions.resize(nb_rows, pos_cols);
+    if(frame.velocities.size(0) < nb_rows || frame.velocities.size(1) != vel_cols)
+      frame.velocities.resize(nb_rows, vel_cols);
+
+    unsigned int current_row = 0;
+    for(unsigned int row = 0; row < nb_rows; ++row)
+    {
+      if(!policy.bodies.empty()
+          && !std::binary_search(policy.bodies.begin(), policy.bodies.end(),
+                                 (unsigned int)_allPositions.getValue(row, 0)))
+        continue;
+
+      if(policy.restVelocityThreshold > 0.)
+      {
+        /* skip bodies at rest: they do not move on screen, the client
+           keeps their last received state */
+        double v2 = 0.;
+        for(unsigned int k = 0; k < vel_dim; ++k)
+        {
+          double v = _allVelocities.getValue(row, 1 + k);
+          v2 += v * v;
+        }
+        if(v2 <= policy.restVelocityThreshold * policy.restVelocityThreshold)
+          continue;
+      }
+
+      if(policy.lodDistance > 0. && policy.lodStride > 1)
+      {
+        double d2 = 0.;
+        for(unsigned int k = 0; k < space_dim; ++k)
+        {
+          double d = _allPositions.getValue(row, 1 + k) - policy.focus[k];
+          d2 += d * d;
+        }
+        /* far bodies are decimated: one out of lodStride is kept */
+        if(d2 > policy.lodDistance * policy.lodDistance
+            && (sub.farCount++ % policy.lodStride) != 0)
+          continue;
+      }
+
+      for(unsigned int k = 0; k < pos_cols; ++k)
+        frame.positions.setValue(current_row, k, _allPositions.getValue(row, k));
+      for(unsigned int k = 0; k < vel_cols; ++k)
+        frame.velocities.setValue(current_row, k, _allVelocities.getValue(row, k));
+      ++current_row;
+    }
+    frame.nbBodies = current_row;
+  }
+}
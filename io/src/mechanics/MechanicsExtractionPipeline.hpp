@@ -0,0 +1,121 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef MechanicsExtractionPipeline_hpp
+#define MechanicsExtractionPipeline_hpp
+
+#include "MechanicsIO.hpp"
+#include <SimpleMatrix.hpp>
+#include <vector>
+
+/** Subscription-based extraction of render data from a running
+ *  simulation.
+ *
+ *  MechanicsIO::positions()/velocities() extract every body of the
+ *  model; a visualization client that only displays a subset, or that
+ *  can afford a lower level of detail for distant bodies, still pays
+ *  for the whole scene on every frame. The pipeline traverses the DS
+ *  graph once per extract() call -- whatever the number of subscribers
+ *  -- and then filters the frame into the preallocated buffers of each
+ *  subscriber according to its policy, so the per-subscriber cost
+ *  scales with the bodies it actually receives.
+ */
+class MechanicsExtractionPipeline
+{
+public:
+
+  /** what a subscriber wants to receive */
+  struct Policy
+  {
+    /** numbers of the subscribed dynamical systems; empty means the
+     * whole scene */
+    std::vector<unsigned int> bodies;
+    /** point of interest of the subscriber, used by the distance
+     * decimation (world coordinates, third component ignored in 2d) */
+    double focus[3] = {0., 0., 0.};
+    /** bodies farther than this from the focus are decimated; 0
+     * disables the decimation */
+    double lodDistance = 0.;
+    /** one far body out of lodStride is kept */
+    unsigned int lodStride = 1;
+    /** bodies whose generalized velocity norm is below this threshold
+     * are skipped (bodies at rest do not move on screen); 0 keeps
+     * everything */
+    double restVelocityThreshold = 0.;
+  };
+
+  /** the extracted data of one subscriber; the matrices are laid out as
+   * in MechanicsIO::positions()/velocities() and are only grown, never
+   * shrunk, so a steady subscriber is served without any allocation */
+  struct Frame
+  {
+    SimpleMatrix positions;
+    SimpleMatrix velocities;
+    /** number of valid rows of the matrices for the current frame */
+    unsigned int nbBodies = 0;
+  };
+
+  /** register a subscriber
+   *  \param policy the bodies and level-of-detail wanted
+   *  \return the subscription identifier
+   */
+  unsigned int subscribe(const Policy& policy);
+
+  /** remove a subscriber
+   *  \param id the subscription identifier
+   */
+  void unsubscribe(unsigned int id);
+
+  /** \param id the subscription identifier
+   *  \return the policy of a subscriber, modifiable between frames
+   */
+  Policy& policy(unsigned int id);
+
+  /** \param id the subscription identifier
+   *  \return the last extracted frame of a subscriber
+   */
+  const Frame& frame(unsigned int id) const;
+
+  /** extract the current state into the buffers of every subscriber
+   *  \param nsds current nonsmooth dynamical system
+   */
+  void extract(const NonSmoothDynamicalSystem& nsds);
+
+private:
+
+  struct Subscriber
+  {
+    unsigned int id;
+    Policy policy;
+    Frame frame;
+    /** far-body counter of the stride decimation, persistent across
+     * frames so the kept subset is stable */
+    unsigned int farCount = 0;
+  };
+
+  Subscriber& subscriber(unsigned int id);
+
+  MechanicsIO _io;
+  /** scene-wide frame buffers, reused across extract() calls */
+  SimpleMatrix _allPositions;
+  SimpleMatrix _allVelocities;
+  std::vector<Subscriber> _subscribers;
+  unsigned int _nextId = 0;
+};
+
+#endif
@@ -667,20 +667,32 @@ void ContactPointDomainVisitor::operator()(const NewtonEuler3DR& rel)
 }
 
 template<typename T, typename G>
-SP::SimpleMatrix MechanicsIO::visitAllVerticesForVector(const G& graph) const
+void MechanicsIO::visitAllVerticesForVector(const G& graph, SimpleMatrix& result) const
 {
-  SP::SimpleMatrix result(new SimpleMatrix());
   typename G::VIterator vi, viend;
   unsigned int current_row;
+  /* the number of rows is known in advance: allocate the full frame at
+     once instead of growing (and copying) the matrix at each vertex.
+     When the caller hands over an already well-shaped matrix, e.g. the
+     frame buffer of a recording loop, nothing is allocated at all. */
+  unsigned int nb_rows = graph.vertices_number();
   for(current_row=0,std::tie(vi,viend)=graph.vertices();
       vi!=viend; ++vi, ++current_row)
   {
     T getter;
     graph.bundle(*vi)->accept(getter);
     const SiconosVector& data = *getter.result;
-    result->resize(current_row+1, data.size());
-    result->setRow(current_row, data);
+    if(result.size(0) != nb_rows || result.size(1) != data.size())
+      result.resize(nb_rows, data.size());
+    result.setRow(current_row, data);
   }
+}
+
+template<typename T, typename G>
+SP::SimpleMatrix MechanicsIO::visitAllVerticesForVector(const G& graph) const
+{
+  SP::SimpleMatrix result(new SimpleMatrix());
+  visitAllVerticesForVector<T>(graph, *result);
   return result;
 }
 
@@ -712,6 +724,18 @@ SP::SimpleMatrix MechanicsIO::positions(const NonSmoothDynamicalSystem& nsds) co
          (*(nsds.topology()->dSG(0)));
 };
 
+void MechanicsIO::positions(const NonSmoothDynamicalSystem& nsds,
+                            SimpleMatrix& result) const
+{
+
+  typedef
+  Visitor < Classes < LagrangianDS, NewtonEulerDS >,
+          GetPosition >::Make Getter;
+
+  visitAllVerticesForVector<Getter>
+  (*(nsds.topology()->dSG(0)), result);
+};
+
 
 SP::SimpleMatrix MechanicsIO::velocities(const NonSmoothDynamicalSystem& nsds) const
 {
@@ -723,6 +747,17 @@ SP::SimpleMatrix MechanicsIO::velocities(const NonSmoothDynamicalSystem& nsds) c
          (*nsds.topology()->dSG(0));
 }
 
+void MechanicsIO::velocities(const NonSmoothDynamicalSystem& nsds,
+                             SimpleMatrix& result) const
+{
+  typedef
+  Visitor < Classes < LagrangianDS, NewtonEulerDS >,
+          GetVelocity>::Make Getter;
+
+  visitAllVerticesForVector<Getter>
+  (*nsds.topology()->dSG(0), result);
+}
+
 SP::SimpleMatrix MechanicsIO::contactPoints(const NonSmoothDynamicalSystem& nsds,
     unsigned int index_set) const
 {
@@ -33,6 +33,9 @@ protected:
   template<typename T, typename G>
   SP::SimpleMatrix visitAllVerticesForVector(const G& graph) const;
 
+  template<typename T, typename G>
+  void visitAllVerticesForVector(const G& graph, SimpleMatrix& result) const;
+
   template<typename T, typename G>
   SP::SiconosVector visitAllVerticesForDouble(const G& graph) const;
 
@@ -50,6 +53,15 @@ public:
    */
   SP::SimpleMatrix positions(const NonSmoothDynamicalSystem& nsds) const;
 
+  /** get all positions, written into a caller-provided matrix. When the
+   * matrix already has the right shape (a frame buffer reused by a
+   * recording loop), nothing is allocated, so frames can be streamed
+   * out at no allocation cost.
+   * \param nsds current nonsmooth dynamical system
+   * \param result the frame buffer, resized if needed
+   */
+  void positions(const NonSmoothDynamicalSystem& nsds, SimpleMatrix& result) const;
+
   /** get all velocities: translation (xdot, ydot, zdot) + orientation velocities
    * ox, oy, oz
    * \param nsds current nonsmooth dynamical system
@@ -59,6 +71,13 @@ public:
    */
   SP::SimpleMatrix velocities(const NonSmoothDynamicalSystem& nsds) const;
 
+  /** get all velocities, written into a caller-provided matrix (see
+   * the positions() overload above).
+   * \param nsds current nonsmooth dynamical system
+   * \param result the frame buffer, resized if needed
+   */
+  void velocities(const NonSmoothDynamicalSystem& nsds, SimpleMatrix& result) const;
+
   /** get the coordinates of all contact points, normals, reactions and velocities
    * \param nsds current nonsmooth dynamical system
    * \param index_set the index set number.
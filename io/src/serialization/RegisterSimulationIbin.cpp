@@ -29,13 +29,26 @@
 
 #include <boost/archive/binary_iarchive.hpp>
 
+#include "SiconosRestart.hpp"
+
 void RegisterSimulationIbin(std::ifstream& ifs, SP::Simulation& sim)
 {
   boost::archive::binary_iarchive ar(ifs);
-  siconos_io_register_Numerics(ar);
-  siconos_io_register_Kernel(ar);
-  siconos_io_register_Mechanics(ar);
-  siconos_io_register_Control(ar);
+  siconos_io_register_Simulation(ar);
   ar >> NVP(sim);
 }
+
+/* defined here, and not in SiconosRestart.cpp, so that a tool calling
+ * only loadBinary() links this translation unit alone and never pulls
+ * the xml archive machinery */
+namespace Siconos
+{
+SP::Simulation loadBinary(const std::string& filename)
+{
+  SP::Simulation s;
+  std::ifstream ifs(filename.c_str());
+  RegisterSimulationIbin(ifs, s);
+  return s;
+}
+}
 #endif
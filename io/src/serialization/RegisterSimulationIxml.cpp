@@ -54,10 +54,20 @@ void basic_text_iprimitive<std::istream>::load<double>(double& t)
 void RegisterSimulationIxml(std::ifstream& ifs, SP::Simulation& sim)
 {
   boost::archive::xml_iarchive ar(ifs);
-  siconos_io_register_Numerics(ar);
-  siconos_io_register_Kernel(ar);
-  siconos_io_register_Mechanics(ar);
-  siconos_io_register_Control(ar);
+  siconos_io_register_Simulation(ar);
   ar >> NVP(sim);
 }
+
+#include "SiconosRestart.hpp"
+
+namespace Siconos
+{
+SP::Simulation loadXml(const std::string& filename)
+{
+  SP::Simulation s;
+  std::ifstream ifs(filename.c_str());
+  RegisterSimulationIxml(ifs, s);
+  return s;
+}
+}
 #endif
@@ -29,13 +29,34 @@
 
 #include <boost/archive/binary_oarchive.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include "SiconosRestart.hpp"
+
 void RegisterSimulationObin(std::ofstream& ofs, SP::Simulation& sim)
 {
   boost::archive::binary_oarchive ar(ofs);
-  siconos_io_register_Numerics(ar);
-  siconos_io_register_Kernel(ar);
-  siconos_io_register_Mechanics(ar);
-  siconos_io_register_Control(ar);
+  siconos_io_register_Simulation(ar);
   ar << NVP(sim);
 }
+
+/* defined here, and not in SiconosRestart.cpp, so that a tool calling
+ * only saveBinary() links this translation unit alone and never pulls
+ * the xml archive machinery */
+namespace Siconos
+{
+void saveBinary(SP::Simulation s, const std::string& filename)
+{
+  boost::filesystem::path tempf =
+    boost::filesystem::path(filename + ".tmp");
+
+  {
+    std::ofstream ofs(tempf.c_str());
+    RegisterSimulationObin(ofs, s);
+  }
+
+  // atomic
+  boost::filesystem::rename(tempf, boost::filesystem::path(filename));
+}
+}
 #endif
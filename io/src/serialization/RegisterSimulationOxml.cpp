@@ -29,13 +29,31 @@
 
 #include <boost/archive/xml_oarchive.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include "SiconosRestart.hpp"
+
 void RegisterSimulationOxml(std::ofstream& ofs, SP::Simulation& sim)
 {
   boost::archive::xml_oarchive ar(ofs);
-  siconos_io_register_Numerics(ar);
-  siconos_io_register_Kernel(ar);
-  siconos_io_register_Mechanics(ar);
-  siconos_io_register_Control(ar);
+  siconos_io_register_Simulation(ar);
   ar << NVP(sim);
 }
+
+namespace Siconos
+{
+void saveXml(SP::Simulation s, const std::string& filename)
+{
+  boost::filesystem::path tempf =
+    boost::filesystem::path(filename + ".tmp");
+
+  {
+    std::ofstream ofs(tempf.c_str());
+    RegisterSimulationOxml(ofs, s);
+  }
+
+  // atomic
+  boost::filesystem::rename(tempf, boost::filesystem::path(filename));
+}
+}
 #endif
@@ -0,0 +1,99 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "SiconosConfig.h"
+#include "SiconosClone.hpp"
+#include "SiconosException.hpp"
+
+#ifdef WITH_SERIALIZATION
+
+#include "SiconosFull.hpp"
+
+#include <boost/numeric/bindings/ublas/matrix.hpp>
+#include <boost/numeric/bindings/ublas/vector.hpp>
+#include <boost/numeric/bindings/ublas/vector_sparse.hpp>
+#include <boost/numeric/bindings/ublas/matrix_sparse.hpp>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+
+#include <sstream>
+
+/* the whole graph traversal is the one already written for the binary
+ * snapshots (SiconosFull.hpp); the only difference with
+ * saveBinary()/loadBinary() is that the archive lives in memory, so a
+ * sweep worker never touches the filesystem */
+
+namespace Siconos
+{
+
+SimulationTemplate::SimulationTemplate(SP::Simulation s)
+{
+  std::ostringstream oss(std::ios::binary);
+  {
+    boost::archive::binary_oarchive ar(oss);
+    siconos_io_register_Simulation(ar);
+    ar << NVP(s);
+  }
+  _image = oss.str();
+}
+
+SP::Simulation SimulationTemplate::instantiate() const
+{
+  std::istringstream iss(_image, std::ios::binary);
+  boost::archive::binary_iarchive ar(iss);
+  siconos_io_register_Simulation(ar);
+  SP::Simulation s;
+  ar >> NVP(s);
+  return s;
+}
+
+SP::Simulation clone(SP::Simulation s)
+{
+  return SimulationTemplate(s).instantiate();
+}
+
+}
+
+#else
+
+namespace Siconos
+{
+
+SimulationTemplate::SimulationTemplate(SP::Simulation s)
+{
+  THROW_EXCEPTION("Siconos/IO must be compiled with serialization support for this service.");
+}
+
+SP::Simulation SimulationTemplate::instantiate() const
+{
+  THROW_EXCEPTION("Siconos/IO must be compiled with serialization support for this service.");
+  /* Dummy return to make every compiler happy  */
+  return std::shared_ptr<Simulation>();
+}
+
+SP::Simulation clone(SP::Simulation s)
+{
+  THROW_EXCEPTION("Siconos/IO must be compiled with serialization support for this service.");
+  /* Dummy return to make every compiler happy  */
+  return std::shared_ptr<Simulation>();
+}
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*! \file SiconosClone.hpp
+  \brief in-memory cloning of initialized simulations, for parameter
+  sweeps and sweep workers */
+
+#ifndef SICONOSCLONE_HPP
+#define SICONOSCLONE_HPP
+
+#include <SiconosFwd.hpp>
+#include <string>
+
+/** SICONOS
+ */
+namespace Siconos
+{
+
+/** Pre-serialized image of a fully initialized Simulation, for runs
+ *  that instantiate the same model many times (calibration sweeps,
+ *  Monte-Carlo batches).
+ *
+ *  The model traversal -- the expensive part of a deep copy -- is paid
+ *  once, when the template is built; every instantiate() then
+ *  materializes an independent warm simulation from the in-memory
+ *  archive, without re-running the model construction or
+ *  Simulation::initialize(). The image itself is immutable and shared
+ *  by all the clones; each clone owns its mutable state, so the clones
+ *  can be stepped concurrently from different threads (instantiate()
+ *  itself is not thread-safe, fork the workers after cloning or guard
+ *  the call).
+ *
+ *  Only available when the library is built WITH_SERIALIZATION; the
+ *  constructor throws otherwise.
+ */
+class SimulationTemplate
+{
+private:
+  /** binary archive image of the simulation */
+  std::string _image;
+
+public:
+  /** build the template from an initialized simulation
+   *  \param s the simulation to capture
+   */
+  explicit SimulationTemplate(SP::Simulation s);
+
+  /** materialize an independent simulation from the captured image
+   *  \return a deep copy of the captured simulation, ready to run
+   */
+  SP::Simulation instantiate() const;
+
+  /** \return the size of the serialized image, in bytes */
+  std::size_t imageSize() const { return _image.size(); };
+};
+
+/** deep-copy an initialized simulation in one shot; equivalent to
+ *  building a SimulationTemplate and instantiating it once -- prefer
+ *  keeping the template around when several copies are needed
+ *  \param s the simulation to copy
+ *  \return an independent copy of s
+ */
+SP::Simulation clone(SP::Simulation s);
+
+}
+
+#endif
@@ -295,6 +295,20 @@ void siconos_property_io(Archive& ar, P& p)
 
 }
 
+/* for the dense Siconos::IndexedProperties the store is indexed by the
+   graph indices, not by the descriptors: go through operator[] */
+template<typename Archive, typename P>
+void siconos_indexed_property_io(Archive& ar, P& p)
+{
+
+  typename P::Access::iterator vi, viend;
+  for (boost::tie(vi, viend) = p.access.elements(p._g); vi != viend; ++vi)
+  {
+    ar & boost::serialization::make_nvp("property", p[*vi]);
+  }
+
+}
+
 
 #define MAKE_SICONOS_IO_PROPERTIES(CLASS)                               \
   template<class Archive>                                               \
@@ -336,6 +350,20 @@ void siconos_property_io(Archive& ar, P& p)
     siconos_property_io(ar, p);                                         \
   }                                                                     \
  
+#define MAKE_SICONOS_IO_INDEXED_PROPERTIES(CLASS)                       \
+  template<class Archive>                                               \
+  void siconos_io(Archive& ar, Siconos::IndexedVertexProperties<CLASS, _InteractionsGraph>& p, unsigned int version) \
+  {                                                                     \
+    SERIALIZE(p, (_g)(_stamp), ar);                                     \
+    siconos_indexed_property_io(ar, p);                                 \
+  }                                                                     \
+  template<class Archive>                                               \
+  void siconos_io(Archive& ar, Siconos::IndexedEdgeProperties<CLASS, _InteractionsGraph>& p, unsigned int version) \
+  {                                                                     \
+    SERIALIZE(p, (_g)(_stamp), ar);                                     \
+    siconos_indexed_property_io(ar, p);                                 \
+  }                                                                     \
+
 namespace Siconos
 {
   MAKE_SICONOS_IO_PROPERTIES(SP::MatrixIntegrator);
@@ -350,6 +378,7 @@ namespace Siconos
   MAKE_SICONOS_IO_SP_PROPERTIES(SiconosMatrix);
   MAKE_SICONOS_IO_SP_PROPERTIES(SimpleMatrix);
   MAKE_SICONOS_IO_SP_PROPERTIES(SiconosVector);
+  MAKE_SICONOS_IO_INDEXED_PROPERTIES(SP::SimpleMatrix);
   MAKE_SICONOS_IO_PROPERTIES(std::string);
   MAKE_SICONOS_IO_PROPERTIES(unsigned int);
   MAKE_SICONOS_IO_PROPERTIES(double);
@@ -393,6 +422,18 @@ namespace boost { namespace serialization {
     {
       siconos_io(ar, p, version);
     }
+
+    template <class Archive, class T>
+    void serialize(Archive& ar, Siconos::IndexedVertexProperties<T, _InteractionsGraph>& p, unsigned int version)
+    {
+      siconos_io(ar, p, version);
+    }
+
+    template <class Archive, class T>
+    void serialize(Archive& ar, Siconos::IndexedEdgeProperties<T, _InteractionsGraph>& p, unsigned int version)
+    {
+      siconos_io(ar, p, version);
+    }
   } // namespace serialization
 } // namespace boost
 
@@ -467,5 +508,21 @@ void siconos_io_register_Control(Archive& ar)
   siconos_io_register_generated_Control(ar);
 }
 
+/* Single-pass registration for the SiconosRestart entry points. The
+   historical Numerics/Kernel/Mechanics/Control sequence re-ran the whole
+   kernel list three times (Mechanics and Control each pull Kernel), and
+   every duplicate register_type call still pays a lookup in the archive
+   type table. Class ids are assigned at the first registration only, so
+   running each list once in the same first-seen order leaves the stream
+   layout unchanged. */
+template <class Archive>
+void siconos_io_register_Simulation(Archive& ar)
+{
+  siconos_io_register_Numerics(ar);
+  siconos_io_register_Kernel(ar);
+  siconos_io_register_generated_Mechanics(ar);
+  siconos_io_register_generated_Control(ar);
+}
+
 #endif
 #endif
@@ -17,12 +17,31 @@
 */
 
 #include "SiconosConfig.h"
-#ifdef WITH_SERIALIZATION
 #include "SiconosRestart.hpp"
 
-#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <vector>
 
 #include "Simulation.hpp"
+#include "NonSmoothDynamicalSystem.hpp"
+#include "Topology.hpp"
+#include "SimulationGraphs.hpp"
+#include "LagrangianDS.hpp"
+#include "NewtonEulerDS.hpp"
+#include "Interaction.hpp"
+#include "SiconosMemory.hpp"
+#include "SiconosVector.hpp"
+#include "SiconosException.hpp"
+
+#ifdef WITH_SERIALIZATION
+
+#include <boost/filesystem.hpp>
+
 #include "RegisterSimulation.hpp"
 
 
@@ -31,27 +50,17 @@ namespace Siconos
 
 void save(SP::Simulation s, const std::string& filename)
 {
-  boost::filesystem::path tempf =
-    boost::filesystem::path(filename + ".tmp");
-
   boost::filesystem::path destf =
     boost::filesystem::path(filename);
 
-  std::ofstream ofs(tempf.c_str());
+  if(destf.extension() == ".xml")
   {
-    if(destf.extension() == ".xml")
-    {
-      RegisterSimulationOxml(ofs, s);
-    }
-
-    else if(destf.extension() == ".bin")
-    {
-      RegisterSimulationObin(ofs, s);
-    }
+    saveXml(s, filename);
+  }
+  else if(destf.extension() == ".bin")
+  {
+    saveBinary(s, filename);
   }
-
-  // atomic
-  boost::filesystem::rename(tempf, destf);
 }
 
 /** load Siconos model from file
@@ -59,26 +68,18 @@ void save(SP::Simulation s, const std::string& filename)
  */
 SP::Simulation load(const std::string& filename)
 {
-  //SP::Simulation s(new Simulation());
-  SP::Simulation s;
-
-  std::ifstream ifs(filename.c_str());
+  if(boost::filesystem::path(filename).extension() == ".xml")
   {
-    if(boost::filesystem::path(filename).extension() == ".xml")
-    {
-      RegisterSimulationIxml(ifs, s);
-    }
-    else if(boost::filesystem::path(filename).extension() == ".bin")
-    {
-      RegisterSimulationIbin(ifs, s);
-    }
+    return loadXml(filename);
   }
-  return s;
+  else if(boost::filesystem::path(filename).extension() == ".bin")
+  {
+    return loadBinary(filename);
+  }
+  return SP::Simulation();
 }
 }
 #else
-#include "SiconosRestart.hpp"
-#include <SiconosException.hpp>
 namespace Siconos
 {
 
@@ -95,3 +96,465 @@ SP::Simulation load(const std::string& filename)
 }
 }
 #endif
+
+/* --- incremental checkpoints: binary deltas of the mutable state ---
+ *
+ * A delta records only what the time integration modifies: the state
+ * vectors and memories of the dynamical systems and the y/lambda of the
+ * interactions. The structural part of the model (topology, relations,
+ * solver setup, ...) is covered by the base snapshot written with
+ * save(), so a delta costs O(state) instead of a full model
+ * serialization and can be written at every checkpoint. Unlike
+ * save()/load(), the deltas do not depend on WITH_SERIALIZATION.
+ *
+ * File layout (raw host-endian binary): magic, simulation time, number
+ * of dynamical systems, per ds { number, kind tag, state vectors,
+ * memories }, number of interactions, per interaction { number, y
+ * levels, lambda levels }. Object numbers and vector sizes are checked
+ * on restore so that applying the delta of another model fails loudly. */
+
+namespace
+{
+
+const char DELTA_MAGIC[8] = {'S', 'i', 'c', 'D', 'l', 't', 'a', '1'};
+
+enum DeltaDSKind
+{
+  DELTA_DS_LAGRANGIAN = 1,
+  DELTA_DS_NEWTONEULER = 2,
+  DELTA_DS_GENERIC = 3
+};
+
+template <typename T>
+void write_raw(std::ofstream& ofs, const T& value)
+{
+  ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_raw(std::ifstream& ifs)
+{
+  T value;
+  ifs.read(reinterpret_cast<char*>(&value), sizeof(T));
+  if(!ifs)
+    THROW_EXCEPTION("Siconos::loadStateDelta: truncated delta file.");
+  return value;
+}
+
+void write_vector(std::ofstream& ofs, const SiconosVector& v)
+{
+  write_raw<std::uint64_t>(ofs, v.size());
+  ofs.write(reinterpret_cast<const char*>(v.getArray()),
+            v.size() * sizeof(double));
+}
+
+void read_vector(std::ifstream& ifs, SiconosVector& v)
+{
+  std::uint64_t size = read_raw<std::uint64_t>(ifs);
+  if(size != v.size())
+    THROW_EXCEPTION("Siconos::loadStateDelta: state size mismatch, the delta does not correspond to this simulation.");
+  ifs.read(reinterpret_cast<char*>(v.getArray()), size * sizeof(double));
+  if(!ifs)
+    THROW_EXCEPTION("Siconos::loadStateDelta: truncated delta file.");
+}
+
+void write_memory(std::ofstream& ofs, const SiconosMemory& mem)
+{
+  write_raw<std::uint64_t>(ofs, mem.size());
+  write_raw<std::uint64_t>(ofs, mem.size() > 0 ? mem[0].size() : 0);
+  write_raw<std::uint64_t>(ofs, mem.nbVectorsInMemory());
+  /* index 0 is the most recent vector */
+  for(MemoryContainer::size_type i = 0; i < mem.nbVectorsInMemory(); ++i)
+    write_vector(ofs, mem.getSiconosVector(i));
+}
+
+void read_memory(std::ifstream& ifs, SiconosMemory& mem)
+{
+  std::uint64_t steps = read_raw<std::uint64_t>(ifs);
+  std::uint64_t vector_size = read_raw<std::uint64_t>(ifs);
+  std::uint64_t nb = read_raw<std::uint64_t>(ifs);
+
+  mem.clear();
+  if(steps > 0)
+    mem.setMemorySize(steps, vector_size);
+
+  std::vector<SiconosVector> saved;  /* most recent first, as written */
+  saved.reserve(nb);
+  for(std::uint64_t i = 0; i < nb; ++i)
+  {
+    SiconosVector v(vector_size);
+    read_vector(ifs, v);
+    saved.push_back(v);
+  }
+  /* re-play the history, oldest first */
+  for(std::uint64_t i = nb; i-- > 0;)
+    mem.swap(saved[i]);
+}
+
+void write_ds_state(std::ofstream& ofs, DynamicalSystem& ds)
+{
+  /* dynamic_cast (and not Type::value) so that derived mechanics
+     classes (RigidBodyDS, ...) follow their base class format */
+  if(LagrangianDS* lds = dynamic_cast<LagrangianDS*>(&ds))
+  {
+    write_raw<std::uint8_t>(ofs, DELTA_DS_LAGRANGIAN);
+    write_vector(ofs, *lds->q());
+    write_vector(ofs, *lds->velocity());
+    write_memory(ofs, lds->qMemory());
+    write_memory(ofs, lds->velocityMemory());
+  }
+  else if(NewtonEulerDS* neds = dynamic_cast<NewtonEulerDS*>(&ds))
+  {
+    write_raw<std::uint8_t>(ofs, DELTA_DS_NEWTONEULER);
+    write_vector(ofs, *neds->q());
+    write_vector(ofs, *neds->twist());
+    write_memory(ofs, neds->qMemory());
+    write_memory(ofs, neds->twistMemory());
+  }
+  else
+  {
+    write_raw<std::uint8_t>(ofs, DELTA_DS_GENERIC);
+    write_vector(ofs, *ds.x());
+    write_memory(ofs, ds.xMemory());
+  }
+}
+
+void read_ds_state(std::ifstream& ifs, DynamicalSystem& ds)
+{
+  std::uint8_t kind = read_raw<std::uint8_t>(ifs);
+  if(LagrangianDS* lds = dynamic_cast<LagrangianDS*>(&ds))
+  {
+    if(kind != DELTA_DS_LAGRANGIAN)
+      THROW_EXCEPTION("Siconos::loadStateDelta: dynamical system type mismatch.");
+    read_vector(ifs, *lds->q());
+    read_vector(ifs, *lds->velocity());
+    /* the memory accessors are read-only; restoring a checkpoint is
+       the one place where the history itself is overwritten */
+    read_memory(ifs, const_cast<SiconosMemory&>(lds->qMemory()));
+    read_memory(ifs, const_cast<SiconosMemory&>(lds->velocityMemory()));
+  }
+  else if(NewtonEulerDS* neds = dynamic_cast<NewtonEulerDS*>(&ds))
+  {
+    if(kind != DELTA_DS_NEWTONEULER)
+      THROW_EXCEPTION("Siconos::loadStateDelta: dynamical system type mismatch.");
+    read_vector(ifs, *neds->q());
+    read_vector(ifs, *neds->twist());
+    read_memory(ifs, const_cast<SiconosMemory&>(neds->qMemory()));
+    read_memory(ifs, const_cast<SiconosMemory&>(neds->twistMemory()));
+  }
+  else
+  {
+    if(kind != DELTA_DS_GENERIC)
+      THROW_EXCEPTION("Siconos::loadStateDelta: dynamical system type mismatch.");
+    read_vector(ifs, *ds.x());
+    read_memory(ifs, ds.xMemory());
+  }
+}
+
+void write_interaction_state(std::ofstream& ofs, Interaction& inter)
+{
+  std::uint32_t ny = inter.upperLevelForOutput() + 1;
+  std::uint32_t nlambda = inter.upperLevelForInput() + 1;
+  write_raw<std::uint32_t>(ofs, ny);
+  write_raw<std::uint32_t>(ofs, nlambda);
+  for(std::uint32_t i = 0; i < ny; ++i)
+  {
+    SP::SiconosVector y = inter.y(i);
+    write_raw<std::uint8_t>(ofs, y ? 1 : 0);
+    if(y)
+    {
+      write_vector(ofs, *y);
+      write_memory(ofs, inter.yMemory(i));
+    }
+  }
+  for(std::uint32_t i = 0; i < nlambda; ++i)
+  {
+    SP::SiconosVector lambda = inter.lambda(i);
+    write_raw<std::uint8_t>(ofs, lambda ? 1 : 0);
+    if(lambda)
+    {
+      write_vector(ofs, *lambda);
+      write_memory(ofs, inter.lambdaMemory(i));
+    }
+  }
+}
+
+void read_interaction_state(std::ifstream& ifs, Interaction& inter)
+{
+  std::uint32_t ny = read_raw<std::uint32_t>(ifs);
+  std::uint32_t nlambda = read_raw<std::uint32_t>(ifs);
+  if(ny != inter.upperLevelForOutput() + 1
+      || nlambda != inter.upperLevelForInput() + 1)
+    THROW_EXCEPTION("Siconos::loadStateDelta: interaction levels mismatch.");
+  for(std::uint32_t i = 0; i < ny; ++i)
+  {
+    std::uint8_t present = read_raw<std::uint8_t>(ifs);
+    SP::SiconosVector y = inter.y(i);
+    if((present != 0) != (bool)y)
+      THROW_EXCEPTION("Siconos::loadStateDelta: interaction output mismatch.");
+    if(y)
+    {
+      read_vector(ifs, *y);
+      read_memory(ifs, inter.yMemory(i));
+    }
+  }
+  for(std::uint32_t i = 0; i < nlambda; ++i)
+  {
+    std::uint8_t present = read_raw<std::uint8_t>(ifs);
+    SP::SiconosVector lambda = inter.lambda(i);
+    if((present != 0) != (bool)lambda)
+      THROW_EXCEPTION("Siconos::loadStateDelta: interaction input mismatch.");
+    if(lambda)
+    {
+      read_vector(ifs, *lambda);
+      read_memory(ifs, inter.lambdaMemory(i));
+    }
+  }
+}
+
+}
+
+namespace Siconos
+{
+
+void saveStateDelta(SP::Simulation s, const std::string& filename)
+{
+  std::string tempf = filename + ".tmp";
+  std::ofstream ofs(tempf.c_str(), std::ios::binary);
+  if(!ofs)
+    THROW_EXCEPTION("Siconos::saveStateDelta: cannot open " + tempf);
+
+  ofs.write(DELTA_MAGIC, sizeof(DELTA_MAGIC));
+  write_raw<double>(ofs, s->nextTime());
+
+  SP::DynamicalSystemsGraph dsg =
+    s->nonSmoothDynamicalSystem()->dynamicalSystems();
+  write_raw<std::uint64_t>(ofs, dsg->vertices_number());
+  DynamicalSystemsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = dsg->vertices(); vi != viend; ++vi)
+  {
+    SP::DynamicalSystem ds = dsg->bundle(*vi);
+    write_raw<std::uint64_t>(ofs, ds->number());
+    write_ds_state(ofs, *ds);
+  }
+
+  SP::InteractionsGraph ig =
+    s->nonSmoothDynamicalSystem()->topology()->indexSet0();
+  write_raw<std::uint64_t>(ofs, ig->vertices_number());
+  InteractionsGraph::VIterator ii, iiend;
+  for(std::tie(ii, iiend) = ig->vertices(); ii != iiend; ++ii)
+  {
+    SP::Interaction inter = ig->bundle(*ii);
+    write_raw<std::uint64_t>(ofs, inter->number());
+    write_interaction_state(ofs, *inter);
+  }
+  ofs.close();
+  if(!ofs)
+    THROW_EXCEPTION("Siconos::saveStateDelta: write failure on " + tempf);
+
+  // atomic
+  if(std::rename(tempf.c_str(), filename.c_str()) != 0)
+    THROW_EXCEPTION("Siconos::saveStateDelta: cannot rename " + tempf);
+}
+
+double loadStateDelta(SP::Simulation s, const std::string& filename)
+{
+  std::ifstream ifs(filename.c_str(), std::ios::binary);
+  if(!ifs)
+    THROW_EXCEPTION("Siconos::loadStateDelta: cannot open " + filename);
+
+  char magic[sizeof(DELTA_MAGIC)];
+  ifs.read(magic, sizeof(magic));
+  if(!ifs || std::memcmp(magic, DELTA_MAGIC, sizeof(magic)) != 0)
+    THROW_EXCEPTION("Siconos::loadStateDelta: not a state delta file: " + filename);
+
+  double time = read_raw<double>(ifs);
+
+  SP::DynamicalSystemsGraph dsg =
+    s->nonSmoothDynamicalSystem()->dynamicalSystems();
+  std::uint64_t nds = read_raw<std::uint64_t>(ifs);
+  if(nds != dsg->vertices_number())
+    THROW_EXCEPTION("Siconos::loadStateDelta: number of dynamical systems mismatch.");
+  DynamicalSystemsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = dsg->vertices(); vi != viend; ++vi)
+  {
+    SP::DynamicalSystem ds = dsg->bundle(*vi);
+    if(read_raw<std::uint64_t>(ifs) != ds->number())
+      THROW_EXCEPTION("Siconos::loadStateDelta: dynamical system numbering mismatch.");
+    read_ds_state(ifs, *ds);
+  }
+
+  SP::InteractionsGraph ig =
+    s->nonSmoothDynamicalSystem()->topology()->indexSet0();
+  std::uint64_t ninter = read_raw<std::uint64_t>(ifs);
+  if(ninter != ig->vertices_number())
+    THROW_EXCEPTION("Siconos::loadStateDelta: number of interactions mismatch.");
+  InteractionsGraph::VIterator ii, iiend;
+  for(std::tie(ii, iiend) = ig->vertices(); ii != iiend; ++ii)
+  {
+    SP::Interaction inter = ig->bundle(*ii);
+    if(read_raw<std::uint64_t>(ifs) != inter->number())
+      THROW_EXCEPTION("Siconos::loadStateDelta: interaction numbering mismatch.");
+    read_interaction_state(ifs, *inter);
+  }
+
+  return time;
+}
+}
+
+/* --- topology cache: derived acceleration structures ---
+ *
+ * Rebuilding a large model from a snapshot recomputes the index set
+ * memberships and the symbolic layout of the OSNS matrix (the
+ * absolute_position graph properties) from scratch, although both were
+ * fully known at save time. The cache below persists them in the same
+ * raw binary format as the state deltas and validates a structural hash
+ * of the topology on load, so a cache written against a different or
+ * edited model is rejected instead of silently corrupting the graphs. */
+
+namespace
+{
+
+const char TOPO_MAGIC[8] = {'S', 'i', 'c', 'T', 'o', 'p', 'o', '1'};
+
+/* FNV-1a, combined commutatively across objects so the hash does not
+   depend on the graph iteration order */
+std::uint64_t fnv1a(std::uint64_t h, std::uint64_t value)
+{
+  for(unsigned int i = 0; i < 8; ++i)
+  {
+    h ^= (value >> (8 * i)) & 0xff;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+std::uint64_t topology_hash(Simulation& s)
+{
+  const std::uint64_t seed = 14695981039346656037ULL;
+  std::uint64_t hash = 0;
+
+  SP::DynamicalSystemsGraph dsg =
+    s.nonSmoothDynamicalSystem()->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = dsg->vertices(); vi != viend; ++vi)
+  {
+    SP::DynamicalSystem ds = dsg->bundle(*vi);
+    hash += fnv1a(fnv1a(seed, ds->number()), ds->n());
+  }
+
+  SP::InteractionsGraph ig =
+    s.nonSmoothDynamicalSystem()->topology()->indexSet0();
+  InteractionsGraph::VIterator ii, iiend;
+  for(std::tie(ii, iiend) = ig->vertices(); ii != iiend; ++ii)
+  {
+    SP::Interaction inter = ig->bundle(*ii);
+    std::uint64_t h = fnv1a(fnv1a(seed, inter->number()),
+                            inter->dimension());
+    const InteractionProperties& props = ig->properties(*ii);
+    if(props.source)
+      h = fnv1a(h, props.source->number());
+    if(props.target)
+      h = fnv1a(h, props.target->number());
+    hash += h;
+  }
+  return hash;
+}
+
+}
+
+namespace Siconos
+{
+
+void saveTopologyCache(SP::Simulation s, const std::string& filename)
+{
+  SP::Topology topo = s->nonSmoothDynamicalSystem()->topology();
+
+  std::string tempf = filename + ".tmp";
+  std::ofstream ofs(tempf.c_str(), std::ios::binary);
+  if(!ofs)
+    THROW_EXCEPTION("Siconos::saveTopologyCache: cannot open " + tempf);
+
+  ofs.write(TOPO_MAGIC, sizeof(TOPO_MAGIC));
+  write_raw<std::uint64_t>(ofs, topology_hash(*s));
+  write_raw<std::uint64_t>(ofs, topo->indexSetsSize());
+
+  for(std::uint64_t level = 0; level < topo->indexSetsSize(); ++level)
+  {
+    SP::InteractionsGraph indexSet = topo->indexSet(level);
+    write_raw<std::uint64_t>(ofs, indexSet->vertices_number());
+    InteractionsGraph::VIterator ii, iiend;
+    for(std::tie(ii, iiend) = indexSet->vertices(); ii != iiend; ++ii)
+    {
+      write_raw<std::uint64_t>(ofs, indexSet->bundle(*ii)->number());
+      write_raw<std::uint32_t>(ofs, indexSet->properties(*ii).absolute_position);
+    }
+  }
+  ofs.close();
+  if(!ofs)
+    THROW_EXCEPTION("Siconos::saveTopologyCache: write failure on " + tempf);
+
+  // atomic
+  if(std::rename(tempf.c_str(), filename.c_str()) != 0)
+    THROW_EXCEPTION("Siconos::saveTopologyCache: cannot rename " + tempf);
+}
+
+void loadTopologyCache(SP::Simulation s, const std::string& filename)
+{
+  SP::Topology topo = s->nonSmoothDynamicalSystem()->topology();
+  SP::InteractionsGraph indexSet0 = topo->indexSet0();
+
+  std::ifstream ifs(filename.c_str(), std::ios::binary);
+  if(!ifs)
+    THROW_EXCEPTION("Siconos::loadTopologyCache: cannot open " + filename);
+
+  char magic[sizeof(TOPO_MAGIC)];
+  ifs.read(magic, sizeof(magic));
+  if(!ifs || std::memcmp(magic, TOPO_MAGIC, sizeof(magic)) != 0)
+    THROW_EXCEPTION("Siconos::loadTopologyCache: not a topology cache file: " + filename);
+
+  /* everything is validated before the graphs are touched */
+  if(read_raw<std::uint64_t>(ifs) != topology_hash(*s))
+    THROW_EXCEPTION("Siconos::loadTopologyCache: topology hash mismatch, the cache does not correspond to this model.");
+
+  std::uint64_t nbSets = read_raw<std::uint64_t>(ifs);
+  if(nbSets != topo->indexSetsSize())
+    THROW_EXCEPTION("Siconos::loadTopologyCache: number of index sets mismatch.");
+
+  /* interaction lookup by number, the only identity that survives a
+     save/load cycle */
+  std::map<std::uint64_t, InteractionsGraph::VDescriptor> byNumber;
+  InteractionsGraph::VIterator ii, iiend;
+  for(std::tie(ii, iiend) = indexSet0->vertices(); ii != iiend; ++ii)
+    byNumber[indexSet0->bundle(*ii)->number()] = *ii;
+
+  for(std::uint64_t level = 0; level < nbSets; ++level)
+  {
+    SP::InteractionsGraph indexSet = topo->indexSet(level);
+    std::uint64_t nb = read_raw<std::uint64_t>(ifs);
+    if(level == 0 && nb != indexSet0->vertices_number())
+      THROW_EXCEPTION("Siconos::loadTopologyCache: indexSet0 size mismatch.");
+
+    for(std::uint64_t k = 0; k < nb; ++k)
+    {
+      std::uint64_t number = read_raw<std::uint64_t>(ifs);
+      std::uint32_t position = read_raw<std::uint32_t>(ifs);
+
+      std::map<std::uint64_t, InteractionsGraph::VDescriptor>::iterator
+        found = byNumber.find(number);
+      if(found == byNumber.end())
+        THROW_EXCEPTION("Siconos::loadTopologyCache: unknown interaction in cache.");
+      SP::Interaction inter = indexSet0->bundle(found->second);
+
+      if(level > 0 && !indexSet->is_vertex(inter))
+        indexSet->copy_vertex(inter, *indexSet0);
+      indexSet->properties(indexSet->descriptor(inter)).absolute_position
+        = position;
+    }
+  }
+
+  /* memberships were restored, the first step must not assume the
+     previous symbolic data of the OSNS problems is still valid */
+  topo->setHasChanged(true);
+}
+}
@@ -44,6 +44,68 @@ void save(SP::Simulation s, const std::string& filename);
  */
 SP::Simulation load(const std::string& filename);
 
+/** Format-specific entry points. save() and load() dispatch on the file
+ *  extension and therefore link the registration machinery of every
+ *  archive format; a statically linked tool that only ever reads binary
+ *  checkpoints can call the functions below instead, so that only the
+ *  translation unit of the format it uses is pulled in. Only available
+ *  when the library is built WITH_SERIALIZATION.
+ * @{
+ */
+void saveBinary(SP::Simulation s, const std::string& filename);
+SP::Simulation loadBinary(const std::string& filename);
+void saveXml(SP::Simulation s, const std::string& filename);
+SP::Simulation loadXml(const std::string& filename);
+/**
+ * @}
+ */
+
+/** write an incremental checkpoint: a compact binary delta holding
+ *  only the mutable simulation state (dynamical system state vectors
+ *  and memories, interaction outputs/inputs and their memories), to be
+ *  applied on top of a base snapshot written with save(). The cost is
+ *  O(state), not O(model), so it is suited to frequent periodic
+ *  checkpoints. The file is written atomically (tmp file + rename).
+ * \param s a Simulation
+ * \param filename delta file name
+ */
+void saveStateDelta(SP::Simulation s, const std::string& filename);
+
+/** restore the mutable state recorded by saveStateDelta() onto a
+ *  simulation rebuilt from the matching base snapshot. The model
+ *  structure must be identical; mismatches raise an exception.
+ * \param s a Simulation loaded from the base snapshot
+ * \param filename delta file name
+ * \return the simulation time recorded in the delta (the clock is
+ *  owned by the events manager, so it is returned to the caller)
+ */
+double loadStateDelta(SP::Simulation s, const std::string& filename);
+
+/** persist the derived Topology acceleration structures: the index set
+ *  memberships (levels >= 1) and the absolute positions of the
+ *  interaction blocks in each index set, i.e. the symbolic layout the
+ *  OSNS matrix assembly derives from the graph. On a large model these
+ *  are expensive to recompute after a restart although they were fully
+ *  known at save time. The file carries a structural hash of the
+ *  topology (dynamical systems and interactions, numbers, sizes and
+ *  connectivity) so that a cache written for another model, or for an
+ *  edited one, is rejected on load.
+ * \param s a Simulation
+ * \param filename cache file name
+ */
+void saveTopologyCache(SP::Simulation s, const std::string& filename);
+
+/** restore the index set memberships and block positions recorded by
+ *  saveTopologyCache() onto a simulation rebuilt from the matching
+ *  snapshot. Must be called once the simulation is initialized (the
+ *  index sets exist). A topology hash mismatch raises an exception and
+ *  leaves the simulation untouched; recomputing from scratch is then
+ *  the correct fallback.
+ * \param s a Simulation loaded from the base snapshot
+ * \param filename cache file name
+ */
+void loadTopologyCache(SP::Simulation s, const std::string& filename);
+
 }
 
 #endif
@@ -0,0 +1,447 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*! \file KernelPerfSuite.cpp
+  \brief Performance regression suite for the kernel simulation hot path.
+
+  Not a correctness test. The suite runs a curated set of representative
+  simulations, each with a pinned number of time steps, reports the wall
+  time and the per-phase breakdown from Simulation::phaseTimers(), and
+  compares the wall times against stored baselines:
+
+    make kernel_perf
+    ./kernel/kernel_perf [baseline_file]
+
+  Baselines are machine-dependent so they are not shipped with the
+  sources: on the first run (or with --update) the suite writes the
+  measured times to the baseline file (default: kernel_perf_baselines.txt
+  in the current directory) and exits successfully; later runs fail (one
+  exit status unit per scenario) whenever a wall time exceeds its
+  baseline by more than the tolerance factor, configurable with the
+  SICONOS_PERF_TOLERANCE environment variable (default 1.25).
+
+  The scenarios only use kernel classes (the joints and the 2D contact
+  detection of a real mechanism or granular scene live in the mechanics
+  component, which the kernel cannot depend on): the mechanism chain and
+  the granular box are modelled directly with LagrangianLinearTIR
+  constraints between the systems.
+*/
+
+#include "SiconosKernel.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct ScenarioResult
+{
+  std::string name;
+  unsigned int steps = 0;
+  double seconds = 0.;
+  SP::TimeStepping simulation;
+};
+
+/** run a simulation for a pinned number of steps and record the wall time */
+ScenarioResult runScenario(const std::string& name, SP::TimeStepping simulation,
+                           unsigned int steps)
+{
+  ScenarioResult result;
+  result.name = name;
+  result.steps = steps;
+  result.simulation = simulation;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for(unsigned int k = 0; k < steps && simulation->hasNextEvent(); ++k)
+  {
+    simulation->computeOneStep();
+    simulation->nextStep();
+  }
+  result.seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+/** a swarm of independent one-degree-of-freedom balls bouncing on the
+    ground: many small interactions, no coupling between them */
+ScenarioResult bouncingBallSwarm()
+{
+  const unsigned int nBalls = 300;
+  const unsigned int steps = 1000;
+  const double t0 = 0.;
+  const double h = 1e-3;
+  const double T = t0 + (steps + 2) * h;
+  const double g = 9.81;
+  const double m = 1.;
+  const double e = 0.9;
+
+  SP::NonSmoothDynamicalSystem nsds(new NonSmoothDynamicalSystem(t0, T));
+
+  SP::NonSmoothLaw nslaw(new NewtonImpactNSL(e));
+  for(unsigned int i = 0; i < nBalls; ++i)
+  {
+    SP::SiconosVector q0(new SiconosVector(1));
+    SP::SiconosVector v0(new SiconosVector(1));
+    (*q0)(0) = 1. + 0.01 * i;
+
+    SP::SiconosMatrix M(new SimpleMatrix(1, 1));
+    (*M)(0, 0) = m;
+
+    SP::LagrangianLinearTIDS ball(new LagrangianLinearTIDS(q0, v0, M));
+    SP::SiconosVector weight(new SiconosVector(1));
+    (*weight)(0) = -m * g;
+    ball->setFExtPtr(weight);
+    nsds->insertDynamicalSystem(ball);
+
+    SP::SimpleMatrix H(new SimpleMatrix(1, 1));
+    (*H)(0, 0) = 1.;
+    SP::Relation relation(new LagrangianLinearTIR(H));
+    SP::Interaction inter(new Interaction(nslaw, relation));
+    nsds->link(inter, ball);
+  }
+
+  SP::TimeDiscretisation td(new TimeDiscretisation(t0, h));
+  SP::OneStepIntegrator osi(new MoreauJeanOSI(0.5));
+  SP::OneStepNSProblem osnspb(new LCP());
+  SP::TimeStepping simulation(new TimeStepping(nsds, td, osi, osnspb));
+
+  return runScenario("bouncing_ball_swarm", simulation, steps);
+}
+
+/** a vertical chain of masses coupled through linkage constraints, the
+    lowest one resting on the ground: one connected constraint chain, so
+    every step solves a coupled problem over all the systems */
+ScenarioResult mechanismChain()
+{
+  const unsigned int nLinks = 40;
+  const unsigned int steps = 1000;
+  const double t0 = 0.;
+  const double h = 1e-3;
+  const double T = t0 + (steps + 2) * h;
+  const double g = 9.81;
+  const double m = 1.;
+  const double gap = 1.;
+
+  SP::NonSmoothDynamicalSystem nsds(new NonSmoothDynamicalSystem(t0, T));
+
+  std::vector<SP::LagrangianLinearTIDS> links(nLinks);
+  for(unsigned int i = 0; i < nLinks; ++i)
+  {
+    SP::SiconosVector q0(new SiconosVector(1));
+    SP::SiconosVector v0(new SiconosVector(1));
+    (*q0)(0) = gap * (i + 1.5);  // above their resting positions
+
+    SP::SiconosMatrix M(new SimpleMatrix(1, 1));
+    (*M)(0, 0) = m;
+
+    links[i].reset(new LagrangianLinearTIDS(q0, v0, M));
+    SP::SiconosVector weight(new SiconosVector(1));
+    (*weight)(0) = -m * g;
+    links[i]->setFExtPtr(weight);
+    nsds->insertDynamicalSystem(links[i]);
+  }
+
+  SP::NonSmoothLaw nslaw(new NewtonImpactNSL(0.));
+
+  // ground contact of the lowest link
+  SP::SimpleMatrix H0(new SimpleMatrix(1, 1));
+  (*H0)(0, 0) = 1.;
+  SP::Relation groundRelation(new LagrangianLinearTIR(H0));
+  SP::Interaction groundInter(new Interaction(nslaw, groundRelation));
+  nsds->link(groundInter, links[0]);
+
+  // inextensible linkage between consecutive links:
+  // y = q_{i+1} - q_i - gap >= 0
+  for(unsigned int i = 0; i + 1 < nLinks; ++i)
+  {
+    SP::SimpleMatrix H(new SimpleMatrix(1, 2));
+    (*H)(0, 0) = -1.;
+    (*H)(0, 1) = 1.;
+    SP::SiconosVector b(new SiconosVector(1));
+    (*b)(0) = -gap;
+    SP::Relation relation(new LagrangianLinearTIR(H, b));
+    SP::Interaction inter(new Interaction(nslaw, relation));
+    nsds->link(inter, links[i], links[i + 1]);
+  }
+
+  SP::TimeDiscretisation td(new TimeDiscretisation(t0, h));
+  SP::OneStepIntegrator osi(new MoreauJeanOSI(0.5));
+  SP::OneStepNSProblem osnspb(new LCP());
+  SP::TimeStepping simulation(new TimeStepping(nsds, td, osi, osnspb));
+
+  return runScenario("mechanism_chain", simulation, steps);
+}
+
+/** columns of planar balls settling in a box: ground, wall and
+    ball/ball contacts, so the index sets keep changing while most
+    contacts become persistent */
+ScenarioResult granularBox2d()
+{
+  const unsigned int nColumns = 8;
+  const unsigned int nRows = 6;
+  const unsigned int steps = 1000;
+  const double t0 = 0.;
+  const double h = 1e-3;
+  const double T = t0 + (steps + 2) * h;
+  const double g = 9.81;
+  const double m = 1.;
+  const double e = 0.1;
+  const double diameter = 1.;
+  const double boxWidth = nColumns * diameter;
+
+  SP::NonSmoothDynamicalSystem nsds(new NonSmoothDynamicalSystem(t0, T));
+  SP::NonSmoothLaw nslaw(new NewtonImpactNSL(e));
+
+  std::vector<std::vector<SP::LagrangianLinearTIDS> > balls(
+    nColumns, std::vector<SP::LagrangianLinearTIDS>(nRows));
+
+  for(unsigned int i = 0; i < nColumns; ++i)
+  {
+    for(unsigned int j = 0; j < nRows; ++j)
+    {
+      SP::SiconosVector q0(new SiconosVector(2));
+      SP::SiconosVector v0(new SiconosVector(2));
+      (*q0)(0) = diameter * (i + 0.5);       // x, within the box
+      (*q0)(1) = diameter * (j + 1.) + 0.5;  // y, dropped from above
+
+      SP::SiconosMatrix M(new SimpleMatrix(2, 2));
+      (*M)(0, 0) = m;
+      (*M)(1, 1) = m;
+
+      SP::LagrangianLinearTIDS ball(new LagrangianLinearTIDS(q0, v0, M));
+      SP::SiconosVector weight(new SiconosVector(2));
+      (*weight)(1) = -m * g;
+      ball->setFExtPtr(weight);
+      nsds->insertDynamicalSystem(ball);
+      balls[i][j] = ball;
+
+      // ground : y - radius >= 0
+      SP::SimpleMatrix Hg(new SimpleMatrix(1, 2));
+      (*Hg)(0, 1) = 1.;
+      SP::SiconosVector bg(new SiconosVector(1));
+      (*bg)(0) = -0.5 * diameter;
+      SP::Relation groundRelation(new LagrangianLinearTIR(Hg, bg));
+      SP::Interaction groundInter(new Interaction(nslaw, groundRelation));
+      nsds->link(groundInter, ball);
+
+      // left wall : x - radius >= 0
+      SP::SimpleMatrix Hl(new SimpleMatrix(1, 2));
+      (*Hl)(0, 0) = 1.;
+      SP::SiconosVector bl(new SiconosVector(1));
+      (*bl)(0) = -0.5 * diameter;
+      SP::Relation leftRelation(new LagrangianLinearTIR(Hl, bl));
+      SP::Interaction leftInter(new Interaction(nslaw, leftRelation));
+      nsds->link(leftInter, ball);
+
+      // right wall : boxWidth - x - radius >= 0
+      SP::SimpleMatrix Hr(new SimpleMatrix(1, 2));
+      (*Hr)(0, 0) = -1.;
+      SP::SiconosVector br(new SiconosVector(1));
+      (*br)(0) = boxWidth - 0.5 * diameter;
+      SP::Relation rightRelation(new LagrangianLinearTIR(Hr, br));
+      SP::Interaction rightInter(new Interaction(nslaw, rightRelation));
+      nsds->link(rightInter, ball);
+
+      // contact with the ball below : y_up - y_down - diameter >= 0
+      if(j > 0)
+      {
+        SP::SimpleMatrix H(new SimpleMatrix(1, 4));
+        (*H)(0, 1) = -1.;
+        (*H)(0, 3) = 1.;
+        SP::SiconosVector b(new SiconosVector(1));
+        (*b)(0) = -diameter;
+        SP::Relation relation(new LagrangianLinearTIR(H, b));
+        SP::Interaction inter(new Interaction(nslaw, relation));
+        nsds->link(inter, balls[i][j - 1], ball);
+      }
+    }
+  }
+
+  SP::TimeDiscretisation td(new TimeDiscretisation(t0, h));
+  SP::OneStepIntegrator osi(new MoreauJeanOSI(0.5));
+  SP::OneStepNSProblem osnspb(new LCP());
+  SP::TimeStepping simulation(new TimeStepping(nsds, td, osi, osnspb));
+
+  return runScenario("granular_box_2d", simulation, steps);
+}
+
+/** an oscillating RLC circuit with ideal diodes, integrated with
+    EulerMoreauOSI: the first order path of the kernel */
+ScenarioResult diodeCircuit()
+{
+  const unsigned int nCells = 20;
+  const unsigned int steps = 5000;
+  const double t0 = 0.;
+  const double h = 1e-6;
+  const double T = t0 + (steps + 2) * h;
+  const double Lvalue = 1e-2;   // inductance
+  const double Cvalue = 1e-6;   // capacitance
+  const double Rvalue = 1e3;    // resistance
+
+  SP::NonSmoothDynamicalSystem nsds(new NonSmoothDynamicalSystem(t0, T));
+  SP::NonSmoothLaw nslaw(new ComplementarityConditionNSL(1));
+
+  for(unsigned int i = 0; i < nCells; ++i)
+  {
+    // state (v, i) of one oscillating cell
+    SP::SiconosVector x0(new SiconosVector(2));
+    (*x0)(0) = 10. + i;
+    SP::SiconosMatrix A(new SimpleMatrix(2, 2));
+    (*A)(0, 1) = -1. / Cvalue;
+    (*A)(1, 0) = 1. / Lvalue;
+    (*A)(1, 1) = -Rvalue / Lvalue;
+
+    SP::FirstOrderLinearTIDS cell(new FirstOrderLinearTIDS(x0, A));
+    nsds->insertDynamicalSystem(cell);
+
+    // ideal diode across the capacitor : 0 <= lambda complementary to y >= 0
+    SP::SimpleMatrix C(new SimpleMatrix(1, 2));
+    (*C)(0, 0) = -1.;
+    SP::SimpleMatrix D(new SimpleMatrix(1, 1));
+    (*D)(0, 0) = Rvalue;
+    SP::SimpleMatrix B(new SimpleMatrix(2, 1));
+    (*B)(0, 0) = 1. / Cvalue;
+    SP::Relation relation(new FirstOrderLinearTIR(
+                            C, D, SP::SimpleMatrix(), SP::SiconosVector(), B));
+    SP::Interaction inter(new Interaction(nslaw, relation));
+    nsds->link(inter, cell);
+  }
+
+  SP::TimeDiscretisation td(new TimeDiscretisation(t0, h));
+  SP::OneStepIntegrator osi(new EulerMoreauOSI(0.5));
+  SP::OneStepNSProblem osnspb(new LCP());
+  SP::TimeStepping simulation(new TimeStepping(nsds, td, osi, osnspb));
+
+  return runScenario("diode_circuit", simulation, steps);
+}
+
+/** read "name seconds" lines; \return false if the file cannot be read */
+bool readBaselines(const std::string& path, std::map<std::string, double>& baselines)
+{
+  std::ifstream file(path);
+  if(!file) return false;
+  std::string name;
+  double seconds;
+  while(file >> name >> seconds)
+  {
+    if(!name.empty() && name[0] == '#') continue;
+    baselines[name] = seconds;
+  }
+  return true;
+}
+
+bool writeBaselines(const std::string& path, const std::vector<ScenarioResult>& results)
+{
+  std::ofstream file(path);
+  if(!file) return false;
+  for(const ScenarioResult& r : results)
+    file << r.name << " " << r.seconds << std::endl;
+  return true;
+}
+
+void displayResult(const ScenarioResult& result)
+{
+  std::cout << result.name << " : " << result.seconds << " s over "
+            << result.steps << " steps" << std::endl;
+  SP::SimulationPhaseTimers timers = result.simulation->phaseTimers();
+  for(unsigned int i = 0; i < timers->numberOfPhases(); ++i)
+  {
+    if(timers->totalCalls(i) == 0) continue;
+    std::cout << "    " << timers->name(i) << " : "
+              << SimulationPhaseTimers::seconds(timers->totalTicks(i))
+              << " s (" << timers->totalCalls(i) << " calls)" << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  std::string baselineFile = "kernel_perf_baselines.txt";
+  bool update = false;
+  for(int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if(arg == "--update") update = true;
+    else baselineFile = arg;
+  }
+
+  double tolerance = 1.25;
+  if(const char* env = std::getenv("SICONOS_PERF_TOLERANCE"))
+    tolerance = std::atof(env);
+
+  std::vector<ScenarioResult> results;
+  try
+  {
+    results.push_back(bouncingBallSwarm());
+    results.push_back(mechanismChain());
+    results.push_back(granularBox2d());
+    results.push_back(diodeCircuit());
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << "kernel_perf : scenario failed : " << e.what() << std::endl;
+    return 1;
+  }
+
+  for(const ScenarioResult& r : results)
+    displayResult(r);
+
+  std::map<std::string, double> baselines;
+  if(update || !readBaselines(baselineFile, baselines))
+  {
+    if(!writeBaselines(baselineFile, results))
+    {
+      std::cerr << "kernel_perf : cannot write baselines to " << baselineFile
+                << std::endl;
+      return 1;
+    }
+    std::cout << "baselines written to " << baselineFile << std::endl;
+    return 0;
+  }
+
+  int regressions = 0;
+  for(const ScenarioResult& r : results)
+  {
+    std::map<std::string, double>::const_iterator it = baselines.find(r.name);
+    if(it == baselines.end())
+    {
+      std::cout << r.name << " : no baseline (run with --update to record it)"
+                << std::endl;
+      continue;
+    }
+    if(r.seconds > tolerance * it->second)
+    {
+      std::cout << r.name << " : REGRESSION, " << r.seconds << " s > "
+                << tolerance << " x " << it->second << " s" << std::endl;
+      ++regressions;
+    }
+    else
+    {
+      std::cout << r.name << " : ok (" << r.seconds << " s, baseline "
+                << it->second << " s)" << std::endl;
+    }
+  }
+  return regressions;
+}
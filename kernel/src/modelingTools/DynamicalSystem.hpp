@@ -121,6 +121,20 @@ protected:
   /** number of previous states stored in memory */
   unsigned int _stepsInMemory;
 
+  /** version counter of the state, bumped by the integrators each time
+   *  they write the state. 0 means the state is not tracked: only
+   *  integrators that bump the counter on every state update may enable
+   *  tracking, since consumers use an unchanged version to skip
+   *  recomputations. */
+  size_t _stateVersion = 0;
+
+  /** true when the system is asleep: one-step integrators and collision
+   *  engines may skip it until it is woken up. The flag is driven by
+   *  whoever implements the sleep policy (e.g. the kinetic-energy
+   *  detection of the mechanics rigid bodies); the kernel only carries
+   *  it. */
+  bool _sleeping = false;
+
   // ===== CONSTRUCTORS =====
 
   /** default constructor */
@@ -207,6 +221,41 @@ public:
     return old_n;
   }
 
+  /** returns the version counter of the state (0 if not tracked) */
+  inline size_t stateVersion() const
+  {
+    return _stateVersion;
+  }
+
+  /** enable state version tracking; to be called only by integrators
+   *  that bump the version on every state update */
+  inline void trackStateVersion()
+  {
+    if(_stateVersion == 0) _stateVersion = 1;
+  }
+
+  /** mark the state as modified (no-op if tracking is not enabled) */
+  inline void bumpStateVersion()
+  {
+    if(_stateVersion) ++_stateVersion;
+  }
+
+  /** returns true when the system is asleep (skipped by the integrators
+   *  that support sleeping) */
+  inline bool sleeping() const
+  {
+    return _sleeping;
+  }
+
+  /** put the system to sleep or wake it up
+   *
+   *  \param asleep the new value of the sleeping flag
+   */
+  inline void setSleeping(bool asleep)
+  {
+    _sleeping = asleep;
+  }
+
   /** returns the size of the vector state x */
   inline unsigned int n() const
   {
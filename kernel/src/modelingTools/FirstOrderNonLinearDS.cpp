@@ -22,6 +22,7 @@
 // #define DEBUG_MESSAGES
 // #define DEBUG_STDOUT
 #include "siconos_debug.h"
+#include <cassert>
 #include <iostream>
 
 // ===== CONSTRUCTORS =====
@@ -156,7 +157,11 @@ void FirstOrderNonLinearDS::initMemory(unsigned int steps)
   if(steps == 0)
     std::cout << "Warning : FirstOrderNonLinearDS::initMemory with size equal to zero" <<std::endl;
   else
+  {
     _rMemory.setMemorySize(steps, _n);
+    if(_retainRhsInMemory)
+      _rhsMemory.setMemorySize(steps, _n);
+  }
 }
 
 void FirstOrderNonLinearDS::swapInMemory()
@@ -164,6 +169,9 @@ void FirstOrderNonLinearDS::swapInMemory()
   DEBUG_BEGIN("void FirstOrderNonLinearDS::swapInMemory()\n");
   _xMemory.swap(*_x[0]);
   _rMemory.swap(*_r);
+  // No-op unless setRetainRhsInMemory(true) was called before init:
+  // swap returns at once on an unsized memory or a null vector.
+  _rhsMemory.swap(_x[1]);
   if(_f)
   {
     assert(_fold);
@@ -234,6 +242,39 @@ void FirstOrderNonLinearDS::computef(double time, SP::SiconosVector state)
     ((FNLDSPtrfct)_pluginf->fPtr)(time, _n, &(*state)(0), &(*_f)(0), _z->size(), &(*_z)(0));
 }
 
+void FirstOrderNonLinearDS::computefBatch(double time, const std::vector<FirstOrderNonLinearDS*>& systems)
+{
+  if(systems.empty()) return;
+
+  void * fPtrBatch = systems.front()->_pluginf->fPtrBatch;
+  if(!fPtrBatch)
+  {
+    // the plugin does not export the batched symbol: one call per system
+    for(FirstOrderNonLinearDS* ds : systems)
+      ds->computef(time, ds->x());
+    return;
+  }
+
+  // marshal the arguments of the whole batch into arrays, for a single
+  // indirect call
+  unsigned int count = systems.size();
+  std::vector<unsigned int> sizes(count), zSizes(count);
+  std::vector<double*> states(count), results(count), zs(count);
+  for(unsigned int i = 0; i < count; ++i)
+  {
+    FirstOrderNonLinearDS& ds = *systems[i];
+    assert(ds._pluginf->fPtrBatch == fPtrBatch && "computefBatch: all the systems must share the same plugin.");
+    assert(ds._f);
+    sizes[i] = ds._n;
+    states[i] = &(*ds.x())(0);
+    results[i] = &(*ds._f)(0);
+    zSizes[i] = ds._z->size();
+    zs[i] = &(*ds._z)(0);
+  }
+  ((FNLDSBatchPtrfct)fPtrBatch)(time, count, sizes.data(), states.data(),
+                                results.data(), zSizes.data(), zs.data());
+}
+
 void FirstOrderNonLinearDS::computeJacobianfx(double time, SP::SiconosVector state)
 {
   if(_jacobianfx && _pluginJacxf->fPtr)
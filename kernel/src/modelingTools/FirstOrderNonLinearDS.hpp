@@ -77,6 +77,15 @@ private:
   typedef void (*FNLDSPtrfct)(double, unsigned int, const double *, double *, unsigned int,
                               double *);
 
+  /** batched plugin signature: one call processes all the systems plugged
+   *  to the same function. Arguments: time, number of systems, then one
+   *  entry per system in each array: state size, state, result, z size, z.
+   *  Resolved from the companion symbol "<functionName>_batch" (see
+   *  PluggedObject::fPtrBatch). */
+  typedef void (*FNLDSBatchPtrfct)(double, unsigned int, const unsigned int *,
+                                   double *const *, double *const *,
+                                   const unsigned int *, double *const *);
+
 protected:
   
   ACCEPT_SERIALIZATION(FirstOrderNonLinearDS);
@@ -129,6 +138,15 @@ protected:
   /**  the previous r vectors */
   SiconosMemory _rMemory;
 
+  /** the previous rhs ( \f$ \dot x \f$ ) vectors, kept only when
+      _retainRhsInMemory is set: together with _xMemory they feed the
+      Hermite dense output of Simulation::stateAt() */
+  SiconosMemory _rhsMemory;
+
+  /** when true, initMemory() sizes _rhsMemory and swapInMemory() saves
+      \f$ \dot x \f$ along with the state; false (default) costs nothing */
+  bool _retainRhsInMemory = false;
+
   /**
       Copy of M Matrix, LU-factorized, used to solve systems like Mx = b with LU-factorization.
       (Warning: may not exist, used if we need to avoid factorization in place of M) */
@@ -257,6 +275,23 @@ public:
    */
   inline const SiconosMemory &rMemory() const { return _rMemory; }
 
+  /** get all the values of rhs ( \f$ \dot x \f$ ) stored in memory;
+   *  empty unless setRetainRhsInMemory(true) was called before the
+   *  simulation was initialized
+   *
+   *  \return a memory vector
+   */
+  inline const SiconosMemory &rhsMemory() const { return _rhsMemory; }
+
+  /** choose whether swapInMemory() also saves rhs ( \f$ \dot x \f$ ),
+   *  so that Simulation::stateAt() can evaluate a Hermite interpolant
+   *  between the saved steps; must be called before the simulation is
+   *  initialized (initMemory() sizes the extra buffer)
+   *
+   *  \param retain true to keep the rhs history
+   */
+  inline void setRetainRhsInMemory(bool retain) { _retainRhsInMemory = retain; }
+
   /** returns previous value of rhs -->OSI Related!!*/
   inline SP::SiconosVector fold() const { return _fold; }
 
@@ -343,6 +378,18 @@ public:
    */
   virtual void computef(double time, SP::SiconosVector state);
 
+  /** compute \f$ f: (x,t) \f$ for a batch of systems plugged to the same
+   *  function, with a single call to the plugin when it exports the
+   *  batched symbol (one indirect call for the whole batch, and the user
+   *  code can vectorize over the systems), one computef per system
+   *  otherwise.
+   *
+   *  \param time time instant used in the computations
+   *  \param systems the systems of the batch; they must all share the
+   *  plugin of the first one, and f is evaluated at their current state
+   */
+  static void computefBatch(double time, const std::vector<FirstOrderNonLinearDS*>& systems);
+
   /** Default function to compute  \f$  \nabla_x f: (x,t) \in R^{n}
    *  \times R \mapsto R^{n \times n} \f$ with x different from
    *  current saved state.
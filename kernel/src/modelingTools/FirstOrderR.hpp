@@ -108,13 +108,15 @@ public:
    */
   void initialize(Interaction &inter) override;
 
-  /** set C to pointer newC
+  /** set C to pointer newC. The matrix may use any SimpleMatrix storage,
+   *  including Siconos::SPARSE; the storage is preserved through the
+   *  OSNS assembly.
    *
    *  \param newC the C matrix
    */
   inline void setCPtr(SP::SimpleMatrix newC) { _C = newC; }
 
-  /** set B to pointer newB
+  /** set B to pointer newB (sparse storage accepted, see setCPtr)
    *
    *  \param newB the B matrix
    */
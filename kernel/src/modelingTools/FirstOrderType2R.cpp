@@ -77,19 +77,50 @@ void FirstOrderType2R::initialize(Interaction& inter)
 //    relationMat[FirstOrderR::mat_K].reset(new SimpleMatrix(sizeDS, sizeDS));
   // TODO add this back to workV of the DS -> needed for X partial NS
 //  }
+
+  // Bind the plugin scratch vectors to the sizes of this interaction, so
+  // that the per-step gathers of multi-block x and r reuse preallocated
+  // storage. Single-block vectors are passed to the plugins directly.
+  if(DSlink[FirstOrderR::x]->numberOfBlocks() > 1
+      && (!_workx || _workx->size() != sizeDS))
+    _workx.reset(new SiconosVector(sizeDS));
+  if(DSlink[FirstOrderR::r]->numberOfBlocks() > 1
+      && (!_workr || _workr->size() != DSlink[FirstOrderR::r]->size()))
+    _workr.reset(new SiconosVector(DSlink[FirstOrderR::r]->size()));
 }
 
 void FirstOrderType2R::computeh(double time, const BlockVector& x, const SiconosVector& lambda, SiconosVector& y)
 {
-  auto xp = x.prepareVectorForPlugin();
-  ((Type2PtrH)(_pluginh->fPtr))(xp->size(), xp->getArray(), lambda.size(), lambda.getArray(), y.size(), y.getArray());
+  // x is read-only for the plugin: gather it into the scratch bound at
+  // initialize time when it is multi-block, without allocating.
+  if(_workx && x.numberOfBlocks() > 1 && x.size() == _workx->size())
+  {
+    *_workx = x;
+    ((Type2PtrH)(_pluginh->fPtr))(_workx->size(), _workx->getArray(), lambda.size(), lambda.getArray(), y.size(), y.getArray());
+  }
+  else
+  {
+    auto xp = x.prepareVectorForPlugin();
+    ((Type2PtrH)(_pluginh->fPtr))(xp->size(), xp->getArray(), lambda.size(), lambda.getArray(), y.size(), y.getArray());
+  }
 }
 
 void FirstOrderType2R::computeg(double time, const SiconosVector& lambda, BlockVector& r)
 {
-  auto rp = r.prepareVectorForPlugin();
-  ((Type2PtrG)(_pluging->fPtr))(lambda.size(), lambda.getArray(), rp->size(), rp->getArray());
-  r = *rp;
+  if(_workr && r.numberOfBlocks() > 1 && r.size() == _workr->size())
+  {
+    *_workr = r;
+    ((Type2PtrG)(_pluging->fPtr))(lambda.size(), lambda.getArray(), _workr->size(), _workr->getArray());
+    r = *_workr;
+  }
+  else
+  {
+    auto rp = r.prepareVectorForPlugin();
+    ((Type2PtrG)(_pluging->fPtr))(lambda.size(), lambda.getArray(), rp->size(), rp->getArray());
+    // single-block r: the plugin wrote through the reference, no copy back
+    if(r.numberOfBlocks() > 1)
+      r = *rp;
+  }
 }
 
 void FirstOrderType2R::computeOutput(double time, Interaction& inter, unsigned int level)
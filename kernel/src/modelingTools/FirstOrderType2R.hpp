@@ -55,9 +55,18 @@ typedef void (*Type2PtrG)(unsigned int, double*,  unsigned int, double*);
 class FirstOrderType2R : public FirstOrderR
 {
 protected:
-  
+
   ACCEPT_SERIALIZATION(FirstOrderType2R);
 
+  /** scratch vector for the plugin calls, bound to the size of x at
+   *  initialize time: the per-step gather of a multi-block x goes into
+   *  this preallocated slot instead of a vector allocated on each call */
+  SP::SiconosVector _workx{nullptr};
+
+  /** scratch vector for the plugin calls, bound to the size of r at
+   *  initialize time */
+  SP::SiconosVector _workr{nullptr};
+
 
 public:
 
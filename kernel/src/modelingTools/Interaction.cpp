@@ -271,18 +271,27 @@ void Interaction::reset()
   // get the dimension of the non smooth law, ie the size of an Interaction blocks (one per relation)
   unsigned int nslawSize = _nslaw->size();
 
+  // vectors of the right size are kept and zeroed rather than
+  // reallocated: reset() runs again on every reuse of a pooled
+  // interaction, and keeping the buffers preserves their memory locality
   for(unsigned int i = _lowerLevelForOutput ;
       i < _upperLevelForOutput + 1 ;
       i++)
   {
-    _y[i].reset(new SiconosVector(nslawSize, 0.0));
+    if(_y[i] && _y[i]->size() == nslawSize)
+      _y[i]->zero();
+    else
+      _y[i].reset(new SiconosVector(nslawSize, 0.0));
   }
 
   for(unsigned int i = _lowerLevelForInput ;
       i < _upperLevelForInput + 1 ;
       i++)
   {
-    _lambda[i].reset(new SiconosVector(nslawSize));
+    if(_lambda[i] && _lambda[i]->size() == nslawSize)
+      _lambda[i]->zero();
+    else
+      _lambda[i].reset(new SiconosVector(nslawSize));
   }
 }
 
@@ -377,6 +386,20 @@ void Interaction::initializeMemory(unsigned int steps)
       _lambdaMemory[i].setMemorySize(steps, nslawSize);
   }
 
+  // Apply the warm-start values registered before this (re)initialization,
+  // both on lambda and on the freshly sized memory so that the OSNS warm
+  // start (which reads lambda_k) sees the carried reaction.
+  for(unsigned int i = _lowerLevelForInput ; i < _upperLevelForInput + 1 ; i++)
+  {
+    if(i < _lambdaWarmStart.size() && _lambdaWarmStart[i] && _lambda[i]
+        && _lambdaWarmStart[i]->size() == nslawSize)
+    {
+      *_lambda[i] = *_lambdaWarmStart[i];
+      _lambdaMemory[i].swap(*_lambdaWarmStart[i]);
+    }
+  }
+  _lambdaWarmStart.clear();
+
   DEBUG_END("Interaction::initializeMemory() \n");
 
 }
@@ -394,6 +417,13 @@ void Interaction::resetAllLambda()
 }
 
 
+void Interaction::setWarmStartLambda(unsigned int level, const SiconosVector& lambda0)
+{
+  if(_lambdaWarmStart.size() <= level)
+    _lambdaWarmStart.resize(level + 1);
+  _lambdaWarmStart[level].reset(new SiconosVector(lambda0));
+}
+
 void Interaction::resetLambda(unsigned int level)
 {
   if(_lambda[level])
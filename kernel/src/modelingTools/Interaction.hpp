@@ -115,6 +115,12 @@ private:
   /** memory of previous coordinates of the system */
   VectorOfMemories _lambdaMemory;
 
+  /** pending warm-start values for lambda, registered with
+   *  setWarmStartLambda() before the interaction is initialized by the
+   *  simulation and consumed (then cleared) at the end of
+   *  initializeMemory(). Empty in the common case. */
+  VectorOfVectors _lambdaWarmStart;
+
   /** the Non-smooth Law of the interaction*/
   SP::NonSmoothLaw _nslaw;
 
@@ -244,6 +250,21 @@ public:
    */
   void resetLambda(unsigned int level);
 
+  /** register a warm-start value for \f$ \lambda \f$ at a given level, to
+   *  be applied when the interaction is (re)initialized by the simulation.
+   *
+   *  Both lambda(level) and the most recent slot of the lambda memory are
+   *  seeded, so that OneStepNSProblem warm starting (see
+   *  LinearOSNS::setKeepLambdaAndYState) reads the given value instead of
+   *  zero at the first step of the interaction. Used by the collision
+   *  managers to carry the previous reaction across the destruction and
+   *  re-creation of an interaction for a physically persistent contact.
+   *
+   *  \param level lambda level to seed
+   *  \param lambda0 value of lambda for that level
+   */
+  void setWarmStartLambda(unsigned int level, const SiconosVector& lambda0);
+
   /** build memories vectors for y and \f$ \lambda \f$
    *
    *  \param computeResiduY true if interaction should compute extra residu value
@@ -138,7 +138,9 @@ public:
     return _jachlambda;
   }
 
-  /** set Jach[index] to pointer newPtr (pointer link)
+  /** set Jach[index] to pointer newPtr (pointer link). The matrix may use
+   *  any SimpleMatrix storage, including Siconos::SPARSE; the storage is
+   *  preserved through the OSNS assembly.
    *
    *  \param newPtr the new matrix
    */
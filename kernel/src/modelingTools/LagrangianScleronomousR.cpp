@@ -77,6 +77,17 @@ void LagrangianScleronomousR::initialize(Interaction& inter)
     unsigned int sizeDS = inter.getSizeOfDS();
     _jachq.reset(new SimpleMatrix(sizeY, sizeDS));
   }
+
+  // Bind the plugin scratch vectors to the sizes of this interaction, so
+  // that the per-step gathers of multi-block q and z reuse preallocated
+  // storage. Single-block vectors are passed to the plugins directly.
+  VectorOfBlockVectors& DSlink = inter.linkToDSVariables();
+  BlockVector& q0 = *DSlink[LagrangianR::q0];
+  BlockVector& z = *DSlink[LagrangianR::z];
+  if(q0.numberOfBlocks() > 1 && (!_workq || _workq->size() != q0.size()))
+    _workq.reset(new SiconosVector(q0.size()));
+  if(z.numberOfBlocks() > 1 && (!_workz || _workz->size() != z.size()))
+    _workz.reset(new SiconosVector(z.size()));
 }
 
 
@@ -85,15 +96,34 @@ void LagrangianScleronomousR::checkSize(Interaction& inter)
 
 }
 
+// Gather a block vector for a plugin call: into the scratch bound at
+// initialize time when it fits (no allocation), through
+// prepareVectorForPlugin otherwise.
+static inline SiconosVector* gatherForPlugin(const BlockVector& v,
+                                             const SP::SiconosVector& work,
+                                             SP::SiconosVector& tmp)
+{
+  if(v.numberOfBlocks() > 1 && work && work->size() == v.size())
+  {
+    *work = v;
+    return work.get();
+  }
+  tmp = v.prepareVectorForPlugin();
+  return tmp.get();
+}
+
 void LagrangianScleronomousR::computeh(const BlockVector& q, BlockVector& z, SiconosVector& y)
 {
   DEBUG_PRINT(" LagrangianScleronomousR::computeh(Interaction& inter, SP::BlockVector q, SP::BlockVector z)\n");
   if(_pluginh && _pluginh->fPtr)
   {
-    auto qp = q.prepareVectorForPlugin();
-    auto zp = z.prepareVectorForPlugin();
-    ((FPtr3)(_pluginh->fPtr))(qp->size(), &(*qp)(0), y.size(), &(y(0)), zp->size(), &(*zp)(0));
-    z = *zp;
+    SP::SiconosVector qtmp, ztmp;
+    SiconosVector* qp = gatherForPlugin(q, _workq, qtmp);
+    SiconosVector* zp = gatherForPlugin(z, _workz, ztmp);
+    ((FPtr3)(_pluginh->fPtr))(qp->size(), qp->getArray(), y.size(), &(y(0)), zp->size(), zp->getArray());
+    // single-block z: the plugin wrote through the reference, no copy back
+    if(z.numberOfBlocks() > 1)
+      z = *zp;
     DEBUG_EXPR(y.display());
 
   }
@@ -104,11 +134,13 @@ void LagrangianScleronomousR::computeJachq(const BlockVector& q, BlockVector& z)
 {
   if(_jachq && _pluginJachq->fPtr)
   {
-    auto qp = q.prepareVectorForPlugin();
-    auto zp = z.prepareVectorForPlugin();
+    SP::SiconosVector qtmp, ztmp;
+    SiconosVector* qp = gatherForPlugin(q, _workq, qtmp);
+    SiconosVector* zp = gatherForPlugin(z, _workz, ztmp);
     // get vector lambda of the current interaction
-    ((FPtr3)(_pluginJachq->fPtr))(qp->size(), &(*qp)(0), _jachq->size(0), &(*_jachq)(0, 0), zp->size(), &(*zp)(0));
-    z = *zp;
+    ((FPtr3)(_pluginJachq->fPtr))(qp->size(), qp->getArray(), _jachq->size(0), &(*_jachq)(0, 0), zp->size(), zp->getArray());
+    if(z.numberOfBlocks() > 1)
+      z = *zp;
   }
 }
 
@@ -116,11 +148,13 @@ void LagrangianScleronomousR::computeDotJachq(const BlockVector& q, BlockVector&
 {
   if(_dotjachq && _plugindotjacqh->fPtr)
   {
-    auto qp = q.prepareVectorForPlugin();
-    auto zp = z.prepareVectorForPlugin();
+    SP::SiconosVector qtmp, ztmp;
+    SiconosVector* qp = gatherForPlugin(q, _workq, qtmp);
+    SiconosVector* zp = gatherForPlugin(z, _workz, ztmp);
     auto qdotp = qDot.prepareVectorForPlugin();
-    ((FPtr2)(_plugindotjacqh->fPtr))(qp->size(), &(*qp)(0), qdotp->size(), &(*qdotp)(0), &(*_dotjachq)(0, 0), zp->size(), &(*zp)(0));
-    z = *zp;
+    ((FPtr2)(_plugindotjacqh->fPtr))(qp->size(), qp->getArray(), qdotp->size(), &(*qdotp)(0), &(*_dotjachq)(0, 0), zp->size(), zp->getArray());
+    if(z.numberOfBlocks() > 1)
+      z = *zp;
   }
 }
 
@@ -129,7 +163,8 @@ void  LagrangianScleronomousR::computedotjacqhXqdot(double time, Interaction& in
   DEBUG_PRINT("LagrangianScleronomousR::computeNonLinearH2dot starts");
   // Compute the H Jacobian dot
   LagrangianScleronomousR::computeDotJachq(*DSlink[LagrangianR::q0], *DSlink[LagrangianR::z], *DSlink[LagrangianR::q1]);
-  _dotjacqhXqdot.reset(new SiconosVector(_dotjachq->size(0)));
+  if(!_dotjacqhXqdot || _dotjacqhXqdot->size() != _dotjachq->size(0))
+    _dotjacqhXqdot.reset(new SiconosVector(_dotjachq->size(0)));
   DEBUG_EXPR(_dotjachq->display(););
   prod(*_dotjachq, *DSlink[LagrangianR::q1], *_dotjacqhXqdot);
   DEBUG_PRINT("LagrangianScleronomousR::computeNonLinearH2dot ends");
@@ -132,6 +132,17 @@ protected:
   /** Product of the time--derivative of Jacobian with the velocity qdot */
   SP::SiconosVector _dotjacqhXqdot{nullptr};
 
+  /** scratch vector for the plugin calls, bound to the size of q at
+   *  initialize time: the per-step gather of a multi-block q goes into
+   *  this preallocated slot instead of a vector allocated on each call.
+   *  Compiled evaluators can be registered directly with
+   *  PluggedObject::setComputeFunction(void*) on the plugin objects. */
+  SP::SiconosVector _workq{nullptr};
+
+  /** scratch vector for the plugin calls, bound to the size of z at
+   *  initialize time */
+  SP::SiconosVector _workz{nullptr};
+
   /** reset all plugins */
   void _zeroPlugin() override;
 
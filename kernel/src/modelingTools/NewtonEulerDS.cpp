@@ -199,6 +199,7 @@ void NewtonEulerDS::_init()
   _mass.reset(new SimpleMatrix(_ndof, _ndof));
   _mass->zero();
   _T.reset(new SimpleMatrix(_qDim, _ndof));
+  _TCacheValid = false;
 
   _scalarMass = 1.;
   _I.reset(new SimpleMatrix(3, 3));
@@ -1182,7 +1183,20 @@ void NewtonEulerDS::resetNonSmoothPart(unsigned int level)
 
 void NewtonEulerDS::computeT()
 {
+  /* _T only depends on the quaternion part of q: skip the rebuild when
+   * the orientation has not moved since the last call */
+  if(_TCacheValid
+      && _TCachedQuaternion[0] == (*_q)(3)
+      && _TCachedQuaternion[1] == (*_q)(4)
+      && _TCachedQuaternion[2] == (*_q)(5)
+      && _TCachedQuaternion[3] == (*_q)(6))
+    return;
   ::computeT(_q,_T);
+  _TCachedQuaternion[0] = (*_q)(3);
+  _TCachedQuaternion[1] = (*_q)(4);
+  _TCachedQuaternion[2] = (*_q)(5);
+  _TCachedQuaternion[3] = (*_q)(6);
+  _TCacheValid = true;
 }
 
 
@@ -142,6 +142,13 @@ protected:
    */
   SP::SimpleMatrix _Tdot;
 
+  /** quaternion value used for the last update of _T, so that computeT()
+   *  can skip the rebuild when the orientation has not moved since */
+  double _TCachedQuaternion[4];
+
+  /** true once _TCachedQuaternion holds the quaternion matching _T */
+  bool _TCacheValid;
+
   /** external forces of the system */
   SP::SiconosVector _fExt;
 
@@ -78,7 +78,7 @@ public:
    *
    *  \param newVal a double to set en
    */
-  inline void setEn(double newVal) { _en = newVal; };
+  inline void setEn(double newVal) { _en = newVal; bumpParametersRevision(); };
 
   /** \return the value of et
    */
@@ -88,7 +88,7 @@ public:
    *
    *  \param newVal a double to set et
    */
-  inline void setEt(double newVal) { _et = newVal; };
+  inline void setEt(double newVal) { _et = newVal; bumpParametersRevision(); };
 
   /** \return the value of mu
    */
@@ -98,7 +98,7 @@ public:
    *
    *  \param newVal a double to set mu
    */
-  inline void setMu(double newVal) { _mu = newVal; };
+  inline void setMu(double newVal) { _mu = newVal; bumpParametersRevision(); };
 
   // OTHER FUNCTIONS
 
@@ -81,7 +81,7 @@ public:
    *
    *  \param newVal a double to set e
    */
-  inline void setE(double newVal) { _e = newVal; };
+  inline void setE(double newVal) { _e = newVal; bumpParametersRevision(); };
 
   /** print the data to the screen
    */
@@ -84,7 +84,7 @@ public:
    *
    *  \param newVal a double to set en
    */
-  inline void setEn(double newVal) { _en = newVal; };
+  inline void setEn(double newVal) { _en = newVal; bumpParametersRevision(); };
 
   /** \return the value of et
    */
@@ -94,7 +94,7 @@ public:
    *
    *  \param newVal a double to set et
    */
-  inline void setEt(double newVal) { _et = newVal; };
+  inline void setEt(double newVal) { _et = newVal; bumpParametersRevision(); };
 
   /** \return the value of mu
    */
@@ -108,13 +108,13 @@ public:
    *
    *  \param newVal a double to set mu
    */
-  inline void setMu(double newVal) { _mu = newVal; };
+  inline void setMu(double newVal) { _mu = newVal; bumpParametersRevision(); };
 
   /** setter of muR
    *
    *  \param newVal a double to set muR
    */
-  inline void setMuR(double newVal) { _muR = newVal; };
+  inline void setMuR(double newVal) { _muR = newVal; bumpParametersRevision(); };
 
   // OTHER FUNCTIONS
 
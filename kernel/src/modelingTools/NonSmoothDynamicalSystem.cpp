@@ -18,6 +18,7 @@
 #include "NonSmoothDynamicalSystem.hpp"
 #include "Interaction.hpp"
 #include "Relation.hpp"
+#include "SimulationGraphs.hpp" // for parallelForVertices, parallelForIndependentVertices
 
 #include <SiconosConfig.h>
 #include <functional>
@@ -144,6 +145,32 @@ void NonSmoothDynamicalSystem::link(SP::Interaction inter, SP::DynamicalSystem d
   _changeLog.push_back(Change(addInteraction,inter));
 };
 
+void NonSmoothDynamicalSystem::stageLink(SP::Interaction inter, SP::DynamicalSystem ds1, SP::DynamicalSystem ds2)
+{
+  _stagedLinks.push_back(Topology::LinkSpec{inter, ds1, ds2});
+}
+
+void NonSmoothDynamicalSystem::applyStagedLinks()
+{
+  if(_stagedLinks.empty()) return;
+
+  for(const Topology::LinkSpec& l : _stagedLinks)
+    _mIsLinear = (l.interaction->relation()->isLinear() && _mIsLinear);
+
+  _topology->linkBatch(_stagedLinks);
+
+  for(const Topology::LinkSpec& l : _stagedLinks)
+    _changeLog.push_back(Change(addInteraction, l.interaction));
+  _stagedLinks.clear();
+}
+
+void NonSmoothDynamicalSystem::removeInteractions(const std::vector<SP::Interaction>& interactions)
+{
+  _topology->removeInteractionBatch(interactions);
+  for(const SP::Interaction& inter : interactions)
+    _changeLog.push_back(Change(rmInteraction, inter));
+}
+
 
 void NonSmoothDynamicalSystem::clear()
 {
@@ -224,17 +251,19 @@ void NonSmoothDynamicalSystem::updateInput(double time, unsigned int level)
   // Set dynamical systems non-smooth part to zero.
   reset(level);
 
-  // We compute input using lambda(level).
-  InteractionsGraph::VIterator ui, uiend;
-  SP::Interaction inter;
+  // We compute input using lambda(level).  The interactions accumulate
+  // into the p vectors of the dynamical systems they link: interactions
+  // sharing a DS are adjacent in indexSet0, so conflict-free batches are
+  // processed in parallel.
   SP::InteractionsGraph indexSet0 = _topology->indexSet0();
-  for(std::tie(ui, uiend) = indexSet0->vertices(); ui != uiend; ++ui)
+  parallelForIndependentVertices(*indexSet0, _updateInputBatches,
+                                 [time, level, &indexSet0](const InteractionsGraph::VDescriptor& vd)
   {
-    inter = indexSet0->bundle(*ui);
+    SP::Interaction inter = indexSet0->bundle(vd);
     assert(inter->lowerLevelForInput() <= level);
     assert(inter->upperLevelForInput() >= level);
     inter->computeInput(time, level);
-  }
+  });
 
   DEBUG_END("Nonsmoothdynamicalsystem::updateInput(double time, unsigned int level)\n");
 
@@ -249,16 +278,18 @@ void NonSmoothDynamicalSystem::updateOutput(double time, unsigned int level)
 
   DEBUG_BEGIN("NonSmoothDynamicalSystem::updateOutput(unsigned int level)\n");
   DEBUG_PRINTF("with level = %i\n", level);
-  InteractionsGraph::VIterator ui, uiend;
-  SP::Interaction inter;
+  // Each interaction writes into its own y: the whole set is processed in
+  // parallel.  A Relation instance shared between several interactions
+  // must not hold mutable state for this to be safe.
   SP::InteractionsGraph indexSet0 = _topology->indexSet0();
-  for(std::tie(ui, uiend) = indexSet0->vertices(); ui != uiend; ++ui)
+  parallelForVertices(*indexSet0,
+                      [time, level, &indexSet0](const InteractionsGraph::VDescriptor& vd)
   {
-    inter = indexSet0->bundle(*ui);
+    SP::Interaction inter = indexSet0->bundle(vd);
     assert(inter->lowerLevelForOutput() <= level);
     assert(inter->upperLevelForOutput() >= level);
     inter->computeOutput(time, level);
-  }
+  });
   DEBUG_END("NonSmoothDynamicalSystem::updateOutput(unsigned int level)\n");
 }
 
@@ -270,17 +301,44 @@ void NonSmoothDynamicalSystem::updateOutput(double time, unsigned int level_min,
   // and for a range of levels in a single pass through I0.
   //  assert(level>=0);
 
-  InteractionsGraph::VIterator ui, uiend;
-  SP::Interaction inter;
   SP::InteractionsGraph indexSet0 = _topology->indexSet0();
-  for(std::tie(ui, uiend) = indexSet0->vertices(); ui != uiend; ++ui)
+  parallelForVertices(*indexSet0,
+                      [time, level_min, level_max, &indexSet0](const InteractionsGraph::VDescriptor& vd)
   {
-    inter = indexSet0->bundle(*ui);
+    SP::Interaction inter = indexSet0->bundle(vd);
     assert(inter->lowerLevelForOutput() <= level_max);
     assert(inter->upperLevelForOutput() >= level_min);
+
+    // The outputs of relations depending only on (q, v, t) are reused
+    // when the connected systems have not moved since the last pass.
+    // A state version of 0 means the integrator does not track state
+    // changes for this system: never skip then.
+    InteractionProperties& props = indexSet0->properties(vd);
+    RELATION::TYPES relType = inter->relation()->getType();
+    bool cacheable = relType == RELATION::NewtonEuler
+                     || (relType == RELATION::Lagrangian
+                         && inter->relation()->getSubType() == RELATION::ScleronomousR);
+    size_t sourceVersion = props.source ? props.source->stateVersion() : 0;
+    size_t targetVersion = props.target ? props.target->stateVersion() : 0;
+    if(cacheable && props.output_uptodate
+        && sourceVersion != 0 && targetVersion != 0
+        && props.output_source_version == sourceVersion
+        && props.output_target_version == targetVersion
+        && props.output_time == time
+        && props.output_level_min == level_min
+        && props.output_level_max == level_max)
+      return;
+
     for(unsigned int level = level_min; level<=level_max; ++level)
       inter->computeOutput(time, level);
-  }
+
+    props.output_uptodate = cacheable;
+    props.output_source_version = sourceVersion;
+    props.output_target_version = targetVersion;
+    props.output_time = time;
+    props.output_level_min = level_min;
+    props.output_level_max = level_max;
+  });
 }
 
 void NonSmoothDynamicalSystem::computeInteractionJacobians(double time)
@@ -105,9 +105,16 @@ private:
   /** log list of the modifications of the nsds */
   std::list<Change> _changeLog;
 
+  /** links staged by stageLink(), waiting for applyStagedLinks() */
+  std::vector<Topology::LinkSpec> _stagedLinks;
+
   /** the topology of the system */
   SP::Topology _topology;
 
+  /** conflict-free interaction batches of updateInput, rebuilt only when
+      the indexSet0 stamp changes (unused in a build without OpenMP) */
+  IndependentVertexBatches<InteractionsGraph> _updateInputBatches;
+
   /** False is one of the interaction is non-linear.
    */
   bool _mIsLinear = true;
@@ -441,6 +448,31 @@ public:
    */
   void link(SP::Interaction inter, SP::DynamicalSystem ds1, SP::DynamicalSystem ds2 = SP::DynamicalSystem());
 
+  /** stage a link for applyStagedLinks(). Nothing is inserted into the
+   *  topology until applyStagedLinks() is called.
+   *
+   *  \param inter the interaction
+   *  \param ds1 a DynamicalSystem
+   *  \param ds2 a DynamicalSystem (optional)
+   */
+  void stageLink(SP::Interaction inter, SP::DynamicalSystem ds1, SP::DynamicalSystem ds2 = SP::DynamicalSystem());
+
+  /** insert all the links staged with stageLink() in one pass.
+   *
+   *  Equivalent to calling link() on each staged triple, but the graph
+   *  indices are rebuilt once for the whole batch (see
+   *  Topology::linkBatch). To be preferred when many interactions are
+   *  created at the same time, as collision managers do.
+   */
+  void applyStagedLinks();
+
+  /** remove a batch of interactions in one pass (see
+   *  Topology::removeInteractionBatch)
+   *
+   *  \param interactions the interactions to remove
+   */
+  void removeInteractions(const std::vector<SP::Interaction>& interactions);
+
   /** set the name for this Dynamical System
    *
    *  \param ds a pointer to the system
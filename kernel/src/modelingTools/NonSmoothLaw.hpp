@@ -28,6 +28,7 @@
 #include "SiconosPointers.hpp"
 #include "SiconosSerialization.hpp" // For ACCEPT_SERIALIZATION
 #include "SiconosVisitor.hpp"
+#include <cstddef> // for std::size_t (parametersRevision)
 
 /**
    Non Smooth Laws (NSL) Base Class
@@ -61,6 +62,9 @@ protected:
   /** "size" of the NonSmoothLaw */
   unsigned int _size{0};
 
+  /** global revision of the law parameters, see parametersRevision() */
+  static inline std::size_t _parametersRevision = 0;
+
   // Rule of five ...
   NonSmoothLaw() = default;
   NonSmoothLaw(const NonSmoothLaw &) = delete;
@@ -91,6 +95,16 @@ public:
   /** \return the size of the NS law */
   inline unsigned int size() const { return _size; }
 
+  /** \return the global revision of the law parameters, bumped by every
+      parameter setter of the derived laws; caches of flattened parameter
+      arrays (see FrictionContact::updateMu) compare it to know when to
+      rebuild, without touching each law */
+  static std::size_t parametersRevision() { return _parametersRevision; }
+
+  /** note a parameter change; called by the parameter setters of the
+      derived laws */
+  static void bumpParametersRevision() { ++_parametersRevision; }
+
   /** display the data of the NonSmoothLaw on the standard output */
   virtual void display() const = 0;
 
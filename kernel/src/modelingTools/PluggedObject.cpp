@@ -23,11 +23,13 @@
 PluggedObject::PluggedObject(): _pluginName("unplugged")
 {
   fPtr = nullptr;
+  fPtrBatch = nullptr;
 }
 
 PluggedObject::PluggedObject(const std::string& name): _pluginName(name)
 {
   fPtr = nullptr;
+  fPtrBatch = nullptr;
   setComputeFunction();
 }
 
@@ -35,6 +37,7 @@ PluggedObject::PluggedObject(const PluggedObject & PO):  _pluginName(PO.pluginNa
 {
   // we don't copy the fPtr since we need to increment the number of times we opened the plugin file in the openedPlugins multimap
   fPtr = nullptr;
+  fPtrBatch = nullptr;
   if((_pluginName.compare("unplugged") != 0) && (_pluginName.compare("Unknown") != 0))
     setComputeFunction();
 }
@@ -51,11 +54,13 @@ void PluggedObject::setComputeFunction(const std::string& pluginPath, const std:
   if(ext.compare(pluginPath.substr(pluginPath.size() - ext.size())) == 0)
   {
     SSLH::setFunction(&fPtr, pluginPath, functionName);
+    SSLH::setFunctionIfPresent(&fPtrBatch, pluginPath, functionName + "_batch");
     _pluginName = pluginPath.substr(0, pluginPath.find_last_of(".")) + ":" + functionName;
   }
   else
   {
     SSLH::setFunction(&fPtr, pluginPath + ext, functionName);
+    SSLH::setFunctionIfPresent(&fPtrBatch, pluginPath + ext, functionName + "_batch");
     _pluginName = pluginPath + ":" + functionName;
   }
 }
@@ -63,6 +68,7 @@ void PluggedObject::setComputeFunction(const std::string& pluginPath, const std:
 void PluggedObject::setComputeFunction(const std::string& plugin)
 {
   SSLH::setFunction(&fPtr, SSLH::getPluginName(plugin), SSLH::getPluginFunctionName(plugin));
+  SSLH::setFunctionIfPresent(&fPtrBatch, SSLH::getPluginName(plugin), SSLH::getPluginFunctionName(plugin) + "_batch");
   _pluginName = plugin;
 }
 
@@ -70,4 +76,5 @@ void PluggedObject::setComputeFunction(void)
 {
   assert(_pluginName != "unplugged" && "PluggedObject::setComputeFunction error, try to plug an unnamed function.");
   SSLH::setFunction(&fPtr, SSLH::getPluginName(_pluginName), SSLH::getPluginFunctionName(_pluginName));
+  SSLH::setFunctionIfPresent(&fPtrBatch, SSLH::getPluginName(_pluginName), SSLH::getPluginFunctionName(_pluginName) + "_batch");
 }
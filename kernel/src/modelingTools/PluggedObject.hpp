@@ -51,6 +51,13 @@ public:
   /** plug-in */
   void * fPtr;
 
+  /** batched variant of the plug-in, resolved from the companion symbol
+   *  "<functionName>_batch" when the plugin exports it, nullptr otherwise.
+   *  A batched function processes in one call the arrays of states of all
+   *  the systems plugged to the same function, so that the user code can
+   *  vectorize over them. */
+  void * fPtrBatch;
+
   /** Default Constructor
    */
   PluggedObject();
@@ -73,6 +80,12 @@ public:
     return (fPtr != nullptr);
   };
 
+  /** \return true if the plugin exports the batched variant of the function */
+  inline bool isBatchPlugged() const
+  {
+    return (fPtrBatch != nullptr);
+  };
+
   /** destructor
    */
   virtual ~PluggedObject();
@@ -99,6 +112,7 @@ public:
   inline void setComputeFunction(void* functionPtr)
   {
     fPtr = functionPtr;
+    fPtrBatch = nullptr;
     _pluginName = "Unknown";
   };
 
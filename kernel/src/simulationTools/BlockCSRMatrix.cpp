@@ -25,6 +25,8 @@
 
 #include "NewtonEulerDS.hpp"
 #include "NewtonEulerR.hpp"
+#include "SecondOrderDS.hpp"       // for the symbolic cross-block pruning
+#include "BoundaryCondition.hpp"   // for the symbolic cross-block pruning
 #include "SimulationGraphs.hpp"
 #include "SparseBlockMatrix.h" // From numerics, for SparseBlockStructuredMatrix
 #include "Tools.hpp"
@@ -79,6 +81,16 @@ BlockCSRMatrix::BlockCSRMatrix(InteractionsGraph& indexSet):
 BlockCSRMatrix::~BlockCSRMatrix()
 {}
 
+// A system whose velocity is entirely clamped by boundary conditions
+// transmits no coupling between the interactions it connects: the cross
+// blocks built through it are zero whatever the dynamics.
+static bool transmitsNoCoupling(DynamicalSystem& ds)
+{
+  SecondOrderDS* sods = dynamic_cast<SecondOrderDS*>(&ds);
+  return sods && sods->boundaryConditions()
+         && sods->boundaryConditions()->velocityIndices()->size() >= sods->dimension();
+}
+
 // Fill the SparseMat
 void BlockCSRMatrix::fill(InteractionsGraph& indexSet)
 {
@@ -119,6 +131,7 @@ void BlockCSRMatrix::fill(InteractionsGraph& indexSet)
       indexSet.properties(*vi).block->getArray();
   }
 
+  _nbPrunedBlocks = 0;
   InteractionsGraph::EIterator ei, eiend;
   for(std::tie(ei, eiend) = indexSet.edges();
       ei != eiend; ++ei)
@@ -142,6 +155,31 @@ void BlockCSRMatrix::fill(InteractionsGraph& indexSet)
 
     assert(pos != col);
 
+    // symbolic suppression: the pair only couples through clamped
+    // systems (there are at most two edges between two interactions,
+    // one per shared system; both edges carry the same block pointers,
+    // so skipping each visit of the pair is consistent)
+    if(_pruneStaticCrossBlocks)
+    {
+      InteractionsGraph::EDescriptor ed1, ed2;
+      std::tie(ed1, ed2) = indexSet.edges(vd1, vd2);
+      if(transmitsNoCoupling(*indexSet.bundle(ed1))
+          && (ed1 == ed2 || transmitsNoCoupling(*indexSet.bundle(ed2))))
+      {
+        ++_nbPrunedBlocks;
+        continue;
+      }
+    }
+
+    // magnitude pruning: drop the pair when both blocks are negligible
+    if(_blockPruningThreshold > 0.
+        && indexSet.properties(*ei).upper_block->normInf() <= _blockPruningThreshold
+        && indexSet.properties(*ei).lower_block->normInf() <= _blockPruningThreshold)
+    {
+      ++_nbPrunedBlocks;
+      continue;
+    }
+
     (*_blockCSR)(std::min(pos, col), std::max(pos, col)) =
       indexSet.properties(*ei).upper_block->getArray();
 
@@ -305,6 +343,117 @@ void BlockCSRMatrix::convert()
   DEBUG_END("void BlockCSRMatrix::convert()\n");
 }
 
+// Symbolic pass of the direct CSR assembly: computed once per block
+// pattern, then reused across steps by fillCSR().
+void BlockCSRMatrix::computeCSRLayout()
+{
+  DEBUG_BEGIN("void BlockCSRMatrix::computeCSRLayout()\n");
+  const auto& idx1 = _blockCSR->index1_data();
+  const auto& idx2 = _blockCSR->index2_data();
+  std::size_t nBlockRows = _blockCSR->filled1() ? _blockCSR->filled1() - 1 : 0;
+  std::size_t nbRows = (_nr > 0) ? (*_diagsize0)[_nr - 1] : 0;
+
+  _csrRowPtr.assign(nbRows + 1, 0);
+  _csrSegmentOffset.resize(_blockCSR->filled2());
+
+  // Row widths: every scalar row of a block row crosses the same
+  // column segments, whose in-row offsets are recorded per block.
+  for(std::size_t i = 0; i < nBlockRows; ++i)
+  {
+    std::size_t segOffset = 0;
+    for(std::size_t k = idx1[i]; k < idx1[i + 1]; ++k)
+    {
+      _csrSegmentOffset[k] = segOffset;
+      std::size_t j = idx2[k];
+      // all blocks of block column j share its width
+      segOffset += (*_diagsize1)[j] - ((j > 0) ? (*_diagsize1)[j - 1] : 0);
+    }
+    std::size_t row0 = (i > 0) ? (*_diagsize0)[i - 1] : 0;
+    for(std::size_t r = row0; r < (*_diagsize0)[i]; ++r)
+      _csrRowPtr[r + 1] = segOffset;
+  }
+
+  for(std::size_t r = 0; r < nbRows; ++r)
+    _csrRowPtr[r + 1] += _csrRowPtr[r];
+
+  std::size_t nnz = _csrRowPtr[nbRows];
+  _csrColInd.resize(nnz);
+  _csrValues.resize(nnz);
+
+  // Column indices; blocks of a row are stored by increasing column
+  // index so the scalar columns come out sorted, as CSR expects.
+  for(std::size_t i = 0; i < nBlockRows; ++i)
+  {
+    std::size_t row0 = (i > 0) ? (*_diagsize0)[i - 1] : 0;
+    for(std::size_t k = idx1[i]; k < idx1[i + 1]; ++k)
+    {
+      std::size_t j = idx2[k];
+      std::size_t col0 = (j > 0) ? (*_diagsize1)[j - 1] : 0;
+      std::size_t blockCols = (*_diagsize1)[j] - col0;
+      for(std::size_t r = row0; r < (*_diagsize0)[i]; ++r)
+      {
+        std::size_t dest = _csrRowPtr[r] + _csrSegmentOffset[k];
+        for(std::size_t lc = 0; lc < blockCols; ++lc)
+          _csrColInd[dest + lc] = col0 + lc;
+      }
+    }
+  }
+  DEBUG_END("void BlockCSRMatrix::computeCSRLayout()\n");
+}
+
+void BlockCSRMatrix::fillCSR()
+{
+  DEBUG_BEGIN("void BlockCSRMatrix::fillCSR()\n");
+  const auto& idx1 = _blockCSR->index1_data();
+  const auto& idx2 = _blockCSR->index2_data();
+  std::size_t nBlockRows = _blockCSR->filled1() ? _blockCSR->filled1() - 1 : 0;
+
+  // Reuse the symbolic layout as long as the block pattern is the
+  // same; the signature is a flat copy of the pattern data, cheap to
+  // compare next to the value fill itself.
+  std::vector<std::size_t> signature;
+  signature.reserve(2 + _blockCSR->filled1() + _blockCSR->filled2() + 2 * _nr);
+  signature.push_back(_blockCSR->filled1());
+  signature.push_back(_blockCSR->filled2());
+  signature.insert(signature.end(), idx1.begin(), idx1.begin() + _blockCSR->filled1());
+  signature.insert(signature.end(), idx2.begin(), idx2.begin() + _blockCSR->filled2());
+  signature.insert(signature.end(), _diagsize0->begin(), _diagsize0->end());
+  signature.insert(signature.end(), _diagsize1->begin(), _diagsize1->end());
+  if(signature != _csrLayoutSignature)
+  {
+    computeCSRLayout();
+    _csrLayoutSignature.swap(signature);
+  }
+
+  // Value fill: every block entry goes straight to its final place in
+  // _csrValues. Block rows write disjoint ranges, hence the parallel
+  // loop. Blocks are column-major (DenseMat arrays, cf convert()).
+  const auto& values = _blockCSR->value_data();
+  int nbBlockRows = (int)nBlockRows;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(nbBlockRows > 16)
+#endif
+  for(int i = 0; i < nbBlockRows; ++i)
+  {
+    std::size_t row0 = (i > 0) ? (*_diagsize0)[i - 1] : 0;
+    std::size_t blockRows = (*_diagsize0)[i] - row0;
+    for(std::size_t k = idx1[i]; k < idx1[i + 1]; ++k)
+    {
+      std::size_t j = idx2[k];
+      std::size_t col0 = (j > 0) ? (*_diagsize1)[j - 1] : 0;
+      std::size_t blockCols = (*_diagsize1)[j] - col0;
+      const double * block = values[k];
+      for(std::size_t lr = 0; lr < blockRows; ++lr)
+      {
+        std::size_t dest = _csrRowPtr[row0 + lr] + _csrSegmentOffset[k];
+        for(std::size_t lc = 0; lc < blockCols; ++lc)
+          _csrValues[dest + lc] = block[lr + lc * blockRows];
+      }
+    }
+  }
+  DEBUG_END("void BlockCSRMatrix::fillCSR()\n");
+}
+
 // Display data
 void BlockCSRMatrix::display() const
 {
@@ -27,6 +27,7 @@ Definition of a compressed row sparse block matrix of SiconosMatrix*
 #include "SimulationTypeDef.hpp"
 
 #include <boost/numeric/ublas/fwd.hpp> // Boost forward declarations
+#include <vector>                      // for the scalar CSR arrays
 
 /* with signed int typedef  boost::numeric::ublas::compressed_matrix<double*>
  * CompressedRowMat; */
@@ -132,6 +133,43 @@ private:
   /** List of non null blocks positions (in col) */
   SP::IndexInt colPos;
 
+  /** Scalar CSR image of the block matrix, assembled by fillCSR().
+      The three arrays follow the usual CSR convention (_csrRowPtr of
+      size nbRows+1, _csrColInd and _csrValues of size nnz) and are
+      reused from one step to the next. */
+  std::vector<std::size_t> _csrRowPtr;
+  std::vector<std::size_t> _csrColInd;
+  std::vector<double> _csrValues;
+
+  /** For each non-null block (in storage order), offset of its column
+      segment inside the scalar rows of its block row. Together with
+      _csrRowPtr it gives the final destination of every block entry,
+      so the value fill writes _csrValues in a single pass. */
+  std::vector<std::size_t> _csrSegmentOffset;
+
+  /** Signature of the block layout (filled1/filled2, index data and
+      diagonal sizes) used to decide whether the symbolic CSR arrays
+      can be reused or must be recomputed. */
+  std::vector<std::size_t> _csrLayoutSignature;
+
+  /** rebuild _csrRowPtr, _csrColInd and _csrSegmentOffset from the
+      current block pattern (symbolic pass of fillCSR) */
+  void computeCSRLayout();
+
+  /** magnitude threshold of the cross-block pruning in fill(): an
+      off-diagonal pair whose two blocks have an infinity norm at or
+      below the threshold is left out of the pattern (0, the default,
+      keeps every block) */
+  double _blockPruningThreshold = 0.;
+
+  /** when true, fill() leaves out the cross blocks of interaction pairs
+      whose only shared systems are fully clamped by boundary conditions:
+      such systems transmit no coupling, the blocks are provably zero */
+  bool _pruneStaticCrossBlocks = false;
+
+  /** number of cross-block pairs pruned by the last fill() */
+  unsigned int _nbPrunedBlocks = 0;
+
   /** Private copy constructor => no copy nor pass by value */
   BlockCSRMatrix(const BlockCSRMatrix &);
 
@@ -214,6 +252,34 @@ public:
       return colPos;
   };
 
+  /** set the magnitude threshold of the cross-block pruning: during
+   *  fill(), an off-diagonal block pair whose two blocks have an
+   *  infinity norm at or below the threshold is left out of the pattern
+   *  handed to the solver. Diagonal blocks are never pruned.
+   *
+   *  \param threshold the pruning threshold (0 keeps every block)
+   */
+  inline void setBlockPruningThreshold(double threshold)
+  {
+    _blockPruningThreshold = threshold;
+  };
+
+  /** enable the symbolic suppression of provably-zero cross blocks:
+   *  during fill(), the blocks of interaction pairs whose shared
+   *  dynamical systems are all fully clamped by boundary conditions are
+   *  left out -- a clamped system transmits no coupling, whatever the
+   *  values the blocks hold.
+   *
+   *  \param enable true to suppress those blocks
+   */
+  inline void setPruneStaticCrossBlocks(bool enable)
+  {
+    _pruneStaticCrossBlocks = enable;
+  };
+
+  /** \return the number of cross-block pairs pruned by the last fill() */
+  inline unsigned int nbPrunedBlocks() const { return _nbPrunedBlocks; };
+
   /** fill the current class using an index set
    *
    *  \param indexSet set of the active constraints
@@ -240,6 +306,33 @@ public:
    */
   void convert();
 
+  /** assemble the scalar CSR image of the block matrix, without any
+   *  intermediate (per-block) copy: the symbolic layout (row pointers,
+   *  column indices and per-block destinations) is computed once per
+   *  block pattern and reused across steps, so after the first call
+   *  only the values are (re)written, in parallel, in one pass.
+   *  Use csrRowPtr/csrColInd/csrValues to read the result.
+   */
+  void fillCSR();
+
+  /** get the CSR row pointers array (size nbRows+1), valid after fillCSR
+   *
+   *  \return a reference on the array
+   */
+  inline const std::vector<std::size_t> &csrRowPtr() const { return _csrRowPtr; };
+
+  /** get the CSR column indices array (size nnz), valid after fillCSR
+   *
+   *  \return a reference on the array
+   */
+  inline const std::vector<std::size_t> &csrColInd() const { return _csrColInd; };
+
+  /** get the CSR values array (size nnz), valid after fillCSR
+   *
+   *  \return a reference on the array
+   */
+  inline const std::vector<double> &csrValues() const { return _csrValues; };
+
   /** display the current matrix
    */
   void display() const;
@@ -130,6 +130,7 @@ void D1MinusLinearOSI::initializeWorkVectorsForDS(double t, SP::DynamicalSystem
     ds_work_vectors[D1MinusLinearOSI::RESIDU_FREE].reset(new SiconosVector(lds->dimension()));
     ds_work_vectors[D1MinusLinearOSI::FREE].reset(new SiconosVector(lds->dimension()));
     ds_work_vectors[D1MinusLinearOSI::FREE_TDG].reset(new SiconosVector(lds->dimension()));
+    ds_work_vectors[D1MinusLinearOSI::P_ACC].reset(new SiconosVector(lds->dimension()));
     // Update dynamical system components (for memory swap).
     lds->computeForces(t, lds->q(), lds->velocity());
     lds->swapInMemory();
@@ -142,6 +143,7 @@ void D1MinusLinearOSI::initializeWorkVectorsForDS(double t, SP::DynamicalSystem
     ds_work_vectors[D1MinusLinearOSI::RESIDU_FREE].reset(new SiconosVector(neds->dimension()));
     ds_work_vectors[D1MinusLinearOSI::FREE].reset(new SiconosVector(neds->dimension()));
     ds_work_vectors[D1MinusLinearOSI::FREE_TDG].reset(new SiconosVector(neds->dimension()));
+    ds_work_vectors[D1MinusLinearOSI::P_ACC].reset(new SiconosVector(neds->dimension()));
     //Compute a first value of the forces to store it in _forcesMemory
     neds->computeForces(t, neds->q(), neds->twist());
     neds->swapInMemory();
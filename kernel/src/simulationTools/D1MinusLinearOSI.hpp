@@ -164,6 +164,7 @@ public:
     RESIDU_FREE,
     FREE,
     FREE_TDG,
+    P_ACC,
     WORK_LENGTH
   };
 
@@ -64,13 +64,16 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
 
 // -- LEFT SIDE --
 
-  DynamicalSystemsGraph::VIterator dsi, dsend;
-  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  /* Each per-DS stage below only touches the state and the workspace of
+   * its own dynamical system, so the DS loops are run with
+   * parallelForVertices when OpenMP is enabled. */
+  parallelForVertices(*_dynamicalSystemsGraph,
+                      [&](const DynamicalSystemsGraph::VDescriptor& dsv)
   {
-    if(!checkOSI(dsi)) continue;
-    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
+    if(!checkOSI(dsv)) return;
+    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(dsv);
     Type::Siconos dsType = Type::value(*ds);
-    VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+    VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
     DEBUG_EXPR(ds->display());
     SP::SiconosVector work_tdg;
 
@@ -154,7 +157,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
     {
       THROW_EXCEPTION("D1MinusLinearOSI::computeResidu - not yet implemented for Dynamical system type: " + std::to_string(dsType));
     }
-  }
+  });
 
 
   if(!allOSNS->empty())
@@ -194,26 +197,28 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
       _simulation->nonSmoothDynamicalSystem()->updateInput(_simulation->nextTime(),2);
 
 
-      for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+      parallelForVertices(*_dynamicalSystemsGraph,
+                          [&](const DynamicalSystemsGraph::VDescriptor& dsv)
       {
-        if(!checkOSI(dsi)) continue;
-        SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
+        if(!checkOSI(dsv)) return;
+        SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(dsv);
 
         Type::Siconos dsType = Type::value(*ds);
-        VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+        VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
 
         if((dsType == Type::LagrangianDS) || (dsType == Type::LagrangianLinearTIDS))
         {
           SP::LagrangianDS d = std::static_pointer_cast<LagrangianDS> (ds);
           SiconosVector& accFree = *workVectors[D1MinusLinearOSI::FREE];
+          SiconosVector& dummy = *workVectors[D1MinusLinearOSI::P_ACC];
 
-          SP::SiconosVector dummy(new SiconosVector(*(d->p(2)))); // value = contact force
+          dummy = *(d->p(2)); // value = contact force
           if(d->inverseMass())
           {
             d->update_inverse_mass();
-            d->inverseMass()->Solve(*dummy);
+            d->inverseMass()->Solve(dummy);
           }
-          accFree  += *(dummy);
+          accFree  += dummy;
 
           DEBUG_EXPR(d->p(2)->display());
         }
@@ -221,15 +226,15 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
         {
           SP::NewtonEulerDS d = std::static_pointer_cast<NewtonEulerDS> (ds);
           SiconosVector& accFree = *workVectors[D1MinusLinearOSI::FREE];
+          SiconosVector& dummy = *workVectors[D1MinusLinearOSI::P_ACC];
 
-
-          SP::SiconosVector dummy(new SiconosVector(*(d->p(2)))); // value = contact force
+          dummy = *(d->p(2)); // value = contact force
           if(d->inverseMass())
           {
             d->update_inverse_mass();
-            d->inverseMass()->Solve(*dummy);
+            d->inverseMass()->Solve(dummy);
           }
-          accFree  += *(dummy);
+          accFree  += dummy;
 
           DEBUG_EXPR(d->p(2)->display());
 
@@ -237,7 +242,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
         else
           THROW_EXCEPTION("D1MinusLinearOSI::computeResidu - not yet implemented for Dynamical system type: " + std::to_string(dsType));
 
-      }
+      });
     }
   }
 
@@ -248,11 +253,12 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
 
   DEBUG_PRINT("\n PREDICT RIGHT HAND SIDE\n");
 
-  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  parallelForVertices(*_dynamicalSystemsGraph,
+                      [&](const DynamicalSystemsGraph::VDescriptor& dsv)
   {
-    if(!checkOSI(dsi)) continue;
-    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
-    VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+    if(!checkOSI(dsv)) return;
+    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(dsv);
+    VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
 
     // type of the current DS
     Type::Siconos dsType = Type::value(*ds);
@@ -270,18 +276,16 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
 
       // initialize *it->residuFree and predicted right velocity (left limit)
       SiconosVector& v = *d->velocity(); //contains velocity v_{k+1}^- and not free velocity
-      residuFree.zero();
-      v.zero();
 
       DEBUG_EXPR(accFree.display());
       DEBUG_EXPR(qold.display());
       DEBUG_EXPR(vold.display());
 
 
-      residuFree -= 0.5 * h*accFree;
+      scal(-0.5 * h, accFree, residuFree, true);
 
-      v += h * accFree;
-      v += vold;
+      v = vold;
+      scal(h, accFree, v, false);
 
       DEBUG_EXPR(residuFree.display());
       DEBUG_EXPR(v.display());
@@ -289,7 +293,8 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
       SP::SiconosVector q = d->q(); // POINTER CONSTRUCTOR : contains position q_{k+1}
       *q = qold;
 
-      scal(0.5 * h, vold + v, *q, false);
+      scal(0.5 * h, vold, *q, false);
+      scal(0.5 * h, v, *q, false);
       DEBUG_EXPR(q->display());
     }
     else if(dsType == Type::NewtonEulerDS)
@@ -303,18 +308,16 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
 
       // initialize *it->residuFree and predicted right velocity (left limit)
       SiconosVector& v = *d->twist(); //contains velocity v_{k+1}^- and not free velocity
-      residuFree.zero();
-      v.zero();
 
       DEBUG_EXPR(accFree.display());
       DEBUG_EXPR(qold.display());
       DEBUG_EXPR(vold.display());
 
 
-      residuFree -= 0.5 * h* accFree;
+      scal(-0.5 * h, accFree, residuFree, true);
 
-      v += h * accFree;
-      v += vold;
+      v = vold;
+      scal(h, accFree, v, false);
 
       DEBUG_EXPR(residuFree.display());
       DEBUG_EXPR(v.display());
@@ -331,7 +334,8 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
       SiconosVector& q = *d->q(); // POINTER CONSTRUCTOR : contains position q_{k+1}
       q = qold;
 
-      scal(0.5 * h, dotqold + dotq, q, false);
+      scal(0.5 * h, dotqold, q, false);
+      scal(0.5 * h, dotq, q, false);
       DEBUG_PRINT("new q before normalizing\n");
       DEBUG_EXPR(q.display());
       //q[3:6] must be normalized
@@ -361,7 +365,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
      * \end{cases}
      * \f]
      **/
-  }
+  });
 
   DEBUG_PRINT("\n DECIDE STRATEGY\n");
   /** Decide of the strategy impact or smooth multiplier.
@@ -406,11 +410,12 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
   {
 
     DEBUG_PRINT("There is an impact in the step. indexSet3->size() > 0.  _isThereImpactInTheTimeStep = true\n");
-    for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+    parallelForVertices(*_dynamicalSystemsGraph,
+                        [&](const DynamicalSystemsGraph::VDescriptor& dsv)
     {
-      if(!checkOSI(dsi)) continue;
-      SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
-      VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+      if(!checkOSI(dsv)) return;
+      SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(dsv);
+      VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
 
       // type of the current DS
       Type::Siconos dsType = Type::value(*ds);
@@ -428,7 +433,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
 
         SP::SiconosVector work_tdg = workVectors[D1MinusLinearOSI::FREE_TDG];
         assert(work_tdg);
-        residuFree =  - 0.5 * h* *work_tdg;
+        scal(-0.5 * h, *work_tdg, residuFree, true);
 
 
         d->computeForces(t, q, v);
@@ -440,7 +445,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
           d->update_inverse_mass();
           d->inverseMass()->Solve(*work_tdg);
         }
-        residuFree -= 0.5 * h**work_tdg;
+        scal(-0.5 * h, *work_tdg, residuFree, false);
         DEBUG_EXPR(residuFree.display());
       }
       else if(dsType == Type::NewtonEulerDS)
@@ -456,7 +461,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
         v->zero();
         SP::SiconosVector work_tdg = workVectors[D1MinusLinearOSI::FREE_TDG];
         assert(work_tdg);
-        residuFree = 0.5 * h * *work_tdg;
+        scal(0.5 * h, *work_tdg, residuFree, true);
         work_tdg->zero();
 
         d->computeForces(t, q, v);
@@ -468,12 +473,12 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
           d->update_inverse_mass();
           d->inverseMass()->Solve(*work_tdg);
         }
-        residuFree -= 0.5 * h * *work_tdg;
+        scal(-0.5 * h, *work_tdg, residuFree, false);
         DEBUG_EXPR(residuFree.display());
       }
       else
         THROW_EXCEPTION("D1MinusLinearOSI::computeResidu - not yet implemented for Dynamical system type: " +  std::to_string(dsType));
-    }
+    });
   }
   else
   {
@@ -481,11 +486,12 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
     // -- RIGHT SIDE --
     // calculate acceleration without contact force
 
-    for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+    parallelForVertices(*_dynamicalSystemsGraph,
+                        [&](const DynamicalSystemsGraph::VDescriptor& dsv)
     {
-      if(!checkOSI(dsi)) continue;
-      SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
-      VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+      if(!checkOSI(dsv)) return;
+      SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(dsv);
+      VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
 
 
       // type of the current DS
@@ -520,6 +526,12 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
         }
         DEBUG_PRINT("accFree contains left limit acceleration at  t^-_{k+1} without contact force :\n");
         DEBUG_EXPR(accFree.display());
+
+        /* the smooth part of the residu does not depend on the contact
+         * forces computed below, so its evaluation is fused with the
+         * free acceleration instead of re-reading accFree afterwards */
+        SiconosVector& residuFree = *workVectors[D1MinusLinearOSI::RESIDU_FREE];
+        scal(-0.5 * h, accFree, residuFree, false);
       }
       else if(dsType == Type::NewtonEulerDS)
       {
@@ -545,11 +557,16 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
 
         DEBUG_PRINT("accFree contains left limit acceleration at  t^-_{k+1} without contact force :\n");
         DEBUG_EXPR(accFree.display());
+
+        /* see the Lagrangian case above: smooth residu contribution
+         * fused with the free acceleration */
+        SiconosVector& residuFree = *workVectors[D1MinusLinearOSI::RESIDU_FREE];
+        scal(-0.5 * h, accFree, residuFree, false);
       }
       else
         THROW_EXCEPTION("D1MinusLinearOSI::computeResidu - not yet implemented for Dynamical system type: " +  std::to_string(dsType));
 
-    }
+    });
 
     // solve a LCP at acceleration level only for contacts which have been active at the beginning of the time-step
     if(!allOSNS->empty())
@@ -578,11 +595,15 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
         _simulation->nonSmoothDynamicalSystem()->updateInput(_simulation->nextTime(),2);
       }
     }
-    for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+    /* the smooth contribution -h/2 * accFree has already been added to the
+     * residu together with the free acceleration above; only the
+     * nonimpulsive contact force contribution remains */
+    parallelForVertices(*_dynamicalSystemsGraph,
+                        [&](const DynamicalSystemsGraph::VDescriptor& dsv)
     {
-      if(!checkOSI(dsi)) continue;
-      SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
-      VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+      if(!checkOSI(dsv)) return;
+      SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(dsv);
+      VectorOfVectors& workVectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
       // type of the current DS
       Type::Siconos dsType = Type::value(*ds);
       /* \warning the following conditional statement should be removed with a MechanicalDS class */
@@ -590,11 +611,6 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
       {
         SP::LagrangianDS d = std::static_pointer_cast<LagrangianDS> (ds);
         SiconosVector& residuFree = *workVectors[D1MinusLinearOSI::RESIDU_FREE];
-        SiconosVector& accFree = *workVectors[D1MinusLinearOSI::FREE];
-
-        // initialize *it->residuFree
-        residuFree -= 0.5 * h* accFree;
-        DEBUG_EXPR(accFree.display());
 
         if(d->p(2))
         {
@@ -602,14 +618,15 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
           // get right state from memory
           DEBUG_EXPR(d->inverseMass()->display());
           DEBUG_EXPR(d->p(2)->display());
-          SiconosVector dummy(*(d->p(2))); // value = contact force
+          SiconosVector& dummy = *workVectors[D1MinusLinearOSI::P_ACC];
+          dummy = *(d->p(2)); // value = contact force
           if(d->inverseMass())
           {
             d->update_inverse_mass();
             d->inverseMass()->Solve(dummy);
           }
 
-          residuFree -= 0.5 * h*dummy;
+          scal(-0.5 * h, dummy, residuFree, false);
 
         }
         DEBUG_EXPR(residuFree.display());
@@ -618,23 +635,20 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
       {
         SP::NewtonEulerDS d = std::static_pointer_cast<NewtonEulerDS> (ds);
         SiconosVector& residuFree = *workVectors[D1MinusLinearOSI::RESIDU_FREE];
-        SiconosVector& accFree = *workVectors[D1MinusLinearOSI::FREE];
-        // initialize *it->residuFree
-        residuFree -= 0.5 * h* accFree;
-        DEBUG_EXPR(accFree.display());
 
         if(d->p(2))
         {
           // get right state from memory
           DEBUG_EXPR(d->inverseMass()->display());
           DEBUG_EXPR(d->p(2)->display());
-          SiconosVector dummy(*(d->p(2))); // value = contact force
+          SiconosVector& dummy = *workVectors[D1MinusLinearOSI::P_ACC];
+          dummy = *(d->p(2)); // value = contact force
           if(d->inverseMass())
           {
             d->update_inverse_mass();
             d->inverseMass()->Solve(dummy);
           }
-          residuFree -= 0.5 * h*dummy;
+          scal(-0.5 * h, dummy, residuFree, false);
 
         }
         DEBUG_EXPR(residuFree.display());
@@ -656,7 +670,7 @@ double D1MinusLinearOSI::computeResiduHalfExplicitAccelerationLevel()
        * \f]
        **/
 
-    }
+    });
 
   } // No impact
 
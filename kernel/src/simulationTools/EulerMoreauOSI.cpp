@@ -16,6 +16,8 @@
  * limitations under the License.
  */
 #include "EulerMoreauOSI.hpp"
+#include <map> // for the batches of computefBatch
+#include <vector> // for the flat vertex lists of the parallel loops
 #include "SiconosAlgebraProd.hpp" // for prod and subprod
 #include "SiconosAlgebraScal.hpp" // for scal
 //#include "SiconosVectorFriends.hpp" // for scal
@@ -482,22 +484,56 @@ double EulerMoreauOSI::computeResidu()
 
   // Operators computed at told have index i, and (i+1) at t.
 
-  // Iteration through the set of Dynamical Systems.
-  //
-  SP::DynamicalSystem ds; // Current Dynamical System.
-  Type::Siconos dsType ; // Type of the current DS.
-
   double maxResidu = 0;
-  double normResidu = maxResidu;
 
   DynamicalSystemsGraph::VIterator dsi, dsend;
+
+  // Batched evaluation of the plugged f at (t_{k+1}, x_{k+1}^alpha) for
+  // the first order nonlinear systems whose plugin exports the batched
+  // symbol: one indirect call for the whole group instead of one per
+  // system.  The per-DS loop below skips computef for them.
+  {
+    std::map<void*, std::vector<FirstOrderNonLinearDS*> > batches;
+    for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+    {
+      if(!checkOSI(dsi)) continue;
+      DynamicalSystem& dsb = *_dynamicalSystemsGraph->bundle(*dsi);
+      if(Type::value(dsb) != Type::FirstOrderNonLinearDS) continue;
+      FirstOrderNonLinearDS& fonlds = static_cast<FirstOrderNonLinearDS&>(dsb);
+      if(fonlds.f() && fonlds.getPluginF()->isBatchPlugged())
+        batches[fonlds.getPluginF()->fPtrBatch].push_back(&fonlds);
+    }
+    for(auto& batch : batches)
+      FirstOrderNonLinearDS::computefBatch(time, batch.second);
+  }
+
+  // The per-DS residuals are independent: each iteration touches only the
+  // state and the workVectors of its own vertex, so the loop is run in
+  // parallel over a flat list of the vertices owned by this OSI.  Types
+  // are validated up front, outside the parallel region.
+  std::vector<DynamicalSystemsGraph::VDescriptor> osiVertices;
+  osiVertices.reserve(_dynamicalSystemsGraph->vertices_number());
   for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
   {
     if(!checkOSI(dsi)) continue;
-    ds = _dynamicalSystemsGraph->bundle(*dsi);
-    VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+    Type::Siconos t = Type::value(*_dynamicalSystemsGraph->bundle(*dsi));
+    if(t != Type::FirstOrderNonLinearDS && t != Type::FirstOrderLinearDS
+        && t != Type::FirstOrderLinearTIDS)
+      THROW_EXCEPTION("EulerMoreauOSI::computeResidu - not yet implemented for Dynamical system type: " + std::to_string(t));
+    osiVertices.push_back(*dsi);
+  }
+
+  int nbOsiVertices = (int)osiVertices.size();
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) reduction(max:maxResidu) if(nbOsiVertices > 64)
+#endif
+  for(int ivertex = 0; ivertex < nbOsiVertices; ++ivertex)
+  {
+    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(osiVertices[ivertex]);
+    VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(osiVertices[ivertex]).workVectors;
 
-    dsType = Type::value(*ds); // Its type
+    Type::Siconos dsType = Type::value(*ds); // Its type
+    double normResidu = 0;
 
     // XXX TMP hack -- xhub
     // we have to iterate over the edges of the DSG0 -> the following won't be necessary anymore
@@ -538,37 +574,33 @@ double EulerMoreauOSI::computeResidu()
 
         // computes f(t_k,x_k)
         // No fold in FirstOrderLinearDS.
-        // residu is used as a tmp buffer to compute Ax + b
-        residu.zero();
+        // residuFree += -h * (1 - _theta) * f(t_k,x_k), accumulated in place
+        // with the scaled prod and axpy, no tmp buffer
         FirstOrderLinearDS& folds = *std::static_pointer_cast<FirstOrderLinearDS>(ds);
         if(folds.A())
         {
           folds.computeA(told);
-          prod(*folds.A(), xold, residu);
+          prod(coef, *folds.A(), xold, residuFree, false);
         }
 
         if(folds.b())
         {
           folds.computeb(told);
-          residu += *folds.b();
+          axpy(coef, *folds.b(), residuFree);
         }
         DEBUG_EXPR(residuFree.display());
-        // residuFree += -h * (1 - _theta) * f(t_k,x_k)
-        scal(coef, residu, residuFree, false);
-        residu.zero();
+        // residuFree += -h * _theta * f(t_{x+1}, x_{k+1}^alpha)
+        coef = -h * _theta;
         if(folds.A())
         {
           folds.computeA(time);
-          prod(*folds.A(), *folds.x(), residu);
+          prod(coef, *folds.A(), *folds.x(), residuFree, false);
         }
         if(folds.b())
         {
           folds.computeb(time);
-          residu += *folds.b();
+          axpy(coef, *folds.b(), residuFree);
         }
-        // residuFree += -h * _theta * f(t_{x+1}, x_{k+1}^alpha)
-        coef = -h * _theta;
-        scal(coef, residu, residuFree, false);
         DEBUG_PRINT("- 3 -\n");
         DEBUG_EXPR(residuFree.display());
         DEBUG_EXPR(xold.display());
@@ -585,8 +617,10 @@ double EulerMoreauOSI::computeResidu()
           // residuFree += -h * (1 - _theta) * f(t_k,x_k)
           scal(coef, *fonlds.fold(), residuFree, false);
 
-          // computes f(t_{x+1}, x_{k+1}^alpha)
-          fonlds.computef(time, fonlds.x());
+          // computes f(t_{x+1}, x_{k+1}^alpha), unless already evaluated
+          // in the batched pass above
+          if(!fonlds.getPluginF()->isBatchPlugged())
+            fonlds.computef(time, fonlds.x());
           coef = -h * _theta;
           // residuFree += -h * _theta * f(t_{x+1}, x_{k+1}^alpha)
           scal(coef, *(fonlds.f()), residuFree, false);
@@ -626,17 +660,12 @@ double EulerMoreauOSI::computeResidu()
         residuFree.zero();
 
       // 2. residuFree += -h * A (\theta x_{k+1}^{\alpha} + (1-\theta) x_k)
-      // residu is used as a temp buffer
+      // accumulated with the scaled prod, no temp buffer
       if(foltids.A())
       {
         SP::SiconosMatrix A = foltids.A();
-        prod(*A, foltids.xMemory().getSiconosVector(0), residu, true);
-        double coef = -h * (1 - _theta);
-        scal(coef, residu, residuFree, false);
-
-        prod(*A, *(foltids.x()), residu, true);
-        coef = -h * _theta;
-        scal(coef, residu, residuFree, false);
+        prod(-h * (1 - _theta), *A, foltids.xMemory().getSiconosVector(0), residuFree, false);
+        prod(-h * _theta, *A, *(foltids.x()), residuFree, false);
       }
 
       // 3. residuFree += M(x_{k+1}^{\alpha} - x_k)
@@ -665,6 +694,90 @@ double EulerMoreauOSI::computeResidu()
   return maxResidu;
 }
 
+// Operator comparison helpers for the ensemble detection below: two
+// systems share an operator either through the very same object or
+// through equal values (common when each member of an ensemble owns its
+// own copy of the model matrices).
+static bool sameOperator(SP::SiconosMatrix a, SP::SiconosMatrix b)
+{
+  if(a == b) return true;
+  if(!a || !b) return false;
+  if(a->size(0) != b->size(0) || a->size(1) != b->size(1)) return false;
+  for(unsigned int i = 0; i < a->size(0); ++i)
+    for(unsigned int j = 0; j < a->size(1); ++j)
+      if((*a)(i, j) != (*b)(i, j)) return false;
+  return true;
+}
+
+static bool sameOperator(SP::SiconosVector a, SP::SiconosVector b)
+{
+  if(a == b) return true;
+  if(!a || !b) return false;
+  if(a->size() != b->size()) return false;
+  for(unsigned int i = 0; i < a->size(); ++i)
+    if((*a)(i) != (*b)(i)) return false;
+  return true;
+}
+
+void EulerMoreauOSI::detectSharedTIDSEnsembles()
+{
+  _tidsEnsembles.clear();
+  _tidsEnsembleIndex.clear();
+
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  {
+    if(!checkOSI(dsi)) continue;
+    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(*dsi);
+    if(Type::value(*ds) != Type::FirstOrderLinearTIDS) continue;
+
+    // a relation jacobian K makes W vertex-dependent (see computeW):
+    // such systems keep the per-system path
+    bool hasK = false;
+    DynamicalSystemsGraph::OEIterator oei, oeiend;
+    for(std::tie(oei, oeiend) = _dynamicalSystemsGraph->out_edges(*dsi);
+        oei != oeiend && !hasK; ++oei)
+    {
+      SP::Interaction inter = _dynamicalSystemsGraph->bundle(*oei);
+      FirstOrderR& rel = static_cast<FirstOrderR&>(*inter->relation());
+      if(rel.K() || inter->relationMatrices()[FirstOrderR::mat_K]) hasK = true;
+    }
+    if(hasK) continue;
+
+    FirstOrderLinearTIDS& d = *std::static_pointer_cast<FirstOrderLinearTIDS>(ds);
+    std::size_t e;
+    for(e = 0; e < _tidsEnsembles.size(); ++e)
+    {
+      FirstOrderLinearTIDS& rep = *std::static_pointer_cast<FirstOrderLinearTIDS>(
+                                    _dynamicalSystemsGraph->bundle(_tidsEnsembles[e].members.front()));
+      if(d.n() == rep.n() && sameOperator(d.A(), rep.A())
+          && sameOperator(d.M(), rep.M()) && sameOperator(d.b(), rep.b()))
+        break;
+    }
+    if(e == _tidsEnsembles.size())
+      _tidsEnsembles.push_back(TIDSEnsemble());
+    _tidsEnsembles[e].members.push_back(*dsi);
+  }
+
+  // drop the singletons: they gain nothing over the per-system path
+  std::size_t kept = 0;
+  for(std::size_t e = 0; e < _tidsEnsembles.size(); ++e)
+  {
+    if(_tidsEnsembles[e].members.size() < 2) continue;
+    if(kept != e) _tidsEnsembles[kept] = _tidsEnsembles[e];
+    ++kept;
+  }
+  _tidsEnsembles.resize(kept);
+
+  for(std::size_t e = 0; e < _tidsEnsembles.size(); ++e)
+    for(std::size_t j = 0; j < _tidsEnsembles[e].members.size(); ++j)
+      _tidsEnsembleIndex[_dynamicalSystemsGraph->bundle(_tidsEnsembles[e].members[j]).get()]
+        = std::make_pair(e, j);
+
+  DEBUG_PRINTF("EulerMoreauOSI::detectSharedTIDSEnsembles %zu ensemble(s)\n",
+               _tidsEnsembles.size());
+}
+
 void EulerMoreauOSI::computeFreeState()
 {
   // This function computes "free" states of the DS belonging to this Integrator.
@@ -680,28 +793,91 @@ void EulerMoreauOSI::computeFreeState()
   //  Note: integration of r with a theta method has been removed
   //  SiconosVector *rold = static_cast<SiconosVector*>(d.rMemory()->getSiconosVector(0));
 
-  // Iteration through the set of Dynamical Systems.
-  //
+  // Iteration through the set of Dynamical Systems.  As in
+  // computeResidu, each iteration only reads and writes per-vertex data
+  // (x, workVectors, its own W, already factorized or factorized once
+  // here), so the loop is parallel over a flat list of the vertices
+  // owned by this OSI, types validated up front.
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  std::vector<DynamicalSystemsGraph::VDescriptor> osiVertices;
+  osiVertices.reserve(_dynamicalSystemsGraph->vertices_number());
+  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  {
+    if(!checkOSI(dsi)) continue;
+    Type::Siconos t = Type::value(*_dynamicalSystemsGraph->bundle(*dsi));
+    if(t != Type::FirstOrderNonLinearDS && t != Type::FirstOrderLinearDS
+        && t != Type::FirstOrderLinearTIDS)
+      THROW_EXCEPTION("EulerMoreauOSI::computeFreeState - not yet implemented for Dynamical system type: " + std::to_string(t));
+    osiVertices.push_back(*dsi);
+  }
 
-  SP::DynamicalSystem ds; // Current Dynamical System.
-  Type::Siconos dsType ; // Type of the current DS.
+  // (Re)detect the ensembles of FirstOrderLinearTIDS sharing (M, A, b)
+  // when the graph changed.  For each ensemble, the two W^{-1} solves
+  // per system of the loop below collapse into one matrix-matrix solve
+  // on the representative W, factorized once: the member right-hand
+  // sides are stacked as the columns of stackedRhs.
+  std::pair<std::size_t, std::size_t> graphSignature(
+    _dynamicalSystemsGraph->vertices_number(),
+    _dynamicalSystemsGraph->edges_number());
+  if(graphSignature != _tidsEnsembleGraphSignature)
+  {
+    detectSharedTIDSEnsembles();
+    _tidsEnsembleGraphSignature = graphSignature;
+  }
 
+  for(std::size_t e = 0; e < _tidsEnsembles.size(); ++e)
+  {
+    TIDSEnsemble& ens = _tidsEnsembles[e];
+    std::size_t N = ens.members.size();
+    unsigned int n = _dynamicalSystemsGraph->bundle(ens.members.front())->n();
+    if(!ens.stackedRhs || ens.stackedRhs->size(0) != n
+        || ens.stackedRhs->size(1) != 2 * N)
+      ens.stackedRhs.reset(new SimpleMatrix(n, (unsigned int)(2 * N)));
+
+    SimpleMatrix& rhs = *ens.stackedRhs;
+    for(std::size_t j = 0; j < N; ++j)
+    {
+      VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(ens.members[j]).workVectors;
+      const SiconosVector& residuFree = *ds_work_vectors[EulerMoreauOSI::RESIDU_FREE];
+      const SiconosVector& xPartialNS = *ds_work_vectors[EulerMoreauOSI::X_PARTIAL_NS_FOR_RELATION];
+      for(unsigned int i = 0; i < n; ++i)
+      {
+        rhs(i, (unsigned int)j) = residuFree(i);
+        rhs(i, (unsigned int)(N + j)) = xPartialNS(i);
+      }
+      if(_useGamma)
+      {
+        FirstOrderNonLinearDS& d = *std::static_pointer_cast<FirstOrderNonLinearDS>(
+                                     _dynamicalSystemsGraph->bundle(ens.members[j]));
+        const SiconosVector& rold = d.rMemory().getSiconosVector(0);
+        double coeff = -h * (1 - _gamma);
+        for(unsigned int i = 0; i < n; ++i)
+          rhs(i, (unsigned int)j) += coeff * rold(i);
+      }
+    }
 
+    // one factorization and one blocked triangular solve for the whole
+    // ensemble, instead of 2N vector solves on N identical matrices
+    SiconosMatrix& W = *_dynamicalSystemsGraph->properties(ens.members.front()).W;
+    W.Solve(rhs);
+  }
 
-  DynamicalSystemsGraph::VIterator dsi, dsend;
-  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  int nbOsiVertices = (int)osiVertices.size();
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(nbOsiVertices > 64)
+#endif
+  for(int ivertex = 0; ivertex < nbOsiVertices; ++ivertex)
   {
-    if(!checkOSI(dsi)) continue;
-    ds = _dynamicalSystemsGraph->bundle(*dsi);
+    SP::DynamicalSystem ds = _dynamicalSystemsGraph->bundle(osiVertices[ivertex]);
 
     // XXX TMP hack -- xhub
     // we have to iterate over the edges of the DSG0 -> the following won't be necessary anymore
     // Maurice will do that with subgraph :)
 
-    VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+    VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(osiVertices[ivertex]).workVectors;
 
-    dsType = Type::value(*ds); // Its type
-    SiconosMatrix& W = *_dynamicalSystemsGraph->properties(*dsi).W; // Its W EulerMoreauOSI matrix of iteration.
+    Type::Siconos dsType = Type::value(*ds); // Its type
+    SiconosMatrix& W = *_dynamicalSystemsGraph->properties(osiVertices[ivertex]).W; // Its W EulerMoreauOSI matrix of iteration.
 
     // 1 - First Order Non Linear Systems
     if(dsType == Type::FirstOrderNonLinearDS || dsType == Type::FirstOrderLinearDS || dsType == Type::FirstOrderLinearTIDS)
@@ -718,24 +894,39 @@ void EulerMoreauOSI::computeFreeState()
       //    SP::SiconosVector xold = d->xMemory()->getSiconosVector(0); // xi
 
       SiconosVector& x = *d.x(); // x = x_k or x = x_{k+1}^{\alpha}
+
+      // members of a TIDS ensemble had their two solves done above, with
+      // the whole ensemble stacked as columns of one right-hand side
+      std::map<DynamicalSystem*, std::pair<std::size_t, std::size_t> >::const_iterator
+      ensIt = _tidsEnsembleIndex.find(ds.get());
+      bool batched = (ensIt != _tidsEnsembleIndex.end());
+
       // xfree gets ResiduFree at first
       SiconosVector& xfree = *ds_work_vectors[EulerMoreauOSI::FREE];
-      xfree = *ds_work_vectors[EulerMoreauOSI::RESIDU_FREE];
-
-      DEBUG_PRINT("EulerMoreauOSI::computeFreeState xfree <- residuFree\n");
-      DEBUG_EXPR(xfree.display());
 
-      if(_useGamma)
+      if(batched)
       {
-        const SiconosVector& rold = d.rMemory().getSiconosVector(0);
-        double coeff = -h * (1 - _gamma);
-        scal(coeff, rold, xfree, false); //  xfree += -h(1-gamma)*rold
+        SimpleMatrix& sol = *_tidsEnsembles[ensIt->second.first].stackedRhs;
+        sol.getCol((unsigned int)ensIt->second.second, xfree);
       }
+      else
+      {
+        xfree = *ds_work_vectors[EulerMoreauOSI::RESIDU_FREE];
 
+        DEBUG_PRINT("EulerMoreauOSI::computeFreeState xfree <- residuFree\n");
+        DEBUG_EXPR(xfree.display());
+
+        if(_useGamma)
+        {
+          const SiconosVector& rold = d.rMemory().getSiconosVector(0);
+          double coeff = -h * (1 - _gamma);
+          scal(coeff, rold, xfree, false); //  xfree += -h(1-gamma)*rold
+        }
 
-      // At this point xfree = (ResiduFree - h(1-gamma)*rold)
-      // -> Solve WX = xfree and set xfree = X
-      W.Solve(xfree);
+        // At this point xfree = (ResiduFree - h(1-gamma)*rold)
+        // -> Solve WX = xfree and set xfree = X
+        W.Solve(xfree);
+      }
 
       // at this point, xfree = W^{-1} (ResiduFree - h(1-gamma)*rold)
       // -> compute real xfree = x - W^{-1} (ResiduFree - h(1-gamma)*rold)
@@ -754,7 +945,14 @@ void EulerMoreauOSI::computeFreeState()
 
       // -> Solve WX = g(x, \lambda, t_{k+1}) - B_{k+1}^{\alpha} \lambda - K_{k+1}^{\alpha} x
       // and set xPartialNS = X
-      W.Solve(xPartialNS);
+      if(batched)
+      {
+        TIDSEnsemble& ens = _tidsEnsembles[ensIt->second.first];
+        ens.stackedRhs->getCol((unsigned int)(ens.members.size() + ensIt->second.second),
+                               xPartialNS);
+      }
+      else
+        W.Solve(xPartialNS);
       scal(h, xPartialNS, xPartialNS);
 
       // compute real xPartialNS = xfree + ...
@@ -23,6 +23,8 @@
 
 #include "OneStepIntegrator.hpp"
 
+#include <map> // for the ensemble member lookup
+
 /** 
     One Step time Integrator for First Order Dynamical Systems.
  
@@ -135,6 +137,42 @@ protected:
    */
   bool _useGammaForRelation;
 
+  /** Ensemble of FirstOrderLinearTIDS sharing the same operators (M, A,
+   *  b).  Since h and theta are OSI-wide, the iteration matrices W of
+   *  the members are all equal, so the representative W is factorized
+   *  once and the two W^{-1} solves per system of computeFreeState are
+   *  applied to all the member states at once, stacked as the columns of
+   *  one right-hand side matrix: one matrix-matrix triangular solve
+   *  instead of 2N matrix-vector ones.
+   */
+  struct TIDSEnsemble
+  {
+    /** graph vertices of the member systems */
+    std::vector<DynamicalSystemsGraph::VDescriptor> members;
+    /** n x 2N stacked right-hand sides (columns [0,N): free part,
+     *  columns [N,2N): xPartialNS), reused across calls */
+    SP::SimpleMatrix stackedRhs;
+  };
+
+  /** ensembles of at least two systems; smaller groups gain nothing and
+   *  keep the per-system path */
+  std::vector<TIDSEnsemble> _tidsEnsembles;
+
+  /** member lookup: ds -> (ensemble index, column index) */
+  std::map<DynamicalSystem*, std::pair<std::size_t, std::size_t> > _tidsEnsembleIndex;
+
+  /** (vertices, edges) numbers of the graph for which the ensembles were
+   *  built; the ensembles are rebuilt when they change */
+  std::pair<std::size_t, std::size_t> _tidsEnsembleGraphSignature = {0, 0};
+
+  /** Group the FirstOrderLinearTIDS of this OSI into ensembles sharing
+   *  the same (M, A, b), either through the very same operator objects
+   *  or through equal values.  Systems whose interactions contribute a
+   *  relation jacobian K to W (see computeW) are left out, since their W
+   *  is vertex-dependent.
+   */
+  void detectSharedTIDSEnsembles();
+
   /** nslaw effects
    */
   struct _NSLEffectOnFreeOutput;
@@ -551,7 +551,6 @@ void EventDriven::computeg(SP::OneStepIntegrator osi,
   SP::Topology topo = _nsds->topology();
   SP::InteractionsGraph indexSet2 = topo->indexSet(2);
   unsigned int nsLawSize, k = 0 ;
-  SP::SiconosVector y, ydot, yddot, lambda;
   SP::LsodarOSI lsodar = std::static_pointer_cast<LsodarOSI>(osi);
   // Solve LCP at acceleration level to calculate the lambda[2] at Interaction of indexSet[2]
   lsodar->fillXWork(sizeOfX, x);
@@ -569,36 +568,40 @@ void EventDriven::computeg(SP::OneStepIntegrator osi,
      computef(osi, sizeOfX,time,x,xdottmp);
      free(xdottmp);
      */
-  // Update the output from level 0 to level 1
+  // Update the outputs: this is the actual evaluation of the constraint
+  // gaps, done in one batch for all the interactions at this trial point.
+  // The level 2 output (accelerations) only feeds the g values of the
+  // interactions in indexSet[2], so it is skipped when no constraint is
+  // active.
+  bool hasActiveIndexSet2 = indexSet2->size() != 0;
   _nsds->updateOutput(t,0);
   _nsds->updateOutput(t,1);
-  _nsds->updateOutput(t,2);
+  if(hasActiveIndexSet2)
+    _nsds->updateOutput(t,2);
   //
   for(std::tie(ui, uiend) = _indexSet0->vertices(); ui != uiend; ++ui)
   {
     SP::Interaction inter = _indexSet0->bundle(*ui);
     nsLawSize = inter->nonSmoothLaw()->size();
-    y = inter->y(0);   // output y at this Interaction
-    ydot = inter->y(1); // output of level 1 at this Interaction
-    yddot = inter->y(2);
-    lambda = inter->lambda(2); // input of level 2 at this Interaction
-    if(!(indexSet2->is_vertex(inter)))  // if Interaction is not in the indexSet[2]
+    if(!hasActiveIndexSet2 || !(indexSet2->is_vertex(inter)))  // if Interaction is not in the indexSet[2]
     {
+      const SiconosVector& y = *inter->y(0);   // output y at this Interaction
+      const SiconosVector& ydot = *inter->y(1); // output of level 1 at this Interaction
       for(unsigned int i = 0; i < nsLawSize; ++i)
       {
-        if((*y)(i) > _TOL_ED)
+        if(y(i) > _TOL_ED)
         {
-          gOut[k] = (*y)(i);
+          gOut[k] = y(i);
         }
         else
         {
-          if((*ydot)(i) > -_TOL_ED)
+          if(ydot(i) > -_TOL_ED)
           {
             gOut[k] = 100 * _TOL_ED;
           }
           else
           {
-            gOut[k] = (*y)(i);
+            gOut[k] = y(i);
           }
         }
         k++;
@@ -606,17 +609,19 @@ void EventDriven::computeg(SP::OneStepIntegrator osi,
     }
     else // If Interaction is in the indexSet[2]
     {
+      const SiconosVector& yddot = *inter->y(2);
+      const SiconosVector& lambda = *inter->lambda(2); // input of level 2 at this Interaction
       for(unsigned int i = 0; i < nsLawSize; ++i)
       {
-        if((*lambda)(i) > _TOL_ED)
+        if(lambda(i) > _TOL_ED)
         {
-          gOut[k] = (*lambda)(i); // g = lambda[2]
+          gOut[k] = lambda(i); // g = lambda[2]
         }
         else
         {
-          if((*yddot)(i) > _TOL_ED)
+          if(yddot(i) > _TOL_ED)
           {
-            gOut[k] = (*lambda)(i);
+            gOut[k] = lambda(i);
           }
           else
           {
@@ -20,6 +20,7 @@
 #include "TimeDiscretisationEvent.hpp"
 #include "TimeDiscretisationEventNoSaveInMemory.hpp"
 #include "Simulation.hpp"
+#include <algorithm> // for stable_sort
 #include <cmath>
 #include <limits> // for ULONG_MAX
 #include <gmp.h>
@@ -187,6 +188,29 @@ void EventsManager::scheduleNonSmoothEvent(Simulation& sim, double time, bool ye
   mpz_clear(delta_time);
 }
 
+void EventsManager::updateCurrentTimeStep(double newH)
+{
+  // rebase the discretisation, t_k stays in place
+  _td->setCurrentTimeStep(_k, newH);
+
+  // the pending time-discretisation events were scheduled with the old
+  // h: move each one onto the new grid, at the instant of its own index
+  for(EventsContainer::iterator it = _events.begin(); it != _events.end(); ++it)
+  {
+    std::shared_ptr<TimeDiscretisationEvent> tdEvent = std::dynamic_pointer_cast<TimeDiscretisationEvent>(*it);
+    if(tdEvent)
+      tdEvent->setTime(_td->getTk(tdEvent->getK()));
+  }
+
+  // the retimed events may have crossed events of another kind
+  // (sensors, actuators): restore the time ordering
+  std::stable_sort(_events.begin(), _events.end(),
+                   [](const SP::Event& e1, const SP::Event& e2)
+  {
+    return mpz_cmp(*e1->getTimeOfEvent(), *e2->getTimeOfEvent()) < 0;
+  });
+}
+
 void EventsManager::processEvents(Simulation& sim)
 {
   //process next event
@@ -194,12 +218,55 @@ void EventsManager::processEvents(Simulation& sim)
 
   // update the event stack
   update(sim);
+
+  // Drain the events coincident with the one just processed (insertEv
+  // snaps time instants closer than the tick gap limit to exactly equal
+  // mpz values). Processing them here, back to back, spares one full
+  // advance/process round trip through the simulation loop -- with its
+  // zero-length integration, nonsmooth solve and index-set updates --
+  // per coincident event, which is what an impact train of k
+  // simultaneous events used to pay.
+  while(_events.size() > 1 &&
+        mpz_cmp(*_events[0]->getTimeOfEvent(),
+                *_events[1]->getTimeOfEvent()) == 0)
+  {
+    _events[1]->process(sim);
+    update(sim);
+  }
 }
 
 void EventsManager::update(Simulation& sim)
 {
   // delete last event, since we have processed one
   int event0Type = _events[0]->getType();
+
+  // Fast path for the pure fixed-step case: the set holds only the two
+  // alternating time-discretisation events [t_k, t_{k+1}].  The processed
+  // event is retimed to t_{k+2} and rotated to the back of the two-slot
+  // set, so a step costs neither a sorted insertion (with its mpz
+  // comparisons) nor an erase at the front of the container.
+  if(event0Type == TD_EVENT && _events.size() == 2
+     && _events[1]->getType() == TD_EVENT)
+  {
+    double tkp2 = getTkp2();
+    SP::Event processed(_events[0]);
+    _events[0] = _events[1];
+    if(!std::isnan(tkp2))
+    {
+      std::static_pointer_cast<TimeDiscretisationEvent>(processed)->update(_k + 2);
+      _events[1] = processed;
+    }
+    else
+    {
+      // t_{k+2} is beyond T: only the current event remains and the
+      // simulation will stop, as in the general path below
+      _events.pop_back();
+    }
+    // the new current event is a TD event
+    _k++;
+    return;
+  }
+
   // reschedule an TD event if needed
   if(event0Type == TD_EVENT)
   {
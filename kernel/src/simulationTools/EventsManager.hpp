@@ -223,7 +223,11 @@ public:
    */
   void scheduleNonSmoothEvent(Simulation& sim, double time, bool yes_update = true);
 
-  /** Process the next event, update the indexSets if necessary
+  /** Process the next event and every event coincident with it (equal
+   *  time instants within the tick gap limit), update the indexSets if
+   *  necessary. Coincident events are processed in one call so that a
+   *  batch of simultaneous events costs a single pass through the
+   *  simulation loop.
    *
    *  \param sim the simulation that owns this EventsManager
    */
@@ -309,6 +313,15 @@ public:
     return _td->currentTimeStep(_k);
   }
 
+  /** Change the (constant) timestep during the simulation, keeping the
+   *  current instant t_k in place, and move the already scheduled
+   *  time-discretisation events onto the new grid. Used by adaptive
+   *  time-stepping schemes (see TimeStepping::setAdaptiveTimeStep).
+   *
+   *  \param newH the new timestep
+   */
+  void updateCurrentTimeStep(double newH);
+
   /** get TimeDiscretisation
    *
    *  \return the TimeDiscretisation in use for the time integration
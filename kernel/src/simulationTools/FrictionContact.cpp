@@ -99,16 +99,41 @@ void FrictionContact::initialize(SP::Simulation sim)
 
 void FrictionContact::updateMu()
 {
-  _mu->clear();
+  // mu[k] must describe the contact whose rows start at position
+  // k * _contactProblemDim in the assembled problem.  Positions are handed
+  // out by the persistent layout of the index set (see
+  // InteractionsGraph::updateStablePositions) and are not a monotone
+  // function of the iteration order, so mu is written by position.
   SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+
+  // skip the gather when neither the layout nor any law parameter changed
+  if(indexSet->stableLayout.revision == _muLayoutRevision
+      && NonSmoothLaw::parametersRevision() == _muLawRevision
+      && _mu->size() == indexSet->size())
+    return;
+  _muLayoutRevision = indexSet->stableLayout.revision;
+  _muLawRevision = NonSmoothLaw::parametersRevision();
+
+  _mu->assign(indexSet->size(), 0.0);
   InteractionsGraph::VIterator ui, uiend;
   for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
   {
-    _mu->push_back(std::static_pointer_cast<NewtonImpactFrictionNSL>
-                   (indexSet->bundle(*ui)->nonSmoothLaw())->mu());
+    (*_mu)[indexSet->properties(*ui).absolute_position / _contactProblemDim] =
+      std::static_pointer_cast<NewtonImpactFrictionNSL>
+      (indexSet->bundle(*ui)->nonSmoothLaw())->mu();
   }
 }
 
+bool FrictionContact::exportFrictionProblem(FrictionProblemView& view)
+{
+  if(!exportAssembledProblem(view))
+    return false;
+  updateMu(); // revision guarded, a no-op when mu is current
+  view.mu = _mu->data();
+  view.numberOfContacts = _sizeOutput / _contactProblemDim;
+  return true;
+}
+
 SP::FrictionContactProblem FrictionContact::frictionContactProblem()
 {
   SP::FrictionContactProblem numerics_problem(new FrictionContactProblem());
@@ -170,6 +195,58 @@ bool FrictionContact::checkCompatibleNSLaw(NonSmoothLaw& nslaw)
   return true;
 }
 
+void FrictionContact::applyWarmStartCache()
+{
+  InteractionsGraph& indexSet = *simulation()->indexSet(indexSetLevel());
+  InteractionsGraph::VIterator ui, uiend;
+  for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+  {
+    Interaction& inter = *indexSet.bundle(*ui);
+    auto cached = _reactionCache.find(inter.number());
+    if(cached == _reactionCache.end()) continue;
+
+    unsigned int pos = indexSet.properties(*ui).absolute_position;
+    const std::vector<double>& reaction = cached->second;
+    if(pos + reaction.size() > _sizeOutput) continue;
+
+    for(unsigned int k = 0; k < reaction.size(); ++k)
+      (*_z)(pos + k) = reaction[k];
+
+    auto cachedVelocity = _velocityCache.find(inter.number());
+    if(cachedVelocity != _velocityCache.end())
+    {
+      for(unsigned int k = 0; k < cachedVelocity->second.size(); ++k)
+        (*_w)(pos + k) = cachedVelocity->second[k];
+    }
+  }
+}
+
+void FrictionContact::saveInWarmStartCache()
+{
+  // Cached values of vanished contacts are kept on purpose: a contact
+  // that leaves the index set and comes back a few steps later restarts
+  // from its last converged reaction instead of zero.
+  InteractionsGraph& indexSet = *simulation()->indexSet(indexSetLevel());
+  InteractionsGraph::VIterator ui, uiend;
+  for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+  {
+    Interaction& inter = *indexSet.bundle(*ui);
+    unsigned int pos = indexSet.properties(*ui).absolute_position;
+    unsigned int dim = _contactProblemDim;
+    if(pos + dim > _sizeOutput) continue;
+
+    std::vector<double>& reaction = _reactionCache[inter.number()];
+    std::vector<double>& velocity = _velocityCache[inter.number()];
+    reaction.resize(dim);
+    velocity.resize(dim);
+    for(unsigned int k = 0; k < dim; ++k)
+    {
+      reaction[k] = (*_z)(pos + k);
+      velocity[k] = (*_w)(pos + k);
+    }
+  }
+}
+
 int FrictionContact::compute(double time)
 {
   int info = 0;
@@ -195,8 +272,15 @@ int FrictionContact::compute(double time)
   // - the global options for Numerics (verbose mode ...)
   if(_sizeOutput != 0)
   {
+    if(_useWarmStartCache)
+      applyWarmStartCache();
+
     // Call Numerics Driver for FrictionContact
     info = solve();
+
+    if(_useWarmStartCache)
+      saveInWarmStartCache();
+
     postCompute();
   }
 
@@ -25,6 +25,8 @@
 
 #include <FrictionContactProblem.h>
 #include <Friction_cst.h>
+#include <map>
+#include <vector>
 /** Pointer to function of the type used for drivers for FrictionContact
  * problems in Numerics */
 typedef int (*Driver)(FrictionContactProblem *, double *, double *,
@@ -84,6 +86,22 @@ protected:
 
   FrictionContactProblem _numerics_problem;
 
+  /** reactions and velocities of the previous solve, keyed by
+   * Interaction::number() so that warm starting survives index-set
+   * reordering and contact churn */
+  std::map<size_t, std::vector<double>> _reactionCache;
+  std::map<size_t, std::vector<double>> _velocityCache;
+
+  /** true if the warm-start cache is used to seed z and w before each solve */
+  bool _useWarmStartCache = false;
+
+  /** revisions the flat mu array was last built for: the index-set layout
+   * (InteractionsGraph::StablePositionLayout::revision) and the global law
+   * parameters (NonSmoothLaw::parametersRevision); when both are
+   * unchanged the solver reuses the array as is */
+  std::size_t _muLayoutRevision = SIZE_MAX;
+  std::size_t _muLawRevision = SIZE_MAX;
+
 public:
   /** constructor (solver id and dimension)
    *
@@ -135,6 +153,49 @@ public:
    */
   void updateMu();
 
+  /** zero-copy view over an assembled friction problem: the base view of
+   *  LinearOSNS plus the friction data, for external solver backends */
+  struct FrictionProblemView : LinearOSNS::AssembledProblemView
+  {
+    double* mu = nullptr;              /**< friction coefficients, one per
+                                          contact, position indexed like
+                                          the assembled problem */
+    unsigned int numberOfContacts = 0; /**< size / dimension */
+  };
+
+  /** fill a zero-copy view over the friction problem assembled by the
+   *  last preCompute(); see LinearOSNS::exportAssembledProblem for the
+   *  validity rules.
+   *
+   *  \param view the view to fill
+   *  \return false when no problem is currently assembled
+   */
+  bool exportFrictionProblem(FrictionProblemView& view);
+
+  /** enable or disable the warm-start cache keyed by interaction number
+   *
+   *  \param useCache true to seed z and w from the cached values
+   */
+  inline void setWarmStartCache(bool useCache) { _useWarmStartCache = useCache; }
+
+  /** \return true if the warm-start cache is enabled */
+  inline bool useWarmStartCache() const { return _useWarmStartCache; }
+
+  /** drop every cached reaction/velocity (e.g. after a reset of the model) */
+  inline void clearWarmStartCache()
+  {
+    _reactionCache.clear();
+    _velocityCache.clear();
+  }
+
+  /** seed z and w with the cached reactions/velocities of the surviving
+   *  interactions of the current index set */
+  void applyWarmStartCache();
+
+  /** store the computed reactions/velocities into the cache, keyed by
+   *  interaction number */
+  void saveInWarmStartCache();
+
   /**
      set the driver-function used to solve the problem
 
@@ -25,7 +25,16 @@
 #include "GenericMechanicalProblem.h" // from numerics, for GM problem struct
 #include "FrictionContactProblem.h" // from numerics, for GM problem struct
 #include "RelayProblem.h" // from numerics, for GM problem struct
+#include "LinearComplementarityProblem.h" // from numerics, for LCP struct
 #include "GenericMechanical_Solvers.h"
+#include "NonSmoothDrivers.h" // from numerics, for the specialized drivers
+#include "NumericsMatrix.h" // from numerics, for NM_new
+#include "SparseBlockMatrix.h" // from numerics, for SBM_extract_principal_submatrix
+#include "lcp_cst.h" // from numerics, for SICONOS_LCP_LEMKE
+#include "relay_cst.h" // from numerics, for SICONOS_RELAY_AVI_CAOFERRIS
+
+#include <map>
+#include <vector>
 
 
 #include "SolverOptions.h"
@@ -162,6 +171,251 @@ void GenericMechanical::computeInteractionBlock(const InteractionsGraph::EDescri
   LinearOSNS::computeInteractionBlock(ed);
 }
 
+namespace
+{
+/* nonsmooth law families a homogeneous partition can be routed to */
+enum class NSLFamily { lcp, relay, fc2d, fc3d, unsupported };
+
+NSLFamily nslawFamily(Interaction& inter)
+{
+  Type::Siconos type = Type::value(*inter.nonSmoothLaw());
+  if(type == Type::NewtonImpactNSL)
+    return NSLFamily::lcp;
+  if(type == Type::RelayNSL)
+    return NSLFamily::relay;
+  if(type == Type::NewtonImpactFrictionNSL)
+  {
+    if(inter.nonSmoothLaw()->size() == 2) return NSLFamily::fc2d;
+    if(inter.nonSmoothLaw()->size() == 3) return NSLFamily::fc3d;
+  }
+  return NSLFamily::unsupported;
+}
+
+/* one homogeneous part of the index set, in block order of _M */
+struct NSLPartition
+{
+  std::vector<unsigned int> blockRows; // block row numbers in _M
+  std::vector<unsigned int> positions; // scalar offsets in q/z/w
+  std::vector<SP::Interaction> interactions;
+  unsigned int size = 0; // total scalar size
+};
+
+/* solve one homogeneous part with its specialized driver; M, q, z, w
+   are the (sub)matrix and vectors of that part only */
+int solvePartition(NSLFamily family, const NSLPartition& part,
+                   NumericsMatrix* M, double* q, double* z, double* w,
+                   SolverOptions* options)
+{
+  switch(family)
+  {
+  case NSLFamily::lcp:
+  {
+    LinearComplementarityProblem problem = {};
+    problem.size = (int)part.size;
+    problem.M = M;
+    problem.q = q;
+    return linearComplementarity_driver(&problem, z, w, options);
+  }
+  case NSLFamily::relay:
+  {
+    std::vector<double> lb(part.size), ub(part.size);
+    unsigned int pos = 0;
+    for(const SP::Interaction& inter : part.interactions)
+    {
+      SP::RelayNSL nslaw =
+        std::static_pointer_cast<RelayNSL>(inter->nonSmoothLaw());
+      for(unsigned int i = 0; i < nslaw->size(); ++i, ++pos)
+      {
+        lb[pos] = nslaw->lb();
+        ub[pos] = nslaw->ub();
+      }
+    }
+    RelayProblem problem = {};
+    problem.size = (int)part.size;
+    problem.M = M;
+    problem.q = q;
+    problem.lb = lb.data();
+    problem.ub = ub.data();
+    return relay_driver(&problem, z, w, options);
+  }
+  case NSLFamily::fc2d:
+  case NSLFamily::fc3d:
+  {
+    int dimension = family == NSLFamily::fc2d ? 2 : 3;
+    std::vector<double> mu;
+    mu.reserve(part.interactions.size());
+    for(const SP::Interaction& inter : part.interactions)
+      mu.push_back(std::static_pointer_cast<NewtonImpactFrictionNSL>
+                   (inter->nonSmoothLaw())->mu());
+    FrictionContactProblem problem = {};
+    problem.dimension = dimension;
+    problem.numberOfContacts = (int)part.interactions.size();
+    problem.M = M;
+    problem.q = q;
+    problem.mu = mu.data();
+    return family == NSLFamily::fc2d ?
+           fc2d_driver(&problem, z, w, options) :
+           fc3d_driver(&problem, z, w, options);
+  }
+  default:
+    THROW_EXCEPTION("GenericMechanical::solvePartition - unsupported family");
+  }
+  return 1;
+}
+} // namespace
+
+bool GenericMechanical::computePartitioned(int& info)
+{
+  SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+
+  /* classify the active interactions; block row numbering and positions
+     follow the vertex iteration order, as in OSNSMatrix */
+  std::map<NSLFamily, NSLPartition> partitions;
+  std::map<Interaction*, NSLFamily> familyOf;
+  InteractionsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = indexSet->vertices(); vi != viend; ++vi)
+  {
+    SP::Interaction inter = indexSet->bundle(*vi);
+    NSLFamily family = nslawFamily(*inter);
+    if(family == NSLFamily::unsupported)
+      return false; // equality or exotic laws: keep the generic solver
+    familyOf[inter.get()] = family;
+    NSLPartition& part = partitions[family];
+    part.blockRows.push_back((unsigned int)indexSet->index(*vi));
+    part.positions.push_back(indexSet->properties(*vi).absolute_position);
+    part.interactions.push_back(inter);
+    part.size += inter->nonSmoothLaw()->size();
+  }
+  if(partitions.empty())
+    return false;
+
+  /* the parts can only be solved independently when the families do not
+     couple: an edge between interactions of different families means a
+     genuinely mixed problem */
+  InteractionsGraph::EIterator ei, eiend;
+  for(std::tie(ei, eiend) = indexSet->edges(); ei != eiend; ++ei)
+  {
+    if(familyOf[indexSet->bundle(indexSet->source(*ei)).get()]
+        != familyOf[indexSet->bundle(indexSet->target(*ei)).get()])
+      return false;
+  }
+
+  /* options are created lazily, before the (possibly parallel) solves */
+  for(const auto& item : partitions)
+  {
+    switch(item.first)
+    {
+    case NSLFamily::lcp:
+      if(!_lcpOptions)
+        _lcpOptions.reset(solver_options_create(SICONOS_LCP_LEMKE),
+                          solver_options_delete);
+      break;
+    case NSLFamily::relay:
+      if(!_relayOptions)
+        _relayOptions.reset(solver_options_create(SICONOS_RELAY_AVI_CAOFERRIS),
+                            solver_options_delete);
+      break;
+    case NSLFamily::fc2d:
+      if(!_fc2dOptions)
+        _fc2dOptions.reset(solver_options_create(SICONOS_FRICTION_2D_NSGS),
+                           solver_options_delete);
+      break;
+    default:
+      if(!_fc3dOptions)
+        _fc3dOptions.reset(solver_options_create(SICONOS_FRICTION_3D_NSGS),
+                           solver_options_delete);
+      break;
+    }
+  }
+  auto optionsOf = [this](NSLFamily family) -> SolverOptions*
+  {
+    switch(family)
+    {
+    case NSLFamily::lcp: return _lcpOptions.get();
+    case NSLFamily::relay: return _relayOptions.get();
+    case NSLFamily::fc2d: return _fc2dOptions.get();
+    default: return _fc3dOptions.get();
+    }
+  };
+
+  NumericsMatrix& Mfull = *_M->numericsMatrix();
+
+  if(partitions.size() == 1)
+  {
+    // homogeneous scene: the assembled matrix is used as is
+    NSLFamily family = partitions.begin()->first;
+    info = solvePartition(family, partitions.begin()->second, &Mfull,
+                          _q->getArray(), _z->getArray(), _w->getArray(),
+                          optionsOf(family));
+    return true;
+  }
+
+  // extracting the per-family submatrices requires sparse block storage
+  if(Mfull.storageType != NM_SPARSE_BLOCK || !Mfull.matrix1)
+    return false;
+
+  std::vector<std::pair<NSLFamily, const NSLPartition*> > parts;
+  parts.reserve(partitions.size());
+  for(const auto& item : partitions)
+    parts.push_back(std::make_pair(item.first, &item.second));
+  std::vector<int> infos(parts.size(), 0);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(std::ptrdiff_t p = 0; p < static_cast<std::ptrdiff_t>(parts.size()); ++p)
+  {
+    const NSLPartition& part = *parts[p].second;
+
+    // gather the part's segments of q and z (warm start)
+    std::vector<double> q(part.size), z(part.size), w(part.size, 0.0);
+    unsigned int pos = 0;
+    for(std::size_t i = 0; i < part.interactions.size(); ++i)
+    {
+      unsigned int nslawSize = part.interactions[i]->nonSmoothLaw()->size();
+      for(unsigned int k = 0; k < nslawSize; ++k, ++pos)
+      {
+        q[pos] = (*_q)(part.positions[i] + k);
+        z[pos] = (*_z)(part.positions[i] + k);
+      }
+    }
+
+    // principal submatrix sharing the blocks of the assembled matrix
+    SparseBlockStructuredMatrix* sub =
+      SBM_extract_principal_submatrix(Mfull.matrix1, part.blockRows.data(),
+                                      (unsigned int)part.blockRows.size());
+    NumericsMatrix* M = NM_new();
+    M->storageType = NM_SPARSE_BLOCK;
+    M->matrix1 = sub;
+    M->size0 = (int)part.size;
+    M->size1 = (int)part.size;
+
+    infos[p] = solvePartition(parts[p].first, part, M, q.data(), z.data(),
+                              w.data(), optionsOf(parts[p].first));
+
+    // scatter the solution back
+    pos = 0;
+    for(std::size_t i = 0; i < part.interactions.size(); ++i)
+    {
+      unsigned int nslawSize = part.interactions[i]->nonSmoothLaw()->size();
+      for(unsigned int k = 0; k < nslawSize; ++k, ++pos)
+      {
+        (*_z)(part.positions[i] + k) = z[pos];
+        (*_w)(part.positions[i] + k) = w[pos];
+      }
+    }
+
+    M->matrix1 = nullptr;
+    NM_free_not_SBM(M);
+    SBM_free_principal_submatrix(sub);
+  }
+
+  info = 0;
+  for(int partInfo : infos)
+    if(partInfo) info = partInfo;
+  return true;
+}
+
 int GenericMechanical::compute(double time)
 {
   DEBUG_BEGIN("GenericMechanical::compute(double time)\n");
@@ -199,19 +453,29 @@ int GenericMechanical::compute(double time)
 
   if(_sizeOutput != 0)
   {
-    // The GenericMechanical Problem in Numerics format
-
-    _pnumerics_GMP->M = &*_M->numericsMatrix();
-    _pnumerics_GMP->q = &*_q->getArray();
-    DEBUG_EXPR(display(););
-    // Call Numerics Driver for GenericMechanical
-    //    display();
-    info = gmp_driver(_pnumerics_GMP,
-                      &*_z->getArray(),
-                      &*_w->getArray(),
-                      &*_numerics_solver_options);
-    //printf("GenericMechanical::compute : R:\n");
-    //_z->display();
+    // When the active interactions split by nonsmooth law family into
+    // decoupled homogeneous parts, each part is solved by its
+    // specialized solver instead of the generic mixed one.
+    bool partitioned = false;
+    if(_automaticPartitioning)
+      partitioned = computePartitioned(info);
+
+    if(!partitioned)
+    {
+      // The GenericMechanical Problem in Numerics format
+
+      _pnumerics_GMP->M = &*_M->numericsMatrix();
+      _pnumerics_GMP->q = &*_q->getArray();
+      DEBUG_EXPR(display(););
+      // Call Numerics Driver for GenericMechanical
+      //    display();
+      info = gmp_driver(_pnumerics_GMP,
+                        &*_z->getArray(),
+                        &*_w->getArray(),
+                        &*_numerics_solver_options);
+      //printf("GenericMechanical::compute : R:\n");
+      //_z->display();
+    }
     postCompute();
 
   }
@@ -53,6 +53,32 @@ protected:
 
   GenericMechanicalProblem *_pnumerics_GMP;
 
+  /** when true (default), compute() inspects the active index set and,
+   *  whenever the interactions split by nonsmooth law family into
+   *  decoupled homogeneous parts, solves each part with the matching
+   *  specialized solver (LCP, Relay, FC2D, FC3D) instead of the mixed
+   *  generic solver. Scenes mixing families on coupled interactions
+   *  fall back to the generic solver unchanged. */
+  bool _automaticPartitioning = true;
+
+  /** options of the specialized solvers used on homogeneous partitions,
+   *  created lazily with the same defaults as the dedicated OSNS
+   *  problems (LCP, Relay, FrictionContact) */
+  SP::SolverOptions _lcpOptions;
+  SP::SolverOptions _relayOptions;
+  SP::SolverOptions _fc2dOptions;
+  SP::SolverOptions _fc3dOptions;
+
+  /** try to solve the current problem family by family with the
+   *  specialized solvers (in parallel over the parts when OpenMP is
+   *  enabled)
+   *
+   *  \param[out] info solver output (0 if ok)
+   *  \return true if the partitioned solve was applicable and done,
+   *  false to fall back to the generic solver
+   */
+  bool computePartitioned(int &info);
+
 public:
   /** constructor from solver id
    *  
@@ -103,6 +129,17 @@ public:
   void computeDiagonalInteractionBlock(
       const InteractionsGraph::VDescriptor &vd) override;
 
+  /** enable or disable the automatic partitioning of the problem by
+   *  nonsmooth law family (enabled by default)
+   *
+   *  \param value true to allow the specialized solvers on decoupled
+   *  homogeneous parts, false to always use the generic solver
+   */
+  void setAutomaticPartitioning(bool value) { _automaticPartitioning = value; };
+
+  /** \return true if automatic partitioning is enabled */
+  bool automaticPartitioning() const { return _automaticPartitioning; };
+
   /** print the data to the screen */
   void display() const override;
 
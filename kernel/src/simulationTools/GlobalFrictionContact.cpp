@@ -210,9 +210,6 @@ bool GlobalFrictionContact::preCompute(double time)
     //   DEBUG_END("GlobalFrictionContact::preCompute(double time)\n");
     //   return false; }
 
-    _mu->clear();
-//    _mu.reserve(indexSet.size())
-
 #if !defined(SICONOS_USE_MAP_FOR_HASH)
     typedef std::unordered_map<SP::DynamicalSystem, SiconosMatrix*> dsMatMap;
     typedef std::unordered_map<SP::DynamicalSystem, size_t> dsPosMap;
@@ -321,7 +318,7 @@ bool GlobalFrictionContact::preCompute(double time)
       SP::Interaction inter = indexSet.bundle(*ui);
 
       assert(Type::value(*(inter->nonSmoothLaw())) == Type::NewtonImpactFrictionNSL);
-      _mu->push_back(std::static_pointer_cast<NewtonImpactFrictionNSL>(inter->nonSmoothLaw())->mu()); //curious !!
+      // mu is maintained by updateMu(), written by position
 
       SP::DynamicalSystem ds1 = indexSet.properties(*ui).source;
       SP::DynamicalSystem ds2 = indexSet.properties(*ui).target;
@@ -539,12 +536,26 @@ void GlobalFrictionContact::display() const
 
 void GlobalFrictionContact::updateMu()
 {
-  _mu->clear();
+  // mu[k] must describe the contact whose rows start at position
+  // k * _contactProblemDim: positions from the persistent layout
+  // (InteractionsGraph::updateStablePositions) are not a monotone function
+  // of the iteration order, so mu is written by position.
   SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+
+  // skip the gather when neither the layout nor any law parameter changed
+  if(indexSet->stableLayout.revision == _muLayoutRevision
+      && NonSmoothLaw::parametersRevision() == _muLawRevision
+      && _mu->size() == indexSet->size())
+    return;
+  _muLayoutRevision = indexSet->stableLayout.revision;
+  _muLawRevision = NonSmoothLaw::parametersRevision();
+
+  _mu->assign(indexSet->size(), 0.0);
   InteractionsGraph::VIterator ui, uiend;
   for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
   {
-    _mu->push_back(std::static_pointer_cast<NewtonImpactFrictionNSL>
-                   (indexSet->bundle(*ui)->nonSmoothLaw())->mu());
+    (*_mu)[indexSet->properties(*ui).absolute_position / _contactProblemDim] =
+      std::static_pointer_cast<NewtonImpactFrictionNSL>
+      (indexSet->bundle(*ui)->nonSmoothLaw())->mu();
   }
 }
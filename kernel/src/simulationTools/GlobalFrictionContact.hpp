@@ -98,6 +98,11 @@ protected:
   /** friction coefficients */
   SP::MuStorage _mu;
 
+  /** revisions the flat mu array was last built for, see
+   * FrictionContact::_muLayoutRevision */
+  std::size_t _muLayoutRevision = SIZE_MAX;
+  std::size_t _muLawRevision = SIZE_MAX;
+
   /** Pointer to the function used to call the Numerics driver to solve the problem */
   GFC3D_Driver _gfc_driver;
 
@@ -160,10 +160,6 @@ bool GlobalRollingFrictionContact::preCompute(double time)
     //   DEBUG_END("GlobalRollingFrictionContact::preCompute(double time)\n");
     //   return false; }
 
-    _mu->clear();
-    _mu_r->clear();
-//    _mu.reserve(indexSet.size())
-
 #if !defined(SICONOS_USE_MAP_FOR_HASH)
     typedef std::unordered_map<SP::DynamicalSystem, SiconosMatrix*> dsMatMap;
     typedef std::unordered_map<SP::DynamicalSystem, size_t> dsPosMap;
@@ -245,8 +241,7 @@ bool GlobalRollingFrictionContact::preCompute(double time)
       SP::Interaction inter = indexSet.bundle(*ui);
 
       assert(Type::value(*(inter->nonSmoothLaw())) == Type::NewtonImpactRollingFrictionNSL);
-      _mu->push_back(std::static_pointer_cast<NewtonImpactRollingFrictionNSL>(inter->nonSmoothLaw())->mu());
-      _mu_r->push_back(std::static_pointer_cast<NewtonImpactRollingFrictionNSL>(inter->nonSmoothLaw())->muR());
+      // mu and mu_r are maintained by updateMu()/updateMur(), written by position
 
       SP::DynamicalSystem ds1 = indexSet.properties(*ui).source;
       SP::DynamicalSystem ds2 = indexSet.properties(*ui).target;
@@ -329,24 +324,49 @@ int GlobalRollingFrictionContact::solve(SP::GlobalRollingFrictionContactProblem
 
 void GlobalRollingFrictionContact::updateMur()
 {
-  _mu_r->clear();
+  // Written by position: mu_r[k] must describe the contact whose rows
+  // start at position k * _contactProblemDim (see
+  // InteractionsGraph::updateStablePositions).
   SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+
+  // skip the gather when neither the layout nor any law parameter changed
+  if(indexSet->stableLayout.revision == _muRLayoutRevision
+      && NonSmoothLaw::parametersRevision() == _muRLawRevision
+      && _mu_r->size() == indexSet->size())
+    return;
+  _muRLayoutRevision = indexSet->stableLayout.revision;
+  _muRLawRevision = NonSmoothLaw::parametersRevision();
+
+  _mu_r->assign(indexSet->size(), 0.0);
   InteractionsGraph::VIterator ui, uiend;
   for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
   {
-    _mu_r->push_back(std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
-                     (indexSet->bundle(*ui)->nonSmoothLaw())->muR());
+    (*_mu_r)[indexSet->properties(*ui).absolute_position / _contactProblemDim] =
+      std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
+      (indexSet->bundle(*ui)->nonSmoothLaw())->muR();
   }
 }
 void GlobalRollingFrictionContact::updateMu()
 {
-  _mu_r->clear();
+  // Same layout as updateMur; note that this refreshes _mu (the sliding
+  // coefficients), which the previous version overwrote into _mu_r.
   SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+
+  // skip the gather when neither the layout nor any law parameter changed
+  if(indexSet->stableLayout.revision == _muLayoutRevision
+      && NonSmoothLaw::parametersRevision() == _muLawRevision
+      && _mu->size() == indexSet->size())
+    return;
+  _muLayoutRevision = indexSet->stableLayout.revision;
+  _muLawRevision = NonSmoothLaw::parametersRevision();
+
+  _mu->assign(indexSet->size(), 0.0);
   InteractionsGraph::VIterator ui, uiend;
   for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
   {
-    _mu_r->push_back(std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
-                     (indexSet->bundle(*ui)->nonSmoothLaw())->mu());
+    (*_mu)[indexSet->properties(*ui).absolute_position / _contactProblemDim] =
+      std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
+      (indexSet->bundle(*ui)->nonSmoothLaw())->mu();
   }
 }
 void GlobalRollingFrictionContact::display() const
@@ -87,6 +87,11 @@ protected:
   /** rolling friction coefficients */
   SP::MuStorage _mu_r;
 
+  /** revisions the flat mu_r array was last built for, see
+   * FrictionContact::_muLayoutRevision (the inherited pair guards _mu) */
+  std::size_t _muRLayoutRevision = SIZE_MAX;
+  std::size_t _muRLawRevision = SIZE_MAX;
+
   /** Pointer to the function used to call the Numerics driver to solve the problem */
   GRFC3D_Driver _g_rolling_driver;
 
@@ -255,16 +255,16 @@ void Hem5OSI::updateData()
 
 void Hem5OSI::fillqWork(integer* NQ, doublereal* q)
 {
-  unsigned int sizeQ = (unsigned int)(*NQ);
-  for(unsigned int i = 0; i < sizeQ ; ++i)
-    (*_qWork)(i) = q[i];
+  assert((unsigned int)(*NQ) == _qWork->size() && "Hem5OSI::fillqWork qWork and NQ have different sizes");
+  // block-wise scatter; the per-element operator() of BlockVector pays a
+  // block lookup for every entry
+  (*_qWork) = q;
 }
 
 void Hem5OSI::fillvWork(integer* NV, doublereal* v)
 {
-  unsigned int sizeV = (unsigned int)(*NV);
-  for(unsigned int i = 0; i < sizeV ; ++i)
-    (*_vWork)(i) = v[i];
+  assert((unsigned int)(*NV) == _vWork->size() && "Hem5OSI::fillvWork vWork and NV have different sizes");
+  (*_vWork) = v;
 }
 
 void Hem5OSI::computeRhs(double t)
@@ -322,6 +322,10 @@ void Hem5OSI_impl::fprob(integer* IFCN,
 
   if((ifcn == 1) || (ifcn >= 7))  // compute Mass AM
   {
+    // the mass is block diagonal w.r.t the DS: clear once, then write each
+    // DS block with local indices
+    unsigned int sizeV = (unsigned int)(*NV);
+    for(unsigned int kk = 0; kk < sizeV * sizeV; ++kk) AM[kk] = 0.;
     unsigned int pos=0;
     for(DynamicalSystemsGraph::VIterator vi = dsGraph->begin(); vi != dsGraph->end(); ++vi)
     {
@@ -330,31 +334,25 @@ void Hem5OSI_impl::fprob(integer* IFCN,
           Type::value(*ds) == Type::LagrangianLinearTIDS)
       {
         LagrangianDS& lds = *std::static_pointer_cast<LagrangianDS>(ds);
+        unsigned int n = lds.dimension();
         if(lds.mass())
         {
           lds.computeMass();
-          for(unsigned int ii =pos ; ii < ((unsigned int)(*NV)+pos); ii ++)
+          const SiconosMatrix& mass = *lds.mass();
+          for(unsigned int jj = 0; jj < n; jj ++)
           {
-            for(unsigned int jj =pos ; jj < ((unsigned int)(*NV)+pos); jj ++)
+            for(unsigned int ii = 0; ii < n; ii ++)
             {
-              AM[ii + jj*(int)(*NV)] = lds.mass()->getValue(ii,jj) ;
+              AM[(pos + ii) + (pos + jj)*sizeV] = mass.getValue(ii,jj) ;
             }
           }
         }
         else
         {
-          for(unsigned int ii =pos ; ii < ((unsigned int)(*NV)+pos); ii ++)
-          {
-            for(unsigned int jj =pos ; jj < ((unsigned int)(*NV)+pos); jj ++)
-            {
-              if(ii == jj)
-                AM[ii + jj*(int)(*NV)] = 1.;
-              else
-                AM[ii + jj*(int)(*NV)] = 0.;
-            }
-          }
+          for(unsigned int ii = 0; ii < n; ii ++)
+            AM[(pos + ii) + (pos + ii)*sizeV] = 1.;
         }
-        pos += lds.dimension();
+        pos += n;
       }
       else
       {
@@ -377,8 +375,7 @@ void Hem5OSI_impl::fprob(integer* IFCN,
           Type::value(*ds) == Type::LagrangianLinearTIDS)
       {
         LagrangianDS& lds = *std::static_pointer_cast<LagrangianDS>(ds);
-        hem5osi->fillqWork(NQ,q);
-        hem5osi->fillvWork(NV,v);
+        // q and v have already been scattered into the DS at the top of fprob
         lds.computeForces((double)*time, lds.q(), lds.velocity());
       }
       else if(Type::value(*ds) == Type::NewtonEulerDS)
@@ -390,10 +387,11 @@ void Hem5OSI_impl::fprob(integer* IFCN,
         THROW_EXCEPTION("Hem5OSI::fprob(), Only integration of Lagrangian DS is allowed");
       }
     }
-    for(unsigned int ii =0 ; ii < (unsigned int)(*NV); ii ++)
-    {
-      F[ii] = hem5osi->_forcesWork->getValue(ii) ;
-    }
+    // block-wise gather of all DS contributions, without going through the
+    // per-element getValue of BlockVector
+    unsigned int pos = 0;
+    for(auto it = hem5osi->_forcesWork->begin(); it != hem5osi->_forcesWork->end(); ++it)
+      pos += (*it)->copyData(&F[pos]);
   }
   if(ifcn == 4)  // compute G (constraints)
   {
@@ -713,32 +711,30 @@ void Hem5OSI::integrate(double& tinit, double& tend, double& tout, int& idid)
 
 
   updateIntData();
-  if(!_qtmp)
-  {
+  // When the OSI integrates a single block, HEM5 can work directly in the
+  // DS storage: the tmp vectors become views on that block and the
+  // continuous-memory copies below are skipped. Otherwise the tmp vectors
+  // are persistent and only reallocated when the problem size changes.
+  if(_qWork->numberOfBlocks() == 1)
+    _qtmp = _qWork->vector(0);
+  else if(!_qtmp || _qtmp->size() != _qWork->size())
     _qtmp.reset(new SiconosVector(_qWork->size()));
-  }
-  else
-    _qtmp->resize((int)_intData[0],true);
 
   DEBUG_PRINTF("Hem5OSI::integrate() _intData[0] (NQ) = %i \n",_intData[0]);
 
-  if(!_vtmp)
-  {
+  if(_vWork->numberOfBlocks() == 1)
+    _vtmp = _vWork->vector(0);
+  else if(!_vtmp || _vtmp->size() != _vWork->size())
     _vtmp.reset(new SiconosVector(_vWork->size()));
-  }
-  else
-    _vtmp->resize((int)_intData[1],true);
-
 
-  _utmp.reset(new SiconosVector(1));
+  if(!_utmp)
+    _utmp.reset(new SiconosVector(1));
   DEBUG_PRINTF("Hem5OSI::integrate() _intData[2] (NU) = %i \n",_intData[2]);
 
-  if(!_atmp)
-  {
-    _atmp.reset(new SiconosVector(_vWork->size()));
-  }
-  else
-    _atmp->resize((int)_intData[1],true);
+  if(_aWork->numberOfBlocks() == 1)
+    _atmp = _aWork->vector(0);
+  else if(!_atmp || _atmp->size() != _aWork->size())
+    _atmp.reset(new SiconosVector(_aWork->size()));
 
   if(!_lambdatmp)
   {
@@ -804,10 +800,14 @@ void Hem5OSI::integrate(double& tinit, double& tend, double& tout, int& idid)
   rtol[0] = HEM5_RTOL_DEFAULT ; // rtol
   atol[0] = HEM5_ATOL_DEFAULT ;  // atol
 
-  *_qtmp = *_qWork; // Copy into a continuous memory chuck
-  *_vtmp = *_vWork; // Copy into a continuous memory chuck
+  bool qDirect = (_qWork->numberOfBlocks() == 1) && (_qtmp == _qWork->vector(0));
+  bool vDirect = (_vWork->numberOfBlocks() == 1) && (_vtmp == _vWork->vector(0));
+  bool aDirect = (_aWork->numberOfBlocks() == 1) && (_atmp == _aWork->vector(0));
+
+  if(!qDirect) *_qtmp = *_qWork; // Copy into a continuous memory chuck
+  if(!vDirect) *_vtmp = *_vWork; // Copy into a continuous memory chuck
   //*_utmp = *_uWork; // Copy into a continuous memory chuck
-  *_atmp = *_aWork; // Copy into a continuous memory chuck
+  if(!aDirect) *_atmp = *_aWork; // Copy into a continuous memory chuck
 
   DEBUG_EXPR(_qtmp->display(););
   DEBUG_EXPR(_vtmp->display(););
@@ -885,9 +885,9 @@ void Hem5OSI::integrate(double& tinit, double& tend, double& tout, int& idid)
                 std::cout << "NFCN = " << iwork[33] <<std::endl;
                 std::cout << "NDEC = " << iwork[34] <<std::endl;
                 std::cout << "NSOL = " << iwork[35] <<std::endl;);
-  *_qWork = *_qtmp;
-  *_vWork = *_vtmp;
-  *_aWork = *_atmp;
+  if(!qDirect) *_qWork = *_qtmp;
+  if(!vDirect) *_vWork = *_vtmp;
+  if(!aDirect) *_aWork = *_atmp;
 
   DEBUG_PRINTF("tend_DR = %f\n", (double) tend_DR);
   DEBUG_EXPR(_qWork->display());
@@ -38,6 +38,32 @@ public:
    * the Newton loop. */
   virtual void updateInteractions(SP::Simulation simulation) {}
 
+  /** Speculative detection protocol, used by TimeStepping when the
+   *  pipelined interaction update is enabled (see
+   *  TimeStepping::setPipelinedInteractionUpdate). A manager that
+   *  supports it splits updateInteractions into a detection phase that
+   *  reads the world and keeps its results aside without touching the
+   *  NonSmoothDynamicalSystem -- it is run on a worker thread while the
+   *  one-step nonsmooth problem is solved -- and a commit phase that
+   *  creates and removes the interactions on the simulation thread. The
+   *  detection must use an envelope large enough to stay valid for any
+   *  configuration within the validation margin of the simulation.
+   *
+   *  \return true if detectInteractions/commitInteractions are
+   *  implemented */
+  virtual bool supportsSpeculativeUpdateInteractions() const { return false; }
+
+  /** detection phase: run broadphase and narrowphase for the current
+   *  world state, without modifying the NonSmoothDynamicalSystem; may be
+   *  called from a worker thread
+   *  \param simulation the simulation */
+  virtual void detectInteractions(SP::Simulation simulation) {}
+
+  /** commit phase: apply the results of the last detectInteractions
+   *  call; always called from the simulation thread
+   *  \param simulation the simulation */
+  virtual void commitInteractions(SP::Simulation simulation) {}
+
   /** Specify a non-smooth law to use for a given combination of
    *  interaction groups.
    * \param nslaw the new nonsmooth law
@@ -19,6 +19,10 @@
 #include "OSNSMatrix.hpp"
 #include "SolverOptions.h"
 #include "ComplementarityConditionNSL.hpp"
+#include "Simulation.hpp"
+#include "SimulationGraphs.hpp"
+#include "Interaction.hpp"
+#include "NonSmoothLaw.hpp"
 // --- numerics headers ---
 #include "NonSmoothDrivers.h"
 #include "LCP_Solvers.h"
@@ -58,6 +62,58 @@ bool LCP::checkCompatibleNSLaw(NonSmoothLaw& nslaw)
 }
 
 
+void LCP::applyWarmStartCache()
+{
+  InteractionsGraph& indexSet = *simulation()->indexSet(indexSetLevel());
+  InteractionsGraph::VIterator ui, uiend;
+  for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+  {
+    Interaction& inter = *indexSet.bundle(*ui);
+    auto cached = _zCache.find(inter.number());
+    if(cached == _zCache.end()) continue;
+
+    unsigned int pos = indexSet.properties(*ui).absolute_position;
+    const std::vector<double>& z = cached->second;
+    if(pos + z.size() > _sizeOutput) continue;
+
+    for(unsigned int k = 0; k < z.size(); ++k)
+      (*_z)(pos + k) = z[k];
+
+    auto cachedW = _wCache.find(inter.number());
+    if(cachedW != _wCache.end())
+    {
+      for(unsigned int k = 0; k < cachedW->second.size(); ++k)
+        (*_w)(pos + k) = cachedW->second[k];
+    }
+  }
+}
+
+void LCP::saveInWarmStartCache()
+{
+  // Cached values of constraints that left the index set are kept on
+  // purpose: a constraint that deactivates and comes back a few events
+  // later restarts from its last solution instead of zero.
+  InteractionsGraph& indexSet = *simulation()->indexSet(indexSetLevel());
+  InteractionsGraph::VIterator ui, uiend;
+  for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+  {
+    Interaction& inter = *indexSet.bundle(*ui);
+    unsigned int pos = indexSet.properties(*ui).absolute_position;
+    unsigned int dim = inter.nonSmoothLaw()->size();
+    if(pos + dim > _sizeOutput) continue;
+
+    std::vector<double>& z = _zCache[inter.number()];
+    std::vector<double>& w = _wCache[inter.number()];
+    z.resize(dim);
+    w.resize(dim);
+    for(unsigned int k = 0; k < dim; ++k)
+    {
+      z[k] = (*_z)(pos + k);
+      w[k] = (*_w)(pos + k);
+    }
+  }
+}
+
 int LCP::solve()
 {
   // Note FP : wrap call to numerics solver inside this function
@@ -68,6 +124,14 @@ int LCP::solve()
   _numerics_problem->q = _q->getArray();
   _numerics_problem->size = _sizeOutput;
   int info  = 0;
+
+  // A pivoting solver may restart from the basis suggested by the incoming
+  // z (seeded by the warm-start cache): when the active set is unchanged
+  // between two adjacent events, one linear solve replaces the whole pivot
+  // sequence.
+  if(_useWarmStartCache
+     && _numerics_solver_options->solverId == SICONOS_LCP_LEMKE)
+    _numerics_solver_options->iparam[SICONOS_LCP_IPARAM_WARM_START_FROM_Z] = 1;
   //const char * name = &*_numerics_solver_options->solverName;
 
   if(_numerics_solver_options->solverId == SICONOS_LCP_ENUM)
@@ -113,8 +177,14 @@ int LCP::compute(double time)
 
   if(_sizeOutput != 0)
   {
+    if(_useWarmStartCache)
+      applyWarmStartCache();
 
     info = solve();
+
+    if(_useWarmStartCache)
+      saveInWarmStartCache();
+
     // --- Recovering of the desired variables from LCP output ---
     postCompute();
 
@@ -59,6 +59,15 @@ protected:
   /** Structure (for Numerics component) that describes the problem to solve */
   SP::LinearComplementarityProblem _numerics_problem;
 
+  /** z and w of the previous solve, keyed by Interaction::number() so that
+   * warm starting survives index-set reordering and constraint churn
+   * between adjacent events */
+  std::map<size_t, std::vector<double>> _zCache;
+  std::map<size_t, std::vector<double>> _wCache;
+
+  /** true if the warm-start cache is used to seed z and w before each solve */
+  bool _useWarmStartCache = false;
+
 public:
 
   /** constructor from numerics solver id
@@ -94,6 +103,30 @@ public:
   int compute(double time) override;
 
 
+  /** enable or disable the warm-start cache keyed by interaction number
+   *
+   *  \param useCache true to seed z and w from the cached values
+   */
+  inline void setWarmStartCache(bool useCache) { _useWarmStartCache = useCache; }
+
+  /** \return true if the warm-start cache is enabled */
+  inline bool useWarmStartCache() const { return _useWarmStartCache; }
+
+  /** drop every cached z/w (e.g. after a reset of the model) */
+  inline void clearWarmStartCache()
+  {
+    _zCache.clear();
+    _wCache.clear();
+  }
+
+  /** seed z and w with the cached values of the surviving interactions of
+   *  the current index set */
+  void applyWarmStartCache();
+
+  /** store the computed z and w into the cache, keyed by interaction
+   *  number */
+  void saveInWarmStartCache();
+
    /* Check the compatibility fol the nslaw with the targeted OSNSP */
   bool checkCompatibleNSLaw(NonSmoothLaw& nslaw) override;
 
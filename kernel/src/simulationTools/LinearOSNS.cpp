@@ -16,6 +16,8 @@
  * limitations under the License.
  */
 #include "LinearOSNS.hpp"
+#include <algorithm> // for std::lower_bound on the block index
+#include <cstring>   // for memcpy (scatter/gather plan)
 #include "NumericsMatrix.h"
 #include "SiconosAlgebraProd.hpp"
 #include "Simulation.hpp"
@@ -42,6 +44,7 @@
 #include "LagrangianLinearTIDS.hpp"
 #include "NewtonEulerDS.hpp"
 #include "OSNSMatrix.hpp"
+#include "SiconosTaskPool.hpp"
 
 #include "Tools.hpp"
 #include <chrono>
@@ -750,6 +753,99 @@ void LinearOSNS::computeInteractionBlock(const InteractionsGraph::EDescriptor& e
   DEBUG_END("LinearOSNS::computeInteractionBlock(const InteractionsGraph::EDescriptor& ed)\n");
 }
 
+void LinearOSNS::updateInteractionBlockIndex(InteractionsGraph& indexSet)
+{
+  DynamicalSystemsGraph& DSG0 = *simulation()->nonSmoothDynamicalSystem()->dynamicalSystems();
+  _blockIndex.clear();
+  _blockIndex.reserve(indexSet.size());
+  InteractionsGraph::VIterator ui, uiend;
+  for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+  {
+    InteractionBlockIndexEntry entry;
+    entry.vertex = *ui;
+    entry.inter = indexSet.bundle(*ui).get();
+    entry.pos = indexSet.properties(*ui).absolute_position;
+    entry.size = entry.inter->nonSmoothLaw()->size();
+    SP::DynamicalSystem ds1 = indexSet.properties(*ui).source;
+    SP::DynamicalSystem ds2 = indexSet.properties(*ui).target;
+    entry.osi1 = DSG0.properties(DSG0.descriptor(ds1)).osi.get();
+    entry.osi2 = (ds2 == ds1) ? entry.osi1
+                 : DSG0.properties(DSG0.descriptor(ds2)).osi.get();
+
+    // Scatter/gather plan: raw storage pointers, so that the per-step
+    // copies are plain memcpy instead of setBlock bounds logic. The
+    // rhs pointer is resolved with the same OSI dispatch as
+    // computeqBlock; unsupported combinations keep the generic path.
+    entry.lambda = entry.inter->lambda(inputOutputLevel())->getArray();
+    entry.osnspRhs = nullptr;
+    if(entry.osi1->getType() == entry.osi2->getType()
+        && indexSet.properties(*ui).workVectors)
+    {
+      VectorOfVectors& wv = *indexSet.properties(*ui).workVectors;
+      SP::SiconosVector rhs;
+      switch(entry.osi1->getType())
+      {
+      case OSI::EULERMOREAUOSI:
+        rhs = wv[EulerMoreauOSI::OSNSP_RHS];
+        break;
+      case OSI::ZOHOSI:
+        rhs = wv[ZeroOrderHoldOSI::OSNSP_RHS];
+        break;
+      case OSI::MOREAUJEANOSI:
+      case OSI::MOREAUDIRECTPROJECTIONOSI:
+        rhs = wv[MoreauJeanOSI::OSNSP_RHS];
+        break;
+      case OSI::MOREAUJEANBILBAOOSI:
+        rhs = wv[MoreauJeanBilbaoOSI::OSNSP_RHS];
+        break;
+      case OSI::LSODAROSI:
+        rhs = wv[LsodarOSI::OSNSP_RHS];
+        break;
+      case OSI::NEWMARKALPHAOSI:
+        rhs = wv[NewMarkAlphaOSI::OSNSP_RHS];
+        break;
+      case OSI::SCHATZMANPAOLIOSI:
+        rhs = wv[SchatzmanPaoliOSI::OSNSP_RHS];
+        break;
+      case OSI::D1MINUSLINEAROSI:
+        rhs = wv[D1MinusLinearOSI::OSNSP_RHS];
+        break;
+      default:
+        break;
+      }
+      if(rhs)
+        entry.osnspRhs = rhs->getArray();
+    }
+    _blockIndex.push_back(entry);
+  }
+}
+
+const std::vector<LinearOSNS::InteractionBlockIndexEntry>&
+LinearOSNS::interactionBlockIndex(InteractionsGraph& indexSet)
+{
+  // Cheap consistency walk: pointer and offset compares only, no map
+  // lookup. The index is rebuilt (paying the DS -> descriptor lookups)
+  // only when the topology really changed.
+  bool stale = _blockIndex.size() != indexSet.size();
+  if(!stale)
+  {
+    size_t k = 0;
+    InteractionsGraph::VIterator ui, uiend;
+    for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend && !stale; ++ui, ++k)
+    {
+      Interaction* inter = indexSet.bundle(*ui).get();
+      stale = _blockIndex[k].vertex != *ui
+              || _blockIndex[k].inter != inter
+              || _blockIndex[k].pos != indexSet.properties(*ui).absolute_position
+              // a reinitialized interaction reallocates its lambda
+              || _blockIndex[k].lambda != inter->lambda(inputOutputLevel())->getArray();
+    }
+  }
+  if(stale)
+    updateInteractionBlockIndex(indexSet);
+  return _blockIndex;
+}
+
 void LinearOSNS::computeqBlock(InteractionsGraph::VDescriptor& vertex_inter, unsigned int pos)
 {
   DEBUG_BEGIN("LinearOSNS::computeqBlock(SP::Interaction inter, unsigned int pos)\n");
@@ -788,10 +884,41 @@ void LinearOSNS::computeqBlock(InteractionsGraph::VDescriptor& vertex_inter, uns
   assert(ds1);
   assert(ds2);
 
+  // The flat block index caches the OSI of each connected DS.
+  // Positions are strictly increasing over the index, so the entry is
+  // recovered by binary search; the DS -> descriptor map lookups are
+  // only a fallback for calls made outside computeq.
+  OneStepIntegrator* osi1p = nullptr;
+  OneStepIntegrator* osi2p = nullptr;
+  const InteractionBlockIndexEntry* entryp = nullptr;
+  {
+    auto it = std::lower_bound(_blockIndex.begin(), _blockIndex.end(), pos,
+                               [](const InteractionBlockIndexEntry& e, unsigned int p)
+                               { return e.pos < p; });
+    if(it != _blockIndex.end() && it->pos == pos && it->vertex == vertex_inter)
+    {
+      entryp = &(*it);
+      osi1p = it->osi1;
+      osi2p = it->osi2;
+    }
+  }
   DynamicalSystemsGraph& DSG0 = *simulation()->nonSmoothDynamicalSystem()->dynamicalSystems();
 
-  OneStepIntegrator& osi1 = *DSG0.properties(DSG0.descriptor(ds1)).osi;
-  OneStepIntegrator& osi2 = *DSG0.properties(DSG0.descriptor(ds2)).osi;
+  OneStepIntegrator& osi1 = osi1p ? *osi1p : *DSG0.properties(DSG0.descriptor(ds1)).osi;
+  OneStepIntegrator& osi2 = osi2p ? *osi2p : *DSG0.properties(DSG0.descriptor(ds2)).osi;
+
+  // Gather plan fast path: the rhs pointer was resolved with the same
+  // OSI dispatch as below when the block index was (re)built, so the
+  // copy into _q is a plain memcpy.
+  if(entryp && entryp->osnspRhs)
+  {
+    osi1.computeFreeOutput(vertex_inter, this);
+    memcpy(_q->getArray() + pos, entryp->osnspRhs,
+           entryp->size * sizeof(double));
+    DEBUG_EXPR(_q->display());
+    DEBUG_END("LinearOSNS::computeqBlock(SP::Interaction inter, unsigned int pos)\n");
+    return;
+  }
 
   OSI::TYPES osi1Type = osi1.getType();
   OSI::TYPES osi2Type = osi2.getType();
@@ -869,16 +996,16 @@ void LinearOSNS::computeq(double time)
   // === Get index set from Simulation ===
   SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
   // === Loop through "active" Interactions (ie present in
-  // indexSets[level]) ===
+  // indexSets[level]), through the flat block index ===
 
-  unsigned int pos = 0;
-  InteractionsGraph::VIterator ui, uiend;
-  for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
+  const std::vector<InteractionBlockIndexEntry>& blockIndex =
+    interactionBlockIndex(*indexSet);
+  for(const InteractionBlockIndexEntry& entry : blockIndex)
   {
     // Compute q, this depends on the type of non smooth problem, on
     // the relation type and on the non smooth law
-    pos = indexSet->properties(*ui).absolute_position;
-    computeqBlock(*ui, pos); // free output is saved in y
+    InteractionsGraph::VDescriptor vertex = entry.vertex;
+    computeqBlock(vertex, entry.pos); // free output is saved in y
   }
   DEBUG_END("void LinearOSNS::computeq(double time)\n");
 }
@@ -1026,8 +1153,13 @@ bool LinearOSNS::preCompute(double time)
         unsigned int pos = indexSet.properties(*ui).absolute_position;
         // VA 30/08/2021  : Warning. the values of y_k and lambda_k that are stored in Memory
         // may be undefined at the first time step.
-        const SiconosVector& yOutput_k = inter.y_k(inputOutputLevel());
-        const SiconosVector& lambda_k = inter.lambda_k(inputOutputLevel());
+        // Inside a Newton loop the memorized values are one whole time
+        // step behind; when asked to, start from the iterate the
+        // previous solve of the loop wrote back instead.
+        const SiconosVector& yOutput_k = _warmStartFromCurrentState ?
+                                         *inter.y(inputOutputLevel()) : inter.y_k(inputOutputLevel());
+        const SiconosVector& lambda_k = _warmStartFromCurrentState ?
+                                        *inter.lambda(inputOutputLevel()) : inter.lambda_k(inputOutputLevel());
 
         if(_sizeOutput >= yOutput_k.size() + pos)
         {
@@ -1075,36 +1207,62 @@ void LinearOSNS::postCompute()
   // === Get index set from Topology ===
   InteractionsGraph& indexSet = *simulation()->indexSet(indexSetLevel());
 
-  // y and lambda vectors
-  SP::SiconosVector lambda;
-  SP::SiconosVector y;
-
   // === Loop through "active" Interactions (ie present in
   // indexSets[1]) ===
 
-  unsigned int pos = 0;
+  // The flat block index already holds each interaction and its slice
+  // of _z; each one owns a distinct slice, so large index sets can be
+  // scattered in parallel on the shared task pool.
+  const std::vector<InteractionBlockIndexEntry>& blockIndex =
+    interactionBlockIndex(indexSet);
 
-  InteractionsGraph::VIterator ui, uiend;
-  for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+  const double* z = _z->getArray();
+  auto scatter = [z, &blockIndex](size_t begin, size_t end)
   {
-    Interaction& inter = *indexSet.bundle(*ui);
-    // Get the  position of inter-interactionBlock in the vector w
-    // or z
-    pos = indexSet.properties(*ui).absolute_position;
-
-    // Get Y and Lambda for the current Interaction
-    y = inter.y(inputOutputLevel());
-    lambda = inter.lambda(inputOutputLevel());
-    // Copy _w/_z values, starting from index pos into y/lambda.
-
-    //setBlock(*_w, y, y->size(), pos, 0);// Warning: yEquivalent is
-    // saved in y !!
-    setBlock(*_z, lambda, lambda->size(), pos, 0);
-    DEBUG_EXPR(lambda->display(););
-  }
+    for(size_t i = begin; i < end; ++i)
+    {
+      const InteractionBlockIndexEntry& entry = blockIndex[i];
+
+      // Copy the slice of _z starting at entry.pos into lambda; the
+      // destination pointer is part of the precomputed plan, so no
+      // per-interaction bounds logic remains here.
+      memcpy(entry.lambda, z + entry.pos, entry.size * sizeof(double));
+    }
+  };
+  // below this, task submission costs more than the copies themselves
+  static const size_t parallelScatterThreshold = 256;
+  if(blockIndex.size() >= parallelScatterThreshold)
+    SiconosTaskPool::parallelFor(blockIndex.size(), scatter);
+  else
+    scatter(0, blockIndex.size());
   DEBUG_END("void LinearOSNS::postCompute()\n");
 }
 
+bool LinearOSNS::exportAssembledProblem(AssembledProblemView& view)
+{
+  if(!_M || !_q || !_z || !_w || _sizeOutput == 0)
+    return false;
+  view.M = _M->numericsMatrix().get();
+  if(!view.M)
+    return false;
+  view.q = _q->getArray();
+  view.z = _z->getArray();
+  view.w = _w->getArray();
+  view.size = _sizeOutput;
+  view.layoutRevision =
+    simulation()->indexSet(_indexSetLevel)->stableLayout.revision;
+  return true;
+}
+
+void LinearOSNS::importSolution(const double* z, const double* w)
+{
+  assert(z);
+  memcpy(_z->getArray(), z, _sizeOutput * sizeof(double));
+  if(w)
+    memcpy(_w->getArray(), w, _sizeOutput * sizeof(double));
+  postCompute();
+}
+
 void LinearOSNS::display() const
 {
   std::cout << "==========================" <<std::endl;
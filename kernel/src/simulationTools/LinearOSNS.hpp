@@ -89,6 +89,53 @@ protected:
       size */
   bool _keepLambdaAndYState = true;
 
+  /** when true, _w and _z are warm-started from the current y and lambda
+      of the interactions (the values the previous solve of the same
+      Newton loop left there) instead of the values memorized at the end
+      of the previous time step; driven per iteration by
+      TimeStepping::setWarmStartNewtonIterations() */
+  bool _warmStartFromCurrentState = false;
+
+  /** one entry of the flat interaction-block index: everything the
+      assembly and scatter loops need for one vertex of the index set,
+      precomputed so the hot loops touch neither the graph maps nor the
+      DS -> descriptor lookup */
+  struct InteractionBlockIndexEntry
+  {
+    InteractionsGraph::VDescriptor vertex;
+    Interaction* inter;
+    unsigned int pos;              /**< row offset in the assembled problem */
+    unsigned int size;             /**< non smooth law size */
+    OneStepIntegrator* osi1;       /**< integrator of the source DS */
+    OneStepIntegrator* osi2;       /**< integrator of the target DS */
+    double* lambda;                /**< raw storage of lambda(inputOutputLevel()),
+                                      destination of the postCompute scatter */
+    double* osnspRhs;              /**< raw storage of the OSI OSNSP_RHS work
+                                      vector, source of the computeq gather
+                                      (nullptr: generic setBlock path) */
+  };
+
+  /** flat index over the current index set, sorted by position;
+      rebuilt only when the topology changed */
+  std::vector<InteractionBlockIndexEntry> _blockIndex;
+
+  /** rebuild _blockIndex from scratch (the only place where the
+      DS -> descriptor map lookups are paid)
+
+      \param indexSet the current index set
+  */
+  void updateInteractionBlockIndex(InteractionsGraph& indexSet);
+
+  /** return _blockIndex, after a cheap consistency walk over the index
+      set (pointer and offset compares only); the index is rebuilt when
+      the walk detects a topology change
+
+      \param indexSet the current index set
+      \return the up-to-date flat block index
+  */
+  const std::vector<InteractionBlockIndexEntry>&
+  interactionBlockIndex(InteractionsGraph& indexSet);
+
   /** nslaw effects : visitors experimentation
    */
   struct _TimeSteppingNSLEffect;
@@ -292,7 +339,42 @@ public:
    *  found solutions.
    */
   void postCompute() override;
- 
+
+  /** Zero-copy view over the assembled problem, for external solver
+   *  backends (GPU, accelerators ...). All the pointers alias the
+   *  internal storage of the problem: no copy is made and nothing is
+   *  allocated. They stay valid until the layout of the index set
+   *  changes; compare layoutRevision between exports to detect this. */
+  struct AssembledProblemView
+  {
+    NumericsMatrix* M = nullptr;  /**< assembled matrix, storage kind as
+                                     selected by setMStorageType() */
+    double* q = nullptr;          /**< right-hand side, dense, size n */
+    double* z = nullptr;          /**< unknown (reaction), dense, size n */
+    double* w = nullptr;          /**< output, dense, size n */
+    unsigned int size = 0;        /**< problem dimension n */
+    std::size_t layoutRevision = 0; /**< stable-layout revision of the
+                                       index set the problem was
+                                       assembled from */
+  };
+
+  /** fill a zero-copy view over the problem assembled by the last
+   *  preCompute().
+   *
+   *  \param view the view to fill
+   *  \return false when no problem is currently assembled
+   */
+  bool exportAssembledProblem(AssembledProblemView& view);
+
+  /** import a solution computed by an external solver and scatter it
+   *  back to the interactions through the postCompute() plan.
+   *
+   *  \param z the reactions, dense, size n (copied into the unknown)
+   *  \param w the outputs, dense, size n; optional, the current content
+   *  of w is kept when null
+   */
+  void importSolution(const double* z, const double* w = nullptr);
+
   /** print the data to the screen
    */
   void display() const override;
@@ -305,6 +387,17 @@ public:
   */
   void setKeepLambdaAndYState(bool val) { _keepLambdaAndYState = val; }
 
+  /**
+      choose the source of the warm start when _keepLambdaAndYState is
+      true.
+
+      \param val true: init w and z with the current values of y and
+      lambda (the iterate the previous solve of the same Newton loop
+      wrote back), false (default): with the values saved in the
+      interactions memory at the end of the previous time step.
+  */
+  void setWarmStartFromCurrentState(bool val) { _warmStartFromCurrentState = val; }
+
   virtual bool checkCompatibleNSLaw(NonSmoothLaw &nslaw) = 0;
 
   ACCEPT_STD_VISITORS();
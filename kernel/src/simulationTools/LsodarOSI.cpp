@@ -288,7 +288,13 @@ void LsodarOSI::initializeWorkVectorsForDS(double t, SP::DynamicalSystem ds)
   // memory allocation for doublereal*, according to _intData values
   updateData();
 
-  _xtmp.reset(new SiconosVector(_xWork->size()));
+  // When the OSI integrates a single block, DLSODAR can work directly in
+  // the DS storage: _xtmp becomes a view on that block and the
+  // continuous-memory copies in integrate() are skipped.
+  if(_xWork->numberOfBlocks() == 1)
+    _xtmp = _xWork->vector(0);
+  else
+    _xtmp.reset(new SiconosVector(_xWork->size()));
 
   computeRhs(t);
 
@@ -505,7 +511,8 @@ void LsodarOSI::integrate(double& tinit, double& tend, double& tout, int& istate
 
   // === LSODAR CALL ===
   DEBUG_EXPR(_xWork->display(););
-  *_xtmp = *_xWork;
+  bool xDirect = (_xWork->numberOfBlocks() == 1) && (_xtmp == _xWork->vector(0));
+  if(!xDirect) *_xtmp = *_xWork;
   if(istate == 3)
   {
     istate = 1; // restart TEMPORARY
@@ -554,7 +561,7 @@ void LsodarOSI::integrate(double& tinit, double& tend, double& tout, int& istate
     THROW_EXCEPTION("LsodarOSI, integration failed");
   }
 
-  *_xWork = *_xtmp;
+  if(!xDirect) *_xWork = *_xtmp;
   istate = _intData[4];
   tout  = tinit_DR; // real ouput time
   tend  = tend_DR; // necessary for next start of DLSODAR
@@ -27,6 +27,8 @@
 #include "MLCP_Solvers.h"
 #include "SiconosCompat.h"
 
+#include <algorithm>
+
 using namespace RELATION;
 // #define DEBUG_NCOLOR
 // #define DEBUG_STDOUT
@@ -249,4 +251,31 @@ void  MLCP::updateInteractionBlocks()
     _n = 0;
   }
   LinearOSNS::updateInteractionBlocks();
+  if(!_hasBeenUpdated)
+  {
+    // blocksRows describes the row partition of M, so the options must be
+    // accumulated in position order.  Positions come from the persistent
+    // layout of the index set (InteractionsGraph::updateStablePositions)
+    // and are no longer a monotone function of the iteration order, so the
+    // per-vertex accumulation done above is rebuilt here, sorted by
+    // position.  updateStablePositions is idempotent for an unchanged set;
+    // calling it here makes the positions current before fillM runs.
+    SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+    indexSet->updateStablePositions();
+    std::vector<std::pair<unsigned int, SP::Interaction> > byPosition;
+    byPosition.reserve(indexSet->size());
+    InteractionsGraph::VIterator ui, uiend;
+    for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
+      byPosition.push_back(std::make_pair(indexSet->properties(*ui).absolute_position,
+                                          indexSet->bundle(*ui)));
+    std::sort(byPosition.begin(), byPosition.end(),
+              [](const std::pair<unsigned int, SP::Interaction>& a,
+                 const std::pair<unsigned int, SP::Interaction>& b)
+              { return a.first < b.first; });
+    _curBlock = 0;
+    _m = 0;
+    _n = 0;
+    for(const auto& entry : byPosition)
+      computeOptions(entry.second, entry.second);
+  }
 }
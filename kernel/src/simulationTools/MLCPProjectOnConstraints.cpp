@@ -136,152 +136,148 @@ void MLCPProjectOnConstraints::updateInteractionBlocks()
       _m = 0;
       _curBlock = 0;
     }
-    InteractionsGraph::VIterator vi, viend;
-    for(std::tie(vi, viend) = indexSet->vertices();
-        vi != viend; ++vi)
-    {
-
-
-
 
-      SP::Interaction inter = indexSet->bundle(*vi);
-      unsigned int nslawSize = std::static_pointer_cast<OSNSMatrixProjectOnConstraints>
-                               (_M)->computeSizeForProjection(inter);
-
-      DEBUG_PRINTF("Start to work on Interaction %i of vertex %p\n", inter->number(), *vi);
-      if(! indexSet->blockProj[*vi])
-      {
-        DEBUG_PRINTF("Allocation of blockProj of size %i x %i for interaction %i \n",nslawSize, nslawSize,inter->number());
-        indexSet->blockProj[*vi].reset(new SimpleMatrix(nslawSize, nslawSize));
-      }
+    // --- structure pass (serial) ---
+    // allocations and vertex coloring; replayed from the cache when the
+    // index set did not change since the last call, which is the common
+    // case over the projection iterations of a single step
+    if(!assemblyCacheMatches(*indexSet))
+    {
+      _assemblyVertices.clear();
+      _assemblyInteractions.clear();
+      _assemblyDegrees.clear();
 
-      if(!isLinear || !_hasBeenUpdated)
+      InteractionsGraph::VIterator vi, viend;
+      for(std::tie(vi, viend) = indexSet->vertices();
+          vi != viend; ++vi)
       {
-        computeDiagonalInteractionBlock(*vi);
-      }
+        SP::Interaction inter = indexSet->bundle(*vi);
+        unsigned int nslawSize = std::static_pointer_cast<OSNSMatrixProjectOnConstraints>
+                                 (_M)->computeSizeForProjection(inter);
 
-      /* on a undirected graph, out_edges gives all incident edges */
-      InteractionsGraph::OEIterator oei, oeiend;
-      /* interactionBlock must be zeroed at init */
-      std::map<SP::SiconosMatrix, bool> initialized;
-      for(std::tie(oei, oeiend) = indexSet->out_edges(*vi);
-          oei != oeiend; ++oei)
-      {
-        /* on adjoint graph there is at most 2 edges between source and target */
-        InteractionsGraph::EDescriptor ed1, ed2;
-        std::tie(ed1, ed2) = indexSet->edges(indexSet->source(*oei), indexSet->target(*oei));
-        if(indexSet->upper_blockProj[ed1])
+        DEBUG_PRINTF("Start to work on Interaction %i of vertex %p\n", inter->number(), *vi);
+        if(! indexSet->blockProj[*vi])
         {
-          initialized[indexSet->upper_blockProj[ed1]] = false;
+          DEBUG_PRINTF("Allocation of blockProj of size %i x %i for interaction %i \n",nslawSize, nslawSize,inter->number());
+          indexSet->blockProj[*vi].reset(new SimpleMatrix(nslawSize, nslawSize));
         }
-        // if(indexSet->upper_blockProj[ed2])
-        // {
-        //   initialized[indexSet->upper_blockProj[ed1]] = false;
-        // }
 
-        if(indexSet->lower_blockProj[ed1])
+        /* on a undirected graph, out_edges gives all incident edges */
+        size_t degree = 0;
+        InteractionsGraph::OEIterator oei, oeiend;
+        for(std::tie(oei, oeiend) = indexSet->out_edges(*vi);
+            oei != oeiend; ++oei)
         {
-          initialized[indexSet->lower_blockProj[ed2]] = false;
-        }
-        // if(indexSet->lower_blockProj[ed2])
-        // {
-        //   initialized[indexSet->lower_blockProj[ed2]] = false;
-        // }
-      }
-
+          ++degree;
 
-      for(std::tie(oei, oeiend) = indexSet->out_edges(*vi);
-          oei != oeiend; ++oei)
-      {
+          /* on adjoint graph there is at most 2 edges between source and target */
+          InteractionsGraph::EDescriptor ed1, ed2;
+          std::tie(ed1, ed2) = indexSet->edges(indexSet->source(*oei), indexSet->target(*oei));
 
-        /* on adjoint graph there is at most 2 edges between source and target */
-        InteractionsGraph::EDescriptor ed1, ed2;
-        std::tie(ed1, ed2) = indexSet->edges(indexSet->source(*oei), indexSet->target(*oei));
+          assert(*oei == ed1 || *oei == ed2);
 
-        assert(*oei == ed1 || *oei == ed2);
+          /* the first edge as the lower index */
+          assert(indexSet->index(ed1) <= indexSet->index(ed2));
 
-        /* the first edge as the lower index */
-        assert(indexSet->index(ed1) <= indexSet->index(ed2));
+          SP::Interaction inter1 = indexSet->bundle(indexSet->source(*oei));
+          SP::Interaction inter2 = indexSet->bundle(indexSet->target(*oei));
 
-        SP::Interaction inter1 = indexSet->bundle(indexSet->source(*oei));
-        SP::Interaction inter2 = indexSet->bundle(indexSet->target(*oei));
-
-        // Memory allocation if needed
-        unsigned int nslawSize1 = std::static_pointer_cast<OSNSMatrixProjectOnConstraints>
-                                  (_M)->computeSizeForProjection(inter1);
-        unsigned int nslawSize2 = std::static_pointer_cast<OSNSMatrixProjectOnConstraints>
-                                  (_M)->computeSizeForProjection(inter2);
-        unsigned int isrc = indexSet->index(indexSet->source(*oei));
-        unsigned int itar = indexSet->index(indexSet->target(*oei));
-
-        SP::SiconosMatrix currentInteractionBlock;
+          // Memory allocation if needed
+          unsigned int nslawSize1 = std::static_pointer_cast<OSNSMatrixProjectOnConstraints>
+                                    (_M)->computeSizeForProjection(inter1);
+          unsigned int nslawSize2 = std::static_pointer_cast<OSNSMatrixProjectOnConstraints>
+                                    (_M)->computeSizeForProjection(inter2);
+          unsigned int isrc = indexSet->index(indexSet->source(*oei));
+          unsigned int itar = indexSet->index(indexSet->target(*oei));
 
-        if(itar > isrc)  // upper block
-        {
-          if(! indexSet->upper_blockProj[ed1])
+          if(itar > isrc)  // upper block
           {
-            indexSet->upper_blockProj[ed1].reset(new SimpleMatrix(nslawSize1, nslawSize2));
-            initialized[indexSet->upper_blockProj[ed1]] = false;
+            if(! indexSet->upper_blockProj[ed1])
+            {
+              indexSet->upper_blockProj[ed1].reset(new SimpleMatrix(nslawSize1, nslawSize2));
 
 #ifdef MLCPPROJ_DEBUG
-            std::cout <<  "Allocation of upper_blockProj " <<  indexSet->upper_blockProj[ed1].get() << " of edge " << ed1 << " of size " << nslawSize1 << " x " << nslawSize2 << " for interaction " << inter1->number() << " and interaction " <<  inter2->number() <<  std::endl;
+              std::cout <<  "Allocation of upper_blockProj " <<  indexSet->upper_blockProj[ed1].get() << " of edge " << ed1 << " of size " << nslawSize1 << " x " << nslawSize2 << " for interaction " << inter1->number() << " and interaction " <<  inter2->number() <<  std::endl;
 #endif
 
-            if(ed2 != ed1)
-              indexSet->upper_blockProj[ed2] = indexSet->upper_blockProj[ed1];
-          }
-#ifdef MLCPPROJ_DEBUG
-          else
-            std::cout <<  "No Allocation of upper_blockProj of size " << nslawSize1 << " x " << nslawSize2 <<  std::endl;
-#endif
-          currentInteractionBlock = indexSet->upper_blockProj[ed1];
+              if(ed2 != ed1)
+                indexSet->upper_blockProj[ed2] = indexSet->upper_blockProj[ed1];
+            }
 #ifdef MLCPPROJ_DEBUG
-          std::cout << "currentInteractionBlock->size(0)" << currentInteractionBlock->size(0) << std::endl;
-          std::cout << "currentInteractionBlock->size(1)" << currentInteractionBlock->size(1) << std::endl;
-
-          std::cout << "inter1->display() " << inter1->number() << std::endl;
-          //inter1->display();
-
-          std::cout << "inter2->display() " << inter2->number() << std::endl;
-          //inter2->display();
+            else
+              std::cout <<  "No Allocation of upper_blockProj of size " << nslawSize1 << " x " << nslawSize2 <<  std::endl;
 #endif
-        }
-        else  // lower block
-        {
-          if(! indexSet->lower_blockProj[ed1])
+          }
+          else  // lower block
           {
+            if(! indexSet->lower_blockProj[ed1])
+            {
 
 #ifdef MLCPPROJ_DEBUG
-            std::cout <<  "Allocation of lower_blockProj of size " << nslawSize1 << " x " << nslawSize2 << " for interaction " << inter1->number() << " and interaction " <<  inter2->number() <<  std::endl;
+              std::cout <<  "Allocation of lower_blockProj of size " << nslawSize1 << " x " << nslawSize2 << " for interaction " << inter1->number() << " and interaction " <<  inter2->number() <<  std::endl;
 #endif
-            indexSet->lower_blockProj[ed1].reset(new SimpleMatrix(nslawSize1, nslawSize2));
-            initialized[indexSet->lower_blockProj[ed1]] = false;
-            if(ed2 != ed1)
-              indexSet->lower_blockProj[ed2] = indexSet->lower_blockProj[ed1];
-          }
+              indexSet->lower_blockProj[ed1].reset(new SimpleMatrix(nslawSize1, nslawSize2));
+              if(ed2 != ed1)
+                indexSet->lower_blockProj[ed2] = indexSet->lower_blockProj[ed1];
+            }
 #ifdef MLCPPROJ_DEBUG
-          else
-            std::cout <<  "No Allocation of lower_blockProj of size " << nslawSize1 << " x " << nslawSize2 <<  std::endl;
+            else
+              std::cout <<  "No Allocation of lower_blockProj of size " << nslawSize1 << " x " << nslawSize2 <<  std::endl;
 #endif
-          currentInteractionBlock = indexSet->lower_blockProj[ed1];
-
-#ifdef MLCPPROJ_DEBUG
-          std::cout << "currentInteractionBlock->size(0)" << currentInteractionBlock->size(0) << std::endl;
-          std::cout << "currentInteractionBlock->size(1)" << currentInteractionBlock->size(1) << std::endl;
-
+          }
+        }
 
-          std::cout << "inter1->display() " << inter1->number() << std::endl;
-          //inter1->display();
+        _assemblyVertices.push_back(*vi);
+        _assemblyInteractions.push_back(inter.get());
+        _assemblyDegrees.push_back(degree);
+      }
+      _assemblyBatches = independentVertexBatches(*indexSet);
+      _assemblyCacheValid = true;
+    }
 
-          std::cout << "inter2->display() " << inter2->number() << std::endl;
-          //inter2->display();
-#endif
+    // the options (number of equalities/inequalities, numerics blocks)
+    // accumulate into shared counters, so they are computed serially,
+    // out of the parallel numeric pass below
+    if(!_hasBeenUpdated)
+    {
+      for(const InteractionsGraph::VDescriptor& vd : _assemblyVertices)
+      {
+        SP::Interaction inter = indexSet->bundle(vd);
+        computeOptions(inter, inter);
+      }
+    }
 
-        }
+    // --- numeric pass ---
+    // each vertex zeroes and fills its own diagonal block and the blocks
+    // of its incident edges; the conflict-free batches guarantee that two
+    // vertices sharing an edge (hence a DS, hence possibly an OSI matrix
+    // factorization) never run concurrently
+    parallelForVertexBatches(_assemblyBatches,
+                             [this, &indexSet, isLinear](const InteractionsGraph::VDescriptor& vd)
+    {
+      if(!isLinear || !_hasBeenUpdated)
+      {
+        computeDiagonalInteractionBlock(vd);
+      }
 
+      /* interactionBlock must be zeroed at init */
+      std::map<SP::SiconosMatrix, bool> initialized;
+      InteractionsGraph::OEIterator oei, oeiend;
+      for(std::tie(oei, oeiend) = indexSet->out_edges(vd);
+          oei != oeiend; ++oei)
+      {
+        /* on adjoint graph there is at most 2 edges between source and target */
+        InteractionsGraph::EDescriptor ed1, ed2;
+        std::tie(ed1, ed2) = indexSet->edges(indexSet->source(*oei), indexSet->target(*oei));
 
+        unsigned int isrc = indexSet->index(indexSet->source(*oei));
+        unsigned int itar = indexSet->index(indexSet->target(*oei));
 
-        //assert(indexSet->index(ed1));
+        SP::SiconosMatrix currentInteractionBlock;
+        if(itar > isrc)  // upper block
+          currentInteractionBlock = indexSet->upper_blockProj[ed1];
+        else  // lower block
+          currentInteractionBlock = indexSet->lower_blockProj[ed1];
 
         if(!initialized[currentInteractionBlock])
         {
@@ -289,19 +285,39 @@ void MLCPProjectOnConstraints::updateInteractionBlocks()
           currentInteractionBlock->zero();
         }
 
-
         if(!isLinear || !_hasBeenUpdated)
         {
           if(isrc != itar)
             computeInteractionBlock(*oei);
         }
-
       }
-    }
+    });
   }
   DEBUG_EXPR(displayBlocks(indexSet););
   DEBUG_END(" MLCPProjectOnConstraints::updateInteractionBlocks()\n");
 }
+
+bool MLCPProjectOnConstraints::assemblyCacheMatches(InteractionsGraph& indexSet) const
+{
+  if(!_assemblyCacheValid) return false;
+  if(indexSet.size() != _assemblyVertices.size()) return false;
+
+  size_t k = 0;
+  InteractionsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = indexSet.vertices(); vi != viend; ++vi, ++k)
+  {
+    if(_assemblyVertices[k] != *vi
+        || _assemblyInteractions[k] != indexSet.bundle(*vi).get())
+      return false;
+    size_t degree = 0;
+    InteractionsGraph::OEIterator oei, oeiend;
+    for(std::tie(oei, oeiend) = indexSet.out_edges(*vi); oei != oeiend; ++oei)
+      ++degree;
+    if(degree != _assemblyDegrees[k])
+      return false;
+  }
+  return true;
+}
 void MLCPProjectOnConstraints::displayBlocks(SP::InteractionsGraph indexSet)
 {
 
@@ -429,6 +445,8 @@ void MLCPProjectOnConstraints::updateInteractionBlocksOLD()
         //        std::cout << "indexSet->blockProj[*vi]: after"<< indexSet->blockProj[*vi] << std::endl;
         // #endif
 
+        if(!_hasBeenUpdated)
+          computeOptions(inter, inter);
         computeDiagonalInteractionBlock(*vi);
       }
 
@@ -595,8 +613,8 @@ void MLCPProjectOnConstraints::computeDiagonalInteractionBlock(const Interaction
   assert(currentInteractionBlock->size(0) == sizeY);
   assert(currentInteractionBlock->size(1) == sizeY);
 
-  if(!_hasBeenUpdated)
-    computeOptions(inter, inter);
+  // the options are computed serially by updateInteractionBlocks before
+  // the (possibly parallel) calls to this method
   // Computes matrix _interactionBlocks[inter1][inter2] (and allocates memory if
   // necessary) if inter1 and inter2 have commond DynamicalSystem.  How
   // _interactionBlocks are computed depends explicitely on the type of
@@ -46,6 +46,33 @@ protected:
 
   bool _useMassNormalization;
 
+  /** assembly structure cache: the projection iterations within one step
+      share their sparsity, so the allocation walk and the vertex coloring
+      of updateInteractionBlocks are done once and replayed until the cheap
+      consistency walk detects a change in the index set */
+  std::vector<InteractionsGraph::VDescriptor> _assemblyVertices;
+
+  /** bundled interactions of _assemblyVertices, for the consistency walk */
+  std::vector<Interaction*> _assemblyInteractions;
+
+  /** out-degree of each vertex of _assemblyVertices, for the consistency
+      walk (the batches are adjacency-dependent) */
+  std::vector<size_t> _assemblyDegrees;
+
+  /** conflict-free vertex batches for the parallel numeric pass */
+  std::vector<std::vector<InteractionsGraph::VDescriptor> > _assemblyBatches;
+
+  /** false until the first structure pass */
+  bool _assemblyCacheValid = false;
+
+  /** walk the index set and check it still matches the cached assembly
+      structure (vertex descriptors, interactions and degrees)
+
+      \param indexSet the current index set
+      \return true if the cache can be replayed
+  */
+  bool assemblyCacheMatches(InteractionsGraph& indexSet) const;
+
 public:
   /** compute the number of inequality and equality for a given tuple of
    *  Interactions update the global number of equality(_n) and inequality (_m)
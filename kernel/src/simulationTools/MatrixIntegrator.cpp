@@ -34,6 +34,38 @@
 
 #include "siconos_debug.h"
 
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+std::string MatrixIntegrator::_cacheDir;
+
+void MatrixIntegrator::setCacheDirectory(const std::string& dir)
+{
+  _cacheDir = dir;
+}
+
+/* FNV-1a over the bytes of the problem data */
+static void hashBytes(uint64_t& h, const void* data, size_t len)
+{
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  for(size_t i = 0; i < len; ++i)
+  {
+    h ^= p[i];
+    h *= 1099511628211ULL;
+  }
+}
+
+static void hashDouble(uint64_t& h, double v)
+{
+  hashBytes(h, &v, sizeof(v));
+}
+
+MatrixIntegrator::~MatrixIntegrator()
+{
+  if(_worker.joinable()) _worker.join();
+}
+
 MatrixIntegrator::MatrixIntegrator(const DynamicalSystem& ds, const NonSmoothDynamicalSystem& nsds, const  TimeDiscretisation & td, SP::SiconosMatrix E): _E(E)
 {
   commonInit(ds, nsds, td);
@@ -99,9 +131,112 @@ void MatrixIntegrator::commonInit(const DynamicalSystem& ds, const NonSmoothDyna
 
 }
 
+std::string MatrixIntegrator::_cacheKey() const
+{
+  if(_cacheDir.empty() || !_isConst || _plugin) return std::string();
+
+  SP::SiconosMatrix A = std::static_pointer_cast<FirstOrderLinearDS>(_DS)->A();
+  if(!A) return std::string();
+
+  uint64_t h = 14695981039346656037ULL;
+  unsigned int n = _mat->size(0);
+  unsigned int p = _mat->size(1);
+  hashDouble(h, (double)n);
+  hashDouble(h, (double)p);
+  hashDouble(h, _TD->currentTimeStep(0));
+  for(unsigned int i = 0; i < A->size(0); ++i)
+    for(unsigned int j = 0; j < A->size(1); ++j)
+      hashDouble(h, (*A)(i, j));
+  // distinguish exp(Ah) from the integral against E
+  hashDouble(h, _E ? 1. : 0.);
+  if(_E)
+    for(unsigned int i = 0; i < _E->size(0); ++i)
+      for(unsigned int j = 0; j < _E->size(1); ++j)
+        hashDouble(h, (*_E)(i, j));
+
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)h);
+  return std::string(buf);
+}
+
 void MatrixIntegrator::integrate()
 {
-  DEBUG_BEGIN("MatrixIntegrator::integrate()\n");
+  const std::string key = _cacheKey();
+
+  if(!key.empty())
+  {
+    std::ifstream in(_cacheDir + "/mi_" + key + ".bin", std::ios::binary);
+    if(in)
+    {
+      uint64_t n, p;
+      in.read(reinterpret_cast<char*>(&n), sizeof(n));
+      in.read(reinterpret_cast<char*>(&p), sizeof(p));
+      if(in && n == _mat->size(0) && p == _mat->size(1))
+      {
+        std::vector<double> values(n * p);
+        in.read(reinterpret_cast<char*>(values.data()),
+                values.size() * sizeof(double));
+        if(in)
+        {
+          for(uint64_t i = 0; i < n; ++i)
+            for(uint64_t j = 0; j < p; ++j)
+              (*_mat)(i, j) = values[i * p + j];
+          return;
+        }
+      }
+    }
+  }
+
+  _integrate(*_mat);
+
+  if(!key.empty())
+  {
+    std::ofstream out(_cacheDir + "/mi_" + key + ".bin", std::ios::binary);
+    if(out)
+    {
+      uint64_t n = _mat->size(0), p = _mat->size(1);
+      out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+      out.write(reinterpret_cast<const char*>(&p), sizeof(p));
+      std::vector<double> values(n * p);
+      for(uint64_t i = 0; i < n; ++i)
+        for(uint64_t j = 0; j < p; ++j)
+          values[i * p + j] = (*_mat)(i, j);
+      out.write(reinterpret_cast<const char*>(values.data()),
+                values.size() * sizeof(double));
+    }
+  }
+}
+
+void MatrixIntegrator::updatePlantMatrix(const SiconosMatrix& A)
+{
+  waitForRecompute();
+  std::static_pointer_cast<FirstOrderLinearDS>(_DS)->setA(A);
+}
+
+void MatrixIntegrator::recomputeInBackground()
+{
+  waitForRecompute();
+  SP::SiconosMatrix staging(new SimpleMatrix(_mat->size(0), _mat->size(1)));
+  _pendingMat = staging;
+  _worker = std::thread([this, staging]()
+  {
+    _integrate(*staging);
+  });
+}
+
+void MatrixIntegrator::waitForRecompute()
+{
+  if(_worker.joinable()) _worker.join();
+  if(_pendingMat)
+  {
+    _mat = _pendingMat;
+    _pendingMat.reset();
+  }
+}
+
+void MatrixIntegrator::_integrate(SiconosMatrix& result)
+{
+  DEBUG_BEGIN("MatrixIntegrator::_integrate(SiconosMatrix& result)\n");
   SiconosVector& x0 = *_DS->x0();
   SiconosVector& x = *_DS->x();
 
@@ -111,7 +246,7 @@ void MatrixIntegrator::integrate()
     Ecol.reset(new SiconosVector(_DS->n(), 0));
     static_cast<FirstOrderLinearDS&>(*_DS).setbPtr(Ecol);
   }
-  unsigned int p = _mat->size(1);
+  unsigned int p = result.size(1);
   for(unsigned int i = 0; i < p; i++)
   {
     x0.zero();
@@ -127,13 +262,13 @@ void MatrixIntegrator::integrate()
     _DS->resetToInitialState();
     _sim->setIstate(1);
     _sim->advanceToEvent();
-    _mat->setCol(i, x);
+    result.setCol(i, x);
   }
 
   _sim->processEvents();
   //_DS->resetToInitialState();
 
-  DEBUG_EXPR(_mat->display(););
+  DEBUG_EXPR(result.display(););
   DEBUG_EXPR(_DS->display(););
-  DEBUG_END("MatrixIntegrator::integrate()\n");
+  DEBUG_END("MatrixIntegrator::_integrate(SiconosMatrix& result)\n");
 }
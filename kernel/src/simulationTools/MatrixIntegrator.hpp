@@ -30,6 +30,9 @@
 
 #include "SiconosFwd.hpp"
 
+#include <string>
+#include <thread>
+
 class MatrixIntegrator
 {
 private:
@@ -68,9 +71,29 @@ protected:
   /** OneStepIntegrator of type LsodarOSI */
   SP::LsodarOSI _OSI;
 
+  /** directory of the on-disk result cache (empty: cache disabled) */
+  static std::string _cacheDir;
+
+  /** background recomputation thread, see recomputeInBackground() */
+  std::thread _worker;
+
+  /** result of a background recomputation, published by waitForRecompute() */
+  SP::SiconosMatrix _pendingMat;
+
   /** */
   void commonInit(const DynamicalSystem& ds, const NonSmoothDynamicalSystem& nsds, const TimeDiscretisation & td);
 
+  /** run the column integrations, filling result
+   *  \param result matrix of the size of _mat
+   */
+  void _integrate(SiconosMatrix& result);
+
+  /** cache key of the current problem data, empty when the result cannot
+   *  be cached (cache disabled, non-constant data or plugged entry)
+   *  \return the key
+   */
+  std::string _cacheKey() const;
+
   /** Default constructor */
   MatrixIntegrator() {};
 
@@ -100,9 +123,42 @@ public:
    */
   MatrixIntegrator(const DynamicalSystem& ds,const NonSmoothDynamicalSystem& nsds, const TimeDiscretisation &td);
 
-  /** Computes the next value of _mat */
+  /** join a pending background recomputation */
+  ~MatrixIntegrator();
+
+  /** Computes the next value of _mat.
+   *
+   *  When a cache directory is set (see setCacheDirectory()) and the
+   *  problem data are constant, the result is read from disk when a
+   *  matching entry exists and stored there otherwise. */
   void integrate();
 
+  /** enable the on-disk result cache: integrations with constant data
+   *  are stored in (and reloaded from) files keyed by a hash of the
+   *  plant matrices and the time step, so repeated runs with the same
+   *  plant skip the integration entirely. The directory must exist; an
+   *  empty string disables the cache (the default).
+   *  \param dir the cache directory
+   */
+  static void setCacheDirectory(const std::string& dir);
+
+  /** replace the plant matrix A of the integrated system, for
+   *  gain-scheduled systems that switch plants at runtime; call
+   *  recomputeInBackground() or integrate() afterwards
+   *  \param A the new plant matrix
+   */
+  void updatePlantMatrix(const SiconosMatrix& A);
+
+  /** recompute _mat on a background thread. The current value of mat()
+   *  stays valid until waitForRecompute() publishes the new one.
+   *  \warning the underlying integrator (LSODAR) is not reentrant: at
+   *  most one integration, foreground or background, may run at a time
+   *  in the whole process. */
+  void recomputeInBackground();
+
+  /** wait for a pending background recomputation and publish its result */
+  void waitForRecompute();
+
   /** Get the value of _mat, solution of the ODE
    * \return a reference to _mat */
   inline const SiconosMatrix& mat() const { return *_mat; }
@@ -27,6 +27,8 @@
 #include "LagrangianR.hpp"
 #include "NewtonImpactNSL.hpp"
 
+#include <cstring> // for std::memcpy (ensemble update)
+
 using namespace RELATION;
 
 
@@ -235,12 +237,118 @@ double MoreauJeanBilbaoOSI::computeResidu()
   return 0.;
 }
 
+const std::vector<MoreauJeanBilbaoOSI::EnsembleEntry>& MoreauJeanBilbaoOSI::ensembleTable()
+{
+  double time_step = _simulation->timeStep();
+  // cheap consistency walk: the table is only rebuilt when a system was
+  // added or removed or when the time step changed
+  bool valid = (_ensembleTimeStep == time_step);
+  std::size_t entry = 0;
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); valid && dsi != dsend; ++dsi)
+  {
+    if(!checkOSI(dsi)) continue;
+    valid = (entry < _ensembleTable.size()
+             && _ensembleTable[entry].ds == _dynamicalSystemsGraph->bundle(*dsi).get());
+    ++entry;
+  }
+  if(valid && entry == _ensembleTable.size())
+    return _ensembleTable;
+
+  _ensembleTable.clear();
+  _ensembleWinv.clear();
+  _ensembleCoeffV.clear();
+  _ensembleCoeffQ.clear();
+  _ensembleTimeStep = time_step;
+  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  {
+    if(!checkOSI(dsi)) continue;
+    LagrangianLinearDiagonalDS& lldds = static_cast<LagrangianLinearDiagonalDS&>(*_dynamicalSystemsGraph->bundle(*dsi));
+    VectorOfVectors& work_ds = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
+    const SimpleMatrix& inv_iteration_matrix = *_dynamicalSystemsGraph->properties(*dsi).W;
+    const SiconosVector& stiffness = *lldds.stiffness();
+    const SiconosVector& two_dt_sigma_star = *work_ds[MoreauJeanBilbaoOSI::TWO_DT_SIGMA_STAR];
+    unsigned int ndof = lldds.dimension();
+    EnsembleEntry e;
+    e.ds = &lldds;
+    e.offset = (unsigned int)_ensembleWinv.size();
+    e.ndof = ndof;
+    e.vfree = work_ds[MoreauJeanBilbaoOSI::VFREE]->getArray();
+    _ensembleTable.push_back(e);
+    // fold the matrix diagonal and the damping/stiffness terms into the
+    // two coefficients of the free-velocity loop
+    for(unsigned int k = 0; k < ndof; ++k)
+    {
+      double winv = inv_iteration_matrix(k, k);
+      _ensembleWinv.push_back(winv);
+      _ensembleCoeffV.push_back(1. - winv * two_dt_sigma_star(k));
+      _ensembleCoeffQ.push_back(-winv * time_step * stiffness(k));
+    }
+  }
+  return _ensembleTable;
+}
+
+void MoreauJeanBilbaoOSI::ensembleComputeFreeState()
+{
+  const std::vector<EnsembleEntry>& table = ensembleTable();
+  const double* coeff_v = _ensembleCoeffV.data();
+  const double* coeff_q = _ensembleCoeffQ.data();
+  for(const EnsembleEntry& e : table)
+  {
+    const double* v_i = e.ds->velocityMemory().getSiconosVector(0).getArray();
+    const double* q_i = e.ds->qMemory().getSiconosVector(0).getArray();
+    const double* cv = coeff_v + e.offset;
+    const double* cq = coeff_q + e.offset;
+    double* vfree = e.vfree;
+    for(unsigned int k = 0; k < e.ndof; ++k)
+      vfree[k] = cv[k] * v_i[k] + cq[k] * q_i[k];
+  }
+}
+
+void MoreauJeanBilbaoOSI::ensembleUpdateState()
+{
+  double time_step = _simulation->timeStep();
+  const std::vector<EnsembleEntry>& table = ensembleTable();
+  const double* winv_all = _ensembleWinv.data();
+  for(const EnsembleEntry& e : table)
+  {
+    LagrangianLinearDiagonalDS& lldds = *e.ds;
+    double* v = lldds.velocity()->getArray();
+    double* q = lldds.q()->getArray();
+    const double* qold = lldds.qMemory().getSiconosVector(0).getArray();
+    const double* vfree = e.vfree;
+    const double* winv = winv_all + e.offset;
+    if(lldds.p(_levelMaxForInput) && lldds.p(_levelMaxForInput)->size() > 0)
+    {
+      const double* p = lldds.p(_levelMaxForInput)->getArray();
+      for(unsigned int k = 0; k < e.ndof; ++k)
+        v[k] = vfree[k] + winv[k] * p[k];
+      // clamped dofs take no impulse
+      if(lldds.boundaryConditions())
+        for(unsigned int index : *lldds.boundaryConditions()->velocityIndices())
+          v[index] = vfree[index];
+    }
+    else
+      std::memcpy(v, vfree, e.ndof * sizeof(double));
+    // position update fused in: q(i+1) = q(i) + dt v(i+1)
+    for(unsigned int k = 0; k < e.ndof; ++k)
+      q[k] = qold[k] + time_step * v[k];
+  }
+}
+
 void MoreauJeanBilbaoOSI::computeFreeState()
 {
   DEBUG_BEGIN("MoreauJeanBilbaoOSI::computeFreeState()")
   // This function computes "free" states of the DS belonging to this Integrator.
   // "Free" means without taking non-smooth effects into account.
 
+  if(_ensembleUpdate)
+  {
+    ensembleComputeFreeState();
+    DEBUG_END("MoreauJeanBilbaoOSI::computeFreeState()")
+    return;
+  }
+
   double time_step = _simulation->timeStep();
   DynamicalSystemsGraph::VIterator dsi, dsend;
   for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
@@ -376,6 +484,13 @@ void MoreauJeanBilbaoOSI::updateState(const unsigned int)
   if(useRCC)
     _simulation->setRelativeConvergenceCriterionHeld(true);
 
+  if(_ensembleUpdate)
+  {
+    ensembleUpdateState();
+    DEBUG_END("MoreauJeanBilbaoOSI::updateState(const unsigned int)");
+    return;
+  }
+
   DynamicalSystemsGraph::VIterator dsi, dsend;
   for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
   {
@@ -24,6 +24,9 @@
 #include "OneStepIntegrator.hpp"
 
 #include <limits>
+#include <vector> // for the ensemble update tables
+
+class LagrangianLinearDiagonalDS;
 
 /**
    One-step integrator for event-capturing simulation combining Moreau-Jean and
@@ -47,6 +50,50 @@ protected:
 
   friend struct _NSLEffectOnFreeOutput;
 
+  /** one entry of the ensemble table: everything the fused update loops
+      need for one diagonal system, so the hot loops touch neither the
+      graph maps nor the matrix/vector wrappers */
+  struct EnsembleEntry
+  {
+    LagrangianLinearDiagonalDS* ds;
+    unsigned int offset; /**< slice start in the shared coefficient arrays */
+    unsigned int ndof;
+    double* vfree;       /**< raw storage of the VFREE work vector */
+  };
+
+  /** flat table over the diagonal systems integrated by this osi, one
+      slice of the shared arrays per system; rebuilt only when the set of
+      systems or the time step changed */
+  std::vector<EnsembleEntry> _ensembleTable;
+
+  /** shared contiguous coefficient arrays: diagonal of W^-1 and the two
+      fused free-velocity coefficients, so that
+      vfree = coeffV * v_i + coeffQ * q_i elementwise
+      (coeffV = 1 - W^-1 * 2 dt sigma^*, coeffQ = -W^-1 * dt * stiffness) */
+  std::vector<double> _ensembleWinv;
+  std::vector<double> _ensembleCoeffV;
+  std::vector<double> _ensembleCoeffQ;
+
+  /** time step the coefficient arrays were computed with */
+  double _ensembleTimeStep = 0.;
+
+  /** when true, computeFreeState() and updateState() run as fused
+      elementwise loops over the shared coefficient arrays instead of
+      going through the per-system matrix machinery (default false), see
+      setEnsembleUpdate() */
+  bool _ensembleUpdate = false;
+
+  /** return the ensemble table, after a cheap consistency walk over the
+      graph (pointer compares only); the table and the coefficient arrays
+      are rebuilt when the walk detects a change */
+  const std::vector<EnsembleEntry>& ensembleTable();
+
+  /** free-velocity computation of computeFreeState(), fused form */
+  void ensembleComputeFreeState();
+
+  /** velocity/position update of updateState(), fused form */
+  void ensembleUpdateState();
+
 public:
   enum MoreauJeanBilbaoOSI_ds_workVector_id {
     TWO_DT_SIGMA_STAR,
@@ -169,6 +216,21 @@ public:
 
   void prepareNewtonIteration(double time) override;
 
+  /** enable the ensemble update: the per-step free-velocity and state
+   *  updates of all the diagonal systems run as a few fused elementwise
+   *  loops over shared contiguous coefficient arrays, instead of one
+   *  pass of matrix/vector wrapper calls per system. Same results, but
+   *  memory-bandwidth bound on large ensembles of small (or not so
+   *  small) diagonal systems. The tables are rebuilt automatically when
+   *  systems are added or removed or when the time step changes.
+   *
+   *  \param enable true to run the fused loops
+   */
+  void setEnsembleUpdate(bool enable) { _ensembleUpdate = enable; };
+
+  /** \return true when the ensemble update is enabled */
+  bool ensembleUpdate() const { return _ensembleUpdate; };
+
   /** Apply the rule to one Interaction to know if it should be included in the
    *  IndexSet of level i
    *
@@ -39,6 +39,8 @@
 
 #include "BlockVector.hpp"
 
+#include <cstring> // for memcmp
+
 // #define DEBUG_NOCOLOR
 // #define DEBUG_STDOUT
 // #define DEBUG_MESSAGES
@@ -136,6 +138,10 @@ void MoreauJeanOSI::initializeWorkVectorsForDS(double t, SP::DynamicalSystem ds)
   SP::SecondOrderDS sods = std::static_pointer_cast<SecondOrderDS> (ds);
   initializeIterationMatrixW(t, sods);
 
+  // updateState() bumps the state version of the systems it writes, so
+  // output computations may rely on the version to detect unchanged states
+  ds->trackStateVersion();
+
   // Initialize work vectors
   VectorOfVectors& ds_work_vectors = *_initializeDSWorkVectors(ds);
   ds_work_vectors.resize(MoreauJeanOSI::WORK_LENGTH);
@@ -386,11 +392,119 @@ void MoreauJeanOSI::initializeIterationMatrixW(double time, SP::SecondOrderDS ds
     W.setIsPositiveDefinite(true);
   }
 
-  // Remark: W is not LU-factorized nor inversed here.
+  // For a time-invariant system, W is constant over the whole simulation
+  // (see computeW): factorize it once for all here, so that every
+  // subsequent Solve() call (computeFreeState, updateState, OSNS assembly)
+  // reuses the stored factors. The boundary conditions columns have been
+  // extracted above, before the factorization overwrites the entries.
+  // The global variant (MoreauJeanGOSI) is excluded: it assembles the raw
+  // entries of W into the global OSNS matrix (OSNSMatrix::fillW).
+  // Note that LagrangianLinearDiagonalDS needs no factorization: its W
+  // already holds the inverse of the diagonal.
+  if(dsType == Type::LagrangianLinearTIDS && _integratorType == OSI::MOREAUJEANOSI)
+    _dynamicalSystemsGraph->properties(dsv).W->Factorize();
+
+  // Remark: for the other types, W is not LU-factorized nor inversed here.
   // Function PLUForwardBackward will do that if required.
+
+  // remember which h the installed matrices belong to (see
+  // timeStepChanged)
+  _WCacheH = _simulation->timeStep();
   DEBUG_END("MoreauJeanOSI::initializeIterationMatrixW\n");
 }
 
+void MoreauJeanOSI::recomputeIterationMatricesW()
+{
+  DEBUG_BEGIN("MoreauJeanOSI::recomputeIterationMatricesW()\n");
+  // The iteration matrices (and the factorizations stored at
+  // initialization for the time-invariant systems) depend on the time
+  // step h: when h is changed, they must be built again from scratch.
+  double time = _simulation->nextTime();
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  {
+    if(!checkOSI(dsi)) continue;
+    SP::SecondOrderDS ds = std::static_pointer_cast<SecondOrderDS>(_dynamicalSystemsGraph->bundle(*dsi));
+    _dynamicalSystemsGraph->properties(*dsi).W.reset();
+    _dynamicalSystemsGraph->properties(*dsi).Winverse.reset();
+    _dynamicalSystemsGraph->properties(*dsi).WBoundaryConditions.reset();
+    initializeIterationMatrixW(time, ds);
+  }
+  DEBUG_END("MoreauJeanOSI::recomputeIterationMatricesW()\n");
+}
+
+void MoreauJeanOSI::timeStepChanged()
+{
+  DEBUG_BEGIN("MoreauJeanOSI::timeStepChanged()\n");
+  double h = _simulation->timeStep();
+  if(h == _WCacheH)
+  {
+    DEBUG_END("MoreauJeanOSI::timeStepChanged()\n");
+    return;
+  }
+
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+
+  // park the matrices built for the outgoing h; the factorizations
+  // stored inside (time-invariant systems) go with them
+  if(_WCacheH > 0.)
+  {
+    std::map<size_t, CachedW>& outgoing = _WCache[_WCacheH];
+    for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+    {
+      if(!checkOSI(dsi)) continue;
+      DynamicalSystemProperties& props = _dynamicalSystemsGraph->properties(*dsi);
+      CachedW& entry = outgoing[_dynamicalSystemsGraph->bundle(*dsi)->number()];
+      entry.W = props.W;
+      entry.WBoundaryConditions = props.WBoundaryConditions;
+    }
+  }
+
+  std::map<double, std::map<size_t, CachedW> >::iterator incoming = _WCache.find(h);
+  if(incoming == _WCache.end())
+  {
+    // h never used so far: build (and factorize) from scratch
+    recomputeIterationMatricesW();
+  }
+  else
+  {
+    for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+    {
+      if(!checkOSI(dsi)) continue;
+      DynamicalSystemProperties& props = _dynamicalSystemsGraph->properties(*dsi);
+      CachedW& entry = incoming->second[_dynamicalSystemsGraph->bundle(*dsi)->number()];
+      if(entry.W)
+      {
+        props.W = entry.W;
+        props.WBoundaryConditions = entry.WBoundaryConditions;
+        props.Winverse.reset(); // rebuilt on demand by its users
+      }
+      else
+      {
+        // DS inserted after this h was last used
+        SP::SecondOrderDS ds = std::static_pointer_cast<SecondOrderDS>(_dynamicalSystemsGraph->bundle(*dsi));
+        props.W.reset();
+        props.Winverse.reset();
+        props.WBoundaryConditions.reset();
+        initializeIterationMatrixW(_simulation->nextTime(), ds);
+      }
+    }
+    _WCacheH = h;
+  }
+
+  // an adaptive controller is expected to revisit a handful of h
+  // values; when it does not, caching is pointless: start afresh
+  if(_WCache.size() > _WCacheMaxSize)
+  {
+    std::map<size_t, CachedW> current;
+    std::map<double, std::map<size_t, CachedW> >::iterator found = _WCache.find(_WCacheH);
+    if(found != _WCache.end()) current.swap(found->second);
+    _WCache.clear();
+    if(!current.empty()) _WCache[_WCacheH].swap(current);
+  }
+  DEBUG_END("MoreauJeanOSI::timeStepChanged()\n");
+}
+
 
 void MoreauJeanOSI::_initializeIterationMatrixWBoundaryConditions(SecondOrderDS& ds, const DynamicalSystemsGraph::VDescriptor& dsv)
 {
@@ -717,9 +831,13 @@ double MoreauJeanOSI::computeResidu()
   {
     if(!checkOSI(dsi)) continue;
     DynamicalSystem& ds = *_dynamicalSystemsGraph->bundle(*dsi);
+    /* sleeping systems are frozen: no residual to integrate */
+    if(ds.sleeping()) continue;
     VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
 
-    dsType = Type::value(ds); // Its type
+    // type cached on the vertex by the topology, the visitor is only a fallback
+    dsType = _dynamicalSystemsGraph->properties(*dsi).ds_type;
+    if(dsType == Type::void_type) dsType = Type::value(ds);
 
     // 3 - Lagrangian Non Linear Systems
     if(dsType == Type::LagrangianDS)
@@ -1056,242 +1174,221 @@ double MoreauJeanOSI::computeResidu()
 
 }
 
-void MoreauJeanOSI::computeFreeState()
+void MoreauJeanOSI::updateTypeGroups()
 {
-  DEBUG_BEGIN("MoreauJeanOSI::computeFreeState()\n");
-  // This function computes "free" states of the DS belonging to this Integrator.
-  // "Free" means without taking non-smooth effects into account.
+  DynamicalSystemsGraph& DSG = *_dynamicalSystemsGraph;
+  if(_typeGroupsStamp == DSG.stamp() && _typeGroupsSize == DSG.size())
+    return;
 
-  double t = _simulation->nextTime(); // End of the time step
+  _typeGroups.clear();
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = DSG.vertices(); dsi != dsend; ++dsi)
+  {
+    if(!checkOSI(dsi)) continue;
+    // type cached on the vertex by the topology, the visitor is only a fallback
+    Type::Siconos dsType = DSG.properties(*dsi).ds_type;
+    if(dsType == Type::void_type) dsType = Type::value(*DSG.bundle(*dsi));
+
+    std::vector<TypeGroup>::iterator group = _typeGroups.begin();
+    for(; group != _typeGroups.end(); ++group)
+      if(group->ds_type == dsType) break;
+    if(group == _typeGroups.end())
+    {
+      _typeGroups.push_back(TypeGroup());
+      _typeGroups.back().ds_type = dsType;
+      group = _typeGroups.end() - 1;
+    }
+    group->vertices.push_back(*dsi);
+  }
+  _typeGroupsStamp = DSG.stamp();
+  _typeGroupsSize = DSG.size();
+}
 
-  // Operators computed at told have index i, and (i+1) at t.
+template<Type::Siconos dsType>
+void MoreauJeanOSI::computeFreeStateKernel(const DynamicalSystemsGraph::VDescriptor& dsv, double t)
+{
+  DynamicalSystem& ds = *_dynamicalSystemsGraph->bundle(dsv);
+  /* sleeping systems keep their state: nothing to integrate */
+  if(ds.sleeping()) return;
+  /* the instantiations for a concrete type keep only their own branches;
+     the Type::void_type instantiation is the generic fallback and keeps
+     the run-time dispatch of old */
+  Type::Siconos runtimeType = dsType;
+  if(dsType == Type::void_type)
+  {
+    runtimeType = _dynamicalSystemsGraph->properties(dsv).ds_type;
+    if(runtimeType == Type::void_type) runtimeType = Type::value(ds);
+  }
+  SiconosMatrix& W = *_dynamicalSystemsGraph->properties(dsv).W; // Its W MoreauJeanOSI matrix of iteration.
+  VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(dsv).workVectors;
 
-  //  Note: integration of r with a theta method has been removed
-  //  SiconosVector *rold = static_cast<SiconosVector*>(d->rMemory()->getSiconosVector(0));
+  // IN to be updated at current time: W, M, q, v, fL
+  // IN at told: qi,vi, fLi
 
-  // Iteration through the set of Dynamical Systems.
-  //
+  // Note: indices i/i+1 corresponds to value at the beginning/end of the time step.
+  // Index k stands for Newton iteration and thus corresponds to the last computed
+  // value, ie the one saved in the DynamicalSystem.
+  // "i" values are saved in memory vectors.
 
+  // vFree = v_k,i+1 - W^{-1} ResiduFree
+  // with
+  // ResiduFree = M(q_k,i+1)(v_k,i+1 - v_i) - h*theta*forces(t,v_k,i+1, q_k,i+1) - h*(1-theta)*forces(ti,vi,qi)
 
-  //SP::DynamicalSystem ds; // Current Dynamical System.
-  //SP::SiconosMatrix W; // W MoreauJeanOSI matrix of the current DS.
-  Type::Siconos dsType ; // Type of the current DS.
+  SecondOrderDS& d = static_cast<SecondOrderDS&>(ds);
+  const SiconosVector& vold = d.velocityMemory().getSiconosVector(0); //vi (vold)
+  const SiconosVector& v = *d.velocity(); // v = v_k,i+1
 
-  DynamicalSystemsGraph::VIterator dsi, dsend;
+  DEBUG_EXPR(v.display());
+  DEBUG_EXPR(vold .display());
 
-  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  // --- ResiduFree computation ---
+  // ResFree = M(v-vold) - h*[theta*forces(t) + (1-theta)*forces(told)]
+  //
+  // vFree pointer is used to compute and save ResiduFree in this first step.
+  SiconosVector& residuFree = *ds_work_vectors[MoreauJeanOSI::RESIDU_FREE];
+  SiconosVector& vfree = *ds_work_vectors[MoreauJeanOSI::VFREE];
+
+  vfree = residuFree;
+  DEBUG_EXPR(vfree.display());
+  // -- Update W --
+  // Note: during computeW, mass and jacobians of forces will be computed/
+  if(runtimeType == Type::LagrangianDS
+      || runtimeType == Type:: NewtonEulerDS)
   {
-    if(!checkOSI(dsi)) continue;
-    DynamicalSystem & ds = *_dynamicalSystemsGraph->bundle(*dsi);
-    dsType = Type::value(ds); // Its type
-    SiconosMatrix& W = *_dynamicalSystemsGraph->properties(*dsi).W; // Its W MoreauJeanOSI matrix of iteration.
-    VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
-    // // 3 - Lagrangian Non Linear Systems
-    // if(dsType == Type::LagrangianDS ||
-    //    dsType == Type::NewtonEulerDS)
-    // {
-    DEBUG_PRINT("MoreauJeanOSI::computeFreeState()\n");
-    // IN to be updated at current time: W, M, q, v, fL
-    // IN at told: qi,vi, fLi
-
-    // Note: indices i/i+1 corresponds to value at the beginning/end of the time step.
-    // Index k stands for Newton iteration and thus corresponds to the last computed
-    // value, ie the one saved in the DynamicalSystem.
-    // "i" values are saved in memory vectors.
-
-    // vFree = v_k,i+1 - W^{-1} ResiduFree
-    // with
-    // ResiduFree = M(q_k,i+1)(v_k,i+1 - v_i) - h*theta*forces(t,v_k,i+1, q_k,i+1) - h*(1-theta)*forces(ti,vi,qi)
-
-    // -- Convert the DS into a Lagrangian one.
-    SecondOrderDS& d = static_cast<SecondOrderDS&>(ds);
-    const SiconosVector& vold = d.velocityMemory().getSiconosVector(0); //vi (vold)
-    const SiconosVector& v = *d.velocity(); // v = v_k,i+1
-
-    DEBUG_EXPR(v.display());
-    DEBUG_EXPR(vold .display());
-
-    // --- ResiduFree computation ---
-    // ResFree = M(v-vold) - h*[theta*forces(t) + (1-theta)*forces(told)]
-    //
-    // vFree pointer is used to compute and save ResiduFree in this first step.
-    SiconosVector& residuFree = *ds_work_vectors[MoreauJeanOSI::RESIDU_FREE];
-    SiconosVector& vfree = *ds_work_vectors[MoreauJeanOSI::VFREE];
-
-    vfree = residuFree;
-    DEBUG_EXPR(vfree.display());
-    // -- Update W --
-    // Note: during computeW, mass and jacobians of forces will be computed/
-    if(dsType == Type::LagrangianDS
-        || dsType == Type:: NewtonEulerDS)
+    computeW(t, d, W);
+    if(d.boundaryConditions())
     {
-      computeW(t, d, W);
-      if(d.boundaryConditions())
-      {
-        _computeWBoundaryConditions(d, *_dynamicalSystemsGraph->properties(*dsi).WBoundaryConditions,W);
-      }
+      _computeWBoundaryConditions(d, *_dynamicalSystemsGraph->properties(dsv).WBoundaryConditions,W);
     }
+  }
 
 
-    DEBUG_EXPR(W.display(););
-    if(dsType == Type::LagrangianLinearDiagonalDS)
+  DEBUG_EXPR(W.display(););
+  if(runtimeType == Type::LagrangianLinearDiagonalDS)
+  {
+    // W is diagonal and contains the inverse of the iteration matrix!
+    for(unsigned int i=0; i<d.dimension(); ++i)
+      vfree(i) = -W(i, i) * vfree(i) + vold(i);
+  }
+  else
+  {
+    // -- vfree =  v - W^{-1} ResiduFree --
+    // At this point vfree = residuFree
+    // -> Solve WX = vfree and set vfree = X
+    W.Solve(vfree);
+    // -> compute real vfree
+    vfree *= -1.0;
+    // Get state i (previous time step) from Memories -> var. indexed with "Old"
+    if(runtimeType == Type::LagrangianLinearTIDS)
     {
-      // W is diagonal and contains the inverse of the iteration matrix!
-      for(unsigned int i=0; i<d.dimension(); ++i)
-        vfree(i) = -W(i, i) * vfree(i) + vold(i);
+      vfree += vold;
     }
     else
     {
-      // -- vfree =  v - W^{-1} ResiduFree --
-      // At this point vfree = residuFree
-      // -> Solve WX = vfree and set vfree = X
-      W.Solve(vfree);
-      // -> compute real vfree
-      vfree *= -1.0;
-      // Get state i (previous time step) from Memories -> var. indexed with "Old"
-      if(dsType == Type::LagrangianLinearTIDS)
-      {
-        vfree += vold;
-      }
-      else
-      {
-        vfree += v;
-      }
-      DEBUG_EXPR(vfree.display());
+      vfree += v;
     }
-    // }
-    // // 4 - Lagrangian Linear Systems
-    // else if(dsType == Type::LagrangianLinearTIDS)
-    // {
-    //   DEBUG_PRINT("MoreauJeanOSI::computeFreeState(), dsType == Type::LagrangianLinearTIDS\n");
-    //   // IN to be updated at current time: Fext
-    //   // IN at told: qi,vi, fext
-    //   // IN constants: K,C
-
-    //   // Note: indices i/i+1 corresponds to value at the beginning/end of the time step.
-    //   // "i" values are saved in memory vectors.
-
-    //   // vFree = v_i + W^{-1} ResiduFree    // with
-    //   // ResiduFree = (-h*C -h^2*theta*K)*vi - h*K*qi + h*theta * Fext_i+1 + h*(1-theta)*Fext_i
-
-    //   // -- Convert the DS into a Lagrangian one.
-    //   LagrangianLinearTIDS& d = static_cast<LagrangianLinearTIDS&> (ds);
-
-    //   // Get state i (previous time step) from Memories -> var. indexed with "Old"
-    //   const SiconosVector& vold = d.velocityMemory().getSiconosVector(0); //vi
-
-    //   // --- ResiduFree computation ---
-    //   // vFree pointer is used to compute and save ResiduFree in this first step.
-
-    //   // Velocity free and residu. vFree = RESfree (pointer equality !!).
-    //   SiconosVector& residuFree = *ds_work_vectors[MoreauJeanOSI::RESIDU_FREE];
-    //   SiconosVector& vfree = *ds_work_vectors[MoreauJeanOSI::VFREE];
-
-    //   vfree = residuFree;
-    //   DEBUG_EXPR(vfree.display());
-    //   W.Solve(vfree);
-    //   vfree *= -1.0;
-    //   vfree += vold;
-
-    //   DEBUG_EXPR(vfree.display());
-
-
-    // }
-    // // 4 - Lagrangian Linear Diagonal Systems
-    // else if(dsType == Type::LagrangianLinearDiagonalDS)
-    // {
-    //   // IN to be updated at current time: Fext
-    //   // IN at told: qi,vi, fext
-    //   // IN constants: K,C
-
-    //   // Note: indices i/i+1 corresponds to value at the beginning/end of the time step.
-    //   // "i" values are saved in memory vectors.
-
-    //   // vFree = v_i + W^{-1} ResiduFree    // with
-    //   // ResiduFree = (-h*C -h^2*theta*K)*vi - h*K*qi + h*theta * Fext_i+1 + h*(1-theta)*Fext_i
-
-    //   // -- Convert the DS into a Lagrangian one.
-    //   LagrangianLinearDiagonalDS& d = static_cast<LagrangianLinearDiagonalDS&> (ds);
-
-    //   // Get state i (previous time step) from Memories -> var. indexed with "Old"
-    //   const SiconosVector& vold = d.velocityMemory().getSiconosVector(0); //vi
-
-    //   // --- ResiduFree computation ---
-    //   // vFree pointer is used to compute and save ResiduFree in this first step.
-
-    //   // Velocity free and residu. vFree = RESfree (pointer equality !!).
-    //   SiconosVector& vfree = *ds_work_vectors[MoreauJeanOSI::VFREE];
-    //   // W is diagonal and contains the inverse of the iteration matrix!
-    //   for(unsigned int i=0;i<d.dimension();++i)
-    //     vfree(i) = -W(i, i) * vfree(i) + vold(i);
-
-    // }
-    // // else if  (dsType == Type::NewtonEulerDS)
-    // {
-    //   // IN to be updated at current time: W, M, q, v, fL
-    //   // IN at told: qi,vi,
-
-    //   // Note: indices i/i+1 corresponds to value at the beginning/end of the time step.
-    //   // Index k stands for Newton iteration and thus corresponds to the last computed
-    //   // value, ie the one saved in the DynamicalSystem.
-    //   // "i" values are saved in memory vectors.
-
-    //   // vFree = v_k,i+1 - W^{-1} ResiduFree
-    //   // with
-    //   // ResiduFree = M(q_k,i+1)(v_k,i+1 - v_i) - h*theta*forces(t,v_k,i+1, q_k,i+1)
-    //   //                                        - h*(1-theta)*forces(ti,vi,qi)
-
-    //   // -- Convert the DS into a NewtonEuler one.
-    //   NewtonEulerDS& d = static_cast<NewtonEulerDS&> (ds);
-    //   // --- ResiduFree computation ---
-    //   // ResFree = M(v-vold) - h*[theta*forces(t) + (1-theta)*forces(told)]
-    //   //
-    //   // vFree pointer is used to compute and save ResiduFree in this first step.
-    //   SiconosVector& residuFree = *ds_work_vectors[MoreauJeanOSI::RESIDU_FREE];
-    //   SiconosVector& vfree = *ds_work_vectors[MoreauJeanOSI::VFREE];
-
-    //   vfree = residuFree;
-
-    //   // -- Update W --
-    //   // Note: during computeW, mass and jacobians of forces will be computed/
-    //   //SimpleMatrix& W = *_dynamicalSystemsGraph->properties(*dsi).W;
-    //   computeW(t, d, W);
-    //   const SiconosVector& v = *d.twist(); // v = v_k,i+1
-
-    //   // -- vfree =  v - W^{-1} ResiduFree --
-    //   // At this point vfree = residuFree
-    //   // -> Solve WX = vfree and set vfree = X
-    //   //    std::cout<<"MoreauJeanOSI::computeFreeState residu free"<<endl;
-    //   //    vfree->display();
-    //   DEBUG_EXPR(residuFree.display(););
-
-    //   W.Solve(vfree);
-    //   //    std::cout<<"MoreauJeanOSI::computeFreeState -WRfree"<<endl;
-    //   //    vfree->display();
-    //   //    scal(h,*vfree,*vfree);
-    //   // -> compute real vfree
-    //   vfree *= -1.0;
-    //   DEBUG_EXPR(vfree.display(););
-    //   vfree += v;
-    //   DEBUG_EXPR(vfree.display(););
-    // }
-    // else
-    //   THROW_EXCEPTION("MoreauJeanOSI::computeFreeState - not yet implemented for Dynamical system of type: " +  Type::name(ds));
+    DEBUG_EXPR(vfree.display());
+  }
+}
+
+template<Type::Siconos dsType>
+void MoreauJeanOSI::computeFreeStateGroup(const TypeGroup& group, double t)
+{
+  // each DS only touches its own W and work vectors, so the free states can
+  // be computed in parallel over the group
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(group.vertices.size()); ++i)
+    computeFreeStateKernel<dsType>(group.vertices[i], t);
+}
+
+void MoreauJeanOSI::computeFreeState()
+{
+  DEBUG_BEGIN("MoreauJeanOSI::computeFreeState()\n");
+  // This function computes "free" states of the DS belonging to this Integrator.
+  // "Free" means without taking non-smooth effects into account.
+
+  double t = _simulation->nextTime(); // End of the time step
+
+  // Operators computed at told have index i, and (i+1) at t.
+
+  //  Note: integration of r with a theta method has been removed
+  //  SiconosVector *rold = static_cast<SiconosVector*>(d->rMemory()->getSiconosVector(0));
 
+  // The DS are sorted once into homogeneous type groups (cached across
+  // the steps while the graph does not change) and each group runs a
+  // kernel instantiated for its type: the loops carry no per-body type
+  // dispatch, which matters in large mixed scenes.
+  updateTypeGroups();
+  for(const TypeGroup& group : _typeGroups)
+  {
+    switch(group.ds_type)
+    {
+    case Type::LagrangianDS:
+      computeFreeStateGroup<Type::LagrangianDS>(group, t);
+      break;
+    case Type::LagrangianLinearTIDS:
+      computeFreeStateGroup<Type::LagrangianLinearTIDS>(group, t);
+      break;
+    case Type::LagrangianLinearDiagonalDS:
+      computeFreeStateGroup<Type::LagrangianLinearDiagonalDS>(group, t);
+      break;
+    case Type::NewtonEulerDS:
+      computeFreeStateGroup<Type::NewtonEulerDS>(group, t);
+      break;
+    default:
+      computeFreeStateGroup<Type::void_type>(group, t);
+      break;
+    }
   }
   DEBUG_END("MoreauJeanOSI::computeFreeState()\n");
 }
 
+/* exact comparison of the raw values of two iteration matrices; dense
+   storage (the usual case) is compared bytewise, anything else falls back
+   to the tolerance-based matrix comparison */
+static bool unchangedW(const SimpleMatrix& Wnew, const SimpleMatrix& W)
+{
+  if(Wnew.num() == Siconos::DENSE && W.num() == Siconos::DENSE)
+    return memcmp(Wnew.getArray(), W.getArray(),
+                  Wnew.size(0) * Wnew.size(1) * sizeof(double)) == 0;
+  return Wnew == W;
+}
+
 void MoreauJeanOSI::prepareNewtonIteration(double time)
 {
   DEBUG_BEGIN(" MoreauJeanOSI::prepareNewtonIteration(double time)\n");
-  DynamicalSystemsGraph::VIterator dsi, dsend;
-  for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
+  // the W update of each DS is independent from the others
+  parallelForVertices(*_dynamicalSystemsGraph,
+                      [&](const DynamicalSystemsGraph::VDescriptor& dsv)
   {
-    if(!checkOSI(dsi)) continue;
-    SecondOrderDS &sods = * (std::static_pointer_cast<SecondOrderDS> (_dynamicalSystemsGraph->bundle(*dsi)));
-    computeW(time, sods, *_dynamicalSystemsGraph->properties(*dsi).W);
-  }
+    if(!checkOSI(dsv)) return;
+    SecondOrderDS &sods = * (std::static_pointer_cast<SecondOrderDS> (_dynamicalSystemsGraph->bundle(dsv)));
+    DynamicalSystemProperties& props = _dynamicalSystemsGraph->properties(dsv);
+    SimpleMatrix& W = *props.W;
+
+    Type::Siconos dsType = Type::value(sods);
+    if(dsType == Type::LagrangianLinearTIDS || dsType == Type::LagrangianLinearDiagonalDS)
+    {
+      // time-invariant W: computeW is a no-op, nothing to refresh
+      return;
+    }
+
+    // Recompute into a per-DS scratch and compare with the current W:
+    // in weakly nonlinear models the Jacobians of most DS stagnate after
+    // the first Newton iterations, and an unchanged W keeps its stored
+    // factors (they live in the numerics matrix, the raw values are left
+    // intact by Factorize()), so the next Solve() calls skip the
+    // refactorization entirely.
+    if(!props.Wlast)
+      props.Wlast.reset(new SimpleMatrix(W.size(0), W.size(1)));
+    SimpleMatrix& Wnew = *props.Wlast;
+    computeW(time, sods, Wnew);
+    if(W.isFactorized() && unchangedW(Wnew, W))
+      return;
+    W = Wnew; // resets the factorization flags
+  });
 
   if(!_explicitNewtonEulerDSOperators)
   {
@@ -1678,6 +1775,16 @@ void MoreauJeanOSI::updatePosition(DynamicalSystem& ds)
 
 }
 
+/* bitwise equality, used to keep the state version of a system untouched
+   only when its new velocity is exactly the previous one */
+static bool equalValues(const SiconosVector& a, const SiconosVector& b)
+{
+  if(a.size() != b.size()) return false;
+  for(unsigned int i = 0; i < a.size(); ++i)
+    if(a.getValue(i) != b.getValue(i)) return false;
+  return true;
+}
+
 void MoreauJeanOSI::updateState(const unsigned int)
 {
 
@@ -1688,18 +1795,25 @@ void MoreauJeanOSI::updateState(const unsigned int)
   if(useRCC)
     _simulation->setRelativeConvergenceCriterionHeld(true);
 
+  /* NewtonEuler position updates are gathered and run in one batch after
+     the velocity loop, through the shared quaternion kernels */
+  std::vector<NewtonEulerDS*> newtonEulerBodies;
+
   DynamicalSystemsGraph::VIterator dsi, dsend;
   for(std::tie(dsi, dsend) = _dynamicalSystemsGraph->vertices(); dsi != dsend; ++dsi)
   {
     if(!checkOSI(dsi)) continue;
     DynamicalSystem& ds = *_dynamicalSystemsGraph->bundle(*dsi);
+    /* sleeping systems keep the state they fell asleep with */
+    if(ds.sleeping()) continue;
 
     VectorOfVectors& ds_work_vectors = *_dynamicalSystemsGraph->properties(*dsi).workVectors;
 
     SiconosMatrix& W = *_dynamicalSystemsGraph->properties(*dsi).W;
-    // Get the DS type
-
-    Type::Siconos dsType = Type::value(ds);
+    // Get the DS type, cached on the vertex by the topology;
+    // the visitor is only a fallback
+    Type::Siconos dsType = _dynamicalSystemsGraph->properties(*dsi).ds_type;
+    if(dsType == Type::void_type) dsType = Type::value(ds);
 
     // 3 - Lagrangian Systems
     if(dsType == Type::LagrangianDS || dsType == Type::LagrangianLinearTIDS || dsType == Type::LagrangianLinearDiagonalDS)
@@ -1712,6 +1826,7 @@ void MoreauJeanOSI::updateState(const unsigned int)
       //    SiconosVector *vfree = d.velocityFree();
       SiconosVector& v = *d.velocity();
       bool baux = dsType == Type::LagrangianDS && useRCC && _simulation->relativeConvergenceCriterionHeld();
+      bool velocityUnchanged = false;
 
       if(d.p(_levelMaxForInput) && d.p(_levelMaxForInput)->size() > 0)
       {
@@ -1740,6 +1855,7 @@ void MoreauJeanOSI::updateState(const unsigned int)
       }
       else
       {
+        velocityUnchanged = equalValues(v, vfree);
         v =  vfree;
       }
       DEBUG_EXPR(v.display());
@@ -1780,6 +1896,11 @@ void MoreauJeanOSI::updateState(const unsigned int)
 
       updatePosition(ds);
 
+      /* within a step q follows deterministically from the (fixed) state
+         memories and v, so an unchanged velocity means an unchanged state */
+      if(!velocityUnchanged)
+        ds.bumpStateVersion();
+
       if(baux)
       {
         double ds_norm_ref = 1. + ds.x0()->norm2(); // Should we save this in the graph?
@@ -1807,6 +1928,7 @@ void MoreauJeanOSI::updateState(const unsigned int)
       //       " MoreauJeanOSI::updateState() *d.p(_levelMaxForInput) == nullptr.");
 
       SiconosVector& vfree = *ds_work_vectors[MoreauJeanOSI::VFREE];
+      bool velocityUnchanged = false;
 
 
       if(d.p(_levelMaxForInput) && d.p(_levelMaxForInput)->size() > 0)
@@ -1829,7 +1951,10 @@ void MoreauJeanOSI::updateState(const unsigned int)
         v +=  vfree;
       }
       else
+      {
+        velocityUnchanged = equalValues(v, vfree);
         v =  vfree;
+      }
 
       DEBUG_PRINT("MoreauJeanOSI::updatestate work free\n");
       DEBUG_EXPR(vfree.display());
@@ -1860,12 +1985,51 @@ void MoreauJeanOSI::updateState(const unsigned int)
         }
       }
 
-      updatePosition(ds);
+      newtonEulerBodies.push_back(&d);
+
+      /* see the comment in the Lagrangian case above */
+      if(!velocityUnchanged)
+        ds.bumpStateVersion();
 
     }
     else THROW_EXCEPTION("MoreauJeanOSI::updateState - not yet implemented for Dynamical system of type: " +  Type::name(ds));
 
   }
+
+  if(!newtonEulerBodies.empty())
+  {
+    /* gather the twist increments and old configurations of every
+       NewtonEuler body, run the shared batch kernel once, scatter the new
+       configurations back (same math as updatePosition, body by body) */
+    double h = _simulation->timeStep();
+    size_t number = newtonEulerBodies.size();
+    std::vector<double> qold(7 * number);
+    std::vector<double> twistIncrement(6 * number);
+    std::vector<double> qnew(7 * number);
+
+    for(size_t i = 0; i < number; ++i)
+    {
+      NewtonEulerDS& d = *newtonEulerBodies[i];
+      const SiconosVector& qo = d.qMemory().getSiconosVector(0);
+      const SiconosVector& vold = d.twistMemory().getSiconosVector(0);
+      const SiconosVector& v = *d.twist();
+      for(unsigned int k = 0; k < 7; ++k)
+        qold[7 * i + k] = qo(k);
+      for(unsigned int k = 0; k < 6; ++k)
+        twistIncrement[6 * i + k] = h * _theta * v(k) + h * (1 - _theta) * vold(k);
+    }
+
+    twistIncrementComposeBatch(qold.data(), twistIncrement.data(),
+                               qnew.data(), number);
+
+    for(size_t i = 0; i < number; ++i)
+    {
+      SiconosVector& q = *newtonEulerBodies[i]->q();
+      for(unsigned int k = 0; k < 7; ++k)
+        q(k) = qnew[7 * i + k];
+    }
+  }
+
   DEBUG_END("MoreauJeanOSI::updateState(const unsigned int)\n");
 }
 
@@ -24,6 +24,7 @@
 #include "OneStepIntegrator.hpp"
 
 #include <limits>
+#include <map> // for the h-keyed cache of iteration matrices
 
 const unsigned int MOREAUSTEPSINMEMORY = 1;
 
@@ -147,12 +148,75 @@ protected:
    */
   bool _isWSymmetricDefinitePositive;
 
-  /** 
+  /**
       A set of work indices for the selected coordinates when
       we subprod in computeFreeOuput
   */
   std::vector<std::size_t> _selected_coordinates;
 
+  /** one cached iteration matrix of a DS: W carries its stored
+   *  factorization (time-invariant systems), the boundary-conditions
+   *  columns were extracted before it */
+  struct CachedW
+  {
+    SP::SimpleMatrix W;
+    SP::SimpleMatrix WBoundaryConditions;
+  };
+
+  /** iteration matrices already built for recently used time steps,
+   *  keyed by h then by DS number; filled and consumed by
+   *  timeStepChanged() */
+  std::map<double, std::map<size_t, CachedW> > _WCache;
+
+  /** value of h the currently installed W matrices were built with
+   *  (0 until the first initializeIterationMatrixW call) */
+  double _WCacheH = 0.;
+
+  /** number of distinct h values kept in _WCache; an adaptive controller
+   *  quantizing h (halving/doubling) never needs more, overflowing the
+   *  cap means thrashing and empties the cache */
+  static const size_t _WCacheMaxSize = 8;
+
+  /** one homogeneous group of DS graph vertices: every vertex bundles a
+   *  DynamicalSystem of the same Type::Siconos, so a step kernel
+   *  instantiated for that type can run over the whole group without
+   *  per-body type branching */
+  struct TypeGroup
+  {
+    Type::Siconos ds_type;
+    std::vector<DynamicalSystemsGraph::VDescriptor> vertices;
+  };
+
+  /** the vertices handled by this integrator, sorted into homogeneous
+   *  type groups; rebuilt by updateTypeGroups() when the graph changes */
+  std::vector<TypeGroup> _typeGroups;
+
+  /** stamp and size of the DS graph the groups were built against */
+  int _typeGroupsStamp = -1;
+  size_t _typeGroupsSize = 0;
+
+  /** rebuild _typeGroups if the DS graph changed since the last build */
+  void updateTypeGroups();
+
+  /** free-state step of one DS; dsType is a compile-time parameter, so
+   *  each instantiation keeps only the branches of its own type
+   *  (Type::void_type instantiates the generic run-time fallback)
+   *
+   *  \param dsv vertex of the DS in the graph
+   *  \param t end of the time step
+   */
+  template<Type::Siconos dsType>
+  void computeFreeStateKernel(const DynamicalSystemsGraph::VDescriptor& dsv, double t);
+
+  /** run the free-state kernel instantiated for dsType over a whole
+   *  group, in parallel when OpenMP is enabled
+   *
+   *  \param group a homogeneous group built by updateTypeGroups()
+   *  \param t end of the time step
+   */
+  template<Type::Siconos dsType>
+  void computeFreeStateGroup(const TypeGroup& group, double t);
+
   /** nslaw effects
    */
   // struct _NSLEffectOnFreeOutput;
@@ -395,6 +459,30 @@ public:
    */
   void initializeIterationMatrixW(double time, SP::SecondOrderDS ds);
 
+  /** discard the iteration matrices W of all the systems handled by the
+   *  OSI, together with their stored factorizations, and rebuild them with
+   *  the current time step.
+   *
+   *  For time-invariant systems (LagrangianLinearTIDS,
+   *  LagrangianLinearDiagonalDS), W depends only on the time step h: it is
+   *  factorized once at initialization and the factors are reused at every
+   *  step. Call this function whenever h is changed during the simulation,
+   *  and only then.
+   */
+  void recomputeIterationMatricesW();
+
+  /** swap the iteration matrices when the time step h changes.
+   *
+   *  The matrices built for the outgoing h (with their stored
+   *  factorizations for the time-invariant systems) are parked in an
+   *  h-keyed cache; if the incoming h was already used they are simply
+   *  reinstalled, otherwise they are rebuilt from scratch with
+   *  recomputeIterationMatricesW(). An adaptive scheme alternating
+   *  between a handful of h values therefore pays each factorization
+   *  once.
+   */
+  void timeStepChanged() override;
+
   /** compute W MoreauJeanOSI matrix at time t
    *
    *  \param time (double)
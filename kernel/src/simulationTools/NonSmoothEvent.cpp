@@ -71,6 +71,7 @@ void NonSmoothEvent::process(Simulation& simulation)
 
       simulation.nonSmoothDynamicalSystem()->swapInMemory();  // To save pre-impact values
       simulation.nonSmoothDynamicalSystem()->pushInteractionsInMemory();  // To save pre-impact values
+      simulation.recordStateMemorySwap(getDoubleTimeOfEvent());  // timestamp for dense output
 
       // solve the LCP-impact => y[1],lambda[1]
       eventDriven.computeOneStepNSProblem(SICONOS_OSNSP_ED_IMPACT); // solveLCPImpact();
@@ -94,6 +95,7 @@ void NonSmoothEvent::process(Simulation& simulation)
     // Save results in memory
     simulation.nonSmoothDynamicalSystem()->swapInMemory();  // To save pre-impact values
     simulation.nonSmoothDynamicalSystem()->pushInteractionsInMemory();  // To save pre-impact values
+    simulation.recordStateMemorySwap(getDoubleTimeOfEvent());  // timestamp for dense output
 
   }
 }
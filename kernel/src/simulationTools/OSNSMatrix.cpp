@@ -22,6 +22,7 @@
 #include "Tools.hpp"
 #include "BlockCSRMatrix.hpp"
 #include "SimulationGraphs.hpp"
+#include "SiconosAlgebra.hpp" // for DenseMat
 #include "SimpleMatrix.hpp"
 #include "Interaction.hpp"
 #include "DynamicalSystem.hpp"
@@ -147,19 +148,14 @@ unsigned OSNSMatrix::updateSizeAndPositions(InteractionsGraph& indexSet)
   //
 
   // Computes real size of the current matrix = sum of the dim. of all
-  // Interactionin indexSet
-  unsigned dim = 0;
-  InteractionsGraph::VIterator vd, vdend;
-  for(std::tie(vd, vdend) = indexSet.vertices(); vd != vdend; ++vd)
-  {
-    assert(indexSet.descriptor(indexSet.bundle(*vd)) == *vd);
-    indexSet.properties(*vd).absolute_position = dim;
-    dim += (indexSet.bundle(*vd)->nonSmoothLaw()->size());
-    DEBUG_PRINTF("Position = %i for interaction %zu\n",dim, indexSet.bundle(*vd)->number());
-    assert(indexSet.properties(*vd).absolute_position < dim);
-  }
-
-  return dim;
+  // Interaction in indexSet.  Positions are handed out by the persistent
+  // layout of the index set (see InteractionsGraph::updateStablePositions):
+  // an interaction keeps the same absolute_position across calls as long as
+  // it stays in the set, so the per-position state of this matrix
+  // (_blockLayout, scatter maps, warm starts downstream) survives the
+  // arrival or departure of a few contacts instead of being invalidated
+  // by a global shift.
+  return indexSet.updateStablePositions();
 }
 unsigned OSNSMatrix::updateSizeAndPositions(DynamicalSystemsGraph & DSG)
 {
@@ -171,20 +167,79 @@ unsigned OSNSMatrix::updateSizeAndPositions(DynamicalSystemsGraph & DSG)
   // previous interactionBlocks sizes.
 
   // Computes real size of the current matrix = sum of the dim. of all
-  // Interactionin indexSet
-  unsigned dim = 0;
+  // Interactionin indexSet. As for the interactions graph overload,
+  // positions follow the vertex indices so a spatial renumbering of the
+  // systems carries over to the layout of W.
+  std::vector<DynamicalSystemsGraph::VDescriptor> vds;
+  vds.reserve(DSG.size());
   DynamicalSystemsGraph::VIterator dsi, dsend;
-  // first loop to compute sizeM and nnz
   for(std::tie(dsi, dsend) = DSG.vertices(); dsi != dsend; ++dsi)
+    vds.push_back(*dsi);
+  std::stable_sort(vds.begin(), vds.end(),
+                   [&DSG](const DynamicalSystemsGraph::VDescriptor& a,
+                          const DynamicalSystemsGraph::VDescriptor& b)
+                   { return DSG.index(a) < DSG.index(b); });
+
+  unsigned dim = 0;
+  for(const DynamicalSystemsGraph::VDescriptor& v : vds)
   {
-    SP::DynamicalSystem ds = DSG.bundle(*dsi);
-    DSG.properties(*dsi).absolute_position = dim;
+    SP::DynamicalSystem ds = DSG.bundle(v);
+    DSG.properties(v).absolute_position = dim;
     dim += ds->dimension();
   }
 
   return dim;
 }
 
+void OSNSMatrix::resizeDenseStorage(unsigned int nr, unsigned int nc)
+{
+  // ublas DenseMat is backed by a std::vector: resizing within the
+  // vector capacity does not reallocate, so keeping the capacity at the
+  // high-water mark makes repeated size changes allocation-free.
+  DenseMat& d = *std::static_pointer_cast<SimpleMatrix>(_M1)->dense();
+  size_t needed = (size_t)nr * nc;
+  if(_denseShrinkRatio > 0. && _denseCapacity > 0
+      && needed < _denseShrinkRatio * _denseCapacity)
+  {
+    d.resize(nr, nc, false);
+    d.data().shrink_to_fit();
+    _denseCapacity = needed;
+  }
+  else
+  {
+    if(needed > _denseCapacity) _denseCapacity = needed;
+    d.data().reserve(_denseCapacity);
+    // no preserve: the caller zeroes and repacks all blocks anyway
+    d.resize(nr, nc, false);
+  }
+}
+
+bool OSNSMatrix::sameBlockLayout(InteractionsGraph& indexSet) const
+{
+  if(_blockLayout.size() != indexSet.size()) return false;
+  size_t k = 0;
+  InteractionsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = indexSet.vertices(); vi != viend; ++vi, ++k)
+  {
+    if(_blockLayout[k].first != indexSet.bundle(*vi)->number()
+        || _blockLayout[k].second != indexSet.properties(*vi).absolute_position)
+      return false;
+  }
+  return true;
+}
+
+void OSNSMatrix::recordBlockLayout(InteractionsGraph& indexSet)
+{
+  _blockLayout.clear();
+  _blockLayout.reserve(indexSet.size());
+  InteractionsGraph::VIterator vi, viend;
+  for(std::tie(vi, viend) = indexSet.vertices(); vi != viend; ++vi)
+  {
+    _blockLayout.push_back(std::make_pair(indexSet.bundle(*vi)->number(),
+                                          indexSet.properties(*vi).absolute_position));
+  }
+}
+
 // Fill the matrix W
 void OSNSMatrix::fillM(InteractionsGraph& indexSet, bool update)
 {
@@ -197,6 +252,45 @@ void OSNSMatrix::fillM(InteractionsGraph& indexSet, bool update)
     _dimRow = _dimColumn;
   }
 
+  // Incremental mode: when the layout of the index set is unchanged,
+  // only the blocks of interactions marked dirty are repacked, in place.
+  // Only relevant for dense storage, where packing means a copy; the
+  // sparse block storage keeps pointer links and needs no repacking.
+  if(_incrementalFill && _storageType == NM_DENSE && _M1
+      && sameBlockLayout(indexSet))
+  {
+    InteractionsGraph::VIterator vi, viend;
+    for(std::tie(vi, viend) = indexSet.vertices(); vi != viend; ++vi)
+    {
+      if(_dirtyBlocks.find(indexSet.bundle(*vi)->number()) == _dirtyBlocks.end())
+        continue;
+      unsigned int pos = indexSet.properties(*vi).absolute_position;
+      std::static_pointer_cast<SimpleMatrix>(_M1)
+      ->setBlock(pos, pos, *indexSet.properties(*vi).block);
+    }
+
+    InteractionsGraph::EIterator ei, eiend;
+    for(std::tie(ei, eiend) = indexSet.edges(); ei != eiend; ++ei)
+    {
+      InteractionsGraph::VDescriptor vd1 = indexSet.source(*ei);
+      InteractionsGraph::VDescriptor vd2 = indexSet.target(*ei);
+      if(_dirtyBlocks.find(indexSet.bundle(vd1)->number()) == _dirtyBlocks.end()
+          && _dirtyBlocks.find(indexSet.bundle(vd2)->number()) == _dirtyBlocks.end())
+        continue;
+      unsigned int pos = indexSet.properties(vd1).absolute_position;
+      unsigned int col = indexSet.properties(vd2).absolute_position;
+      std::static_pointer_cast<SimpleMatrix>(_M1)
+      ->setBlock(std::min(pos, col), std::max(pos, col),
+                 *indexSet.properties(*ei).upper_block);
+      std::static_pointer_cast<SimpleMatrix>(_M1)
+      ->setBlock(std::max(pos, col), std::min(pos, col),
+                 *indexSet.properties(*ei).lower_block);
+    }
+    _dirtyBlocks.clear();
+    DEBUG_END("void OSNSMatrix::fillM(SP::InteractionsGraph indexSet, bool update)\n");
+    return;
+  }
+
   if(_storageType == NM_DENSE)
   {
 
@@ -209,7 +303,7 @@ void OSNSMatrix::fillM(InteractionsGraph& indexSet, bool update)
       else
       {
         if(_M1->size(0) != _dimRow || _M1->size(1) != _dimColumn)
-          _M1->resize(_dimRow, _dimColumn);
+          resizeDenseStorage(_dimRow, _dimColumn);
         _M1->zero();
       }
     }
@@ -270,16 +364,63 @@ void OSNSMatrix::fillM(InteractionsGraph& indexSet, bool update)
   {
     if(! _M2)
     {
-      DEBUG_PRINT("Reset _M2 shared pointer using new BlockCSRMatrix(indexSet) \n ");
-      _M2.reset(new BlockCSRMatrix(indexSet));
+      DEBUG_PRINT("Reset _M2 shared pointer using new BlockCSRMatrix \n ");
+      _M2.reset(new BlockCSRMatrix(indexSet.size()));
+    }
+    _M2->setBlockPruningThreshold(_blockPruningThreshold);
+    _M2->setPruneStaticCrossBlocks(_pruneStaticCrossBlocks);
+    _M2->fill(indexSet);
+    DEBUG_EXPR(_M2->display(););
+  }
+  else if(_storageType == NM_SPARSE)
+  {
+    size_t sizeM = _dimRow;
+    DEBUG_PRINTF("sizeM = %lu \n", sizeM);
+
+    // We choose a triplet matrix format for inserting values.
+    // This simplifies the memory manipulation.
+    _numericsMatrix.reset(NM_create(NM_SPARSE, sizeM, sizeM), NM_free);
 
+    NumericsMatrix& M_NM = *numericsMatrix();
+    NM_triplet_alloc(&M_NM, _triplet_nzmax);
+    CSparseMatrix* Mtriplet = NM_triplet(&M_NM);
+
+    // Diagonal blocks. fillTriplet inserts only the stored entries when a
+    // block carries sparse storage, so sparse relation Jacobians keep
+    // their format down to the numerics matrix.
+    InteractionsGraph::VIterator vi, viend;
+    for(std::tie(vi, viend) = indexSet.vertices(); vi != viend; ++vi)
+    {
+      unsigned int pos = indexSet.properties(*vi).absolute_position;
+      indexSet.properties(*vi).block->fillTriplet(Mtriplet, pos, pos);
     }
-    else
+
+    // Extra-diagonal blocks.
+    InteractionsGraph::EIterator ei, eiend;
+    for(std::tie(ei, eiend) = indexSet.edges(); ei != eiend; ++ei)
     {
-      DEBUG_PRINT("fill existing _M2\n");
-      _M2->fill(indexSet);
-      DEBUG_EXPR(_M2->display(););
+      InteractionsGraph::VDescriptor vd1 = indexSet.source(*ei);
+      InteractionsGraph::VDescriptor vd2 = indexSet.target(*ei);
+      unsigned int pos = indexSet.properties(vd1).absolute_position;
+      unsigned int col = indexSet.properties(vd2).absolute_position;
+
+      assert(indexSet.properties(*ei).lower_block);
+      assert(indexSet.properties(*ei).upper_block);
+      indexSet.properties(*ei).upper_block
+      ->fillTriplet(Mtriplet, std::min(pos, col), std::max(pos, col));
+      indexSet.properties(*ei).lower_block
+      ->fillTriplet(Mtriplet, std::max(pos, col), std::min(pos, col));
     }
+    _triplet_nzmax = NM_nnz(&M_NM);
+  }
+  else
+  {
+    THROW_EXCEPTION("OSNSMatrix::fillM unknown _storageType");
+  }
+  if(_incrementalFill)
+  {
+    recordBlockLayout(indexSet);
+    _dirtyBlocks.clear();
   }
   if(update)
     convert();
@@ -465,16 +606,158 @@ void OSNSMatrix::fillWinverse(DynamicalSystemsGraph & DSG, bool update)
 
 #include <float.h>
 // Fill the matrix H
+//
+// H is assembled directly in sparse form, without going through Htrans and
+// NM_transpose. Its layout only depends on the index set and on the
+// positions of the dynamical systems: it is recorded at the first assembly,
+// together with the destination of every block entry in the csc arrays,
+// and as long as it does not change the following assemblies keep the same
+// matrix and only rewrite its values, in parallel, straight from the
+// relation Jacobians. Structural zeros inside the Jacobian blocks are kept
+// so that the pattern does not depend on the values.
 void OSNSMatrix::fillH(DynamicalSystemsGraph & DSG, InteractionsGraph& indexSet, bool update)
 {
   DEBUG_BEGIN("void OSNSMatrix::fillH(SP::DynamicalSystemsGraph DSG, InteractionsGraph& indexSet, bool update)\n");
 
-  fillHtrans(DSG, indexSet, update);
+  if(_storageType != NM_SPARSE)
+  {
+    THROW_EXCEPTION("OSNSMatrix::fillH unknown _storageType");
+  }
+
+  if(update)
+  {
+    _dimColumn = updateSizeAndPositions(indexSet);
+    _dimRow = updateSizeAndPositions(DSG);
+
+    // check the recorded layout, on the constraint side (interactions and
+    // their positions) and on the dynamical systems side
+    bool sameLayout = _numericsMatrix && !_hCscMap.empty()
+                      && _numericsMatrix->size0 == (int) _dimRow
+                      && _numericsMatrix->size1 == (int) _dimColumn
+                      && sameBlockLayout(indexSet);
+    if(sameLayout)
+    {
+      size_t nds = 0;
+      InteractionsGraph::VIterator ui, uiend;
+      for(std::tie(ui, uiend) = indexSet.vertices(); sameLayout && ui != uiend; ++ui)
+      {
+        SP::DynamicalSystem ds1 = indexSet.properties(*ui).source;
+        SP::DynamicalSystem ds2 = indexSet.properties(*ui).target;
+        bool endl = false;
+        for(SP::DynamicalSystem ds = ds1; sameLayout && !endl; ds = ds2)
+        {
+          endl = (ds == ds2);
+          unsigned int abs_pos_ds = DSG.properties(DSG.descriptor(ds)).absolute_position;
+          sameLayout = nds < _hDsPositions.size() && _hDsPositions[nds++] == abs_pos_ds;
+        }
+      }
+      sameLayout = sameLayout && nds == _hDsPositions.size();
+    }
+
+    if(sameLayout)
+    {
+      // values-only refill of the persistent csc storage; each interaction
+      // writes a disjoint range of entries
+      NumericsMatrix& H_NM = *numericsMatrix();
+      double* x = NM_csc(&H_NM)->x;
+      parallelForVertices(indexSet, [&](const InteractionsGraph::VDescriptor& vd)
+      {
+        Interaction& inter = *indexSet.bundle(vd);
+        size_t sizeY = inter.dimension();
+        SP::SiconosMatrix leftInteractionBlock = inter.getLeftInteractionBlock();
+        double * array = &*leftInteractionBlock->getArray();
+
+        SP::DynamicalSystem ds1 = indexSet.properties(vd).source;
+        SP::DynamicalSystem ds2 = indexSet.properties(vd).target;
+        size_t posBlock = indexSet.properties(vd).source_pos;
+        size_t pos_ds2 = indexSet.properties(vd).target_pos;
+
+        size_t k = _hBlockOffsets[indexSet.index(vd)];
+        bool endl = false;
+        for(SP::DynamicalSystem ds = ds1; !endl; ds = ds2, posBlock = pos_ds2)
+        {
+          endl = (ds == ds2);
+          size_t sizeDS = ds->dimension();
+          const double* block = array + posBlock * sizeY;
+          for(size_t e = 0; e < sizeY * sizeDS; ++e)
+            x[_hCscMap[k++]] = block[e];
+        }
+      });
+      NSM_inc_version(H_NM.matrix2, NSM_CSC);
+    }
+    else
+    {
+      // the layout changed (or first assembly): rebuild the matrix in
+      // triplet form and record the layout
+      _numericsMatrix.reset(NM_create(NM_SPARSE, _dimRow, _dimColumn), NM_free);
+      NumericsMatrix& H_NM = *numericsMatrix();
+      NM_triplet_alloc(&H_NM, _triplet_nzmax);
+      CSparseMatrix* Htriplet = NM_triplet(&H_NM);
 
-  SP::NumericsMatrix Htrans = _numericsMatrix;
-  _numericsMatrix.reset(NM_transpose(Htrans.get()), NM_free);
-  _dimColumn = updateSizeAndPositions(indexSet);
-  _dimRow = updateSizeAndPositions(DSG);
+      _hBlockOffsets.assign(indexSet.size(), 0);
+      _hDsPositions.clear();
+
+      unsigned int pos = 0, abs_pos_ds = 0;
+      SP::SiconosMatrix leftInteractionBlock;
+
+      InteractionsGraph::VIterator ui, uiend;
+      for(std::tie(ui, uiend) = indexSet.vertices(); ui != uiend; ++ui)
+      {
+        Interaction& inter = *indexSet.bundle(*ui);
+        size_t sizeY = inter.dimension();
+        leftInteractionBlock = inter.getLeftInteractionBlock();
+
+        double * array = &*leftInteractionBlock->getArray();
+
+        SP::DynamicalSystem ds1 = indexSet.properties(*ui).source;
+        SP::DynamicalSystem ds2 = indexSet.properties(*ui).target;
+
+        bool endl = false;
+        size_t posBlock = indexSet.properties(*ui).source_pos;
+        size_t pos_ds2 = indexSet.properties(*ui).target_pos;
+
+        pos = indexSet.properties(*ui).absolute_position;
+        _hBlockOffsets[indexSet.index(*ui)] = (size_t) Htriplet->nz;
+
+        for(SP::DynamicalSystem ds = ds1; !endl; ds = ds2, posBlock = pos_ds2)
+        {
+          endl = (ds == ds2);
+          size_t sizeDS = ds->dimension();
+
+          SecondOrderDS* sods = dynamic_cast<SecondOrderDS*>(ds.get());
+          if(sods && sods->boundaryConditions())
+          {
+            THROW_EXCEPTION("OSNSMatrix::fillH boundary conditions not yet implemented.");
+          }
+
+          abs_pos_ds = DSG.properties(DSG.descriptor(ds)).absolute_position;
+          _hDsPositions.push_back(abs_pos_ds);
+
+          const double* block = array + posBlock * sizeY;
+          for(size_t j = 0; j < sizeDS; ++j)
+            for(size_t i = 0; i < sizeY; ++i)
+              CSparseMatrix_entry(Htriplet, abs_pos_ds + j, pos + i, block[i + j * sizeY]);
+        }
+      }
+      _triplet_nzmax = NM_nnz(&H_NM);
+
+      // compress now and record where every assembled entry lands in the
+      // csc values array: cs_compress scatters the triplet entries in
+      // order, with one running cursor per column
+      CSparseMatrix* Hcsc = NM_csc(&H_NM);
+      _hCscMap.resize((size_t) Htriplet->nz);
+      std::vector<CS_INT> cursor(Hcsc->p, Hcsc->p + _dimColumn);
+      for(CS_INT k = 0; k < Htriplet->nz; ++k)
+        _hCscMap[(size_t) k] = (size_t) cursor[Htriplet->p[k]]++;
+
+      // the csc becomes the authoritative storage and the triplet is
+      // dropped; the numerics solvers work on the matrix in place
+      H_NM.matrix2->origin = NSM_CSC;
+      NM_clearTriplet(&H_NM);
+
+      recordBlockLayout(indexSet);
+    }
+  }
 
   DEBUG_END("void OSNSMatrix::fillH(SP::DynamicalSystemsGraph DSG, InteractionsGraph& indexSet, bool update)\n");
 }
@@ -27,6 +27,10 @@
 #include "SimulationTypeDef.hpp"
 #include "NumericsMatrix.h" // for NM_types
 
+#include <set>
+#include <utility>
+#include <vector>
+
 /**
    Interface to some specific storage types for matrices used in
    OneStepNSProblem
@@ -117,6 +121,67 @@ protected:
       (_storageType = NM_SPARSE_BLOCK) */
   SP::BlockCSRMatrix _M2;
 
+  /** true if fillM may repack only the blocks marked dirty when the
+      layout of the index set has not changed */
+  bool _incrementalFill = false;
+
+  /** cross-block pruning settings forwarded to _M2 before each fill
+      (NM_SPARSE_BLOCK storage only), see setBlockPruning() */
+  double _blockPruningThreshold = 0.;
+  bool _pruneStaticCrossBlocks = false;
+
+  /** high-water mark (in number of elements) of the dense storage, kept
+      across assemblies so that size changes reuse the same buffer */
+  size_t _denseCapacity = 0;
+
+  /** when > 0, the dense storage is released once the assembled size
+      falls below this fraction of the high-water capacity; 0 (default)
+      means the buffer never shrinks */
+  double _denseShrinkRatio = 0.;
+
+  /** layout of the last assembly: (interaction number, absolute position)
+      in index set order, used to detect structural changes */
+  std::vector<std::pair<size_t, unsigned int>> _blockLayout;
+
+  /** numbers of the interactions whose blocks must be repacked on the
+      next incremental fill */
+  std::set<size_t> _dirtyBlocks;
+
+  /** persistent H assembly: start, in assembly order, of the entries of
+      each interaction, indexed by its vertex index in the index set */
+  std::vector<size_t> _hBlockOffsets;
+
+  /** persistent H assembly: destination in the csc values array of each
+      entry, in assembly order; empty when no layout has been recorded */
+  std::vector<size_t> _hCscMap;
+
+  /** persistent H assembly: absolute positions of the dynamical systems
+      visited during the last assembly, completing _blockLayout on the
+      column side for the detection of structural changes */
+  std::vector<unsigned int> _hDsPositions;
+
+  /** resize the dense storage _M1 to the assembled dimensions without
+   *  reallocating when they fit in the high-water capacity; see
+   *  setDenseShrinkRatio()
+   *
+   *  \param nr number of rows
+   *  \param nc number of columns
+   */
+  void resizeDenseStorage(unsigned int nr, unsigned int nc);
+
+  /** check whether the index set still matches the recorded layout
+   *
+   *  \param indexSet the index set of the active constraints
+   *  \return true if vertices and positions are unchanged
+   */
+  bool sameBlockLayout(InteractionsGraph& indexSet) const;
+
+  /** record the layout of the current assembly
+   *
+   *  \param indexSet the index set of the active constraints
+   */
+  void recordBlockLayout(InteractionsGraph& indexSet);
+
   /** For each Interaction in the graph, compute its absolute position
    * 
    *  \param indexSet the index set ot the concerned interactios.
@@ -251,6 +316,56 @@ public:
    */
   virtual void fillM(InteractionsGraph&indexSet, bool update = true);
 
+  /** enable or disable incremental assembly: when enabled and the index
+   *  set layout is unchanged, fillM repacks only the blocks marked dirty
+   *  with markBlockDirty() (dense storage only)
+   *
+   *  \param incremental true to enable
+   */
+  inline void setIncrementalFill(bool incremental)
+  {
+    _incrementalFill = incremental;
+  };
+
+  /** configure the cross-block pruning of the sparse-block assembly
+   *  (NM_SPARSE_BLOCK storage only), see
+   *  BlockCSRMatrix::setBlockPruningThreshold() and
+   *  BlockCSRMatrix::setPruneStaticCrossBlocks()
+   *
+   *  \param threshold magnitude threshold under which an off-diagonal
+   *  block pair is dropped (0 keeps every block)
+   *  \param pruneStatic true to also drop the blocks of pairs that only
+   *  couple through systems fully clamped by boundary conditions
+   */
+  inline void setBlockPruning(double threshold, bool pruneStatic)
+  {
+    _blockPruningThreshold = threshold;
+    _pruneStaticCrossBlocks = pruneStatic;
+  };
+
+  /** flag the blocks of an interaction (and of its incident edges) for
+   *  repacking on the next incremental fill
+   *
+   *  \param interactionNumber Interaction::number() of the changed interaction
+   */
+  inline void markBlockDirty(size_t interactionNumber)
+  {
+    _dirtyBlocks.insert(interactionNumber);
+  };
+
+  /** set the shrink threshold of the dense storage. The buffer grows to
+   *  the high-water mark of the assembled sizes and is reused as the
+   *  problem dimension fluctuates (contact churn); it is released only
+   *  when the assembled size falls below ratio * capacity. A ratio of 0
+   *  (the default) keeps the high-water buffer forever.
+   *
+   *  \param ratio shrink threshold in [0,1)
+   */
+  inline void setDenseShrinkRatio(double ratio)
+  {
+    _denseShrinkRatio = ratio;
+  };
+
 
   /** Compute the M matrix given the inverse of W and H
    * 
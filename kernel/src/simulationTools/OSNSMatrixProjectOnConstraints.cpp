@@ -106,7 +106,7 @@ void OSNSMatrixProjectOnConstraints::fillM(InteractionsGraph& indexSet, bool upd
       else
       {
         if(_M1->size(0) != _dimRow || _M1->size(1) != _dimColumn)
-          _M1->resize(_dimRow, _dimColumn);
+          resizeDenseStorage(_dimRow, _dimColumn);
         _M1->zero();
       }
     }
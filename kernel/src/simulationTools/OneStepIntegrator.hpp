@@ -411,6 +411,14 @@ public:
 
   virtual void prepareNewtonIteration(double time) = 0;
 
+  /** notification that the simulation time step h has been changed
+   *  (adaptive time-stepping, see TimeStepping::setAdaptiveTimeStep).
+   *  Integrators holding h-dependent data (iteration matrices and their
+   *  factorizations) refresh -- or swap from an h-keyed cache -- here;
+   *  default: nothing to do.
+   */
+  virtual void timeStepChanged() {};
+
   /** print the data to the screen
    */
   virtual void display() = 0;
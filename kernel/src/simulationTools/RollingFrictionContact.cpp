@@ -105,16 +105,30 @@ void RollingFrictionContact::initialize(SP::Simulation sim)
 
 void RollingFrictionContact::updateMu()
 {
-  _mu->clear();
-  _muR->clear();
+  // Coefficients are written by position: mu[k] must describe the contact
+  // whose rows start at position k * _contactProblemDim, and positions from
+  // the persistent layout (InteractionsGraph::updateStablePositions) are
+  // not a monotone function of the iteration order.
   SP::InteractionsGraph indexSet = simulation()->indexSet(indexSetLevel());
+
+  // skip the gather when neither the layout nor any law parameter changed
+  if(indexSet->stableLayout.revision == _muLayoutRevision
+      && NonSmoothLaw::parametersRevision() == _muLawRevision
+      && _mu->size() == indexSet->size())
+    return;
+  _muLayoutRevision = indexSet->stableLayout.revision;
+  _muLawRevision = NonSmoothLaw::parametersRevision();
+
+  _mu->assign(indexSet->size(), 0.0);
+  _muR->assign(indexSet->size(), 0.0);
   InteractionsGraph::VIterator ui, uiend;
   for(std::tie(ui, uiend) = indexSet->vertices(); ui != uiend; ++ui)
   {
-    _mu->push_back(std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
-                   (indexSet->bundle(*ui)->nonSmoothLaw())->mu());
-    _muR->push_back(std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
-                    (indexSet->bundle(*ui)->nonSmoothLaw())->muR());
+    unsigned int k = indexSet->properties(*ui).absolute_position / _contactProblemDim;
+    (*_mu)[k] = std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
+                (indexSet->bundle(*ui)->nonSmoothLaw())->mu();
+    (*_muR)[k] = std::static_pointer_cast<NewtonImpactRollingFrictionNSL>
+                 (indexSet->bundle(*ui)->nonSmoothLaw())->muR();
   }
 }
 
@@ -79,6 +79,11 @@ protected:
   /** * friction coefficients */
   SP::MuStorage _muR;
 
+  /** revisions the flat mu/muR arrays were last built for, see
+   * FrictionContact::_muLayoutRevision */
+  std::size_t _muLayoutRevision = SIZE_MAX;
+  std::size_t _muLawRevision = SIZE_MAX;
+
   /** Pointer to the function used to call the Numerics driver to solve the
    * problem */
   RollingDriver _rolling_frictionContact_driver;
@@ -24,6 +24,8 @@
 #include "Relation.hpp"
 #include "EventsManager.hpp"
 #include "LagrangianDS.hpp"
+#include "NewtonEulerDS.hpp"
+#include "FirstOrderNonLinearDS.hpp"
 
 // One Step Integrators
 #include "OneStepIntegrator.hpp"
@@ -42,6 +44,19 @@
 #include "siconos_debug.h"
 #include <fstream>
 
+/* the order of registration must match the Simulation::SimulationPhase enum */
+static SP::SimulationPhaseTimers buildPhaseTimers()
+{
+  SP::SimulationPhaseTimers timers(new SimulationPhaseTimers());
+  timers->addPhase("prepare");
+  timers->addPhase("computeFreeState");
+  timers->addPhase("OSNSProblem");
+  timers->addPhase("updateInput");
+  timers->addPhase("updateState");
+  timers->addPhase("updateOutput");
+  return timers;
+}
+
 // --- Constructor with a TimeDiscretisation (and thus a NonSmoothDynamicalSystem) and an
 // --- id ---
 Simulation::Simulation(SP::NonSmoothDynamicalSystem nsds, SP::TimeDiscretisation td):
@@ -49,6 +64,7 @@ Simulation::Simulation(SP::NonSmoothDynamicalSystem nsds, SP::TimeDiscretisation
   _nsds(nsds),
   _numberOfIndexSets(0),
   _tolerance(DEFAULT_TOLERANCE), _printStat(false),
+  _phaseTimers(buildPhaseTimers()),
   _staticLevels(false),_isInitialized(false)
 {
   if(!td)
@@ -75,6 +91,7 @@ Simulation::Simulation(SP::TimeDiscretisation td):
   _name("unnamed"), _tinit(0.0), _tend(0.0), _tout(0.0), _T(0.0),
   _numberOfIndexSets(0),
   _tolerance(DEFAULT_TOLERANCE), _printStat(false),
+  _phaseTimers(buildPhaseTimers()),
   _staticLevels(false), _useRelativeConvergenceCriterion(false),
   _relativeConvergenceCriterionHeld(false), _relativeConvergenceTol(10e-3),
   _isInitialized(false)
@@ -131,6 +148,97 @@ bool Simulation::hasNextEvent() const
   return _eventsManager->hasNextEvent();
 }
 
+void Simulation::recordStateMemorySwap(double time)
+{
+  // No duplicate filtering: several swaps may happen at the same instant
+  // (pre- and post-impact saves of an EventDriven nonsmooth event) and
+  // each one rotates the memories, so each one gets its time entry.
+  _stepTimeMemory.push_front(time);
+  while(_stepTimeMemory.size() > _stepTimeMemoryDepth)
+    _stepTimeMemory.pop_back();
+}
+
+SP::SiconosVector Simulation::stateAt(double time, DynamicalSystem& ds) const
+{
+  // Pick the state/derivative memory pair of this kind of system. The
+  // derivative histories are the ones the integrators already maintain:
+  // no extra per-step work is required for second-order systems.
+  const SiconosMemory* stateMemory = nullptr;
+  const SiconosMemory* derivativeMemory = nullptr;
+  Type::Siconos dsType = Type::value(ds);
+  if(dsType == Type::LagrangianDS || dsType == Type::LagrangianLinearTIDS
+      || dsType == Type::LagrangianLinearDiagonalDS)
+  {
+    LagrangianDS& d = static_cast<LagrangianDS&>(ds);
+    stateMemory = &d.qMemory();
+    derivativeMemory = &d.velocityMemory();
+  }
+  else if(dsType == Type::NewtonEulerDS)
+  {
+    NewtonEulerDS& d = static_cast<NewtonEulerDS&>(ds);
+    stateMemory = &d.qMemory();
+    derivativeMemory = &d.dotqMemory();
+  }
+  else
+  {
+    // first-order systems: the rhs history is opt-in, see
+    // FirstOrderNonLinearDS::setRetainRhsInMemory
+    FirstOrderNonLinearDS& d = static_cast<FirstOrderNonLinearDS&>(ds);
+    stateMemory = &d.xMemory();
+    if(d.rhsMemory().nbVectorsInMemory() > 0)
+      derivativeMemory = &d.rhsMemory();
+  }
+
+  // _stepTimeMemory[i] is the time of memory slot i, most recent first;
+  // only the slots a time was recorded for are usable (the swaps done
+  // at initialization predate the recording).
+  std::size_t known = std::min<std::size_t>(stateMemory->nbVectorsInMemory(),
+                      _stepTimeMemory.size());
+  if(known < 2)
+    THROW_EXCEPTION("Simulation::stateAt - less than two saved steps, no interpolation window yet.");
+  if(time > _stepTimeMemory[0] || time < _stepTimeMemory[known - 1])
+    THROW_EXCEPTION("Simulation::stateAt - time outside the retained history window; enlarge it with DynamicalSystem::setStepsInMemory().");
+
+  // find i such that _stepTimeMemory[i+1] <= time <= _stepTimeMemory[i]
+  std::size_t i = 0;
+  while(i + 2 < known && time < _stepTimeMemory[i + 1]) ++i;
+
+  double t1 = _stepTimeMemory[i];      // newer end of the bracket
+  double t0 = _stepTimeMemory[i + 1];  // older end
+  const SiconosVector& x1 = stateMemory->getSiconosVector(i);
+  const SiconosVector& x0 = stateMemory->getSiconosVector(i + 1);
+  SP::SiconosVector state(new SiconosVector(x1.size()));
+
+  double h = t1 - t0;
+  if(h <= 0.0)  // degenerate bracket (two saves at the same instant)
+  {
+    *state = x1;
+    return state;
+  }
+  double s = (time - t0) / h;
+
+  if(derivativeMemory && derivativeMemory->nbVectorsInMemory() > i + 1
+      && derivativeMemory->getSiconosVector(i).size() == x1.size())
+  {
+    // cubic Hermite basis on [t0, t1]
+    const SiconosVector& v1 = derivativeMemory->getSiconosVector(i);
+    const SiconosVector& v0 = derivativeMemory->getSiconosVector(i + 1);
+    double s2 = s * s, s3 = s2 * s;
+    double h00 = 2. * s3 - 3. * s2 + 1., h10 = s3 - 2. * s2 + s;
+    double h01 = -2. * s3 + 3. * s2, h11 = s3 - s2;
+    for(unsigned int k = 0; k < x1.size(); ++k)
+      (*state)(k) = h00 * x0(k) + h * h10 * v0(k)
+                    + h01 * x1(k) + h * h11 * v1(k);
+  }
+  else
+  {
+    // no derivative history retained: linear interpolation
+    for(unsigned int k = 0; k < x1.size(); ++k)
+      (*state)(k) = (1. - s) * x0(k) + s * x1(k);
+  }
+  return state;
+}
+
 
 // clear all maps to break shared_ptr cycle
 void Simulation::clear()
@@ -186,8 +294,16 @@ void Simulation::updateIndexSets()
     for(unsigned int i = 1; i < nindexsets ; ++i)
     {
       updateIndexSet(i);
-      _nsds->topology()->indexSet(i)->update_vertices_indices();
-      _nsds->topology()->indexSet(i)->update_edges_indices();
+      // The index sets are maintained incrementally (copy_vertex /
+      // remove_vertex in updateIndexSet) and are identical between most
+      // steps. Renumber the vertices and edges -- and thereby bump the
+      // graph stamp, which invalidates every property attached to the
+      // graph -- only when this pass really changed the set.
+      if(_nsds->topology()->hasChanged())
+      {
+        _nsds->topology()->indexSet(i)->update_vertices_indices();
+        _nsds->topology()->indexSet(i)->update_edges_indices();
+      }
     }
   }
   DEBUG_END("Simulation::updateIndexSets()\n");
@@ -509,8 +625,17 @@ int Simulation::computeOneStepNSProblem(int Id)
     }
   }
 
+  // Time the solve twice: once in the aggregated OSNSProblem phase, once
+  // in a phase dedicated to this problem id (registered on first use).
+  unsigned int phaseId = _phaseTimers->addPhase("OSNSProblem_" + std::to_string(Id));
+  std::uint64_t start = SimulationPhaseTimers::now();
+
   int info = (*_allNSProblems)[Id]->compute(nextTime());
 
+  std::uint64_t ticks = SimulationPhaseTimers::now() - start;
+  _phaseTimers->accumulate(PHASE_OSNS, ticks);
+  _phaseTimers->accumulate(phaseId, ticks);
+
   DEBUG_END("Simulation::computeOneStepNSProblem(int Id)\n");
   return info;
 }
@@ -579,6 +704,13 @@ void Simulation::run()
     advanceToEvent();
     processEvents();
     count++;
+    if(monitorAbortRequested())
+    {
+      std::cout << "===== " << Type::name(*this)
+                << " simulation aborted by the monitor at time "
+                << startingTime() << ". ====" <<std::endl;
+      break;
+    }
   }
   std::cout << "===== End of " << Type::name(*this) << " simulation. " << count << " events have been processed. ==== " <<std::endl;
 }
@@ -588,6 +720,11 @@ void Simulation::processEvents()
   DEBUG_BEGIN("void Simulation::processEvents()\n");
   _eventsManager->processEvents(*this);
 
+  // the monitor samples quantities the step has already produced; an
+  // unmonitored run skips this entirely
+  if(_monitor)
+    _monitor->sample(*this, startingTime());
+
   // if(_eventsManager->hasNextEvent())
   // {
   //   // For TimeStepping Scheme, need to update IndexSets, but not for EventDriven scheme
@@ -645,6 +782,7 @@ void Simulation::computeResidu()
 void Simulation::updateInput(unsigned int)
 {
   DEBUG_BEGIN("Simulation::updateInput()\n");
+  SimulationPhaseScope phaseScope(*_phaseTimers, PHASE_UPDATE_INPUT);
   OSIIterator itOSI;
   // 1 - compute input (lambda -> r)
   if(!_allNSProblems->empty())
@@ -659,6 +797,7 @@ void Simulation::updateInput(unsigned int)
 void Simulation::updateState(unsigned int)
 {
   DEBUG_BEGIN("Simulation::updateState()\n");
+  SimulationPhaseScope phaseScope(*_phaseTimers, PHASE_UPDATE_STATE);
   OSIIterator itOSI;
   // 2 - compute state for each dynamical system
   for(itOSI = _allOSI->begin(); itOSI != _allOSI->end() ; ++itOSI)
@@ -673,6 +812,7 @@ void Simulation::updateState(unsigned int)
 void Simulation::updateOutput(unsigned int)
 {
   DEBUG_BEGIN("Simulation::updateOutput()\n");
+  SimulationPhaseScope phaseScope(*_phaseTimers, PHASE_UPDATE_OUTPUT);
 
   // 3 - compute output ( x ... -> y)
   if(!_allNSProblems->empty())
@@ -26,8 +26,11 @@
 #include "SimulationTypeDef.hpp"
 #include "SiconosFwd.hpp"
 #include <fstream>
+#include <deque>
 #include "NonSmoothDynamicalSystem.hpp"
 #include "InteractionManager.hpp"
+#include "SimulationPhaseTimers.hpp"
+#include "SimulationMonitor.hpp"
 
 /**
    Description of the simulation process (integrators, time
@@ -93,6 +96,14 @@ protected:
   /** Output setup: if true, display solver stats */
   bool _printStat;
 
+  /** per-phase timers accumulated along the hot path (always on, the
+      cost of a timed scope is a few nanoseconds) */
+  SP::SimulationPhaseTimers _phaseTimers;
+
+  /** in-loop watches, sampled after each processed event; allocated on
+      first access to monitor() so an unmonitored run pays nothing */
+  SP::SimulationMonitor _monitor;
+
   /** _staticLevels : do not recompute levels once they have been
    * initialized */
   bool _staticLevels;
@@ -125,6 +136,17 @@ protected:
   /** map of not-yet-initialized DS variables for each OSI */
   std::map< SP::OneStepIntegrator, std::list<SP::DynamicalSystem> >  _OSIDSmap;
 
+  /** times of the state-memory swaps, most recent first: entry i is the
+      time the vectors at index i of the DS state memories were saved
+      at. Written by the events that call
+      NonSmoothDynamicalSystem::swapInMemory(); read by stateAt(). */
+  std::deque<double> _stepTimeMemory;
+
+  /** retention depth of _stepTimeMemory; raise it together with
+      DynamicalSystem::setStepsInMemory() when a longer dense-output
+      window is needed */
+  std::size_t _stepTimeMemoryDepth = 64;
+
 
 private:
 
@@ -246,6 +268,44 @@ public:
   */
   bool hasNextEvent() const;
 
+  /** record that the state memories were just saved at the given time;
+      called by the events that trigger
+      NonSmoothDynamicalSystem::swapInMemory(), once per swap so the
+      time ring stays aligned with the memory slots.
+
+      \param time the time the saved states refer to
+  */
+  void recordStateMemorySwap(double time);
+
+  /** set the retention depth of the step-time ring used by stateAt()
+
+      \param depth number of step times kept (default 64)
+  */
+  inline void setStepTimeMemoryDepth(std::size_t depth)
+  {
+    _stepTimeMemoryDepth = depth;
+  }
+
+  /** dense output: evaluate the (position-level) state of a dynamical
+      system at an arbitrary time inside the retained history window,
+      without stepping.
+
+      A cubic Hermite interpolant is built between the two saved steps
+      bracketing the given time, from the state and state-derivative
+      histories the integrators already maintain: q/velocity for
+      Lagrangian systems, q/dotq for Newton-Euler systems, x/rhs for
+      first-order systems (call
+      FirstOrderNonLinearDS::setRetainRhsInMemory(true) before
+      initialization, otherwise the interpolation degrades to linear).
+      Enlarge the window with DynamicalSystem::setStepsInMemory().
+
+      \param time the query time; must lie between the oldest and the
+      most recent saved step, otherwise an exception is thrown
+      \param ds the dynamical system whose state is queried
+      \return a new vector holding the interpolated state
+  */
+  SP::SiconosVector stateAt(double time, DynamicalSystem& ds) const;
+
   /** get all the Integrators of the Simulation
    *
    *  \return an OSISset
@@ -373,6 +433,41 @@ public:
     return _printStat;
   };
 
+  /** indices of the phases registered by the Simulation constructor in
+      phaseTimers(); additional phases may be registered with
+      SimulationPhaseTimers::addPhase */
+  enum SimulationPhase
+  {
+    PHASE_PREPARE,
+    PHASE_FREE_STATE,
+    PHASE_OSNS,
+    PHASE_UPDATE_INPUT,
+    PHASE_UPDATE_STATE,
+    PHASE_UPDATE_OUTPUT
+  };
+
+  /** \return the per-phase timers of the hot path
+   */
+  inline SP::SimulationPhaseTimers phaseTimers() const
+  {
+    return _phaseTimers;
+  };
+
+  /** \return the in-loop monitor, created on first access; its watches
+      are sampled after each processed event */
+  SP::SimulationMonitor monitor()
+  {
+    if(!_monitor) _monitor.reset(new SimulationMonitor());
+    return _monitor;
+  };
+
+  /** \return true when a triggered watch of the monitor has requested an
+      abort; checked by run() after each event */
+  inline bool monitorAbortRequested() const
+  {
+    return _monitor && _monitor->abortRequested();
+  };
+
   /** 
       update all index sets of the topology, using current y and lambda values of Interactions
    */
@@ -0,0 +1,126 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include "SimulationGraphs.hpp"
+#include "Interaction.hpp"
+#include "NonSmoothLaw.hpp"
+
+#include <algorithm>
+
+unsigned int InteractionsGraph::updateStablePositions()
+{
+  // Collect the members of the set in index order (the order normally
+  // reproduces the storage order, but may have been renumbered spatially,
+  // see Topology::reorderByMortonCode).  Newcomers are assigned in that
+  // order so that a fresh layout follows the index order exactly.
+  std::vector<VDescriptor> vds;
+  vds.reserve(size());
+  VIterator vd, vdend;
+  for(std::tie(vd, vdend) = vertices(); vd != vdend; ++vd)
+    vds.push_back(*vd);
+  std::stable_sort(vds.begin(), vds.end(),
+                   [this](const VDescriptor& a, const VDescriptor& b)
+                   { return index(a) < index(b); });
+
+  StablePositionLayout& layout = stableLayout;
+  bool changed = false;
+
+  // Release the slots of interactions that have left the set since the
+  // previous call; their positions become available for newcomers of the
+  // same size.
+  {
+    std::map<size_t, std::pair<unsigned int, unsigned int> > keep;
+    for(const VDescriptor& v : vds)
+    {
+      size_t number = bundle(v)->number();
+      auto it = layout.slots.find(number);
+      if(it != layout.slots.end())
+        keep.insert(*it);
+    }
+    for(const auto& slot : layout.slots)
+    {
+      if(keep.find(slot.first) == keep.end())
+      {
+        layout.freePositions[slot.second.second].push_back(slot.second.first);
+        changed = true;
+      }
+    }
+    layout.slots.swap(keep);
+  }
+
+  // Assign newcomers: reuse a released slot of the exact size when one is
+  // available, append at the end otherwise.
+  for(const VDescriptor& v : vds)
+  {
+    size_t number = bundle(v)->number();
+    if(layout.slots.find(number) != layout.slots.end())
+      continue;
+    changed = true;
+    unsigned int nslawSize = bundle(v)->nonSmoothLaw()->size();
+    auto freeIt = layout.freePositions.find(nslawSize);
+    if(freeIt != layout.freePositions.end() && !freeIt->second.empty())
+    {
+      layout.slots[number] = std::make_pair(freeIt->second.back(), nslawSize);
+      freeIt->second.pop_back();
+    }
+    else
+    {
+      layout.slots[number] = std::make_pair(layout.dim, nslawSize);
+      layout.dim += nslawSize;
+    }
+  }
+
+  // The layout must stay gapless: a hole would put zero rows in the
+  // assembled OSNS problem.  When slots remain free (net removal, or a
+  // newcomer whose size did not match any released slot), compact from the
+  // first hole upward; positions below it are left untouched, and trailing
+  // holes cost nothing but the dimension update.
+  bool hasFree = false;
+  for(const auto& freeList : layout.freePositions)
+    if(!freeList.second.empty())
+    {
+      hasFree = true;
+      break;
+    }
+  if(hasFree)
+  {
+    std::vector<std::pair<unsigned int, size_t> > byPosition;
+    byPosition.reserve(layout.slots.size());
+    for(const auto& slot : layout.slots)
+      byPosition.push_back(std::make_pair(slot.second.first, slot.first));
+    std::sort(byPosition.begin(), byPosition.end());
+
+    unsigned int pos = 0;
+    for(const auto& entry : byPosition)
+    {
+      std::pair<unsigned int, unsigned int>& slot = layout.slots[entry.second];
+      slot.first = pos;
+      pos += slot.second;
+    }
+    layout.dim = pos;
+    layout.freePositions.clear();
+  }
+
+  if(changed)
+    ++layout.revision;
+
+  // Publish the positions on the graph properties.
+  for(const VDescriptor& v : vds)
+    properties(v).absolute_position = layout.slots[bundle(v)->number()].first;
+
+  return layout.dim;
+}
@@ -28,7 +28,11 @@
 #include "SiconosPointers.hpp"
 #include "SiconosFwd.hpp" // for SP::DynamicalSystem, ...
 #include "SiconosAlgebraTypeDef.hpp" // for VectorOfVectors, ...
+#include "SiconosVisitor.hpp" // for Type::Siconos (cached ds type)
 #include "SimulationTypeDef.hpp"
+#include <map> // for the vertex colors of parallelForIndependentVertices
+#include <tuple> // for std::tie
+#include <vector>
 
 /** the graph structure :
  *
@@ -86,6 +90,14 @@ struct InteractionProperties
   SP::VectorOfBlockVectors workBlockVectors;     /**< set of BlockVector, used as buffers in OneStepIntegrator classes. */
   SP::VectorOfSMatrices workMatrices;  /**< Internal buffers used on simulation size, to store jacobians or other temporary matrices. */
 
+  bool output_uptodate = false;        /**< true if y matches the state versions and time below, so that
+                                          NonSmoothDynamicalSystem::updateOutput may skip the interaction */
+  size_t output_source_version = 0;    /**< state version of source at the last output computation */
+  size_t output_target_version = 0;    /**< state version of target at the last output computation */
+  double output_time = 0.;             /**< time of the last output computation */
+  unsigned int output_level_min = 0;   /**< level range of the last output computation */
+  unsigned int output_level_max = 0;
+
   ACCEPT_SERIALIZATION(InteractionProperties);
 };
 
@@ -100,7 +112,14 @@ struct DynamicalSystemProperties
   SP::SimpleMatrix W;                     /**< Matrix for integration */
   SP::SimpleMatrix WBoundaryConditions;   /**< Matrix for integration of boundary conditions*/
   SP::SimpleMatrix Winverse;              /**< Matrix for integration */
+  SP::SimpleMatrix Wlast;                 /**< scratch for the recomputed iteration matrix, used to
+                                               keep the stored factors of W when its values did not
+                                               move between two Newton iterations */
   unsigned int absolute_position;         /**< Absolute position of the ds variables in the unknown vector in osnsp*/
+  Type::Siconos ds_type = Type::void_type; /**< Cached Type::Siconos of the bundled DynamicalSystem, filled by the
+                                              Topology when the vertex is inserted: the hot per-step loops of the
+                                              integrators switch on it instead of paying the virtual dispatch of
+                                              Type::value() on every access. void_type means "not cached". */
 //  SP::SiconosMemory _xMemory            /**< old value of x, TBD */
 
   ACCEPT_SERIALIZATION(DynamicalSystemProperties);
@@ -188,30 +207,208 @@ struct DynamicalSystemsGraph : public _DynamicalSystemsGraph
 struct InteractionsGraph : public _InteractionsGraph
 {
   /** optional properties : memory is allocated only on first access */
+  /* the blockProj family is traversed per vertex and per edge in the
+     assembly loops of MLCPProjectOnConstraints: it uses the dense,
+     index-backed variant of the property maps */
   INSTALL_GRAPH_PROPERTIES(Interactions,
-                           ((Vertex, SP::SimpleMatrix, blockProj))        // ProjectOnConstraint
-                           ((Edge, SP::SimpleMatrix, upper_blockProj))    // idem
-                           ((Edge, SP::SimpleMatrix, lower_blockProj))  // idem
+                           ((IndexedVertex, SP::SimpleMatrix, blockProj))      // ProjectOnConstraint
+                           ((IndexedEdge, SP::SimpleMatrix, upper_blockProj))  // idem
+                           ((IndexedEdge, SP::SimpleMatrix, lower_blockProj))  // idem
                            ((Vertex, std::string, name)));
 
   // to be installed with INSTALL_GRAPH_PROPERTIES
   void eraseProperties(_InteractionsGraph::VDescriptor vd)
   {
-    blockProj._store->erase(vd);
+    blockProj.erase(vd);
     name._store->erase(vd);
   }
 
   // to be installed with INSTALL_GRAPH_PROPERTIES
   void eraseProperties(_InteractionsGraph::EDescriptor ed)
   {
-    upper_blockProj._store->erase(ed);
-    lower_blockProj._store->erase(ed);
+    upper_blockProj.erase(ed);
+    lower_blockProj.erase(ed);
   }
 
-  
+  /** Persistent position layout used by updateStablePositions().
+   *
+   *  It remembers the offset handed to each interaction so that positions
+   *  survive index-set rebuilds: an interaction keeps its slot as long as it
+   *  stays in the set, and a released slot is recycled for a newcomer of the
+   *  same size before the problem is grown at the end.
+   */
+  struct StablePositionLayout
+  {
+    /** interaction number -> (absolute position, nslaw size) */
+    std::map<size_t, std::pair<unsigned int, unsigned int> > slots;
+    /** size class -> positions released by departed interactions */
+    std::map<unsigned int, std::vector<unsigned int> > freePositions;
+    /** current problem dimension */
+    unsigned int dim = 0;
+    /** bumped whenever membership or any position changes, so that
+     *  per-position caches (flattened law parameters, scatter plans)
+     *  know when to rebuild */
+    std::size_t revision = 0;
+  };
+
+  /** state of the stable layout; reset it to start from a fresh numbering
+   *  (e.g. after a spatial reordering of the graph) */
+  StablePositionLayout stableLayout;
+
+  /** Assign a stable absolute_position to every interaction of the graph.
+   *
+   *  Interactions already present keep their previous position; newcomers
+   *  reuse the slot of a departed interaction of the same size when one is
+   *  available, and are appended at the end otherwise.  Holes left by a net
+   *  removal are compacted (the layout must stay gapless, otherwise the
+   *  assembled OSNS problem would contain zero rows), but only positions at
+   *  or above the first hole move.
+   *
+   *  \return the total dimension of the assembled problem
+   */
+  unsigned int updateStablePositions();
+
   ACCEPT_SERIALIZATION(InteractionsGraph);
 };
 
+/** Apply a functor to every vertex of a graph, in parallel when OpenMP is
+ *  enabled.
+ *
+ *  The vertex descriptors are collected up front so that the functor can be
+ *  run concurrently: the functor must not add or remove vertices, and must
+ *  only write to data owned by its own vertex (its bundle and properties).
+ *
+ *  \param graph a DynamicalSystemsGraph, InteractionsGraph ...
+ *  \param fun functor called as fun(vd) on each vertex descriptor
+ */
+template<typename G, typename F>
+void parallelForVertices(G& graph, F&& fun)
+{
+  std::vector<typename G::VDescriptor> vds;
+  vds.reserve(graph.size());
+  typename G::VIterator vi, viend;
+  for(std::tie(vi, viend) = graph.vertices(); vi != viend; ++vi)
+    vds.push_back(*vi);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(vds.size()); ++i)
+    fun(vds[i]);
+}
+
+/** Group the vertices of a graph into conflict-free batches: each vertex
+ *  takes the smallest color unused by its neighbours (greedy coloring), so
+ *  that two adjacent vertices never end up in the same batch.
+ *
+ *  The result may be cached by the caller and replayed with
+ *  parallelForVertexBatches as long as the graph structure does not change.
+ *
+ *  \param graph a DynamicalSystemsGraph, InteractionsGraph ...
+ *  \return the batches, indexed by color
+ */
+template<typename G>
+std::vector<std::vector<typename G::VDescriptor> > independentVertexBatches(G& graph)
+{
+  std::vector<typename G::VDescriptor> vds;
+  vds.reserve(graph.size());
+  typename G::VIterator vi, viend;
+  for(std::tie(vi, viend) = graph.vertices(); vi != viend; ++vi)
+    vds.push_back(*vi);
+
+  std::map<typename G::VDescriptor, unsigned int> colors;
+  unsigned int numberOfColors = 0;
+  std::vector<bool> usedByNeighbours;
+  for(const auto& vd : vds)
+  {
+    usedByNeighbours.assign(numberOfColors, false);
+    typename G::AVIterator avi, aviend;
+    for(std::tie(avi, aviend) = graph.adjacent_vertices(vd); avi != aviend; ++avi)
+    {
+      auto cit = colors.find(*avi);
+      if(cit != colors.end())
+        usedByNeighbours[cit->second] = true;
+    }
+    unsigned int color = 0;
+    while(color < numberOfColors && usedByNeighbours[color]) ++color;
+    if(color == numberOfColors) ++numberOfColors;
+    colors[vd] = color;
+  }
 
+  std::vector<std::vector<typename G::VDescriptor> > batches(numberOfColors);
+  for(const auto& vd : vds)
+    batches[colors[vd]].push_back(vd);
+  return batches;
+}
+
+/** Apply a functor to every vertex of precomputed conflict-free batches,
+ *  one batch after the other, each batch in parallel when OpenMP is
+ *  enabled.
+ *
+ *  \param batches vertex batches built by independentVertexBatches
+ *  \param fun functor called as fun(vd) on each vertex descriptor
+ */
+template<typename VD, typename F>
+void parallelForVertexBatches(const std::vector<std::vector<VD> >& batches, F&& fun)
+{
+  for(const auto& batch : batches)
+  {
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(batch.size()); ++i)
+      fun(batch[i]);
+  }
+}
+
+/** Conflict-free batches of independentVertexBatches together with the
+ *  graph stamp they were built against, so that a caller on a hot path can
+ *  keep them across calls.  Topology bumps the stamp (through
+ *  update_vertices_indices) whenever it edits a graph, the same signal
+ *  SiconosProperties uses to invalidate its data.
+ */
+template<typename G>
+struct IndependentVertexBatches
+{
+  std::vector<std::vector<typename G::VDescriptor> > batches;
+  int stamp = 0;
+  bool built = false;
+};
+
+/** Apply a functor to every vertex of a graph, in parallel when OpenMP is
+ *  enabled, with the guarantee that two adjacent vertices are never
+ *  processed concurrently.
+ *
+ *  The vertices are grouped into conflict-free batches and the batches are
+ *  processed one after the other, each one in parallel.  In the
+ *  interactions graph an edge means a shared dynamical system, so this
+ *  allows the functor to accumulate into per-DS vectors (e.g. p) without
+ *  any locking.  The batches live in the caller-supplied cache and are
+ *  rebuilt only when the graph stamp changed; without OpenMP there is
+ *  nothing to decouple and the vertices are visited in a plain loop.
+ *
+ *  \param graph a DynamicalSystemsGraph, InteractionsGraph ...
+ *  \param cache batches kept across calls, owned by the caller
+ *  \param fun functor called as fun(vd) on each vertex descriptor
+ */
+template<typename G, typename F>
+void parallelForIndependentVertices(G& graph, IndependentVertexBatches<G>& cache,
+                                    F&& fun)
+{
+#if defined(_OPENMP)
+  if(!cache.built || cache.stamp != graph.stamp())
+  {
+    cache.batches = independentVertexBatches(graph);
+    cache.stamp = graph.stamp();
+    cache.built = true;
+  }
+  parallelForVertexBatches(cache.batches, std::forward<F>(fun));
+#else
+  (void)cache;
+  typename G::VIterator vi, viend;
+  for(std::tie(vi, viend) = graph.vertices(); vi != viend; ++vi)
+    fun(*vi);
+#endif
+}
 
 #endif
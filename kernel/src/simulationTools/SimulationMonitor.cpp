@@ -0,0 +1,116 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include "SimulationMonitor.hpp"
+#include "Simulation.hpp"
+#include "NonSmoothDynamicalSystem.hpp"
+#include "SimulationGraphs.hpp"
+#include "SecondOrderDS.hpp"
+#include "LagrangianDS.hpp"
+#include "NewtonEulerDS.hpp"
+#include "OneStepNSProblem.hpp"
+#include "SolverOptions.h"
+
+unsigned int SimulationMonitor::addWatch(const std::string& name, Sampler sampler,
+                                         double threshold, Callback onThreshold)
+{
+  Watch watch;
+  watch.name = name;
+  watch.sampler = sampler;
+  watch.threshold = threshold;
+  watch.onThreshold = onThreshold;
+  _watches.push_back(watch);
+  return _watches.size() - 1;
+}
+
+bool SimulationMonitor::sample(Simulation& simulation, double time)
+{
+  for(Watch& watch : _watches)
+  {
+    watch.lastValue = watch.sampler(simulation);
+    if(watch.lastValue > watch.threshold)
+    {
+      ++watch.triggerCount;
+      // an empty callback means "stop when the threshold is crossed"
+      Decision decision = watch.onThreshold ?
+                          watch.onThreshold(watch.lastValue, time) : ABORT;
+      if(decision == ABORT)
+        _abortRequested = true;
+    }
+  }
+  return !_abortRequested;
+}
+
+void SimulationMonitor::reset()
+{
+  for(Watch& watch : _watches)
+  {
+    watch.lastValue = 0.;
+    watch.triggerCount = 0;
+  }
+  _abortRequested = false;
+}
+
+double SimulationMonitor::maxVelocity(Simulation& simulation)
+{
+  double vmax = 0.;
+  DynamicalSystemsGraph& DSG0 =
+    *simulation.nonSmoothDynamicalSystem()->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = DSG0.vertices(); dsi != dsend; ++dsi)
+  {
+    SP::SecondOrderDS ds =
+      std::dynamic_pointer_cast<SecondOrderDS>(DSG0.bundle(*dsi));
+    if(ds && ds->velocity())
+    {
+      double v = ds->velocity()->normInf();
+      if(v > vmax) vmax = v;
+    }
+  }
+  return vmax;
+}
+
+double SimulationMonitor::kineticEnergy(Simulation& simulation)
+{
+  double energy = 0.;
+  DynamicalSystemsGraph& DSG0 =
+    *simulation.nonSmoothDynamicalSystem()->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = DSG0.vertices(); dsi != dsend; ++dsi)
+  {
+    SP::DynamicalSystem ds = DSG0.bundle(*dsi);
+    Type::Siconos dsType = Type::value(*ds);
+    if(dsType == Type::LagrangianDS || dsType == Type::LagrangianLinearTIDS
+        || dsType == Type::LagrangianLinearDiagonalDS)
+      energy += std::static_pointer_cast<LagrangianDS>(ds)->computeKineticEnergy();
+    else if(dsType == Type::NewtonEulerDS)
+      energy += std::static_pointer_cast<NewtonEulerDS>(ds)->computeKineticEnergy();
+  }
+  return energy;
+}
+
+double SimulationMonitor::lastOSNSResidual(Simulation& simulation)
+{
+  double residual = 0.;
+  for(const SP::OneStepNSProblem& osnsp : *simulation.oneStepNSProblems())
+  {
+    if(!osnsp) continue;
+    double r = osnsp->numericsSolverOptions()->dparam[SICONOS_DPARAM_RESIDU];
+    if(r > residual) residual = r;
+  }
+  return residual;
+}
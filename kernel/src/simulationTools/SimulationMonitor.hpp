@@ -0,0 +1,172 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*! \file SimulationMonitor.hpp
+  \brief In-loop watches over cheap scalar reductions of the simulation state
+*/
+
+#ifndef SIMULATIONMONITOR_HPP
+#define SIMULATIONMONITOR_HPP
+
+#include "SiconosPointers.hpp"
+
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+class Simulation;
+
+/** Watches over scalar reductions of the simulation state, sampled once
+ *  per step.
+ *
+ *  A watch is a named sampler -- a function pulling one scalar from
+ *  quantities the step has already computed (velocities, solver
+ *  residuals, energies) -- together with an optional threshold and
+ *  callback.  The simulation samples every watch at the end of each
+ *  processed event (see Simulation::processEvents); when a sampled value
+ *  exceeds its threshold the callback runs and decides whether the run
+ *  continues or aborts, so divergence and physical blowups are caught in
+ *  the loop instead of from the output files.  A callback is free to
+ *  trigger a checkpoint before returning.
+ *
+ *  Samplers must be cheap: they are pull-based reads of state the step
+ *  maintains anyway, not extra passes over the model.  Ready-made
+ *  samplers are provided for the maximum velocity norm, the total
+ *  kinetic energy and the last residual reported by the one-step
+ *  nonsmooth problems.
+ */
+class SimulationMonitor
+{
+public:
+
+  /** a sampler pulls one scalar from the simulation state */
+  typedef std::function<double(Simulation&)> Sampler;
+
+  /** decision returned by a threshold callback */
+  enum Decision
+  {
+    CONTINUE = 0,
+    ABORT = 1
+  };
+
+  /** called when a watch crosses its threshold, with the sampled value
+   *  and the current time */
+  typedef std::function<Decision(double, double)> Callback;
+
+  SimulationMonitor() = default;
+
+  /** register a watch
+   *
+   *  \param name the name of the watch
+   *  \param sampler the function pulling the watched scalar
+   *  \param threshold the watch triggers when the sample exceeds it
+   *  (default: never)
+   *  \param onThreshold callback run on trigger; when empty, a triggered
+   *  watch requests an abort
+   *  \return the index of the watch
+   */
+  unsigned int addWatch(const std::string& name, Sampler sampler,
+                        double threshold = std::numeric_limits<double>::infinity(),
+                        Callback onThreshold = Callback());
+
+  /** sample every watch and run the triggered callbacks
+   *
+   *  \param simulation the simulation to sample
+   *  \param time the current time, passed to the callbacks
+   *  \return false when a triggered watch requested an abort
+   */
+  bool sample(Simulation& simulation, double time);
+
+  /** \return the number of registered watches */
+  inline unsigned int numberOfWatches() const
+  {
+    return _watches.size();
+  }
+
+  /** \param watch the index of the watch
+   *  \return its name */
+  inline const std::string& name(unsigned int watch) const
+  {
+    return _watches[watch].name;
+  }
+
+  /** \param watch the index of the watch
+   *  \return the value of its last sample */
+  inline double lastValue(unsigned int watch) const
+  {
+    return _watches[watch].lastValue;
+  }
+
+  /** \param watch the index of the watch
+   *  \return how many samples exceeded the threshold */
+  inline unsigned int triggerCount(unsigned int watch) const
+  {
+    return _watches[watch].triggerCount;
+  }
+
+  /** \return true once a triggered watch has requested an abort */
+  inline bool abortRequested() const
+  {
+    return _abortRequested;
+  }
+
+  /** forget every sample and trigger (registered watches are kept) */
+  void reset();
+
+  // --- ready-made samplers ---
+
+  /** largest infinity norm of the velocities of the second-order systems
+   *  \param simulation the simulation to sample
+   *  \return the norm, 0 when no second-order system is present */
+  static double maxVelocity(Simulation& simulation);
+
+  /** total kinetic energy of the Lagrangian and Newton-Euler systems,
+   *  through their mass operators
+   *  \param simulation the simulation to sample
+   *  \return the energy */
+  static double kineticEnergy(Simulation& simulation);
+
+  /** largest residual reported by the one-step nonsmooth problems during
+   *  the last solve
+   *  \param simulation the simulation to sample
+   *  \return the residual, 0 when no problem has been solved */
+  static double lastOSNSResidual(Simulation& simulation);
+
+private:
+
+  struct Watch
+  {
+    std::string name;
+    Sampler sampler;
+    double threshold;
+    Callback onThreshold;
+    double lastValue = 0.;
+    unsigned int triggerCount = 0;
+  };
+
+  /** the registered watches, indexed by the value returned by addWatch */
+  std::vector<Watch> _watches;
+
+  /** true once a triggered watch has requested an abort */
+  bool _abortRequested = false;
+};
+
+TYPEDEF_SPTR(SimulationMonitor)
+
+#endif // SIMULATIONMONITOR_HPP
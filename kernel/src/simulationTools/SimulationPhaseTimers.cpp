@@ -0,0 +1,118 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "SimulationPhaseTimers.hpp"
+
+#include <chrono>
+#include <iostream>
+
+unsigned int SimulationPhaseTimers::addPhase(const std::string& name)
+{
+  for(unsigned int i = 0; i < _phases.size(); ++i)
+  {
+    if(_phases[i].name == name)
+      return i;
+  }
+  Phase p;
+  p.name = name;
+  _phases.push_back(p);
+  return _phases.size() - 1;
+}
+
+void SimulationPhaseTimers::stepDone()
+{
+  for(std::vector<Phase>::iterator it = _phases.begin(); it != _phases.end(); ++it)
+  {
+    it->lastStepTicks = it->stepTicks;
+    it->stepTicks = 0;
+  }
+  ++_steps;
+}
+
+void SimulationPhaseTimers::reset()
+{
+  for(std::vector<Phase>::iterator it = _phases.begin(); it != _phases.end(); ++it)
+  {
+    it->totalTicks = 0;
+    it->stepTicks = 0;
+    it->lastStepTicks = 0;
+    it->totalCalls = 0;
+  }
+  _steps = 0;
+}
+
+double SimulationPhaseTimers::seconds(std::uint64_t ticks)
+{
+  // The tick frequency is measured once, on the first conversion, by
+  // spinning for about a millisecond against the wall clock. The
+  // timestamp counter of every recent x86 processor is invariant, so a
+  // single calibration is enough.
+  static const double ticksPerSecond = []
+  {
+    using clock = std::chrono::steady_clock;
+    clock::time_point t0 = clock::now();
+    std::uint64_t c0 = now();
+    while(clock::now() - t0 < std::chrono::milliseconds(1));
+    std::uint64_t c1 = now();
+    std::chrono::duration<double> elapsed = clock::now() - t0;
+    return (double)(c1 - c0) / elapsed.count();
+  }();
+  return (double)ticks / ticksPerSecond;
+}
+
+std::uint64_t SimulationPhaseTimers::ticks(double secs)
+{
+  if(secs <= 0.) return 0;
+  // one tick is never zero seconds, so the ratio is well defined
+  return (std::uint64_t)(secs / seconds(1));
+}
+
+void SimulationPhaseTimers::writeCSV(std::ostream& os) const
+{
+  os << "phase,calls,total_seconds,last_step_seconds\n";
+  for(std::vector<Phase>::const_iterator it = _phases.begin(); it != _phases.end(); ++it)
+  {
+    os << it->name << "," << it->totalCalls << ","
+       << seconds(it->totalTicks) << "," << seconds(it->lastStepTicks) << "\n";
+  }
+}
+
+void SimulationPhaseTimers::writeJSON(std::ostream& os) const
+{
+  os << "[";
+  for(unsigned int i = 0; i < _phases.size(); ++i)
+  {
+    const Phase& p = _phases[i];
+    os << (i == 0 ? "" : ",") << "\n"
+       << "  {\"phase\": \"" << p.name << "\", "
+       << "\"calls\": " << p.totalCalls << ", "
+       << "\"total_seconds\": " << seconds(p.totalTicks) << ", "
+       << "\"last_step_seconds\": " << seconds(p.lastStepTicks) << "}";
+  }
+  os << "\n]\n";
+}
+
+void SimulationPhaseTimers::display() const
+{
+  std::cout << "=== SimulationPhaseTimers (" << _steps << " steps) ===" << std::endl;
+  for(std::vector<Phase>::const_iterator it = _phases.begin(); it != _phases.end(); ++it)
+  {
+    std::cout << "  " << it->name << ": " << seconds(it->totalTicks) << " s in "
+              << it->totalCalls << " calls" << std::endl;
+  }
+}
@@ -0,0 +1,206 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*! \file SimulationPhaseTimers.hpp
+  \brief Lightweight named timers for the phases of the simulation hot path
+*/
+
+#ifndef SIMULATIONPHASETIMERS_HPP
+#define SIMULATIONPHASETIMERS_HPP
+
+#include "SiconosPointers.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <x86intrin.h>  // for __rdtsc
+#define SICONOS_HAS_RDTSC
+#else
+#include <chrono>
+#endif
+
+/** Named phase timers accumulated along the simulation hot path.
+ *
+ *  Timestamps come from the time-stamp counter (rdtsc) when available,
+ *  so a timed scope costs a few nanoseconds and the timers can stay
+ *  compiled in. Each phase accumulates its tick total and call count
+ *  over the whole simulation and over the current time step; stepDone()
+ *  closes the current step. Results can be queried directly (in ticks or
+ *  in seconds, through a frequency calibrated against the wall clock) or
+ *  exported with writeCSV/writeJSON.
+ *
+ *  The phases of TimeStepping::computeOneStep are registered by the
+ *  Simulation constructor (see Simulation::SimulationPhase for their
+ *  indices); integrators or nonsmooth problems may register additional
+ *  phases with addPhase() and time their own scopes with
+ *  SimulationPhaseScope.
+ */
+class SimulationPhaseTimers
+{
+public:
+
+  SimulationPhaseTimers() = default;
+
+  /** read the timestamp counter
+   *  \return the current time, in ticks
+   */
+  static inline std::uint64_t now()
+  {
+#ifdef SICONOS_HAS_RDTSC
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+  }
+
+  /** register a phase, or retrieve an already registered one
+   *  \param name the name of the phase
+   *  \return the index of the phase
+   */
+  unsigned int addPhase(const std::string& name);
+
+  /** add a measured duration to a phase
+   *  \param phase the index of the phase, as returned by addPhase
+   *  \param ticks the duration, in ticks
+   */
+  inline void accumulate(unsigned int phase, std::uint64_t ticks)
+  {
+    Phase& p = _phases[phase];
+    p.totalTicks += ticks;
+    p.stepTicks += ticks;
+    ++p.totalCalls;
+  }
+
+  /** close the current time step: the per-step counters of every phase
+   *  are stored as the last-step values and reset */
+  void stepDone();
+
+  /** forget every measurement (registered phases are kept) */
+  void reset();
+
+  /** \return the number of registered phases */
+  inline unsigned int numberOfPhases() const
+  {
+    return _phases.size();
+  }
+
+  /** \param phase the index of the phase
+   *  \return its name */
+  inline const std::string& name(unsigned int phase) const
+  {
+    return _phases[phase].name;
+  }
+
+  /** \param phase the index of the phase
+   *  \return the ticks accumulated since the beginning (or reset()) */
+  inline std::uint64_t totalTicks(unsigned int phase) const
+  {
+    return _phases[phase].totalTicks;
+  }
+
+  /** \param phase the index of the phase
+   *  \return the number of times the phase was timed */
+  inline std::uint64_t totalCalls(unsigned int phase) const
+  {
+    return _phases[phase].totalCalls;
+  }
+
+  /** \param phase the index of the phase
+   *  \return the ticks accumulated during the last closed step */
+  inline std::uint64_t lastStepTicks(unsigned int phase) const
+  {
+    return _phases[phase].lastStepTicks;
+  }
+
+  /** \return the number of closed steps */
+  inline std::uint64_t numberOfSteps() const
+  {
+    return _steps;
+  }
+
+  /** convert a tick count into seconds, using a tick frequency
+   *  calibrated against the wall clock on the first call
+   *  \param ticks a duration in ticks
+   *  \return the duration in seconds
+   */
+  static double seconds(std::uint64_t ticks);
+
+  /** convert a duration in seconds into a tick count, with the same
+   *  calibrated frequency as seconds()
+   *  \param seconds a duration in seconds
+   *  \return the duration in ticks
+   */
+  static std::uint64_t ticks(double seconds);
+
+  /** write one csv line per phase: name,calls,total_seconds,last_step_seconds
+   *  \param os the output stream
+   */
+  void writeCSV(std::ostream& os) const;
+
+  /** write the phases as a json array of objects with the same fields as
+   *  the csv output
+   *  \param os the output stream
+   */
+  void writeJSON(std::ostream& os) const;
+
+  /** print the accumulated times on standard output */
+  void display() const;
+
+private:
+
+  struct Phase
+  {
+    std::string name;
+    std::uint64_t totalTicks = 0;
+    std::uint64_t stepTicks = 0;
+    std::uint64_t lastStepTicks = 0;
+    std::uint64_t totalCalls = 0;
+  };
+
+  /** the registered phases, indexed by the value returned by addPhase */
+  std::vector<Phase> _phases;
+
+  /** number of closed steps */
+  std::uint64_t _steps = 0;
+};
+
+/** Scope guard adding its own lifetime to one phase of a
+ *  SimulationPhaseTimers. */
+class SimulationPhaseScope
+{
+public:
+  SimulationPhaseScope(SimulationPhaseTimers& timers, unsigned int phase):
+    _timers(timers), _phase(phase), _start(SimulationPhaseTimers::now()) {}
+
+  ~SimulationPhaseScope()
+  {
+    _timers.accumulate(_phase, SimulationPhaseTimers::now() - _start);
+  }
+
+private:
+  SimulationPhaseTimers& _timers;
+  unsigned int _phase;
+  std::uint64_t _start;
+};
+
+TYPEDEF_SPTR(SimulationPhaseTimers)
+
+#endif // SIMULATIONPHASETIMERS_HPP
@@ -122,6 +122,18 @@ void TimeDiscretisation::setTkVector(const TkVector& newTk)
   _tkV = newTk;
 }
 
+void TimeDiscretisation::setCurrentTimeStep(unsigned int k, double newH)
+{
+  if(!_tkV.empty())
+    THROW_EXCEPTION("TimeDiscretisation::setCurrentTimeStep must be called only when the TimeDiscretisation is with a constant h");
+  if(hGmp())
+    THROW_EXCEPTION("TimeDiscretisation::setCurrentTimeStep is not implemented for a TimeDiscretisation using GMP");
+  assert(newH > 0.);
+  // keep t_k in place: rebase the origin so that _t0 + k*newH == t_k
+  _t0 = getTk(k) - newH * k;
+  _h = newH;
+}
+
 void TimeDiscretisation::setT0(double val)
 {
   _t0 = val;
@@ -204,6 +204,20 @@ public:
    */
   void setTkVector(const TkVector& newTk);
 
+  /** change the constant time step h during the simulation.
+   *
+   *  The grid is rebased so that \f$ t_k \f$ keeps its current value and
+   *  every future instant is \f$ t_k + (i-k)\,h_{new} \f$: the past is
+   *  rewritten (getTk for indices below k uses the new h), which is
+   *  harmless for a running simulation since only current and future
+   *  instants are queried. Only for constant-h discretisations (h and t0
+   *  constructors, no tk vector, no GMP).
+   *
+   *  \param k the index of the current time instant, which must not move
+   *  \param newH the new value of h
+   */
+  void setCurrentTimeStep(unsigned int k, double newH);
+
   /** change t0 before the simulation starts (useful for delays)
    *
    *  \param val the new value for t0
@@ -40,6 +40,7 @@ void TimeDiscretisationEvent::process(Simulation& simulation)
 
   simulation.nonSmoothDynamicalSystem()->swapInMemory();  // To save pre-impact values
   simulation.nonSmoothDynamicalSystem()->pushInteractionsInMemory();  // To save pre-impact values
+  simulation.recordStateMemorySwap(getDoubleTimeOfEvent());  // timestamp for dense output
 
 }
 
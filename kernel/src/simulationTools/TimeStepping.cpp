@@ -29,15 +29,28 @@
 #include "EventsManager.hpp"
 #include "FrictionContact.hpp"
 #include "FirstOrderNonLinearDS.hpp"
+#include "SecondOrderDS.hpp" // for the speculative detection snapshot
+#include "InteractionManager.hpp"
 #include "NonSmoothLaw.hpp"
 #include "TypeName.hpp"
 #include "Relation.hpp"
+#include "SolverOptions.h" // for SolverOptions, SICONOS_IPARAM_*
+#include "LinearOSNS.hpp" // for the across-iterations warm start
 #include "BlockVector.hpp"
 #include "NewtonEulerR.hpp"
 #include "FirstOrderR.hpp"
 
+#include "SiconosException.hpp"
+
+#include "SiconosMemory.hpp" // for the step rejection rollback
+#include "SiconosAllocationTracker.hpp" // for the per-step allocation report
+
 #include <SiconosConfig.h>
+#include <algorithm>  // for std::min, std::max (step controller)
+#include <fstream>    // for std::ofstream, std::ifstream (step journal)
 #include <functional>
+#include <iomanip>    // for std::setprecision
+#include <sstream>    // for std::istringstream
 using namespace std::placeholders;
 
 // #define DEBUG_BEGIN_END_ONLY
@@ -373,16 +386,160 @@ void TimeStepping::nextStep()
 void TimeStepping::computeFreeState()
 {
   DEBUG_BEGIN("TimeStepping::computeFreeState()\n");
+  SimulationPhaseScope phaseScope(*_phaseTimers, PHASE_FREE_STATE);
   std::for_each(_allOSI->begin(), _allOSI->end(), std::bind(&OneStepIntegrator::computeFreeState, _1));
   DEBUG_END("TimeStepping::computeFreeState()\n");
 }
 
+TimeStepping::~TimeStepping() noexcept
+{
+  /* a speculative detection may still be in flight when the simulation
+   * is destroyed between two steps */
+  if(_speculationPending)
+    _speculativeDetection.join();
+}
+
+void TimeStepping::startSpeculativeInteractionUpdate()
+{
+  if(!_pipelinedInteractionUpdate || !_interman
+      || !_interman->supportsSpeculativeUpdateInteractions())
+    return;
+
+  /* snapshot the configuration the detection is run with */
+  _speculativeState.clear();
+  DynamicalSystemsGraph& dsg = *_nsds->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator dsi, dsiend;
+  for(std::tie(dsi, dsiend) = dsg.vertices(); dsi != dsiend; ++dsi)
+  {
+    SP::DynamicalSystem ds = dsg.bundle(*dsi);
+    SecondOrderDS* sods = dynamic_cast<SecondOrderDS*>(ds.get());
+    _speculativeState.emplace(ds->number(), sods ? *sods->q() : *ds->x());
+  }
+
+  SP::Simulation simulation = shared_from_this();
+  InteractionManager& interman = *_interman;
+  _speculativeDetection = std::thread([&interman, simulation]()
+  {
+    interman.detectInteractions(simulation);
+  });
+  _speculationPending = true;
+}
+
+bool TimeStepping::finishSpeculativeInteractionUpdate()
+{
+  if(!_speculationPending)
+    return false;
+
+  _speculativeDetection.join();
+  _speculationPending = false;
+
+  /* the detection stays usable if no system has moved further than the
+   * margin since the snapshot */
+  bool valid = true;
+  DynamicalSystemsGraph& dsg = *_nsds->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator dsi, dsiend;
+  for(std::tie(dsi, dsiend) = dsg.vertices(); valid && dsi != dsiend; ++dsi)
+  {
+    SP::DynamicalSystem ds = dsg.bundle(*dsi);
+    SecondOrderDS* sods = dynamic_cast<SecondOrderDS*>(ds.get());
+    const SiconosVector& state = sods ? *sods->q() : *ds->x();
+
+    std::map<size_t, SiconosVector>::const_iterator it =
+      _speculativeState.find(ds->number());
+    if(it == _speculativeState.end() || it->second.size() != state.size())
+    {
+      valid = false;
+      break;
+    }
+    for(unsigned int i = 0; i < state.size(); ++i)
+    {
+      if(fabs(state(i) - it->second(i)) > _pipelineValidationMargin)
+      {
+        valid = false;
+        break;
+      }
+    }
+  }
+
+  if(valid)
+    _interman->commitInteractions(shared_from_this());
+  else
+    DEBUG_PRINT("TimeStepping::finishSpeculativeInteractionUpdate mispredict, falling back to the synchronous update\n");
+
+  return valid;
+}
+
 // compute simulation between current and next event.  Initial
 // DS/interaction state is given by memory vectors and final state is
 // the one saved in DS/Interaction at the end of this function
 void TimeStepping::computeOneStep()
 {
+  if(_realTimeMode)
+  {
+    _realTimeDeadline = SimulationPhaseTimers::now()
+                        + SimulationPhaseTimers::ticks(_realTimeBudget);
+    _realTimeQuality = REALTIME_STEP_FULL;
+  }
+  Siconos::alloc::beginStep();
   advanceToEvent();
+  Siconos::alloc::endStep();
+  _phaseTimers->stepDone();
+}
+
+void TimeStepping::setRealTimeMode(double stepBudget, double pressureFraction)
+{
+  assert(stepBudget > 0.);
+  assert(pressureFraction > 0. && pressureFraction < 1.);
+  _realTimeMode = true;
+  _realTimeBudget = stepBudget;
+  _realTimePressureFraction = pressureFraction;
+  _realTimeQuality = REALTIME_STEP_FULL;
+}
+
+void TimeStepping::unsetRealTimeMode()
+{
+  _realTimeMode = false;
+  _realTimeDeadline = 0;
+}
+
+void TimeStepping::realTimeThrottle(std::uint64_t lastSolveTicks,
+                                    int lastSolveIterations)
+{
+  std::uint64_t now = SimulationPhaseTimers::now();
+  if(now >= _realTimeDeadline) return;
+  double remaining = SimulationPhaseTimers::seconds(_realTimeDeadline - now);
+  if(remaining >= _realTimePressureFraction * _realTimeBudget) return;
+
+  // under pressure: the relation residuals refine the convergence test
+  // but are not needed to produce the iterate
+  if(_computeResiduY || _computeResiduR)
+  {
+    _computeResiduY = false;
+    _computeResiduR = false;
+  }
+  if(_realTimeQuality == REALTIME_STEP_FULL)
+    _realTimeQuality = REALTIME_STEP_DEGRADED;
+
+  // cap the nonsmooth solver iterations from the remaining budget and
+  // the measured cost per iteration of its previous call; the solver
+  // gets at most half of what is left, the rest of the iteration
+  // (update of inputs, states and outputs) needs its share too
+  if(_allNSProblems->empty() || lastSolveIterations <= 0) return;
+  SP::SolverOptions opts =
+    (*_allNSProblems)[SICONOS_OSNSP_TS_VELOCITY]->numericsSolverOptions();
+  if(!opts) return;
+  double perIteration =
+    SimulationPhaseTimers::seconds(lastSolveTicks) / lastSolveIterations;
+  if(perIteration <= 0.) return;
+  int cap = (int)(0.5 * remaining / perIteration);
+  if(cap < 1) cap = 1;
+  if(cap < opts->iparam[SICONOS_IPARAM_MAX_ITER])
+  {
+    if(_realTimeSavedMaxIter < 0)
+      _realTimeSavedMaxIter = opts->iparam[SICONOS_IPARAM_MAX_ITER];
+    opts->iparam[SICONOS_IPARAM_MAX_ITER] = cap;
+    DEBUG_PRINTF("TimeStepping::realTimeThrottle cap = %i\n", cap);
+  }
 }
 
 
@@ -419,13 +576,242 @@ void TimeStepping::resetLambdas()
   }
 }
 
+bool TimeStepping::expressSignatureMatches() const
+{
+  return _expressSigDS == _nsds->dynamicalSystems()->vertices_number()
+         && _expressSigInter == _nsds->topology()->indexSet0()->vertices_number()
+         && _expressSigEdges == _nsds->topology()->indexSet0()->edges_number();
+}
+
+void TimeStepping::expressStepDone()
+{
+  if(_expressThreshold == 0)
+    return;
+
+  if(expressSignatureMatches())
+  {
+    if(++_expressStableSteps >= _expressThreshold)
+      _expressActive = true;
+  }
+  else
+  {
+    _expressSigDS = _nsds->dynamicalSystems()->vertices_number();
+    _expressSigInter = _nsds->topology()->indexSet0()->vertices_number();
+    _expressSigEdges = _nsds->topology()->indexSet0()->edges_number();
+    _expressStableSteps = 0;
+  }
+}
+
+void TimeStepping::setExpressMode(unsigned int nbStableSteps)
+{
+  assert(nbStableSteps >= 1);
+  _expressThreshold = nbStableSteps;
+  _expressStableSteps = 0;
+  _expressActive = false;
+}
+
+void TimeStepping::unsetExpressMode()
+{
+  _expressThreshold = 0;
+  invalidateExpressMode();
+}
+
 void TimeStepping::advanceToEvent()
 {
   DEBUG_PRINTF("TimeStepping::advanceToEvent(). Time =%f\n",getTkp1());
-  initialize();
+  if(_expressActive && expressSignatureMatches())
+  {
+    // express pipeline: the structure is frozen, only the numeric part
+    // of the step preamble runs. The interaction detection, the index
+    // set updates and the OSNS (re)initialization -- and the forced
+    // topology-changed flag initOSNS raises, which makes the OSNS
+    // problems rebuild their matrices -- are all skipped, so the
+    // problems keep their symbolic data from the last full step.
+    updateOutput();
+  }
+  else
+  {
+    if(_expressActive)
+    {
+      // structural change detected while frozen: drop the frozen
+      // structure and go through the full pipeline again
+      invalidateExpressMode();
+    }
+    initialize();
+    expressStepDone();
+  }
   if (!_skip_resetLambdas)
     resetLambdas();
-  newtonSolve(_newtonTolerance, _newtonMaxIteration);
+  if(_adaptiveTimeStep)
+    newtonSolveWithStepControl();
+  else
+    newtonSolve(_newtonTolerance, _newtonMaxIteration);
+  if(_journalStream)
+    journalRecordStep();
+}
+
+void TimeStepping::setAdaptiveTimeStep(double hMin, double hMax)
+{
+  assert(hMin > 0. && hMin <= hMax);
+  if(_newtonOptions != SICONOS_TS_NONLINEAR)
+    THROW_EXCEPTION("TimeStepping::setAdaptiveTimeStep, the step controller reads the residuals of the nonlinear Newton loop: it requires the SICONOS_TS_NONLINEAR option");
+  const TimeDiscretisation& td = _eventsManager->timeDiscretisation();
+  if(!td.hConst() || td.hGmp())
+    THROW_EXCEPTION("TimeStepping::setAdaptiveTimeStep requires a constant-h TimeDiscretisation ((t0, h) constructors, no tk vector, no GMP)");
+  _adaptiveTimeStep = true;
+  _adaptiveHMin = hMin;
+  _adaptiveHMax = hMax;
+  _adaptiveSmoothSteps = 0;
+  _adaptiveGrowPending = false;
+}
+
+void TimeStepping::applyTimeStep(double newH)
+{
+  DEBUG_PRINTF("TimeStepping::applyTimeStep() newH = %g\n", newH);
+  // rebase the discretisation and the pending events, t_k stays in place
+  _eventsManager->updateCurrentTimeStep(newH);
+  // the integrators keep h-parameterized caches of their iteration
+  // matrices: swapping is (much) cheaper than rebuilding
+  for(OSIIterator it = _allOSI->begin(); it != _allOSI->end(); ++it)
+    (*it)->timeStepChanged();
+}
+
+void TimeStepping::rejectStep()
+{
+  DEBUG_BEGIN("TimeStepping::rejectStep()\n");
+  DynamicalSystemsGraph& dsg = *_nsds->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = dsg.vertices(); dsi != dsend; ++dsi)
+  {
+    SP::DynamicalSystem ds = dsg.bundle(*dsi);
+    SecondOrderDS* sods = dynamic_cast<SecondOrderDS*>(ds.get());
+    if(sods)
+    {
+      // nothing to roll back before the first swap (first simulation step)
+      if(sods->qMemory().nbVectorsInMemory() == 0) continue;
+      *sods->q() = sods->qMemory().getSiconosVector(0);
+      *sods->velocity() = sods->velocityMemory().getSiconosVector(0);
+    }
+    else
+    {
+      if(ds->xMemory().nbVectorsInMemory() == 0) continue;
+      *ds->x() = ds->xMemory().getSiconosVector(0);
+    }
+    ds->bumpStateVersion();
+  }
+  DEBUG_END("TimeStepping::rejectStep()\n");
+}
+
+void TimeStepping::newtonSolveWithStepControl()
+{
+  // a growth decided at the end of the previous step is applied here,
+  // before the step starts, where t_k is the only grid point in use
+  double h = _eventsManager->currentTimeStep();
+  if(_adaptiveGrowPending)
+  {
+    _adaptiveGrowPending = false;
+    applyTimeStep(std::min(2. * h, _adaptiveHMax));
+    h = _eventsManager->currentTimeStep();
+  }
+
+  while(true)
+  {
+    newtonSolve(_newtonTolerance, _newtonMaxIteration);
+
+    // the Newton residual machinery is the error estimator: the step is
+    // accepted when the loop converged, or when it cannot be refined
+    // further
+    if(_isNewtonConverge || h <= _adaptiveHMin * (1. + 1e-12))
+    {
+      if(!_isNewtonConverge && _warnOnNonConvergence)
+        std::cout << "[kernel][warning] TimeStepping::newtonSolveWithStepControl -- accepting a non-converged step at hMin = " << h << std::endl;
+
+      // a smooth phase shows as steps solved well within the iteration
+      // cap: after a run of them, grow h (at the beginning of the next
+      // step)
+      if(_isNewtonConverge && 2 * _newtonNbIterations <= _newtonMaxIteration)
+        ++_adaptiveSmoothSteps;
+      else
+        _adaptiveSmoothSteps = 0;
+      if(_adaptiveSmoothSteps >= 3 && h < _adaptiveHMax)
+      {
+        _adaptiveGrowPending = true;
+        _adaptiveSmoothSteps = 0;
+      }
+      break;
+    }
+
+    // rejected: roll the state back to t_k and redo the step with h/2
+    ++_adaptiveRejectedSteps;
+    _adaptiveSmoothSteps = 0;
+    DEBUG_PRINTF("TimeStepping::newtonSolveWithStepControl() step rejected, h = %g\n", h);
+    rejectStep();
+    applyTimeStep(std::max(0.5 * h, _adaptiveHMin));
+    h = _eventsManager->currentTimeStep();
+    if(!_skip_resetLambdas)
+      resetLambdas();
+  }
+}
+
+void TimeStepping::enableStepJournal(const std::string& filename,
+                                     unsigned int checkpointPeriod)
+{
+  _journalStream.reset(new std::ofstream(filename, std::ios::trunc));
+  if(!_journalStream->is_open())
+    THROW_EXCEPTION("TimeStepping::enableStepJournal, cannot open journal file " + filename);
+  _journalStep = 0;
+  _journalCheckpointPeriod = checkpointPeriod;
+  // one header line so the journal is self-describing
+  *_journalStream << "# step time newtonIterations residuDS residuY residuR checkpoint\n";
+}
+
+void TimeStepping::journalRecordStep()
+{
+  ++_journalStep;
+
+  bool checkpoint = _journalCheckpointPeriod > 0 && _journalCheckpointHook
+                    && (_journalStep % _journalCheckpointPeriod == 0);
+  if(checkpoint)
+    _journalCheckpointHook(_journalStep, getTkp1());
+
+  *_journalStream << _journalStep << ' '
+                  << std::setprecision(17) << getTkp1() << ' '
+                  << _newtonNbIterations << ' '
+                  << _newtonResiduDSMax << ' '
+                  << _newtonResiduYMax << ' '
+                  << _newtonResiduRMax << ' '
+                  << (checkpoint ? 1 : 0) << '\n';
+  // flush each record: the journal is precisely for inspecting runs that
+  // die, a buffered tail would lose the interesting steps
+  _journalStream->flush();
+}
+
+long TimeStepping::journalLastCheckpointBefore(const std::string& filename,
+                                               unsigned long targetStep)
+{
+  std::ifstream journal(filename);
+  if(!journal.is_open())
+    THROW_EXCEPTION("TimeStepping::journalLastCheckpointBefore, cannot open journal file " + filename);
+
+  long lastCheckpoint = -1;
+  std::string line;
+  while(std::getline(journal, line))
+  {
+    if(line.empty() || line[0] == '#')
+      continue;
+    std::istringstream record(line);
+    unsigned long step;
+    double time, residuDS, residuY, residuR;
+    unsigned int newtonIterations, checkpoint;
+    if(!(record >> step >> time >> newtonIterations
+         >> residuDS >> residuY >> residuR >> checkpoint))
+      break; // truncated record (e.g. the run died while writing): stop here
+    if(step > targetStep)
+      break;
+    if(checkpoint)
+      lastCheckpoint = (long)step;
+  }
+  return lastCheckpoint;
 }
 
 /*update of the nabla */
@@ -433,6 +819,7 @@ void TimeStepping::advanceToEvent()
 void   TimeStepping::prepareNewtonIteration()
 {
   DEBUG_BEGIN("TimeStepping::prepareNewtonIteration()\n");
+  SimulationPhaseScope phaseScope(*_phaseTimers, PHASE_PREPARE);
   double tkp1 = getTkp1();
   for(OSIIterator itosi = _allOSI->begin();
       itosi != _allOSI->end(); ++itosi)
@@ -513,9 +900,18 @@ void TimeStepping::computeInitialNewtonState()
 void TimeStepping::initializeNewtonLoop()
 {
   DEBUG_BEGIN("TimeStepping::initializeNewtonLoop()\n");
+  SimulationPhaseScope phaseScope(*_phaseTimers, PHASE_PREPARE);
   double tkp1 = getTkp1();
   assert(!std::isnan(tkp1));
 
+  // A new step starts from swapped state memories, and the user may have
+  // modified states between two steps: mark every (tracked) state as
+  // changed so that no output computation is skipped on stale values.
+  DynamicalSystemsGraph& DSG0 = *_nsds->dynamicalSystems();
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = DSG0.vertices(); dsi != dsend; ++dsi)
+    DSG0.bundle(*dsi)->bumpStateVersion();
+
   if(_newtonOptions == SICONOS_TS_NONLINEAR)
   {
     //  Compute the initial state for the Newton loop
@@ -532,8 +928,13 @@ void TimeStepping::initializeNewtonLoop()
     // Predictive contact -- update initial contacts after updating DS positions
     // for the Newton loop
     // allow the InteractionManager to add/remove any interactions it wants
+    // A speculative detection launched during the previous solve must be
+    // joined and validated before the world moves, since the worker reads
+    // the shape positions.
+    bool speculationCommitted = finishSpeculativeInteractionUpdate();
     updateWorldFromDS();
-    updateInteractions();
+    if(!speculationCommitted)
+      updateInteractions();
 
     // Changes in updateInteractions may require initialization
     initializeNSDSChangelog();
@@ -603,6 +1004,10 @@ void TimeStepping::newtonSolve(double criterion, unsigned int maxStep)
 
   initializeNewtonLoop();
 
+  // overlap the collision detection of the next step with the solve: the
+  // world stays at the current configuration for the whole Newton loop
+  startSpeculativeInteractionUpdate();
+
   if((_newtonOptions == SICONOS_TS_LINEAR || _newtonOptions == SICONOS_TS_LINEAR_IMPLICIT)
       || isLinear)
   {
@@ -636,10 +1041,50 @@ void TimeStepping::newtonSolve(double criterion, unsigned int maxStep)
 
   else if(_newtonOptions == SICONOS_TS_NONLINEAR)
   {
+    // real-time mode bookkeeping: per-iteration and per-solve costs are
+    // measured on the fly, the residual flags and the solver iteration
+    // cap are restored once the loop is done
+    bool savedResiduY = _computeResiduY;
+    bool savedResiduR = _computeResiduR;
+    std::uint64_t iterationTicks = 0;
+    std::uint64_t solveTicks = 0;
+    int solveIterations = 0;
+
+    // across-iterations warm start and inexact Newton laddering both
+    // steer the velocity problem from here, iteration by iteration
+    SP::LinearOSNS velocityOSNS;
+    if((_warmStartNewtonIterations || _inexactNewtonFactor > 0.)
+        && !_allNSProblems->empty())
+      velocityOSNS = std::dynamic_pointer_cast<LinearOSNS>(
+                       (*_allNSProblems)[SICONOS_OSNSP_TS_VELOCITY]);
+    double savedSolverTol = -1.;
+    if(velocityOSNS && _inexactNewtonFactor > 0.)
+      savedSolverTol = velocityOSNS->numericsSolverOptions()->dparam[SICONOS_DPARAM_TOL];
+
     //  while((!_isNewtonConverge)&&(_newtonNbIterations < maxStep)&&(!info))
     //_isNewtonConverge = newtonCheckConvergence(criterion);
     while((!_isNewtonConverge) && (_newtonNbIterations < maxStep))
     {
+      std::uint64_t iterationStart = 0;
+      if(_realTimeMode)
+      {
+        iterationStart = SimulationPhaseTimers::now();
+        // guaranteed progress: the first iteration always runs; further
+        // ones only start while the remaining budget covers the
+        // measured cost of the previous one
+        if(_newtonNbIterations > 0
+            && (iterationStart >= _realTimeDeadline
+                || _realTimeDeadline - iterationStart < iterationTicks))
+        {
+          _realTimeQuality = REALTIME_STEP_TRUNCATED;
+          if(_warnOnNonConvergence)
+            std::cout << "[kernel][warning] TimeStepping::newtonSolve -- wall-clock budget exhausted after "
+                      << _newtonNbIterations << " iterations, keeping the best iterate" << std::endl;
+          break;
+        }
+        realTimeThrottle(solveTicks, solveIterations);
+      }
+
       _newtonNbIterations++;
       info=0;
 
@@ -662,7 +1107,31 @@ void TimeStepping::newtonSolve(double criterion, unsigned int maxStep)
       bool hasNSProblems = (!_allNSProblems->empty()) ? true : false;
       if(hasNSProblems)
       {
+        if(velocityOSNS)
+        {
+          // from the second iteration on the previous iterate is a far
+          // better initial guess than the state of the previous step
+          if(_warmStartNewtonIterations)
+            velocityOSNS->setWarmStartFromCurrentState(_newtonNbIterations > 1);
+          if(savedSolverTol >= 0.)
+          {
+            // solve loosely while the Newton residual is large; the
+            // first iteration has no residual yet and uses the loosest
+            // rung of the ladder
+            double rung = _newtonNbIterations > 1 ?
+                          _inexactNewtonFactor * _newtonResiduDSMax : _inexactNewtonTolMax;
+            velocityOSNS->numericsSolverOptions()->dparam[SICONOS_DPARAM_TOL] =
+              std::max(savedSolverTol, std::min(_inexactNewtonTolMax, rung));
+          }
+        }
+        std::uint64_t solveStart = _realTimeMode ? SimulationPhaseTimers::now() : 0;
         info = computeOneStepNSProblem(SICONOS_OSNSP_TS_VELOCITY);
+        if(_realTimeMode)
+        {
+          solveTicks = SimulationPhaseTimers::now() - solveStart;
+          solveIterations = (*_allNSProblems)[SICONOS_OSNSP_TS_VELOCITY]
+                            ->numericsSolverOptions()->iparam[SICONOS_IPARAM_ITER_DONE];
+        }
         // Check output from solver (convergence or not ...)
         if(!checkSolverOutput)
           DefaultCheckSolverOutput(info);
@@ -686,17 +1155,88 @@ void TimeStepping::newtonSolve(double criterion, unsigned int maxStep)
       _isNewtonConverge = newtonCheckConvergence(criterion);
 
       displayNewtonConvergenceInTheLoop();
+
+      if(_realTimeMode)
+        iterationTicks = SimulationPhaseTimers::now() - iterationStart;
     } // End of the Newton Loop
 
+    // leave the velocity problem the way the step found it
+    if(velocityOSNS)
+    {
+      velocityOSNS->setWarmStartFromCurrentState(false);
+      if(savedSolverTol >= 0.)
+        velocityOSNS->numericsSolverOptions()->dparam[SICONOS_DPARAM_TOL] = savedSolverTol;
+    }
+
+    // restore what the real-time throttling may have changed
+    _computeResiduY = savedResiduY;
+    _computeResiduR = savedResiduR;
+    if(_realTimeSavedMaxIter >= 0)
+    {
+      (*_allNSProblems)[SICONOS_OSNSP_TS_VELOCITY]->numericsSolverOptions()
+        ->iparam[SICONOS_IPARAM_MAX_ITER] = _realTimeSavedMaxIter;
+      _realTimeSavedMaxIter = -1;
+    }
+
     _newtonCumulativeNbIterations += _newtonNbIterations;
 
     displayNewtonConvergenceAtTheEnd(info, maxStep);
   }
   else
     THROW_EXCEPTION("TimeStepping::NewtonSolve failed. Unknown newtonOptions: " + std::to_string(_newtonOptions));
+
+  if(_adaptSolverParameters)
+    adaptSolverParameters();
+
   DEBUG_END("TimeStepping::newtonSolve(double criterion, unsigned int maxStep)\n");
 }
 
+void TimeStepping::setAdaptSolverParameters(double tolMin, double tolMax)
+{
+  assert(tolMin > 0. && tolMin <= tolMax);
+  _adaptSolverParameters = true;
+  _adaptTolMin = tolMin;
+  _adaptTolMax = tolMax;
+  _adaptNewtonMaxIterationCap = 10 * _newtonMaxIteration;
+  _adaptEasySteps = 0;
+}
+
+void TimeStepping::adaptSolverParameters()
+{
+  if(_allNSProblems->size() <= SICONOS_OSNSP_TS_VELOCITY) return;
+  SP::OneStepNSProblem osnsp = (*_allNSProblems)[SICONOS_OSNSP_TS_VELOCITY];
+  if(!osnsp || !osnsp->numericsSolverOptions()) return;
+  SolverOptions& options = *osnsp->numericsSolverOptions();
+
+  int used = options.iparam[SICONOS_IPARAM_ITER_DONE];
+  int cap = options.iparam[SICONOS_IPARAM_MAX_ITER];
+  double residu = options.dparam[SICONOS_DPARAM_RESIDU];
+  double tol = options.dparam[SICONOS_DPARAM_TOL];
+
+  /* a step is hard when the nonsmooth solver or the Newton loop came
+     close to its iteration cap, or left a residual above the tolerance */
+  bool hard = (cap > 0 && 2 * used >= cap)
+              || residu > tol
+              || _newtonNbIterations >= _newtonMaxIteration;
+
+  if(hard)
+  {
+    _adaptEasySteps = 0;
+    if(tol > _adaptTolMin)
+      options.dparam[SICONOS_DPARAM_TOL] = fmax(_adaptTolMin, 0.1 * tol);
+    if(_newtonNbIterations >= _newtonMaxIteration
+        && 2 * _newtonMaxIteration <= _adaptNewtonMaxIterationCap)
+      _newtonMaxIteration *= 2;
+  }
+  else if(++_adaptEasySteps >= 10)
+  {
+    /* a run of easy steps: relax the tolerance one notch */
+    _adaptEasySteps = 0;
+    if(tol < _adaptTolMax)
+      options.dparam[SICONOS_DPARAM_TOL] = fmin(_adaptTolMax, 10. * tol);
+  }
+}
+
 bool TimeStepping::newtonCheckConvergence(double criterion)
 {
   bool checkConvergence = true;
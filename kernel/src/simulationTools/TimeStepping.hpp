@@ -23,6 +23,14 @@
 
 #include "Simulation.hpp"
 
+#include "SiconosVector.hpp" // for the speculative detection state snapshot
+
+#include <cstddef>    // for std::size_t (express mode signature)
+#include <functional> // for std::function (journal checkpoint hook)
+#include <iosfwd>     // for std::ofstream (step journal)
+#include <map>        // for the speculative detection state snapshot
+#include <thread>     // for the speculative detection worker
+
 /** type of function used to post-treat output info from solver. */
 typedef void (*CheckSolverFPtr)(int, Simulation *);
 
@@ -122,6 +130,198 @@ protected:
    */
   bool _skip_resetLambdas;
 
+  /** when true, the tolerance of the velocity one-step nonsmooth problem
+   *  and the Newton iteration cap are adjusted online from the per-step
+   *  feedback (default false), see setAdaptSolverParameters()
+   */
+  bool _adaptSolverParameters = false;
+
+  /** tightest tolerance the adaptive policy may set */
+  double _adaptTolMin = 0.;
+
+  /** loosest tolerance the adaptive policy may set */
+  double _adaptTolMax = 0.;
+
+  /** upper bound for the Newton iteration cap under adaptation */
+  unsigned int _adaptNewtonMaxIterationCap = 0;
+
+  /** consecutive steps solved well below the caps */
+  unsigned int _adaptEasySteps = 0;
+
+  /** when true, from the second Newton iteration on the velocity
+   *  one-step nonsmooth problem starts from the lambda and y the
+   *  previous iteration wrote back instead of the values memorized at
+   *  the end of the previous time step (default false), see
+   *  setWarmStartNewtonIterations() */
+  bool _warmStartNewtonIterations = false;
+
+  /** scaling between the Newton residual and the tolerance handed to
+   *  the velocity one-step nonsmooth problem (inexact Newton laddering);
+   *  0 (default) keeps the solver tolerance fixed */
+  double _inexactNewtonFactor = 0.;
+
+  /** loosest tolerance the inexact Newton laddering may hand to the
+   *  nonsmooth solver */
+  double _inexactNewtonTolMax = 0.;
+
+  /** step journal output stream, null when journaling is disabled */
+  std::shared_ptr<std::ofstream> _journalStream;
+
+  /** number of steps recorded in the journal so far */
+  unsigned long _journalStep = 0;
+
+  /** period (in steps) between two checkpoint hook calls, 0 to disable */
+  unsigned int _journalCheckpointPeriod = 0;
+
+  /** called with (step, time) when a periodic checkpoint is due; wire it
+   *  to an incremental checkpoint writer such as
+   *  Siconos::IO::saveStateDelta() */
+  std::function<void(unsigned long, double)> _journalCheckpointHook;
+
+  /** append the record of the step that just completed to the journal */
+  void journalRecordStep();
+
+  /** when true and the interaction manager supports it, collision
+   *  detection for the next step is run on a worker thread while the
+   *  one-step nonsmooth problem is solved (default false), see
+   *  setPipelinedInteractionUpdate() */
+  bool _pipelinedInteractionUpdate = false;
+
+  /** maximum displacement (infinity norm, per dynamical system state)
+   *  between the configuration the speculative detection was run with and
+   *  the actual post-step configuration for the detection to be kept;
+   *  beyond it the step falls back to synchronous detection */
+  double _pipelineValidationMargin = 0.;
+
+  /** true while a speculative detection thread is in flight */
+  bool _speculationPending = false;
+
+  /** worker thread of the speculative detection */
+  std::thread _speculativeDetection;
+
+  /** state snapshot the speculative detection was run with, per
+   *  dynamical system number */
+  std::map<size_t, SiconosVector> _speculativeState;
+
+  /** snapshot the current configuration and launch the detection phase
+   *  of the interaction manager on a worker thread; does nothing when
+   *  the pipelined update is disabled or unsupported */
+  void startSpeculativeInteractionUpdate();
+
+  /** join the speculative detection thread, validate its configuration
+   *  against the current one and commit its results when valid
+   *
+   *  \return true if the detection was committed, false when the caller
+   *  has to run the synchronous update
+   */
+  bool finishSpeculativeInteractionUpdate();
+
+  /** when true the time step h is adapted online between _adaptiveHMin
+   *  and _adaptiveHMax from the Newton residuals (default false), see
+   *  setAdaptiveTimeStep() */
+  bool _adaptiveTimeStep = false;
+
+  /** smallest h the step controller may set */
+  double _adaptiveHMin = 0.;
+
+  /** largest h the step controller may set */
+  double _adaptiveHMax = 0.;
+
+  /** consecutive accepted steps solved well within the Newton caps;
+   *  reaching a run of them triggers a step growth */
+  unsigned int _adaptiveSmoothSteps = 0;
+
+  /** a growth was decided at the end of the previous step; it is
+   *  applied at the beginning of the next one, where t_k is the only
+   *  grid point that must not move */
+  bool _adaptiveGrowPending = false;
+
+  /** number of steps rejected (and redone with a smaller h) so far */
+  unsigned int _adaptiveRejectedSteps = 0;
+
+  /** when true every computeOneStep() is bounded by the wall-clock
+   *  budget _realTimeBudget (default false), see setRealTimeMode() */
+  bool _realTimeMode = false;
+
+  /** wall-clock budget of one step, in seconds */
+  double _realTimeBudget = 0.;
+
+  /** fraction of the budget below which the step is under pressure:
+   *  non-critical phases are skipped and the nonsmooth solver
+   *  iterations are capped from the remaining time */
+  double _realTimePressureFraction = 0.5;
+
+  /** tick at which the budget of the current step expires */
+  std::uint64_t _realTimeDeadline = 0;
+
+  /** quality of the last step computed in real-time mode */
+  int _realTimeQuality = 0;
+
+  /** iteration cap of the nonsmooth solver before the step possibly
+   *  lowered it, to be restored at the end of the step (-1: untouched) */
+  int _realTimeSavedMaxIter = -1;
+
+  /** saved relation residual flags, restored at the end of a step that
+   *  skipped their evaluation under pressure */
+  bool _realTimeSavedResiduY = false;
+  bool _realTimeSavedResiduR = false;
+
+  /** Real-time throttling, called before each Newton iteration: under
+   *  pressure, skip the relation residual evaluations (they refine the
+   *  convergence test but are not needed to produce the iterate) and
+   *  cap the nonsmooth solver iterations from the remaining budget and
+   *  the measured cost per solver iteration of its previous call
+   *
+   *  \param lastSolveTicks duration of the previous nonsmooth solve
+   *  \param lastSolveIterations iterations it performed
+   */
+  void realTimeThrottle(std::uint64_t lastSolveTicks, int lastSolveIterations);
+
+  /** number of stable steps after which the express pipeline engages
+   *  (0: express mode disabled) */
+  unsigned int _expressThreshold = 0;
+
+  /** number of consecutive steps whose structural signature did not
+   *  change */
+  unsigned int _expressStableSteps = 0;
+
+  /** true while the express pipeline is running */
+  bool _expressActive = false;
+
+  /** structural signature of the model the stability counter refers
+   *  to: dynamical systems, interactions and indexSet0 edges */
+  std::size_t _expressSigDS = 0;
+  std::size_t _expressSigInter = 0;
+  std::size_t _expressSigEdges = 0;
+
+  /** \return the current structural signature matches the stored one */
+  bool expressSignatureMatches() const;
+
+  /** update the stability counter after a full-pipeline step and engage
+   *  the express pipeline once the threshold is reached */
+  void expressStepDone();
+
+  /** Newton solve wrapped in the step acceptance loop: reject and redo
+   *  the step with h/2 while the Newton iteration does not converge
+   *  (down to hMin), grow h after a run of smooth steps (up to hMax)
+   */
+  void newtonSolveWithStepControl();
+
+  /** roll the dynamical systems back to the beginning of the step. The
+   *  state memories are written by swapInMemory() at the end of the
+   *  previous step, so slot 0 holds exactly the state at t_k; topology,
+   *  index sets and work vectors are left untouched -- the retry
+   *  re-enters the standard Newton path, which refreshes them.
+   */
+  void rejectStep();
+
+  /** install a new time step: rebase the events schedule (t_k stays in
+   *  place) and let the integrators swap their h-parameterized caches
+   *
+   *  \param newH the new time step
+   */
+  void applyTimeStep(double newH);
+
   /** Default Constructor
    */
   TimeStepping()
@@ -135,6 +335,13 @@ protected:
    */
   virtual void newtonSolve(double criterion, unsigned int maxStep);
 
+  /** adjust the tolerance of the velocity one-step nonsmooth problem and
+   *  the Newton iteration cap from the feedback of the step that just
+   *  completed; called at the end of newtonSolve() when adaptation is
+   *  enabled
+   */
+  void adaptSolverParameters();
+
 public:
   /** initialisation specific to TimeStepping for OneStepNSProblem.
    */
@@ -167,7 +374,26 @@ public:
 
   /** Destructor.
    */
-  virtual ~TimeStepping() noexcept = default;
+  virtual ~TimeStepping() noexcept;
+
+  /** Enable or disable the pipelined interaction update: when enabled
+   *  and the interaction manager implements the speculative detection
+   *  protocol (see InteractionManager::detectInteractions), collision
+   *  detection for the next step runs on a worker thread during the
+   *  one-step nonsmooth problem solve. The detection is kept only if no
+   *  dynamical system has moved further than the margin since it was
+   *  launched; otherwise the step runs the synchronous update as usual.
+   *  The detection envelope of the manager must cover the margin.
+   *
+   *  \param enable true to overlap detection and solve
+   *  \param margin the validation margin, in the units of the dynamical
+   *  systems state (default 0: any motion triggers the fallback)
+   */
+  void setPipelinedInteractionUpdate(bool enable, double margin = 0.)
+  {
+    _pipelinedInteractionUpdate = enable;
+    _pipelineValidationMargin = margin;
+  };
 
   /** update indexSets[i] of the topology, using current y and lambda values of Interactions
    *
@@ -331,6 +557,204 @@ public:
    */
   unsigned int newtonMaxIteration() { return _newtonMaxIteration; };
 
+  /** enable online adaptation of the nonsmooth solver parameters.
+   *
+   *  After each step, the tolerance of the velocity one-step nonsmooth
+   *  problem is tightened (down to tolMin) when the step was hard --
+   *  solver or Newton loop close to its iteration cap, or residual above
+   *  the tolerance -- and relaxed one notch (up to tolMax) after a run
+   *  of easy steps. The Newton iteration cap is raised when it is hit,
+   *  up to ten times its current value. The accuracy actually delivered
+   *  therefore moves within [tolMin, tolMax]: choose the band
+   *  accordingly.
+   *
+   *  \param tolMin tightest tolerance the policy may set
+   *  \param tolMax loosest tolerance the policy may set
+   */
+  void setAdaptSolverParameters(double tolMin, double tolMax);
+
+  /** warm-start the velocity one-step nonsmooth problem across Newton
+   *  iterations: from the second iteration of a Newton loop on, the
+   *  solver starts from the lambda and y the previous iteration wrote
+   *  back instead of the values memorized at the end of the previous
+   *  time step. Successive Newton iterates are much closer to each
+   *  other than to the previous step, so the inner solver usually
+   *  converges in a few iterations. Only effective with the
+   *  SICONOS_TS_NONLINEAR option and a LinearOSNS-based problem.
+   *
+   *  \param enable true to reuse the previous iteration's solution
+   */
+  void setWarmStartNewtonIterations(bool enable)
+  {
+    _warmStartNewtonIterations = enable;
+  };
+
+  /** \return true when the across-iterations warm start is enabled */
+  bool warmStartNewtonIterations() const { return _warmStartNewtonIterations; };
+
+  /** ladder the tolerance of the velocity one-step nonsmooth problem
+   *  with the Newton residual (inexact Newton): each iteration solves at
+   *  max(configured tolerance, min(tolMax, factor * residual)), so the
+   *  early iterations -- whose solution the next linearization discards
+   *  anyway -- are solved loosely and only the last ones pay for full
+   *  accuracy. The solver tolerance is restored at the end of the step;
+   *  the accuracy delivered by the step is still governed by the Newton
+   *  convergence criterion. Only effective with the SICONOS_TS_NONLINEAR
+   *  option.
+   *
+   *  \param factor scaling between the Newton residual and the solver
+   *  tolerance (0 disables the laddering)
+   *  \param tolMax loosest tolerance handed to the solver, used for the
+   *  first iteration where no residual is available yet
+   */
+  void setInexactNewtonTolerance(double factor, double tolMax)
+  {
+    _inexactNewtonFactor = factor;
+    _inexactNewtonTolMax = tolMax;
+  };
+
+  /** enable adaptive time-stepping.
+   *
+   *  The existing Newton residuals act as the error estimator: a step
+   *  whose Newton loop does not converge is rejected -- the state is
+   *  rolled back from the memory vectors, without touching the topology
+   *  -- and redone with h/2, down to hMin; after three consecutive
+   *  steps solved in at most half the Newton iteration cap, h is
+   *  doubled, up to hMax. Halving and doubling keep h on the dyadic
+   *  grid hMin * 2^n, so the integrators (see
+   *  MoreauJeanOSI::timeStepChanged) cache the iteration matrices and
+   *  their factorizations for the few h values actually visited instead
+   *  of rebuilding them on every adjustment.
+   *
+   *  Requires a constant-h TimeDiscretisation (t0, h constructors) and
+   *  the SICONOS_TS_NONLINEAR Newton option (the controller reads the
+   *  residuals the nonlinear loop computes).
+   *
+   *  \param hMin smallest time step the controller may set
+   *  \param hMax largest time step the controller may set
+   */
+  void setAdaptiveTimeStep(double hMin, double hMax);
+
+  /** \return true when adaptive time-stepping is enabled */
+  bool adaptiveTimeStep() const { return _adaptiveTimeStep; };
+
+  /** quality of a step computed in real-time mode */
+  enum RealTimeStepQuality
+  {
+    /** the step completed exactly as in normal mode, within its budget */
+    REALTIME_STEP_FULL = 0,
+    /** the step converged, but non-critical phases were skipped or the
+        nonsmooth solver iterations were capped by the remaining budget */
+    REALTIME_STEP_DEGRADED,
+    /** the wall-clock budget ran out: the best iterate computed so far
+        was kept, without convergence */
+    REALTIME_STEP_TRUNCATED
+  };
+
+  /** Bound every computeOneStep() by a wall-clock budget, for real-time
+   *  (e.g. control) loops where a late step is worse than a slightly
+   *  degraded one.  The step always performs at least one Newton
+   *  iteration; further iterations only start while the remaining budget
+   *  covers the measured cost of the previous one.  When the remaining
+   *  budget falls below pressureFraction times the budget, the relation
+   *  residual evaluations are skipped and the iteration cap of the
+   *  nonsmooth solver is derived from the remaining time and its
+   *  measured cost per iteration.  realTimeStepQuality() reports how
+   *  much of this machinery a step had to use.
+   *
+   *  \param stepBudget wall-clock budget of one step, in seconds
+   *  \param pressureFraction remaining-budget fraction below which the
+   *  non-critical phases are skipped (default 0.5)
+   */
+  void setRealTimeMode(double stepBudget, double pressureFraction = 0.5);
+
+  /** leave real-time mode: steps run to convergence again */
+  void unsetRealTimeMode();
+
+  /** \return true when real-time stepping is enabled */
+  bool realTimeMode() const { return _realTimeMode; };
+
+  /** \return the quality of the last step computed in real-time mode */
+  RealTimeStepQuality realTimeStepQuality() const
+  {
+    return (RealTimeStepQuality)_realTimeQuality;
+  };
+
+  /** enable the fixed-topology express pipeline: after nbStableSteps
+   *  consecutive steps without structural change (same dynamical
+   *  systems, interactions and connectivity), the per-step structure
+   *  work -- interaction detection, index set updates, OSNS
+   *  (re)initialization -- is frozen and the step reduces to the pure
+   *  numeric pipeline until invalidateExpressMode() is called or a
+   *  structural change is detected. Meant for models whose contacts
+   *  are all persistent (preloaded mechanisms, jointed assemblies);
+   *  anything that adds or removes systems or interactions behind the
+   *  simulation's back must call invalidateExpressMode() first.
+   *
+   *  \param nbStableSteps steps without change before freezing (>= 1)
+   */
+  void setExpressMode(unsigned int nbStableSteps = 3);
+
+  /** disable the express pipeline; every step runs the full structure
+   *  pipeline again */
+  void unsetExpressMode();
+
+  /** \return true while the frozen (express) pipeline is running */
+  bool expressModeActive() const { return _expressActive; };
+
+  /** drop the frozen structure: the next steps run the full pipeline
+   *  and the stability counter restarts */
+  void invalidateExpressMode()
+  {
+    _expressActive = false;
+    _expressStableSteps = 0;
+  };
+
+  /** \return the number of steps rejected and redone with a smaller h */
+  unsigned int adaptiveRejectedSteps() const { return _adaptiveRejectedSteps; };
+
+  /** enable the step journal: after each completed step a one-line record
+   *  (step number, time, Newton iterations, residuals, checkpoint flag)
+   *  is appended to the given file. Together with periodic incremental
+   *  checkpoints it allows replaying a long run up to a failing step
+   *  without re-executing it from t0: restore the last checkpoint at or
+   *  before the target step, then re-run the few remaining steps.
+   *
+   *  \param filename journal file name (truncated if it exists)
+   *  \param checkpointPeriod number of steps between two calls of the
+   *  checkpoint hook (0, the default, never calls it)
+   */
+  void enableStepJournal(const std::string& filename,
+                         unsigned int checkpointPeriod = 0);
+
+  /** set the function called with (step, time) each time a periodic
+   *  checkpoint is due; typically a lambda invoking
+   *  Siconos::IO::saveStateDelta() with a step-stamped file name
+   *
+   *  \param hook the checkpoint writer
+   */
+  void setJournalCheckpointHook(std::function<void(unsigned long, double)> hook)
+  {
+    _journalCheckpointHook = hook;
+  };
+
+  /** number of steps recorded in the journal since enableStepJournal()
+   *
+   *  \return the current journal step counter
+   */
+  unsigned long journalStep() const { return _journalStep; };
+
+  /** scan a journal file for the last checkpointed step at or before a
+   *  target step; the returned step tells which checkpoint file to
+   *  restore before replaying towards the target
+   *
+   *  \param filename journal file name
+   *  \param targetStep step to be reached by the replay
+   *  \return the checkpointed step number, or -1 when none was found
+   */
+  static long journalLastCheckpointBefore(const std::string& filename,
+                                          unsigned long targetStep);
+
   /** set the NewtonOptions
    *
    *  \param v Newton solver options
@@ -22,6 +22,11 @@
 #include "Interaction.hpp"
 #include "EqualityConditionNSL.hpp"
 #include "OneStepIntegrator.hpp"
+#include "LagrangianDS.hpp"
+#include "NewtonEulerDS.hpp"
+
+#include <cstdint>
+#include <map>
 
 #if (__cplusplus >= 201103L) && !defined(USE_BOOST_FOR_CXX11)
 #include <functional>
@@ -87,10 +92,12 @@ Topology::__addInteractionInIndexSet0(SP::Interaction inter, SP::DynamicalSystem
   // vector of the Interaction
   DynamicalSystemsGraph::VDescriptor dsgv1, dsgv2;
   dsgv1 = _DSG[0]->add_vertex(ds1);
+  _DSG[0]->properties(dsgv1).ds_type = Type::value(*ds1);
 
   if(ds2)
   {
     dsgv2 = _DSG[0]->add_vertex(ds2);
+    _DSG[0]->properties(dsgv2).ds_type = Type::value(*ds2);
   }
   else
   {
@@ -226,7 +233,8 @@ void Topology::__removeInteractionFromIndexSet(SP::Interaction inter)
 
 void Topology::insertDynamicalSystem(SP::DynamicalSystem ds)
 {
-  _DSG[0]->add_vertex(ds);
+  DynamicalSystemsGraph::VDescriptor dsgv = _DSG[0]->add_vertex(ds);
+  _DSG[0]->properties(dsgv).ds_type = Type::value(*ds);
   setHasChanged(true);
 }
 
@@ -352,6 +360,160 @@ Topology::link(SP::Interaction inter, SP::DynamicalSystem ds, SP::DynamicalSyste
   return __addInteractionInIndexSet0(inter, ds, ds2);
 }
 
+void Topology::linkBatch(const std::vector<LinkSpec>& links)
+{
+  DEBUG_PRINTF("Topology::linkBatch : %lu links\n", links.size());
+
+  for(const LinkSpec& l : links)
+  {
+    // If the interaction is already in the graph remove it
+    if(indexSet0()->is_vertex(l.interaction))
+    {
+      __removeInteractionFromIndexSet(l.interaction);
+    }
+
+    // Compute interaction dimension (sum of involved dynamical systems sizes)
+    unsigned int sumOfDSSizes = 0;
+    sumOfDSSizes += l.ds1->dimension();
+    if(l.ds2)
+    {
+      sumOfDSSizes += l.ds2->dimension();
+      l.interaction->setHas2Bodies(true);
+    }
+    l.interaction->setDSSizes(sumOfDSSizes);
+
+    __addInteractionInIndexSet0(l.interaction, l.ds1, l.ds2);
+  }
+
+  // one index rebuild for the whole batch: consumers of the indices (in
+  // particular the index-backed property maps) then remap once instead
+  // of once per insertion
+  _IG[0]->update_vertices_indices();
+  _IG[0]->update_edges_indices();
+  _DSG[0]->update_vertices_indices();
+  _DSG[0]->update_edges_indices();
+}
+
+void Topology::removeInteractionBatch(const std::vector<SP::Interaction>& interactions)
+{
+  DEBUG_PRINTF("Topology::removeInteractionBatch : %lu interactions\n",
+               interactions.size());
+
+  assert(_DSG[0]->edges_number() == _IG[0]->size());
+  for(const SP::Interaction& inter : interactions)
+  {
+    __removeInteractionFromIndexSet(inter);
+  }
+  assert(_DSG[0]->edges_number() == _IG[0]->size());
+
+  // same single index rebuild as in linkBatch
+  _IG[0]->update_vertices_indices();
+  _IG[0]->update_edges_indices();
+  _DSG[0]->update_vertices_indices();
+  _DSG[0]->update_edges_indices();
+
+  setHasChanged(true);
+}
+
+/* interleave the low 10 bits of v with two zero bits between each bit */
+static uint64_t __spreadBits10(uint64_t v)
+{
+  v &= 0x3ff;
+  v = (v | (v << 16)) & 0x030000ff;
+  v = (v | (v << 8)) & 0x0300f00f;
+  v = (v | (v << 4)) & 0x030c30c3;
+  v = (v | (v << 2)) & 0x09249249;
+  return v;
+}
+
+void Topology::reorderByMortonCode()
+{
+  // one 3d position per system, when it has generalized coordinates
+  struct Placed
+  {
+    DynamicalSystem* ds;
+    double p[3];
+  };
+  std::vector<Placed> placed;
+  placed.reserve(_DSG[0]->size());
+  double lo[3] = {0., 0., 0.};
+  double hi[3] = {0., 0., 0.};
+
+  DynamicalSystemsGraph::VIterator dsi, dsend;
+  for(std::tie(dsi, dsend) = _DSG[0]->vertices(); dsi != dsend; ++dsi)
+  {
+    SP::DynamicalSystem ds = _DSG[0]->bundle(*dsi);
+    SP::SiconosVector q;
+    if(SP::LagrangianDS lds = std::dynamic_pointer_cast<LagrangianDS>(ds))
+      q = lds->q();
+    else if(SP::NewtonEulerDS neds = std::dynamic_pointer_cast<NewtonEulerDS>(ds))
+      q = neds->q();
+    if(!q) continue;
+
+    Placed item = {ds.get(), {0., 0., 0.}};
+    for(unsigned int k = 0; k < 3 && k < q->size(); ++k)
+      item.p[k] = (*q)(k);
+    if(placed.empty())
+      for(unsigned int k = 0; k < 3; ++k)
+        lo[k] = hi[k] = item.p[k];
+    else
+      for(unsigned int k = 0; k < 3; ++k)
+      {
+        lo[k] = std::min(lo[k], item.p[k]);
+        hi[k] = std::max(hi[k], item.p[k]);
+      }
+    placed.push_back(item);
+  }
+  if(placed.empty())
+    return; // no positions to sort by
+
+  // quantize each axis to 10 bits over the bounding box and interleave;
+  // systems without a position keep their relative order after the rest
+  std::map<DynamicalSystem*, uint64_t> code;
+  for(const Placed& item : placed)
+  {
+    uint64_t morton = 0;
+    for(unsigned int k = 0; k < 3; ++k)
+    {
+      double span = hi[k] - lo[k];
+      double normalized = span > 0. ? (item.p[k] - lo[k]) / span : 0.;
+      morton |= __spreadBits10((uint64_t)(normalized * 1023.)) << k;
+    }
+    code[item.ds] = morton;
+  }
+  auto codeOf = [&code](DynamicalSystem* ds) -> uint64_t
+  {
+    std::map<DynamicalSystem*, uint64_t>::const_iterator it = code.find(ds);
+    return it != code.end() ? it->second : std::numeric_limits<uint64_t>::max();
+  };
+
+  _DSG[0]->sort_vertices_indices(
+    [this, &codeOf](const DynamicalSystemsGraph::VDescriptor& vd)
+    { return codeOf(_DSG[0]->bundle(vd).get()); });
+
+  // each interaction follows the closest of its systems
+  _IG[0]->sort_vertices_indices(
+    [this, &codeOf](const InteractionsGraph::VDescriptor& vd)
+    {
+      const InteractionProperties& props = _IG[0]->properties(vd);
+      uint64_t morton = std::numeric_limits<uint64_t>::max();
+      if(props.source) morton = std::min(morton, codeOf(props.source.get()));
+      if(props.target) morton = std::min(morton, codeOf(props.target.get()));
+      return morton;
+    });
+
+  // drop the persistent position layouts so that the next assembly lays the
+  // problems out in the new spatial order (a kept layout would pin every
+  // interaction to its pre-reordering position); the revision keeps
+  // counting so per-position caches see the reset as a change
+  for(SP::InteractionsGraph ig : _IG)
+  {
+    InteractionsGraph::StablePositionLayout fresh;
+    fresh.revision = ig->stableLayout.revision + 1;
+    ig->stableLayout = fresh;
+  }
+}
+
 bool Topology::hasInteraction(SP::Interaction inter) const
 {
   return indexSet0()->is_vertex(inter);
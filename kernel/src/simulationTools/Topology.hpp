@@ -206,6 +206,49 @@ public:
   std::pair<DynamicalSystemsGraph::EDescriptor, InteractionsGraph::VDescriptor>
   link(SP::Interaction inter, SP::DynamicalSystem ds, SP::DynamicalSystem ds2 = SP::DynamicalSystem());
 
+  /** one (interaction, ds1, ds2) triple for linkBatch() */
+  struct LinkSpec
+  {
+    SP::Interaction interaction;
+    SP::DynamicalSystem ds1;
+    SP::DynamicalSystem ds2;
+  };
+
+  /** link a batch of interactions in one pass.
+   *
+   *  Equivalent to calling link() on each triple, but the graph indices
+   *  are rebuilt only once at the end of the batch, so the index-backed
+   *  property maps remap (and grow to the final size) once instead of
+   *  once per insertion. To be preferred when many interactions are
+   *  created at the same time, as collision managers do.
+   *
+   *  \param links the (interaction, ds1, ds2) triples to insert
+   */
+  void linkBatch(const std::vector<LinkSpec>& links);
+
+  /** remove a batch of Interactions from the topology in one pass, with
+   *  the same single index rebuild as linkBatch(). As for
+   *  removeInteraction(), the interactions are not removed from actives
+   *  subgraphs : see updateIndexSet
+   *
+   *  \param interactions the Interactions to remove
+   */
+  void removeInteractionBatch(const std::vector<SP::Interaction>& interactions);
+
+  /** renumber the vertices of the dynamical systems graph (and of the
+   *  interactions graph, each interaction following its closest system)
+   *  by Morton code of the system positions, so that spatially adjacent
+   *  bodies get adjacent indices. Everything laid out by index --
+   *  index-backed graph properties, the position assignment of the
+   *  assembled OSNS matrices -- then touches memory in near-spatial
+   *  order, which matters for large granular scenes. Only systems with
+   *  a generalized coordinates vector (Lagrangian, Newton-Euler)
+   *  contribute a position; the others keep their relative order after
+   *  them. Insertions and removals reset the numbering to storage
+   *  order, so call this periodically on evolving scenes.
+   */
+  void reorderByMortonCode();
+
   /** specify if the given Interaction is for controlling the DS
    *
    *  \param inter Interaction
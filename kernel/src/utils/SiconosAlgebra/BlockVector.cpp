@@ -18,6 +18,7 @@
 
 #include "BlockVector.hpp"
 
+#include <algorithm>  // for upper_bound
 #include <boost/numeric/ublas/vector_proxy.hpp>  // for project
 #include <boost/numeric/ublas/vector_sparse.hpp>
 #include <vector>
@@ -218,10 +219,9 @@ std::ostream& operator<<(std::ostream& os, const BlockVector& bv)
 
 double BlockVector::getValue(unsigned int pos) const
 {
-  unsigned int blockNum = 0;
-
-  while(pos >= (*_tabIndex)[blockNum] && blockNum < _tabIndex->size())
-    blockNum ++;
+  // binary search of the block that holds position pos: the linear scan
+  // turns an element-by-element gather over the whole vector quadratic.
+  unsigned int blockNum = std::upper_bound(_tabIndex->begin(), _tabIndex->end(), pos) - _tabIndex->begin();
 
   unsigned int relativePos = pos;
 
@@ -233,10 +233,7 @@ double BlockVector::getValue(unsigned int pos) const
 
 void BlockVector::setValue(unsigned int pos, double value)
 {
-  unsigned int blockNum = 0;
-
-  while(pos >= (*_tabIndex)[blockNum] && blockNum < _tabIndex->size())
-    blockNum ++;
+  unsigned int blockNum = std::upper_bound(_tabIndex->begin(), _tabIndex->end(), pos) - _tabIndex->begin();
 
   unsigned int relativePos = pos;
 
@@ -248,10 +245,7 @@ void BlockVector::setValue(unsigned int pos, double value)
 
 double& BlockVector::operator()(unsigned int pos)
 {
-  unsigned int blockNum = 0;
-
-  while(pos >= (*_tabIndex)[blockNum] && blockNum < _tabIndex->size())
-    blockNum ++;
+  unsigned int blockNum = std::upper_bound(_tabIndex->begin(), _tabIndex->end(), pos) - _tabIndex->begin();
 
   unsigned int relativePos = pos;
 
@@ -304,10 +298,9 @@ void BlockVector::setAllVect(VectorOfVectors& v)
 
 unsigned int BlockVector::getNumVectorAtPos(unsigned int pos) const
 {
-  unsigned int blockNum = 0;
-
-  while(pos >= (*_tabIndex)[blockNum] && blockNum < _tabIndex->size() - 1)
-    blockNum ++;
+  unsigned int blockNum = std::upper_bound(_tabIndex->begin(), _tabIndex->end(), pos) - _tabIndex->begin();
+  if(blockNum > _tabIndex->size() - 1)
+    blockNum = _tabIndex->size() - 1;
   return blockNum;
 }
 
@@ -351,6 +344,26 @@ BlockVector& BlockVector::operator = (const double* data)
   return *this;
 }
 
+void BlockVector::copyToDense(double* data) const
+{
+  // Bulk gather: the blocks are streamed one after the other into the
+  // contiguous output array, with one BLAS copy per block.
+  unsigned int indxPos = 0;
+  VectorOfVectors::const_iterator it;
+
+  for(it = _vect.begin(); it != _vect.end(); ++it)
+  {
+    assert(*it);
+    indxPos += (*it)->copyData(&data[indxPos]);
+  }
+}
+
+void BlockVector::copyFromDense(const double* data)
+{
+  // Bulk scatter, mirror operation of copyToDense.
+  *this = data;
+}
+
 
 BlockVector& BlockVector::operator -= (const BlockVector& vIn)
 {
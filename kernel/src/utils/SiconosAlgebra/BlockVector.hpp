@@ -165,6 +165,24 @@ public:
    */
   std::string toString() const;
 
+  /** Copy the content of all the blocks into a contiguous array
+   *  (bulk gather, one BLAS copy per block).
+   *
+   *  All the blocks must be dense.
+   *
+   *  \param data the array to be filled in (size of the vector at least)
+   */
+  void copyToDense(double* data) const;
+
+  /** Fill all the blocks with the content of a contiguous array
+   *  (bulk scatter, one BLAS copy per block).
+   *
+   *  All the blocks must be dense.
+   *
+   *  \param data the array to be copied (size of the vector at least)
+   */
+  void copyFromDense(const double* data);
+
   /** Get a component of the vector
    *
    *  \param i index of the required component
@@ -33,7 +33,15 @@
 // Typedef to define interface to boost ublas.
 //#include "SiconosAlgebraTypeDef.hpp"
 #include "SiconosMatrix.hpp"
+#include "SimpleMatrix.hpp"
 #include "SiconosVector.hpp"
+#include "SiconosAlgebraProd.hpp"
+#include "SiconosException.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
 
 #include "EigenProblems.hpp"
 // Some utilities (print ...)
@@ -100,5 +108,170 @@ int geev(SiconosMatrix& input_mat, complex_vector& eigenval, complex_matrix& lef
   return info;
 }
 
+int lanczos(const SiconosMatrix& A, unsigned int k, SiconosVector& eigenval,
+            SiconosMatrix& eigenvec, bool smallest, double sigma,
+            double tol, unsigned int maxSubspace, bool withVect)
+{
+  unsigned int n = A.size(0);
+  if(A.size(1) != n)
+    THROW_EXCEPTION("lanczos: the input matrix must be square.");
+  if(k == 0 || k > n)
+    THROW_EXCEPTION("lanczos: k must be between 1 and the matrix order.");
+  if(withVect && (eigenvec.size(0) != n || eigenvec.size(1) < k
+                  || eigenvec.num() != Siconos::DENSE))
+    THROW_EXCEPTION("lanczos: eigenvec must be a dense n x k matrix.");
+
+  bool shiftInvert = smallest;
+
+  // Shift-invert operator: A - sigma.I is factorized once and reused for
+  // every iteration. The copy keeps the storage kind of A, so a sparse
+  // input goes through the sparse factorization of Numerics.
+  SP::SimpleMatrix OP;
+  if(shiftInvert)
+  {
+    OP.reset(new SimpleMatrix(A));
+    if(sigma != 0.)
+    {
+      for(unsigned int i = 0; i < n; ++i)
+        OP->setValue(i, i, OP->getValue(i, i) - sigma);
+      OP->setIsPositiveDefinite(false); // the shifted matrix may be indefinite
+    }
+    OP->Factorize();
+  }
+
+  unsigned int m = maxSubspace == 0 ? std::max(4 * k + 10, 40u) : maxSubspace;
+  if(m > n) m = n;
+  if(m < k) m = k;
+
+  // Lanczos basis, with full reorthogonalization to keep the Ritz pairs
+  // reliable: m stays a few tens whatever n, so the extra dot products
+  // are cheap next to the solves.
+  std::vector<SP::SiconosVector> V;
+  V.reserve(m + 1);
+  V.push_back(SP::SiconosVector(new SiconosVector(n)));
+  // deterministic start, never orthogonal to the dominant modes of the
+  // typical stiffness matrices met in modal analysis.
+  V[0]->fill(1.0 / std::sqrt((double) n));
+
+  SiconosVector w(n);
+  std::vector<double> alpha(m, 0.);
+  std::vector<double> beta(m, 0.);
+
+  unsigned int msub = m;
+  for(unsigned int j = 0; j < m; ++j)
+  {
+    if(shiftInvert)
+    {
+      w = *V[j];
+      OP->Solve(w);
+    }
+    else
+      prod(A, *V[j], w, true);
+
+    alpha[j] = ublas::inner_prod(*w.dense(), *V[j]->dense());
+
+    // Two passes of classical Gram-Schmidt against the whole basis; the
+    // projection coefficients are independent, hence the parallel loop.
+    for(unsigned int pass = 0; pass < 2; ++pass)
+    {
+      std::vector<double> coeff(j + 1);
+      int last = (int) j;
+#ifdef _OPENMP
+      #pragma omp parallel for
+#endif
+      for(int i = 0; i <= last; ++i)
+        coeff[i] = ublas::inner_prod(*w.dense(), *V[i]->dense());
+      for(int i = 0; i <= last; ++i)
+        noalias(*w.dense()) -= coeff[i] * (*V[i]->dense());
+    }
+
+    beta[j] = ublas::norm_2(*w.dense());
+    if(beta[j] <= tol * std::max(std::fabs(alpha[j]), 1.0))
+    {
+      // invariant subspace found ("happy breakdown"): the Ritz pairs of
+      // the current subspace are exact.
+      msub = j + 1;
+      break;
+    }
+    if(j + 1 < m)
+    {
+      V.push_back(SP::SiconosVector(new SiconosVector(n)));
+      noalias(*V[j + 1]->dense()) = (*w.dense()) / beta[j];
+    }
+  }
+
+  // Eigen decomposition of the tridiagonal Rayleigh quotient with the
+  // dense syev above: msub is small whatever n.
+  SimpleMatrix T(msub, msub);
+  SiconosVector theta(msub);
+  for(unsigned int j = 0; j < msub; ++j)
+  {
+    T.setValue(j, j, alpha[j]);
+    if(j + 1 < msub)
+    {
+      T.setValue(j, j + 1, beta[j]);
+      T.setValue(j + 1, j, beta[j]);
+    }
+  }
+  int info = syev(theta, T, true);
+  if(info != 0)
+    return info;
+
+  // Ritz selection: syev sorts the operator eigenvalues in ascending
+  // order. In shift-invert mode the wanted pairs (eigenvalues of A
+  // closest to sigma) are those of largest magnitude.
+  std::vector<unsigned int> sel(msub);
+  std::iota(sel.begin(), sel.end(), 0u);
+  if(shiftInvert)
+    std::sort(sel.begin(), sel.end(),
+              [&theta](unsigned int a, unsigned int b)
+  {
+    return std::fabs(theta.getValue(a)) > std::fabs(theta.getValue(b));
+  });
+  else
+    std::reverse(sel.begin(), sel.end());
+
+  unsigned int keff = std::min(k, msub);
+  unsigned int notConverged = k - keff;
+
+  // (eigenvalue of A, index in T) for the retained pairs, ascending order.
+  std::vector<std::pair<double, unsigned int> > ritz(keff);
+  for(unsigned int i = 0; i < keff; ++i)
+  {
+    unsigned int idx = sel[i];
+    double th = theta.getValue(idx);
+    ritz[i].first = shiftInvert ? sigma + 1.0 / th : th;
+    ritz[i].second = idx;
+    // standard Lanczos residual bound: |beta_m s_{m,i}| in operator space.
+    double resid = std::fabs(beta[msub - 1] * T.getValue(msub - 1, idx));
+    if(resid > tol * std::max(std::fabs(th), 1.0))
+      ++notConverged;
+  }
+  std::sort(ritz.begin(), ritz.end());
+
+  for(unsigned int i = 0; i < keff; ++i)
+    eigenval.setValue(i, ritz[i].first);
+
+  if(withVect)
+  {
+    // Ritz vectors x_i = V s_i; the columns are independent.
+    int last = (int) keff - 1;
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int i = 0; i <= last; ++i)
+    {
+      unsigned int idx = ritz[i].second;
+      DenseVect x(n);
+      x.clear();
+      for(unsigned int j = 0; j < msub; ++j)
+        x += T.getValue(j, idx) * (*V[j]->dense());
+      noalias(ublas::column(*eigenvec.dense(), i)) = x;
+    }
+  }
+
+  return (int) notConverged;
+}
+
 } // namespace eigenproblems
 } // namespace Siconos
@@ -52,6 +52,33 @@ namespace Siconos {
              complex_matrix& left_eigenvec, complex_matrix& right_eigenvec,
              bool withLeft = false, bool withRight = true);
 
+/** Compute k extremal eigenpairs of a large real symmetric matrix with a
+ *   Lanczos iteration, without ever forming a dense copy of the matrix.
+ *   For the smallest eigenvalues (the default, e.g. modal analysis of a
+ *   stiffness matrix) the iteration runs in shift-invert mode: A - sigma.I
+ *   is factorized once through SimpleMatrix::Factorize() -- sparse or
+ *   dense, whatever the storage of A -- and each step costs one solve.
+ *   For the largest eigenvalues each step costs one matrix-vector product.
+ *   \param[in] A : the matrix, any SimpleMatrix storage (sparse recommended).
+ *   \param[in] k : number of eigenpairs wanted.
+ *   \param[in,out] eigenval : filled with the k eigenvalues, ascending order.
+ *   \param[in,out] eigenvec : dense n x k matrix, filled with the eigenvectors (columns).
+ *   \param[in] smallest : true for the k smallest eigenvalues (shift-invert),
+ *   false for the k largest (default = true).
+ *   \param[in] sigma : shift, eigenvalues closest to sigma are computed first
+ *   (default = 0, smallest mode only).
+ *   \param[in] tol : relative residual tolerance (default = 1e-10).
+ *   \param[in] maxSubspace : Lanczos subspace dimension; 0 picks
+ *   max(4k+10, 40). Increase it if some pairs do not converge.
+ *   \param[in] withVect : true if eigenvectors are to be computed (default = true).
+ *   \return int : 0 if the k pairs converged, otherwise the number of pairs
+ *   that did not reach the tolerance.
+ */
+    int lanczos(const SiconosMatrix& A, unsigned int k, SiconosVector& eigenval,
+                SiconosMatrix& eigenvec, bool smallest = true, double sigma = 0.,
+                double tol = 1e-10, unsigned int maxSubspace = 0,
+                bool withVect = true);
+
   } // namespace eigenproblems
 } // namespace Siconos
 
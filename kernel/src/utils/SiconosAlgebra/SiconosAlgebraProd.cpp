@@ -21,10 +21,13 @@
 #include <boost/numeric/ublas/symmetric.hpp>
 #include <boost/numeric/ublas/banded.hpp>
 #include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/operation.hpp>        // for ublas::axpy_prod
+#include <boost/numeric/ublas/operation_sparse.hpp> // for ublas::sparse_prod
 #include "SiconosMatrix.hpp"
 #include "SimpleMatrix.hpp"
 #include "BlockVector.hpp"
 #include "SiconosVector.hpp"
+#include "SiconosAlgebraSmallOps.hpp"
 #include "SiconosException.hpp"
 
 void prod(const SiconosMatrix& A, const SiconosVector& x, BlockVector& y, bool init)
@@ -83,6 +86,18 @@ void prod(const SiconosMatrix& A, const SiconosVector& x, SiconosVector& y, bool
   if(numA == Siconos::BLOCK)
     THROW_EXCEPTION("not yet implemented for block matrices.");
 
+  // small dense fast path: plain loops on the raw storage instead of the
+  // ublas expression machinery, whose overhead dominates at these sizes
+  if(numA == Siconos::DENSE && numX == Siconos::DENSE && numY == Siconos::DENSE
+      && &x != &y
+      && A.size(0) <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD
+      && A.size(1) <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD)
+  {
+    Siconos::smallops::gemv(A.size(0), A.size(1), 1.0, A.getArray(),
+                            x.getArray(), y.getArray(), init);
+    return;
+  }
+
   if(numA == Siconos::ZERO)
   {
     if(init)
@@ -123,7 +138,8 @@ void prod(const SiconosMatrix& A, const SiconosVector& x, SiconosVector& y, bool
           else if(numA == Siconos::SYMMETRIC)
             noalias(*y.dense()) = ublas::prod(*A.sym(), *x.dense());
           else if(numA == Siconos::SPARSE)
-            noalias(*y.dense()) = ublas::prod(*A.sparse(), *x.dense());
+            // dedicated kernel: touches stored entries only
+            ublas::axpy_prod(*A.sparse(), *x.dense(), *y.dense(), true);
           else //if(numA==Siconos::BANDED)
             noalias(*y.dense()) = ublas::prod(*A.banded(), *x.dense());
         }
@@ -195,7 +211,8 @@ void prod(const SiconosMatrix& A, const SiconosVector& x, SiconosVector& y, bool
           else if(numA == Siconos::SYMMETRIC)
             noalias(*y.dense()) += ublas::prod(*A.sym(), *x.dense());
           else if(numA == Siconos::SPARSE)
-            noalias(*y.dense()) += ublas::prod(*A.sparse(), *x.dense());
+            // dedicated kernel: touches stored entries only
+            ublas::axpy_prod(*A.sparse(), *x.dense(), *y.dense(), false);
           else //if(numA==Siconos::BANDED)
             noalias(*y.dense()) += ublas::prod(*A.banded(), *x.dense());
         }
@@ -273,6 +290,17 @@ void prod(const SiconosVector& x, const SiconosMatrix& A, SiconosVector& y, bool
   if(numA == Siconos::BLOCK)
     THROW_EXCEPTION("not yet implemented for block matrices.");
 
+  // small dense fast path, see prod(A, x, y, init)
+  if(numA == Siconos::DENSE && numX == Siconos::DENSE && numY == Siconos::DENSE
+      && &x != &y
+      && A.size(0) <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD
+      && A.size(1) <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD)
+  {
+    Siconos::smallops::gemv_trans(A.size(0), A.size(1), 1.0, A.getArray(),
+                                  x.getArray(), y.getArray(), init);
+    return;
+  }
+
   if(numA == Siconos::ZERO)  // A = 0
   {
     if(init)
@@ -727,7 +755,8 @@ void prod(const SiconosMatrix& A, const SiconosMatrix& B, SiconosMatrix& C, bool
             else if(numA == Siconos::SYMMETRIC)
               noalias(*C.dense()) = prod(*A.sym(), *B.sparse());
             else if(numA == Siconos::SPARSE)
-              noalias(*C.dense()) = prod(*A.sparse(), *B.sparse());
+              // dedicated kernel: touches stored entries only
+              ublas::sparse_prod(*A.sparse(), *B.sparse(), *C.dense(), true);
             else //if(numA==Siconos::BANDED){
               noalias(*C.dense()) = prod(*A.banded(), *B.sparse());
           }
@@ -758,7 +787,7 @@ void prod(const SiconosMatrix& A, const SiconosMatrix& B, SiconosMatrix& C, bool
         case Siconos::SPARSE:
           if(numA != Siconos::SPARSE || numB != Siconos::SPARSE)
             THROW_EXCEPTION("wrong type for A or B (according to C type).");
-          noalias(*C.sparse()) = prod(*A.sparse(), *B.sparse());
+          ublas::sparse_prod(*A.sparse(), *B.sparse(), *C.sparse(), true);
           break;
         default:
           THROW_EXCEPTION("not implemented for C type.");
@@ -890,7 +919,8 @@ void prod(const SiconosMatrix& A, const SiconosMatrix& B, SiconosMatrix& C, bool
             else if(numA == Siconos::SYMMETRIC)
               noalias(*C.dense()) += prod(*A.sym(), *B.sparse());
             else if(numA == Siconos::SPARSE)
-              noalias(*C.dense()) += prod(*A.sparse(), *B.sparse());
+              // dedicated kernel: touches stored entries only
+              ublas::sparse_prod(*A.sparse(), *B.sparse(), *C.dense(), false);
             else //if(numA==Siconos::BANDED){
               noalias(*C.dense()) += prod(*A.banded(), *B.sparse());
           }
@@ -921,7 +951,7 @@ void prod(const SiconosMatrix& A, const SiconosMatrix& B, SiconosMatrix& C, bool
         case Siconos::SPARSE:
           if(numA != Siconos::SPARSE || numB != Siconos::SPARSE)
             THROW_EXCEPTION("wrong type for A or B (according to C type).");
-          noalias(*C.sparse()) += prod(*A.sparse(), *B.sparse());
+          ublas::sparse_prod(*A.sparse(), *B.sparse(), *C.sparse(), false);
           break;
         default:
             THROW_EXCEPTION("not implemented for C type).");
@@ -933,6 +963,68 @@ void prod(const SiconosMatrix& A, const SiconosMatrix& B, SiconosMatrix& C, bool
   }
 }
 
+void gemv_add(double a, const SiconosMatrix& A, const SiconosVector& x, double b, SiconosVector& y)
+{
+  // To compute y = a*A*x + b*y in a single pass, without a temporary for A*x.
+  assert(!(A.isPLUFactorizedInPlace()) && "A is PLUFactorizedInPlace in gemv_add !!");
+
+  if(A.size(1) != x.size())
+    THROW_EXCEPTION("inconsistent sizes between A and x.");
+
+  if(A.size(0) != y.size())
+    THROW_EXCEPTION("inconsistent sizes between A and y.");
+
+  if(&x == &y)
+    THROW_EXCEPTION("x and y must be distinct.");
+
+  Siconos::UBLAS_TYPE numA = A.num();
+  Siconos::UBLAS_TYPE numX = x.num();
+  Siconos::UBLAS_TYPE numY = y.num();
+
+  if(numA == Siconos::DENSE && numX == Siconos::DENSE && numY == Siconos::DENSE)
+  {
+    // one fused write pass over y; y(i) is read before it is written
+    noalias(*y.dense()) = a * ublas::prod(*A.dense(), *x.dense()) + b * (*y.dense());
+  }
+  else
+  {
+    // fallback: scale y then accumulate, still without a temporary
+    y *= b;
+    prod(a, A, x, y, false);
+  }
+}
+
+void axpby_prod(double a, const SiconosMatrix& A, const SiconosVector& x, double b, const SiconosVector& z, SiconosVector& y)
+{
+  // To compute y = a*A*x + b*z in a single pass, without a temporary for A*x.
+  assert(!(A.isPLUFactorizedInPlace()) && "A is PLUFactorizedInPlace in axpby_prod !!");
+
+  if(A.size(1) != x.size())
+    THROW_EXCEPTION("inconsistent sizes between A and x.");
+
+  if(A.size(0) != y.size() || z.size() != y.size())
+    THROW_EXCEPTION("inconsistent sizes between A, z and y.");
+
+  if(&x == &y)
+    THROW_EXCEPTION("x and y must be distinct.");
+
+  Siconos::UBLAS_TYPE numA = A.num();
+  Siconos::UBLAS_TYPE numX = x.num();
+  Siconos::UBLAS_TYPE numY = y.num();
+  Siconos::UBLAS_TYPE numZ = z.num();
+
+  if(numA == Siconos::DENSE && numX == Siconos::DENSE
+      && numY == Siconos::DENSE && numZ == Siconos::DENSE)
+  {
+    noalias(*y.dense()) = a * ublas::prod(*A.dense(), *x.dense()) + b * (*z.dense());
+  }
+  else
+  {
+    scal(b, z, y, true);
+    prod(a, A, x, y, false);
+  }
+}
+
 void prod(double a, const SiconosMatrix& A, const SiconosVector& x, SiconosVector& y, bool init)
 {
   // To compute y = a*A * x in an "optimized" way (in comparison with y = prod(A,x) )
@@ -952,6 +1044,17 @@ void prod(double a, const SiconosMatrix& A, const SiconosVector& x, SiconosVecto
   if(numA == Siconos::BLOCK)  // If A is Block
     THROW_EXCEPTION("not yet implemented for block matrices.");
 
+  // small dense fast path, see prod(A, x, y, init)
+  if(numA == Siconos::DENSE && numX == Siconos::DENSE && numY == Siconos::DENSE
+      && &x != &y
+      && A.size(0) <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD
+      && A.size(1) <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD)
+  {
+    Siconos::smallops::gemv(A.size(0), A.size(1), a, A.getArray(),
+                            x.getArray(), y.getArray(), init);
+    return;
+  }
+
   if(numA == Siconos::ZERO)  // A = 0
   {
     if(init)
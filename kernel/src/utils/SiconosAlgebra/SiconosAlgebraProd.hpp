@@ -86,6 +86,27 @@ void axpy_prod(const SiconosMatrix&, const SiconosMatrix&, SiconosMatrix&, bool)
   */
 void prod(double a, const SiconosMatrix& A, const SiconosVector& x, SiconosVector& y, bool init = true);
 
+/** gemv_add(a, A, x, b, y) computes y = a*A*x + b*y in a single pass,
+  without materializing a temporary for A*x. x and y must be distinct.
+  \param a a double
+  \param A a SiconosMatrix
+  \param x a SiconosVector
+  \param b a double
+  \param[in,out] y a SiconosVector
+  */
+void gemv_add(double a, const SiconosMatrix& A, const SiconosVector& x, double b, SiconosVector& y);
+
+/** axpby_prod(a, A, x, b, z, y) computes y = a*A*x + b*z in a single pass,
+  without materializing a temporary for A*x. x and y must be distinct.
+  \param a a double
+  \param A a SiconosMatrix
+  \param x a SiconosVector
+  \param b a double
+  \param z a SiconosVector
+  \param[in,out] y a SiconosVector
+  */
+void axpby_prod(double a, const SiconosMatrix& A, const SiconosVector& x, double b, const SiconosVector& z, SiconosVector& y);
+
 /** subprod(A, x, y) computes sub_y = sub_A*sub_x or sub_y += sub_A*sub_x if init = false
   \param A a SiconosMatrix
   \param x a SiconosVector
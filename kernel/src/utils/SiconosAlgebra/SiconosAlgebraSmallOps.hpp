@@ -0,0 +1,101 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!\file SiconosAlgebraSmallOps.hpp
+  \brief raw-storage fast paths for small dense vector and matrix operations
+*/
+
+#ifndef SiconosAlgebraSmallOps_H
+#define SiconosAlgebraSmallOps_H
+
+/** Small dense operations (the majority in the OSI and relation hot
+ *  loops) pay more for the ublas expression machinery -- iterators,
+ *  proxies, dispatch -- than for the arithmetic itself, and they are
+ *  also too small for a BLAS call to amortize its entry cost.  The
+ *  kernels below are plain loops on the raw storage pointers, simple
+ *  enough for the compiler to unroll and vectorize; the callers in
+ *  SiconosAlgebra select them at runtime for dense operands whose sizes
+ *  do not exceed SICONOS_SMALL_DENSE_THRESHOLD, and keep the ublas/BLAS
+ *  path for everything else.
+ */
+namespace Siconos
+{
+namespace smallops
+{
+
+/** size (rows and columns) up to which the raw loops win over ublas and
+    over a BLAS call */
+constexpr unsigned int SICONOS_SMALL_DENSE_THRESHOLD = 32;
+
+/** y = x */
+inline void copy(unsigned int n, const double* x, double* y)
+{
+  for(unsigned int i = 0; i < n; ++i) y[i] = x[i];
+}
+
+/** y = a*x (init) or y += a*x */
+inline void axpy(unsigned int n, double a, const double* x, double* y, bool init)
+{
+  if(init)
+    for(unsigned int i = 0; i < n; ++i) y[i] = a * x[i];
+  else
+    for(unsigned int i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
+/** \return x . y */
+inline double dot(unsigned int n, const double* x, const double* y)
+{
+  double r = 0.0;
+  for(unsigned int i = 0; i < n; ++i) r += x[i] * y[i];
+  return r;
+}
+
+/** y = a*A*x (init) or y += a*A*x, A dense column major, m rows and n
+    columns, x and y distinct */
+inline void gemv(unsigned int m, unsigned int n, double a,
+                 const double* A, const double* x, double* y, bool init)
+{
+  if(init)
+    for(unsigned int i = 0; i < m; ++i) y[i] = 0.0;
+  for(unsigned int j = 0; j < n; ++j)
+  {
+    double axj = a * x[j];
+    const double* col = A + (size_t)j * m;
+    for(unsigned int i = 0; i < m; ++i) y[i] += col[i] * axj;
+  }
+}
+
+/** y = a*A^T*x (init) or y += a*A^T*x, A dense column major, m rows and
+    n columns (y has n entries), x and y distinct */
+inline void gemv_trans(unsigned int m, unsigned int n, double a,
+                       const double* A, const double* x, double* y, bool init)
+{
+  for(unsigned int j = 0; j < n; ++j)
+  {
+    const double* col = A + (size_t)j * m;
+    double r = 0.0;
+    for(unsigned int i = 0; i < m; ++i) r += col[i] * x[i];
+    if(init) y[j] = a * r;
+    else y[j] += a * r;
+  }
+}
+
+}
+}
+
+#endif
@@ -17,10 +17,13 @@
 */
 
 
+#include "SiconosAlgebra.hpp" // for DenseMat
 #include "SiconosMatrix.hpp"
 #include "BlockVector.hpp"
 #include "SiconosVector.hpp"
 #include "SiconosAlgebraTools.hpp"
+#include <cassert>
+#include <cstring> // for memcpy
 #include <iostream>
 
 namespace Siconos
@@ -28,6 +31,23 @@ namespace Siconos
 namespace Algebra
 {
 
+DenseBlockView::DenseBlockView(DenseMat& m, std::size_t row, std::size_t col,
+                               std::size_t nbrows, std::size_t nbcols)
+  : ptr(&m.data()[0] + row + col * m.size1()),
+    rows(nbrows), cols(nbcols), ld(m.size1())
+{}
+
+void copyBlock(const DenseBlockView& src, const DenseBlockView& dst)
+{
+  assert(src.rows == dst.rows && src.cols == dst.cols);
+
+  if(src.contiguous() && dst.contiguous())
+    std::memcpy(dst.ptr, src.ptr, src.rows * src.cols * sizeof(double));
+  else
+    for(std::size_t j = 0; j < src.cols; ++j)
+      std::memcpy(dst.column(j), src.column(j), src.rows * sizeof(double));
+}
+
 bool isComparableTo(const BlockVector& v1, const BlockVector& v2)
 {
   // return:
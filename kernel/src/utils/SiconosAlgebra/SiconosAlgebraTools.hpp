@@ -22,12 +22,43 @@
 #ifndef SICONOSALGEBRATOOLS_H
 #define SICONOSALGEBRATOOLS_H
 
+#include "SiconosAlgebraTypeDef.hpp" // for DenseMat
+
 class SiconosMatrix;
 class BlockVector;
 
 namespace Siconos {
   namespace Algebra {
 
+    /** Non-owning view over a rectangular block of a column-major dense
+        matrix. Each column of the block is contiguous in memory, so blocks
+        can be moved around with one memcpy per column (a single one when
+        the block spans whole columns) instead of element-wise ublas proxy
+        assignments. The (ptr, ld) pair can also be handed directly to
+        cblas routines operating on sub-matrices. */
+    struct DenseBlockView
+    {
+      double* ptr;      /**< first element of the block */
+      std::size_t rows; /**< number of rows of the block */
+      std::size_t cols; /**< number of columns of the block */
+      std::size_t ld;   /**< leading dimension (rows of the viewed matrix) */
+
+      DenseBlockView(DenseMat& m, std::size_t row, std::size_t col,
+                     std::size_t nbrows, std::size_t nbcols);
+
+      /** first element of column j of the block */
+      double* column(std::size_t j) const { return ptr + j * ld; }
+
+      /** true when the block spans whole columns of the viewed matrix */
+      bool contiguous() const { return rows == ld; }
+    };
+
+    /** bulk copy of a dense block into another one of the same dimensions
+        \param src the block to be read
+        \param dst the block to be overwritten (must not overlap src)
+    */
+    void copyBlock(const DenseBlockView& src, const DenseBlockView& dst);
+
 
     /** test if two BlockVectors have the same number of blocks with
         blocks of the same size when at the same position
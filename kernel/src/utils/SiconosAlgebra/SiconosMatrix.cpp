@@ -389,6 +389,24 @@ bool SiconosMatrix::fillTriplet(CSparseMatrix* triplet, size_t row_off, size_t c
       }
     }
   }
+  else if(_num == Siconos::SPARSE)
+  {
+    // Insert stored entries only; the compressed storage is column-major
+    // (see fillCSC), so index1 holds the column pointers.
+    const Index& ptr = sparse()->index1_data();
+    const Index& indx = sparse()->index2_data();
+    const ublas::unbounded_array<double>& vals = sparse()->value_data();
+
+    assert(ptr.size() >= ncol + 1);
+
+    for(size_t j = 0; j < ncol; ++j)
+    {
+      for(size_t p = ptr[j]; p < ptr[j + 1]; ++p)
+      {
+        CSparseMatrix_zentry(triplet, indx[p] + row_off, j + col_off, vals[p], DBL_EPSILON);
+      }
+    }
+  }
   else
   {
     THROW_EXCEPTION("not implemented for the given matrix type");
@@ -23,6 +23,7 @@
 #include <boost/numeric/ublas/banded.hpp>
 #include <boost/numeric/ublas/matrix_sparse.hpp>
 #include "SiconosMatrix.hpp"
+#include "SiconosAlgebraTools.hpp" // for Siconos::Algebra::DenseBlockView
 #include "SiconosException.hpp"
 
 void setBlock(SPC::SiconosMatrix  input_matrix, SP::SiconosMatrix output_matrix, const Index& dim, const Index& start)
@@ -331,17 +332,22 @@ void setBlock(SPC::SiconosMatrix  input_matrix, SP::SiconosMatrix output_matrix,
   {
     if(numOut == Siconos::DENSE)
     {
-      ublas::matrix_range<DenseMat> out_range(*output_matrix->dense(),
-                                              ublas::range(start[2],end[2]),
-                                              ublas::range(start[3], end[3]));
       if(numIn == Siconos::DENSE)
       {
-        ublas::matrix_range<DenseMat> in_range(*input_matrix->dense(),
-                                               ublas::range(start[0],end[0]),
-                                               ublas::range(start[1], end[1]));
-        noalias(out_range) = in_range;
+        // dense -> dense: block columns are contiguous in the column-major
+        // storage, copy them in bulk rather than through ublas proxies.
+        Siconos::Algebra::DenseBlockView in_view(*input_matrix->dense(),
+                                                 start[0], start[1], dim[0], dim[1]);
+        Siconos::Algebra::DenseBlockView out_view(*output_matrix->dense(),
+                                                  start[2], start[3], dim[0], dim[1]);
+        Siconos::Algebra::copyBlock(in_view, out_view);
+        output_matrix->resetFactorizationFlags();
+        return;
       }
-      else if(numIn == Siconos::SYMMETRIC)
+      ublas::matrix_range<DenseMat> out_range(*output_matrix->dense(),
+                                              ublas::range(start[2],end[2]),
+                                              ublas::range(start[3], end[3]));
+      if(numIn == Siconos::SYMMETRIC)
       {
         ublas::matrix_range<SymMat> in_range(*input_matrix->sym(),
                                              ublas::range(start[0],end[0]),
@@ -38,6 +38,7 @@ namespace siconosBindings = boost::numeric::bindings::blas;
 #include "ioVector.hpp"
 #include "SiconosVector.hpp"
 #include "SiconosAlgebra.hpp"
+#include "SiconosAlgebraSmallOps.hpp"
 #include <cmath>        // std::exp(double)
 #include <algorithm>    // std::transform
 #include "SiconosException.hpp"
@@ -182,6 +183,18 @@ SiconosVector::SiconosVector(const SiconosVector &svect) : std::enable_shared_fr
 }
 
 
+// Move: steal the ublas vector, the source keeps a null pointer and may
+// only be destroyed or assigned to afterwards.
+SiconosVector::SiconosVector(SiconosVector &&svect) noexcept : std::enable_shared_from_this<SiconosVector>()
+{
+  _dense = svect._dense;
+  vect = svect.vect;
+  if(_dense)
+    svect.vect.Dense = nullptr;
+  else
+    svect.vect.Sparse = nullptr;
+}
+
 SiconosVector::SiconosVector(const DenseVect& m)
 {
   _dense = true;
@@ -190,6 +203,14 @@ SiconosVector::SiconosVector(const DenseVect& m)
 
 }
 
+SiconosVector::SiconosVector(DenseVect&& m)
+{
+  _dense = true;
+  // ublas swap is O(1): the content of m ends up here without a copy
+  vect.Dense = new DenseVect();
+  vect.Dense->swap(m);
+}
+
 SiconosVector::SiconosVector(const SparseVect& m)
 {
   _dense = false;
@@ -577,6 +598,26 @@ SiconosVector& SiconosVector::operator = (const SiconosVector& vIn)
   return *this;
 }
 
+SiconosVector& SiconosVector::operator = (SiconosVector&& vIn) noexcept
+{
+  if(&vIn == this) return *this;  // auto-assignment.
+
+  assert(size() == vIn.size() && "SiconosVector::operator = failed: inconsistent sizes.");
+
+  if(_dense)
+    delete vect.Dense;
+  else
+    delete vect.Sparse;
+
+  _dense = vIn._dense;
+  vect = vIn.vect;
+  if(_dense)
+    vIn.vect.Dense = nullptr;
+  else
+    vIn.vect.Sparse = nullptr;
+  return *this;
+}
+
 SiconosVector& SiconosVector::operator = (const BlockVector& vIn)
 {
   VectorOfVectors::const_iterator it;
@@ -1089,7 +1130,12 @@ double inner_prod(const SiconosVector &x, const SiconosVector &m)
   if(numX == numM)
   {
     if(numM == Siconos::DENSE)
+    {
+      // small fast path: skip the BLAS call entry cost
+      if(x.size() <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD)
+        return Siconos::smallops::dot(x.size(), x.getArray(), m.getArray());
       return siconosBindings::dot(*x.dense(), *m.dense());
+    }
     else
       return inner_prod(*x.sparse(), *m.sparse());
   }
@@ -1151,7 +1197,10 @@ void scal(double a, const SiconosVector & x, SiconosVector & y, bool init)
 
       if(numX == Siconos::DENSE)  // ie if both are Dense
       {
-        if(init)
+        // small fast path: plain loop on the raw storage
+        if(sizeX <= Siconos::smallops::SICONOS_SMALL_DENSE_THRESHOLD)
+          Siconos::smallops::axpy(sizeX, a, x.getArray(), y.getArray(), init);
+        else if(init)
           //siconosBindings::axpby(a,*x.dense(),0.0,*y.dense());
           noalias(*y.dense()) = a * *x.dense();
         else
@@ -90,12 +90,25 @@ public:
    */
   SiconosVector(const SiconosVector& v);
 
+  /** move constructor: steals the internal storage of the source, which is
+   *  left empty and only fit for destruction or assignment.
+   *
+   *  \param v source vector
+   */
+  SiconosVector(SiconosVector&& v) noexcept;
+
   /** creates a dense vector, with a copy.
    *
    *  \param v source vector (ublas dense)
    */
   SiconosVector(const DenseVect& v);
 
+  /** creates a dense vector, stealing the storage of an ublas temporary.
+   *
+   *  \param v source vector (ublas dense), emptied by the call
+   */
+  SiconosVector(DenseVect&& v);
+
   /** creates a sparse vector, with a copy.
    *
    *  \param v source vector (ublas sparse)
@@ -292,6 +305,14 @@ public:
    */
   SiconosVector& operator = (const SiconosVector& v);
 
+  /** move assignment: steals the internal storage of the source, which is
+   *  left empty and only fit for destruction or assignment.
+   *
+   *  \param v the vector to be moved
+   *  \return SiconosVector&
+   */
+  SiconosVector& operator = (SiconosVector&& v) noexcept;
+
   /** operator =
    *
    *  \param b the vector to be copied
@@ -35,7 +35,7 @@
 #include "NumericsMatrix.h"
 
 #include "NumericsSparseMatrix.h"
-#include "CSparseMatrix.h"
+#include "CSparseMatrix_internal.h"                   // for CSparseMatrix
 
 //#define DEBUG_MESSAGES
 #include "siconos_debug.h"
@@ -432,6 +432,21 @@ SimpleMatrix::~SimpleMatrix()
 }
 
 
+/* deleter for a NumericsMatrix whose csc header points into the ublas
+   compressed matrix of a SimpleMatrix: the index and value arrays belong
+   to the boost container, only the headers (and whatever factorization
+   or alternate storage a solver may have attached) are freed */
+static void NM_free_sparse_view(NumericsMatrix* m)
+{
+  if(m->matrix2 && m->matrix2->csc)
+  {
+    m->matrix2->csc->p = nullptr;
+    m->matrix2->csc->i = nullptr;
+    m->matrix2->csc->x = nullptr;
+  }
+  NM_free(m);
+}
+
 void SimpleMatrix::updateNumericsMatrix()
 {
   /* set the numericsMatrix */
@@ -445,6 +460,32 @@ void SimpleMatrix::updateNumericsMatrix()
     DEBUG_EXPR(NV_display(data,size(0)*size(1)););
     NM_fill(NM, NM_DENSE, size(0), size(1), data ); // Pointer link
   }
+  else if(_num == Siconos::SPARSE
+          && sizeof(CS_INT) == sizeof(Index::value_type))
+  {
+    // Same deal as the dense case, for compressed storage: the ublas
+    // compressed matrix is already column-compressed, so when the index
+    // widths agree the csc header can point straight into the boost
+    // container instead of copying every entry. The view follows the
+    // lifetime rules of the dense pointer link: it is valid until the
+    // matrix is structurally modified (new non-zero, resize) or
+    // destroyed, after which updateNumericsMatrix must be called again.
+    mat.Sparse->complete_index1_data();
+    _numericsMatrix.reset(NM_create(NM_SPARSE, size(0), size(1)),
+                          NM_free_sparse_view);
+    NM = _numericsMatrix.get();
+    NM->matrix2->origin = NSM_CSC;
+    CSparseMatrix* csc = (CSparseMatrix*)calloc(1, sizeof(CSparseMatrix));
+    csc->m = size(0);
+    csc->n = size(1);
+    csc->nzmax = (CS_INT)mat.Sparse->nnz();
+    csc->nz = -1; // compressed column
+    csc->p = reinterpret_cast<CS_INT*>(&(mat.Sparse->index1_data()[0]));
+    csc->i = reinterpret_cast<CS_INT*>(&(mat.Sparse->index2_data()[0]));
+    csc->x = &(mat.Sparse->value_data()[0]);
+    NM->matrix2->csc = csc;
+    DEBUG_EXPR(cs_print(NM->matrix2->csc, 0););
+  }
   else
   {
     // For all the other cases, we build a sparse matrix and we call numerics for the factorization of a sparse matrix.
@@ -25,6 +25,7 @@
 #include "BlockMatrix.hpp"
 
 #include "SiconosAlgebra.hpp"
+#include "SiconosAlgebraTools.hpp" // for Siconos::Algebra::DenseBlockView
 #include "SiconosException.hpp"
 
 using namespace Siconos;
@@ -167,7 +168,14 @@ void SimpleMatrix::setBlock(unsigned int row_min, unsigned int col_min, const Si
       THROW_EXCEPTION("Inconsistent matrix types.");
 
     if(_num == Siconos::DENSE)
-      noalias(ublas::subrange(*mat.Dense, row_min, row_max, col_min, col_max)) = *(m.dense());
+    {
+      // block columns are contiguous in the column-major storage: bulk copy
+      // (this is the hot path of the OSNS matrix assembly).
+      Algebra::DenseBlockView in_view(*m.dense(), 0, 0, m.size(0), m.size(1));
+      Algebra::DenseBlockView out_view(*mat.Dense, row_min, col_min,
+                                       row_max - row_min, col_max - col_min);
+      Algebra::copyBlock(in_view, out_view);
+    }
     else if(_num == Siconos::TRIANGULAR)
       noalias(ublas::subrange(*mat.Triang, row_min, row_max, col_min, col_max)) = *(m.triang());
     else if(_num == Siconos::SYMMETRIC)
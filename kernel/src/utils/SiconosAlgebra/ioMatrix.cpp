@@ -20,6 +20,14 @@
 #include <iostream>
 #include <fstream>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#endif
 #include "ioMatrix.hpp"
 #include "SiconosMatrix.hpp"
 #include "SiconosException.hpp"
@@ -32,8 +40,109 @@
 
 namespace ioMatrix
 {
+
+/** Layout of the "mmap" format: this fixed header followed by the raw
+ *  column-major payload (size1*size2 doubles, the native layout of
+ *  DenseMat), so that a file can be mapped and transferred without any
+ *  parsing. 24 bytes, no padding. */
+struct BinaryHeader
+{
+  char magic[8];
+  std::uint64_t size1;
+  std::uint64_t size2;
+};
+
+static const char binaryMagic[8] = {'S', 'i', 'c', 'o', 'M', 'a', 't', '\0'};
+
+/* read a file in the "mmap" format, through a memory mapping when
+   available: the payload goes from the page cache to the matrix with a
+   single copy, with no parsing and no stream buffer */
+static bool readBinary(const std::string& fileName, SiconosMatrix& m)
+{
+  if(m.isBlock())
+    THROW_EXCEPTION("not yet implemented for block matrix.");
+
+  DenseMat& p = *m.dense();
+
+#ifndef _WIN32
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    THROW_EXCEPTION("cannot open file " + fileName);
+
+  struct stat st;
+  if(fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(BinaryHeader))
+  {
+    close(fd);
+    THROW_EXCEPTION("file " + fileName + " is not a matrix in binary format (too short)");
+  }
+
+  void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(mapping == MAP_FAILED)
+    THROW_EXCEPTION("cannot map file " + fileName);
+
+  const BinaryHeader* header = static_cast<const BinaryHeader*>(mapping);
+  if(std::memcmp(header->magic, binaryMagic, sizeof(binaryMagic)) != 0
+     || (size_t)st.st_size != sizeof(BinaryHeader) + sizeof(double) * header->size1 * header->size2)
+  {
+    munmap(mapping, st.st_size);
+    THROW_EXCEPTION("file " + fileName + " is not a matrix in binary format");
+  }
+
+  if(header->size1 != p.size1() || header->size2 != p.size2())
+    p.resize(header->size1, header->size2);
+
+  std::memcpy(&p.data()[0], header + 1, sizeof(double) * header->size1 * header->size2);
+  munmap(mapping, st.st_size);
+#else
+  std::ifstream infile(fileName.c_str(), std::ifstream::binary);
+  if(!infile.good())
+    THROW_EXCEPTION("cannot open file " + fileName);
+
+  BinaryHeader header;
+  infile.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if(!infile.good() || std::memcmp(header.magic, binaryMagic, sizeof(binaryMagic)) != 0)
+    THROW_EXCEPTION("file " + fileName + " is not a matrix in binary format");
+
+  if(header.size1 != p.size1() || header.size2 != p.size2())
+    p.resize(header.size1, header.size2);
+
+  infile.read(reinterpret_cast<char*>(&p.data()[0]), sizeof(double) * header.size1 * header.size2);
+  if(!infile.good())
+    THROW_EXCEPTION("truncated binary matrix file " + fileName);
+#endif
+  return true;
+}
+
+/* write a file in the "mmap" format: header + raw column-major payload */
+static bool writeBinary(const std::string& fileName, const SiconosMatrix& m)
+{
+  if(m.isBlock())
+    THROW_EXCEPTION("not yet implemented for BlockMatrix");
+  if(m.num() != Siconos::DENSE)
+    THROW_EXCEPTION("the mmap mode is only implemented for dense matrices.");
+
+  std::ofstream outfile(fileName.c_str(), std::ofstream::binary);
+  if(!outfile.good())
+    THROW_EXCEPTION("cannot open file " + fileName);
+
+  BinaryHeader header;
+  std::memcpy(header.magic, binaryMagic, sizeof(binaryMagic));
+  header.size1 = m.size(0);
+  header.size2 = m.size(1);
+  outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  const DenseMat& p = *m.dense();
+  outfile.write(reinterpret_cast<const char*>(&p.data()[0]),
+                sizeof(double) * header.size1 * header.size2);
+  return outfile.good();
+}
+
 bool read(const std::string& fileName, const std::string& mode, SiconosMatrix& m)
 {
+  if(mode == "mmap")
+    return readBinary(fileName, m);
+
   std::ifstream infile;
   if(mode == "ascii")
     infile.open(fileName.c_str(), std::ifstream::in);
@@ -95,6 +204,9 @@ bool read(const std::string& fileName, const std::string& mode, SiconosMatrix& m
 
 bool write(const std::string& fileName, const std::string& mode, const SiconosMatrix& m, const std::string& outputType)
 {
+  if(mode == "mmap")
+    return writeBinary(fileName, m);
+
   // Open file and various checks
   std::ofstream outfile;
   if(mode == "ascii")
@@ -36,7 +36,10 @@ namespace ioMatrix {
      Read a SiconosMatrix
      
      \param[in] fileName the name of the file to read
-     \param[in] mode the storage type used in the file (either ascii or binary)
+     \param[in] mode the storage type used in the file: "ascii", "binary"
+     (text streams), or "mmap" (fixed header plus raw column-major payload,
+     read through a memory mapping without any parsing; this is the format
+     to use for large matrices)
      \param[in,out] m the SiconosMatrix to be filled
      \return true if read ok, else false ...
   */
@@ -46,7 +49,9 @@ namespace ioMatrix {
      Write a SiconosMatrix
      
      \param[in] fileName the name of the file to write in
-     \param[in] mode the storage type used in the file (either ascii or binary)
+     \param[in] mode the storage type used in the file: "ascii", "binary"
+     (text streams), or "mmap" (binary header plus raw column-major
+     payload, dense matrices only; outputType is ignored)
      \param[in] m the SiconosMatrix to write
      \param[in] outputType type of output:
      - "python"(default):
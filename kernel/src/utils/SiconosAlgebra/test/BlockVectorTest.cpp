@@ -488,6 +488,30 @@ void BlockVectorTest::testInsert()
   std::cout << "--> insert test ended with success." <<std::endl;
 }
 
+void BlockVectorTest::testCopyDense()
+{
+  std::cout << "--> Test: copyDense." <<std::endl;
+  unsigned int size1 = 3, size2 = 5, size = size1 + size2;
+  SP::SiconosVector tmp1(new SiconosVector(size1, 2.));
+  SP::SiconosVector tmp2(new SiconosVector(size2, 3.));
+  SP::BlockVector v(new BlockVector(tmp1, tmp2));
+
+  std::vector<double> data(size);
+  v->copyToDense(data.data());
+  for(unsigned int i = 0; i < size1; i++)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("testCopyDense : ", data[i] == 2., true);
+  for(unsigned int i = size1; i < size; i++)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("testCopyDense : ", data[i] == 3., true);
+
+  for(unsigned int i = 0; i < size; i++)
+    data[i] = i;
+  v->copyFromDense(data.data());
+  for(unsigned int i = 0; i < size; i++)
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("testCopyDense : ", (*v)(i) == i, true);
+
+  std::cout << "--> copyDense test ended with success." <<std::endl;
+}
+
 void BlockVectorTest::End()
 {
   std::cout << "======================================" <<std::endl;
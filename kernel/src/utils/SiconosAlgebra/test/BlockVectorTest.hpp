@@ -54,6 +54,7 @@ private:
   CPPUNIT_TEST(testOperators4);
   CPPUNIT_TEST(testSetBlock);
   CPPUNIT_TEST(testInsert);
+  CPPUNIT_TEST(testCopyDense);
   CPPUNIT_TEST(End);
 
   CPPUNIT_TEST_SUITE_END();
@@ -75,6 +76,7 @@ private:
   void testOperators4();
   void testSetBlock();
   void testInsert();
+  void testCopyDense();
   void End();
   // Members
 
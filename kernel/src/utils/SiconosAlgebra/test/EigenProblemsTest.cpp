@@ -21,8 +21,10 @@
 #include "SiconosAlgebra.hpp"
 #include "SimpleMatrixFriends.hpp"
 #include "bindings_utils.hpp"
+#include <cmath>
 #include <limits>
 #include <iostream>
+#include "SiconosAlgebraProd.hpp" // for prod(A, x, y, init)
 #include <boost/numeric/ublas/io.hpp>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 #include "SiconosVector.hpp"
@@ -164,6 +166,63 @@ void EigenProblemsTest::testGeev3()
   std::cout << "--> geev3 test ended with success." <<std::endl;
 }
 
+void EigenProblemsTest::testLanczos()
+{
+  std::cout << "--> Test: lanczos." <<std::endl;
+
+  // 1D Laplacian with sparse storage; its eigenvalues are known:
+  // lambda_i = 4 sin^2(i pi / (2(n+1))), i = 1..n.
+  unsigned int n = 50;
+  SP::SimpleMatrix L(new SimpleMatrix(n, n, Siconos::SPARSE));
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    L->setValue(i, i, 2.0);
+    if(i + 1 < n)
+    {
+      L->setValue(i, i + 1, -1.0);
+      L->setValue(i + 1, i, -1.0);
+    }
+  }
+
+  unsigned int k = 4;
+  SP::SiconosVector eigenval(new SiconosVector(k));
+  SP::SimpleMatrix eigenvec(new SimpleMatrix(n, k));
+
+  // k smallest eigenpairs, shift-invert through the sparse factorization.
+  int info = Siconos::eigenproblems::lanczos(*L, k, *eigenval, *eigenvec);
+  CPPUNIT_ASSERT_EQUAL_MESSAGE("testLanczos 1: ", info, 0);
+
+  for(unsigned int i = 0; i < k; ++i)
+  {
+    double expected = 4.0 * std::pow(std::sin((i + 1) * M_PI / (2.0 * (n + 1))), 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("testLanczos 2: ",
+                                 std::fabs(eigenval->getValue(i) - expected) < 1e-8, true);
+  }
+
+  // Residual check on the returned pairs, through the sparse prod path.
+  SiconosVector x(n), Lx(n);
+  for(unsigned int i = 0; i < k; ++i)
+  {
+    noalias(*x.dense()) = column(*eigenvec->dense(), i);
+    prod(*L, x, Lx, true);
+    noalias(*Lx.dense()) -= eigenval->getValue(i) * (*x.dense());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("testLanczos 3: ", norm_2(*Lx.dense()) < 1e-8, true);
+  }
+
+  // k largest eigenpairs, plain iteration.
+  info = Siconos::eigenproblems::lanczos(*L, k, *eigenval, *eigenvec, false);
+  CPPUNIT_ASSERT_EQUAL_MESSAGE("testLanczos 4: ", info, 0);
+  for(unsigned int i = 0; i < k; ++i)
+  {
+    unsigned int mode = n - k + i + 1;
+    double expected = 4.0 * std::pow(std::sin(mode * M_PI / (2.0 * (n + 1))), 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("testLanczos 5: ",
+                                 std::fabs(eigenval->getValue(i) - expected) < 1e-8, true);
+  }
+
+  std::cout << "--> lanczos test ended with success." <<std::endl;
+}
+
 void EigenProblemsTest::End()
 {
   std::cout << "======================================" <<std::endl;
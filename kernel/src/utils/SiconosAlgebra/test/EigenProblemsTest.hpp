@@ -36,6 +36,7 @@ private:
   CPPUNIT_TEST(testGeev1);
   CPPUNIT_TEST(testGeev2);
   CPPUNIT_TEST(testGeev3);
+  CPPUNIT_TEST(testLanczos);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -43,6 +44,7 @@ private:
   void testGeev1();
   void testGeev2();
   void testGeev3();
+  void testLanczos();
 
   void End();
 
@@ -23,11 +23,17 @@
 
 // From the size of the container (number of saved vectors) and
 // the size of the vectors.
+// The whole ring is preallocated in one burst: the slots are reserved
+// then built back to back, so their buffers come out of the allocator
+// close to each other and the history reads of the integrators stay
+// local. Afterwards swap() is a plain index rotation, no slot is ever
+// (re)allocated during the simulation.
 SiconosMemory::SiconosMemory(const unsigned int size, const unsigned int vectorSize): MemoryContainer(), _indx(size-1)
 {
+  reserve(size);
   for(unsigned int i = 0; i < size; i++)
   {
-    push_back(SiconosVector(vectorSize));
+    emplace_back(vectorSize);
   }
 }
 
@@ -37,6 +43,7 @@ SiconosMemory::SiconosMemory(const SiconosMemory& Mem)
     _nbVectorsInMemory(Mem.nbVectorsInMemory()),
     _indx(Mem.size()-1)
 {
+  reserve(Mem.size());
   for(unsigned int i = 0; i < Mem.size(); i++)
   {
     push_back(Mem[i]);
@@ -66,28 +73,36 @@ void SiconosMemory::setMemorySize(const unsigned int steps,
 {
   _nbVectorsInMemory = 0;
   _indx = steps-1;
+  reserve(steps);
   for(unsigned int i = 0; i < size(); i++)
   {
     this->at(i).resize(vectorSize, true);
   }
   for(unsigned int i = size(); i < steps; i++)
   {
-    this->push_back(SiconosVector(vectorSize));
+    this->emplace_back(vectorSize);
   }
 }
 
 // --- GETTERS/SETTERS ---
 
+// The ring never holds more than size() vectors, so the wrap-around is a
+// conditional subtraction instead of an integer division: these getters
+// sit in the history reads of the OSI computeFreeState loops.
 const SiconosVector& SiconosMemory::getSiconosVector(const unsigned int index) const
 {
   assert(index < _nbVectorsInMemory && "getSiconosVector(index) : inconsistent index value");
-  return this->at((_indx + 1 + index) % this->size());
+  MemoryContainer::size_type pos = _indx + 1 + index;
+  if(pos >= this->size()) pos -= this->size();
+  return (*this)[pos];
 }
 
 SiconosVector& SiconosMemory::getSiconosVectorMutable(const unsigned int index)
 {
   assert(index < _nbVectorsInMemory && "getSiconosVector(index) : inconsistent index value");
-  return *(SiconosVector*)(&this->at((_indx + 1 + index) % this->size()));
+  MemoryContainer::size_type pos = _indx + 1 + index;
+  if(pos >= this->size()) pos -= this->size();
+  return (*this)[pos];
 }
 
 void SiconosMemory::swap(const SiconosVector& v)
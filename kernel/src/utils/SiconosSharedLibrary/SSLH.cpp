@@ -90,6 +90,17 @@ void setFunction(void* fPtr, const std::string& pluginPath, const std::string& f
   *(void **)(fPtr) = SiconosSharedLibrary::getProcAddress(handle, fName.c_str());
 }
 
+void setFunctionIfPresent(void* fPtr, const std::string& pluginPath, const std::string& fName)
+{
+  // load the library
+  PluginHandle handle = SiconosSharedLibrary::loadPlugin(pluginPath.c_str());
+  // get the function pointer, nullptr when the symbol is not exported
+  *(void **)(fPtr) = SiconosSharedLibrary::tryProcAddress(handle, fName.c_str());
+  // drop the reference taken by loadPlugin: the caller is expected to hold
+  // the plugin open through a mandatory symbol of the same library
+  SiconosSharedLibrary::closePlugin(pluginPath);
+}
+
 void closePlugin(const std::string& pluginPath)
 {
   SiconosSharedLibrary::closePlugin(getPluginName(pluginPath));
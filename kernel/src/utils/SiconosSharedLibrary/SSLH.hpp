@@ -40,6 +40,11 @@ namespace SSLH
 
   void setFunction(void* fPtr, const std::string& pluginPath, const std::string& fName);
 
+  /* like setFunction, but leaves *fPtr to nullptr when the plugin does not
+     export the function instead of failing (used for optional companion
+     symbols such as the batched variants) */
+  void setFunctionIfPresent(void* fPtr, const std::string& pluginPath, const std::string& fName);
+
   void closePlugin(const std::string& pluginPath);
 }
 
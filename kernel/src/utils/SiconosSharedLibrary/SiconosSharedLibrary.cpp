@@ -94,6 +94,16 @@ void * getProcAddress(PluginHandle plugin, const std::string& procedure)
   return ptr;
 }
 
+void * tryProcAddress(PluginHandle plugin, const std::string& procedure)
+{
+#ifdef _WIN32
+  return (void*) GetProcAddress(plugin, procedure.c_str());
+#endif
+#ifdef _SYS_UNX
+  return dlsym(plugin, procedure.c_str());
+#endif
+}
+
 void closePlugin(const std::string& pluginFile)
 {
   iter it = openedPlugins.find(pluginFile);
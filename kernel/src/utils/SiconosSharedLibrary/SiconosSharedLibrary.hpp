@@ -56,7 +56,14 @@ namespace SiconosSharedLibrary
    * \return pointer on procedure
    */
   void * getProcAddress(PluginHandle plugin, const std::string& procedure);
-  
+
+  /** Gets procedure address, without failing
+   * \param plugin the plugin handle
+   * \param procedure the procedure name
+   * \return pointer on procedure, or nullptr when the plugin does not export it
+   */
+  void * tryProcAddress(PluginHandle plugin, const std::string& procedure);
+
   /**  Closes plugin
    * \param pluginFile the name of the plugin to close
    */
@@ -410,3 +410,103 @@ void compositionLawLieGroup(const SiconosVector& a, SiconosVector& b)
   b.setValue(6,quat_ab.R_component_4());
   //normalizeq(b);
 }
+
+void quaternionRotateBatch(const double* quat, double* v, unsigned int number)
+{
+  // same math as the scalar quaternionRotate (direct computation with
+  // cross products, unit quaternions only), unrolled on indexed arrays
+  for(unsigned int i = 0; i < number; ++i)
+  {
+    const double q0 = quat[4 * i];
+    const double q1 = quat[4 * i + 1];
+    const double q2 = quat[4 * i + 2];
+    const double q3 = quat[4 * i + 3];
+    const double v0 = v[3 * i];
+    const double v1 = v[3 * i + 1];
+    const double v2 = v[3 * i + 2];
+
+    // t = 2 (qvect x v)
+    const double t0 = 2.0 * (q2 * v2 - q3 * v1);
+    const double t1 = 2.0 * (q3 * v0 - q1 * v2);
+    const double t2 = 2.0 * (q1 * v1 - q2 * v0);
+
+    // v += qvect x t + q0 t
+    v[3 * i]     = v0 + q2 * t2 - q3 * t1 + q0 * t0;
+    v[3 * i + 1] = v1 + q3 * t0 - q1 * t2 + q0 * t1;
+    v[3 * i + 2] = v2 + q1 * t1 - q2 * t0 + q0 * t2;
+  }
+}
+
+void quaternionComposeBatch(const double* a, const double* b, double* ab,
+                            unsigned int number)
+{
+  for(unsigned int i = 0; i < number; ++i)
+  {
+    const double a0 = a[4 * i];
+    const double a1 = a[4 * i + 1];
+    const double a2 = a[4 * i + 2];
+    const double a3 = a[4 * i + 3];
+    const double b0 = b[4 * i];
+    const double b1 = b[4 * i + 1];
+    const double b2 = b[4 * i + 2];
+    const double b3 = b[4 * i + 3];
+
+    ab[4 * i]     = a0 * b0 - a1 * b1 - a2 * b2 - a3 * b3;
+    ab[4 * i + 1] = a0 * b1 + a1 * b0 + a2 * b3 - a3 * b2;
+    ab[4 * i + 2] = a0 * b2 - a1 * b3 + a2 * b0 + a3 * b1;
+    ab[4 * i + 3] = a0 * b3 + a1 * b2 - a2 * b1 + a3 * b0;
+  }
+}
+
+void quaternionNormalizeBatch(double* quat, unsigned int number)
+{
+  for(unsigned int i = 0; i < number; ++i)
+  {
+    const double q0 = quat[4 * i];
+    const double q1 = quat[4 * i + 1];
+    const double q2 = quat[4 * i + 2];
+    const double q3 = quat[4 * i + 3];
+    double normq = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    assert(normq > 0);
+    normq = 1.0 / normq;
+    quat[4 * i]     = q0 * normq;
+    quat[4 * i + 1] = q1 * normq;
+    quat[4 * i + 2] = q2 * normq;
+    quat[4 * i + 3] = q3 * normq;
+  }
+}
+
+void twistIncrementComposeBatch(const double* qold, const double* twistIncrement,
+                                double* q, unsigned int number)
+{
+  for(unsigned int i = 0; i < number; ++i)
+  {
+    const double* dv = &twistIncrement[6 * i];
+    const double* qo = &qold[7 * i];
+    double* qn = &q[7 * i];
+
+    // increment quaternion from the rotational part of the twist
+    // increment (same math as quaternionFromTwistVector)
+    const double angle = sqrt(dv[3] * dv[3] + dv[4] * dv[4] + dv[5] * dv[5]);
+    const double f = 0.5 * sin_x(angle * 0.5);
+    const double b0 = cos(angle / 2.0);
+    const double b1 = dv[3] * f;
+    const double b2 = dv[4] * f;
+    const double b3 = dv[5] * f;
+
+    // composition law: addition of the translations, quaternion product
+    // for the rotations (same math as compositionLawLieGroup)
+    qn[0] = qo[0] + dv[0];
+    qn[1] = qo[1] + dv[1];
+    qn[2] = qo[2] + dv[2];
+
+    const double a0 = qo[3];
+    const double a1 = qo[4];
+    const double a2 = qo[5];
+    const double a3 = qo[6];
+    qn[3] = a0 * b0 - a1 * b1 - a2 * b2 - a3 * b3;
+    qn[4] = a0 * b1 + a1 * b0 + a2 * b3 - a3 * b2;
+    qn[5] = a0 * b2 - a1 * b3 + a2 * b0 + a3 * b1;
+    qn[6] = a0 * b3 + a1 * b2 - a2 * b1 + a3 * b0;
+  }
+}
@@ -137,4 +137,46 @@ void compositionLawLieGroup(const SiconosVector& a, SiconosVector& b, SiconosVec
 
 void compositionLawLieGroup(const SiconosVector& a, SiconosVector& b);
 
+/* Batch variants over contiguous arrays, for callers updating many bodies
+ * at once (integrators, joints, collision synchronization).  Quaternions
+ * are stored as rows of four doubles (q0, q1, q2, q3), vectors as rows of
+ * three doubles, so the loops run branch-free on plain indexed arrays and
+ * the compiler can vectorize them.
+ */
+
+/* Rotate number vectors in place, each by its own unit quaternion
+ * \param[in] quat number x 4 array of unit quaternions
+ * \param[in,out] v number x 3 array of vectors
+ * \param[in] number how many rotations to perform
+ */
+void quaternionRotateBatch(const double* quat, double* v, unsigned int number);
+
+/* Compose number quaternion pairs: ab = a * b (quaternion product);
+ * ab may alias a or b
+ * \param[in] a number x 4 array of quaternions
+ * \param[in] b number x 4 array of quaternions
+ * \param[out] ab number x 4 array receiving the products
+ * \param[in] number how many products to perform
+ */
+void quaternionComposeBatch(const double* a, const double* b, double* ab,
+                            unsigned int number);
+
+/* Normalize number quaternions in place
+ * \param[in,out] quat number x 4 array of quaternions
+ * \param[in] number how many quaternions to normalize
+ */
+void quaternionNormalizeBatch(double* quat, unsigned int number);
+
+/* Batched NewtonEuler configuration update: for each body, build the
+ * increment quaternion from the rotational part of its twist increment
+ * and compose the old configuration with it -- the batch equivalent of
+ * quaternionFromTwistVector followed by compositionLawLieGroup
+ * \param[in] qold number x 7 array of configurations (position, quaternion)
+ * \param[in] twistIncrement number x 6 array of twist increments
+ * \param[out] q number x 7 array receiving the new configurations
+ * \param[in] number how many bodies to update
+ */
+void twistIncrementComposeBatch(const double* qold, const double* twistIncrement,
+                                double* q, unsigned int number);
+
 #endif // ROTATIONQUATERNION_H
@@ -0,0 +1,252 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "SiconosConfig.h"
+#include "SiconosAllocationTracker.hpp"
+
+#ifdef WITH_ALLOCATION_TRACKING
+
+#include <atomic>
+#include <cstdlib>  // for malloc, free
+#include <map>
+#include <mutex>
+#include <new>      // for std::bad_alloc
+
+namespace
+{
+
+/* the tag of the innermost Scope; thread local so that parallel
+   regions attribute their allocations correctly */
+thread_local const char* current_site = nullptr;
+
+/* the recording machinery itself allocates (map nodes); the guard
+   keeps those allocations out of the counters */
+thread_local bool in_tracker = false;
+
+std::atomic<bool> tracking_enabled(false);
+std::atomic<bool> step_open(false);
+
+std::mutex stats_mutex;
+
+/* keyed by the site pointer: tags are string literals */
+typedef std::map<const char*, std::pair<std::size_t, std::size_t> > StatsMap;
+StatsMap live_stats;    /* the step being recorded */
+StatsMap closed_stats;  /* the last closed step, what the report reads */
+
+const char* const UNTAGGED = "(untagged)";
+
+void record(std::size_t size)
+{
+  if(!tracking_enabled.load(std::memory_order_relaxed)
+      || !step_open.load(std::memory_order_relaxed)
+      || in_tracker)
+    return;
+
+  in_tracker = true;
+  {
+    const char* site = current_site ? current_site : UNTAGGED;
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    std::pair<std::size_t, std::size_t>& entry = live_stats[site];
+    entry.first += 1;
+    entry.second += size;
+  }
+  in_tracker = false;
+}
+
+}
+
+/* --- replacement global allocation functions --- */
+
+void* operator new(std::size_t size)
+{
+  void* p = std::malloc(size > 0 ? size : 1);
+  if(!p) throw std::bad_alloc();
+  record(size);
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  void* p = std::malloc(size > 0 ? size : 1);
+  if(!p) throw std::bad_alloc();
+  record(size);
+  return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  void* p = std::malloc(size > 0 ? size : 1);
+  if(p) record(size);
+  return p;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  void* p = std::malloc(size > 0 ? size : 1);
+  if(p) record(size);
+  return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+namespace Siconos
+{
+namespace alloc
+{
+
+bool available()
+{
+  return true;
+}
+
+void enable()
+{
+  tracking_enabled.store(true);
+}
+
+void disable()
+{
+  tracking_enabled.store(false);
+  step_open.store(false);
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  in_tracker = true;
+  live_stats.clear();
+  closed_stats.clear();
+  in_tracker = false;
+}
+
+bool enabled()
+{
+  return tracking_enabled.load();
+}
+
+void beginStep()
+{
+  if(!tracking_enabled.load(std::memory_order_relaxed))
+    return;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  in_tracker = true;
+  live_stats.clear();
+  in_tracker = false;
+  step_open.store(true);
+}
+
+void endStep()
+{
+  if(!tracking_enabled.load(std::memory_order_relaxed))
+    return;
+  step_open.store(false);
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  in_tracker = true;
+  closed_stats.swap(live_stats);
+  live_stats.clear();
+  in_tracker = false;
+}
+
+std::vector<SiteStats> stepReport()
+{
+  std::vector<SiteStats> report;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  in_tracker = true;
+  report.reserve(closed_stats.size());
+  for(StatsMap::const_iterator it = closed_stats.begin();
+      it != closed_stats.end(); ++it)
+  {
+    SiteStats s = {it->first, it->second.first, it->second.second};
+    report.push_back(s);
+  }
+  in_tracker = false;
+  return report;
+}
+
+std::size_t stepAllocationCount()
+{
+  std::size_t count = 0;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  for(StatsMap::const_iterator it = closed_stats.begin();
+      it != closed_stats.end(); ++it)
+    count += it->second.first;
+  return count;
+}
+
+std::size_t stepAllocatedBytes()
+{
+  std::size_t bytes = 0;
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  for(StatsMap::const_iterator it = closed_stats.begin();
+      it != closed_stats.end(); ++it)
+    bytes += it->second.second;
+  return bytes;
+}
+
+Scope::Scope(const char* site) : _saved(current_site)
+{
+  current_site = site;
+}
+
+Scope::~Scope()
+{
+  current_site = _saved;
+}
+
+}
+}
+
+#else  /* !WITH_ALLOCATION_TRACKING: every entry point is a no-op */
+
+namespace Siconos
+{
+namespace alloc
+{
+
+bool available()
+{
+  return false;
+}
+void enable() {}
+void disable() {}
+bool enabled()
+{
+  return false;
+}
+void beginStep() {}
+void endStep() {}
+std::vector<SiteStats> stepReport()
+{
+  return std::vector<SiteStats>();
+}
+std::size_t stepAllocationCount()
+{
+  return 0;
+}
+std::size_t stepAllocatedBytes()
+{
+  return 0;
+}
+Scope::Scope(const char*) : _saved(nullptr) {}
+Scope::~Scope() {}
+
+}
+}
+
+#endif
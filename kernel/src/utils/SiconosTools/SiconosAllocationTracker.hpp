@@ -0,0 +1,116 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!\file SiconosAllocationTracker.hpp
+  \brief per-step allocation tracking for the kernel hot paths
+
+  Hidden allocations in the per-step code (temporaries in the algebra
+  layer, container resizes) are a recurring performance regression that
+  only shows up under a profiler. When the library is configured with
+  WITH_ALLOCATION_TRACKING, the global operator new is replaced by a
+  recording version: every allocation made between beginStep() and
+  endStep() -- called by TimeStepping::computeOneStep -- is counted and
+  attributed to the innermost active Scope tag (a plain string literal,
+  not a backtrace, so the overhead stays negligible). The per-step
+  report lets a CI performance test assert that the steady state of a
+  simulation allocates nothing.
+
+  Without the build option every entry point below is a cheap no-op and
+  available() returns false, so callers need no conditional
+  compilation. Recording itself is also a runtime switch: nothing is
+  recorded unless enable() was called.
+
+  Typical use in a performance test:
+
+    Siconos::alloc::enable();
+    ... run some warm-up steps ...
+    s->computeOneStep();   // the step to check
+    assert(Siconos::alloc::stepAllocationCount() == 0);
+*/
+
+#ifndef SiconosAllocationTracker_H
+#define SiconosAllocationTracker_H
+
+#include <cstddef>  // for std::size_t
+#include <vector>   // for the report
+
+namespace Siconos
+{
+namespace alloc
+{
+
+/** \return true when the library was built WITH_ALLOCATION_TRACKING */
+bool available();
+
+/** turn recording on; allocations are attributed to steps from the
+    next beginStep() on */
+void enable();
+
+/** turn recording off and drop the recorded data */
+void disable();
+
+/** \return true when recording is on */
+bool enabled();
+
+/** start a new step: the counters of the previous step become the
+    report and the live counters are reset. Called by
+    TimeStepping::computeOneStep; manual phases can call it directly. */
+void beginStep();
+
+/** close the current step, making its counters available to the
+    report functions */
+void endStep();
+
+/** allocation counters of one tag, for the per-step report */
+struct SiteStats
+{
+  const char* site;   /**< tag of the innermost Scope, "(untagged)" when none */
+  std::size_t count;  /**< number of allocations */
+  std::size_t bytes;  /**< total bytes requested */
+};
+
+/** \return the per-site counters of the last closed step */
+std::vector<SiteStats> stepReport();
+
+/** \return the total number of allocations of the last closed step */
+std::size_t stepAllocationCount();
+
+/** \return the total bytes requested during the last closed step */
+std::size_t stepAllocatedBytes();
+
+/** tag the allocations of a lexical scope: allocations made while a
+    Scope is alive are attributed to its site string. Scopes nest; the
+    innermost one wins. The site must be a literal (it is stored by
+    pointer). */
+class Scope
+{
+public:
+  explicit Scope(const char* site);
+  ~Scope();
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* _saved;
+};
+
+}
+}
+
+#endif
@@ -40,7 +40,10 @@
 #include <map>
 #endif
 
+#include <algorithm>
 #include <limits>
+#include <utility>
+#include <vector>
 #include <boost/graph/graph_utility.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_concepts.hpp>
@@ -851,6 +854,38 @@ public:
     _stamp++;
   };
 
+  /** Renumber the vertices following a caller-supplied sort key instead
+   *  of the storage order, e.g. to give spatially close bundles close
+   *  indices. The vertex storage itself cannot be reordered (adjacency
+   *  list), but everything keyed on the indices -- index-backed
+   *  properties, position assignment in the assembled matrices --
+   *  adopts the sorted order. The sort is stable, so equal keys keep
+   *  their storage order; like update_vertices_indices this bumps the
+   *  stamp and thereby invalidates the properties attached to the
+   *  graph.
+   *
+   *  \param key functor called as key(vd) on each vertex descriptor,
+   *  returning a value comparable with operator<
+   */
+  template<typename KeyFunction>
+  void sort_vertices_indices(KeyFunction&& key)
+  {
+    std::vector<std::pair<decltype(key(*boost::vertices(g).first)),
+                          VDescriptor> > order;
+    order.reserve(size());
+    VIterator vi, viend;
+    for (std::tie(vi, viend) = boost::vertices(g); vi != viend; ++vi)
+      order.push_back(std::make_pair(key(*vi), *vi));
+    std::stable_sort(order.begin(), order.end(),
+                     [](const typename decltype(order)::value_type& a,
+                        const typename decltype(order)::value_type& b)
+                     { return a.first < b.first; });
+    size_t i = 0;
+    for (typename decltype(order)::value_type& item : order)
+      index(item.second) = i++;
+    _stamp++;
+  };
+
   void update_edges_indices()
   {
     EIterator ei, eiend;
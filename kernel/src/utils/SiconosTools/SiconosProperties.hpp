@@ -45,6 +45,7 @@
 #include <SiconosConfig.h>
 #include <memory>
 #include <map>
+#include <stdexcept>
 
 
 #include <boost/mpl/eval_if.hpp>
@@ -400,6 +401,210 @@ public:
   */
 };
 
+/** dense, index-backed properties structure.
+
+    Same API as Properties, but the values live in a flat vector indexed
+    by the stable vertex (or edge) indices maintained by
+    update_vertices_indices() (or update_edges_indices()), so that the
+    per-element accesses of hot simulation loops are array lookups
+    instead of a tree search with pointer chasing. The store is remapped
+    lazily whenever the graph indices have been rebuilt (the graph stamp
+    is the witness).
+
+    The requirements stated at the top of this file apply here with one
+    addition: properties of removed vertices or edges must be erased with
+    erase() (see eraseProperties() of the simulation graphs), since the
+    remapping walks the recorded descriptors and must not see dead ones.
+
+ \param T the property data type
+ \param G the graph type
+ \param IndexMap the index map, should be either G::VIndexAccess or G:EIndexAccess
+*/
+template<typename T, typename G, typename IndexMap>
+class IndexedProperties
+{
+
+public:
+  typedef typename VertexOrEdge<G, IndexMap>::Access Access;
+
+  Access access;
+
+  typedef typename boost::property_traits<IndexMap>::key_type  key_type;
+  typedef T value_type;
+  typedef typename std::iterator_traits <
+  typename std::vector<T>::iterator >::reference reference;
+  typedef boost::lvalue_property_map_tag category;
+
+
+public:
+  G& _g;
+
+  std::shared_ptr< std::vector<T> > _store;
+  std::shared_ptr< std::vector<key_type> > _keys;
+  std::shared_ptr< std::vector<bool> > _present;
+
+  int _stamp;
+
+
+  /** constructor from a SiconosGraph
+      \param g a SiconosGraph
+  */
+  IndexedProperties(G& g) : _g(g),
+    _store(new std::vector<T>()),
+    _keys(new std::vector<key_type>()),
+    _present(new std::vector<bool>()),
+    _stamp(-1)
+  {}
+
+  /** insert an element in the Property descriptor
+    * \param v a SiconosGraph::VDescriptor or
+    * SiconosGraph::EDescriptor according to IndexMap type
+    * \param t the element to be inserted
+    */
+  void insert(const key_type& v, T t)
+  {
+    (*this)[v] = t;
+  };
+
+  /** data access from a SiconosGraph vertex descriptor or edge
+      descriptor
+      \warning this operator creates an empty element if the key
+      is not in the map. Dot not use it to test if a key is present
+      or not in the map ...
+      \param v a SiconosGraph::VDescriptor or
+      SiconosGraph::EDescriptor according to IndexMap type
+      \return the element in the vector
+    */
+  reference operator[](const key_type& v)
+  {
+    remapIfStale();
+    size_t i = _g.index(v);
+    if(i >= _store->size()) grow(i + 1);
+    (*_keys)[i] = v;
+    (*_present)[i] = true;
+    return (*_store)[i];
+  };
+
+  /** data access from a SiconosGraph vertex descriptor or edge
+      descriptor
+      \param v a SiconosGraph::VDescriptor or
+      SiconosGraph::EDescriptor according to IndexMap type */
+  value_type at(const key_type& v)
+  {
+    remapIfStale();
+    size_t i = _g.index(v);
+    if(i >= _store->size() || !(*_present)[i])
+      throw std::out_of_range("Siconos::IndexedProperties::at");
+    return (*_store)[i];
+  };
+
+  /** check if a given property exists
+      \param v a SiconosGraph::VDescriptor or
+      SiconosGraph::EDescriptor according to IndexMap type
+      \return true if the key is a property, otherwise false
+   */
+  inline bool hasKey(const key_type& v)
+  {
+    remapIfStale();
+    size_t i = _g.index(v);
+    return i < _store->size() && (*_present)[i] && (*_keys)[i] == v;
+  };
+
+  /** remove the property attached to a key, to be called when the
+      vertex or edge is removed from the graph
+      \param v a SiconosGraph::VDescriptor or
+      SiconosGraph::EDescriptor according to IndexMap type
+   */
+  void erase(const key_type& v)
+  {
+    /* the graph indices may not have been rebuilt yet: clear the slot
+       that recorded this key, wherever it is */
+    size_t i = _g.index(v);
+    if(i < _store->size() && (*_keys)[i] == v)
+      clearSlot(i);
+    else
+      for(size_t j = 0; j < _store->size(); ++j)
+        if((*_present)[j] && (*_keys)[j] == v)
+        {
+          clearSlot(j);
+          break;
+        }
+  };
+
+  typedef void serializable;
+
+private:
+
+  void grow(size_t n)
+  {
+    _store->resize(n);
+    _keys->resize(n);
+    _present->resize(n, false);
+  }
+
+  void clearSlot(size_t i)
+  {
+    (*_store)[i] = T();
+    (*_present)[i] = false;
+  }
+
+  /** scatter the stored values to their new indices after
+      update_vertices_indices() or update_edges_indices() */
+  void remapIfStale()
+  {
+    if(_stamp == _g.stamp()) return;
+
+    size_t n = access.size(_g);
+    std::vector<T> values(n);
+    std::vector<key_type> keys(n);
+    std::vector<bool> present(n, false);
+
+    for(size_t i = 0; i < _store->size(); ++i)
+    {
+      if(!(*_present)[i]) continue;
+      size_t j = _g.index((*_keys)[i]);
+      if(j >= n) continue; /* no longer indexed */
+      values[j] = (*_store)[i];
+      keys[j] = (*_keys)[i];
+      present[j] = true;
+    }
+
+    _store->swap(values);
+    _keys->swap(keys);
+    _present->swap(present);
+    _stamp = _g.stamp();
+  }
+};
+
+/** dense vertex property structure:
+    \param T the property data type
+    \param G the graph type
+ */
+template<typename T, typename G>
+class IndexedVertexProperties : public IndexedProperties<T, G, typename G::VIndexAccess>
+{
+public:
+  IndexedVertexProperties(G& g) : IndexedProperties<T, G, typename G::VIndexAccess>(g)
+  {};
+
+  typedef void serializable;
+};
+
+/** dense edge property structure:
+    \param T the property data type
+    \param G the graph type
+ */
+template<typename T, typename G>
+class IndexedEdgeProperties : public IndexedProperties<T, G, typename G::EIndexAccess>
+{
+public:
+  IndexedEdgeProperties(G& g) : IndexedProperties<T, G, typename G::EIndexAccess>(g)
+  {};
+
+  typedef void serializable;
+};
+
+
 /** function to build a VertexProperties from one template parameter
   \param g the graph
 */
@@ -0,0 +1,102 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*! \file SiconosTaskPool.hpp
+    \brief C++ convenience layer over the shared numerics task pool
+    (NumericsTaskPool.h): persistent worker threads, usable from the
+    stepping loop without per-call thread creation or OpenMP region
+    entry costs.
+*/
+
+#ifndef SiconosTaskPool_H
+#define SiconosTaskPool_H
+
+#include <algorithm>   // for min
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <utility>     // for move
+
+#include "NumericsTaskPool.h"  // for NTP_default, NTP_submit_hint, NTP_wait
+
+/** Free functions around the process-wide worker pool. All of them are
+    meant to be called from the stepping (main) thread; calling wait()
+    from inside a task would wait for the task itself. */
+namespace SiconosTaskPool
+{
+namespace details
+{
+inline void trampoline(void* ctx)
+{
+  std::function<void()>* f = static_cast<std::function<void()>*>(ctx);
+  (*f)();
+  delete f;
+}
+}
+
+/** \return the number of persistent workers, 0 when threads are not
+    available (tasks then run inline). */
+inline unsigned int numWorkers()
+{
+  return NTP_num_workers(NTP_default());
+}
+
+/** Submit a task on the shared pool.
+    \param f the task
+    \param hint preferred worker (affinity), negative for no preference */
+inline void run(std::function<void()> f, int hint = -1)
+{
+  NTP_submit_hint(NTP_default(), &details::trampoline,
+                  new std::function<void()>(std::move(f)), hint);
+}
+
+/** Wait for every task submitted so far. */
+inline void wait()
+{
+  NTP_wait(NTP_default());
+}
+
+/** Apply body(begin, end) over subranges covering [0, n), distributed
+    over the workers, and wait for completion. The iterations must be
+    independent.
+    \param n the iteration count
+    \param body callable taking the (begin, end) bounds of a subrange */
+template <typename Body>
+void parallelFor(std::size_t n, Body body)
+{
+  unsigned int w = numWorkers();
+  if(w <= 1 || n < 2)
+  {
+    body(static_cast<std::size_t>(0), n);
+    return;
+  }
+  /* a few chunks per worker so stealing can even out imbalance */
+  std::size_t nchunks = std::min<std::size_t>(n, 4 * w);
+  std::size_t chunk = (n + nchunks - 1) / nchunks;
+  for(std::size_t begin = 0; begin < n; begin += chunk)
+  {
+    std::size_t end = std::min(begin + chunk, n);
+    /* hint by position, not round-robin: worker i prefers the i-th
+       contiguous slice of the range, matching the first-touch placement
+       of NTP_first_touch so the data a worker touches stays local */
+    run([=] { body(begin, end); }, static_cast<int>((begin * w) / n));
+  }
+  wait();
+}
+}
+
+#endif
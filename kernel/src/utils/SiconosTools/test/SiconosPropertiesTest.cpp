@@ -143,3 +143,78 @@ void SiconosPropertiesTest::t3()
   CPPUNIT_ASSERT(mv[vf] == 333);
 
 }
+
+/* dense, index-backed variant : values survive reindexing */
+void SiconosPropertiesTest::t4()
+{
+  typedef SiconosGraph < std::string, std::string,
+          boost::no_property, boost::no_property, boost::no_property > G;
+
+  std::shared_ptr<G> g(new G());
+
+  Siconos::IndexedVertexProperties<int, G> mv(*g);
+
+  G::VDescriptor v1 = g->add_vertex("A");
+  G::VDescriptor v2 = g->add_vertex("B");
+  G::VDescriptor v3 = g->add_vertex("C");
+  G::VDescriptor v4 = g->add_vertex("D");
+  G::VDescriptor v5 = g->add_vertex("E");
+
+  g->update_vertices_indices();
+
+  mv[v1] = 1;
+  mv[v2] = 2;
+  mv[v3] = 3;
+  mv[v4] = 4;
+  mv[v5] = 5;
+
+  /* properties of removed elements must be erased before the removal */
+  mv.erase(v3);
+  g->remove_vertex("C");
+  G::VDescriptor vnc = g->add_vertex("new C");
+  g->update_vertices_indices();
+
+  mv[vnc] = 33;
+
+  CPPUNIT_ASSERT(mv[v1] == 1);
+  CPPUNIT_ASSERT(mv[v2] == 2);
+  CPPUNIT_ASSERT(mv[v4] == 4);
+  CPPUNIT_ASSERT(mv[v5] == 5);
+  CPPUNIT_ASSERT(mv[vnc] == 33);
+}
+
+/* dense, index-backed variant : hasKey, at and erase */
+void SiconosPropertiesTest::t5()
+{
+  typedef SiconosGraph < std::string, std::string,
+          boost::no_property, boost::no_property, boost::no_property > G;
+
+  std::shared_ptr<G> g(new G());
+
+  Siconos::IndexedVertexProperties<int, G> mv(*g);
+
+  G::VDescriptor v1 = g->add_vertex("A");
+  G::VDescriptor v2 = g->add_vertex("B");
+
+  g->update_vertices_indices();
+
+  mv[v1] = 1;
+
+  CPPUNIT_ASSERT(mv.hasKey(v1));
+  CPPUNIT_ASSERT(!mv.hasKey(v2));
+  CPPUNIT_ASSERT(mv.at(v1) == 1);
+
+  mv.erase(v1);
+  CPPUNIT_ASSERT(!mv.hasKey(v1));
+
+  bool catched = false;
+  try
+  {
+    mv.at(v1);
+  }
+  catch(const std::out_of_range&)
+  {
+    catched = true;
+  }
+  CPPUNIT_ASSERT(catched);
+}
@@ -37,12 +37,18 @@ private:
 
   CPPUNIT_TEST(t3);
 
+  CPPUNIT_TEST(t4);
+
+  CPPUNIT_TEST(t5);
+
   CPPUNIT_TEST_SUITE_END();
 
   // Members
   void t1();
   void t2();
   void t3();
+  void t4();
+  void t5();
 
 public:
   void setUp();
@@ -143,6 +143,46 @@
 }
 %extend SimpleMatrix{
   std::string __str__() { return $self->toString(); }
+  /* zero-copy numpy array over the dense storage (fortran order, like
+   * the conversion typemaps); None for non-dense matrices */
+  PyObject* _numpy_view(PyObject* owner) {
+    if ($self->num() != 1)
+    {
+      Py_INCREF(Py_None);
+      return Py_None;
+    }
+    npy_intp this_matrix_dim[2] = { (npy_intp)$self->size(0),
+                                    (npy_intp)$self->size(1) };
+    PyObject* pyarray = FPyArray_SimpleNewFromData(2, this_matrix_dim,
+                                                   NPY_DOUBLE, $self->getArray());
+    if (!pyarray) return nullptr;
+    Py_INCREF(owner);
+#if NPY_API_VERSION < 0x00000007
+    PyArray_BASE((PyArrayObject*)pyarray) = owner;
+#else
+    PyArray_SetBaseObject((PyArrayObject*)pyarray, owner);
+#endif
+    return pyarray;
+  }
+%insert("python") %{
+    def numpy_view(self):
+        """Zero-copy numpy array over the matrix content (dense only).
+
+        The returned array shares its memory with the matrix: entries
+        may be read and written in place. The matrix is kept alive as
+        long as the view is. Returns None for non-dense matrices."""
+        return self._numpy_view(self)
+
+    def __array__(self, dtype=None, copy=None):
+        a = self._numpy_view(self)
+        if a is None:
+            raise TypeError("only dense matrices can be converted to numpy arrays")
+        if dtype is not None and a.dtype != dtype:
+            return a.astype(dtype)
+        if copy:
+            return a.copy()
+        return a
+%}
   PyObject *__getitem__(PyObject *args) {
     /* printf("__getitem__ PyObject\n"); */
     if (PyTuple_Check(args))
@@ -260,10 +300,38 @@
   SiconosVectorIterator __iter__() {
     return SiconosVectorIterator($self->begin());
   }
+  /* zero-copy numpy array over the internal storage; the SWIG proxy
+   * (owner) is installed as the base object of the array, so the vector
+   * stays alive as long as a view on it does */
+  PyObject* _numpy_view(PyObject* owner) {
+    npy_intp this_vector_dim[1] = { (npy_intp)$self->size() };
+    PyObject* pyarray = FPyArray_SimpleNewFromData(1, this_vector_dim,
+                                                   NPY_DOUBLE, $self->getArray());
+    if (!pyarray) return nullptr;
+    Py_INCREF(owner);
+#if NPY_API_VERSION < 0x00000007
+    PyArray_BASE((PyArrayObject*)pyarray) = owner;
+#else
+    PyArray_SetBaseObject((PyArrayObject*)pyarray, owner);
+#endif
+    return pyarray;
+  }
 %insert("python") %{
-    def __array__(self):
-        import numpy
-        return numpy.fromiter(self, dtype=float)
+    def numpy_view(self):
+        """Zero-copy numpy array over the vector content.
+
+        The returned array shares its memory with the vector: entries
+        may be read and written in place. The vector is kept alive as
+        long as the view is."""
+        return self._numpy_view(self)
+
+    def __array__(self, dtype=None, copy=None):
+        a = self._numpy_view(self)
+        if dtype is not None and a.dtype != dtype:
+            return a.astype(dtype)
+        if copy:
+            return a.copy()
+        return a
 %}
 }
 %extend BlockVector{
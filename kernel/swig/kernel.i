@@ -120,6 +120,38 @@ Example of usage:
  // common declarations with upper modules : Mechanics, IO, ...
 %include handleException.i
 
+// Release the GIL around the long-running stepping calls, so that other
+// Python threads (monitoring, analysis, ...) can run while the
+// simulation advances. Callbacks into Python (directors, plugins) are
+// safe: the director glue re-acquires the GIL (SWIG_PYTHON_THREADS is
+// defined in start.i). The catch clause mirrors handleException.i, with
+// the GIL restored before touching the error indicator.
+%define %RELEASE_GIL_AROUND(METHOD)
+%exception METHOD
+{
+  PyThreadState* _save = PyEval_SaveThread();
+  try
+  {
+    $action;
+    PyEval_RestoreThread(_save);
+  }
+  catch (...) {
+    PyEval_RestoreThread(_save);
+    if (!PyErr_Occurred()) {
+      handle_exception();
+    }
+    SWIG_fail;
+  }
+}
+%enddef
+
+%RELEASE_GIL_AROUND(Simulation::run)
+%RELEASE_GIL_AROUND(Simulation::advanceToEvent)
+%RELEASE_GIL_AROUND(TimeStepping::run)
+%RELEASE_GIL_AROUND(TimeStepping::advanceToEvent)
+%RELEASE_GIL_AROUND(TimeStepping::computeOneStep)
+%RELEASE_GIL_AROUND(EventDriven::advanceToEvent)
+
 %include sharedPointers.i
 
 // handle stl data types
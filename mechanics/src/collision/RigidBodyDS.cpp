@@ -16,3 +16,17 @@ RigidBodyDS::RigidBodyDS(SP::SiconosVector position,
 RigidBodyDS::~RigidBodyDS()
 {
 }
+
+void RigidBodyDS::updateSleepState()
+{
+  if(_sleepEnergyThreshold <= 0. || sleeping())
+    return;
+
+  if(computeKineticEnergy() <= _sleepEnergyThreshold)
+  {
+    if(++_lowEnergySteps >= _sleepDelaySteps)
+      setSleeping(true);
+  }
+  else
+    _lowEnergySteps = 0;
+}
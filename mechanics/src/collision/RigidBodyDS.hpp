@@ -45,6 +45,17 @@ protected:
    *  collide. See also NewtonEulerJointR::_allowSelfCollide */
   bool _allowSelfCollide = true;
 
+  /** Kinetic energy below which the body is a candidate for sleeping;
+   *  0 (the default) disables the sleep detection. */
+  double _sleepEnergyThreshold = 0.;
+
+  /** Number of consecutive low-energy steps required before the body
+   *  actually falls asleep. */
+  unsigned int _sleepDelaySteps = 10;
+
+  /** Consecutive low-energy steps observed so far. */
+  unsigned int _lowEnergySteps = 0;
+
 public:
 
   RigidBodyDS(SP::SiconosVector position,
@@ -79,6 +90,32 @@ public:
    *  \return a SP::SiconosVector */
   virtual SP::SiconosVector base_position() { return q(); }
 
+  /** Enable the sleep detection of the body.
+   *
+   *  \param threshold kinetic energy below which the body is a
+   *  candidate for sleeping; 0 disables the detection. */
+  void setSleepEnergyThreshold(double threshold) { _sleepEnergyThreshold = threshold; }
+
+  /** Return the kinetic-energy threshold of the sleep detection. */
+  double sleepEnergyThreshold() const { return _sleepEnergyThreshold; }
+
+  /** Set the number of consecutive low-energy steps required before
+   *  the body falls asleep. */
+  void setSleepDelaySteps(unsigned int steps) { _sleepDelaySteps = steps; }
+
+  /** Wake the body up and restart the low-energy step count. */
+  void wake()
+  {
+    setSleeping(false);
+    _lowEnergySteps = 0;
+  }
+
+  /** Run one step of the sleep detection: an awake body whose kinetic
+   *  energy has stayed below the threshold for _sleepDelaySteps
+   *  consecutive calls falls asleep (see DynamicalSystem::sleeping()).
+   *  Called once per step by the collision manager. */
+  void updateSleepState();
+
   ACCEPT_BASE_VISITORS(NewtonEulerDS);
 };
 
@@ -30,12 +30,151 @@
 #include <SiconosContactor.hpp>
 #include <SiconosCollisionQueryResult.hpp>
 
+#include <map>
+#include <memory>
+#include <vector>
+
+/** Pool of fully-constructed contact Interaction objects (together with
+ *  their contact relation), grouped by nonsmooth law.
+ *
+ *  Granular flows create and destroy thousands of contacts per step; an
+ *  Interaction birth allocates the Interaction, its relation and several
+ *  vector members.  Instead of freeing a vanished contact, a collision
+ *  manager may release() it here and acquire() it again for the next
+ *  contact governed by the same nonsmooth law, only rebinding the body
+ *  pair and the contact geometry on the recycled relation.
+ */
+class SiconosContactInteractionPool
+{
+protected:
+
+  ACCEPT_SERIALIZATION(SiconosContactInteractionPool);
+
+  /** free interactions, grouped by the nonsmooth law they were created with */
+  std::map<const NonSmoothLaw*, std::vector<SP::Interaction> > _free;
+
+public:
+
+  /** Take a recycled interaction created with the given nonsmooth law.
+   *
+   *  \param nslaw the nonsmooth law of the new contact
+   *  \return a fully-constructed Interaction, or empty if the pool has none
+   */
+  SP::Interaction acquire(const SP::NonSmoothLaw& nslaw)
+  {
+    std::vector<SP::Interaction>& free = _free[&*nslaw];
+    if(free.empty()) return SP::Interaction();
+    SP::Interaction inter(free.back());
+    free.pop_back();
+    return inter;
+  }
+
+  /** Give back the interaction of a vanished contact for later reuse.
+   *  The interaction must already be unlinked from the topology.
+   *
+   *  \param nslaw the nonsmooth law the interaction was created with
+   *  \param inter the interaction to recycle
+   */
+  void release(const SP::NonSmoothLaw& nslaw, const SP::Interaction& inter)
+  {
+    _free[&*nslaw].push_back(inter);
+  }
+
+  /** Drop all pooled interactions. */
+  void clear()
+  {
+    _free.clear();
+  }
+};
+
+/** One line-segment query of a lineIntersectionBulkQuery() batch,
+ *  both points in inertial frame (world) coordinates. */
+struct SiconosRayQuery
+{
+  SiconosRayQuery() : start(3), end(3) {}
+  SiconosRayQuery(const SiconosVector& s, const SiconosVector& e)
+    : start(s), end(e) {}
+
+  /** starting point of the line segment */
+  SiconosVector start;
+
+  /** ending point of the line segment */
+  SiconosVector end;
+};
+
+/** One sphere query of an inSphereBulkQuery() batch, center in
+ *  inertial frame (world) coordinates. */
+struct SiconosSphereQuery
+{
+  SiconosSphereQuery() : center(3), radius(0.) {}
+  SiconosSphereQuery(const SiconosVector& c, double r)
+    : center(c), radius(r) {}
+
+  /** center of the sphere */
+  SiconosVector center;
+
+  /** radius of the sphere */
+  double radius;
+};
+
+/** Pool of recycled SiconosCollisionQueryResult objects for the bulk
+ *  query interface.  Sensor-style workloads fire thousands of queries
+ *  per frame; handing the same pool to every batch replaces one
+ *  allocation per hit with a pop from the free list.  The pool is
+ *  owned by the caller and must outlive the result lists filled from
+ *  it.
+ */
+class SiconosCollisionQueryResultPool
+{
+protected:
+
+  ACCEPT_SERIALIZATION(SiconosCollisionQueryResultPool);
+
+  /** free result objects */
+  std::vector<SP::SiconosCollisionQueryResult> _free;
+
+public:
+
+  /** Take a recycled result object, allocating one only if the pool
+   *  is empty.
+   *
+   *  \return a SiconosCollisionQueryResult ready to be filled
+   */
+  SP::SiconosCollisionQueryResult acquire()
+  {
+    if(_free.empty()) return std::make_shared<SiconosCollisionQueryResult>();
+    SP::SiconosCollisionQueryResult result(_free.back());
+    _free.pop_back();
+    return result;
+  }
+
+  /** Give back the results of a processed query for later reuse and
+   *  clear the list.
+   *
+   *  \param results the result list to recycle
+   */
+  void release(std::vector<SP::SiconosCollisionQueryResult>& results)
+  {
+    _free.insert(_free.end(), results.begin(), results.end());
+    results.clear();
+  }
+
+  /** Drop all pooled result objects. */
+  void clear()
+  {
+    _free.clear();
+  }
+};
+
 class SiconosCollisionManager : public InteractionManager
 {
 protected:
-  
+
   ACCEPT_SERIALIZATION(SiconosCollisionManager);
 
+  /** recycled contact interactions, see SiconosContactInteractionPool */
+  SiconosContactInteractionPool _interaction_pool;
+
 public:
   SiconosCollisionManager() : InteractionManager() {}
   virtual ~SiconosCollisionManager() {}
@@ -102,6 +241,68 @@ public:
                 bool sorted=true)
     { return std::vector<SP::SiconosCollisionQueryResult>(); }
 
+  /**
+     Perform a batch of line segment intersection tests in one call.
+
+     results is resized to rays.size() and results[i] is cleared then
+     refilled with the hits of rays[i], following the same conventions
+     as lineIntersectionQuery().  The caller keeps the result lists
+     (and the optional pool) alive across frames, so a steady-state
+     batch performs no per-query allocation.  Collision managers may
+     override this to process the batch in parallel.
+
+     \param rays The line segments to test.
+     \param results One result list per ray, reused across calls.
+     \param pool Optional pool the result objects are recycled through.
+     \param closestOnly If true, keep only the hit closest to the ray
+     start, max size of each result list = 1.
+     \param sorted If true, each result list is sorted by distance.
+  */
+  virtual void
+  lineIntersectionBulkQuery(const std::vector<SiconosRayQuery>& rays,
+                            std::vector<std::vector<SP::SiconosCollisionQueryResult> >& results,
+                            SiconosCollisionQueryResultPool* pool = nullptr,
+                            bool closestOnly=false,
+                            bool sorted=true)
+  {
+    results.resize(rays.size());
+    for(size_t i = 0; i < rays.size(); ++i)
+    {
+      results[i].clear();
+      std::vector<SP::SiconosCollisionQueryResult> hits =
+        lineIntersectionQuery(rays[i].start, rays[i].end, closestOnly, sorted);
+      results[i].swap(hits);
+    }
+  }
+
+  /**
+     Perform a batch of sphere queries in one call, with the same
+     conventions as lineIntersectionBulkQuery().
+
+     \param spheres The spheres to test.
+     \param results One result list per sphere, reused across calls.
+     \param pool Optional pool the result objects are recycled through.
+     \param closestOnly If true, keep only the hit closest to the
+     center, max size of each result list = 1.
+     \param sorted If true, each result list is sorted by distance.
+  */
+  virtual void
+  inSphereBulkQuery(const std::vector<SiconosSphereQuery>& spheres,
+                    std::vector<std::vector<SP::SiconosCollisionQueryResult> >& results,
+                    SiconosCollisionQueryResultPool* pool = nullptr,
+                    bool closestOnly=false,
+                    bool sorted=true)
+  {
+    results.resize(spheres.size());
+    for(size_t i = 0; i < spheres.size(); ++i)
+    {
+      results[i].clear();
+      std::vector<SP::SiconosCollisionQueryResult> hits =
+        inSphereQuery(spheres[i].center, spheres[i].radius, closestOnly, sorted);
+      results[i].swap(hits);
+    }
+  }
+
   /**
      Find all shapes that are within a box defined by a center point
      and a dimensions (3-vector), and return them in an ordered list
@@ -63,6 +63,9 @@ DEFINE_SPTR(UpdateShapeVisitor)
 #include "Bullet1DR.hpp"
 #include "Bullet2dR.hpp"
 #include "Bullet2d3DR.hpp"
+#include "NewtonEuler1DR.hpp"
+#include "Lagrangian2d2DR.hpp"
+#include "Lagrangian2d3DR.hpp"
 #include "StaticBody.hpp"
 
 #include "BodyShapeRecord.hpp"
@@ -70,9 +73,17 @@ DEFINE_SPTR(UpdateShapeVisitor)
 #include "BulletUtils.hpp"
 
 #include <map>
+#include <vector>
+#include <string>
 #include <limits>
+#include <initializer_list>
+#include <cstdio>
 #include <boost/format.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <Relation.hpp>
 #include <Simulation.hpp>
 #include <NonSmoothDynamicalSystem.hpp>
@@ -113,6 +124,7 @@ DEFINE_SPTR(UpdateShapeVisitor)
 #include <BulletCollision/CollisionShapes/btTriangleIndexVertexArray.h>
 #include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
 #include <BulletCollision/CollisionDispatch/btInternalEdgeUtility.h>
+#include <BulletCollision/CollisionDispatch/btCollisionObjectWrapper.h>
 
 // 2D shapes
 #include "BulletCollision/CollisionShapes/btConvexShape.h"
@@ -229,6 +241,7 @@ SiconosBulletOptions::SiconosBulletOptions()
   , enableSatConvex(false)
   , enablePolyhedralContactClipping(false)
   , Depth2D(0.04)
+  , temporalCoherenceGating(true)
 {
 }
 
@@ -265,6 +278,10 @@ public:
                         SP::btCollisionObject btobj,SP::SiconosContactor con, SP::StaticBody staticCSR):
     BodyShapeRecord(b, d, sh, con, staticCSR), btobject(btobj) {}
   SP::btCollisionObject btobject;
+
+  /* Cache key of the shared Bullet shape currently bound to btobject;
+   * empty until the first updateShape().  See _sharedShapeCache. */
+  std::string btshape_key;
 };
 
 typedef std::map<const StaticBody*, std::vector<std::shared_ptr<BodyBulletShapeRecord> > >
@@ -333,6 +350,11 @@ protected:
 
   StaticBodyShapeMap  staticBodyShapeMap;
 
+  /* Immutable Bullet shapes shared between contactors whose geometric
+   * parameters are identical, keyed on those parameters.  Entries are
+   * weak so a shape disappears with the last record that uses it. */
+  std::map<std::string, std::weak_ptr<btCollisionShape> > _sharedShapeCache;
+
   SP::Simulation _simulation;
 
   /* Create collision objects for each shape type */
@@ -432,6 +454,30 @@ protected:
   void updateAllShapesForDS(const SecondOrderDS &bds);
   void updateShapePosition(const BodyBulletShapeRecord &record);
 
+  /** true if a shape record of the body references a shape whose
+   *  parameters changed since the last update; such a body must be
+   *  updated serially, since rescaling a shape touches the broadphase */
+  bool hasStaleShapes(const SecondOrderDS &bds) const;
+
+  /** bodies whose shapes are unchanged, queued by the update visitor for
+   *  the batched parallel transform sync in updateInteractions */
+  std::vector<const SecondOrderDS*> _transform_sync_queue;
+
+  /** temporal coherence gate: upper bound (in bullet world units) on the
+   *  displacement of any body since the overlapping pair list was last
+   *  rebuilt, and whether such a list exists at all */
+  double _motionSinceBroadphase = 0.0;
+  bool _pairCacheValid = false;
+
+  /** set whenever a collision object was created, rescaled or removed:
+   *  the cached pair list cannot be reused then */
+  bool _structuralChange = false;
+
+  /** upper bound, in bullet world units, on the displacement of the body
+   *  over one step of length h: linear speed plus angular speed times
+   *  the bounding-sphere radius of its collision shapes */
+  double displacementBound(const SecondOrderDS &bds, double h);
+
   /* Helper to apply an offset transform to a position and return as a
    * btTransform */
   btTransform offsetTransform(const SiconosVector& position,
@@ -478,6 +524,7 @@ SP::StaticBody SiconosBulletCollisionManager::addStaticBody(
   rec->number=number;
   //std::cout << "SiconosBulletCollisionManager::addStaticBody number : " << number <<  std::endl;
   _impl->createCollisionObjectsForBodyContactorSet(SP::SecondOrderDS(), rec, rec->base, cs);
+  _impl->_structuralChange = true;
 
   return rec;
 }
@@ -496,6 +543,7 @@ void SiconosBulletCollisionManager::removeStaticBody(const SP::StaticBody& body)
   }
 
   _impl->staticBodyShapeMap.erase(it);
+  _impl->_structuralChange = true;
 }
 
 /* We derive a specific callback for filtering the broadphase of Bullet
@@ -513,6 +561,22 @@ struct SiconosBulletFilterCallback : public btOverlapFilterCallback
     // bool collides = (proxy0->m_collisionFilterGroup & proxy1->m_collisionFilterMask) != 0;
     // collides = collides && (proxy1->m_collisionFilterGroup & proxy0->m_collisionFilterMask);
 
+    /* Pieces of one body (multi-shape contactor sets, e.g. convex
+     * decompositions) never interact with each other: without this test
+     * the narrowphase computes their contact points only to have them
+     * discarded when contact points are turned into interactions.
+     * Rejecting the pair here makes the broadphase a two-level test:
+     * body identity first, piece AABBs (the broadphase tree) second. */
+    const BodyShapeRecord* recordA = reinterpret_cast<const BodyShapeRecord*>(
+      static_cast<btCollisionObject*>(proxy0->m_clientObject)->getUserPointer());
+    const BodyShapeRecord* recordB = reinterpret_cast<const BodyShapeRecord*>(
+      static_cast<btCollisionObject*>(proxy1->m_clientObject)->getUserPointer());
+    if(recordA && recordB && recordA->ds == recordB->ds)
+    {
+      DEBUG_END("SiconosBulletFilterCallback :: needBroadphaseCollision\n");
+      return false;
+    }
+
     //add some additional logic here that modified 'collides'
     SP::NonSmoothLaw nslaw = _interactionManager->nonSmoothLaw(proxy0->m_collisionFilterGroup,proxy1->m_collisionFilterGroup);
     bool collides = (bool)nslaw;
@@ -668,12 +732,72 @@ public:
 
 void SiconosBulletCollisionManager_impl::updateAllShapesForDS(const SecondOrderDS &bds)
 {
+  // find() instead of operator[]: this runs concurrently from the batched
+  // transform sync and must not modify the map
+  BodyShapeMap::iterator mit = bodyShapeMap.find(&bds);
+  if(mit == bodyShapeMap.end()) return;
   SP::UpdateShapeVisitor updateShapeVisitor(new UpdateShapeVisitor(*this));
   std::vector<std::shared_ptr<BodyBulletShapeRecord> >::iterator it;
-  for(it = bodyShapeMap[&bds].begin(); it != bodyShapeMap[&bds].end(); it++)
+  for(it = mit->second.begin(); it != mit->second.end(); it++)
     (*it)->acceptSP(updateShapeVisitor);
 }
 
+bool SiconosBulletCollisionManager_impl::hasStaleShapes(const SecondOrderDS &bds) const
+{
+  BodyShapeMap::const_iterator mit = bodyShapeMap.find(&bds);
+  if(mit == bodyShapeMap.end()) return false;
+  std::vector<std::shared_ptr<BodyBulletShapeRecord> >::const_iterator it;
+  for(it = mit->second.begin(); it != mit->second.end(); it++)
+  {
+    if((*it)->sshape->version() != (*it)->shape_version)
+      return true;
+  }
+  return false;
+}
+
+double SiconosBulletCollisionManager_impl::displacementBound(const SecondOrderDS &bds,
+                                                             double h)
+{
+  BodyShapeMap::const_iterator mit = bodyShapeMap.find(&bds);
+  if(mit == bodyShapeMap.end()) return 0.0;
+
+  /* bounding-sphere radius (bullet units) around the body reference
+   * point, covering every collision shape of the contactor set */
+  double radius = 0.0;
+  std::vector<std::shared_ptr<BodyBulletShapeRecord> >::const_iterator it;
+  for(it = mit->second.begin(); it != mit->second.end(); it++)
+  {
+    btVector3 center;
+    btScalar r;
+    (*it)->btobject->getCollisionShape()->getBoundingSphere(center, r);
+    double d = center.length() + r;
+    if(d > radius) radius = d;
+  }
+
+  double linear = 0.0, angular = 0.0;
+  const NewtonEulerDS *neds = dynamic_cast<const NewtonEulerDS*>(&bds);
+  if(neds)
+  {
+    const SiconosVector& v = *neds->twist();
+    linear = sqrt(v(0)*v(0) + v(1)*v(1) + v(2)*v(2));
+    angular = sqrt(v(3)*v(3) + v(4)*v(4) + v(5)*v(5));
+  }
+  else
+  {
+    const LagrangianDS *lds = dynamic_cast<const LagrangianDS*>(&bds);
+    if(lds)
+    {
+      const SiconosVector& v = *lds->velocity();
+      linear = sqrt(v(0)*v(0) + v(1)*v(1));
+      if(v.size() > 2) angular = fabs(v(2));
+    }
+  }
+
+  /* velocities are in world units, the bounding radius already in
+   * (scaled) bullet units */
+  return h * (linear * _options.worldScale + angular * radius);
+}
+
 // helper for enabling polyhedral contact clipping for shape types
 // derived from btPolyhedralConvexShape
 static void initPolyhedralFeatures(btPolyhedralConvexShape& btshape)
@@ -682,6 +806,47 @@ static void initPolyhedralFeatures(btPolyhedralConvexShape& btshape)
 }
 static void initPolyhedralFeatures(btCollisionShape& btshape) {}
 
+// Helpers for sharing one Bullet shape between all contactors whose
+// geometric parameters are identical.  The primitive shapes are created
+// unit-sized and parameterized in updateShape() through local scaling
+// and margins, so records may share a btCollisionShape as long as every
+// parameter written there agrees; the cache key encodes exactly those
+// parameters.
+static std::string btShapeCacheKey(const char* cls,
+                                   std::initializer_list<double> params)
+{
+  std::string key(cls);
+  char buf[32];
+  for(double p : params)
+  {
+    snprintf(buf, sizeof(buf), ":%.17g", p);
+    key += buf;
+  }
+  return key;
+}
+
+template<typename BT, typename MAKER>
+static std::shared_ptr<BT> sharedBtShape(
+  std::map<std::string, std::weak_ptr<btCollisionShape> >& cache,
+  const std::string& key, MAKER make)
+{
+  std::shared_ptr<BT> btshape;
+  std::map<std::string, std::weak_ptr<btCollisionShape> >::iterator
+    it = cache.find(key);
+  if(it != cache.end())
+  {
+    btshape = std::static_pointer_cast<BT>(it->second.lock());
+    if(!btshape)
+      cache.erase(it);
+  }
+  if(!btshape)
+  {
+    btshape = make();
+    cache[key] = btshape;
+  }
+  return btshape;
+}
+
 template<typename ST, typename BT, typename DST, typename BR>
 SP::btCollisionObject SiconosBulletCollisionManager_impl::createCollisionObjectHelper(
   SP::SiconosVector base, const DST& ds, ST& shape, BT& btshape,
@@ -708,21 +873,6 @@ SP::btCollisionObject SiconosBulletCollisionManager_impl::createCollisionObjectH
   else
     btobject->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
 
-  // put it in the world
-  int collisionFilterGroup = contactor->collision_group;
-  int collisionFilterMask  = 1;
-
-#ifdef QUEUE_STATIC_CONTACTORS
-  if(!ds)
-  {
-    _queuedCollisionObjects.push_back(std::make_pair(btobject,collisionFilterGroup));
-  }
-  else
-    _collisionWorld->addCollisionObject(&*btobject,collisionFilterGroup,collisionFilterMask);
-#else
-  _collisionWorld->addCollisionObject(&*btobject,collisionFilterGroup,collisionFilterMask);
-#endif
-
   // create a record to keep track of things
   // (for static contactor, ds=nil)
   std::shared_ptr<BR> record(
@@ -745,10 +895,27 @@ SP::btCollisionObject SiconosBulletCollisionManager_impl::createCollisionObjectH
 
   // Allow Bullet to report colliding DSs.  We need to access it from
   // the collision callback as the record base class so down-cast it.
+  // Set before the object enters the world so that the broadphase
+  // filter can identify the owning body for pairs created on insertion.
   btobject->setUserPointer(
     reinterpret_cast<void*>(
       static_cast<BodyShapeRecord*>(&*record)));
 
+  // put it in the world
+  int collisionFilterGroup = contactor->collision_group;
+  int collisionFilterMask  = 1;
+
+#ifdef QUEUE_STATIC_CONTACTORS
+  if(!ds)
+  {
+    _queuedCollisionObjects.push_back(std::make_pair(btobject,collisionFilterGroup));
+  }
+  else
+    _collisionWorld->addCollisionObject(&*btobject,collisionFilterGroup,collisionFilterMask);
+#else
+  _collisionWorld->addCollisionObject(&*btobject,collisionFilterGroup,collisionFilterMask);
+#endif
+
   // initial parameter update (change version to make something happen)
   record->shape_version -= 1;
   updateShape(*record);
@@ -817,28 +984,42 @@ void SiconosBulletCollisionManager_impl::updateShapePosition(const BodyBulletSha
   DEBUG_END("SiconosBulletCollisionManager_impl::updateShapePosition(...)\n");
 }
 
-void SiconosBulletCollisionManager_impl::createCollisionObject(
-  const SP::SiconosVector base,
-  const SP::RigidBodyDS ds,
-  SP::SiconosSphere sphere,
-  const SP::SiconosContactor contactor,
-  const SP::StaticBody staticBody)
+// set radius to 1.0 and use scaling instead of setting radius
+// directly, makes it easier to change during update
+static SP::BTSPHERESHAPE makeBtSphere()
 {
-  // set radius to 1.0 and use scaling instead of setting radius
-  // directly, makes it easier to change during update
-
 #ifdef USE_CONVEXHULL_FOR_SPHERE
   // A sphere can be represented as a convex hull of a single point, with the
   // margin equal to the radius size
   SP::btConvexHullShape btsphere(new btConvexHullShape());
-  {
-    btsphere->addPoint(btVector3(0.0, 0.0, 0.0));
-    btsphere->setMargin(0.0);
-  }
+  btsphere->addPoint(btVector3(0.0, 0.0, 0.0));
+  btsphere->setMargin(0.0);
 #else
   SP::btSphereShape btsphere(new btSphereShape(1.0));
   btsphere->setMargin(0.0);
 #endif
+  return btsphere;
+}
+
+static std::string sphereCacheKey(const SP::SiconosSphere& sphere)
+{
+  return btShapeCacheKey("sphere", { sphere->radius(),
+                                     sphere->insideMargin(),
+                                     sphere->outsideMargin() });
+}
+
+void SiconosBulletCollisionManager_impl::createCollisionObject(
+  const SP::SiconosVector base,
+  const SP::RigidBodyDS ds,
+  SP::SiconosSphere sphere,
+  const SP::SiconosContactor contactor,
+  const SP::StaticBody staticBody)
+{
+  // one unit sphere shared between all contactors with the same radius
+  // and margins
+  SP::BTSPHERESHAPE btsphere(
+    sharedBtShape<BTSPHERESHAPE>(_sharedShapeCache, sphereCacheKey(sphere),
+                                 makeBtSphere));
 
   // initialization
   createCollisionObjectHelper<SP::SiconosSphere, SP::BTSPHERESHAPE,
@@ -886,6 +1067,21 @@ void SiconosBulletCollisionManager_impl::updateShape(BodySphereRecord &record)
 
   if(sphere->version() != record.shape_version)
   {
+    // If the parameters no longer match those of the records sharing
+    // the current Bullet shape, bind (or create) the shape for the new
+    // key instead of mutating a shape other records still use.
+    const std::string key(sphereCacheKey(sphere));
+    if(key != record.btshape_key)
+    {
+      btsphere = sharedBtShape<BTSPHERESHAPE>(_sharedShapeCache, key,
+                                              makeBtSphere);
+      if(_options.enablePolyhedralContactClipping)
+        initPolyhedralFeatures(*btsphere);
+      record.btshape = btsphere;
+      record.btobject->setCollisionShape(&*btsphere);
+      record.btshape_key = key;
+    }
+
     double r = (sphere->radius() + sphere->outsideMargin()) * _options.worldScale;
 
     // Update shape parameters
@@ -987,12 +1183,7 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyPlaneRecord& record)
   record.btobject->setWorldTransform(t);
 }
 
-void SiconosBulletCollisionManager_impl::createCollisionObject(
-  const SP::SiconosVector base,
-  const SP::RigidBodyDS ds,
-  SP::SiconosBox box,
-  SP::SiconosContactor contactor,
-  const SP::StaticBody staticBody)
+static SP::BTBOXSHAPE makeBtBox()
 {
   const btScalar half = 0.5;
 
@@ -1010,16 +1201,37 @@ void SiconosBulletCollisionManager_impl::createCollisionObject(
     };
   SP::btConvexHullShape btbox(
     new btConvexHullShape(pts, 8, sizeof(pts[0])*3));
-
-  // External margin
-  btbox->setMargin(box->outsideMargin());
 #else
   SP::btBoxShape btbox(new btBoxShape(btVector3(half, half, half)));
-
-  // btBoxShape has an internal margin
-  btbox->setMargin(box->insideMargin() * _options.worldScale);
 #endif
 
+  // The margin is overwritten from the box parameters in updateShape().
+  btbox->setMargin(0.0);
+  return btbox;
+}
+
+static std::string boxCacheKey(const SP::SiconosBox& box)
+{
+  return btShapeCacheKey("box", { (*box->dimensions())(0),
+                                  (*box->dimensions())(1),
+                                  (*box->dimensions())(2),
+                                  box->insideMargin(),
+                                  box->outsideMargin() });
+}
+
+void SiconosBulletCollisionManager_impl::createCollisionObject(
+  const SP::SiconosVector base,
+  const SP::RigidBodyDS ds,
+  SP::SiconosBox box,
+  SP::SiconosContactor contactor,
+  const SP::StaticBody staticBody)
+{
+  // one unit box shared between all contactors with the same
+  // dimensions and margins
+  SP::BTBOXSHAPE btbox(
+    sharedBtShape<BTBOXSHAPE>(_sharedShapeCache, boxCacheKey(box),
+                              makeBtBox));
+
   // initialization
   createCollisionObjectHelper<SP::SiconosBox, SP::BTBOXSHAPE, SP::RigidBodyDS, BodyBoxRecord>
   (base, ds, box, btbox, bodyShapeMap, contactor,
@@ -1034,6 +1246,17 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyBoxRecord &record)
   // Update shape parameters
   if(box->version() != record.shape_version)
   {
+    const std::string key(boxCacheKey(box));
+    if(key != record.btshape_key)
+    {
+      btbox = sharedBtShape<BTBOXSHAPE>(_sharedShapeCache, key, makeBtBox);
+      if(_options.enablePolyhedralContactClipping)
+        initPolyhedralFeatures(*btbox);
+      record.btshape = btbox;
+      record.btobject->setCollisionShape(&*btbox);
+      record.btshape_key = key;
+    }
+
 #ifdef USE_CONVEXHULL_FOR_BOX
     double m = -box->insideMargin();
 #else
@@ -1065,6 +1288,19 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyBoxRecord &record)
 
   updateShapePosition(record);
 }
+static SP::BTCYLSHAPE makeBtCylinder()
+{
+  return SP::BTCYLSHAPE(new BTCYLSHAPE(btVector3(1.0, 1.0, 1.0)));
+}
+
+static std::string cylinderCacheKey(const SP::SiconosCylinder& cyl)
+{
+  return btShapeCacheKey("cylinder", { cyl->radius(),
+                                       cyl->length(),
+                                       cyl->insideMargin(),
+                                       cyl->outsideMargin() });
+}
+
 void SiconosBulletCollisionManager_impl::createCollisionObject(
   const SP::SiconosVector base,
   const SP::RigidBodyDS ds,
@@ -1072,7 +1308,11 @@ void SiconosBulletCollisionManager_impl::createCollisionObject(
   SP::SiconosContactor contactor,
   const SP::StaticBody staticBody)
 {
-  SP::BTCYLSHAPE btcylinder(new BTCYLSHAPE(btVector3(1.0, 1.0, 1.0)));
+  // one unit cylinder shared between all contactors with the same
+  // radius, length and margins
+  SP::BTCYLSHAPE btcylinder(
+    sharedBtShape<BTCYLSHAPE>(_sharedShapeCache, cylinderCacheKey(cylinder),
+                              makeBtCylinder));
 
   // initialization
   createCollisionObjectHelper<SP::SiconosCylinder, SP::BTCYLSHAPE, SP::RigidBodyDS, BodyCylinderRecord>
@@ -1088,6 +1328,16 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyCylinderRecord &record)
   // Update shape parameters
   if(cyl->version() != record.shape_version)
   {
+    const std::string key(cylinderCacheKey(cyl));
+    if(key != record.btshape_key)
+    {
+      btcyl = sharedBtShape<BTCYLSHAPE>(_sharedShapeCache, key,
+                                        makeBtCylinder);
+      record.btshape = btcyl;
+      record.btobject->setCollisionShape(&*btcyl);
+      record.btshape_key = key;
+    }
+
     // Bullet cylinder has an inside margin, so we add the outside
     // margin explicitly.
     double m = cyl->outsideMargin();
@@ -1117,6 +1367,19 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyCylinderRecord &record)
 }
 
 
+static SP::BTCONSHAPE makeBtCone()
+{
+  return SP::BTCONSHAPE(new BTCONSHAPE(1.0, 1.0));
+}
+
+static std::string coneCacheKey(const SP::SiconosCone& cone)
+{
+  return btShapeCacheKey("cone", { cone->radius(),
+                                   cone->length(),
+                                   cone->insideMargin(),
+                                   cone->outsideMargin() });
+}
+
 void SiconosBulletCollisionManager_impl::createCollisionObject(
   const SP::SiconosVector base,
   const SP::RigidBodyDS ds,
@@ -1124,7 +1387,11 @@ void SiconosBulletCollisionManager_impl::createCollisionObject(
   SP::SiconosContactor contactor,
   const SP::StaticBody staticBody)
 {
-  SP::BTCONSHAPE btcone(new BTCONSHAPE(1.0, 1.0));
+  // one unit cone shared between all contactors with the same radius,
+  // length and margins
+  SP::BTCONSHAPE btcone(
+    sharedBtShape<BTCONSHAPE>(_sharedShapeCache, coneCacheKey(cone),
+                              makeBtCone));
 
   // initialization
   createCollisionObjectHelper<SP::SiconosCone, SP::BTCONSHAPE, SP::RigidBodyDS, BodyConeRecord>
@@ -1140,6 +1407,15 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyConeRecord &record)
   // Update shape parameters
   if(cone->version() != record.shape_version)
   {
+    const std::string key(coneCacheKey(cone));
+    if(key != record.btshape_key)
+    {
+      btcone = sharedBtShape<BTCONSHAPE>(_sharedShapeCache, key, makeBtCone);
+      record.btshape = btcone;
+      record.btobject->setCollisionShape(&*btcone);
+      record.btshape_key = key;
+    }
+
     // Bullet cone has an inside margin, so we add the outside
     // margin explicitly.
     double m = cone->outsideMargin();
@@ -1168,6 +1444,19 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyConeRecord &record)
   updateShapePosition(record);
 }
 
+static SP::BTCAPSHAPE makeBtCapsule()
+{
+  return SP::BTCAPSHAPE(new BTCAPSHAPE(1.0, 1.0));
+}
+
+static std::string capsuleCacheKey(const SP::SiconosCapsule& capsule)
+{
+  return btShapeCacheKey("capsule", { capsule->radius(),
+                                      capsule->length(),
+                                      capsule->insideMargin(),
+                                      capsule->outsideMargin() });
+}
+
 void SiconosBulletCollisionManager_impl::createCollisionObject(
   const SP::SiconosVector base,
   const SP::RigidBodyDS ds,
@@ -1175,7 +1464,11 @@ void SiconosBulletCollisionManager_impl::createCollisionObject(
   SP::SiconosContactor contactor,
   const SP::StaticBody staticBody)
 {
-  SP::BTCAPSHAPE btcapsule(new BTCAPSHAPE(1.0, 1.0));
+  // one unit capsule shared between all contactors with the same
+  // radius, length and margins
+  SP::BTCAPSHAPE btcapsule(
+    sharedBtShape<BTCAPSHAPE>(_sharedShapeCache, capsuleCacheKey(capsule),
+                              makeBtCapsule));
 
   // initialization
   createCollisionObjectHelper<SP::SiconosCapsule, SP::BTCAPSHAPE, SP::RigidBodyDS, BodyCapsuleRecord>
@@ -1191,6 +1484,16 @@ void SiconosBulletCollisionManager_impl::updateShape(BodyCapsuleRecord &record)
   // Update shape parameters
   if(capsule->version() != record.shape_version)
   {
+    const std::string key(capsuleCacheKey(capsule));
+    if(key != record.btshape_key)
+    {
+      btcapsule = sharedBtShape<BTCAPSHAPE>(_sharedShapeCache, key,
+                                            makeBtCapsule);
+      record.btshape = btcapsule;
+      record.btobject->setCollisionShape(&*btcapsule);
+      record.btshape_key = key;
+    }
+
     // Bullet capsule has an inside margin, so we add the outside
     // margin explicitly.
     double m = capsule->outsideMargin();
@@ -2134,6 +2437,7 @@ void SiconosBulletCollisionManager::removeBody(const SP::SecondOrderDS& body)
   }
 
   _impl->bodyShapeMap.erase(it);
+  _impl->_structuralChange = true;
 }
 
 /** This class allows to iterate over all the contact points in a
@@ -2245,6 +2549,7 @@ public:
 
 // called once for each contact point as it is destroyed
 Simulation* SiconosBulletCollisionManager::gSimulation;
+SiconosBulletCollisionManager* SiconosBulletCollisionManager::gManager = nullptr;
 bool SiconosBulletCollisionManager::bulletContactClear(void* userPersistentData)
 {
   /* note: stored pointer to shared_ptr! */
@@ -2266,7 +2571,55 @@ bool SiconosBulletCollisionManager::bulletContactClear(void* userPersistentData)
   //   rel_bullet2d3DR->preDelete();
   // std::static_pointer_cast<BulletR>((*p_inter)->relation())->preDelete();
   //_stats.interaction_destroyed++;
-  gSimulation->unlink(*p_inter);
+  if(gManager && gManager->_stage_unlinks)
+    /* speculative detection pass: the NonSmoothDynamicalSystem must not
+     * be touched from the worker thread, commitInteractions unlinks */
+    gManager->_staged_unlinks.push_back(*p_inter);
+  else
+    gSimulation->unlink(*p_inter);
+
+  /* recycle contact interactions instead of freeing them: the next contact
+   * governed by the same nonsmooth law rebinds the body pair and the
+   * contact geometry on the pooled relation (see updateInteractions) */
+  if(gManager)
+  {
+    SP::Relation rel((*p_inter)->relation());
+    if(std::dynamic_pointer_cast<BulletR>(rel)
+       || std::dynamic_pointer_cast<Bullet5DR>(rel)
+       || std::dynamic_pointer_cast<Bullet2dR>(rel)
+       || std::dynamic_pointer_cast<Bullet2d3DR>(rel))
+    {
+      /* remember the world contact position and the last reaction: if the
+       * same detection pass re-creates a point at (nearly) this place the
+       * contact is physically persistent and its interaction is warm
+       * started from this record (see updateInteractions) */
+      SP::SiconosVector pc;
+      SP::NewtonEuler1DR rel3d(std::dynamic_pointer_cast<NewtonEuler1DR>(rel));
+      SP::Lagrangian2d2DR rel2d(std::dynamic_pointer_cast<Lagrangian2d2DR>(rel));
+      SP::Lagrangian2d3DR rel2d3d(std::dynamic_pointer_cast<Lagrangian2d3DR>(rel));
+      if(rel3d) pc = rel3d->pc1();
+      else if(rel2d) pc = rel2d->pc1();
+      else if(rel2d3d) pc = rel2d3d->pc1();
+      if(pc)
+      {
+        SiconosBulletCollisionManager::VanishedContactRecord vrec;
+        vrec.pos[0] = (*pc)(0);
+        vrec.pos[1] = (*pc)(1);
+        vrec.pos[2] = pc->size() > 2 ? (*pc)(2) : 0.0;
+        unsigned int upper = (*p_inter)->upperLevelForInput();
+        vrec.lambdas.resize(upper + 1);
+        for(unsigned int i = (*p_inter)->lowerLevelForInput(); i <= upper; ++i)
+        {
+          if((*p_inter)->lambda(i))
+            vrec.lambdas[i].reset(new SiconosVector(*(*p_inter)->lambda(i)));
+        }
+        gManager->_vanished_contacts.push_back(vrec);
+      }
+
+      gManager->_interaction_pool.release((*p_inter)->nonSmoothLaw(), *p_inter);
+    }
+  }
+
   delete p_inter;
   return false;
 }
@@ -2465,8 +2818,16 @@ public:
   using SiconosVisitor::visit;
   SiconosBulletCollisionManager_impl &impl;
 
-  CollisionUpdateVisitor(SiconosBulletCollisionManager_impl& _impl)
-    : impl(_impl) {}
+  /** step length, for the temporal-coherence displacement bounds */
+  double timeStep;
+
+  /** upper bound (bullet units) on the displacement of any visited
+   *  awake body over this step */
+  double maxDisplacement = 0.0;
+
+  CollisionUpdateVisitor(SiconosBulletCollisionManager_impl& _impl,
+                         double h)
+    : impl(_impl), timeStep(h) {}
 
   void visit(SP::RigidBodyDS bds)
   {
@@ -2475,8 +2836,27 @@ public:
       if(impl.bodyShapeMap.find(&*bds) == impl.bodyShapeMap.end())
       {
         impl.createCollisionObjectsForBodyContactorSet(bds);
+        impl._structuralChange = true;
+      }
+      /* a body that just fell asleep has not moved: its collision
+       * objects are already in place, the broadphase update is skipped
+       * until something wakes it up */
+      bds->updateSleepState();
+      if(bds->sleeping())
+        return;
+      double bound = impl.displacementBound(*bds, timeStep);
+      if(bound > maxDisplacement) maxDisplacement = bound;
+      /* a changed shape parameter (rare) touches the broadphase, so it is
+       * handled here, serially; the common case -- only the world
+       * transforms need pushing into bullet -- is queued for the batched
+       * parallel transform sync below */
+      if(impl.hasStaleShapes(*bds))
+      {
+        impl.updateAllShapesForDS(*bds);
+        impl._structuralChange = true;
       }
-      impl.updateAllShapesForDS(*bds);
+      else
+        impl._transform_sync_queue.push_back(&*bds);
     }
   }
   void visit(SP::RigidBody2dDS bds)
@@ -2486,16 +2866,113 @@ public:
       if(impl.bodyShapeMap.find(&*bds) == impl.bodyShapeMap.end())
       {
         impl.createCollisionObjectsForBodyContactorSet(bds);
+        impl._structuralChange = true;
+      }
+      double bound = impl.displacementBound(*bds, timeStep);
+      if(bound > maxDisplacement) maxDisplacement = bound;
+      if(impl.hasStaleShapes(*bds))
+      {
+        impl.updateAllShapesForDS(*bds);
+        impl._structuralChange = true;
       }
-      impl.updateAllShapesForDS(*bds);
+      else
+        impl._transform_sync_queue.push_back(&*bds);
     }
   }
 
 };
 
+/* Wake a sleeping body and, transitively, the sleeping bodies in contact
+   with it: a settled pile hit by a moving body has to be reactivated as a
+   whole, since releasing one support may set the others in motion. The
+   sleeping flag doubles as the visited mark of the traversal. */
+static void wakeBodyAndContactNeighbours(Simulation& simulation,
+                                         SP::SecondOrderDS ds)
+{
+  if(!ds || !ds->sleeping())
+    return;
+
+  SP::InteractionsGraph indexSet0 =
+    simulation.nonSmoothDynamicalSystem()->topology()->indexSet0();
+
+  auto wakeOne = [](const SP::DynamicalSystem& body)
+  {
+    SP::RigidBodyDS rbds(std::dynamic_pointer_cast<RigidBodyDS>(body));
+    if(rbds)
+      rbds->wake();
+    else
+      body->setSleeping(false);
+  };
+
+  std::vector<SP::DynamicalSystem> worklist;
+  wakeOne(ds);
+  worklist.push_back(ds);
+
+  while(!worklist.empty())
+  {
+    SP::DynamicalSystem current = worklist.back();
+    worklist.pop_back();
+
+    InteractionsGraph::VIterator ui, uiend;
+    for(std::tie(ui, uiend) = indexSet0->vertices(); ui != uiend; ++ui)
+    {
+      SP::DynamicalSystem ds1 = indexSet0->properties(*ui).source;
+      SP::DynamicalSystem ds2 = indexSet0->properties(*ui).target;
+      SP::DynamicalSystem other;
+      if(&*ds1 == &*current)
+        other = ds2;
+      else if(&*ds2 == &*current)
+        other = ds1;
+      if(other && other->sleeping())
+      {
+        wakeOne(other);
+        worklist.push_back(other);
+      }
+    }
+  }
+}
+
 void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation)
 {
   DEBUG_BEGIN("SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation)\n");
+  performDetectionPass(simulation);
+  applyDetectionPass(simulation);
+  DEBUG_END("SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation)\n");
+}
+
+void SiconosBulletCollisionManager::detectInteractions(SP::Simulation simulation)
+{
+  DEBUG_BEGIN("SiconosBulletCollisionManager::detectInteractions(SP::Simulation simulation)\n");
+  /* worker-thread half of the speculative protocol: only the collision
+   * world is touched; the unlinks triggered by the contact-destroyed
+   * callback are staged for the commit */
+  _staged_unlinks.clear();
+  _stage_unlinks = true;
+  performDetectionPass(simulation);
+  _stage_unlinks = false;
+  _detection_pending = true;
+  DEBUG_END("SiconosBulletCollisionManager::detectInteractions(SP::Simulation simulation)\n");
+}
+
+void SiconosBulletCollisionManager::commitInteractions(SP::Simulation simulation)
+{
+  if(!_detection_pending)
+    return;
+  _detection_pending = false;
+
+  DEBUG_BEGIN("SiconosBulletCollisionManager::commitInteractions(SP::Simulation simulation)\n");
+  /* unlink the contacts that vanished during the detection before the
+   * classification recycles their pooled interactions */
+  for(size_t k = 0; k < _staged_unlinks.size(); ++k)
+    simulation->unlink(_staged_unlinks[k]);
+  _staged_unlinks.clear();
+
+  applyDetectionPass(simulation);
+  DEBUG_END("SiconosBulletCollisionManager::commitInteractions(SP::Simulation simulation)\n");
+}
+
+void SiconosBulletCollisionManager::performDetectionPass(SP::Simulation simulation)
+{
 #ifdef BULLET_TIMER
   CProfileManager::Start_Profile("bullet_profile.txt");
   CProfileManager::Reset();
@@ -2506,8 +2983,23 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
   start = std::chrono::system_clock::now();
 #endif
 
-  SP::SiconosVisitor updateVisitor(new CollisionUpdateVisitor(*_impl));
+  CollisionUpdateVisitor* rawUpdateVisitor =
+    new CollisionUpdateVisitor(*_impl, simulation->timeStep());
+  SP::SiconosVisitor updateVisitor(rawUpdateVisitor);
   simulation->nonSmoothDynamicalSystem()->visitDynamicalSystems(updateVisitor);
+
+  // batched transform sync: for the bodies queued by the visitor only the
+  // world transforms have to be pushed into bullet, and each body touches
+  // nothing but its own collision objects, so the sync runs in parallel
+  {
+    std::vector<const SecondOrderDS*>& queue = _impl->_transform_sync_queue;
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(static)
+#endif
+    for(std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(queue.size()); ++k)
+      _impl->updateAllShapesForDS(*queue[k]);
+    queue.clear();
+  }
 #ifdef BULLET_TIMER
   end = std::chrono::system_clock::now();
   int elapsed = std::chrono::duration_cast<std::chrono::milliseconds> (end-start).count();
@@ -2546,14 +3038,54 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
 #endif
   // 0. set up bullet callbacks
   gSimulation = &*simulation;
+  gManager = this;
   gContactDestroyedCallback = this->bulletContactClear;
   gContactAddedCallback = this->bulletContactAddedCallback;
 
   // Important parameter controlling contact point making and breaking
   gContactBreakingThreshold = _options.contactBreakingThreshold;
 
+  // only the reactions of contacts destroyed by this detection pass are
+  // candidates for warm starting the re-created contact points below
+  _vanished_contacts.clear();
+
   // 1. perform bullet collision detection
-  _impl->_collisionWorld->performDiscreteCollisionDetection();
+  //
+  // temporal coherence gate: a pair absent from the overlapping pair
+  // cache had, when the cache was last rebuilt, its two AABBs separated
+  // even after each was inflated by the contact breaking threshold, so a
+  // new pair needs a relative approach of at least that threshold.  As
+  // long as twice the cumulative per-body displacement bound stays below
+  // it, the pair list cannot have changed and only the narrowphase is
+  // run on the cached pairs (with the fresh transforms pushed above).
+  bool reuse_pairs = false;
+  if(_options.temporalCoherenceGating
+      && _impl->_pairCacheValid
+      && !_impl->_structuralChange
+      && !_options.clearOverlappingPairCache)
+  {
+    if(2.0 * (_impl->_motionSinceBroadphase + rawUpdateVisitor->maxDisplacement)
+        < _options.contactBreakingThreshold)
+      reuse_pairs = true;
+  }
+
+  if(reuse_pairs)
+  {
+    _impl->_motionSinceBroadphase += rawUpdateVisitor->maxDisplacement;
+    _stats.broadphase_skipped += 1;
+    btDispatcher* narrowphase = _impl->_collisionWorld->getDispatcher();
+    narrowphase->dispatchAllCollisionPairs(
+      _impl->_broadphase->getOverlappingPairCache(),
+      _impl->_collisionWorld->getDispatchInfo(),
+      narrowphase);
+  }
+  else
+  {
+    _impl->_motionSinceBroadphase = 0.0;
+    _impl->_pairCacheValid = true;
+    _impl->_collisionWorld->performDiscreteCollisionDetection();
+  }
+  _impl->_structuralChange = false;
 #ifdef BULLET_TIMER
   end_old =end;
   end = std::chrono::system_clock::now();
@@ -2567,117 +3099,194 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
   CProfileManager::dumpAll();
   CProfileManager::Stop_Profile();
 #endif
+}
+
+void SiconosBulletCollisionManager::applyDetectionPass(SP::Simulation simulation)
+{
+#ifdef BULLET_TIMER
+  std::chrono::time_point<std::chrono::system_clock> start, end;
+  start = std::chrono::system_clock::now();
+#endif
 
   DEBUG_PRINT("SiconosBulletCollisionManager :: iterating contact points:\n");
   //getchar();
   // 2. deleted contact points have been removed from the graph during the
   //    bullet collision detection callbacks
 
-  // 3. for each contact point, if there is no interaction, create one
-  IterateContactPoints t(_impl->_collisionWorld);
-  IterateContactPoints::iterator it, itend=t.end();
-  DEBUG_EXPR_WE(
-    int num_contact_points =0;
-    for(it=t.begin(); it!=itend; ++it)  num_contact_points++;
-    std::cout << "Number of contacts points detected by bullet: " << num_contact_points << std::endl; );
-
-  for(it=t.begin(); it!=itend; ++it)
+  // 3. classify the remaining contact points. Persistent and new points are
+  //    sorted concurrently into per-thread buffers (the per-point tests only
+  //    read the collision objects and the index sets); the relation updates
+  //    of the persistent points then run in parallel, while the interactions
+  //    of the new points are created serially and linked into the topology
+  //    in one batched pass at the end.
+  struct ContactPointRecord
   {
-    DEBUG_PRINTF("\n\n\nSiconosBulletCollisionManager ::   -- %p, %p, %p\n", it->objectA, it->objectB, it->point);
+    btPersistentManifold* manifold;
+    btManifoldPoint* point;
+    const BodyBulletShapeRecord* pairA;
+    const BodyBulletShapeRecord* pairB;
+    bool flip;
+  };
 
-    // Get the RigidBodyDS and SiconosShape pointers
+  btDispatcher* dispatcher = _impl->_collisionWorld->getDispatcher();
+  int numManifolds = dispatcher->getNumManifolds();
 
-    const BodyBulletShapeRecord *pairA, *pairB;
-    pairA = reinterpret_cast<const BodyBulletShapeRecord*>(it->objectA->getUserPointer());
-    pairB = reinterpret_cast<const BodyBulletShapeRecord*>(it->objectB->getUserPointer());
-    assert(pairA && pairB && "btCollisionObject had a null user pointer!");
+#if defined(_OPENMP)
+  int nthreads = omp_get_max_threads();
+#else
+  int nthreads = 1;
+#endif
+  std::vector<std::vector<ContactPointRecord> > persistent_buffers(nthreads);
+  std::vector<std::vector<ContactPointRecord> > new_buffers(nthreads);
+
+  SP::InteractionsGraph indexSet0 =
+    simulation->nonSmoothDynamicalSystem()->topology()->indexSet0();
+
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for(int m = 0; m < numManifolds; ++m)
+  {
+#if defined(_OPENMP)
+    std::vector<ContactPointRecord>& persistent_buffer = persistent_buffers[omp_get_thread_num()];
+    std::vector<ContactPointRecord>& new_buffer = new_buffers[omp_get_thread_num()];
+#else
+    std::vector<ContactPointRecord>& persistent_buffer = persistent_buffers[0];
+    std::vector<ContactPointRecord>& new_buffer = new_buffers[0];
+#endif
+    btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(m);
 
-    // The first pair will always be the non-static object
-    // As a consequence, if there is a static body, it is always associated with second pair pairB
-    bool flip = false;
-    if(pairB->ds && !pairA->ds)
+    for(int p = 0; p < manifold->getNumContacts(); ++p)
     {
-      pairA = reinterpret_cast<const BodyBulletShapeRecord*>(it->objectB->getUserPointer());
-      pairB = reinterpret_cast<const BodyBulletShapeRecord*>(it->objectA->getUserPointer());
-      flip = true;
-    }
-    DEBUG_PRINTF("SiconosBulletCollisionManager :: flip = %i \n", flip);
-    // If both collision objects belong to the same body (or no body),
-    // no interaction is created.
-    if(pairA->ds == pairB->ds)
-      continue;
-
-    // If the two bodies are already connected by another type of
-    // relation (e.g. EqualityCondition == they have a joint between
-    // them), then don't create contact constraints, because it leads
-    // to an ill-conditioned problem.
-
-    DEBUG_EXPR_WE(
-      if (pairA->ds && pairB->ds)
-      {
-        DEBUG_PRINTF("SiconosBulletCollisionManager ::   -- ds1 :  %zu,  ds2: %zu\n",
-                     pairA->ds->number(),
-                     pairB->ds->number());
-      }
-      if (pairA->ds && pairB->staticBody)
+      btManifoldPoint& cpoint = manifold->getContactPoint(p);
+
+      // Get the RigidBodyDS and SiconosShape pointers
+
+      const BodyBulletShapeRecord *pairA, *pairB;
+      pairA = reinterpret_cast<const BodyBulletShapeRecord*>(manifold->getBody0()->getUserPointer());
+      pairB = reinterpret_cast<const BodyBulletShapeRecord*>(manifold->getBody1()->getUserPointer());
+      assert(pairA && pairB && "btCollisionObject had a null user pointer!");
+
+      // The first pair will always be the non-static object
+      // As a consequence, if there is a static body, it is always associated with second pair pairB
+      bool flip = false;
+      if(pairB->ds && !pairA->ds)
       {
-        DEBUG_PRINTF("SiconosBulletCollisionManager ::   -- ds1 :  %zu  staticbody: %i\n",
-                     pairA->ds->number(),
-                     pairB->staticBody->number);
+        const BodyBulletShapeRecord *tmp = pairA;
+        pairA = pairB;
+        pairB = tmp;
+        flip = true;
       }
-      );
+      DEBUG_PRINTF("SiconosBulletCollisionManager :: flip = %i \n", flip);
+      // If both collision objects belong to the same body (or no body),
+      // no interaction is created.
+      if(pairA->ds == pairB->ds)
+        continue;
 
-    DEBUG_PRINTF("SiconosBulletCollisionManager :: _with_equality_constraints  -- %i\n", _with_equality_constraints);
+      // If the two bodies are already connected by another type of
+      // relation (e.g. EqualityCondition == they have a joint between
+      // them), then don't create contact constraints, because it leads
+      // to an ill-conditioned problem.
 
+      DEBUG_EXPR_WE(
+        if (pairA->ds && pairB->ds)
+        {
+          DEBUG_PRINTF("SiconosBulletCollisionManager ::   -- ds1 :  %zu,  ds2: %zu\n",
+                       pairA->ds->number(),
+                       pairB->ds->number());
+        }
+        if (pairA->ds && pairB->staticBody)
+        {
+          DEBUG_PRINTF("SiconosBulletCollisionManager ::   -- ds1 :  %zu  staticbody: %i\n",
+                       pairA->ds->number(),
+                       pairB->staticBody->number);
+        }
+        );
 
-    if(_with_equality_constraints && pairA->ds && pairB->ds)
-    {
-      InteractionsGraph::VIterator ui, uiend;
-      SP::InteractionsGraph indexSet0 = simulation->nonSmoothDynamicalSystem()->topology()->indexSet0();
-      bool match = false;
-      for(std::tie(ui, uiend) = indexSet0->vertices(); ui != uiend; ++ui)
+      DEBUG_PRINTF("SiconosBulletCollisionManager :: _with_equality_constraints  -- %i\n", _with_equality_constraints);
+
+
+      if(_with_equality_constraints && pairA->ds && pairB->ds)
       {
-        SP::Interaction inter(indexSet0->bundle(*ui));
-        SP::SecondOrderDS ds1(std::dynamic_pointer_cast<SecondOrderDS>(
-                                indexSet0->properties(*ui).source));
-        SP::SecondOrderDS ds2(std::dynamic_pointer_cast<SecondOrderDS>(
-                                indexSet0->properties(*ui).target));
-        if(ds1 && ds2 && (((&*ds1==&*pairA->ds) && (&*ds2==&*pairB->ds))
-                          || ((&*ds1==&*pairB->ds) && (&*ds2==&*pairA->ds))))
+        InteractionsGraph::VIterator ui, uiend;
+        bool match = false;
+        for(std::tie(ui, uiend) = indexSet0->vertices(); ui != uiend; ++ui)
         {
-          SP::BulletR br(std::dynamic_pointer_cast<BulletR>(inter->relation()));
-          DEBUG_EXPR(std::cout << "br" << br << std::endl;);
-          if(!br)
+          SP::Interaction inter(indexSet0->bundle(*ui));
+          SP::SecondOrderDS ds1(std::dynamic_pointer_cast<SecondOrderDS>(
+                                  indexSet0->properties(*ui).source));
+          SP::SecondOrderDS ds2(std::dynamic_pointer_cast<SecondOrderDS>(
+                                  indexSet0->properties(*ui).target));
+          if(ds1 && ds2 && (((&*ds1==&*pairA->ds) && (&*ds2==&*pairB->ds))
+                            || ((&*ds1==&*pairB->ds) && (&*ds2==&*pairA->ds))))
           {
-            DEBUG_PRINT("Only match on non-BulletR interactions, i.e. non-contact relations\n");
-            SP::NewtonEulerJointR jr(
-              std::dynamic_pointer_cast<NewtonEulerJointR>(inter->relation()));
-
-            /* If it is a joint, check the joint self-collide property */
-            if(jr && !jr->allowSelfCollide())
-              match = true;
-
-            /* If any non-contact relation is found, both bodies must
-             * allow self-collide */
-            // We need to check for other type of dynamical systems.
-            SP::RigidBodyDS rbdsA =  std::static_pointer_cast<RigidBodyDS>(pairA->ds);
-            SP::RigidBodyDS rbdsB =  std::static_pointer_cast<RigidBodyDS>(pairB->ds);
-            if(!rbdsA->allowSelfCollide() || !rbdsB->allowSelfCollide())
-              match = true;
+            SP::BulletR br(std::dynamic_pointer_cast<BulletR>(inter->relation()));
+            DEBUG_EXPR(std::cout << "br" << br << std::endl;);
+            if(!br)
+            {
+              DEBUG_PRINT("Only match on non-BulletR interactions, i.e. non-contact relations\n");
+              SP::NewtonEulerJointR jr(
+                std::dynamic_pointer_cast<NewtonEulerJointR>(inter->relation()));
+
+              /* If it is a joint, check the joint self-collide property */
+              if(jr && !jr->allowSelfCollide())
+                match = true;
+
+              /* If any non-contact relation is found, both bodies must
+               * allow self-collide */
+              // We need to check for other type of dynamical systems.
+              SP::RigidBodyDS rbdsA =  std::static_pointer_cast<RigidBodyDS>(pairA->ds);
+              SP::RigidBodyDS rbdsB =  std::static_pointer_cast<RigidBodyDS>(pairB->ds);
+              if(!rbdsA->allowSelfCollide() || !rbdsB->allowSelfCollide())
+                match = true;
+            }
+            if(match) break;
           }
-          if(match) break;
         }
+        if(match)
+          continue;
       }
-      if(match)
-        continue;
+
+      ContactPointRecord record = { manifold, &cpoint, pairA, pairB, flip };
+      if(cpoint.m_userPersistentData)
+        persistent_buffer.push_back(record);
+      else
+        new_buffer.push_back(record);
     }
-    DEBUG_PRINTF("SiconosBulletCollisionManager :: it->point->m_userPersistentData  %p \n", it->point->m_userPersistentData);
-    if(it->point->m_userPersistentData)
+  }
+
+  // With a static schedule every thread owns a contiguous range of
+  // manifolds, so concatenating the buffers in thread order keeps the
+  // contact points in manifold order.
+  std::vector<ContactPointRecord> persistent_points;
+  std::vector<ContactPointRecord> new_points;
+  for(int tid = 0; tid < nthreads; ++tid)
+  {
+    persistent_points.insert(persistent_points.end(),
+                             persistent_buffers[tid].begin(), persistent_buffers[tid].end());
+    new_points.insert(new_points.end(),
+                      new_buffers[tid].begin(), new_buffers[tid].end());
+  }
+  DEBUG_PRINTF("SiconosBulletCollisionManager :: %zu persistent, %zu new contact points\n",
+               persistent_points.size(), new_points.size());
+
+  // 4. refresh the relation of each persistent contact point from its
+  //    manifold point; every point touches only its own Interaction, so the
+  //    updates run concurrently
+  bool unknown_relation = false;
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for(std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(persistent_points.size()); ++k)
+  {
+    const ContactPointRecord& rec = persistent_points[k];
+    const BodyBulletShapeRecord *pairA = rec.pairA, *pairB = rec.pairB;
+    bool flip = rec.flip;
     {
       /* interaction already exists */
       DEBUG_PRINT("SiconosBulletCollisionManager :: interaction already exists \n");
       SP::Interaction *p_inter =
-        (SP::Interaction*)it->point->m_userPersistentData;
+        (SP::Interaction*)rec.point->m_userPersistentData;
 
 
       SP::BulletR rel_bulletR(std::dynamic_pointer_cast<BulletR>((*p_inter)->relation()));
@@ -2694,7 +3303,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
 
         /* update the relation */
         SP::BulletR rel(std::static_pointer_cast<BulletR>((*p_inter)->relation()));
-        rel->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+        rel->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
             flip, _options.worldScale,
             rbdsA,
             rbdsB ? rbdsB
@@ -2708,7 +3317,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
         SP::RigidBody2dDS rbdsB =  std::static_pointer_cast<RigidBody2dDS>(pairB->ds);
 
         /* update the relation */
-        rel_bullet2dR->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+        rel_bullet2dR->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
             flip, _options.worldScale,
             rbdsA,
             rbdsB ? rbdsB
@@ -2722,7 +3331,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
         SP::RigidBody2dDS rbdsB =  std::static_pointer_cast<RigidBody2dDS>(pairB->ds);
 
         /* update the relation */
-        rel_bullet2d3DR->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+        rel_bullet2d3DR->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
             flip, _options.worldScale,
             rbdsA,
             rbdsB ? rbdsB
@@ -2731,13 +3340,31 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
 
       else
       {
-        THROW_EXCEPTION("Unknown relation type");
+        /* throwing from inside a parallel region would terminate: record
+         * the failure and throw after the loop */
+        unknown_relation = true;
       }
+    }
+  }
+  if(unknown_relation)
+    THROW_EXCEPTION("Unknown relation type");
+  _stats.existing_interactions_processed += (int)persistent_points.size();
 
+  // 5. create the interactions of the new contact points, then link the
+  //    bodies into the topology in one batched serial pass
+  struct PendingLink
+  {
+    SP::Interaction inter;
+    SP::SecondOrderDS dsA;
+    SP::SecondOrderDS dsB;
+  };
+  std::vector<PendingLink> pending_links;
 
-      _stats.existing_interactions_processed ++;
-    }
-    else
+  for(size_t k = 0; k < new_points.size(); ++k)
+  {
+    const ContactPointRecord& rec = new_points[k];
+    const BodyBulletShapeRecord *pairA = rec.pairA, *pairB = rec.pairB;
+    bool flip = rec.flip;
     {
       /* new interaction */
       DEBUG_PRINT("SiconosBulletCollisionManager :: New interaction\n");
@@ -2764,11 +3391,20 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           SP::RigidBodyDS rbdsA =  std::static_pointer_cast<RigidBodyDS>(pairA->ds);
           SP::RigidBodyDS rbdsB =  std::static_pointer_cast<RigidBodyDS>(pairB->ds);
 
-          SP::BulletR rel(makeBulletR(rbdsA, pairA->sshape,
-                                      rbdsB, pairB->sshape,
-                                      *it->point));
-
-          if(!rel) continue;
+          /* reuse a pooled interaction for this nonsmooth law if one is
+           * available: the relation is fully constructed, only the body
+           * pair and the contact geometry are rebound below */
+          SP::Interaction pooled(_interaction_pool.acquire(nslaw));
+          SP::BulletR rel;
+          if(pooled)
+            rel = std::static_pointer_cast<BulletR>(pooled->relation());
+          else
+          {
+            rel = makeBulletR(rbdsA, pairA->sshape,
+                              rbdsB, pairB->sshape,
+                              *rec.point);
+            if(!rel) continue;
+          }
 
           // Fill in extra contact information
           rel->bodyShapeRecordA = createSPtrBodyBulletShapeRecord(*const_cast<BodyBulletShapeRecord*>(pairA));
@@ -2780,7 +3416,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           // rel->btShape[0] = pairA->btshape;
           // rel->btShape[1] = pairB->btshape;
 
-          rel->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+          rel->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
               flip, _options.worldScale,
               rbdsA ? rbdsA : SP::NewtonEulerDS(),
               rbdsB ? rbdsB : SP::NewtonEulerDS());
@@ -2795,8 +3431,17 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
             _stats.interaction_warnings ++;
           }
 
-          inter = std::make_shared<Interaction>(nslaw, rel);
-          _stats.new_interactions_created ++;
+          if(pooled)
+          {
+            inter = pooled;
+            inter->resetAllLambda();
+            _stats.interactions_recycled ++;
+          }
+          else
+          {
+            inter = std::make_shared<Interaction>(nslaw, rel);
+            _stats.new_interactions_created ++;
+          }
         }
         else if(nslaw && nslaw->size() == 2)
         {
@@ -2804,11 +3449,20 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           SP::RigidBody2dDS rbdsA =  std::static_pointer_cast<RigidBody2dDS>(pairA->ds);
           SP::RigidBody2dDS rbdsB =  std::static_pointer_cast<RigidBody2dDS>(pairB->ds);
 
-          SP::Bullet2dR rel(makeBullet2dR(rbdsA, pairA->sshape,
-                                          rbdsB, pairB->sshape,
-                                          *it->point));
-
-          if(!rel) continue;
+          /* reuse a pooled interaction for this nonsmooth law if one is
+           * available: the relation is fully constructed, only the body
+           * pair and the contact geometry are rebound below */
+          SP::Interaction pooled(_interaction_pool.acquire(nslaw));
+          SP::Bullet2dR rel;
+          if(pooled)
+            rel = std::static_pointer_cast<Bullet2dR>(pooled->relation());
+          else
+          {
+            rel = makeBullet2dR(rbdsA, pairA->sshape,
+                     rbdsB, pairB->sshape,
+                     *rec.point);
+            if(!rel) continue;
+          }
 
            // Fill in extra contact information
           rel->bodyShapeRecordA = createSPtrBodyBulletShapeRecord(*const_cast<BodyBulletShapeRecord*>(pairA));
@@ -2820,7 +3474,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           // rel->btShape[0] = pairA->btshape;
           // rel->btShape[1] = pairB->btshape;
 
-          rel->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+          rel->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
               flip, _options.worldScale,
               rbdsA ? rbdsA : SP::RigidBody2dDS(),
               rbdsB ? rbdsB : SP::RigidBody2dDS());
@@ -2835,8 +3489,17 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
             _stats.interaction_warnings ++;
           }
           DEBUG_PRINT("SiconosBulletCollisionManager :: create 2d interaction\n");
-          inter = std::make_shared<Interaction>(nslaw, rel);
-          _stats.new_interactions_created ++;
+          if(pooled)
+          {
+            inter = pooled;
+            inter->resetAllLambda();
+            _stats.interactions_recycled ++;
+          }
+          else
+          {
+            inter = std::make_shared<Interaction>(nslaw, rel);
+            _stats.new_interactions_created ++;
+          }
         }
 
       }
@@ -2848,11 +3511,20 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           SP::RigidBodyDS rbdsA =  std::static_pointer_cast<RigidBodyDS>(pairA->ds);
           SP::RigidBodyDS rbdsB =  std::static_pointer_cast<RigidBodyDS>(pairB->ds);
 
-          SP::Bullet5DR rel(makeBullet5DR(rbdsA, pairA->sshape,
-                                          rbdsB, pairB->sshape,
-                                          *it->point));
-
-          if(!rel) continue;
+          /* reuse a pooled interaction for this nonsmooth law if one is
+           * available: the relation is fully constructed, only the body
+           * pair and the contact geometry are rebound below */
+          SP::Interaction pooled(_interaction_pool.acquire(nslaw));
+          SP::Bullet5DR rel;
+          if(pooled)
+            rel = std::static_pointer_cast<Bullet5DR>(pooled->relation());
+          else
+          {
+            rel = makeBullet5DR(rbdsA, pairA->sshape,
+                     rbdsB, pairB->sshape,
+                     *rec.point);
+            if(!rel) continue;
+          }
 
           // Fill in extra contact information
           rel->bodyShapeRecordA = createSPtrBodyBulletShapeRecord(*const_cast<BodyBulletShapeRecord*>(pairA));
@@ -2864,7 +3536,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           // rel->btShape[0] = pairA->btshape;
           // rel->btShape[1] = pairB->btshape;
 
-          rel->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+          rel->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
               flip, _options.worldScale,
               rbdsA ? rbdsA : SP::NewtonEulerDS(),
               rbdsB ? rbdsB : SP::NewtonEulerDS());
@@ -2879,8 +3551,17 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
             _stats.interaction_warnings ++;
           }
 
-          inter = std::make_shared<Interaction>(nslaw, rel);
-          _stats.new_interactions_created ++;
+          if(pooled)
+          {
+            inter = pooled;
+            inter->resetAllLambda();
+            _stats.interactions_recycled ++;
+          }
+          else
+          {
+            inter = std::make_shared<Interaction>(nslaw, rel);
+            _stats.new_interactions_created ++;
+          }
         }
         else if(nslaw && nslaw->size() == 3)
         {
@@ -2888,11 +3569,20 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           SP::RigidBody2dDS rbdsA =  std::static_pointer_cast<RigidBody2dDS>(pairA->ds);
           SP::RigidBody2dDS rbdsB =  std::static_pointer_cast<RigidBody2dDS>(pairB->ds);
 
-          SP::Bullet2d3DR rel(makeBullet2d3DR(rbdsA, pairA->sshape,
-                                              rbdsB, pairB->sshape,
-                                              *it->point));
-
-          if(!rel) continue;
+          /* reuse a pooled interaction for this nonsmooth law if one is
+           * available: the relation is fully constructed, only the body
+           * pair and the contact geometry are rebound below */
+          SP::Interaction pooled(_interaction_pool.acquire(nslaw));
+          SP::Bullet2d3DR rel;
+          if(pooled)
+            rel = std::static_pointer_cast<Bullet2d3DR>(pooled->relation());
+          else
+          {
+            rel = makeBullet2d3DR(rbdsA, pairA->sshape,
+                     rbdsB, pairB->sshape,
+                     *rec.point);
+            if(!rel) continue;
+          }
 
           // Fill in extra contact information
           rel->bodyShapeRecordA = createSPtrBodyBulletShapeRecord(*const_cast<BodyBulletShapeRecord*>(pairA));
@@ -2908,7 +3598,7 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
           // rel->btShape[0] = pairA->btshape;
           // rel->btShape[1] = pairB->btshape;
 
-          rel->updateContactPointsFromManifoldPoint(*it->manifold, *it->point,
+          rel->updateContactPointsFromManifoldPoint(*rec.manifold, *rec.point,
               flip, _options.worldScale,
               rbdsA ? rbdsA : SP::RigidBody2dDS(),
               rbdsB ? rbdsB : SP::RigidBody2dDS());
@@ -2923,8 +3613,17 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
             _stats.interaction_warnings ++;
           }
           DEBUG_PRINT("SiconosBulletCollisionManager :: create 2d interaction\n");
-          inter = std::make_shared<Interaction>(nslaw, rel);
-          _stats.new_interactions_created ++;
+          if(pooled)
+          {
+            inter = pooled;
+            inter->resetAllLambda();
+            _stats.interactions_recycled ++;
+          }
+          else
+          {
+            inter = std::make_shared<Interaction>(nslaw, rel);
+            _stats.new_interactions_created ++;
+          }
         }
       }
       else
@@ -2933,33 +3632,79 @@ void SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation
         {
           SP::Bullet1DR rel(
             std::make_shared<Bullet1DR>(
-              createSPtrbtManifoldPoint(*it->point)));
+              createSPtrbtManifoldPoint(*rec.point)));
           inter = std::make_shared<Interaction>(nslaw, rel);
         }
       }
 
       if(inter)
       {
+        /* if a contact destroyed by this detection pass lived at (nearly)
+         * the same place, only the manifold point was replaced while the
+         * contact physically persisted: carry its reaction into the new
+         * interaction so the OSNS warm start does not see a fresh contact */
+        if(!_vanished_contacts.empty())
+        {
+          btVector3 posa = rec.point->getPositionWorldOnA() / _options.worldScale;
+          double tol = rec.manifold->getContactBreakingThreshold() / _options.worldScale;
+          size_t best = _vanished_contacts.size();
+          double best_d2 = tol * tol;
+          for(size_t v = 0; v < _vanished_contacts.size(); ++v)
+          {
+            const VanishedContactRecord& vrec = _vanished_contacts[v];
+            double dx = vrec.pos[0] - posa.x();
+            double dy = vrec.pos[1] - posa.y();
+            double dz = vrec.pos[2] - posa.z();
+            double d2 = dx*dx + dy*dy + dz*dz;
+            if(d2 < best_d2)
+            {
+              best_d2 = d2;
+              best = v;
+            }
+          }
+          if(best < _vanished_contacts.size())
+          {
+            const VanishedContactRecord& vrec = _vanished_contacts[best];
+            for(unsigned int i = 0; i < vrec.lambdas.size(); ++i)
+            {
+              if(vrec.lambdas[i] && vrec.lambdas[i]->size() == nslaw->size())
+                inter->setWarmStartLambda(i, *vrec.lambdas[i]);
+            }
+            _vanished_contacts.erase(_vanished_contacts.begin() + best);
+            _stats.interactions_warm_started ++;
+            DEBUG_PRINTF("SiconosBulletCollisionManager :: warm start interaction %zu from vanished contact\n",
+                         inter->number());
+          }
+        }
+
         /* store interaction in the contact point data, it will be freed by the
          * Bullet callback gContactDestroyedCallback */
         /* note: storing pointer to shared_ptr! */
-        it->point->m_userPersistentData = (void*)(new SP::Interaction(inter));
-        DEBUG_PRINT("SiconosBulletCollisionManager :: link the interaction\n");
-        /* link bodies by the new interaction */
-        simulation->link(inter, pairA->ds, pairB->ds);
+        rec.point->m_userPersistentData = (void*)(new SP::Interaction(inter));
+        pending_links.push_back(PendingLink{inter, pairA->ds, pairB->ds});
       }
     }
     //getchar();
   }
   //getchar();
+
+  /* link the bodies by the new interactions in one batched pass */
+  for(size_t k = 0; k < pending_links.size(); ++k)
+  {
+    DEBUG_PRINT("SiconosBulletCollisionManager :: link the interaction\n");
+    /* a new contact reaching a sleeping body reactivates it together
+       with the pile resting on it */
+    wakeBodyAndContactNeighbours(*simulation, pending_links[k].dsA);
+    wakeBodyAndContactNeighbours(*simulation, pending_links[k].dsB);
+    simulation->link(pending_links[k].inter,
+                     pending_links[k].dsA, pending_links[k].dsB);
+  }
 #ifdef BULLET_TIMER
-  end_old =end;
   end = std::chrono::system_clock::now();
-  elapsed = std::chrono::duration_cast<std::chrono::milliseconds>
-    (end-end_old).count();
+  int elapsed = std::chrono::duration_cast<std::chrono::milliseconds>
+    (end-start).count();
   std::cout << "2 : creation of interaction " << elapsed << " ms" << std::endl;
 #endif
-  DEBUG_END("SiconosBulletCollisionManager::updateInteractions(SP::Simulation simulation)\n");
 }
 
 void SiconosBulletCollisionManager::clearOverlappingPairCache()
@@ -2992,14 +3737,51 @@ bool cmpQueryResult(const SP::SiconosCollisionQueryResult &a,
   return a->distance < b->distance;
 }
 
-std::vector<SP::SiconosCollisionQueryResult>
-SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
-    const SiconosVector& end,
-    bool closestOnly,
-    bool sorted)
+/** Acquire a result object, recycled from the pool when one is given.
+ *  Called from the parallel bulk ray query: the pool free list is the
+ *  only mutable state shared by the threads, hence the critical
+ *  section. */
+static SP::SiconosCollisionQueryResult
+acquireQueryResult(SiconosCollisionQueryResultPool* pool)
 {
-  std::vector<SP::SiconosCollisionQueryResult> result_list;
+  if(!pool) return std::make_shared<SiconosCollisionQueryResult>();
+  SP::SiconosCollisionQueryResult result;
+#if defined(_OPENMP)
+#pragma omp critical (bullet_query_result_pool)
+#endif
+  result = pool->acquire();
+  return result;
+}
+
+/** Fill one query result from the intersected body-shape record. */
+static void fillQueryResult(SiconosCollisionQueryResult& result,
+                            const BodyShapeRecord* rec,
+                            const btVector3& hitPoint,
+                            const SiconosVector& origin)
+{
+  result.point.resize(3);
+  result.point.setValue(0, hitPoint.getX());
+  result.point.setValue(1, hitPoint.getY());
+  result.point.setValue(2, hitPoint.getZ());
+  double dx = hitPoint.getX() - origin(0);
+  double dy = hitPoint.getY() - origin(1);
+  double dz = hitPoint.getZ() - origin(2);
+  result.distance = sqrt(dx*dx + dy*dy + dz*dz);
+  result.body = rec->ds; // note: may be null for static contactors
+  result.shape = rec->sshape;
+  result.contactor = rec->contactor;
+}
 
+/** One ray test against the world, shared by the single and bulk
+ *  query entry points.  Bullet ray tests only read the collision
+ *  world, so this may be called concurrently. */
+static void bulletLineQuery(const btCollisionWorld& world,
+                            const SiconosVector& start,
+                            const SiconosVector& end,
+                            bool closestOnly, bool sorted,
+                            std::vector<SP::SiconosCollisionQueryResult>& result_list,
+                            SiconosCollisionQueryResultPool* pool)
+{
   btVector3 btstart(start(0), start(1), start(2));
   btVector3 btend(end(0), end(1), end(2));
 
@@ -3007,7 +3789,7 @@ SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
   if(closestOnly)
   {
     btCollisionWorld::ClosestRayResultCallback rayResult(btstart, btend);
-    _impl->_collisionWorld->rayTest(btstart, btend, rayResult);
+    world.rayTest(btstart, btend, rayResult);
 
     if(rayResult.hasHit())
     {
@@ -3017,16 +3799,8 @@ SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
 
       if(rec)
       {
-        SP::SiconosCollisionQueryResult result(
-          std::make_shared<SiconosCollisionQueryResult>());
-        result->point.resize(3);
-        result->point.setValue(0, rayResult.m_hitPointWorld.getX());
-        result->point.setValue(1, rayResult.m_hitPointWorld.getY());
-        result->point.setValue(2, rayResult.m_hitPointWorld.getZ());
-        result->distance = (result->point - start).norm2();
-        result->body = rec->ds; // note: may be null for static contactors
-        result->shape = rec->sshape;
-        result->contactor = rec->contactor;
+        SP::SiconosCollisionQueryResult result = acquireQueryResult(pool);
+        fillQueryResult(*result, rec, rayResult.m_hitPointWorld, start);
         result_list.push_back(result);
       }
       else
@@ -3041,7 +3815,7 @@ SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
   else
   {
     btCollisionWorld::AllHitsRayResultCallback rayResult(btstart, btend);
-    _impl->_collisionWorld->rayTest(btstart, btend, rayResult);
+    world.rayTest(btstart, btend, rayResult);
 
     if(rayResult.hasHit())
     {
@@ -3053,16 +3827,8 @@ SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
 
         if(rec)
         {
-          SP::SiconosCollisionQueryResult result(
-            std::make_shared<SiconosCollisionQueryResult>());
-          result->point.resize(3);
-          result->point.setValue(0, rayResult.m_hitPointWorld[i].getX());
-          result->point.setValue(1, rayResult.m_hitPointWorld[i].getY());
-          result->point.setValue(2, rayResult.m_hitPointWorld[i].getZ());
-          result->distance = (result->point - start).norm2();
-          result->body = rec->ds; // note: null for static contactors
-          result->shape = rec->sshape;
-          result->contactor = rec->contactor;
+          SP::SiconosCollisionQueryResult result = acquireQueryResult(pool);
+          fillQueryResult(*result, rec, rayResult.m_hitPointWorld[i], start);
           result_list.push_back(result);
         }
         else
@@ -3075,6 +3841,170 @@ SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
 
   if(sorted && result_list.size() > 1)
     std::sort(result_list.begin(), result_list.end(), cmpQueryResult);
+}
+
+std::vector<SP::SiconosCollisionQueryResult>
+SiconosBulletCollisionManager::lineIntersectionQuery(const SiconosVector& start,
+    const SiconosVector& end,
+    bool closestOnly,
+    bool sorted)
+{
+  std::vector<SP::SiconosCollisionQueryResult> result_list;
+  bulletLineQuery(*_impl->_collisionWorld, start, end, closestOnly, sorted,
+                  result_list, nullptr);
+  return result_list;
+}
+
+void
+SiconosBulletCollisionManager::lineIntersectionBulkQuery(
+  const std::vector<SiconosRayQuery>& rays,
+  std::vector<std::vector<SP::SiconosCollisionQueryResult> >& results,
+  SiconosCollisionQueryResultPool* pool,
+  bool closestOnly,
+  bool sorted)
+{
+  results.resize(rays.size());
+
+  /* hand the previous batch's result objects back to the pool before
+   * refilling, so a steady-state batch allocates nothing */
+  if(pool)
+  {
+    for(size_t i = 0; i < results.size(); ++i)
+      pool->release(results[i]);
+  }
+
+  int nrays = (int)rays.size();
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 64) if(nrays > 64)
+#endif
+  for(int i = 0; i < nrays; ++i)
+  {
+    results[i].clear();
+    bulletLineQuery(*_impl->_collisionWorld, rays[i].start, rays[i].end,
+                    closestOnly, sorted, results[i], pool);
+  }
+}
+
+/** Collects the contact points of a sphere contactTest, keeping the
+ *  closest point per intersected collision object (Bullet reports one
+ *  manifold point per contact pair feature). */
+struct SphereQueryCallback : public btCollisionWorld::ContactResultCallback
+{
+  SphereQueryCallback(const btCollisionObject* queryObject_,
+                      const btVector3& center_)
+    : queryObject(queryObject_), center(center_) {}
+
+  const btCollisionObject* queryObject;
+  btVector3 center;
+  std::map<const btCollisionObject*, btVector3> hits;
+
+  btScalar addSingleResult(btManifoldPoint& cp,
+                           const btCollisionObjectWrapper* colObj0Wrap, int, int,
+                           const btCollisionObjectWrapper* colObj1Wrap, int, int)
+  {
+    const btCollisionObject* other;
+    btVector3 point;
+    if(colObj0Wrap->getCollisionObject() == queryObject)
+    {
+      other = colObj1Wrap->getCollisionObject();
+      point = cp.getPositionWorldOnB();
+    }
+    else
+    {
+      other = colObj0Wrap->getCollisionObject();
+      point = cp.getPositionWorldOnA();
+    }
+
+    std::map<const btCollisionObject*, btVector3>::iterator it = hits.find(other);
+    if(it == hits.end()
+        || (point - center).length2() < (it->second - center).length2())
+      hits[other] = point;
+    return 0;
+  }
+};
+
+/** One sphere test against the world, shared by the single and bulk
+ *  query entry points.  Goes through the narrowphase dispatcher, which
+ *  is not reentrant: do not call concurrently. */
+static void bulletSphereQuery(btCollisionWorld& world,
+                              const SiconosVector& center, double radius,
+                              bool closestOnly, bool sorted,
+                              std::vector<SP::SiconosCollisionQueryResult>& result_list,
+                              SiconosCollisionQueryResultPool* pool)
+{
+  btVector3 btcenter(center(0), center(1), center(2));
+  btSphereShape sphere(radius);
+  btCollisionObject obj;
+  obj.setCollisionShape(&sphere);
+  btTransform transform;
+  transform.setIdentity();
+  transform.setOrigin(btcenter);
+  obj.setWorldTransform(transform);
+
+  SphereQueryCallback cb(&obj, btcenter);
+  world.contactTest(&obj, cb);
+
+  for(std::map<const btCollisionObject*, btVector3>::iterator it = cb.hits.begin();
+      it != cb.hits.end(); ++it)
+  {
+    const BodyShapeRecord *rec =
+      reinterpret_cast<const BodyShapeRecord*>(it->first->getUserPointer());
+
+    if(rec)
+    {
+      SP::SiconosCollisionQueryResult result = acquireQueryResult(pool);
+      fillQueryResult(*result, rec, it->second, center);
+      result_list.push_back(result);
+    }
+    else
+    {
+      DEBUG_PRINT("Siconos warning: BodyShapeRecord found by sphere query was null.");
+    }
+  }
+
+  if(closestOnly && result_list.size() > 1)
+  {
+    std::sort(result_list.begin(), result_list.end(), cmpQueryResult);
+    if(pool)
+    {
+      std::vector<SP::SiconosCollisionQueryResult> rest(
+        result_list.begin() + 1, result_list.end());
+      pool->release(rest);
+    }
+    result_list.resize(1);
+  }
+  else if(sorted && result_list.size() > 1)
+    std::sort(result_list.begin(), result_list.end(), cmpQueryResult);
+}
 
+std::vector<SP::SiconosCollisionQueryResult>
+SiconosBulletCollisionManager::inSphereQuery(const SiconosVector& center,
+    double radius,
+    bool closestOnly,
+    bool sorted)
+{
+  std::vector<SP::SiconosCollisionQueryResult> result_list;
+  bulletSphereQuery(*_impl->_collisionWorld, center, radius, closestOnly, sorted,
+                    result_list, nullptr);
   return result_list;
 }
+
+void
+SiconosBulletCollisionManager::inSphereBulkQuery(
+  const std::vector<SiconosSphereQuery>& spheres,
+  std::vector<std::vector<SP::SiconosCollisionQueryResult> >& results,
+  SiconosCollisionQueryResultPool* pool,
+  bool closestOnly,
+  bool sorted)
+{
+  results.resize(spheres.size());
+  for(size_t i = 0; i < spheres.size(); ++i)
+  {
+    if(pool)
+      pool->release(results[i]);
+    else
+      results[i].clear();
+    bulletSphereQuery(*_impl->_collisionWorld, spheres[i].center,
+                      spheres[i].radius, closestOnly, sorted, results[i], pool);
+  }
+}
@@ -62,6 +62,7 @@ public:
   bool enableSatConvex;
   bool enablePolyhedralContactClipping;
   double Depth2D;
+  bool temporalCoherenceGating;
 };
 
 struct SiconosBulletStatistics
@@ -73,14 +74,20 @@ protected:
 public:
   SiconosBulletStatistics()
     : new_interactions_created(0)
+    , interactions_recycled(0)
+    , interactions_warm_started(0)
     , existing_interactions_processed(0)
     , interaction_warnings(0)
     , interaction_destroyed(0)
+    , broadphase_skipped(0)
     {}
   int new_interactions_created;
+  int interactions_recycled;
+  int interactions_warm_started;
   int existing_interactions_processed;
   int interaction_warnings;
   int interaction_destroyed;
+  int broadphase_skipped;
 };
 
 class SiconosBulletCollisionManager : public SiconosCollisionManager
@@ -102,6 +109,50 @@ protected:
                                          const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1);
   static Simulation *gSimulation;
 
+  // the active manager, so that the static removal callback can recycle
+  // the interactions of vanished contacts into _interaction_pool
+  static SiconosBulletCollisionManager *gManager;
+
+  /** world contact position and last reaction of a contact whose manifold
+   *  point was destroyed during the current collision-detection pass.
+   *  When Bullet drops a point and immediately re-adds one at (nearly)
+   *  the same place, the contact is physically persistent: the matching
+   *  record seeds the lambda of the re-created interaction so that the
+   *  OSNS warm start does not restart from zero. */
+  struct VanishedContactRecord
+  {
+    double pos[3];
+    std::vector<SP::SiconosVector> lambdas;
+  };
+
+  /** reactions of the contacts destroyed by the last detection pass;
+   *  filled by bulletContactClear, matched against the new contact points
+   *  of the same pass in updateInteractions */
+  std::vector<VanishedContactRecord> _vanished_contacts;
+
+  /** when true (speculative detection in flight), bulletContactClear
+   *  stages the interactions of vanished contacts in _staged_unlinks
+   *  instead of unlinking them from the simulation */
+  bool _stage_unlinks = false;
+
+  /** interactions whose contact point vanished during a speculative
+   *  detection pass; unlinked at the start of commitInteractions */
+  std::vector<SP::Interaction> _staged_unlinks;
+
+  /** true between a detectInteractions call and its commit */
+  bool _detection_pending = false;
+
+  /** collision detection part of updateInteractions: transform sync,
+   *  broadphase and narrowphase; touches only the collision world (and,
+   *  through the contact-destroyed callback, the simulation unless
+   *  _stage_unlinks is set) */
+  void performDetectionPass(SP::Simulation simulation);
+
+  /** contact classification part of updateInteractions: walks the
+   *  manifolds of the last detection pass, updates the persistent
+   *  relations and links the new interactions into the topology */
+  void applyDetectionPass(SP::Simulation simulation);
+
 public:
   SiconosBulletCollisionManager();
   SiconosBulletCollisionManager(const SiconosBulletOptions &options);
@@ -155,10 +206,44 @@ public:
 
   void updateInteractions(SP::Simulation simulation);
 
+  /** The detection/commit split of InteractionManager: detectInteractions
+   *  runs the transform sync, the broadphase and the narrowphase -- the
+   *  expensive part of updateInteractions -- and may do so on a worker
+   *  thread while the one-step nonsmooth problem is solved.  Interactions
+   *  whose contact point vanishes during such a pass are staged instead of
+   *  being unlinked, and commitInteractions applies them together with the
+   *  contact classification on the simulation thread. */
+  virtual bool supportsSpeculativeUpdateInteractions() const { return true; }
+
+  void detectInteractions(SP::Simulation simulation);
+
+  void commitInteractions(SP::Simulation simulation);
+
   std::vector<SP::SiconosCollisionQueryResult>
   lineIntersectionQuery(const SiconosVector& start, const SiconosVector& end,
                         bool closestOnly=false, bool sorted=true);
 
+  std::vector<SP::SiconosCollisionQueryResult>
+  inSphereQuery(const SiconosVector& center, double radius,
+                bool closestOnly=false, bool sorted=true);
+
+  /** Bulk version of lineIntersectionQuery().  Bullet ray tests only
+   *  read the collision world, so the rays are processed in parallel;
+   *  result objects are recycled through the pool when one is given. */
+  void lineIntersectionBulkQuery(const std::vector<SiconosRayQuery>& rays,
+                                 std::vector<std::vector<SP::SiconosCollisionQueryResult> >& results,
+                                 SiconosCollisionQueryResultPool* pool = nullptr,
+                                 bool closestOnly=false, bool sorted=true);
+
+  /** Bulk version of inSphereQuery().  Sphere tests go through the
+   *  narrowphase dispatcher, which is not reentrant, so the batch is
+   *  processed serially; the pool still removes the per-hit
+   *  allocations. */
+  void inSphereBulkQuery(const std::vector<SiconosSphereQuery>& spheres,
+                         std::vector<std::vector<SP::SiconosCollisionQueryResult> >& results,
+                         SiconosCollisionQueryResultPool* pool = nullptr,
+                         bool closestOnly=false, bool sorted=true);
+
   void clearOverlappingPairCache();
 
   const SiconosBulletOptions &options() const { return _options; }
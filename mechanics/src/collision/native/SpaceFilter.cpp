@@ -62,6 +62,7 @@ SpaceFilter::SpaceFilter(unsigned int bboxfactor,
   _plans(plans),
   _moving_plans(moving_plans),
   _hash_table(new space_hash()),
+  _body_cells(new body_cells()),
   diskdisk_relations(new DiskDiskRDeclaredPool()),
   diskplan_relations(new DiskPlanRDeclaredPool()),
   circlecircle_relations(new CircleCircleRDeclaredPool())
@@ -74,6 +75,7 @@ SpaceFilter::SpaceFilter(unsigned int bboxfactor,
   _cellsize(cellsize),
   _plans(plans),
   _hash_table(new space_hash()),
+  _body_cells(new body_cells()),
   diskdisk_relations(new DiskDiskRDeclaredPool()),
   diskplan_relations(new DiskPlanRDeclaredPool()),
   circlecircle_relations(new CircleCircleRDeclaredPool())
@@ -81,6 +83,7 @@ SpaceFilter::SpaceFilter(unsigned int bboxfactor,
 
 SpaceFilter::SpaceFilter() :
   _hash_table(new space_hash()),
+  _body_cells(new body_cells()),
   diskdisk_relations(new DiskDiskRDeclaredPool()),
   diskplan_relations(new DiskPlanRDeclaredPool()),
   circlecircle_relations(new CircleCircleRDeclaredPool())
@@ -99,7 +102,7 @@ public:
 
   void visit(SP::Disk pds)
   {
-    int i, j, imin, imax, jmin, jmax;
+    int imin, imax, jmin, jmax;
     unsigned int _bboxfactor = parent.bboxfactor();
     unsigned int _cellsize = parent.cellsize();
 
@@ -109,18 +112,13 @@ public:
     jmin = (int) floor((pds->getQ(1) - _bboxfactor * pds->getRadius()) / _cellsize);
     jmax = (int) floor((pds->getQ(1) + _bboxfactor * pds->getRadius()) / _cellsize);
 
-    for(i = imin; i <= imax; ++i)
-    {
-      for(j = jmin; j <= jmax; ++j)
-      {
-        parent.insert(pds, i, j, 0);
-      }
-    }
+    parent.updateCells(std::static_pointer_cast<DynamicalSystem>(pds),
+                       imin, imax, jmin, jmax, 0, 0);
   };
 
   void visit(SP::Circle pds)
   {
-    int i, j, imin, imax, jmin, jmax;
+    int imin, imax, jmin, jmax;
 
     unsigned int _bboxfactor = parent.bboxfactor();
     unsigned int _cellsize = parent.cellsize();
@@ -131,18 +129,13 @@ public:
     jmin = (int) floor((pds->getQ(1) - _bboxfactor * pds->getRadius()) / _cellsize);
     jmax = (int) floor((pds->getQ(1) + _bboxfactor * pds->getRadius()) / _cellsize);
 
-    for(i = imin; i <= imax; ++i)
-    {
-      for(j = jmin; j <= jmax; ++j)
-      {
-        parent.insert(pds, i, j, 0);
-      }
-    }
+    parent.updateCells(std::static_pointer_cast<DynamicalSystem>(pds),
+                       imin, imax, jmin, jmax, 0, 0);
   }
 
   void visit(SP::SphereLDS pds)
   {
-    int i, j, k, imin, imax, jmin, jmax, kmin, kmax;
+    int imin, imax, jmin, jmax, kmin, kmax;
 
     unsigned int _bboxfactor = parent.bboxfactor();
     unsigned int _cellsize = parent.cellsize();
@@ -156,22 +149,12 @@ public:
     kmin = (int) floor((pds->getQ(2) - _bboxfactor * pds->getRadius()) / _cellsize);
     kmax = (int) floor((pds->getQ(2) + _bboxfactor * pds->getRadius()) / _cellsize);
 
-    for(i = imin; i <= imax; ++i)
-    {
-      for(j = jmin; j <= jmax; ++j)
-      {
-        for(k = kmin; k <= kmax; ++k)
-        {
-          parent.insert(pds, i, j, k);
-        }
-      }
-    }
-
+    parent.updateCells(pds, imin, imax, jmin, jmax, kmin, kmax);
   }
 
   void visit(SP::SphereNEDS pds)
   {
-    int i, j, k, imin, imax, jmin, jmax, kmin, kmax;
+    int imin, imax, jmin, jmax, kmin, kmax;
 
     unsigned int _bboxfactor = parent.bboxfactor();
     unsigned int _cellsize = parent.cellsize();
@@ -185,21 +168,14 @@ public:
     kmin = (int) floor((pds->getQ(2) - _bboxfactor * pds->getRadius()) / _cellsize);
     kmax = (int) floor((pds->getQ(2) + _bboxfactor * pds->getRadius()) / _cellsize);
 
-    for(i = imin; i <= imax; ++i)
-    {
-      for(j = jmin; j <= jmax; ++j)
-      {
-        for(k = kmin; k <= kmax; ++k)
-        {
-          parent.insert(pds, i, j, k);
-        }
-      }
-    }
-
+    parent.updateCells(pds, imin, imax, jmin, jmax, kmin, kmax);
   }
 
   void visit(SP::ExternalBody d)
   {
+    /* external bodies hash themselves and offer no cell-bounds test:
+       drop the previous memberships and let them re-insert */
+    parent.removeCells(d);
     d->selfHash(parent);
   }
 
@@ -209,155 +185,6 @@ public:
 
 
 
-/* proximity detection for circular object */
-struct SpaceFilter::_CircularFilter : public SiconosVisitor
-{
-  using SiconosVisitor::visit;
-
-  SP::Simulation sim;
-  SP::SpaceFilter parent;
-  SP::CircularDS ds1;
-
-  _CircularFilter(SP::Simulation s, SP::SpaceFilter parent, SP::CircularDS ds1)
-    : sim(s), parent(parent), ds1(ds1) {};
-
-  void visit_circular(SP::CircularDS ds2)
-  {
-
-    SP::CircularR rel;
-    SP::DynamicalSystemsGraph DSG0 =
-      sim->nonSmoothDynamicalSystem()->topology()->dSG(0);
-
-    assert(ds1 != ds2);
-    assert(DSG0->bundle(DSG0->descriptor(ds1)) == ds1);
-    assert(DSG0->bundle(DSG0->descriptor(ds2)) == ds2);
-
-    double r1 = ds1->getRadius();
-    double r2 = ds2->getRadius();
-    double tol = r1 + r2;
-
-    double x1 = ds1->getQ(0);
-    double y1 = ds1->getQ(1);
-    double x2 = ds2->getQ(0);
-    double y2 = ds2->getQ(1);
-    double rmax = fmax(r1, r2);
-    double rmin = fmin(r1, r2);
-
-    double d = hypot(x1 - x2, y1 - y2);
-
-    if(d < rmax)
-    {
-      // one inside the other : CircleCircle relation
-      if(rmax - (d + rmin) < tol)
-      {
-        CircleCircleRDeclaredPool::iterator rcandid =
-          parent->circlecircle_relations->find(CircleCircleRDeclared(r1, r2));
-        if(rcandid == parent->circlecircle_relations->end())
-        {
-          // a new relation
-          rel.reset(new CircleCircleR(r1, r2));
-          // FIX : this could work with stateless relations.
-          // This is not the case: cf LagrangianR.
-          //(*(parent->circlecircle_relations))[CircleCircleRDeclared(r1, r2)] = rel;
-        }
-        else
-        {
-          // get relation from pool
-          rel = (*rcandid).second;
-        }
-      }
-    }
-    else
-    {
-      // a DiskDisk relation
-      if(d - (r1 + r2) < tol)
-      {
-        DiskDiskRDeclaredPool::iterator rcandid =
-          parent->diskdisk_relations->find(DiskDiskRDeclared(r1, r2));
-        if(rcandid == parent->diskdisk_relations->end())
-        {
-          // a new relation
-          rel.reset(new DiskDiskR(r1, r2));
-
-          // FIX : this could work with stateless relations.
-          // This is not the case cf LagrangianR:
-          // parent->diskdisk_relations[DiskDiskRDeclared(r1,r2)] = rel;
-        }
-        else
-        {
-          // get relation from pool
-          rel = (*rcandid).second;
-        }
-      }
-    }
-
-    if(rel)
-    {
-      bool found = false;
-      DynamicalSystemsGraph::OEIterator oei, oeiend;
-      for(std::tie(oei, oeiend) = DSG0->out_edges(DSG0->descriptor(ds1));
-          oei != oeiend; ++oei)
-      {
-        if(DSG0->bundle(DSG0->target(*oei)) == ds2)
-        {
-          found = true;
-          break;
-        }
-      }
-
-      if(!found)
-      {
-        SP::NonSmoothLaw nslaw =
-          parent->nonSmoothLaw(DSG0->groupId[DSG0->descriptor(ds1)],
-                               DSG0->groupId[DSG0->descriptor(ds2)]);
-        assert(nslaw);
-
-        SP::Interaction inter(new Interaction(nslaw, rel));
-        sim->nonSmoothDynamicalSystem()->link(inter, ds1, ds2);
-      }
-    }
-    else
-    {
-      // is interaction in graph ?
-      bool found = false;
-      DynamicalSystemsGraph::OEIterator oei, oeiend;
-      for(std::tie(oei, oeiend) = DSG0->out_edges(DSG0->descriptor(ds1));
-          oei != oeiend; ++oei)
-      {
-        if(DSG0->bundle(DSG0->target(*oei)) == ds2)
-        {
-          found = true;
-          break;
-        }
-      }
-
-      if(found)
-      {
-
-
-        DEBUG_PRINTF("remove interaction : %d\n", DSG0->bundle(*oei)->number());
-        sim->unlink(DSG0->bundle(*oei));
-      }
-    }
-  }
-
-  void visit(SP::Disk disk)
-  {
-    visit_circular(disk);
-  }
-
-  void visit(SP::Circle circle)
-  {
-    visit_circular(circle);
-  }
-
-  // do nothing (everything must be done in ExternalBody.findInteractions)
-  void visit(SP::ExternalBody)
-  {}
-
-
-};
-
 /* proximity detection for sphere objects */
 struct SpaceFilter::_SphereLDSFilter : public SiconosVisitor
 {
@@ -954,38 +781,118 @@ void SpaceFilter::_PlanSphereNEDSFilter(SP::Simulation sim,
 }
 
 
+/* remove one table entry by identity: the SP::Hashed equality used by
+   the table only compares the cell coordinates */
+static void eraseOneHashed(space_hash& table, SP::Hashed const& h)
+{
+  std::pair<space_hash::iterator, space_hash::iterator> range =
+    table.equal_range(h);
+  for(; range.first != range.second; ++range.first)
+  {
+    if(range.first->get() == h.get())
+    {
+      table.erase(range.first);
+      break;
+    }
+  }
+}
+
 /* insertion */
 void SpaceFilter::insert(SP::Disk ds, int i, int j, int k)
 {
 
   SP::Hashed hashed(new Hashed(std::static_pointer_cast<DynamicalSystem>(ds), i, j));
-  _hash_table->insert(hashed);
+  insert(hashed);
 }
 
 void SpaceFilter::insert(SP::Circle ds, int i, int j, int k)
 {
 
   SP::Hashed hashed(new Hashed(std::static_pointer_cast<DynamicalSystem>(ds), i, j));
-  _hash_table->insert(hashed);
+  insert(hashed);
 }
 
 void SpaceFilter::insert(SP::SphereLDS ds, int i, int j, int k)
 {
 
   SP::Hashed hashed(new Hashed(ds, i, j, k));
-  _hash_table->insert(hashed);
+  insert(hashed);
 }
 
 void SpaceFilter::insert(SP::SphereNEDS ds, int i, int j, int k)
 {
 
   SP::Hashed hashed(new Hashed(ds, i, j, k));
-  _hash_table->insert(hashed);
+  insert(hashed);
 }
 
 void SpaceFilter::insert(SP::Hashed hashed)
 {
   _hash_table->insert(hashed);
+  if(hashed->body)
+  {
+    /* record the membership so the entry can be removed later; the
+       bounds stay unknown, forcing a re-hash on the next pass */
+    BodyCells& rec = (*_body_cells)[&*hashed->body];
+    rec.pass = _hashPass;
+    rec.imin = 0;
+    rec.imax = -1;
+    rec.cells.push_back(hashed);
+  }
+}
+
+bool SpaceFilter::updateCells(SP::DynamicalSystem body,
+                              int imin, int imax, int jmin, int jmax,
+                              int kmin, int kmax)
+{
+  BodyCells& rec = (*_body_cells)[&*body];
+  rec.pass = _hashPass;
+
+  if(rec.sameCells(imin, imax, jmin, jmax, kmin, kmax))
+  {
+    /* the bounding box did not cross a cell boundary: the table
+       entries of the body are still valid */
+    return false;
+  }
+
+  for(std::vector<SP::Hashed>::iterator it = rec.cells.begin();
+      it != rec.cells.end(); ++it)
+  {
+    eraseOneHashed(*_hash_table, *it);
+  }
+  rec.cells.clear();
+
+  for(int i = imin; i <= imax; ++i)
+  {
+    for(int j = jmin; j <= jmax; ++j)
+    {
+      for(int k = kmin; k <= kmax; ++k)
+      {
+        SP::Hashed hashed(new Hashed(body, i, j, k));
+        _hash_table->insert(hashed);
+        rec.cells.push_back(hashed);
+      }
+    }
+  }
+  rec.imin = imin;
+  rec.imax = imax;
+  rec.jmin = jmin;
+  rec.jmax = jmax;
+  rec.kmin = kmin;
+  rec.kmax = kmax;
+  return true;
+}
+
+void SpaceFilter::removeCells(SP::DynamicalSystem body)
+{
+  body_cells::iterator it = _body_cells->find(&*body);
+  if(it == _body_cells->end()) return;
+  for(std::vector<SP::Hashed>::iterator hit = it->second.cells.begin();
+      hit != it->second.cells.end(); ++hit)
+  {
+    eraseOneHashed(*_hash_table, *hit);
+  }
+  _body_cells->erase(it);
 }
 
 /* insert other objects */
@@ -1030,78 +937,17 @@ struct SpaceFilter::_FindInteractions : public SiconosVisitor
   SP::Simulation sim;
   SP::SpaceFilter parent;
   double time;
+
+  /* circular bodies are only collected here and handled all at once by
+     _batchCircularNarrowphase after the pass */
+  std::vector<SP::CircularDS> circulars;
+
   _FindInteractions(SP::Simulation s, SP::SpaceFilter p, double time)
     : sim(s), parent(p), time(time) {};
 
   void visit_circular(SP::CircularDS  ds1)
   {
-    assert(parent->_plans->size(0) > 0);
-
-    // interactions with plans
-
-    if(parent->_plans)
-    {
-      for(unsigned int i = 0; i < parent->_plans->size(0); ++i)
-      {
-        parent->_PlanCircularFilter(sim,
-                                    (*parent->_plans)(i, 0),
-                                    (*parent->_plans)(i, 1),
-                                    (*parent->_plans)(i, 2),
-                                    (*parent->_plans)(i, 3),
-                                    (*parent->_plans)(i, 4),
-                                    (*parent->_plans)(i, 5),
-                                    ds1);
-      }
-    }
-
-    if(parent->_moving_plans)
-    {
-      for(unsigned int i = 0; i < parent->_moving_plans->size1(); ++i)
-      {
-        parent->_MovingPlanCircularFilter(sim, i, ds1, time);
-      }
-    }
-
-    SP::SiconosVector Q1 = ds1->q();
-
-    double x1 = Q1->getValue(0);
-    double y1 = Q1->getValue(1);
-    SP::Hashed hds1(new Hashed(std::static_pointer_cast<DynamicalSystem>(ds1),
-                               (int) floor(x1 / parent->_cellsize),
-                               (int) floor(y1 / parent->_cellsize)));
-
-    // find all other systems that are in the same cells
-    std::pair<space_hash::iterator, space_hash::iterator>
-    neighbours = parent->_hash_table->equal_range(hds1);
-
-    unsigned int j;
-    interPairs declaredInteractions;
-    std::shared_ptr<_CircularFilter>
-    circularFilter(new _CircularFilter(sim, parent, ds1));
-
-    for(j = 0; neighbours.first != neighbours.second; ++neighbours.first, ++j)
-    {
-      SP::DynamicalSystem ds2 = (*neighbours.first)->body;
-      int ids1 = ds1->number();
-      int ids2 = ds2->number();
-      int imax = (std::max)(ids1, ids2);
-      int imin = (std::min)(ids1, ids2);
-      if(ids1 != ids2)
-      {
-        // is interaction already treated ?
-        interPair interpair;
-        interpair = std::pair<int, int>(imin, imax);
-
-        if(declaredInteractions.find(interpair)
-            == declaredInteractions.end())
-        {
-          // no, check proximity
-          declaredInteractions.insert(interpair);
-          ds2->acceptSP(circularFilter);
-        }
-
-      }
-    }
+    circulars.push_back(ds1);
   };
 
   void visit(SP::Circle circle)
@@ -1237,6 +1083,162 @@ struct SpaceFilter::_FindInteractions : public SiconosVisitor
 };
 
 
+/* flat narrowphase over all circular bodies; see SpaceFilter.hpp */
+void SpaceFilter::_batchCircularNarrowphase(SP::Simulation sim, double time,
+                                            const std::vector<SP::CircularDS>& bodies)
+{
+  size_t nb = bodies.size();
+  if(nb == 0) return;
+
+  SP::DynamicalSystemsGraph DSG0 =
+    sim->nonSmoothDynamicalSystem()->topology()->dSG(0);
+
+  // interactions with plans, per body as before
+  for(size_t i = 0; i < nb; ++i)
+  {
+    if(_plans)
+    {
+      for(unsigned int p = 0; p < _plans->size(0); ++p)
+        _PlanCircularFilter(sim,
+                            (*_plans)(p, 0), (*_plans)(p, 1), (*_plans)(p, 2),
+                            (*_plans)(p, 3), (*_plans)(p, 4), (*_plans)(p, 5),
+                            bodies[i]);
+    }
+    if(_moving_plans)
+    {
+      for(unsigned int p = 0; p < _moving_plans->size1(); ++p)
+        _MovingPlanCircularFilter(sim, p, bodies[i], time);
+    }
+  }
+
+  // pack positions and radii
+  std::vector<double> x(nb), y(nb), r(nb);
+  std::map<DynamicalSystem*, size_t> index;
+  for(size_t i = 0; i < nb; ++i)
+  {
+    x[i] = bodies[i]->getQ(0);
+    y[i] = bodies[i]->getQ(1);
+    r[i] = bodies[i]->getRadius();
+    index[&*bodies[i]] = i;
+  }
+
+  // candidate pairs from the hash table, deduplicated over the whole batch
+  typedef std::pair<size_t, size_t> candPair;
+  boost::unordered_set<candPair, boost::hash<candPair> > declared;
+  std::vector<candPair> candidates;
+  for(size_t i = 0; i < nb; ++i)
+  {
+    SP::Hashed hds1(new Hashed(std::static_pointer_cast<DynamicalSystem>(bodies[i]),
+                               (int) floor(x[i] / _cellsize),
+                               (int) floor(y[i] / _cellsize)));
+    std::pair<space_hash::iterator, space_hash::iterator>
+    neighbours = _hash_table->equal_range(hds1);
+    for(; neighbours.first != neighbours.second; ++neighbours.first)
+    {
+      std::map<DynamicalSystem*, size_t>::iterator
+      it2 = index.find(&*(*neighbours.first)->body);
+      if(it2 == index.end() || it2->second == i) continue;
+      candPair pr((std::min)(i, it2->second), (std::max)(i, it2->second));
+      if(declared.insert(pr).second)
+        candidates.push_back(pr);
+    }
+  }
+
+  // flat distance evaluation over the packed arrays
+  size_t nc = candidates.size();
+  std::vector<double> dist(nc);
+  std::vector<unsigned char> close(nc);
+  for(size_t k = 0; k < nc; ++k)
+  {
+    size_t i = candidates[k].first;
+    size_t j = candidates[k].second;
+    double d = hypot(x[i] - x[j], y[i] - y[j]);
+    double r1 = r[i];
+    double r2 = r[j];
+    double tol = r1 + r2;
+    dist[k] = d;
+    if(d < fmax(r1, r2))
+      // one inside the other
+      close[k] = (fmax(r1, r2) - (d + fmin(r1, r2)) < tol);
+    else
+      close[k] = (d - (r1 + r2) < tol);
+  }
+
+  // only the selected pairs reach the graph and relation machinery
+  for(size_t k = 0; k < nc; ++k)
+  {
+    SP::CircularDS ds1 = bodies[candidates[k].first];
+    SP::CircularDS ds2 = bodies[candidates[k].second];
+
+    // existing interaction between the two bodies ?
+    SP::Interaction inter;
+    DynamicalSystemsGraph::OEIterator oei, oeiend;
+    for(std::tie(oei, oeiend) = DSG0->out_edges(DSG0->descriptor(ds1));
+        oei != oeiend; ++oei)
+    {
+      if(DSG0->bundle(DSG0->target(*oei)) == ds2)
+      {
+        inter = DSG0->bundle(*oei);
+        break;
+      }
+    }
+
+    if(close[k] && !inter)
+    {
+      double r1 = ds1->getRadius();
+      double r2 = ds2->getRadius();
+      SP::CircularR rel;
+      if(dist[k] < fmax(r1, r2))
+      {
+        // one inside the other : CircleCircle relation
+        CircleCircleRDeclaredPool::iterator rcandid =
+          circlecircle_relations->find(CircleCircleRDeclared(r1, r2));
+        if(rcandid == circlecircle_relations->end())
+        {
+          // a new relation
+          // FIX : this could work with stateless relations.
+          // This is not the case: cf LagrangianR.
+          rel.reset(new CircleCircleR(r1, r2));
+        }
+        else
+        {
+          // get relation from pool
+          rel = (*rcandid).second;
+        }
+      }
+      else
+      {
+        // a DiskDisk relation
+        DiskDiskRDeclaredPool::iterator rcandid =
+          diskdisk_relations->find(DiskDiskRDeclared(r1, r2));
+        if(rcandid == diskdisk_relations->end())
+        {
+          // a new relation
+          rel.reset(new DiskDiskR(r1, r2));
+        }
+        else
+        {
+          // get relation from pool
+          rel = (*rcandid).second;
+        }
+      }
+
+      SP::NonSmoothLaw nslaw =
+        nonSmoothLaw(DSG0->groupId[DSG0->descriptor(ds1)],
+                     DSG0->groupId[DSG0->descriptor(ds2)]);
+      assert(nslaw);
+
+      SP::Interaction newInter(new Interaction(nslaw, rel));
+      sim->nonSmoothDynamicalSystem()->link(newInter, ds1, ds2);
+    }
+    else if(!close[k] && inter)
+    {
+      DEBUG_PRINTF("remove interaction : %d\n", inter->number());
+      sim->unlink(inter);
+    }
+  }
+}
+
 /* general proximity detection */
 void SpaceFilter::updateInteractions(SP::Simulation sim)
 {
@@ -1250,9 +1252,10 @@ void SpaceFilter::updateInteractions(SP::Simulation sim)
   std::shared_ptr<_FindInteractions>
   findInteractions(new _FindInteractions(sim, shared_from_this(), time));
 
-  _hash_table->clear();
+  ++_hashPass;
 
-  // 1: rehash DS
+  // 1: rehash the DS whose bounding box crossed a cell boundary; the
+  // memberships of the others persist from the previous call
   DynamicalSystemsGraph::VIterator vi, viend;
   for(std::tie(vi, viend) = DSG0->vertices();
       vi != viend; ++vi)
@@ -1261,12 +1264,33 @@ void SpaceFilter::updateInteractions(SP::Simulation sim)
     DSG0->bundle(*vi)->acceptSP(hasher);
   }
 
+  // drop the entries of bodies that left the graph
+  for(body_cells::iterator it = _body_cells->begin();
+      it != _body_cells->end();)
+  {
+    if(it->second.pass != _hashPass)
+    {
+      for(std::vector<SP::Hashed>::iterator hit = it->second.cells.begin();
+          hit != it->second.cells.end(); ++hit)
+      {
+        eraseOneHashed(*_hash_table, *hit);
+      }
+      it = _body_cells->erase(it);
+    }
+    else
+      ++it;
+  }
+
   // 2: prox detection
   for(std::tie(vi, viend) = DSG0->vertices();
       vi != viend; ++vi)
   {
     DSG0->bundle(*vi)->acceptSP(findInteractions);
   }
+
+  // 3: the circular bodies were only collected above: run the flat
+  // narrowphase over all of them at once
+  _batchCircularNarrowphase(sim, time, findInteractions->circulars);
   //model()->simulation()->initOSNS();
 }
 
@@ -43,6 +43,7 @@
 
 /* local forwards (see SpaceFilter_impl.hpp) */
 DEFINE_SPTR(space_hash);
+DEFINE_SPTR(body_cells);
 DEFINE_SPTR(DiskDiskRDeclaredPool);
 DEFINE_SPTR(DiskPlanRDeclaredPool);
 DEFINE_SPTR(CircleCircleRDeclaredPool);
@@ -71,6 +72,12 @@ protected:
   /* the hash table */
   SP::space_hash _hash_table;
 
+  /* persistent cell memberships, one record per hashed body */
+  SP::body_cells _body_cells;
+
+  /* current hash pass, bumped by updateInteractions */
+  unsigned int _hashPass = 0;
+
   /* relations pool */
   SP::DiskDiskRDeclaredPool diskdisk_relations;
   SP::DiskPlanRDeclaredPool diskplan_relations;
@@ -83,6 +90,14 @@ protected:
   void _MovingPlanCircularFilter(SP::Simulation, unsigned int i,
                                  SP::CircularDS ds, double time);
 
+  /** flat narrowphase over all the circular bodies collected by the
+      current proximity detection pass: positions and radii are packed
+      into arrays, the candidate pairs coming from the hash table are
+      evaluated in one loop and only the pairs close to contact (or the
+      linked pairs that separated) reach the per-pair machinery */
+  void _batchCircularNarrowphase(SP::Simulation sim, double time,
+                                 const std::vector<SP::CircularDS>& bodies);
+
   void _PlanSphereLDSFilter(SP::Simulation, double A, double B, double C,
                             double D, SP::SphereLDS ds);
 
@@ -93,7 +108,6 @@ protected:
   /* note : cf Thinking in C++, vol2, the inner class idiom. */
 
   /* each kind of proximity detection */
-  struct _CircularFilter;
   struct _SphereLDSFilter;
   struct _SphereNEDSFilter;
 
@@ -111,7 +125,6 @@ protected:
   /* to compute distance */
   struct _DiskDistance;
 
-  friend struct SpaceFilter::_CircularFilter;
   friend struct SpaceFilter::_SphereLDSFilter;
   friend struct SpaceFilter::_SphereNEDSFilter;
   friend struct SpaceFilter::_BodyHash;
@@ -145,6 +158,19 @@ public:
    */
   void insert(SP::Hashed);
 
+  /** Re-insert a body whose cell bounds changed since the last pass;
+   *  bodies still covering the same cells keep their table entries.
+   *
+   *  \return true when the body was (re-)hashed
+   */
+  bool updateCells(SP::DynamicalSystem body,
+                   int imin, int imax, int jmin, int jmax,
+                   int kmin, int kmax);
+
+  /** Remove the recorded cell memberships of a body.
+   */
+  void removeCells(SP::DynamicalSystem body);
+
   /** get parameters
    */
 
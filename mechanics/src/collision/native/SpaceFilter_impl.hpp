@@ -24,6 +24,7 @@
 #define SpaceFilter_impl_hpp
 
 #include <map>
+#include <vector>
 
 #include <NSLawMatrix.hpp>
 #include <SpaceFilter.hpp>
@@ -68,6 +69,43 @@ class space_hash : public boost::unordered_multiset < SP::Hashed,
   ACCEPT_SERIALIZATION(space_hash);
 };
 
+/* the cell memberships of one body, kept between two broadphase passes
+   so that only bodies whose bounding box crossed a cell boundary get
+   re-inserted in the hash table */
+class BodyCells
+{
+public:
+
+  ACCEPT_SERIALIZATION(BodyCells);
+
+  /* cell bounds at the last insertion; imax < imin means unknown */
+  int imin = 0;
+  int imax = -1;
+  int jmin = 0;
+  int jmax = -1;
+  int kmin = 0;
+  int kmax = -1;
+
+  /* hash pass that last visited the body (to detect removed bodies) */
+  unsigned int pass = 0;
+
+  /* the entries inserted in the hash table */
+  std::vector<SP::Hashed> cells;
+
+  bool sameCells(int i0, int i1, int j0, int j1, int k0, int k1) const
+  {
+    return !cells.empty() &&
+           imin == i0 && imax == i1 &&
+           jmin == j0 && jmax == j1 &&
+           kmin == k0 && kmax == k1;
+  }
+};
+
+class body_cells : public std::map<DynamicalSystem*, BodyCells>
+{
+  ACCEPT_SERIALIZATION(body_cells);
+};
+
 /* relations pool */
 typedef std::pair<double, double> CircleCircleRDeclared;
 typedef std::pair<double, double> DiskDiskRDeclared;
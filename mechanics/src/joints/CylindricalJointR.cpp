@@ -233,6 +233,8 @@ void CylindricalJointR::computeV1V2FromAxis()
 
 void CylindricalJointR::computeJachq(double time, Interaction& inter,  SP::BlockVector q0)
 {
+  if(jachqCacheUpToDate(*q0)) return;
+
   SP::SiconosVector q1 = (q0->getAllVect())[0];
   double X1 = q1->getValue(0);
   double Y1 = q1->getValue(1);
@@ -256,6 +258,7 @@ void CylindricalJointR::computeJachq(double time, Interaction& inter,  SP::Block
   }
   else
     Jd1(X1, Y1, Z1, q10, q11, q12, q13);
+  jachqCacheStore(*q0);
 }
 
 void CylindricalJointR::computeh(double time, const BlockVector& q0, SiconosVector& y)
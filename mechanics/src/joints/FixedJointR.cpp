@@ -153,6 +153,8 @@ void FixedJointR::computeh(double time, const BlockVector& q0, SiconosVector& y)
 
 void FixedJointR::computeJachq(double time, Interaction& inter, SP::BlockVector q0)
 {
+  if(jachqCacheUpToDate(*q0)) return;
+
   _jachq->zero();
 
   SP::SiconosVector q1 = (q0->getAllVect())[0];
@@ -186,6 +188,7 @@ void FixedJointR::computeJachq(double time, Interaction& inter, SP::BlockVector
   }
   else
     Jd1(X1, Y1, Z1, q10, q11, q12, q13);
+  jachqCacheStore(*q0);
 }
 
 void FixedJointR::Jd1d2(double X1, double Y1, double Z1,
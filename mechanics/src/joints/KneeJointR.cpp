@@ -386,6 +386,8 @@ void KneeJointR::computeJachq(double time, Interaction& inter, SP::BlockVector q
 {
   DEBUG_BEGIN("KneeJointR::computeJachq(double time, Interaction& inter,  SP::BlockVector q0) \n");
 
+  if(jachqCacheUpToDate(*q0)) return;
+
   _jachq->zero();
   SP::SiconosVector q1 = (q0->getAllVect())[0];
 
@@ -419,6 +421,7 @@ void KneeJointR::computeJachq(double time, Interaction& inter, SP::BlockVector q
   }
   else
     Jd1(X1, Y1, Z1, q10, q11, q12, q13);
+  jachqCacheStore(*q0);
   DEBUG_END("KneeJointR::computeJachq(double time, Interaction& inter,  SP::BlockVector q0 ) \n");
 
 }
@@ -23,6 +23,44 @@
 #include "BlockVector.hpp"
 #include "NewtonEulerJointR.hpp"
 
+#include <cmath> // for fabs
+
+bool NewtonEulerJointR::jachqCacheUpToDate(const BlockVector& q0) const
+{
+  if(_jachqCacheTol <= 0. || _jachqCacheConfig.empty())
+    return false;
+
+  if(_jachqCacheConfig.size() != q0.size())
+    return false;
+
+  std::size_t k = 0;
+  for(unsigned int b = 0; b < q0.numberOfBlocks(); ++b)
+  {
+    const SiconosVector& q = *(q0.getAllVect()[b]);
+    for(unsigned int i = 0; i < q.size(); ++i, ++k)
+    {
+      if(fabs(q(i) - _jachqCacheConfig[k]) > _jachqCacheTol)
+        return false;
+    }
+  }
+  return true;
+}
+
+void NewtonEulerJointR::jachqCacheStore(const BlockVector& q0)
+{
+  if(_jachqCacheTol <= 0.)
+    return;
+
+  _jachqCacheConfig.resize(q0.size());
+  std::size_t k = 0;
+  for(unsigned int b = 0; b < q0.numberOfBlocks(); ++b)
+  {
+    const SiconosVector& q = *(q0.getAllVect()[b]);
+    for(unsigned int i = 0; i < q.size(); ++i, ++k)
+      _jachqCacheConfig[k] = q(i);
+  }
+}
+
 void NewtonEulerJointR::projectVectorDoF(const SiconosVector& v,
     const BlockVector& q0,
     SiconosVector& ans, int axis,
@@ -25,6 +25,8 @@
 #include <SiconosFwd.hpp>
 #include <NewtonEulerR.hpp>
 
+#include <vector> // for the Jacobian cache configuration
+
 /** 
     This class implements an abstract Joint relation (articulation) between one or two Newton/Euler dynamical systems.
 */
@@ -53,13 +55,61 @@ protected:
   virtual void _normalDoF(SiconosVector& ans, const BlockVector& q0, int axis,
                           bool absoluteRef=true) {}
 
+  /** Tolerance on the body configuration delta under which the cached
+   *  constraint Jacobian is reused instead of recomputed (0: caching
+   *  disabled, the default). */
+  double _jachqCacheTol;
+
+  /** Configurations of the connected bodies (7 components each) the
+   *  cached Jacobian was computed at; empty when no Jacobian was
+   *  cached yet. */
+  std::vector<double> _jachqCacheConfig;
+
+  /** Return true when a Jacobian is cached and every component of the
+   *  configuration in q0 is within _jachqCacheTol of the one it was
+   *  computed at; used by the computeJachq of the subclasses to skip
+   *  the recomputation.
+   *
+   *  \param q0 The state q of one or more NewtonEulerDS
+   */
+  bool jachqCacheUpToDate(const BlockVector& q0) const;
+
+  /** Record the configuration the Jacobian was just computed at.
+   *
+   *  \param q0 The state q of one or more NewtonEulerDS
+   */
+  void jachqCacheStore(const BlockVector& q0);
+
 public:
 
   /** Empty constructor. The relation may be initialized later by
    *  setPoint, setAbsolute, and setBasePositions. */
   NewtonEulerJointR(): NewtonEulerR()
                      , _allowSelfCollide(false)
-                     , _absoluteRef(true) {};
+                     , _absoluteRef(true)
+                     , _jachqCacheTol(0.) {};
+
+  /** Enable reuse of the constraint Jacobian between Newton iterations:
+   *  as long as no component of the body configurations (position and
+   *  quaternion) moved by more than tol since the Jacobian was last
+   *  computed, computeJachq returns the cached value. The Jacobian
+   *  entries are smooth in the configuration, so the consistency error
+   *  of the reused Jacobian is first order in tol; it only affects the
+   *  convergence rate of the Newton loop, not the solution. Anything
+   *  that changes the joint geometry (setPoint, setAxis,
+   *  setBasePositions) must be followed by invalidateJachqCache().
+   *
+   *  \param tol configuration tolerance, 0 to disable caching
+   */
+  void setJachqCacheTolerance(double tol)
+  {
+    _jachqCacheTol = tol;
+    _jachqCacheConfig.clear();
+  }
+
+  /** Drop the cached Jacobian; the next computeJachq recomputes it. */
+  void invalidateJachqCache()
+    { _jachqCacheConfig.clear(); }
 
   /** Set a point for this joint. The role of each point is specific
    *  to the joint subclass. Won't take effect until
@@ -178,6 +178,8 @@ void PrismaticJointR::computeJachq(double time, Interaction& inter,  SP::BlockVe
 {
   DEBUG_PRINT("PrismaticJointR::computeJachq(double time, Interaction& inter, SP::BlockVector q0 ) \n");
 
+  if(jachqCacheUpToDate(*q0)) return;
+
   _jachq->zero();
   SP::SiconosVector q1 = (q0->getAllVect())[0];
   double X1 = q1->getValue(0);
@@ -203,6 +205,7 @@ void PrismaticJointR::computeJachq(double time, Interaction& inter,  SP::BlockVe
   else
     Jd1(X1, Y1, Z1, q10, q11, q12, q13);
 
+  jachqCacheStore(*q0);
   DEBUG_END("PrismaticJointR::computeJachq(double time, Interaction& inter, SP::BlockVector q0 ) \n");
 }
 
@@ -23,7 +23,16 @@ OccContactEdge::OccContactEdge(const OccContactShape& shape,
 
 const SPC::TopoDS_Edge OccContactEdge::contact() const
 {
-  return this->edge(this->_index);
+  /* the location of the sub-shape is composed from the reference shape at
+   * exploration time: the cached sub-shape stays valid until the body
+   * moves, so the exploration is redone once per move instead of once per
+   * distance query */
+  if(!this->_edge || !this->_location.IsEqual(this->data().Location()))
+  {
+    this->_edge = this->edge(this->_index);
+    this->_location = this->data().Location();
+  }
+  return this->_edge;
 }
 
 void OccContactEdge::computeUVBounds()
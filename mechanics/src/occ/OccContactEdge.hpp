@@ -2,6 +2,7 @@
 #define OccContactEdge_hpp
 
 #include "OccContactShape.hpp"
+#include <TopLoc_Location.hxx>
 
 struct OccContactEdge : public OccContactShape
 {
@@ -14,7 +15,11 @@ struct OccContactEdge : public OccContactShape
   virtual void computeUVBounds();
 
   unsigned int _index;
-  SPC::TopoDS_Edge _edge;
+
+  /* cached sub-shape: refreshed by contact() when the reference shape
+   * has moved */
+  mutable SPC::TopoDS_Edge _edge;
+  mutable TopLoc_Location _location;
 
   ACCEPT_STD_VISITORS();
 
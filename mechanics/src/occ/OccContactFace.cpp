@@ -22,7 +22,16 @@ OccContactFace::OccContactFace(const OccContactShape& reference_shape,
 
 SPC::TopoDS_Face OccContactFace::contact() const
 {
-  return this->face(this->_index);
+  /* the location of the sub-shape is composed from the reference shape at
+   * exploration time: the cached sub-shape stays valid until the body
+   * moves, so the exploration is redone once per move instead of once per
+   * distance query */
+  if(!this->_face || !this->_location.IsEqual(this->data().Location()))
+  {
+    this->_face = this->face(this->_index);
+    this->_location = this->data().Location();
+  }
+  return this->_face;
 }
 
 void OccContactFace::computeUVBounds()
@@ -2,6 +2,7 @@
 #define OccContactFace_hpp
 
 #include "OccContactShape.hpp"
+#include <TopLoc_Location.hxx>
 
 struct OccContactFace : public OccContactShape
 {
@@ -14,7 +15,11 @@ struct OccContactFace : public OccContactShape
   virtual void computeUVBounds();
 
   unsigned int _index;
-  SPC::TopoDS_Face _face;
+
+  /* cached sub-shape: refreshed by contact() when the reference shape
+   * has moved */
+  mutable SPC::TopoDS_Face _face;
+  mutable TopLoc_Location _location;
 
   ACCEPT_STD_VISITORS();
 };
@@ -1,14 +1,70 @@
 #include "OccUtils.hpp"
 #include "OccContactFace.hpp"
 #include "OccContactEdge.hpp"
+#include "SiconosException.hpp"
 #include "SiconosVector.hpp"
 #include <TopoDS.hxx>
+#include <TopLoc_Location.hxx>
 #include <gp_Dir.hxx>
 #include <gp_Quaternion.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 
 #include <cadmbtb.hpp>
 
+#include <limits>
+#include <map>
+#include <mutex>
+#include <utility>
+
+/* Persistent extrema computations: BRepExtrema_DistShapeShape decomposes
+ * the two shapes into sub-shape lists when they are loaded, and this setup
+ * dominates the query cost for CAD geometries. One instance is kept per
+ * contact pair across steps, and a side is reloaded only when its shape
+ * has actually moved. */
+struct OccDistanceMeasure
+{
+  BRepExtrema_DistShapeShape measure;
+  TopLoc_Location location1;
+  TopLoc_Location location2;
+  bool loaded = false;
+};
+
+static std::map<std::pair<const void*, const void*>, OccDistanceMeasure>
+occ_distance_measures;
+static std::mutex occ_distance_measures_mutex;
+
+static BRepExtrema_DistShapeShape& occ_measure(const void* key1,
+                                               const TopoDS_Shape& shape1,
+                                               const void* key2,
+                                               const TopoDS_Shape& shape2)
+{
+  OccDistanceMeasure* m;
+  {
+    /* std::map nodes are stable: distinct pairs may then use their
+     * measures concurrently */
+    std::lock_guard<std::mutex> lock(occ_distance_measures_mutex);
+    m = &occ_distance_measures[std::make_pair(key1, key2)];
+  }
+  if(!m->loaded || !m->location1.IsEqual(shape1.Location()))
+  {
+    m->measure.LoadS1(shape1);
+    m->location1 = shape1.Location();
+  }
+  if(!m->loaded || !m->location2.IsEqual(shape2.Location()))
+  {
+    m->measure.LoadS2(shape2);
+    m->location2 = shape2.Location();
+  }
+  m->loaded = true;
+  return m->measure;
+}
+
+void occ_clearDistanceCache()
+{
+  std::lock_guard<std::mutex> lock(occ_distance_measures_mutex);
+  occ_distance_measures.clear();
+}
+
 
 void occ_move(TopoDS_Shape& shape, const SiconosVector& q)
 {
@@ -37,9 +93,7 @@ void occ_distanceFaceFace(const OccContactFace& csh1,
   const TopoDS_Face& face1 = *pface1;
   const TopoDS_Face& face2 = *pface2;
 
-  BRepExtrema_DistShapeShape measure;
-  measure.LoadS1(face1);
-  measure.LoadS2(face2);
+  BRepExtrema_DistShapeShape& measure = occ_measure(&csh1, face1, &csh2, face2);
   measure.Perform();
 
   if(measure.IsDone())
@@ -91,9 +145,7 @@ void occ_distanceFaceEdge(const OccContactFace& csh1,
   const TopoDS_Face& face1 = *pface1;
   const TopoDS_Edge& edge2 = *pedge2;
 
-  BRepExtrema_DistShapeShape measure;
-  measure.LoadS1(face1);
-  measure.LoadS2(edge2);
+  BRepExtrema_DistShapeShape& measure = occ_measure(&csh1, face1, &csh2, edge2);
   measure.Perform();
 
   if(measure.IsDone())
@@ -130,3 +182,61 @@ void occ_distanceFaceEdge(const OccContactFace& csh1,
   else
     THROW_EXCEPTION("occ distance: BRepExtrema_DistShapeShape failed");
 }
+
+/* same dispatch and sign conventions as the Geometer visitors, without the
+ * visitor machinery so that it can run inside a parallel loop */
+static void occ_distanceShapeShape(const OccContactShape& csh1,
+                                   const OccContactShape& csh2,
+                                   ContactShapeDistance& dist)
+{
+  dist.value = std::numeric_limits<double>::infinity();
+
+  const OccContactFace* face1 = dynamic_cast<const OccContactFace*>(&csh1);
+  const OccContactFace* face2 = dynamic_cast<const OccContactFace*>(&csh2);
+  const OccContactEdge* edge1 = dynamic_cast<const OccContactEdge*>(&csh1);
+  const OccContactEdge* edge2 = dynamic_cast<const OccContactEdge*>(&csh2);
+
+  if(face1 && face2)
+  {
+    occ_distanceFaceFace(*face1, *face2,
+                         dist.x1, dist.y1, dist.z1,
+                         dist.x2, dist.y2, dist.z2,
+                         dist.nx, dist.ny, dist.nz,
+                         dist.value);
+  }
+  else if(face1 && edge2)
+  {
+    occ_distanceFaceEdge(*face1, *edge2,
+                         dist.x1, dist.y1, dist.z1,
+                         dist.x2, dist.y2, dist.z2,
+                         dist.nx, dist.ny, dist.nz,
+                         dist.value);
+    dist.nx = -dist.nx;
+    dist.ny = -dist.ny;
+    dist.nz = -dist.nz;
+  }
+  else if(edge1 && face2)
+  {
+    occ_distanceFaceEdge(*face2, *edge1,
+                         dist.x1, dist.y1, dist.z1,
+                         dist.x2, dist.y2, dist.z2,
+                         dist.nx, dist.ny, dist.nz,
+                         dist.value);
+  }
+  else
+  {
+    THROW_EXCEPTION("occ_distances: unsupported contact shape pair");
+  }
+}
+
+void occ_distances(std::vector<OccDistanceJob>& jobs)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(jobs.size()); ++i)
+  {
+    OccDistanceJob& job = jobs[i];
+    occ_distanceShapeShape(*job.shape1, *job.shape2, *job.distance);
+  }
+}
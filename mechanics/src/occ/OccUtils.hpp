@@ -3,10 +3,13 @@
 
 #include "MechanicsFwd.hpp"
 #include "SiconosFwd.hpp"
+#include "ContactShapeDistance.hpp"
 #include <Standard_TypeDef.hxx>
+#include <vector>
 
 class OccContactFace;
 class OccContactEdge;
+struct OccContactShape;
 
 void occ_move(TopoDS_Shape& shape, const SiconosVector& pos);
 
@@ -24,4 +27,27 @@ void occ_distanceFaceEdge(const OccContactFace& csh1,
                           Standard_Real& nX, Standard_Real& nY, Standard_Real& nZ,
                           Standard_Real& MinDist);
 
+/** a distance query over one pair of contact shapes, for the batch API */
+struct OccDistanceJob
+{
+  const OccContactShape* shape1;
+  const OccContactShape* shape2;
+  ContactShapeDistance* distance;
+};
+
+/** Run the distance queries of all jobs, in parallel when OpenMP is
+ *  enabled. The pairs must be distinct: the persistent extrema
+ *  computation of a pair is not reentrant. The result of each job follows
+ *  the same conventions as the Geometer visitors (the normal points from
+ *  shape2 towards shape1, face first for a face-edge pair).
+ *
+ *  \param jobs the queries to run
+ */
+void occ_distances(std::vector<OccDistanceJob>& jobs);
+
+/** Drop the extrema computations cached across steps; to be called when
+ *  contact shapes are destroyed or replaced.
+ */
+void occ_clearDistanceCache();
+
 #endif
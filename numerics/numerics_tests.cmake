@@ -15,6 +15,8 @@ if(WITH_TESTING)
 
   new_test(SOURCES test_op3x3.c)
 
+  new_test(SOURCES test_opNxN.c)
+
   new_test(SOURCES test_timers_interf.c)
 
   new_test(SOURCES test_blas_lapack.c)
@@ -22,7 +24,13 @@ if(WITH_TESTING)
   #if(HAS_LAPACK_dgesvd) # Some lapack versions miss dgesvd
   new_test(SOURCES test_pinv.c)# DEPS "externals")
   #endif()
-  
+
+  new_test(SOURCES test_cond.c)
+
+  new_test(SOURCES test_fd_jacobian.c)
+
+  new_test(SOURCES test_anderson.c)
+
   new_test(NAME tools_projection SOURCES test_projection.c)
 
   new_test(SOURCES NumericsArrays.c)
@@ -171,7 +179,10 @@ if(WITH_TESTING)
   new_tests_collection(
     DRIVER fc_test_collection.c.in FORMULATION fc3d COLLECTION TEST_NSGS_COLLECTION_5
     EXTRA_SOURCES data_collection_3.c test_nsgs_5.c)
-  
+  new_tests_collection(
+    DRIVER fc_test_collection.c.in FORMULATION fc3d COLLECTION TEST_PARALLEL_COLLECTION_1
+    EXTRA_SOURCES data_collection_3.c test_parallel_1.c)
+
   new_tests_collection(
     DRIVER fc_test_collection.c.in FORMULATION fc3d COLLECTION TEST_ADMM_COLLECTION_1
     EXTRA_SOURCES data_collection_1.c test_admm_1.c)
@@ -208,6 +219,14 @@ if(WITH_TESTING)
     DRIVER fc_test_collection.c.in FORMULATION fc3d COLLECTION TEST_QUARTIC_COLLECTION_1
     EXTRA_SOURCES data_collection_5.c test_quartic_1.c)
     
+  # --- benchmark harness ---
+  # performance harness for any fc3d solver id; without arguments it
+  # runs NSGS once on a small problem and doubles as a smoke test
+  new_test(SOURCES fc3d_benchmark.c)
+
+  # --- binary problem corpus ---
+  new_test(SOURCES fc_corpus_test.c)
+
   # --- LMGC driver ---
   new_test(SOURCES fc3d_newFromFortranData.c)
   new_test(SOURCES fc3d_LmgcDriver_test1.c)
@@ -240,6 +259,7 @@ if(WITH_TESTING)
 
   # Alart Curnier functions
   new_test(NAME AlartCurnierFunctions_test SOURCES fc3d_AlartCurnierFunctions_test.c)
+  new_test(NAME AlartCurnierBatch_test SOURCES fc3d_AlartCurnierBatch_test.c)
 
   # ---------------------------------------------------
   # --- Rolling friction contact problem formulation ---
@@ -248,7 +268,11 @@ if(WITH_TESTING)
   new_tests_collection(
     DRIVER rfc3d_test_collection.c.in  FORMULATION rolling_fc3d COLLECTION TEST_FIRST_ORDER_COLLECTION
     EXTRA_SOURCES data_collection_rfc3d.c test_first_order_rfc3d_1.c )
-      
+
+  new_tests_collection(
+    DRIVER rfc3d_test_collection.c.in  FORMULATION rolling_fc3d COLLECTION TEST_PARALLEL_RFC3D_COLLECTION
+    EXTRA_SOURCES data_collection_rfc3d.c test_parallel_rfc3d_1.c )
+
   if(WITH_FCLIB)
 
     new_test(NAME FCLIB_test1 SOURCES fc3d_writefclib_local_test.c DEPS FCLIB::fclib)
@@ -38,8 +38,10 @@
 #define IS_NOT_ZERO(x) fabs(x) > 0
 #define IS_POSITIVE(x) 1
 
-#define random1 sqrt(2)/2
-#define random2 sqrt(2)/2
+/* constant unit tangent used for the degenerate cases; literals avoid
+ * going through the sqrt hack below on every use */
+#define random1 0.70710678118654752440
+#define random2 0.70710678118654752440
 
 #ifdef __cplusplus
 #include <cmath>
@@ -52,11 +54,33 @@
 // and it is not clear for all compiler which cast should be applied.
 // The real fix is to prevent sympy from adding the type specifier
 #ifdef __cplusplus
-#define pow(x, y) std::pow(static_cast<double>(x), static_cast<double>(y))
+#define FB_POW_LIBM(x, y) std::pow(static_cast<double>(x), static_cast<double>(y))
 #else
-#define pow(x,y) pow((double)x, (double)y)
+#define FB_POW_LIBM(x, y) pow((double)(x), (double)(y))
 #endif
 
+/* The generated code calls pow almost only with small integer exponents
+ * (3 to 6): dispatch those to multiplications instead of the libm call.
+ * Another hack, should also be prevented in sage/sympy/maple or in code
+ * generation */
+static inline double fb_pow(double x, double y)
+{
+  int e = (int)y;
+  if((double)e == y && e >= 0 && e <= 8)
+  {
+    double r = 1.0;
+    while(e)
+    {
+      if(e & 1) r *= x;
+      x *= x;
+      e >>= 1;
+    }
+    return r;
+  }
+  return FB_POW_LIBM(x, y);
+}
+#define pow(x, y) fb_pow(x, y)
+
 #pragma GCC diagnostic ignored "-Wconversion"
 
 // hack, should be prevented in sage/sympy/maple or in code generation
@@ -0,0 +1,350 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include "CSparseMatrix_internal.h"  // for CSparseMatrix, CS_INT
+#include "FrictionContactCorpus.h"
+
+#include <stdint.h>                  // for uint64_t, int64_t
+#include <stdlib.h>                  // for malloc, calloc, free, realloc
+#include <string.h>                  // for memcmp, memcpy
+
+#include "FrictionContactProblem.h"  // for FrictionContactProblem
+#include "NumericsMatrix.h"          // for NumericsMatrix, NM_create, NM_csc
+#include "NumericsSparseMatrix.h"    // for NSM_CSC
+#include "numerics_verbose.h"        // for numerics_printf_verbose, numeric...
+
+#ifndef _WIN32
+#include <fcntl.h>     // for open, O_RDONLY
+#include <sys/mman.h>  // for mmap, munmap, PROT_READ, MAP_PRI...
+#include <sys/stat.h>  // for fstat, stat
+#include <unistd.h>    // for close
+#endif
+
+/* file header: magic, format version, number of problems, byte offset of
+   the index. The index is an array of (offset, size) pairs, one per
+   problem, appended after the last record. */
+#define CORPUS_MAGIC "SNFCCORP"
+#define CORPUS_MAGIC_SIZE 8
+#define CORPUS_VERSION UINT64_C(1)
+#define CORPUS_HEADER_SIZE (CORPUS_MAGIC_SIZE + 3 * sizeof(uint64_t))
+
+/* each record starts 8-byte aligned with four uint64 fields (dimension,
+   number of contacts, n, nnz) followed by p[n+1] and i[nnz] as int64,
+   then x[nnz], q[n] and mu[nc] as doubles */
+
+struct FrictionContactCorpus
+{
+  void* map;              /**< the whole file */
+  size_t size;            /**< file size in bytes */
+  int mapped;             /**< 1 when map comes from mmap, 0 from malloc */
+  uint64_t count;         /**< number of problems */
+  const uint64_t* index;  /**< (offset, size) pairs, into map */
+};
+
+static void* corpus_read_whole_file(const char* filename, size_t* size)
+{
+  FILE* file = fopen(filename, "rb");
+  if(!file) return NULL;
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  void* data = length > 0 ? malloc((size_t)length) : NULL;
+  if(data && fread(data, 1, (size_t)length, file) != (size_t)length)
+  {
+    free(data);
+    data = NULL;
+  }
+  fclose(file);
+  *size = length > 0 ? (size_t)length : 0;
+  return data;
+}
+
+FrictionContactCorpus* frictionContact_corpus_open(const char* filename)
+{
+  void* map = NULL;
+  size_t size = 0;
+  int mapped = 0;
+
+#ifndef _WIN32
+  int fd = open(filename, O_RDONLY);
+  if(fd >= 0)
+  {
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+      map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(map == MAP_FAILED)
+        map = NULL;
+      else
+      {
+        size = (size_t)st.st_size;
+        mapped = 1;
+      }
+    }
+    close(fd);
+  }
+#endif
+  if(!map)
+    map = corpus_read_whole_file(filename, &size);
+
+  if(!map || size < CORPUS_HEADER_SIZE
+      || memcmp(map, CORPUS_MAGIC, CORPUS_MAGIC_SIZE) != 0)
+  {
+    numerics_warning("frictionContact_corpus_open",
+                     "%s is not a corpus file", filename);
+    goto fail;
+  }
+
+  const uint64_t* header = (const uint64_t*)((const char*)map + CORPUS_MAGIC_SIZE);
+  uint64_t version = header[0];
+  uint64_t count = header[1];
+  uint64_t index_offset = header[2];
+  if(version != CORPUS_VERSION
+      || index_offset + count * 2 * sizeof(uint64_t) > size)
+  {
+    numerics_warning("frictionContact_corpus_open",
+                     "%s: unsupported version or truncated file", filename);
+    goto fail;
+  }
+
+  FrictionContactCorpus* corpus =
+    (FrictionContactCorpus*)malloc(sizeof(FrictionContactCorpus));
+  corpus->map = map;
+  corpus->size = size;
+  corpus->mapped = mapped;
+  corpus->count = count;
+  corpus->index = (const uint64_t*)((const char*)map + index_offset);
+  numerics_printf_verbose(1, "frictionContact_corpus_open :: %s, %llu problems",
+                          filename, (unsigned long long)count);
+  return corpus;
+
+fail:
+  if(map)
+  {
+#ifndef _WIN32
+    if(mapped)
+      munmap(map, size);
+    else
+#endif
+      free(map);
+  }
+  return NULL;
+}
+
+void frictionContact_corpus_close(FrictionContactCorpus* corpus)
+{
+  if(!corpus) return;
+#ifndef _WIN32
+  if(corpus->mapped)
+    munmap(corpus->map, corpus->size);
+  else
+#endif
+    free(corpus->map);
+  free(corpus);
+}
+
+unsigned int frictionContact_corpus_size(const FrictionContactCorpus* corpus)
+{
+  return (unsigned int)corpus->count;
+}
+
+FrictionContactProblem* frictionContact_corpus_get(FrictionContactCorpus* corpus, unsigned int k)
+{
+  if(k >= corpus->count)
+  {
+    numerics_warning("frictionContact_corpus_get",
+                     "problem number %u out of range", k);
+    return NULL;
+  }
+  uint64_t offset = corpus->index[2 * k];
+  const uint64_t* rec = (const uint64_t*)((const char*)corpus->map + offset);
+  uint64_t nc = rec[1];
+  uint64_t n = rec[2];
+  uint64_t nnz = rec[3];
+  const int64_t* p = (const int64_t*)(rec + 4);
+  const int64_t* i = p + n + 1;
+  const double* x = (const double*)(i + nnz);
+  const double* q = x + nnz;
+  const double* mu = q + n;
+
+  FrictionContactProblem* problem = frictionContactProblem_new();
+  problem->dimension = (int)rec[0];
+  problem->numberOfContacts = (int)nc;
+
+  NumericsMatrix* M = NM_create(NM_SPARSE, (int)n, (int)n);
+  M->matrix2->origin = NSM_CSC;
+  CSparseMatrix* csc = (CSparseMatrix*)calloc(1, sizeof(CSparseMatrix));
+  csc->m = (CS_INT)n;
+  csc->n = (CS_INT)n;
+  csc->nzmax = (CS_INT)nnz;
+  csc->nz = -1;
+  if(sizeof(CS_INT) == sizeof(int64_t))
+  {
+    /* the mapped arrays are used in place; the problems are read-only */
+    csc->p = (CS_INT*)p;
+    csc->i = (CS_INT*)i;
+  }
+  else
+  {
+    /* 32-bit CS_INT: the indices are the only thing copied */
+    csc->p = (CS_INT*)malloc((n + 1) * sizeof(CS_INT));
+    csc->i = (CS_INT*)malloc(nnz * sizeof(CS_INT));
+    for(uint64_t j = 0; j < n + 1; ++j) csc->p[j] = (CS_INT)p[j];
+    for(uint64_t j = 0; j < nnz; ++j) csc->i[j] = (CS_INT)i[j];
+  }
+  csc->x = (double*)x;
+  M->matrix2->csc = csc;
+  problem->M = M;
+  problem->q = (double*)q;
+  problem->mu = (double*)mu;
+  return problem;
+}
+
+void frictionContact_corpus_problem_free(FrictionContactProblem* problem)
+{
+  if(!problem) return;
+  CSparseMatrix* csc = problem->M->matrix2->csc;
+  if(sizeof(CS_INT) == sizeof(int64_t))
+  {
+    /* the index arrays are views into the mapping, only the copies made
+       for 32-bit CS_INT belong to the matrix */
+    csc->p = NULL;
+    csc->i = NULL;
+  }
+  csc->x = NULL;
+  NM_free(problem->M);
+  problem->M = NULL;
+  problem->q = NULL;
+  problem->mu = NULL;
+  free(problem);
+}
+
+struct FrictionContactCorpusWriter
+{
+  FILE* file;
+  uint64_t* index;        /**< (offset, size) pairs of the records so far */
+  uint64_t count;
+  uint64_t capacity;
+};
+
+FrictionContactCorpusWriter* frictionContact_corpus_writer_open(const char* filename)
+{
+  FILE* file = fopen(filename, "wb");
+  if(!file)
+  {
+    numerics_warning("frictionContact_corpus_writer_open",
+                     "cannot create %s", filename);
+    return NULL;
+  }
+  /* header placeholder, patched on close */
+  uint64_t header[3] = {CORPUS_VERSION, 0, 0};
+  fwrite(CORPUS_MAGIC, 1, CORPUS_MAGIC_SIZE, file);
+  fwrite(header, sizeof(uint64_t), 3, file);
+
+  FrictionContactCorpusWriter* writer =
+    (FrictionContactCorpusWriter*)malloc(sizeof(FrictionContactCorpusWriter));
+  writer->file = file;
+  writer->count = 0;
+  writer->capacity = 64;
+  writer->index = (uint64_t*)malloc(2 * writer->capacity * sizeof(uint64_t));
+  return writer;
+}
+
+static void corpus_write_int64(FILE* file, const CS_INT* values, uint64_t n)
+{
+  if(sizeof(CS_INT) == sizeof(int64_t))
+  {
+    fwrite(values, sizeof(int64_t), n, file);
+    return;
+  }
+  int64_t buffer[512];
+  while(n > 0)
+  {
+    uint64_t chunk = n < 512 ? n : 512;
+    for(uint64_t j = 0; j < chunk; ++j) buffer[j] = (int64_t)values[j];
+    fwrite(buffer, sizeof(int64_t), chunk, file);
+    values += chunk;
+    n -= chunk;
+  }
+}
+
+int frictionContact_corpus_writer_add(FrictionContactCorpusWriter* writer,
+                                      FrictionContactProblem* problem)
+{
+  CSparseMatrix* csc = NM_csc(problem->M);
+  if(!csc)
+  {
+    numerics_warning("frictionContact_corpus_writer_add",
+                     "cannot convert M to csc");
+    return 1;
+  }
+  uint64_t nc = (uint64_t)problem->numberOfContacts;
+  uint64_t n = (uint64_t)csc->n;
+  uint64_t nnz = (uint64_t)csc->p[n];
+
+  /* records start 8-byte aligned so that the mapped arrays can be used
+     in place */
+  long position = ftell(writer->file);
+  static const char zeros[8] = {0};
+  if(position % 8)
+  {
+    fwrite(zeros, 1, 8 - position % 8, writer->file);
+    position += 8 - position % 8;
+  }
+
+  uint64_t fields[4] = {(uint64_t)problem->dimension, nc, n, nnz};
+  fwrite(fields, sizeof(uint64_t), 4, writer->file);
+  corpus_write_int64(writer->file, csc->p, n + 1);
+  corpus_write_int64(writer->file, csc->i, nnz);
+  fwrite(csc->x, sizeof(double), nnz, writer->file);
+  fwrite(problem->q, sizeof(double), n, writer->file);
+  fwrite(problem->mu, sizeof(double), nc, writer->file);
+
+  if(writer->count == writer->capacity)
+  {
+    writer->capacity *= 2;
+    writer->index = (uint64_t*)realloc(writer->index,
+                                       2 * writer->capacity * sizeof(uint64_t));
+  }
+  writer->index[2 * writer->count] = (uint64_t)position;
+  writer->index[2 * writer->count + 1] = (uint64_t)(ftell(writer->file) - position);
+  writer->count++;
+  return ferror(writer->file) ? 1 : 0;
+}
+
+int frictionContact_corpus_writer_close(FrictionContactCorpusWriter* writer)
+{
+  FILE* file = writer->file;
+  long position = ftell(file);
+  static const char zeros[8] = {0};
+  if(position % 8)
+  {
+    fwrite(zeros, 1, 8 - position % 8, file);
+    position += 8 - position % 8;
+  }
+  fwrite(writer->index, sizeof(uint64_t), 2 * writer->count, file);
+
+  uint64_t header[2] = {writer->count, (uint64_t)position};
+  fseek(file, CORPUS_MAGIC_SIZE + sizeof(uint64_t), SEEK_SET);
+  fwrite(header, sizeof(uint64_t), 2, file);
+
+  int status = ferror(file);
+  fclose(file);
+  free(writer->index);
+  free(writer);
+  return status ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef FRICTIONCONTACTCORPUS_H
+#define FRICTIONCONTACTCORPUS_H
+
+/*!\file FrictionContactCorpus.h
+  \brief binary container holding many friction-contact problems in one file.
+
+  The ASCII dumps written by frictionContact_printInFile() have to be
+  parsed number by number; on a corpus of captured problems the parsing
+  dominates the solves. A corpus file stores the problems back to back in
+  a fixed binary layout -- M as 64-bit CSC, then q and mu -- with an
+  index at the end of the file for random access. The file is mapped
+  read-only and a problem is handed out as a view whose arrays point into
+  the mapping: no parsing, no copy (the column indices are the only copy,
+  and only when the library is built with 32-bit CS_INT).
+
+  All fields are 64-bit and records are 8-byte aligned, so a file written
+  on one LP64 machine loads on any other.
+*/
+
+#include <stdio.h>  // for FILE
+
+#include "NumericsFwd.h"    // for FrictionContactProblem
+#include "SiconosConfig.h"  // for BUILD_AS_CPP // IWYU pragma: keep
+
+/** read-only view on a corpus file */
+typedef struct FrictionContactCorpus FrictionContactCorpus;
+
+/** incremental corpus file writer */
+typedef struct FrictionContactCorpusWriter FrictionContactCorpusWriter;
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** Map a corpus file.
+      \param filename path of the corpus file
+      \return the corpus, NULL when the file cannot be mapped or is not a
+      corpus file
+  */
+  FrictionContactCorpus* frictionContact_corpus_open(const char* filename);
+
+  /** Unmap and free a corpus. All the problem views handed out by
+      frictionContact_corpus_get() must have been freed before.
+      \param corpus the corpus, may be NULL
+  */
+  void frictionContact_corpus_close(FrictionContactCorpus* corpus);
+
+  /** Number of problems in a corpus.
+      \param corpus the corpus
+      \return the number of problems
+  */
+  unsigned int frictionContact_corpus_size(const FrictionContactCorpus* corpus);
+
+  /** Problem number k of a corpus, as a view into the mapping.
+      The problem is read-only: M, q and mu point into the mapped file.
+      \param corpus the corpus
+      \param k problem number, 0 .. size-1
+      \return the problem, to be released with
+      frictionContact_corpus_problem_free(), NULL when k is out of range
+  */
+  FrictionContactProblem* frictionContact_corpus_get(FrictionContactCorpus* corpus, unsigned int k);
+
+  /** Release a problem view handed out by frictionContact_corpus_get()
+      without touching the mapped arrays.
+      \param problem the problem view, may be NULL
+  */
+  void frictionContact_corpus_problem_free(FrictionContactProblem* problem);
+
+  /** Start writing a corpus file.
+      \param filename path of the corpus file, truncated when it exists
+      \return the writer, NULL when the file cannot be created
+  */
+  FrictionContactCorpusWriter* frictionContact_corpus_writer_open(const char* filename);
+
+  /** Append one problem; M is converted to CSC whatever its storage.
+      \param writer the writer
+      \param problem the problem to append
+      \return 0 on success
+  */
+  int frictionContact_corpus_writer_add(FrictionContactCorpusWriter* writer,
+                                        FrictionContactProblem* problem);
+
+  /** Write the index and the header, then close the file.
+      \param writer the writer
+      \return 0 on success
+  */
+  int frictionContact_corpus_writer_close(FrictionContactCorpusWriter* writer);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
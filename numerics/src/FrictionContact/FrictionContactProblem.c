@@ -411,3 +411,23 @@ void frictionContact_rescaling(
   cblas_dscal(n,alpha*gamma,problem->q,1);
 
 }
+
+void frictionContact_AoS_to_SoA(int numberOfContacts, const double* v, double* v_soa)
+{
+  for(int i = 0; i < numberOfContacts; ++i)
+  {
+    v_soa[i] = v[3 * i];
+    v_soa[numberOfContacts + i] = v[3 * i + 1];
+    v_soa[2 * numberOfContacts + i] = v[3 * i + 2];
+  }
+}
+
+void frictionContact_SoA_to_AoS(int numberOfContacts, const double* v_soa, double* v)
+{
+  for(int i = 0; i < numberOfContacts; ++i)
+  {
+    v[3 * i] = v_soa[i];
+    v[3 * i + 1] = v_soa[numberOfContacts + i];
+    v[3 * i + 2] = v_soa[2 * numberOfContacts + i];
+  }
+}
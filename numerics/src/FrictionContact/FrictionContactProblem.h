@@ -154,6 +154,29 @@ FrictionContactProblem *frictionContact_copy(FrictionContactProblem *problem);
 void frictionContact_rescaling(FrictionContactProblem *problem, double alpha,
                                double gamma);
 
+/** Convert a stacked vector of per-contact 3-vectors (reaction, velocity or
+ *  q, interleaved [n, t1, t2] order) into its structure-of-arrays
+ *  representation, where component c of contact i is stored at
+ *  v_soa[c * numberOfContacts + i] (same component-major convention as
+ *  fc3d_AlartCurnier_batch.h); per-contact kernels vectorize on this layout.
+ *
+ *  \param numberOfContacts the number of contacts
+ *  \param v interleaved array (size 3 * numberOfContacts)
+ *  \param v_soa component-major output buffer (size 3 * numberOfContacts)
+ */
+void frictionContact_AoS_to_SoA(int numberOfContacts, const double *v,
+                                double *v_soa);
+
+/** Convert a component-major structure-of-arrays buffer back into the
+ *  interleaved per-contact layout; inverse of frictionContact_AoS_to_SoA().
+ *
+ *  \param numberOfContacts the number of contacts
+ *  \param v_soa component-major input buffer (size 3 * numberOfContacts)
+ *  \param v interleaved output array (size 3 * numberOfContacts)
+ */
+void frictionContact_SoA_to_AoS(int numberOfContacts, const double *v_soa,
+                                double *v);
+
 #if defined(__cplusplus) && !defined(BUILD_AS_CPP)
 }
 #endif
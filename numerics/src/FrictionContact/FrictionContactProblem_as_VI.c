@@ -48,9 +48,8 @@ void Function_VI_FC3D(void * self, int n_notused, double *x, double *F)
   cblas_dcopy(n, fc3d->q, 1, F, 1);
   NM_gemv(1.0, fc3d->M, x, 1.0, F);
 
-  int contact =0;
-
-  for(contact = 0 ; contact <  fc3d->numberOfContacts ; ++contact)
+  #pragma omp parallel for schedule(static) if(fc3d->numberOfContacts > (1 << 12))
+  for(int contact = 0 ; contact <  fc3d->numberOfContacts ; ++contact)
   {
     double  normUT = sqrt(F[contact * nLocal + 1] * F[contact * nLocal + 1]
                           + F[contact * nLocal + 2] * F[contact * nLocal + 2]);
@@ -69,14 +68,10 @@ void Projection_VI_FC3D(void *viIn, double *x, double *PX)
   FrictionContactProblem * fc3d = pb->fc3d;
   //frictionContact_display(fc3d);
 
-  int contact =0;
   int nLocal =  fc3d->dimension;
   int n = fc3d->numberOfContacts* nLocal;
   cblas_dcopy(n, x, 1, PX, 1);
-  for(contact = 0 ; contact < fc3d->numberOfContacts  ; ++contact)
-  {
-    projectionOnCone(&PX[ contact * nLocal ], fc3d->mu[contact]);
-  }
+  projectionOnCone_batch(fc3d->numberOfContacts, PX, fc3d->mu);
 }
 
 void Function_VI_FC3D_Cylinder(void * self, int n_notused, double *x, double *F)
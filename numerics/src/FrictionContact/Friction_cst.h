@@ -59,6 +59,15 @@ enum FRICTION_SOLVER
   SICONOS_FRICTION_3D_PFP = 522,
   /** ADMM local formulation */
   SICONOS_FRICTION_3D_ADMM = 523,
+  /** Non-smooth Gauss Seidel with multi-color parallel sweeps, local formulation */
+  SICONOS_FRICTION_3D_NSGS_MULTICOLOR = 524,
+
+  /** FC3D, island decomposition: split the problem into the connected
+      components of W and solve them independently */
+  SICONOS_FRICTION_3D_ISLANDS = 525,
+  SICONOS_FRICTION_3D_REDUCED = 526,
+  /** Damped Jacobi / asynchronous block iteration, local formulation */
+  SICONOS_FRICTION_3D_JACOBI = 527,
 
   /* 3D Frictional Contact solvers for one contact (used mainly inside NSGS solvers) */
 
@@ -105,6 +114,7 @@ enum FRICTION_SOLVER
   SICONOS_GLOBAL_FRICTION_3D_ADMM = 613,
   SICONOS_GLOBAL_FRICTION_3D_ADMM_WR = 614,
   SICONOS_GLOBAL_FRICTION_3D_IPM = 615,
+  SICONOS_GLOBAL_FRICTION_3D_NSGS_MPI = 616,
 
 
   /** Non-smooth Gauss Seidel, local formulation */
@@ -112,6 +122,7 @@ enum FRICTION_SOLVER
   SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnCone= 3001,
   SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnConeWithLocalIteration = 3002,
   SICONOS_ROLLING_FRICTION_3D_ADMM = 3003,
+  SICONOS_ROLLING_FRICTION_3D_NSGS_MULTICOLOR = 3004,
 
   /** Non-smooth Gauss Seidel, local formulation */
   SICONOS_ROLLING_FRICTION_2D_NSGS = 4000,
@@ -132,6 +143,10 @@ extern const char* const   SICONOS_FRICTION_2D_ENUM_STR ;
 
 extern const char* const   SICONOS_FRICTION_3D_NSGS_STR ;
 extern const char* const   SICONOS_FRICTION_3D_NSGSV_STR ;
+extern const char* const   SICONOS_FRICTION_3D_NSGS_MULTICOLOR_STR ;
+extern const char* const   SICONOS_FRICTION_3D_JACOBI_STR ;
+extern const char* const   SICONOS_FRICTION_3D_ISLANDS_STR ;
+extern const char* const   SICONOS_FRICTION_3D_REDUCED_STR ;
 extern const char* const   SICONOS_FRICTION_3D_PROX_STR;
 extern const char* const   SICONOS_FRICTION_3D_TFP_STR ;
 extern const char* const   SICONOS_FRICTION_3D_PFP_STR ;
@@ -173,6 +188,7 @@ extern const char* const   SICONOS_GLOBAL_FRICTION_3D_PROX_WR_STR ;
 extern const char* const   SICONOS_GLOBAL_FRICTION_3D_DSFP_WR_STR ;
 extern const char* const   SICONOS_GLOBAL_FRICTION_3D_TFP_WR_STR ;
 extern const char* const   SICONOS_GLOBAL_FRICTION_3D_NSGS_STR ;
+extern const char* const   SICONOS_GLOBAL_FRICTION_3D_NSGS_MPI_STR ;
 extern const char* const   SICONOS_GLOBAL_FRICTION_3D_NSN_AC_WR_STR ;
 extern const char* const   SICONOS_GLOBAL_FRICTION_3D_NSN_AC_STR;
 extern const char* const   SICONOS_GLOBAL_FRICTION_3D_GAMS_PATH_STR;
@@ -191,6 +207,7 @@ extern const char* const   SICONOS_ROLLING_FRICTION_3D_NSGS_STR ;
 extern const char* const   SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnCone_STR;
 extern const char* const   SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnConeWithLocalIteration_STR;
 extern const char* const   SICONOS_ROLLING_FRICTION_3D_ADMM_STR ;
+extern const char* const   SICONOS_ROLLING_FRICTION_3D_NSGS_MULTICOLOR_STR ;
 
 extern const char* const   SICONOS_ROLLING_FRICTION_2D_NSGS_STR ;
 extern const char* const   SICONOS_ROLLING_FRICTION_2D_ONECONTACT_ProjectionOnCone_STR;
@@ -212,6 +229,9 @@ enum SICONOS_FRICTION_3D_IPARAM
   SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION = 7,
   /** index in iparam to store the frequency of error evaluation method */
   SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION_FREQUENCY = 8,
+  /** index in iparam to store the Anderson acceleration depth of the
+      fixed-point solvers (TFP, ACLMFP, FPP), 0 to disable it */
+  SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH = 9,
   SICONOS_FRICTION_3D_NUMBER_OF_CONTACTS = 17,
 };
 
@@ -254,8 +274,42 @@ enum SICONOS_FRICTION_3D_NSGS_IPARAM
   SICONOS_FRICTION_3D_NSGS_SHUFFLE_SEED=6,
   /** index in iparam to store the  */
   SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT =19,
+  /** index in iparam to store the reactivation strategy for frozen contacts */
+  SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION =15,
+  /** index in iparam (out) to store the number of contacts still frozen on return */
+  SICONOS_FRICTION_3D_NSGS_IPARAM_FROZEN_CONTACTS =16,
+  /** index in iparam (out) to store the number of local solves skipped by freezing */
+  SICONOS_FRICTION_3D_NSGS_IPARAM_SKIPPED_LOCAL_SOLVES =17,
   /** index in iparam to store the  */
   SICONOS_FRICTION_3D_NSGS_FILTER_LOCAL_SOLUTION =14,
+  /** index in iparam to store the number of iterations of the coarse
+      aggregate preconditioner applied before the sweeps of each outer
+      iteration (two-level scheme), 0 to disable it */
+  SICONOS_FRICTION_3D_NSGS_COARSE_PRECOND =18,
+  /** index in iparam to enable, in gfc3d_nsgs, the incremental
+      maintenance of the global velocity through cached columns of
+      M^{-1}H instead of a full resolution per sweep */
+  SICONOS_FRICTION_3D_NSGS_INCREMENTAL_GLOBAL_VELOCITY =12,
+  /** index in iparam to keep the frozen-contact countdowns in
+      options->iWork across successive calls on the same problem, so
+      that an outer wrapper (e.g. the proximal solver) restarting nsgs
+      does not thaw every contact; 0 (default) resets them each call */
+  SICONOS_FRICTION_3D_NSGS_KEEP_FREEZE_STATE =13,
+};
+
+enum SICONOS_FRICTION_3D_NSGS_INCREMENTAL_GLOBAL_VELOCITY_ENUM
+{
+  SICONOS_FRICTION_3D_NSGS_INCREMENTAL_GLOBAL_VELOCITY_FALSE =0,
+  SICONOS_FRICTION_3D_NSGS_INCREMENTAL_GLOBAL_VELOCITY_TRUE =1
+};
+
+enum SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION_ENUM
+{
+  /** frozen contacts only thaw when their countdown expires */
+  SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION_FALSE =0,
+  /** freezing requires a stable residual history and frozen contacts are
+      woken up when a neighbour in the W block graph moves */
+  SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION_TRUE =1
 };
 enum SICONOS_FRICTION_3D_NSGS_DPARAM
 {
@@ -264,6 +318,36 @@ enum SICONOS_FRICTION_3D_NSGS_DPARAM
 };
 
 
+enum SICONOS_FRICTION_3D_JACOBI_IPARAM
+{
+  /** index in iparam to store the update scheme (see
+      SICONOS_FRICTION_3D_JACOBI_UPDATE_SCHEME_ENUM) */
+  SICONOS_FRICTION_3D_JACOBI_IPARAM_UPDATE_SCHEME =9,
+  /** index in iparam to store the number of consecutive iterations with
+      an increasing residual tolerated before the solver falls back on
+      sequential Gauss-Seidel sweeps */
+  SICONOS_FRICTION_3D_JACOBI_IPARAM_DIVERGENCE_LIMIT =10
+};
+
+enum SICONOS_FRICTION_3D_JACOBI_UPDATE_SCHEME_ENUM
+{
+  /** all contacts update from the snapshot taken at the beginning of the
+      iteration: perfectly parallel and deterministic */
+  SICONOS_FRICTION_3D_JACOBI_UPDATE_SYNCHRONOUS =0,
+  /** contacts update from the latest available reactions: maximum
+      throughput, the sweep result depends on the thread schedule */
+  SICONOS_FRICTION_3D_JACOBI_UPDATE_ASYNCHRONOUS =1
+};
+
+enum SICONOS_FRICTION_3D_JACOBI_DPARAM
+{
+  /** index in dparam to store the initial damping factor (same slot as
+      the NSGS relaxation value) */
+  SICONOS_FRICTION_3D_JACOBI_DPARAM_DAMPING =8,
+  /** index in dparam to store the lower bound of the adaptive damping */
+  SICONOS_FRICTION_3D_JACOBI_DPARAM_DAMPING_MIN =9
+};
+
 enum SICONOS_FRICTION_3D_NSGS_LOCALSOLVER_IPARAM
 {
   SICONOS_FRICTION_3D_NSGS_LOCALSOLVER_IPARAM_USE_TRIVIAL_SOLUTION=10
@@ -289,12 +373,20 @@ enum SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ENUM
   /** Evaluation of the error with the expensive function fc3d_compute_error and
       an adaptive frequency for calling the error function  **/
   SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ADAPTIVE =3,
+  /** Evaluation of the error by accumulating the natural-map residual of
+      each contact as it is relaxed during the sweep (the local velocity is
+      a by-product of the local solve): the quality of the full evaluation
+      at the cost of the light one **/
+  SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_NATURAL_MAP =4,
 };
 enum SICONOS_FRICTION_3D_NSGS_SHUFFLE_ENUM
 {
   SICONOS_FRICTION_3D_NSGS_SHUFFLE_FALSE=0,
   SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE=1,
-  SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP=2
+  SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP=2,
+  /** sweep the contacts in a reverse Cuthill-McKee ordering of the contact
+      graph, so that consecutive local solves touch neighbouring blocks of W */
+  SICONOS_FRICTION_3D_NSGS_SHUFFLE_RCM=3
 };
 
 enum SICONOS_FRICTION_3D_NSGS_RELAXATION_ENUM
@@ -332,7 +424,12 @@ enum SICONOS_FRICTION_3D_NSN_IPARAM
   /** index in iparam used to check if memory allocation has already be done (if true/1) or not (if 0/false) for internal work array. */
   SICONOS_FRICTION_3D_NSN_MEMORY_ALLOCATED= 17,
   /** index in iparam to store the boolean to know if allocation of dwork is needed */
-  SICONOS_FRICTION_3D_NSN_MPI_COM= 18
+  SICONOS_FRICTION_3D_NSN_MPI_COM= 18,
+  /** quasi-Newton: keep the Newton matrix and its factors for up to this
+      many iterations, correcting the solves with Broyden rank-1 updates;
+      the matrix is rebuilt as soon as convergence degrades. 0 (the
+      default) rebuilds every iteration. */
+  SICONOS_FRICTION_3D_NSN_QUASI_NEWTON_MAX_AGE = 19
 
 };
 
@@ -405,6 +502,11 @@ enum SICONOS_FRICTION_3D_PROXIMAL_IPARAM
   SICONOS_FRICTION_3D_PROXIMAL_IPARAM_RELAXATION = 8,
   /** index in iparam to store the proximal strategy*/
   SICONOS_FRICTION_3D_PROXIMAL_IPARAM_STRATEGY = 9,
+  /** index in iparam to drive the alpha update with the iteration count
+      of the internal solver: the regularization is relaxed slowly while
+      the inner solves are expensive and aggressively once they become
+      cheap (see fc3d_proximal) */
+  SICONOS_FRICTION_3D_PROXIMAL_IPARAM_ADAPTIVE_FROM_INNER = 10,
 };
 
 
@@ -455,7 +557,10 @@ enum SICONOS_FRICTION_3D_ADMM_DPARAM_ENUM
   /** index in dparam to store the tau value for the balancing residual technique */
   SICONOS_FRICTION_3D_ADMM_BALANCING_RESIDUAL_TAU = 5,
   /** index in dparam to store the phi value for the balancing residual technique */
-  SICONOS_FRICTION_3D_ADMM_BALANCING_RESIDUAL_PHI = 6
+  SICONOS_FRICTION_3D_ADMM_BALANCING_RESIDUAL_PHI = 6,
+  /** index in dparam to store the fraction of contacts that must ask for a
+   * new rho before the matrix is refactored (per-contact strategy only) */
+  SICONOS_FRICTION_3D_ADMM_BALANCING_REFACTOR_FRACTION = 7
 };
 
 enum SICONOS_FRICTION_3D_ADMM_ACCELERATION_ENUM
@@ -516,7 +621,11 @@ enum SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_ENUM
   /** An adaptive strategy for rho is used */
   SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_RESIDUAL_BALANCING =2,
   /** An adaptive strategy for rho is used */
-  SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING =3
+  SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING =3,
+  /** An adaptive strategy with one rho per contact is used; the
+   * factorization is redone only when enough contacts ask for a change
+   * (see dparam[SICONOS_FRICTION_3D_ADMM_BALANCING_REFACTOR_FRACTION]) */
+  SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING_PER_CONTACT =4
 };
 
 enum SICONOS_FRICTION_3D_ADMM_INITIAL_RHO_ENUM
@@ -535,7 +644,9 @@ enum SICONOS_FRICTION_3D_IPM_IPARAM_ENUM
   /** index in iparam to store the sparse storage parameter */
   SICONOS_FRICTION_3D_IPM_IPARAM_SPARSE_STORAGE= 12,
   /** index in iparam to get problem info */
-  SICONOS_FRICTION_3D_IPM_IPARAM_GET_PROBLEM_INFO= 13
+  SICONOS_FRICTION_3D_IPM_IPARAM_GET_PROBLEM_INFO= 13,
+  /** index in iparam to retain the solver state across calls (warm start) */
+  SICONOS_FRICTION_3D_IPM_IPARAM_WARM_START= 14
 
 };
 
@@ -564,5 +675,11 @@ enum SICONOS_FRICTION_3D_IPM_GET_PROBLEM_INFO_ENUM
   SICONOS_FRICTION_3D_IPM_GET_PROBLEM_INFO_YES= 1
 };
 
+enum SICONOS_FRICTION_3D_IPM_WARM_START_ENUM
+{
+  SICONOS_FRICTION_3D_IPM_WARM_START_NO= 0,
+  SICONOS_FRICTION_3D_IPM_WARM_START_YES= 1
+};
+
 
 #endif
@@ -92,10 +92,7 @@ void Projection_VI_GFC3D(void *viIn, double *x, double *PX)
 
   double * reaction = &PX[n];
 
-  for(int contact = 0 ; contact < gfc3d->numberOfContacts  ; ++contact)
-  {
-    projectionOnCone(&reaction[ contact * nLocal ], gfc3d->mu[contact]);
-  }
+  projectionOnCone_batch(gfc3d->numberOfContacts, reaction, gfc3d->mu);
   DEBUG_EXPR(NM_vector_display(PX, n+m));
   DEBUG_END("Projection_VI_FC3D(void *viIn, double *x, double *PX)\n");
 
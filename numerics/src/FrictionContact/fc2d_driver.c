@@ -113,8 +113,13 @@ int fc2d_driver(FrictionContactProblem* problem, double *reaction, double *veloc
     case SICONOS_FRICTION_2D_NSGS:
     {
       if(verbose)
-        printf(" ========================== Call NLGS solver for Friction-Contact 2D problem ==========================\n");
-      fc2d_nsgs_dense(problem, reaction, velocity, &info, options);
+        printf(" ========================== Call NSGS solver for Friction-Contact 2D problem ==========================\n");
+      /* the block NSGS handles dense storage too (diagonal block
+       * extraction and row products work on any storage) and brings
+       * contact freezing, the light error evaluations and warm
+       * starting; the historical fc2d_nsgs_dense is kept for direct
+       * callers only */
+      fc2d_nsgs(problem, reaction, velocity, &info, options);
       break;
     }
     /****** CPG algorithm ******/
@@ -20,6 +20,7 @@
 #include <math.h>                                         // for sqrt
 #include <stdio.h>                                        // for printf, fpr...
 #include <stdlib.h>                                       // for free, malloc
+#include "AndersonAcceleration.h"                         // for anderson_ac...
 #include "FrictionContactProblem.h"                       // for FrictionCon...
 #include "Friction_cst.h"                                 // for SICONOS_FRI...
 #include "NumericsFwd.h"                                  // for SolverOptions
@@ -120,6 +121,16 @@ void fc3d_ACLMFixedPoint(FrictionContactProblem* problem, double *reaction, doub
 
   double normUT;
   int cumul_iter =0;
+
+  /* Optional Anderson acceleration of the fixed-point map on the reaction */
+  AndersonAcceleration* aa = NULL;
+  double* reaction_k = NULL;
+  if(iparam[SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH] > 0)
+  {
+    aa = anderson_acceleration_new(nc * 3, iparam[SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH]);
+    reaction_k = (double *) malloc(nc * 3 * sizeof(double));
+  }
+
   while((iter < itermax) && (hasNotConverged > 0))
   {
     ++iter;
@@ -134,9 +145,13 @@ void fc3d_ACLMFixedPoint(FrictionContactProblem* problem, double *reaction, doub
 
     fc3d_set_internalsolver_tolerance(problem,options,internalsolver_options, error);
 
+    if(aa) cblas_dcopy(nc * 3, reaction, 1, reaction_k, 1);
 
     (*internalsolver)(soclcp, reaction, velocity, info, internalsolver_options);
     cumul_iter +=  internalsolver_options->iparam[SICONOS_IPARAM_ITER_DONE];
+
+    if(aa) anderson_acceleration_step(aa, reaction_k, reaction, reaction);
+
     /* **** Criterium convergence **** */
 
     fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q, &error);
@@ -158,6 +173,8 @@ void fc3d_ACLMFixedPoint(FrictionContactProblem* problem, double *reaction, doub
     printf("--------------- FC3D - ACLMFP - # Iteration %i Final Residual = %14.7e\n", iter, error);
     printf("--------------- FC3D - ACLMFP - #              internal iteration = %i\n", cumul_iter);
   }
+  anderson_acceleration_free(aa);
+  free(reaction_k);
   free(soclcp->q);
   free(soclcp->coneIndex);
   free(soclcp);
@@ -0,0 +1,183 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include <math.h>                         // for sqrt
+#include <stddef.h>                       // for NULL
+#include "fc3d_AlartCurnier_batch.h"
+#include "SiconosCpuFeatures.h"           // for SICONOS_SIMD_KERNEL
+/* #define DEBUG_STDOUT */
+/* #define DEBUG_MESSAGES */
+#include "siconos_debug.h"                // for DEBUG_PRINT
+
+/* This file is compiled once in the regular build (generic kernel and
+   public entry points) and, with WITH_SIMD_DISPATCH, once more per
+   instruction set with SICONOS_SIMD_VARIANT defined (suffixed kernel
+   only); see SiconosCpuFeatures.h. */
+
+#ifndef SICONOS_SIMD_VARIANT
+void fc3d_batch_gather3(unsigned int batch_size, const unsigned int* contacts,
+                        const double* source, double* batch)
+{
+  for(unsigned int i = 0; i < batch_size; ++i)
+  {
+    unsigned int contact = contacts[i];
+    batch[0 * batch_size + i] = source[contact * 3 + 0];
+    batch[1 * batch_size + i] = source[contact * 3 + 1];
+    batch[2 * batch_size + i] = source[contact * 3 + 2];
+  }
+}
+
+void fc3d_batch_scatter3(unsigned int batch_size, const unsigned int* contacts,
+                         const double* batch, double* destination)
+{
+  for(unsigned int i = 0; i < batch_size; ++i)
+  {
+    unsigned int contact = contacts[i];
+    destination[contact * 3 + 0] = batch[0 * batch_size + i];
+    destination[contact * 3 + 1] = batch[1 * batch_size + i];
+    destination[contact * 3 + 2] = batch[2 * batch_size + i];
+  }
+}
+#endif /* SICONOS_SIMD_VARIANT */
+
+/* Branchless transcription of computeAlartCurnierSTD (see
+   fc3d_AlartCurnier_functions.c); each condition of the scalar kernel
+   becomes a lane-wise select so that the loop vectorizes. */
+void SICONOS_SIMD_KERNEL(fc3d_AlartCurnierSTD_batch)(unsigned int batch_size,
+    const double* restrict reaction,
+    const double* restrict velocity,
+    const double* restrict mu,
+    const double* restrict rho,
+    double* restrict F,
+    double* restrict A,
+    double* restrict B)
+{
+  const double* RN = &reaction[0 * batch_size];
+  const double* RT = &reaction[1 * batch_size];
+  const double* RS = &reaction[2 * batch_size];
+  const double* UN = &velocity[0 * batch_size];
+  const double* UT = &velocity[1 * batch_size];
+  const double* US = &velocity[2 * batch_size];
+  const double* rhoN = &rho[0 * batch_size];
+  const double* rhoT = &rho[1 * batch_size];
+
+  for(unsigned int i = 0; i < batch_size; ++i)
+  {
+    double RVN = RN[i] - rhoN[i] * UN[i];
+    double RVT = RT[i] - rhoT[i] * UT[i];
+    double RVS = RS[i] - rhoT[i] * US[i];
+    double RV2 = RVT * RVT + RVS * RVS;
+    double RV = sqrt(RV2);
+
+    int inside_cone = RVN > 0.0;
+    double Radius = inside_cone ? mu[i] * RVN : 0.0;
+    int stick = RV <= Radius;          /* Radius > 0 on the stick branch */
+    int slip = (!stick) && (Radius > 0.0);
+
+    F[0 * batch_size + i] = inside_cone ? rhoN[i] * UN[i] : RN[i];
+
+    /* 1/RV is only consumed on the slip branch; keep it finite elsewhere. */
+    double RV1 = slip ? 1.0 / RV : 0.0;
+    double RV3 = RV1 * RV1 * RV1;
+
+    F[1 * batch_size + i] = stick ? rhoT[i] * UT[i]
+                            : (slip ? RT[i] - Radius * RVT * RV1 : RT[i]);
+    F[2 * batch_size + i] = stick ? rhoT[i] * US[i]
+                            : (slip ? RS[i] - Radius * RVS * RV1 : RS[i]);
+
+    if(A && B)
+    {
+      double GammaTT = RV1 - RVT * RVT * RV3;
+      double GammaTS = -RVT * RVS * RV3;
+      double GammaSS = RV1 - RVS * RVS * RV3;
+
+      /* Blocks are stored column-major (slot = row + 3 * column), the
+         op3x3.h convention used by computeAlartCurnierSTD. */
+      A[0 * batch_size + i] = inside_cone ? rhoN[i] : 0.0; /* A00 */
+      A[1 * batch_size + i] = slip ? mu[i] * rhoN[i] * RVT * RV1 : 0.0; /* A10 */
+      A[2 * batch_size + i] = slip ? mu[i] * rhoN[i] * RVS * RV1 : 0.0; /* A20 */
+      A[3 * batch_size + i] = 0.0;                         /* A01 */
+      A[4 * batch_size + i] = stick ? rhoT[i]
+                              : (slip ? GammaTT * rhoT[i] * Radius : 0.0); /* A11 */
+      A[5 * batch_size + i] = slip ? GammaTS * rhoT[i] * Radius : 0.0;     /* A21 */
+      A[6 * batch_size + i] = 0.0;                         /* A02 */
+      A[7 * batch_size + i] = slip ? GammaTS * rhoT[i] * Radius : 0.0;     /* A12 */
+      A[8 * batch_size + i] = stick ? rhoT[i]
+                              : (slip ? GammaSS * rhoT[i] * Radius : 0.0); /* A22 */
+
+      B[0 * batch_size + i] = inside_cone ? 0.0 : 1.0;     /* B00 */
+      B[1 * batch_size + i] = slip ? -mu[i] * RVT * RV1 : 0.0;             /* B10 */
+      B[2 * batch_size + i] = slip ? -mu[i] * RVS * RV1 : 0.0;             /* B20 */
+      B[3 * batch_size + i] = 0.0;                         /* B01 */
+      B[4 * batch_size + i] = stick ? 0.0
+                              : (slip ? 1.0 - GammaTT * Radius : 1.0);     /* B11 */
+      B[5 * batch_size + i] = slip ? -GammaTS * Radius : 0.0;              /* B21 */
+      B[6 * batch_size + i] = 0.0;                         /* B02 */
+      B[7 * batch_size + i] = slip ? -GammaTS * Radius : 0.0;              /* B12 */
+      B[8 * batch_size + i] = stick ? 0.0
+                              : (slip ? 1.0 - GammaSS * Radius : 1.0);     /* B22 */
+    }
+  }
+}
+
+#ifndef SICONOS_SIMD_VARIANT
+
+typedef void (*fc3d_AlartCurnierSTD_batch_fn)(unsigned int,
+    const double* restrict, const double* restrict, const double* restrict,
+    const double* restrict, double* restrict, double* restrict, double* restrict);
+
+#ifdef SICONOS_HAS_AVX2_KERNELS
+void fc3d_AlartCurnierSTD_batch_avx2(unsigned int batch_size,
+    const double* restrict reaction, const double* restrict velocity,
+    const double* restrict mu, const double* restrict rho,
+    double* restrict F, double* restrict A, double* restrict B);
+#endif
+#ifdef SICONOS_HAS_AVX512_KERNELS
+void fc3d_AlartCurnierSTD_batch_avx512(unsigned int batch_size,
+    const double* restrict reaction, const double* restrict velocity,
+    const double* restrict mu, const double* restrict rho,
+    double* restrict F, double* restrict A, double* restrict B);
+#endif
+
+void fc3d_AlartCurnierSTD_batch(unsigned int batch_size,
+                                const double* restrict reaction,
+                                const double* restrict velocity,
+                                const double* restrict mu,
+                                const double* restrict rho,
+                                double* restrict F,
+                                double* restrict A,
+                                double* restrict B)
+{
+  /* benign race: every thread resolves the same variant */
+  static fc3d_AlartCurnierSTD_batch_fn kernel = NULL;
+  if(!kernel)
+  {
+    fc3d_AlartCurnierSTD_batch_fn selected = &fc3d_AlartCurnierSTD_batch_generic;
+#ifdef SICONOS_HAS_AVX2_KERNELS
+    if(siconos_simd_level() >= SICONOS_SIMD_AVX2)
+      selected = &fc3d_AlartCurnierSTD_batch_avx2;
+#endif
+#ifdef SICONOS_HAS_AVX512_KERNELS
+    if(siconos_simd_level() >= SICONOS_SIMD_AVX512)
+      selected = &fc3d_AlartCurnierSTD_batch_avx512;
+#endif
+    kernel = selected;
+  }
+  (*kernel)(batch_size, reaction, velocity, mu, rho, F, A, B);
+}
+
+#endif /* SICONOS_SIMD_VARIANT */
@@ -0,0 +1,88 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef FRICTIONCONTACT3D_AlartCurnier_batch_H
+#define FRICTIONCONTACT3D_AlartCurnier_batch_H
+
+/*!\file fc3d_AlartCurnier_batch.h
+
+  Batched, structure-of-arrays evaluation of the Alart-Curnier function
+  and its gradients for several contacts at once.
+
+  The classic per-contact kernels of fc3d_AlartCurnier_functions.h work
+  on interleaved 3-vectors; the memory layout prevents the compiler from
+  vectorizing across contacts.  The routines below operate on
+  component-major buffers where component c of contact i is stored at
+  buffer[c * batch_size + i].  The branchless inner loops are written so
+  that the compiler can emit SIMD selects (AVX2/AVX-512 when enabled at
+  build time) without any hand-written intrinsics.
+
+ */
+#include "NumericsFwd.h"  // for FrictionContactProblem
+#include "SiconosConfig.h" // for BUILD_AS_CPP // IWYU pragma: keep
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** Gather interleaved per-contact 3-vectors into a component-major batch
+      buffer.
+      \param batch_size number of contacts in the batch
+      \param contacts indices of the contacts to gather
+      \param source interleaved array (size 3 * number of contacts)
+      \param batch component-major output buffer (size 3 * batch_size)
+  */
+  void fc3d_batch_gather3(unsigned int batch_size, const unsigned int* contacts,
+                          const double* source, double* batch);
+
+  /** Scatter a component-major batch buffer back into an interleaved
+      per-contact array; inverse of fc3d_batch_gather3().
+      \param batch_size number of contacts in the batch
+      \param contacts indices of the contacts to scatter
+      \param batch component-major input buffer (size 3 * batch_size)
+      \param destination interleaved array (size 3 * number of contacts)
+  */
+  void fc3d_batch_scatter3(unsigned int batch_size, const unsigned int* contacts,
+                           const double* batch, double* destination);
+
+  /** Evaluate the Alart-Curnier function (standard form) and its gradients
+      for a whole batch of contacts.
+      \param batch_size number of contacts in the batch
+      \param reaction component-major reactions (size 3 * batch_size)
+      \param velocity component-major velocities (size 3 * batch_size)
+      \param mu friction coefficients (size batch_size)
+      \param rho component-major rho parameters (size 3 * batch_size)
+      \param[out] F value of the function (size 3 * batch_size), component-major
+      \param[out] A gradient w.r.t velocity (size 9 * batch_size), entry (r,c)
+      of contact i at A[(r + 3*c) * batch_size + i] (column-major slots, as
+      computeAlartCurnierSTD); may be NULL together with B
+      \param[out] B gradient w.r.t reaction, same layout as A; may be NULL
+      together with A
+  */
+  void fc3d_AlartCurnierSTD_batch(unsigned int batch_size,
+                                  const double* reaction,
+                                  const double* velocity,
+                                  const double* mu,
+                                  const double* rho,
+                                  double* F, double* A, double* B);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
@@ -26,9 +26,35 @@
 #include "fc3d_Solvers.h"            // for fc3d_DeSaxceFixedPoint, fc3d_DeS...
 #include "fc3d_compute_error.h"      // for fc3d_compute_error
 #include "numerics_verbose.h"        // for verbose, numerics_error
-#include "projectionOnCone.h"        // for projectionOnCone
+#include "projectionOnCone.h"        // for projectionOnCone_SoA
 #include "SiconosBlas.h"                   // for cblas_dcopy, cblas_dnrm2
 
+/* One De Saxce fixed point step over all contacts in structure-of-arrays
+   form, r <- P_K(r - rho (u + mu ||u_T|| e_N)): the interleaved vectors are
+   gathered into component-major buffers so that the correction and the cone
+   projections vectorize across contacts. work is a scratch buffer of
+   6 * nc doubles. */
+static void deSaxceProjection_SoA(int nc, double rho, const double* mu,
+                                  const double* velocity, double* reaction,
+                                  double* work)
+{
+  double* u = work;
+  double* r = &work[3 * nc];
+  frictionContact_AoS_to_SoA(nc, velocity, u);
+  frictionContact_AoS_to_SoA(nc, reaction, r);
+  const double* ut1 = &u[nc];
+  const double* ut2 = &u[2 * nc];
+  for(int i = 0; i < nc; ++i)
+  {
+    double normUT = sqrt(ut1[i] * ut1[i] + ut2[i] * ut2[i]);
+    r[i] -= rho * (u[i] + mu[i] * normUT);
+    r[nc + i] -= rho * ut1[i];
+    r[2 * nc + i] -= rho * ut2[i];
+  }
+  projectionOnCone_SoA(nc, r, &r[nc], &r[2 * nc], mu);
+  frictionContact_SoA_to_AoS(nc, r, reaction);
+}
+
 void fc3d_DeSaxceFixedPoint(FrictionContactProblem* problem, double *reaction, double *velocity, int* info, SolverOptions* options)
 {
   /* int and double parameters */
@@ -51,9 +77,8 @@ void fc3d_DeSaxceFixedPoint(FrictionContactProblem* problem, double *reaction, d
   int iter = 0; /* Current iteration number */
   double error = 1.; /* Current error */
   int hasNotConverged = 1;
-  int contact; /* Number of the current row of blocks in M */
-  int nLocal = 3;
   double * velocitytmp = (double *)calloc(n, sizeof(double));
+  double * soa_work = (double *)calloc(2 * n, sizeof(double));
 
   double rho = 0.0;
 
@@ -84,16 +109,8 @@ void fc3d_DeSaxceFixedPoint(FrictionContactProblem* problem, double *reaction, d
     beta = 1.0;
     NM_gemv(alpha, M, reaction, beta, velocitytmp);
 
-    /* projection for each contact */
-    for(contact = 0 ; contact < nc ; ++contact)
-    {
-      int pos = contact * nLocal;
-      double  normUT = sqrt(velocitytmp[pos + 1] * velocitytmp[pos + 1] + velocitytmp[pos + 2] * velocitytmp[pos + 2]);
-      reaction[pos] -= rho * (velocitytmp[pos] + mu[contact] * normUT);
-      reaction[pos + 1] -= rho * velocitytmp[pos + 1];
-      reaction[pos + 2] -= rho * velocitytmp[pos + 2];
-      projectionOnCone(&reaction[pos], mu[contact]);
-    }
+    /* projection for each contact, vectorized on the SoA layout */
+    deSaxceProjection_SoA(nc, rho, mu, velocitytmp, reaction, soa_work);
 
     /* **** Criterium convergence **** */
     fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q, &error);
@@ -119,6 +136,7 @@ void fc3d_DeSaxceFixedPoint(FrictionContactProblem* problem, double *reaction, d
   iparam[SICONOS_IPARAM_ITER_DONE] = iter;
   dparam[SICONOS_DPARAM_RESIDU] = error;
   free(velocitytmp);
+  free(soa_work);
 
 }
 
@@ -29,9 +29,35 @@
 #include "fc3d_Solvers.h"            // for fc3d_ExtraGradient, fc3d_ExtraGr...
 #include "fc3d_compute_error.h"      // for fc3d_compute_error
 #include "numerics_verbose.h"        // for verbose
-#include "projectionOnCone.h"        // for projectionOnCone
+#include "projectionOnCone.h"        // for projectionOnCone_SoA
 #include "SiconosBlas.h"                   // for cblas_dcopy, cblas_dnrm2, cblas_...
 
+/* One projected gradient step over all contacts in structure-of-arrays form,
+   r <- P_K(r - rho (u + mu ||u_T|| e_N)): the interleaved vectors are
+   gathered into component-major buffers so that the correction and the cone
+   projections vectorize across contacts. work is a scratch buffer of
+   6 * nc doubles. */
+static void deSaxceProjection_SoA(int nc, double rho, const double* mu,
+                                  const double* velocity, double* reaction,
+                                  double* work)
+{
+  double* u = work;
+  double* r = &work[3 * nc];
+  frictionContact_AoS_to_SoA(nc, velocity, u);
+  frictionContact_AoS_to_SoA(nc, reaction, r);
+  const double* ut1 = &u[nc];
+  const double* ut2 = &u[2 * nc];
+  for(int i = 0; i < nc; ++i)
+  {
+    double normUT = sqrt(ut1[i] * ut1[i] + ut2[i] * ut2[i]);
+    r[i] -= rho * (u[i] + mu[i] * normUT);
+    r[nc + i] -= rho * ut1[i];
+    r[2 * nc + i] -= rho * ut2[i];
+  }
+  projectionOnCone_SoA(nc, r, &r[nc], &r[2 * nc], mu);
+  frictionContact_SoA_to_AoS(nc, r, reaction);
+}
+
 void fc3d_ExtraGradient(FrictionContactProblem* problem, double *reaction, double *velocity, int* info, SolverOptions* options)
 {
   /* int and double parameters */
@@ -62,6 +88,7 @@ void fc3d_ExtraGradient(FrictionContactProblem* problem, double *reaction, doubl
 
   double * velocitytmp = (double *)calloc(n,sizeof(double));
   double * reactiontmp = (double *)calloc(n,sizeof(double));
+  double * soa_work = (double *)calloc(2 * n,sizeof(double));
 
   double rho = 0.0, rho_k =0.0;
   int isVariable = 0;
@@ -120,28 +147,12 @@ void fc3d_ExtraGradient(FrictionContactProblem* problem, double *reaction, doubl
 
 
       NM_gemv(alpha, M, reactiontmp, beta, velocitytmp);
-      // projection for each contact
-      for(contact = 0 ; contact < nc ; ++contact)
-      {
-        int pos = contact * nLocal;
-        double  normUT = sqrt(velocitytmp[pos + 1] * velocitytmp[pos + 1] + velocitytmp[pos + 2] * velocitytmp[pos + 2]);
-        reactiontmp[pos] -= rho * (velocitytmp[pos] + mu[contact] * normUT);
-        reactiontmp[pos + 1] -= rho * velocitytmp[pos + 1];
-        reactiontmp[pos + 2] -= rho * velocitytmp[pos + 2];
-        projectionOnCone(&reactiontmp[pos], mu[contact]);
-      }
+      // projection for each contact, vectorized on the SoA layout
+      deSaxceProjection_SoA(nc, rho, mu, velocitytmp, reactiontmp, soa_work);
       cblas_dcopy(n, q, 1, velocitytmp, 1);
       NM_gemv(alpha, M, reactiontmp, beta, velocitytmp);
-      // projection for each contact
-      for(contact = 0 ; contact < nc ; ++contact)
-      {
-        int pos = contact * nLocal;
-        double  normUT = sqrt(velocitytmp[pos + 1] * velocitytmp[pos + 1] + velocitytmp[pos + 2] * velocitytmp[pos + 2]);
-        reaction[pos] -= rho * (velocitytmp[pos] + mu[contact] * normUT);
-        reaction[pos + 1] -= rho * velocitytmp[pos + 1];
-        reaction[pos + 2] -= rho * velocitytmp[pos + 2];
-        projectionOnCone(&reaction[pos], mu[contact]);
-      }
+      // projection for each contact, vectorized on the SoA layout
+      deSaxceProjection_SoA(nc, rho, mu, velocitytmp, reaction, soa_work);
 
       /* **** Criterium convergence **** */
       fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q, &error);
@@ -189,20 +200,8 @@ void fc3d_ExtraGradient(FrictionContactProblem* problem, double *reaction, doubl
 
         rho_k = rho * pow(tau,ls_iter);
 
-        /* projection for each contact */
-        for(contact = 0 ; contact < nc ; ++contact)
-        {
-          int pos = contact * nLocal;
-          double  normUT = sqrt(velocity_k[pos + 1] * velocity_k[pos + 1] + velocity_k[pos + 2] * velocity_k[pos + 2]);
-          /* reaction[pos] = reaction_k[pos] -  rho_k * (velocity_k[pos] + mu[contact] * normUT); */
-          /* reaction[pos + 1] = reaction_k[pos+1] - rho_k * velocity_k[pos + 1]; */
-          /* reaction[pos + 2] = reaction_k[pos+2] - rho_k * velocity_k[pos + 2]; */
-
-          reaction[pos] -= rho_k * (velocity_k[pos] + mu[contact] * normUT);
-          reaction[pos + 1] -= rho_k * velocity_k[pos + 1];
-          reaction[pos + 2] -= rho_k * velocity_k[pos + 2];
-          projectionOnCone(&reaction[pos], mu[contact]);
-        }
+        /* projection for each contact, vectorized on the SoA layout */
+        deSaxceProjection_SoA(nc, rho_k, mu, velocity_k, reaction, soa_work);
 
 
         /* velocity <- q + M * reaction  */
@@ -265,20 +264,8 @@ void fc3d_ExtraGradient(FrictionContactProblem* problem, double *reaction, doubl
       cblas_dcopy(n, q, 1, velocitytmp, 1);
       NM_gemv(alpha, M, reaction, beta, velocitytmp);
 
-      // projection for each contact
-      for(contact = 0 ; contact < nc ; ++contact)
-      {
-        int pos = contact * nLocal;
-        double  normUT = sqrt(velocitytmp[pos + 1] * velocitytmp[pos + 1] +
-                              velocitytmp[pos + 2] * velocitytmp[pos + 2]);
-        reaction[pos] -= rho_k * (velocitytmp[pos] + mu[contact] * normUT);
-        reaction[pos + 1] -= rho_k * velocitytmp[pos + 1];
-        reaction[pos + 2] -= rho_k * velocitytmp[pos + 2];
-        /* reaction[pos] = reaction_k[pos] -  rho_k * (velocitytmp[pos] + mu[contact] * normUT); */
-        /* reaction[pos + 1] = reaction_k[pos+1] - rho_k * velocitytmp[pos + 1]; */
-        /* reaction[pos + 2] = reaction_k[pos+2] - rho_k * velocitytmp[pos + 2]; */
-        projectionOnCone(&reaction[pos], mu[contact]);
-      }
+      // projection for each contact, vectorized on the SoA layout
+      deSaxceProjection_SoA(nc, rho_k, mu, velocitytmp, reaction, soa_work);
       DEBUG_EXPR_WE(for(int i =0; i< 5 ; i++)
     {
       printf("reaction[%i]=%12.8e\t",i,reaction[i]);
@@ -319,6 +306,7 @@ void fc3d_ExtraGradient(FrictionContactProblem* problem, double *reaction, doubl
   iparam[SICONOS_IPARAM_ITER_DONE] = iter;
   free(velocitytmp);
   free(reactiontmp);
+  free(soa_work);
   if(isVariable)
   {
     free(reaction_k);
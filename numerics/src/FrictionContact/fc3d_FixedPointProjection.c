@@ -19,6 +19,7 @@
 #include <math.h>                    // for sqrt, pow
 #include <stdio.h>                   // for printf, NULL
 #include <stdlib.h>                  // for calloc, free, malloc
+#include "AndersonAcceleration.h"    // for anderson_acceleration_step
 #include "FrictionContactProblem.h"  // for FrictionContactProblem
 #include "Friction_cst.h"            // for SICONOS_FRICTION_3D_FPP
 #include "NumericsFwd.h"             // for SolverOptions, FrictionContactPr...
@@ -30,9 +31,35 @@
 #include "fc3d_Solvers.h"            // for fc3d_fixedPointProjection, fc3d_...
 #include "fc3d_compute_error.h"      // for fc3d_compute_error
 #include "numerics_verbose.h"        // for verbose
-#include "projectionOnCone.h"        // for projectionOnCone
+#include "projectionOnCone.h"        // for projectionOnCone_SoA
 #include "SiconosBlas.h"                   // for cblas_dcopy, cblas_dnrm2, cblas_...
 
+/* One projected fixed point step over all contacts in structure-of-arrays
+   form, r <- P_K(r - rho (u + mu ||u_T|| e_N)): the interleaved vectors are
+   gathered into component-major buffers so that the correction and the cone
+   projections vectorize across contacts. work is a scratch buffer of
+   6 * nc doubles. */
+static void deSaxceProjection_SoA(int nc, double rho, const double* mu,
+                                  const double* velocity, double* reaction,
+                                  double* work)
+{
+  double* u = work;
+  double* r = &work[3 * nc];
+  frictionContact_AoS_to_SoA(nc, velocity, u);
+  frictionContact_AoS_to_SoA(nc, reaction, r);
+  const double* ut1 = &u[nc];
+  const double* ut2 = &u[2 * nc];
+  for(int i = 0; i < nc; ++i)
+  {
+    double normUT = sqrt(ut1[i] * ut1[i] + ut2[i] * ut2[i]);
+    r[i] -= rho * (u[i] + mu[i] * normUT);
+    r[nc + i] -= rho * ut1[i];
+    r[2 * nc + i] -= rho * ut2[i];
+  }
+  projectionOnCone_SoA(nc, r, &r[nc], &r[2 * nc], mu);
+  frictionContact_SoA_to_AoS(nc, r, reaction);
+}
+
 void fc3d_fixedPointProjection(FrictionContactProblem* problem, double *reaction, double *velocity, int* info, SolverOptions* options)
 {
   /* int and double parameters */
@@ -58,6 +85,7 @@ void fc3d_fixedPointProjection(FrictionContactProblem* problem, double *reaction
   int contact; /* Number of the current row of blocks in M */
   int nLocal = 3;
   double * velocitytmp = (double *)malloc(n * sizeof(double));
+  double * soa_work = (double *)malloc(2 * n * sizeof(double));
 
 
   double rho = 0.0, rho_k =0.0;
@@ -104,6 +132,13 @@ void fc3d_fixedPointProjection(FrictionContactProblem* problem, double *reaction
 
 
 
+  /* Optional Anderson acceleration of the projected fixed-point map; the
+     mixed iterate leaves the cone in general, so it is projected back
+     before the residual check */
+  AndersonAcceleration* aa = NULL;
+  if(iparam[SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH] > 0)
+    aa = anderson_acceleration_new(n, iparam[SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH]);
+
   // Compute new rho if variable
   if(isVariable)
   {
@@ -133,21 +168,8 @@ void fc3d_fixedPointProjection(FrictionContactProblem* problem, double *reaction
 
 
 
-        /* projection for each contact */
-        for(contact = 0 ; contact < nc ; ++contact)
-        {
-          int pos = contact * nLocal;
-          double  normUT = sqrt(velocity_k[pos + 1] * velocity_k[pos + 1] + velocity_k[pos + 2] * velocity_k[pos + 2]);
-          /* reaction[pos] = reaction_k[pos] -  rho_k * (velocity_k[pos] + mu[contact] * normUT); */
-          /* reaction[pos + 1] = reaction_k[pos+1] - rho_k * velocity_k[pos + 1]; */
-          /* reaction[pos + 2] = reaction_k[pos+2] - rho_k * velocity_k[pos + 2]; */
-
-          reaction[pos] -= rho_k * (velocity_k[pos] + mu[contact] * normUT);
-          reaction[pos + 1] -= rho_k * velocity_k[pos + 1];
-          reaction[pos + 2] -= rho_k * velocity_k[pos + 2];
-
-          projectionOnCone(&reaction[pos], mu[contact]);
-        }
+        /* projection for each contact, vectorized on the SoA layout */
+        deSaxceProjection_SoA(nc, rho_k, mu, velocity_k, reaction, soa_work);
 
 
         /* velocity <- q + M * reaction  */
@@ -208,6 +230,12 @@ void fc3d_fixedPointProjection(FrictionContactProblem* problem, double *reaction
                    );
 
 
+      if(aa && anderson_acceleration_step(aa, reaction_k, reaction, reaction))
+      {
+        for(contact = 0 ; contact < nc ; ++contact)
+          projectionOnCone(&reaction[contact * nLocal], mu[contact]);
+      }
+
       /* **** Criterium convergence **** */
       fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q, &error);
       DEBUG_EXPR_WE(
@@ -241,7 +269,9 @@ void fc3d_fixedPointProjection(FrictionContactProblem* problem, double *reaction
     printf("--------------- FC3D - Fixed Point Projection (FPP) - #Iteration %i Final Residual = %14.7e\n", iter, error);
   iparam[SICONOS_IPARAM_ITER_DONE] = iter;
   dparam[SICONOS_DPARAM_RESIDU] = error;
+  anderson_acceleration_free(aa);
   free(velocitytmp);
+  free(soa_work);
   free(reaction_k);
   free(velocity_k);
   free(reactiontmp);
@@ -111,8 +111,8 @@ void fc3d_HyperplaneProjection(FrictionContactProblem* problem, double *reaction
       reactiontmp[pos] -= rho * (velocitytmp[pos] + mu[contact] * normUT);
       reactiontmp[pos + 1] -= rho * velocitytmp[pos + 1];
       reactiontmp[pos + 2] -= rho * velocitytmp[pos + 2];
-      projectionOnCone(&reactiontmp[pos], mu[contact]);
     }
+    projectionOnCone_batch(nc, reactiontmp, mu);
 
     // Armijo line search
 
@@ -175,11 +175,7 @@ void fc3d_HyperplaneProjection(FrictionContactProblem* problem, double *reaction
 
 
     // projection for each contact
-    for(contact = 0 ; contact < nc ; ++contact)
-    {
-      int pos = contact * nLocal;
-      projectionOnCone(&reaction[pos], mu[contact]);
-    }
+    projectionOnCone_batch(nc, reaction, mu);
 
     /* **** Criterium convergence **** */
     fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q, &error);
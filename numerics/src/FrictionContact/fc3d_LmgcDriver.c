@@ -17,6 +17,7 @@
 */
 #include <stdio.h>                   // for fprintf, fclose, fopen, printf
 #include <stdlib.h>                  // for free, malloc
+#include <string.h>                  // for memcpy
 #include "FrictionContactProblem.h"  // for frictionContactProblem_new_with_...
 #include "Friction_cst.h"            // for SICONOS_FRICTION_3D_IPARAM_ERROR...
 #include "NonSmoothDrivers.h"        // for fc3d_driver, fc3d_LmgcDriver
@@ -231,3 +232,119 @@ int fc3d_LmgcDriver(double *reaction,
 
   return info;
 }
+
+/* ================= persistent coupling session =================
+ *
+ * fc3d_LmgcDriver rebuilds the whole SparseBlockMatrix structure and
+ * the solver options at every call; in a co-simulation loop calling
+ * the driver at every step of the external code, the rebuild overhead
+ * dominates the solve for small steps. The session keeps everything
+ * with a per-call lifetime in the driver alive across the calls:
+ * structure and blocks of W (the session owns a copy of the values,
+ * so the caller may reuse its buffers), solver options and, through
+ * SICONOS_IPARAM_PREALLOC, the internal workspaces of the solver. */
+
+struct fc3d_lmgc_session
+{
+  unsigned int nc;                 /* number of contacts */
+  unsigned int nb;                 /* number of 3x3 blocks of W */
+  double* values;                  /* session-owned blocks, registration order */
+  SparseBlockCoordinateMatrix* MC; /* registered structure (0-based indices) */
+  SparseBlockStructuredMatrix* M;
+  NumericsMatrix* NM;
+  FrictionContactProblem* FC;
+  SolverOptions* options;
+};
+
+fc3d_lmgc_session* fc3d_LmgcDriver_session_create(unsigned int nc,
+                                                  unsigned int nb,
+                                                  unsigned int *row,
+                                                  unsigned int *column,
+                                                  double *W,
+                                                  double *mu,
+                                                  int solver_id,
+                                                  double tolerance,
+                                                  int itermax)
+{
+  fc3d_lmgc_session* session =
+    (fc3d_lmgc_session*)malloc(sizeof(fc3d_lmgc_session));
+  session->nc = nc;
+  session->nb = nb;
+  session->values = (double*)malloc(nb * 9 * sizeof(double));
+  memcpy(session->values, W, nb * 9 * sizeof(double));
+
+  /* same construction as fc3d_LmgcDriver, once; the SBM blocks point
+     into the session-owned value array, so value updates need no
+     structural work at all */
+  session->MC = SBCM_new_3x3(nc, nc, nb, row, column, session->values);
+  session->M = SBCM_to_SBM(session->MC);
+  session->NM = NM_new_SBM(nc * 3, nc * 3, session->M);
+  session->FC = frictionContactProblem_new_with_data(3, nc, session->NM,
+                                                     NULL, mu);
+
+  session->options = solver_options_create(solver_id);
+  if(solver_id == SICONOS_FRICTION_3D_NSGS)
+  {
+    session->options->iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] = SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_WITH_FULL_FINAL;
+  }
+  else if(solver_id == SICONOS_FRICTION_3D_NSN_AC)
+  {
+    session->options->iparam[SICONOS_FRICTION_3D_NSN_LINESEARCH] = SICONOS_FRICTION_3D_NSN_LINESEARCH_NO;
+    session->options->iparam[SICONOS_FRICTION_3D_NSN_HYBRID_STRATEGY] = SICONOS_FRICTION_3D_NSN_HYBRID_STRATEGY_VI_EG_NSN;
+  }
+  session->options->dparam[SICONOS_DPARAM_TOL] = tolerance;
+  session->options->iparam[SICONOS_IPARAM_MAX_ITER] = itermax;
+  /* keep the solver workspaces alive across the calls of the session */
+  session->options->iparam[SICONOS_IPARAM_PREALLOC] = 1;
+
+  return session;
+}
+
+int fc3d_LmgcDriver_session_solve(fc3d_lmgc_session* session,
+                                  double *reaction,
+                                  double *velocity,
+                                  double *q,
+                                  const double *W,
+                                  const unsigned char *changed_rows)
+{
+  if(W)
+  {
+    if(changed_rows)
+    {
+      /* MC->row holds the 0-based block row of each registered block */
+      const unsigned int* brow = session->MC->row;
+      for(unsigned int k = 0; k < session->nb; ++k)
+        if(changed_rows[brow[k] / 8] & (unsigned char)(1 << (brow[k] % 8)))
+          memcpy(&session->values[9 * k], &W[9 * k], 9 * sizeof(double));
+    }
+    else
+      memcpy(session->values, W, session->nb * 9 * sizeof(double));
+
+    /* derived sparse storages (triplet, csc, ...) built by a previous
+       solve are stale now; the block storage itself is up to date */
+    NM_clearSparseStorage(session->NM);
+  }
+
+  session->FC->q = q;
+  return fc3d_driver(session->FC, reaction, velocity, session->options);
+}
+
+void fc3d_LmgcDriver_session_destroy(fc3d_lmgc_session* session)
+{
+  if(!session) return;
+
+  /* same teardown as fc3d_LmgcDriver */
+  SBCM_free_3x3(session->MC);
+  free(session->M->index1_data);
+  free(session->M->index2_data);
+  free(session->M->block);
+  free(session->M);
+  free(session->FC);
+  solver_options_delete(session->options);
+  free(session->options);
+  NM_clearSparseStorage(session->NM);
+  free(session->NM);
+  free(session->MC);
+  free(session->values);
+  free(session);
+}
@@ -88,6 +88,9 @@ extern "C" {
     (2) : only light error computation (velocity not computed)
     SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ADAPTIVE (3) :  we adapt the
     frequency of the full erro evaluation.
+    SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_NATURAL_MAP (4) :
+    natural-map residual accumulated contact by contact during the sweep
+    (full-quality error at light cost, velocity not computed)
 
     [in] iparam[SICONOS_FRICTION_3D_NSGS_FILTER_LOCAL_SOLUTION(14)] : filter
     local solution if the local error is greater than 1.0
@@ -131,6 +134,120 @@ void fc3d_nsgs_initialize_local_solver(SolverPtr *solve, UpdatePtr *update,
                                        FrictionContactProblem *localproblem,
                                        SolverOptions *options);
 
+/**
+    Non-Smooth Gauss Seidel solver with multi-color parallel sweeps for
+    friction-contact 3D problem.
+
+    The contact graph derived from the sparse block structure of W is
+    colored greedily so that contacts of the same color class do not
+    interact and can be relaxed concurrently (with OpenMP when available).
+    When W is dense or not stored as sparse block, the solver falls back
+    on the sequential fc3d_nsgs() sweep. The options are those of
+    fc3d_nsgs().
+
+    \param problem the friction-contact 3D problem to solve
+    \param velocity global vector (n), in-out parameter
+    \param reaction global vector (n), in-out parameters
+    \param info return 0 if the solution is found
+    \param options the solver options
+*/
+void fc3d_nsgs_multicolor(FrictionContactProblem *problem, double *reaction,
+                          double *velocity, int *info, SolverOptions *options);
+
+/**
+    Greedy coloring of the contact graph read off the sparse block structure
+    of W : two contacts are adjacent whenever an off-diagonal block couples
+    them (in either direction, the pattern is symmetrized on the fly). Only
+    the block pattern matters, so the coloring serves both the 3D and the
+    rolling multi-color NSGS sweeps.
+
+    \param W the sparse block structure of the Delassus matrix
+    \param nc the number of contacts
+    \param[out] colors the color of each contact (size nc)
+    \return the number of colors, or 0 when the graph is too dense for
+    coloring to pay off
+*/
+unsigned int fc_nsgs_multicolor_coloring(const SparseBlockStructuredMatrix *W,
+                                         unsigned int nc, unsigned int *colors);
+
+/**
+    Damped Jacobi / asynchronous block iteration for friction-contact 3D
+    problem.
+
+    Unlike the Gauss-Seidel sweeps, the contacts of one iteration have no
+    sequential dependency: in the synchronous scheme they all update from
+    the snapshot taken at the beginning of the iteration (perfectly
+    parallel and deterministic), in the asynchronous scheme they read the
+    latest available reactions (maximum throughput, schedule-dependent).
+    The new reactions are blended with the previous iterate by an
+    adaptive damping factor: the damping shrinks when the residual grows
+    and relaxes back towards 1 otherwise. After
+    SICONOS_FRICTION_3D_JACOBI_IPARAM_DIVERGENCE_LIMIT consecutive
+    iterations with an increasing residual, the solver falls back on
+    sequential fc3d_nsgs() sweeps with the remaining iteration budget.
+    The internal (one contact) solver options are those of fc3d_nsgs().
+
+    \param problem the friction-contact 3D problem to solve
+    \param velocity global vector (n), in-out parameter
+    \param reaction global vector (n), in-out parameters
+    \param info return 0 if the solution is found
+    \param options the solver options
+*/
+void fc3d_jacobi(FrictionContactProblem *problem, double *reaction,
+                 double *velocity, int *info, SolverOptions *options);
+
+/** set default options for the damped Jacobi solver
+    \param options the solver options
+*/
+void fc3d_jacobi_set_default(SolverOptions *options);
+
+/**
+    Island decomposition solver for friction-contact 3D problem.
+
+    The connected components (islands) of the sparse block structure of W
+    are extracted with a union-find pass; each island yields an independent
+    sub-problem that is handed to the internal solver (NSGS by default),
+    concurrently over islands when OpenMP is available. Reactions and
+    velocities are scattered back into the global vectors afterwards. When
+    W is dense or there is a single island, the internal solver is called
+    on the full problem.
+
+    \param problem the friction-contact 3D problem to solve
+    \param velocity global vector (n), in-out parameter
+    \param reaction global vector (n), in-out parameters
+    \param info return 0 if the solution is found
+    \param options the solver options
+*/
+void fc3d_islands(FrictionContactProblem *problem, double *reaction,
+                  double *velocity, int *info, SolverOptions *options);
+
+/** set default options for the island decomposition solver
+    \param options the solver options
+*/
+void fc3d_islands_set_default(SolverOptions *options);
+
+/** Presolve reduction: screen the contacts whose normal part of q is
+    positive (opening under zero reaction), solve the reduced problem of
+    the remaining contacts with the internal solver (the reduced W is a
+    set of views into the sparse block storage of the full W), scatter
+    zeros back for the eliminated contacts and post-check the full
+    problem error; if the post-check fails, the full problem is solved,
+    warm-started from the reduced solution.
+
+    \param problem the friction-contact 3D problem to solve
+    \param velocity global vector (n), in-out parameter
+    \param reaction global vector (n), in-out parameters
+    \param info return 0 if the solution is found
+    \param options the solver options
+*/
+void fc3d_reduced(FrictionContactProblem *problem, double *reaction,
+                  double *velocity, int *info, SolverOptions *options);
+
+/** set default options for the presolve reduction solver
+    \param options the solver options
+*/
+void fc3d_reduced_set_default(SolverOptions *options);
+
 void fc3d_admm(FrictionContactProblem *problem, double *reaction,
                double *velocity, int *info, SolverOptions *options);
 
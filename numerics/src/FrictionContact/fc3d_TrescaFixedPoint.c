@@ -19,6 +19,7 @@
 #include <math.h>                    // for fmax
 #include <stdio.h>                   // for printf, NULL
 #include <stdlib.h>                  // for malloc
+#include "AndersonAcceleration.h"    // for anderson_acceleration_step
 #include "FrictionContactProblem.h"  // for FrictionContactProblem
 #include "Friction_cst.h"            // for SICONOS_FRICTION_3D_NSGS, SICONO...
 #include "NumericsFwd.h"             // for SolverOptions, FrictionContactPr...
@@ -92,6 +93,15 @@ void fc3d_TrescaFixedPoint(FrictionContactProblem* problem, double *reaction, do
 
   int cumul_internal=0;
 
+  /* Optional Anderson acceleration of the fixed-point map on the reaction */
+  AndersonAcceleration* aa = NULL;
+  double* reaction_k = NULL;
+  if(iparam[SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH] > 0)
+  {
+    aa = anderson_acceleration_new(nc * 3, iparam[SICONOS_FRICTION_3D_FP_IPARAM_ANDERSON_DEPTH]);
+    reaction_k = (double *) malloc(nc * 3 * sizeof(double));
+  }
+
   while((iter < itermax) && (hasNotConverged > 0))
   {
     ++iter;
@@ -104,10 +114,14 @@ void fc3d_TrescaFixedPoint(FrictionContactProblem* problem, double *reaction, do
 
     fc3d_set_internalsolver_tolerance(problem,options,internalsolver_options, error);
 
+    if(aa) cblas_dcopy(nc * 3, reaction, 1, reaction_k, 1);
+
     (*internalsolver)(problem, reaction, velocity, info, internalsolver_options);
 
     cumul_internal += internalsolver_options->iparam[SICONOS_IPARAM_ITER_DONE];
 
+    if(aa) anderson_acceleration_step(aa, reaction_k, reaction, reaction);
+
     /* **** Criterium convergence **** */
 
     fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q,  &error);
@@ -134,6 +148,8 @@ void fc3d_TrescaFixedPoint(FrictionContactProblem* problem, double *reaction, do
       }
     }
   }
+  anderson_acceleration_free(aa);
+  free(reaction_k);
   mu = NULL;
   internalsolver_options->dWork = NULL;
   dparam[SICONOS_DPARAM_RESIDU] = error;
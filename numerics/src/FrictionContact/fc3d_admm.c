@@ -25,7 +25,10 @@
 #include "Friction_cst.h"            // for SICONOS_FRICTION_3D_ADMM_IPARAM_...
 #include "NumericsFwd.h"             // for SolverOptions, FrictionContactPr...
 #include "NumericsMatrix.h"          // for NM_gemv, NM_clear, NM_copy, NM_new
+#include "NumericsArena.h"           // for numerics_arena_calloc, numerics_...
+#include "NumericsDataVersion.h"     // for NDV_value, version_t
 #include "NumericsSparseMatrix.h"    // for NSM_diag_indices
+#include "SparseBlockMatrix.h"       // for SparseBlockStructuredMatrix
 #include "SolverOptions.h"           // for SolverOptions, SICONOS_DPARAM_TOL
 /* #define DEBUG_NOCOLOR */
 /* #define DEBUG_STDOUT */
@@ -41,6 +44,16 @@ const char* const   SICONOS_FRICTION_3D_ADMM_STR = "FC3D ADMM";
 
 typedef struct
 {
+  NumericsArena * arena; /* region holding all the vectors below */
+
+  NumericsMatrix * W;    /* cached M + rho*I, with the factors computed by
+                            the linear solver; reused across calls while M
+                            keeps the same NumericsDataVersion and rho is
+                            unchanged */
+  version_t W_version;   /* version of M folded into W */
+  double W_rho;          /* value of rho folded into W */
+  int W_valid;           /* 1 when W (and its factors) match W_version/W_rho */
+
   double * xi;
   double * xi_k;
   double * xi_hat;
@@ -56,6 +69,22 @@ Fc3d_ADMM_data;
 /** pointer to function used to call local solver */
 typedef int (*LinearSolverPtr)(NumericsMatrix *M, double *b, unsigned int nrhs);
 
+/* comparable version of the storage of M, whatever its type */
+static version_t fc3d_admm_M_version(NumericsMatrix* M)
+{
+  switch(M->storageType)
+  {
+  case NM_DENSE:
+    return NDV_value(&M->version);
+  case NM_SPARSE_BLOCK:
+    return NDV_value(&M->matrix1->version);
+  case NM_SPARSE:
+    return NSM_max_version(M->matrix2);
+  default:
+    return 0;
+  }
+}
+
 
 
 void fc3d_admm_init(FrictionContactProblem* problem, SolverOptions* options)
@@ -74,25 +103,34 @@ void fc3d_admm_init(FrictionContactProblem* problem, SolverOptions* options)
     nb_constraints =2*m;
   }
 
+  /* all the workspace vectors live in one solver-scoped region, released
+     in a single shot by fc3d_admm_free */
+  data->arena = numerics_arena_new((7 * nb_constraints + m) * sizeof(double));
+
+  data->W = NULL;
+  data->W_version = 0;
+  data->W_rho = 0.0;
+  data->W_valid = 0;
+
   if(options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_ACCELERATION] == SICONOS_FRICTION_3D_ADMM_ACCELERATION ||
       options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_ACCELERATION] == SICONOS_FRICTION_3D_ADMM_ACCELERATION_AND_RESTART||
       options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_ACCELERATION] == SICONOS_FRICTION_3D_ADMM_NO_ACCELERATION)
   {
 
-    data->xi_hat = (double*)calloc(nb_constraints,sizeof(double));
-    data->xi = (double*)calloc(nb_constraints,sizeof(double));
-    data->xi_k = (double*)calloc(nb_constraints,sizeof(double));
+    data->xi_hat = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
+    data->xi = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
+    data->xi_k = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
 
-    data->z_hat = (double*)calloc(nb_constraints,sizeof(double));
-    data->z = (double*)calloc(nb_constraints,sizeof(double));
-    data->z_k = (double*)calloc(nb_constraints,sizeof(double));
-    data->q = (double*)calloc(m,sizeof(double));
+    data->z_hat = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
+    data->z = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
+    data->z_k = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
+    data->q = (double*)numerics_arena_calloc(data->arena, m, sizeof(double));
   }
 
   if(options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_SYMMETRY] == SICONOS_FRICTION_3D_ADMM_FORCED_ASYMMETRY||
       options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_SYMMETRY] == SICONOS_FRICTION_3D_ADMM_CHECK_SYMMETRY)
   {
-    data->b = (double*)calloc(nb_constraints,sizeof(double));
+    data->b = (double*)numerics_arena_calloc(data->arena, nb_constraints, sizeof(double));
     if(!options->dWork || options->dWorkSize != 2*m)
     {
       options->dWork = (double*)calloc(2*m,sizeof(double));
@@ -117,14 +155,13 @@ void fc3d_admm_free(FrictionContactProblem* problem, SolverOptions* options)
   if(options->solverData)
   {
     Fc3d_ADMM_data * data = (Fc3d_ADMM_data *)options->solverData;
-    free(data->xi);
-    free(data->xi_hat);
-    free(data->z_hat);
-    free(data->xi_k);
-    free(data->z_k);
-    free(data->z);
-    free(data->q);
-    free(data->b);
+    /* the vectors all belong to the arena */
+    numerics_arena_free(data->arena);
+    if(data->W)
+    {
+      NM_clear(data->W);
+      free(data->W);
+    }
     free(data);
   }
   options->solverData = NULL;
@@ -188,8 +225,8 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
     printf("norm_q (rescaled) = %e\n", norm_q);
   }
 
-  /* Compute M + rho I (storage in W)*/
-  NumericsMatrix *W = NM_new();
+  /* Compute M + rho I (storage in W, cached in the solver data) */
+  NumericsMatrix *W = NULL;
 
 
   /*****  ADMM iterations *****/
@@ -211,6 +248,25 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
 
   Fc3d_ADMM_data * data = (Fc3d_ADMM_data *)options->solverData;
 
+  /* W = M + rho*I and the factors computed lazily by the linear solver are
+     cached across calls; they are reused as long as M is unchanged (same
+     NumericsDataVersion) and rho is kept. Rescaled or storage-converted
+     copies of M get a fresh version each call, so only problem->M is
+     eligible. When the cache hits, we also keep the previous rho rather
+     than re-estimating it, precisely to preserve the factors. */
+  int use_cache = (M == problem->M);
+  version_t M_version = fc3d_admm_M_version(M);
+  int has_rho_changed = 1;
+  if(use_cache && data->W && data->W_valid
+      && data->W_version == M_version)
+  {
+    rho = data->W_rho;
+    has_rho_changed = 0;
+    numerics_printf_verbose(2, "fc3d_admm. W cache hit, factors reused (rho = %5.2e)", rho);
+  }
+  if(!data->W) data->W = NM_new();
+  W = data->W;
+  data->W_valid = 0; /* revalidated on the way out */
 
   /* we use velocity as a tmp */
   double * tmp = velocity;
@@ -242,7 +298,6 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
   int pos;
   double normUT;
   rho_k=rho;
-  int has_rho_changed = 1;
 
   while((iter < itermax) && (hasNotConverged > 0))
   {
@@ -255,6 +310,8 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
       /* W= NM_new(); */
       NM_copy(M,W);
       NM_add_to_diag3(W, rho);
+      data->W_version = M_version;
+      data->W_rho = rho;
     }
 
     /********************/
@@ -313,11 +370,7 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
     DEBUG_PRINT("Before projection :");
     DEBUG_EXPR(NV_display(z,m));
 
-    /* Loop through the contact points */
-    for(contact = 0 ; contact < nc ; ++contact)
-    {
-      projectionOnCone(&z[contact * 3], mu[contact]);
-    }
+    projectionOnCone_batch(nc, z, mu);
     DEBUG_PRINT("After projection :");
     DEBUG_EXPR(NV_display(z,m));
 
@@ -483,6 +536,8 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
       stopping_criterion =1;
 
 
+    solver_options_stats_push(options, iter, residual, rho, -1);
+
     numerics_printf_verbose(1,"---- FC3D - ADMM  - Iteration %i rho = %14.7e, residual = %14.7e, tol = %14.7e", iter, rho, residual, tolerance);
     numerics_printf_verbose(1,"---- FC3D - ADMM  -                            primal residual = %14.7e, epsilon_primal = %14.7e", r,  epsilon_primal);
     numerics_printf_verbose(1,"---- FC3D - ADMM  -                            dual residual = %14.7e, epsilon_dual = %14.7e", s,  epsilon_dual);
@@ -531,7 +586,16 @@ static void fc3d_admm_symmetric(FrictionContactProblem* restrict problem,
     }
     numerics_printf_verbose(1,"---- FC3D - ADMM  - Iteration %i rho = %14.7e \t full error = %14.7e", iter, rho, error);
   }
-  NM_clear(W);
+  if(use_cache)
+  {
+    /* keep W and its factors for the next call; W_version/W_rho record
+       what is actually folded into W */
+    data->W_valid = 1;
+  }
+  else
+  {
+    NM_clear(W);
+  }
   dparam[SICONOS_DPARAM_RESIDU] = error;
   iparam[SICONOS_IPARAM_ITER_DONE] = iter;
 }
@@ -736,10 +800,7 @@ static void fc3d_admm_asymmetric(FrictionContactProblem* restrict problem,
     {
       projectionOnDualCone(&z[contact * 3], mu[contact]);
     }
-    for(contact = 0 ; contact < nc ; ++contact)
-    {
-      projectionOnCone(&z[contact * 3+m], mu[contact]);
-    }
+    projectionOnCone_batch(nc, &z[m], mu);
 
     DEBUG_PRINT("After projection :");
     DEBUG_EXPR(NV_display(z,2*m));
@@ -917,6 +978,8 @@ static void fc3d_admm_asymmetric(FrictionContactProblem* restrict problem,
     if(fabs(norm_q) > DBL_EPSILON)
       residual /= norm_q;
 
+    solver_options_stats_push(options, iter, residual, rho, -1);
+
     numerics_printf_verbose(1,"---- FC3D - ADMM  - Iteration %i rho = %14.7e, residual = %14.7e, tol = %14.7e", iter, rho, residual, tolerance);
 
     /* 4-1 basic stopping criterion */
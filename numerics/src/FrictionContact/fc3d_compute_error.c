@@ -24,7 +24,9 @@
 #include <stddef.h>                  // for NULL
 #include "FrictionContactProblem.h"  // for FrictionContactProblem
 #include "NumericsMatrix.h"          // for NM_prod_mv_3x3, NM_gemv
+#include "SparseBlockMatrix.h"       // for SparseBlockStructuredMatrix
 #include "SolverOptions.h"           // for SolverOptions
+#include "op3x3.h"                   // for mvp3x3
 /* #define DEBUG_NOCOLOR */
 /* #define DEBUG_STDOUT */
 /* #define DEBUG_MESSAGES */
@@ -64,18 +66,40 @@ int fc3d_compute_error(
   assert(problem);
   assert(z);
   assert(w);
-  assert(error);
 
   /* Computes w = Mz + q */
   int incx = 1, incy = 1;
-  int nc = problem->numberOfContacts;
-  int n = nc * 3;
-  double *mu = problem->mu;
+  int n = problem->numberOfContacts * 3;
 
   /* Compute the current velocity */
   cblas_dcopy(n, problem->q, incx, w, incy);     // w <-q
   NM_prod_mv_3x3(n, n, problem->M, z, w); // w = Mz +q
 
+  int result = fc3d_compute_error_incremental(problem, z, w, tolerance,
+                                              options, norm, error);
+  DEBUG_END("fc3d_compute_error(...)\n");
+  return result;
+}
+
+/* Number of contacts whose modified velocities are projected at once in
+   fc3d_compute_error_incremental. Small enough to stay in L1. */
+#define FC3D_ERROR_TILE 64
+
+int fc3d_compute_error_incremental(
+  FrictionContactProblem* problem,
+  double *z, double *w, double tolerance,
+  SolverOptions * options, double norm, double * error)
+{
+  DEBUG_BEGIN("fc3d_compute_error_incremental(...)\n");
+  assert(problem);
+  assert(z);
+  assert(w);
+  assert(error);
+
+  int nc = problem->numberOfContacts;
+  int n = nc * 3;
+  double *mu = problem->mu;
+
   DEBUG_PRINTF("norm of the reaction %e\n", cblas_dnrm2(n, z, 1));
   DEBUG_PRINTF("norm of the velocity %e\n", cblas_dnrm2(n, w, 1));
   DEBUG_PRINTF("norm of q = %12.8e\n", norm);
@@ -84,12 +108,34 @@ int fc3d_compute_error(
   /* DEBUG_EXPR(NV_display(z,n);); */
 
   *error = 0.;
-  int ic, ic3;
-  double worktmp[3];
-  for(ic = 0, ic3 = 0 ; ic < nc ; ic++, ic3 += 3)
+  /* Tiled version of the per-contact loop over
+     fc3d_unitary_compute_and_add_error: building the modified local
+     velocities for a slice of contacts first lets the projection
+     vectorize across cones instead of branching on each one. */
+  double worktmp[3 * FC3D_ERROR_TILE];
+  for(int ic0 = 0 ; ic0 < nc ; ic0 += FC3D_ERROR_TILE)
   {
-    fc3d_unitary_compute_and_add_error(z + ic3, w + ic3, mu[ic], error, worktmp);
-    /*DEBUG_PRINTF("absolute error = %12.8e contact =%i nc= %i\n", *error, ic, nc);*/
+    int t = nc - ic0 < FC3D_ERROR_TILE ? nc - ic0 : FC3D_ERROR_TILE;
+    int base = 3 * ic0;
+    for(int i = 0 ; i < t ; ++i)
+    {
+      int i3 = 3 * i;
+      int ic3 = base + i3;
+      worktmp[i3] = z[ic3] - w[ic3]
+                    - mu[ic0 + i] * sqrt(w[ic3 + 1] * w[ic3 + 1] + w[ic3 + 2] * w[ic3 + 2]);
+      worktmp[i3 + 1] = z[ic3 + 1] - w[ic3 + 1];
+      worktmp[i3 + 2] = z[ic3 + 2] - w[ic3 + 2];
+    }
+    projectionOnCone_batch(t, worktmp, &mu[ic0]);
+    for(int i = 0 ; i < t ; ++i)
+    {
+      int i3 = 3 * i;
+      int ic3 = base + i3;
+      double e0 = z[ic3] - worktmp[i3];
+      double e1 = z[ic3 + 1] - worktmp[i3 + 1];
+      double e2 = z[ic3 + 2] - worktmp[i3 + 2];
+      *error += e0 * e0 + e1 * e1 + e2 * e2;
+    }
   }
   *error = sqrt(*error);
   DEBUG_PRINTF("absolute error in complementarity = %12.8e\n", *error);
@@ -105,13 +151,53 @@ int fc3d_compute_error(
     *error /= relative_scaling;
 
   DEBUG_PRINTF("relative error in complementarity = %12.8e\n", *error);
-  DEBUG_END("fc3d_compute_error(...)\n");
+  DEBUG_END("fc3d_compute_error_incremental(...)\n");
   if(*error > tolerance)
     return 1;
 
   return 0;
 }
 
+int fc3d_velocity_rank3_update(
+  FrictionContactProblem* problem, int contact,
+  const double* dr, double *w)
+{
+  NumericsMatrix* M = problem->M;
+
+  if(M->storageType == NM_SPARSE_BLOCK && M->matrix1)
+  {
+    SparseBlockStructuredMatrix* W = M->matrix1;
+    /* the blocks of column `contact` are located through the rows of the
+       (structurally symmetric) pattern of W: block (j, contact) exists iff
+       block (contact, j) does */
+    for(size_t blockNum = W->index1_data[contact];
+        blockNum < W->index1_data[contact + 1]; ++blockNum)
+    {
+      size_t j = W->index2_data[blockNum];
+      for(size_t bn = W->index1_data[j]; bn < W->index1_data[j + 1]; ++bn)
+      {
+        if(W->index2_data[bn] == (size_t)contact)
+        {
+          mvp3x3(W->block[bn], dr, &w[3 * j]);
+          break;
+        }
+      }
+    }
+    return 0;
+  }
+  else if(M->storageType == NM_DENSE && M->matrix0)
+  {
+    int n = 3 * problem->numberOfContacts;
+    for(int c = 0; c < 3; ++c)
+      if(dr[c] != 0.0)
+        cblas_daxpy(n, dr[c], &M->matrix0[(3 * contact + c) * n], 1, w, 1);
+    return 0;
+  }
+
+  /* unsupported storage: the caller has to fall back on a full product */
+  return 1;
+}
+
 
 
 int fc3d_compute_error_velocity(FrictionContactProblem* problem, double *z, double *w, double tolerance,
@@ -46,7 +46,40 @@ extern "C"
    */
   int fc3d_compute_error(FrictionContactProblem* problem, double *z , double *w, double tolerance, SolverOptions * options, double norm, double * error);
 
-  /** 
+  /**
+      Incremental variant of fc3d_compute_error: the velocity w is NOT
+      recomputed, the caller is responsible for maintaining w = Mz + q
+      (for instance with fc3d_velocity_rank3_update() after each local
+      reaction change), so the full product Mz is avoided.
+
+      \param problem the structure which defines the friction-contact problem
+      \param z vector
+      \param w vector, assumed up to date with z
+      \param tolerance value for error computation
+      \param options
+      \param norm norm of a vector (problem->q) for relative error
+      \param[in,out] error value
+      \return 0 if ok
+   */
+  int fc3d_compute_error_incremental(FrictionContactProblem* problem, double *z , double *w, double tolerance, SolverOptions * options, double norm, double * error);
+
+  /**
+      Rank-3 update of the velocity w = Mz + q after the reaction of one
+      contact has changed by dr: w += M[:, 3 contact .. 3 contact + 2] dr,
+      touching only the rows coupled to the contact (O(nnz of the column
+      blocks) for a sparse block matrix with a structurally symmetric
+      pattern).
+
+      \param problem the structure which defines the friction-contact problem
+      \param contact the index of the contact whose reaction changed
+      \param dr the change of the reaction of the contact (3 doubles)
+      \param[in,out] w the maintained velocity
+      \return 0 if ok, 1 if the storage of M does not support column access
+      (the caller then has to recompute w with a full product)
+   */
+  int fc3d_velocity_rank3_update(FrictionContactProblem* problem, int contact, const double* dr, double *w);
+
+  /**
       Error computation (using the normal map residual) for one friction-contact 3D problem
       
       \param r the reaction force
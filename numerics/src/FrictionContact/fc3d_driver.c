@@ -18,6 +18,7 @@
 #include <assert.h>                                    // for assert
 #include <float.h>                                     // for DBL_EPSILON
 #include <stdio.h>                                     // for NULL
+#include <stdlib.h>                                    // for malloc, qsort
 #include <string.h>                                     // for NULL
 #include "FrictionContactProblem.h"                    // for FrictionContac...
 #include "Friction_cst.h"                              // for SICONOS_FRICTI...
@@ -32,9 +33,19 @@
 #include "fc3d_projection.h"                           // for fc3d_projectio...
 #include "fc3d_unitary_enumerative.h"                  // for fc3d_unitary_e...
 #include "numerics_verbose.h"                          // for numerics_printf
+#include "NumericsPerfCounters.h"                       // for perf_counters_b...
+#include "NumericsTrace.h"                             // for SN_TRACE
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 const char* const   SICONOS_FRICTION_3D_NSGS_STR = "FC3D_NSGS";
 const char* const   SICONOS_FRICTION_3D_NSGSV_STR = "FC3D_NSGSV";
+const char* const   SICONOS_FRICTION_3D_NSGS_MULTICOLOR_STR = "FC3D_NSGS_MULTICOLOR";
+const char* const   SICONOS_FRICTION_3D_JACOBI_STR = "FC3D_JACOBI";
+const char* const   SICONOS_FRICTION_3D_ISLANDS_STR = "FC3D_ISLANDS";
+const char* const   SICONOS_FRICTION_3D_REDUCED_STR = "FC3D_REDUCED";
 const char* const   SICONOS_FRICTION_3D_TFP_STR = "FC3D_TFP";
 const char* const   SICONOS_FRICTION_3D_PFP_STR = "FC3D_PFP";
 const char* const   SICONOS_FRICTION_3D_NSN_AC_STR = "FC3D_NSN_AC";
@@ -93,6 +104,13 @@ int fc3d_driver(FrictionContactProblem* problem,
   if(problem->dimension != 3)
     numerics_error("fc3d_driver", "Dimension of the problem : problem-> dimension is not compatible or is not set");
 
+  PerfCountersHandle perf_handle;
+  int collect_perf = options->stats && options->stats->collect_perf;
+  if(collect_perf) perf_counters_begin(&perf_handle);
+
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_BEGIN, 0,
+           (double)problem->numberOfContacts);
+
   /* Check for trivial case */
   info = fc3d_checkTrivialCase(problem, velocity, reaction, options);
   if(info == 0)
@@ -121,6 +139,34 @@ int fc3d_driver(FrictionContactProblem* problem,
     fc3d_nsgs_velocity(problem, reaction, velocity, &info, options);
     break;
   }
+  /* Non Smooth Gauss Seidel with multi-color parallel sweeps */
+  case SICONOS_FRICTION_3D_NSGS_MULTICOLOR:
+  {
+    numerics_printf(" ========================== Call NSGS MULTICOLOR solver for Friction-Contact 3D problem ==========================\n");
+    fc3d_nsgs_multicolor(problem, reaction, velocity, &info, options);
+    break;
+  }
+  /* Damped Jacobi / asynchronous block iteration */
+  case SICONOS_FRICTION_3D_JACOBI:
+  {
+    numerics_printf(" ========================== Call JACOBI solver for Friction-Contact 3D problem ==========================\n");
+    fc3d_jacobi(problem, reaction, velocity, &info, options);
+    break;
+  }
+  /* Island decomposition */
+  case SICONOS_FRICTION_3D_ISLANDS:
+  {
+    numerics_printf(" ========================== Call ISLANDS solver for Friction-Contact 3D problem ==========================\n");
+    fc3d_islands(problem, reaction, velocity, &info, options);
+    break;
+  }
+  /* Inactive contact elimination */
+  case SICONOS_FRICTION_3D_REDUCED:
+  {
+    numerics_printf(" ========================== Call REDUCED solver for Friction-Contact 3D problem ==========================\n");
+    fc3d_reduced(problem, reaction, velocity, &info, options);
+    break;
+  }
   /* ADMM*/
   case SICONOS_FRICTION_3D_ADMM:
   {
@@ -295,10 +341,114 @@ int fc3d_driver(FrictionContactProblem* problem,
   }
 
 exit:
+  if(collect_perf) perf_counters_end(&perf_handle, &options->stats->perf);
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_END,
+           options->iparam[SICONOS_IPARAM_ITER_DONE],
+           options->dparam[SICONOS_DPARAM_RESIDU]);
   return info;
 
 }
 
+/* size-sorted ordering of the batch: largest problems first, so that
+   with dynamic scheduling the long solves start early and the small
+   islands fill the tail */
+typedef struct
+{
+  int nc;
+  unsigned int idx;
+} fc3d_batch_entry;
+
+static int fc3d_batch_compare(const void* a, const void* b)
+{
+  const fc3d_batch_entry* ea = (const fc3d_batch_entry*)a;
+  const fc3d_batch_entry* eb = (const fc3d_batch_entry*)b;
+  if(eb->nc != ea->nc) return eb->nc - ea->nc;
+  /* stable tie-break on the original position */
+  return (ea->idx > eb->idx) - (ea->idx < eb->idx);
+}
+
+int fc3d_driver_batch(FrictionContactProblem** problems, unsigned int nproblems,
+                      double** reactions, double** velocities,
+                      int* infos, SolverOptions* options)
+{
+  if(options == NULL)
+    numerics_error("fc3d_driver_batch", "null input for solver options");
+
+  assert(options->isSet);
+
+  if(nproblems == 0) return 0;
+
+  /* validate once for the whole batch */
+  for(unsigned int p = 0; p < nproblems; ++p)
+    if(problems[p]->dimension != 3)
+      numerics_error("fc3d_driver_batch", "Dimension of the problem : problem-> dimension is not compatible or is not set");
+
+  if(verbose > 1)
+    solver_options_print(options);
+
+  fc3d_batch_entry* order =
+    (fc3d_batch_entry*) malloc(nproblems * sizeof(fc3d_batch_entry));
+  for(unsigned int p = 0; p < nproblems; ++p)
+  {
+    order[p].nc = problems[p]->numberOfContacts;
+    order[p].idx = p;
+  }
+  qsort(order, nproblems, sizeof(fc3d_batch_entry), &fc3d_batch_compare);
+
+  int nthreads = 1;
+#if defined(_OPENMP)
+  nthreads = omp_get_max_threads();
+#endif
+
+  /* one private copy of the options per worker: the solver workspaces
+     (dWork/iWork, internal solver state) allocated on a copy are reused
+     across all the problems that worker picks up, instead of being
+     rebuilt per call */
+  SolverOptions** worker_options =
+    (SolverOptions**) malloc(nthreads * sizeof(SolverOptions*));
+  worker_options[0] = options;
+  for(int t = 1; t < nthreads; ++t)
+    worker_options[t] = solver_options_copy(options);
+
+  int max_info = 0;
+  double max_residu = 0.0;
+  int max_iter_done = 0;
+
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(dynamic) \
+    reduction(max:max_info) reduction(max:max_residu) reduction(max:max_iter_done)
+#endif
+  for(unsigned int p = 0; p < nproblems; ++p)
+  {
+    unsigned int idx = order[p].idx;
+#if defined(_OPENMP)
+    SolverOptions* opts = worker_options[omp_get_thread_num()];
+#else
+    SolverOptions* opts = worker_options[0];
+#endif
+    int info = fc3d_driver(problems[idx], reactions[idx], velocities[idx], opts);
+    infos[idx] = info;
+
+    if(info > max_info) max_info = info;
+    if(opts->dparam[SICONOS_DPARAM_RESIDU] > max_residu)
+      max_residu = opts->dparam[SICONOS_DPARAM_RESIDU];
+    if(opts->iparam[SICONOS_IPARAM_ITER_DONE] > max_iter_done)
+      max_iter_done = opts->iparam[SICONOS_IPARAM_ITER_DONE];
+  }
+
+  for(int t = 1; t < nthreads; ++t)
+  {
+    solver_options_delete(worker_options[t]);
+    free(worker_options[t]);
+  }
+  free(worker_options);
+  free(order);
+
+  options->dparam[SICONOS_DPARAM_RESIDU] = max_residu;
+  options->iparam[SICONOS_IPARAM_ITER_DONE] = max_iter_done;
+  return max_info;
+}
+
 int fc3d_checkTrivialCase(FrictionContactProblem* problem, double* velocity,
                           double* reaction, SolverOptions* options)
 {
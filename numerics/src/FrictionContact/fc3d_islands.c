@@ -0,0 +1,288 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>                  // for assert
+#include <stdio.h>                   // for NULL
+#include <stdlib.h>                  // for calloc, malloc, free
+#include <string.h>                  // for memcpy
+#include "FrictionContactProblem.h"  // for FrictionContactProblem
+#include "Friction_cst.h"            // for SICONOS_FRICTION_3D_ISLANDS
+#include "NonSmoothDrivers.h"        // for fc3d_driver
+#include "NumericsFwd.h"             // for SolverOptions
+#include "NumericsMatrix.h"          // for NumericsMatrix, NM_new
+#include "SolverOptions.h"           // for SolverOptions, solver_options_copy
+#include "SparseBlockMatrix.h"       // for SparseBlockStructuredMatrix
+#include "fc3d_Solvers.h"            // for fc3d_islands
+#include "numerics_verbose.h"        // for numerics_printf
+/* #define DEBUG_STDOUT */
+/* #define DEBUG_MESSAGES */
+#include "siconos_debug.h"           // for DEBUG_PRINTF
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Union-find over contacts, used to collect the connected components
+   (islands) of the block structure of W. */
+static unsigned int islands_find(unsigned int* parent, unsigned int i)
+{
+  while(parent[i] != i)
+  {
+    parent[i] = parent[parent[i]]; /* path halving */
+    i = parent[i];
+  }
+  return i;
+}
+
+static void islands_union(unsigned int* parent, unsigned int i, unsigned int j)
+{
+  unsigned int ri = islands_find(parent, i);
+  unsigned int rj = islands_find(parent, j);
+  if(ri != rj) parent[rj] = ri;
+}
+
+/* Build the sub-problem of an island. The local W shares the block payloads
+   of the global one (only the index arrays are remapped), so the sub-problem
+   must be released with fc3d_islands_free_subproblem and never with
+   frictionContactProblem_free. contacts lists the nci global contact indices
+   of the island, global_to_local inverts it. */
+static FrictionContactProblem* fc3d_islands_extract_subproblem(
+  FrictionContactProblem* problem,
+  const unsigned int* contacts, unsigned int nci,
+  const unsigned int* global_to_local)
+{
+  SparseBlockStructuredMatrix* W = problem->M->matrix1;
+
+  SparseBlockStructuredMatrix* subW = SBM_new();
+  subW->blocknumber0 = nci;
+  subW->blocknumber1 = nci;
+  subW->blocksize0 = (unsigned int*) malloc(nci * sizeof(unsigned int));
+  subW->blocksize1 = subW->blocksize0;
+  for(unsigned int r = 0; r < nci; ++r) subW->blocksize0[r] = 3 * (r + 1);
+
+  /* an island is closed under adjacency: every block of a row of the island
+     has its column inside the island too */
+  size_t nblocks = 0;
+  for(unsigned int r = 0; r < nci; ++r)
+    nblocks += W->index1_data[contacts[r] + 1] - W->index1_data[contacts[r]];
+
+  subW->nbblocks = nblocks;
+  subW->filled1 = nci + 1;
+  subW->filled2 = nblocks;
+  subW->index1_data = (size_t*) malloc((nci + 1) * sizeof(size_t));
+  subW->index2_data = (size_t*) malloc(nblocks * sizeof(size_t));
+  subW->block = (double**) malloc(nblocks * sizeof(double*));
+
+  size_t pos = 0;
+  subW->index1_data[0] = 0;
+  for(unsigned int r = 0; r < nci; ++r)
+  {
+    unsigned int g = contacts[r];
+    for(size_t blockNum = W->index1_data[g];
+        blockNum < W->index1_data[g + 1]; ++blockNum)
+    {
+      subW->index2_data[pos] = global_to_local[W->index2_data[blockNum]];
+      subW->block[pos] = W->block[blockNum];
+      ++pos;
+    }
+    subW->index1_data[r + 1] = pos;
+  }
+
+  NumericsMatrix* subM = NM_new();
+  subM->storageType = NM_SPARSE_BLOCK;
+  subM->size0 = 3 * (int)nci;
+  subM->size1 = 3 * (int)nci;
+  subM->matrix1 = subW;
+
+  FrictionContactProblem* subproblem =
+    (FrictionContactProblem*) malloc(sizeof(FrictionContactProblem));
+  subproblem->dimension = problem->dimension;
+  subproblem->numberOfContacts = (int)nci;
+  subproblem->M = subM;
+  subproblem->q = (double*) malloc(3 * nci * sizeof(double));
+  subproblem->mu = (double*) malloc(nci * sizeof(double));
+  for(unsigned int r = 0; r < nci; ++r)
+  {
+    memcpy(&subproblem->q[3 * r], &problem->q[3 * contacts[r]], 3 * sizeof(double));
+    subproblem->mu[r] = problem->mu[contacts[r]];
+  }
+  return subproblem;
+}
+
+static void fc3d_islands_free_subproblem(FrictionContactProblem* subproblem)
+{
+  SparseBlockStructuredMatrix* subW = subproblem->M->matrix1;
+  /* the block payloads belong to the global W */
+  free(subW->block);
+  free(subW->index1_data);
+  free(subW->index2_data);
+  free(subW->blocksize0);
+  free(subW);
+  subproblem->M->matrix1 = NULL;
+  NM_clear(subproblem->M);
+  free(subproblem->M);
+  free(subproblem->q);
+  free(subproblem->mu);
+  free(subproblem);
+}
+
+void fc3d_islands(FrictionContactProblem* problem, double* reaction,
+                  double* velocity, int* info, SolverOptions* options)
+{
+  assert(options->numberOfInternalSolvers == 1);
+  SolverOptions* inner_options = options->internalSolvers[0];
+  unsigned int nc = problem->numberOfContacts;
+
+  if(problem->M->storageType != NM_SPARSE_BLOCK || !problem->M->matrix1)
+  {
+    /* dense W couples every contact with every other one: a single island */
+    numerics_printf("fc3d_islands - W is not sparse block, "
+                    "falling back to the inner solver on the full problem");
+    *info = fc3d_driver(problem, reaction, velocity, inner_options);
+    options->dparam[SICONOS_DPARAM_RESIDU] = inner_options->dparam[SICONOS_DPARAM_RESIDU];
+    options->iparam[SICONOS_IPARAM_ITER_DONE] = inner_options->iparam[SICONOS_IPARAM_ITER_DONE];
+    return;
+  }
+
+  SparseBlockStructuredMatrix* W = problem->M->matrix1;
+
+  /* 1. connected components of the (symmetrized) block structure of W */
+  unsigned int* parent = (unsigned int*) malloc(nc * sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i) parent[i] = i;
+  for(unsigned int row = 0; row < nc; ++row)
+    for(size_t blockNum = W->index1_data[row];
+        blockNum < W->index1_data[row + 1]; ++blockNum)
+      islands_union(parent, row, (unsigned int)W->index2_data[blockNum]);
+
+  /* 2. group the contacts island by island (counting sort on the roots) */
+  unsigned int* island_of = (unsigned int*) malloc(nc * sizeof(unsigned int));
+  unsigned int nislands = 0;
+  unsigned int* root_to_island = (unsigned int*) malloc(nc * sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i) root_to_island[i] = nc; /* unset */
+  for(unsigned int i = 0; i < nc; ++i)
+  {
+    unsigned int root = islands_find(parent, i);
+    if(root_to_island[root] == nc) root_to_island[root] = nislands++;
+    island_of[i] = root_to_island[root];
+  }
+  free(root_to_island);
+  free(parent);
+
+  numerics_printf("fc3d_islands - %u contacts in %u island(s)", nc, nislands);
+
+  if(nislands <= 1)
+  {
+    free(island_of);
+    *info = fc3d_driver(problem, reaction, velocity, inner_options);
+    options->dparam[SICONOS_DPARAM_RESIDU] = inner_options->dparam[SICONOS_DPARAM_RESIDU];
+    options->iparam[SICONOS_IPARAM_ITER_DONE] = inner_options->iparam[SICONOS_IPARAM_ITER_DONE];
+    return;
+  }
+
+  unsigned int* island_size = (unsigned int*) calloc(nislands, sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i) ++island_size[island_of[i]];
+
+  unsigned int* island_offset = (unsigned int*) malloc((nislands + 1) * sizeof(unsigned int));
+  island_offset[0] = 0;
+  for(unsigned int s = 0; s < nislands; ++s)
+    island_offset[s + 1] = island_offset[s] + island_size[s];
+
+  unsigned int* contacts = (unsigned int*) malloc(nc * sizeof(unsigned int));
+  unsigned int* fill = (unsigned int*) calloc(nislands, sizeof(unsigned int));
+  unsigned int* global_to_local = (unsigned int*) malloc(nc * sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i)
+  {
+    unsigned int s = island_of[i];
+    global_to_local[i] = fill[s];
+    contacts[island_offset[s] + fill[s]++] = i;
+  }
+  free(fill);
+  free(island_size);
+  free(island_of);
+
+  /* 3. solve each island independently; with OpenMP, islands run
+     concurrently, each worker on a private copy of the inner options */
+  int max_info = 0;
+  double max_residu = 0.0;
+  int max_iter_done = 0;
+
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(dynamic) \
+    reduction(max:max_info) reduction(max:max_residu) reduction(max:max_iter_done)
+#endif
+  for(unsigned int s = 0; s < nislands; ++s)
+  {
+    unsigned int nci = island_offset[s + 1] - island_offset[s];
+    const unsigned int* island_contacts = &contacts[island_offset[s]];
+
+    FrictionContactProblem* subproblem =
+      fc3d_islands_extract_subproblem(problem, island_contacts, nci, global_to_local);
+
+    double* subreaction = (double*) malloc(3 * nci * sizeof(double));
+    double* subvelocity = (double*) malloc(3 * nci * sizeof(double));
+    for(unsigned int r = 0; r < nci; ++r)
+    {
+      memcpy(&subreaction[3 * r], &reaction[3 * island_contacts[r]], 3 * sizeof(double));
+      memcpy(&subvelocity[3 * r], &velocity[3 * island_contacts[r]], 3 * sizeof(double));
+    }
+
+    SolverOptions* island_options;
+#if defined(_OPENMP)
+    island_options = solver_options_copy(inner_options);
+#else
+    island_options = inner_options;
+#endif
+
+    int island_info = fc3d_driver(subproblem, subreaction, subvelocity, island_options);
+
+    if(island_info > max_info) max_info = island_info;
+    if(island_options->dparam[SICONOS_DPARAM_RESIDU] > max_residu)
+      max_residu = island_options->dparam[SICONOS_DPARAM_RESIDU];
+    if(island_options->iparam[SICONOS_IPARAM_ITER_DONE] > max_iter_done)
+      max_iter_done = island_options->iparam[SICONOS_IPARAM_ITER_DONE];
+
+#if defined(_OPENMP)
+    solver_options_delete(island_options);
+    free(island_options);
+#endif
+
+    for(unsigned int r = 0; r < nci; ++r)
+    {
+      memcpy(&reaction[3 * island_contacts[r]], &subreaction[3 * r], 3 * sizeof(double));
+      memcpy(&velocity[3 * island_contacts[r]], &subvelocity[3 * r], 3 * sizeof(double));
+    }
+
+    free(subreaction);
+    free(subvelocity);
+    fc3d_islands_free_subproblem(subproblem);
+  }
+
+  free(global_to_local);
+  free(contacts);
+  free(island_offset);
+
+  *info = max_info;
+  options->dparam[SICONOS_DPARAM_RESIDU] = max_residu;
+  options->iparam[SICONOS_IPARAM_ITER_DONE] = max_iter_done;
+}
+
+void fc3d_islands_set_default(SolverOptions* options)
+{
+  options->dparam[SICONOS_DPARAM_TOL] = 1e-4;
+  assert(options->numberOfInternalSolvers == 1);
+  options->internalSolvers[0] = solver_options_create(SICONOS_FRICTION_3D_NSGS);
+}
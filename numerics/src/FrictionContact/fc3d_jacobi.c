@@ -0,0 +1,308 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>                                    // for assert
+#include <float.h>                                     // for DBL_EPSILON
+#include <math.h>                                      // for fabs, sqrt, pow
+#include <stdio.h>                                     // for NULL
+#include <stdlib.h>                                    // for malloc, free
+#include <string.h>                                    // for memcpy
+#include "FrictionContactProblem.h"                    // for FrictionContac...
+#include "Friction_cst.h"                              // for SICONOS_FRICTI...
+#include "NumericsExecutionPolicy.h"                   // for numerics_execu...
+#include "NumericsNumaReplica.h"                       // for numerics_numa_...
+#include "NumericsFwd.h"                               // for SolverOptions
+#include "SolverOptions.h"                             // for SolverOptions
+#include "fc3d_Solvers.h"                              // for SolverPtr, Upd...
+#include "fc3d_local_problem_tools.h"                  // for fc3d_local_pro...
+#include "numerics_verbose.h"                          // for numerics_printf
+#include "SiconosBlas.h"                               // for cblas_dnrm2
+/* #define DEBUG_STDOUT */
+/* #define DEBUG_MESSAGES */
+#include "siconos_debug.h"                             // for DEBUG_PRINTF
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static double jacobi_light_error_squared(double localreaction[3],
+                                         double *oldreaction)
+{
+  return (pow(oldreaction[0] - localreaction[0], 2) +
+          pow(oldreaction[1] - localreaction[1], 2) +
+          pow(oldreaction[2] - localreaction[2], 2));
+}
+
+void fc3d_jacobi(FrictionContactProblem* problem, double *reaction,
+                 double *velocity, int* info, SolverOptions* options)
+{
+  int* iparam = options->iparam;
+  double* dparam = options->dparam;
+
+  unsigned int nc = problem->numberOfContacts;
+  int itermax = iparam[SICONOS_IPARAM_MAX_ITER];
+  double tolerance = dparam[SICONOS_DPARAM_TOL];
+  double norm_q = cblas_dnrm2(nc * 3, problem->q, 1);
+
+  if(*info == 0)
+    return;
+
+  if(options->numberOfInternalSolvers < 1)
+  {
+    numerics_error("fc3d_jacobi",
+                   "The Jacobi method needs options for the internal solvers, "
+                   "options[0].numberOfInternalSolvers should be >= 1");
+  }
+
+  int async = (iparam[SICONOS_FRICTION_3D_JACOBI_IPARAM_UPDATE_SCHEME] ==
+               SICONOS_FRICTION_3D_JACOBI_UPDATE_ASYNCHRONOUS);
+  int divergence_limit = iparam[SICONOS_FRICTION_3D_JACOBI_IPARAM_DIVERGENCE_LIMIT];
+  if(divergence_limit <= 0) divergence_limit = 3;
+
+  double omega = dparam[SICONOS_FRICTION_3D_JACOBI_DPARAM_DAMPING];
+  double omega_min = dparam[SICONOS_FRICTION_3D_JACOBI_DPARAM_DAMPING_MIN];
+  if(omega_min <= 0.0) omega_min = 0.05;
+  if(omega <= 0.0 || omega > 1.0) omega = 0.7;
+
+  /* Per-thread local problem and solver options; thread 0 uses the caller
+     options so that statistics of the internal solver remain visible. */
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  FrictionContactProblem** localproblems =
+    (FrictionContactProblem**)malloc(nthreads * sizeof(FrictionContactProblem*));
+  SolverOptions** thread_options =
+    (SolverOptions**)malloc(nthreads * sizeof(SolverOptions*));
+  SolverPtr local_solver = NULL;
+  UpdatePtr update_localproblem = NULL;
+  FreeSolverNSGSPtr freeSolver = NULL;
+  ComputeErrorPtr computeError = NULL;
+
+  for(int t = 0; t < nthreads; ++t)
+  {
+    thread_options[t] = (t == 0) ? options : solver_options_copy(options);
+    localproblems[t] = fc3d_local_problem_allocate(problem);
+    fc3d_nsgs_initialize_local_solver(&local_solver, &update_localproblem,
+                                      &freeSolver, &computeError,
+                                      problem, localproblems[t],
+                                      thread_options[t]);
+  }
+
+  /* Optional NUMA replication of the read-only problem data, parked in
+     solverData and refreshed in place while the topology is unchanged
+     (see NumericsNumaReplica.h). */
+  NumericsNumaReplicaSet* replicas =
+    numerics_numa_replicate_fc3d((NumericsNumaReplicaSet*)options->solverData,
+                                 problem);
+  options->solverData = replicas;
+
+  /* Snapshot read by the synchronous scheme, previous iterate for the
+     damping and the light error in both schemes. */
+  double* reaction_prev = (double*)malloc(nc * 3 * sizeof(double));
+
+  /* with deterministic reductions, the light error terms are stored per
+     contact and folded in a fixed order after the sweep */
+  double* light_error_terms = NULL;
+  if(numerics_execution_policy()->deterministic_reductions)
+    light_error_terms = (double*)malloc(nc * sizeof(double));
+
+  int iter = 0;
+  double error = 1.;
+  double error_prev = 1.;
+  int hasNotConverged = 1;
+  int diverging = 0;
+  int fallback = 0;
+
+  while((iter < itermax) && (hasNotConverged > 0))
+  {
+    ++iter;
+    double light_error_sum = 0.0;
+
+    for(int t = 0; t < nthreads; ++t)
+      fc3d_set_internalsolver_tolerance(problem, thread_options[t],
+                                        thread_options[t]->internalSolvers[0],
+                                        error);
+
+    memcpy(reaction_prev, reaction, nc * 3 * sizeof(double));
+    /* the local problems of the synchronous scheme read the snapshot;
+       the asynchronous ones read the live vector as it is updated */
+    double* input = async ? reaction : reaction_prev;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 8) reduction(+:light_error_sum)
+#endif
+    for(unsigned int contact = 0; contact < nc; ++contact)
+    {
+      int tid = 0;
+#ifdef _OPENMP
+      tid = omp_get_thread_num();
+#endif
+      SolverOptions* localsolver_options = thread_options[tid]->internalSolvers[0];
+      double localreaction[3];
+      FrictionContactProblem* node_problem =
+        replicas ? numerics_numa_local_problem(replicas, tid) : problem;
+
+      (*update_localproblem)(contact, node_problem, localproblems[tid],
+                             input, localsolver_options);
+      localsolver_options->iparam[SICONOS_FRICTION_3D_CURRENT_CONTACT_NUMBER] = contact;
+      localreaction[0] = reaction_prev[contact * 3 + 0];
+      localreaction[1] = reaction_prev[contact * 3 + 1];
+      localreaction[2] = reaction_prev[contact * 3 + 2];
+
+      (*local_solver)(localproblems[tid], localreaction, localsolver_options);
+
+      double light_error = jacobi_light_error_squared(localreaction,
+                                                      &reaction_prev[contact * 3]);
+      if(light_error_terms)
+        light_error_terms[contact] = light_error;
+      else
+        light_error_sum += light_error;
+
+      /* damped write; each contact only ever writes its own entries, so
+         the asynchronous scheme needs no synchronisation, later contacts
+         simply pick the value up immediately */
+      if(!(isnan(localsolver_options->dparam[SICONOS_DPARAM_RESIDU])
+           || isinf(localsolver_options->dparam[SICONOS_DPARAM_RESIDU])
+           || localsolver_options->dparam[SICONOS_DPARAM_RESIDU] > 1.0))
+      {
+        for(int i = 0; i < 3; ++i)
+          reaction[contact * 3 + i] =
+            (1.0 - omega) * reaction_prev[contact * 3 + i] + omega * localreaction[i];
+      }
+    }
+
+    if(light_error_terms)
+      light_error_sum = numerics_fixed_order_sum(light_error_terms, nc);
+
+    double norm_r = cblas_dnrm2(nc * 3, reaction, 1);
+    error = sqrt(light_error_sum);
+    if(fabs(norm_r) > DBL_EPSILON)
+      error /= norm_r;
+
+    /* adaptive damping: shrink on a growing residual, relax back
+       towards 1 otherwise */
+    if(iter > 1 && (!isfinite(error) || error > error_prev))
+    {
+      ++diverging;
+      omega = fmax(0.5 * omega, omega_min);
+      numerics_printf("--------------- FC3D - JACOBI - Iteration %i "
+                      "Residual = %14.7e increasing, damping reduced to %7.3e",
+                      iter, error, omega);
+    }
+    else
+    {
+      diverging = 0;
+      omega = fmin(1.1 * omega, 1.0);
+    }
+    error_prev = error;
+
+    if(error < tolerance)
+    {
+      hasNotConverged = 0;
+      numerics_printf("--------------- FC3D - JACOBI - Iteration %i "
+                      "Residual = %14.7e < %7.3e", iter, error, tolerance);
+    }
+    else
+    {
+      numerics_printf("--------------- FC3D - JACOBI - Iteration %i "
+                      "Residual = %14.7e > %7.3e", iter, error, tolerance);
+    }
+
+    if(options->callback)
+    {
+      options->callback->collectStatsIteration(options->callback->env,
+                                               nc * 3, reaction, velocity,
+                                               error, NULL);
+    }
+
+    if(hasNotConverged && diverging >= divergence_limit)
+    {
+      fallback = 1;
+      break;
+    }
+  }
+
+  if(fallback)
+  {
+    /* divergence safeguard: hand the remaining iteration budget to the
+       sequential Gauss-Seidel sweeps, warm-started from the current
+       iterate */
+    int remaining = itermax - iter;
+    if(remaining < 1) remaining = 1;
+    numerics_printf("--------------- FC3D - JACOBI - %i diverging iterations, "
+                    "falling back on %i sequential NSGS sweeps",
+                    diverging, remaining);
+    iparam[SICONOS_IPARAM_MAX_ITER] = remaining;
+    fc3d_nsgs(problem, reaction, velocity, info, options);
+    iparam[SICONOS_IPARAM_MAX_ITER] = itermax;
+    hasNotConverged = *info;
+    error = dparam[SICONOS_DPARAM_RESIDU];
+    iter += iparam[SICONOS_IPARAM_ITER_DONE];
+  }
+  else if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] !=
+          SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT)
+  {
+    /* Full error of the final iterate, as in the
+       LIGHT_WITH_FULL_FINAL strategy of the sequential solver. */
+    (*computeError)(problem, reaction, velocity, tolerance, options,
+                    norm_q, &error);
+    hasNotConverged = (error < tolerance) ? 0 : 1;
+  }
+
+  *info = hasNotConverged;
+  dparam[SICONOS_DPARAM_RESIDU] = error;
+  iparam[SICONOS_IPARAM_ITER_DONE] = iter;
+
+  for(int t = 0; t < nthreads; ++t)
+  {
+    (*freeSolver)(problem, localproblems[t], thread_options[t]->internalSolvers[0]);
+    fc3d_local_problem_free(localproblems[t], problem);
+    if(t > 0)
+    {
+      solver_options_delete(thread_options[t]);
+      free(thread_options[t]);
+    }
+  }
+  if(replicas && !iparam[SICONOS_IPARAM_PREALLOC])
+  {
+    numerics_numa_replica_free(replicas);
+    options->solverData = NULL;
+  }
+  free(localproblems);
+  free(thread_options);
+  free(light_error_terms);
+  free(reaction_prev);
+}
+
+void fc3d_jacobi_set_default(SolverOptions* options)
+{
+  options->iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] =
+    SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_WITH_FULL_FINAL;
+  options->iparam[SICONOS_FRICTION_3D_IPARAM_INTERNAL_ERROR_STRATEGY] =
+    SICONOS_FRICTION_3D_INTERNAL_ERROR_STRATEGY_GIVEN_VALUE;
+  options->iparam[SICONOS_FRICTION_3D_JACOBI_IPARAM_UPDATE_SCHEME] =
+    SICONOS_FRICTION_3D_JACOBI_UPDATE_SYNCHRONOUS;
+  options->iparam[SICONOS_FRICTION_3D_JACOBI_IPARAM_DIVERGENCE_LIMIT] = 3;
+  options->dparam[SICONOS_DPARAM_TOL] = 1e-4;
+  options->dparam[SICONOS_FRICTION_3D_DPARAM_INTERNAL_ERROR_RATIO] = 10.0;
+  options->dparam[SICONOS_FRICTION_3D_JACOBI_DPARAM_DAMPING] = 0.7;
+  options->dparam[SICONOS_FRICTION_3D_JACOBI_DPARAM_DAMPING_MIN] = 0.05;
+  // Internal solver
+  assert(options->numberOfInternalSolvers == 1);
+  options->internalSolvers[0] = solver_options_create(SICONOS_FRICTION_3D_ONECONTACT_NSN_GP_HYBRID);
+}
@@ -48,26 +48,19 @@ void fc3d_FischerBurmeisterFunction(
   assert(problemSize / 3 > 0);
   assert(problemSize % 3 == 0);
 
-  unsigned int i;
-  for(i = 0; i < problemSize; i += 3)
+  /* the per-contact evaluations are independent: process the batch of
+     contacts in parallel */
+  int nc = (int)(problemSize / 3);
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(static)
+#endif
+  for(int contact = 0; contact < nc; ++contact)
   {
-
-    computeACFun3x3(reaction, velocity, *mu, rho, result, A, B);
-
-    reaction += 3;
-    velocity += 3;
-    mu++;
-    rho += 3;
-
-    if(result)
-      result += 3;
-
-    if(A)
-      A += 9;
-
-    if(B)
-      B += 9;
-
+    computeACFun3x3(&reaction[3 * contact], &velocity[3 * contact],
+                    mu[contact], &rho[3 * contact],
+                    result ? &result[3 * contact] : NULL,
+                    A ? &A[9 * contact] : NULL,
+                    B ? &B[9 * contact] : NULL);
   }
 
 }
@@ -38,6 +38,7 @@
 #include "fc3d_AlartCurnier_functions.h"              // for compute_rho_spe...
 #include "fc3d_compute_error.h"                       // for fc3d_compute_error
 #include "fc3d_local_problem_tools.h"                 // for fc3d_local_prob...
+#include "Newton_methods.h"                           // for broyden_updates
 #include "fc3d_nonsmooth_Newton_FischerBurmeister.h"  // for fc3d_FischerBur...
 #include "numerics_verbose.h"                         // for verbose, numeri...
 #include "op3x3.h"                                    // for extract3x3, add3x3
@@ -683,16 +684,51 @@ void fc3d_nonsmooth_Newton_solvers_solve(fc3d_nonsmooth_Newton_solvers* equation
 
   double linear_solver_residual=0.0;
 
+  /* quasi-Newton mode: keep AWpB and its factors for several iterations,
+   * correcting the solves with Broyden rank-1 updates; Jacobian assembly
+   * plus factorization dominates the per-iteration cost, so frozen
+   * iterations only reassemble F */
+  unsigned int qn_max_age = options->iparam[SICONOS_FRICTION_3D_NSN_QUASI_NEWTON_MAX_AGE];
+  broyden_updates* qn = qn_max_age > 0 ?
+                        broyden_updates_new(problemSize, qn_max_age) : NULL;
+  unsigned int jacobian_age = 0; /* iterations since AWpB was last rebuilt */
+  int qn_refresh = 0;            /* convergence degraded: rebuild AWpB */
+
   while(iter++ < itermax)
   {
 
-    equation->function(equation->data,
-                       problemSize,
-                       reaction, velocity, equation->problem->mu,
-                       rho,
-                       F, Ax, Bx);
-    // AW + B
-    computeAWpB(Ax, problem->M, Bx, AWpB);
+    int frozen = 0;
+    if(qn && jacobian_age > 0 && !qn_refresh)
+    {
+      /* the accepted step provides one Broyden correction; on rejection
+       * (storage full, breakdown) fall back to a full rebuild */
+      equation->function(equation->data,
+                         problemSize,
+                         reaction, velocity, equation->problem->mu,
+                         rho,
+                         F, NULL, NULL);
+      frozen = !broyden_updates_add(qn, AWpB, reaction, F);
+    }
+
+    if(!frozen)
+    {
+      equation->function(equation->data,
+                         problemSize,
+                         reaction, velocity, equation->problem->mu,
+                         rho,
+                         F, Ax, Bx);
+      // AW + B
+      computeAWpB(Ax, problem->M, Bx, AWpB);
+      if(qn)
+      {
+        broyden_updates_reset(qn);
+        jacobian_age = 0;
+        qn_refresh = 0;
+      }
+    }
+
+    if(qn)
+      broyden_updates_record(qn, reaction, F);
 
     cblas_dcopy_msan(problemSize, F, 1, tmp1, 1);
     cblas_dscal(problemSize, -1., tmp1, 1);
@@ -700,10 +736,21 @@ void fc3d_nonsmooth_Newton_solvers_solve(fc3d_nonsmooth_Newton_solvers* equation
     /* Solve: AWpB X = -F */
 //    NM_copy(AWpB, AWpB_backup);
     // int lsi = NM_gesv(AWpB, tmp1, true);
-    NM_unpreserve(AWpB);
-    NM_preserve(AWpB);
-    NM_set_LU_factorized(AWpB, false);
+    if(jacobian_age == 0)
+    {
+      NM_unpreserve(AWpB);
+      NM_preserve(AWpB);
+      NM_set_LU_factorized(AWpB, false);
+    }
     int lsi = NM_LU_solve(AWpB, tmp1, 1);
+    if(qn)
+    {
+      if(!lsi)
+        broyden_updates_apply(qn, tmp1);
+      else
+        qn_refresh = 1;
+      ++jacobian_age;
+    }
 
     /* NM_copy needed here */
 //    NM_copy(AWpB_backup, AWpB);
@@ -763,6 +810,14 @@ void fc3d_nonsmooth_Newton_solvers_solve(fc3d_nonsmooth_Newton_solvers* equation
     else
       cblas_daxpy(problemSize, 1., tmp3, 1., reaction, 1);
 
+    if(qn)
+    {
+      /* the full step was taken when the line search was skipped or
+       * failed; a shortened step means the frozen Jacobian degrades */
+      qn->tau = info_ls ? 1.0 : alpha;
+      if(qn->tau < 1.0) qn_refresh = 1;
+    }
+
     // velocity <- M*reaction + qfree
     cblas_dcopy(problemSize, problem->q, 1, velocity, 1);
     NM_gemv(1., problem->M, reaction, 1., velocity);
@@ -849,6 +904,8 @@ void fc3d_nonsmooth_Newton_solvers_solve(fc3d_nonsmooth_Newton_solvers* equation
     assert(buffer == options->dWork);
   }
 
+  broyden_updates_free(qn);
+
   if(!options->dWork)
   {
     NM_clear(AWpB);
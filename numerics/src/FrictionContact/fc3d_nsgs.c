@@ -21,10 +21,14 @@
 #include <stdio.h>                                     // for fclose, fopen
 #include <stdlib.h>                                    // for calloc, malloc
 #include <string.h>                                    // for NULL, memcpy
+#include "CSparseMatrix_internal.h"                    // for cs_entry, CSparseMatrix_rcm
 #include "FrictionContactProblem.h"                    // for FrictionContac...
 #include "Friction_cst.h"                              // for SICONOS_FRICTI...
 #include "NumericsArrays.h"                            // for uint_shuffle
 #include "NumericsFwd.h"                               // for SolverOptions
+#include "NumericsMatrix.h"                            // for NumericsMatrix
+#include "NumericsTrace.h"                             // for SN_TRACE
+#include "SparseBlockMatrix.h"                         // for SparseBlockStru...
 #include "SolverOptions.h"                             // for SolverOptions
 #include "fc3d_2NCP_Glocker.h"                         // for NCPGlocker_update
 #include "fc3d_NCPGlockerFixedPoint.h"                 // for fc3d_FixedP_in...
@@ -35,6 +39,7 @@
 #include "fc3d_onecontact_nonsmooth_Newton_solvers.h"  // for fc3d_onecontac...
 #include "fc3d_projection.h"                           // for fc3d_projectio...
 #include "fc3d_unitary_enumerative.h"                  // for fc3d_unitary_e...
+#include "projectionOnCone.h"                          // for projectionOnCone
 #include "numerics_verbose.h"                          // for numerics_printf
 #include "SiconosBlas.h"                                     // for cblas_dnrm2
 /* #define DEBUG_STDOUT */
@@ -242,12 +247,69 @@ void fc3d_nsgs_initialize_local_solver(SolverPtr* solve, UpdatePtr* update,
 
 
 
+static
+unsigned int* allocRCMOrderedContacts(FrictionContactProblem *problem)
+{
+  unsigned int nc = problem->numberOfContacts;
+  unsigned int *scontacts = (unsigned int *) malloc(nc * sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc ; ++i)
+  {
+    scontacts[i] = i;
+  }
+
+  /* contact adjacency graph: one entry per non zero 3x3 block of W */
+  CSparseMatrix* T = cs_spalloc(nc, nc, nc, 1, 1);
+  NumericsMatrix* M = problem->M;
+  if(M->storageType == NM_SPARSE_BLOCK && M->matrix1)
+  {
+    SparseBlockStructuredMatrix* W = M->matrix1;
+    for(size_t row = 0; row < W->filled1 - 1; ++row)
+      for(size_t b = W->index1_data[row]; b < W->index1_data[row+1]; ++b)
+        cs_entry(T, (CS_INT)row, (CS_INT)W->index2_data[b], 1.0);
+  }
+  else if(M->storageType == NM_SPARSE)
+  {
+    CSparseMatrix* csc = NM_csc(M);
+    for(CS_INT j = 0; j < csc->n; ++j)
+      for(CS_INT pos = csc->p[j]; pos < csc->p[j+1]; ++pos)
+        cs_entry(T, csc->i[pos] / 3, j / 3, 1.0);
+  }
+  else
+  {
+    /* dense W: every sweep order has the same locality, keep the natural one */
+    cs_spfree(T);
+    return scontacts;
+  }
+
+  CSparseMatrix* G = cs_compress(T);
+  cs_spfree(T);
+  if(G)
+  {
+    cs_dupl(G);
+    CS_INT* perm = CSparseMatrix_rcm(G);
+    if(perm)
+    {
+      for(unsigned int i = 0; i < nc ; ++i)
+      {
+        scontacts[i] = (unsigned int)perm[i];
+      }
+      cs_free(perm);
+    }
+    cs_spfree(G);
+  }
+  return scontacts;
+}
+
 static
 unsigned int* allocShuffledContacts(FrictionContactProblem *problem,
                                     SolverOptions *options)
 {
   unsigned int *scontacts = 0;
   unsigned int nc = problem->numberOfContacts;
+  if(options->iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_RCM)
+  {
+    return allocRCMOrderedContacts(problem);
+  }
   if(options->iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE||
       options->iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP)
   {
@@ -274,6 +336,20 @@ unsigned int* allocfreezingContacts(FrictionContactProblem *problem,
   unsigned int nc = problem->numberOfContacts;
   if(options->iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] > 0)
   {
+    if(options->iparam[SICONOS_FRICTION_3D_NSGS_KEEP_FREEZE_STATE] > 0)
+    {
+      /* persistent countdowns, kept in options->iWork so that an outer
+         wrapper restarting nsgs on the same problem (proximal outer
+         iterations) does not thaw every contact; reset only when the
+         problem size changed */
+      if(!options->iWork || options->iWorkSize != nc * sizeof(unsigned int) / sizeof(int))
+      {
+        options->iWork = (int *) realloc(options->iWork, nc * sizeof(unsigned int));
+        options->iWorkSize = nc * sizeof(unsigned int) / sizeof(int);
+        memset(options->iWork, 0, nc * sizeof(unsigned int));
+      }
+      return (unsigned int *) options->iWork;
+    }
     fcontacts = (unsigned int *) malloc(nc * sizeof(unsigned int));
     for(unsigned int i = 0; i < nc ; ++i)
     {
@@ -283,6 +359,230 @@ unsigned int* allocfreezingContacts(FrictionContactProblem *problem,
   return fcontacts;
 }
 
+/* ===== Two-level coarse aggregate preconditioner =====
+
+   On ill-conditioned problems (tall stacks) the NSGS sweeps only move
+   information one contact neighbourhood per iteration and convergence
+   stalls. The preconditioner aggregates contacts into coarse groups by
+   clustering over the contact graph of W, assembles the Galerkin coarse
+   operator W_G = P^T W P (P prolongates one coarse reaction to every
+   contact of its aggregate), and before the fine sweeps of each outer
+   iteration solves the small coarse friction problem
+
+       u_G = W_G dr_G + P^T (q + W r),  K_G* ∋ u_G ⊥ dr_G ∈ K_G
+
+   whose solution is prolongated back as a long-range correction of the
+   reactions, each one being projected on its cone afterwards. */
+typedef struct
+{
+  unsigned int nc_coarse;          /* number of aggregates */
+  unsigned int *agg;               /* fine contact -> aggregate */
+  FrictionContactProblem *coarse;  /* Galerkin coarse problem, dense W_G */
+  double *dr;                      /* coarse correction, 3 * nc_coarse */
+  double *du;                      /* coarse velocity work, 3 * nc_coarse */
+  double *u;                       /* fine velocity q + W r, 3 * nc */
+  SolverOptions *options;          /* NSGS options for the coarse solves */
+} CoarsePreconditioner;
+
+/* Greedy aggregation over the contact graph of W: each not yet aggregated
+   contact seeds an aggregate made of itself and its not yet aggregated
+   neighbours (plain aggregation, as in aggregation based multigrid).
+   With a dense W there is no graph and contacts are grouped by chunks,
+   which still captures the stack ordering of most assembled problems.
+   \return the number of aggregates */
+static
+unsigned int coarse_aggregate_contacts(FrictionContactProblem *problem,
+                                       unsigned int *agg)
+{
+  unsigned int nc = problem->numberOfContacts;
+  unsigned int nc_coarse = 0;
+  for(unsigned int i = 0; i < nc ; ++i) agg[i] = nc; /* nc = unset */
+
+  NumericsMatrix* M = problem->M;
+  if(M->storageType == NM_SPARSE_BLOCK && M->matrix1)
+  {
+    SparseBlockStructuredMatrix* W = M->matrix1;
+    for(unsigned int i = 0; i < nc ; ++i)
+    {
+      if(agg[i] < nc) continue;
+      agg[i] = nc_coarse;
+      for(size_t b = W->index1_data[i]; b < W->index1_data[i+1]; ++b)
+      {
+        size_t j = W->index2_data[b];
+        if(agg[j] == nc) agg[j] = nc_coarse;
+      }
+      ++nc_coarse;
+    }
+  }
+  else if(M->storageType == NM_SPARSE)
+  {
+    CSparseMatrix* csc = NM_csc(M);
+    for(unsigned int i = 0; i < nc ; ++i)
+    {
+      if(agg[i] < nc) continue;
+      agg[i] = nc_coarse;
+      for(CS_INT pos = csc->p[3*i]; pos < csc->p[3*i+1]; ++pos)
+      {
+        unsigned int j = (unsigned int)(csc->i[pos] / 3);
+        if(agg[j] == nc) agg[j] = nc_coarse;
+      }
+      ++nc_coarse;
+    }
+  }
+  else
+  {
+    for(unsigned int i = 0; i < nc ; ++i) agg[i] = i / 8;
+    nc_coarse = (nc + 7) / 8;
+  }
+  return nc_coarse;
+}
+
+/* Build the coarse problem once: W_G = P^T W P assembled dense (the
+   aggregates are strongly coupled, W_G has few zero blocks), mu_G the
+   largest friction coefficient of each aggregate, q_G refilled before
+   each coarse solve. */
+static
+void coarse_preconditioner_initialize(FrictionContactProblem *problem,
+                                      CoarsePreconditioner *cp,
+                                      int coarse_iters, double tolerance)
+{
+  unsigned int nc = problem->numberOfContacts;
+  cp->agg = (unsigned int *) malloc(nc * sizeof(unsigned int));
+  cp->nc_coarse = coarse_aggregate_contacts(problem, cp->agg);
+
+  unsigned int ncg = cp->nc_coarse;
+  NumericsMatrix* Wg = NM_create(NM_DENSE, 3*ncg, 3*ncg); /* zeroed */
+  double* wg = Wg->matrix0;
+  int ldg = 3*ncg;
+
+  NumericsMatrix* M = problem->M;
+  if(M->storageType == NM_SPARSE_BLOCK && M->matrix1)
+  {
+    SparseBlockStructuredMatrix* W = M->matrix1;
+    for(size_t row = 0; row < W->filled1 - 1; ++row)
+    {
+      unsigned int ag = cp->agg[row];
+      for(size_t b = W->index1_data[row]; b < W->index1_data[row+1]; ++b)
+      {
+        unsigned int bg = cp->agg[W->index2_data[b]];
+        double* block = W->block[b]; /* 3x3, column major */
+        for(int jj = 0; jj < 3; ++jj)
+          for(int ii = 0; ii < 3; ++ii)
+            wg[(3*ag + ii) + (3*bg + jj) * ldg] += block[ii + 3*jj];
+      }
+    }
+  }
+  else if(M->storageType == NM_SPARSE)
+  {
+    CSparseMatrix* csc = NM_csc(M);
+    for(CS_INT j = 0; j < csc->n; ++j)
+      for(CS_INT pos = csc->p[j]; pos < csc->p[j+1]; ++pos)
+      {
+        CS_INT i = csc->i[pos];
+        wg[(3*cp->agg[i/3] + i%3) + (3*cp->agg[j/3] + j%3) * ldg] += csc->x[pos];
+      }
+  }
+  else
+  {
+    for(unsigned int j = 0; j < 3*nc; ++j)
+      for(unsigned int i = 0; i < 3*nc; ++i)
+        wg[(3*cp->agg[i/3] + i%3) + (3*cp->agg[j/3] + j%3) * ldg]
+          += M->matrix0[i + j * 3*nc];
+  }
+
+  double* qg = (double *) calloc(3*ncg, sizeof(double));
+  double* mug = (double *) calloc(ncg, sizeof(double));
+  for(unsigned int i = 0; i < nc ; ++i)
+    if(problem->mu[i] > mug[cp->agg[i]]) mug[cp->agg[i]] = problem->mu[i];
+
+  cp->coarse = frictionContactProblem_new_with_data(3, (int)ncg, Wg, qg, mug);
+
+  cp->dr = (double *) calloc(3*ncg, sizeof(double));
+  cp->du = (double *) calloc(3*ncg, sizeof(double));
+  cp->u = (double *) malloc(3*nc * sizeof(double));
+
+  cp->options = solver_options_create(SICONOS_FRICTION_3D_NSGS);
+  cp->options->iparam[SICONOS_IPARAM_MAX_ITER] = coarse_iters;
+  cp->options->iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] =
+    SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT;
+  cp->options->dparam[SICONOS_DPARAM_TOL] = tolerance;
+
+  numerics_printf("fc3d_nsgs: coarse preconditioner, %u contacts aggregated into %u groups",
+                  nc, ncg);
+}
+
+/* One preconditioning step: restrict the current residual velocity,
+   solve the coarse problem from zero and prolongate the correction. */
+static
+void coarse_precondition(FrictionContactProblem *problem,
+                         CoarsePreconditioner *cp, double *reaction)
+{
+  unsigned int nc = problem->numberOfContacts;
+  unsigned int ncg = cp->nc_coarse;
+
+  /* fine residual velocity u = q + W r */
+  cblas_dcopy(nc*3, problem->q, 1, cp->u, 1);
+  NM_prod_mv_3x3(nc*3, nc*3, problem->M, reaction, cp->u);
+
+  /* restriction q_G = P^T u */
+  memset(cp->coarse->q, 0, 3*ncg * sizeof(double));
+  for(unsigned int i = 0; i < nc ; ++i)
+    for(int k = 0; k < 3; ++k)
+      cp->coarse->q[3*cp->agg[i] + k] += cp->u[3*i + k];
+
+  /* coarse solve: dr restarts from zero, it is a correction */
+  memset(cp->dr, 0, 3*ncg * sizeof(double));
+  int infoc = 1;
+  fc3d_nsgs(cp->coarse, cp->dr, cp->du, &infoc, cp->options);
+
+  /* prolongation, then fall back onto the cones */
+  for(unsigned int i = 0; i < nc ; ++i)
+  {
+    for(int k = 0; k < 3; ++k)
+      reaction[3*i + k] += cp->dr[3*cp->agg[i] + k];
+    projectionOnCone(&reaction[3*i], problem->mu[i]);
+  }
+}
+
+static
+void coarse_preconditioner_free(CoarsePreconditioner *cp)
+{
+  if(!cp->agg) return;
+  free(cp->agg);
+  frictionContactProblem_free(cp->coarse); /* frees W_G, q_G and mu_G */
+  free(cp->dr);
+  free(cp->du);
+  free(cp->u);
+  solver_options_delete(cp->options);
+  free(cp->options);
+}
+
+/* Wake up the frozen neighbours of a contact whose reaction just moved.
+   Neighbours are read off the block row of W; with a dense W every contact
+   is coupled to every other one, so there is no useful graph to exploit
+   and we leave the countdowns alone. */
+static
+void reactivateFrozenNeighbours(FrictionContactProblem *problem,
+                                unsigned int contact,
+                                unsigned int *freeze_contacts,
+                                unsigned char *low_error_sweeps)
+{
+  if(problem->M->storageType != NM_SPARSE_BLOCK || !problem->M->matrix1)
+    return;
+
+  SparseBlockStructuredMatrix *W = problem->M->matrix1;
+  for(size_t blockNum = W->index1_data[contact];
+      blockNum < W->index1_data[contact + 1]; ++blockNum)
+  {
+    size_t neighbour = W->index2_data[blockNum];
+    if(neighbour != contact && freeze_contacts[neighbour] > 0)
+    {
+      freeze_contacts[neighbour] = 0;
+      low_error_sweeps[neighbour] = 0;
+    }
+  }
+}
+
 
 static
 int solveLocalReaction(UpdatePtr update_localproblem, SolverPtr local_solver,
@@ -417,6 +717,33 @@ double calculateLightError(double light_error_sum, unsigned int nc, double *reac
   return error;
 }
 
+/* Error from the natural-map residuals accumulated contact by contact
+   during the sweep (two slots per contact: squared residual of the
+   natural map, squared norm of the local velocity). Each term was
+   computed right after its contact was relaxed, from the local data
+   already loaded for the local solve, so the estimate has the quality
+   of fc3d_compute_error without its full W reaction product; the terms
+   of frozen (skipped) contacts persist from the sweep that last updated
+   them. The normalization mirrors the one of fc3d_compute_error. */
+static
+double calculateNaturalMapError(const double *nat_map_terms, unsigned int nc,
+                                double *reaction, double norm_q, double *norm_r)
+{
+  double error = 0.0;
+  double norm_u_2 = 0.0;
+  for(unsigned int i = 0 ; i < nc ; ++i)
+  {
+    error += nat_map_terms[2*i];
+    norm_u_2 += nat_map_terms[2*i + 1];
+  }
+  error = sqrt(error);
+  *norm_r = cblas_dnrm2(nc*3, reaction, 1);
+  double relative_scaling = fmax(norm_q, fmax(*norm_r, sqrt(norm_u_2)));
+  if(fabs(relative_scaling) > DBL_EPSILON)
+    error /= relative_scaling;
+  return error;
+}
+
 static
 double calculateFullErrorAdaptiveInterval(FrictionContactProblem *problem,
     ComputeErrorPtr computeError,
@@ -482,6 +809,7 @@ int determine_convergence(double error, double tolerance, int iter,
                           SolverOptions *options)
 {
   int hasNotConverged = 1;
+  SN_TRACE(options->solverId, NUMERICS_TRACE_ITERATION, iter, error);
   if(error < tolerance)
   {
     hasNotConverged = 0;
@@ -504,6 +832,7 @@ int determine_convergence_with_full_final(FrictionContactProblem *problem, Solve
     int iter)
 {
   int hasNotConverged = 1;
+  SN_TRACE(options->solverId, NUMERICS_TRACE_ITERATION, iter, error);
   if(error < *tolerance)
   {
     hasNotConverged = 0;
@@ -545,7 +874,16 @@ int determine_convergence_with_full_final(FrictionContactProblem *problem, Solve
 }
 
 
-static
+/* number of contacts with a nonzero normal reaction, for the optional
+   convergence trace */
+static int activeContacts(unsigned int nc, const double *reaction)
+{
+  int n = 0;
+  for(unsigned int i = 0; i < nc; ++i)
+    if(reaction[3 * i] > 0.0) ++n;
+  return n;
+}
+
 void statsIterationCallback(FrictionContactProblem *problem,
                             SolverOptions *options,
                             double *reaction, double *velocity, double error)
@@ -608,6 +946,8 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
   if(*info == 0)
     return;
 
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_BEGIN, 0, (double)nc);
+
   /*****  Initialize various solver options *****/
   localproblem = fc3d_local_problem_allocate(problem);
 
@@ -617,30 +957,79 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
 
   scontacts = allocShuffledContacts(problem, options);
   freeze_contacts = allocfreezingContacts(problem, options);
+
+  /* two-level coarse aggregate preconditioner */
+  CoarsePreconditioner coarse = { 0, NULL, NULL, NULL, NULL, NULL, NULL };
+  int coarse_iters = iparam[SICONOS_FRICTION_3D_NSGS_COARSE_PRECOND];
+  if(coarse_iters > 0)
+  {
+    coarse_preconditioner_initialize(problem, &coarse, coarse_iters, tolerance);
+    if(coarse.nc_coarse >= nc)
+    {
+      /* nothing was aggregated (e.g. diagonal W): the coarse solve would
+         just duplicate the fine sweeps */
+      coarse_preconditioner_free(&coarse);
+      coarse_iters = 0;
+    }
+  }
+
+  /* residual history and statistics for the freezing active set */
+  unsigned char *low_error_sweeps = NULL;
+  unsigned int skipped_local_solves = 0;
+  if(iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] > 0
+      && iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION] == SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION_TRUE)
+  {
+    low_error_sweeps = (unsigned char *) calloc(nc, sizeof(unsigned char));
+  }
+
+  /* per-contact natural-map residual terms, kept across sweeps so that
+     frozen contacts retain the value of their last actual solve */
+  double *nat_map_terms = NULL;
+  if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_NATURAL_MAP)
+    nat_map_terms = (double *) calloc(2 * nc, sizeof(double));
+
+  /* With full error evaluation, maintain velocity = W reaction + q across
+     the sweeps: the product is computed once here and then updated contact
+     by contact (rank-3 column updates) as the reactions change, which
+     removes the dominant full W reaction product of fc3d_compute_error
+     from every iteration */
+  int incremental_velocity =
+    iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_FULL
+    && computeError == (ComputeErrorPtr)&fc3d_compute_error
+    && (problem->M->storageType == NM_SPARSE_BLOCK || problem->M->storageType == NM_DENSE);
+  if(incremental_velocity)
+  {
+    cblas_dcopy(nc*3, problem->q, 1, velocity, 1);
+    NM_prod_mv_3x3(nc*3, nc*3, problem->M, reaction, velocity);
+  }
   /*****  Check solver options *****/
   if(!(iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_FALSE
        || iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE
-       || iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP))
+       || iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP
+       || iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_RCM))
   {
     numerics_error(
       "fc3d_nsgs", "iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] must be equal to "
       "SICONOS_FRICTION_3D_NSGS_SHUFFLE_FALSE (0), "
-      "SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE (1) or "
-      "SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP (2)");
+      "SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE (1), "
+      "SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP (2) or "
+      "SICONOS_FRICTION_3D_NSGS_SHUFFLE_RCM (3)");
     return;
   }
 
   if(!(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_FULL
        || iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_WITH_FULL_FINAL
        || iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT
-       || iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ADAPTIVE))
+       || iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ADAPTIVE
+       || iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_NATURAL_MAP))
   {
     numerics_error(
       "fc3d_nsgs", "iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] must be equal to "
       "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_FULL (0), "
       "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_WITH_FULL_FINAL (1), "
-      "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT (2) or "
-      "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ADAPTIVE (3)");
+      "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT (2), "
+      "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_ADAPTIVE (3) or "
+      "SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_NATURAL_MAP (4)");
     return;
   }
 
@@ -650,6 +1039,7 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
    * with mechanics_run.py **/
   if(iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_FALSE
      && iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] == 0
+      && coarse_iters == 0
       && iparam[SICONOS_FRICTION_3D_NSGS_RELAXATION] == SICONOS_FRICTION_3D_NSGS_RELAXATION_FALSE
       && iparam[SICONOS_FRICTION_3D_NSGS_FILTER_LOCAL_SOLUTION] == SICONOS_FRICTION_3D_NSGS_FILTER_LOCAL_SOLUTION_TRUE
       && iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT)
@@ -682,6 +1072,10 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
 
       hasNotConverged = determine_convergence(error, tolerance, iter, options);
 
+      if(options->stats)
+        solver_options_stats_push(options, iter, error, 0.0,
+                                  activeContacts(nc, reaction));
+
       statsIterationCallback(problem, options, reaction, velocity, error);
     }
   }
@@ -698,10 +1092,20 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
       double light_error_2 = 0.0;
       fc3d_set_internalsolver_tolerance(problem, options, localsolver_options, error);
 
+      if(coarse_iters > 0)
+      {
+        coarse_precondition(problem, &coarse, reaction);
+        /* the long range correction invalidates the maintained velocity */
+        if(incremental_velocity)
+        {
+          cblas_dcopy(nc*3, problem->q, 1, velocity, 1);
+          NM_prod_mv_3x3(nc*3, nc*3, problem->M, reaction, velocity);
+        }
+      }
+
       for(unsigned int i = 0 ; i < nc ; ++i)
       {
-        if(iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE
-            || iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP)
+        if(iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] != SICONOS_FRICTION_3D_NSGS_SHUFFLE_FALSE)
         {
           if(iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] == SICONOS_FRICTION_3D_NSGS_SHUFFLE_TRUE_EACH_LOOP)
             uint_shuffle(scontacts, nc);
@@ -716,11 +1120,20 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
           {
             /* we skip freeze contacts */
             freeze_contacts[contact] -=  1;
+            ++skipped_local_solves;
             continue;
           }
         }
 
 
+        double reaction_old[3];
+        if(incremental_velocity)
+        {
+          reaction_old[0] = reaction[3 * contact];
+          reaction_old[1] = reaction[3 * contact + 1];
+          reaction_old[2] = reaction[3 * contact + 2];
+        }
+
         solveLocalReaction(update_localproblem, local_solver, contact,
                            problem, localproblem, reaction, localsolver_options,
                            localreaction);
@@ -744,16 +1157,32 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
                || squared_norm(localreaction) <=  (*norm_r* *norm_r/(nc*nc*1000)))
               && iter >=10)
           {
-            /* we  freeze the contact for n iterations*/
-            freeze_contacts[contact] = iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT];
-
-            DEBUG_EXPR
-              (printf("first criteria : light_error_2*squared_norm(localreaction) <= tolerance*tolerance/(nc*nc*10) ==> %e <= %e\n",
-                      light_error_2*squared_norm(localreaction), tolerance*tolerance/(nc*nc*10));
-               printf("second criteria :  squared_norm(localreaction) <=  (*norm_r* *norm_r/(nc*nc))/1000. ==> %e <= %e\n",
-                      squared_norm(localreaction) ,  (*norm_r* *norm_r/(nc*nc))/1000.);
-               printf("Contact % i is freezed for %i steps\n", contact,  iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT]);
-                );
+            /* with reactivation enabled, we only freeze a contact once its
+               local error has stayed below the scaled tolerance over three
+               consecutive sweeps; otherwise freeze right away (legacy) */
+            if(!low_error_sweeps || ++low_error_sweeps[contact] >= 3)
+            {
+              /* we  freeze the contact for n iterations*/
+              freeze_contacts[contact] = iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT];
+
+              DEBUG_EXPR
+                (printf("first criteria : light_error_2*squared_norm(localreaction) <= tolerance*tolerance/(nc*nc*10) ==> %e <= %e\n",
+                        light_error_2*squared_norm(localreaction), tolerance*tolerance/(nc*nc*10));
+                 printf("second criteria :  squared_norm(localreaction) <=  (*norm_r* *norm_r/(nc*nc))/1000. ==> %e <= %e\n",
+                        squared_norm(localreaction) ,  (*norm_r* *norm_r/(nc*nc))/1000.);
+                 printf("Contact % i is freezed for %i steps\n", contact,  iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT]);
+                  );
+            }
+          }
+          else if(low_error_sweeps)
+          {
+            /* the local residual bounced back: restart the history and, if
+               the reaction moved beyond its share of the tolerance budget,
+               wake the frozen neighbours coupled to it through W */
+            low_error_sweeps[contact] = 0;
+            if(light_error_2 > tolerance*tolerance/(nc*nc*10))
+              reactivateFrozenNeighbours(problem, contact,
+                                         freeze_contacts, low_error_sweeps);
           }
         }
 
@@ -764,7 +1193,34 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
         else
           acceptLocalReactionUnconditionally(contact, reaction, localreaction);
 
+        if(incremental_velocity)
+        {
+          double dr[3] = { reaction[3 * contact] - reaction_old[0],
+                           reaction[3 * contact + 1] - reaction_old[1],
+                           reaction[3 * contact + 2] - reaction_old[2]
+                         };
+          if(dr[0] != 0.0 || dr[1] != 0.0 || dr[2] != 0.0)
+            fc3d_velocity_rank3_update(problem, contact, dr, velocity);
+        }
 
+        if(nat_map_terms)
+        {
+          /* the local problem of this contact is still loaded: its
+             velocity u = W_cc r + q_local comes for a 3x3 product and
+             gives the natural-map residual of the contact at this point
+             of the sweep */
+          double *MLocal = localproblem->M->matrix0;
+          double *r = &reaction[3 * contact];
+          double u[3], worktmp[3];
+          for(int k = 0 ; k < 3 ; ++k)
+            u[k] = MLocal[k] * r[0] + MLocal[k + 3] * r[1]
+                   + MLocal[k + 6] * r[2] + localproblem->q[k];
+          nat_map_terms[2 * contact] = 0.0;
+          fc3d_unitary_compute_and_add_error(r, u, problem->mu[contact],
+                                             &nat_map_terms[2 * contact],
+                                             worktmp);
+          nat_map_terms[2 * contact + 1] = u[0]*u[0] + u[1]*u[1] + u[2]*u[2];
+        }
 
       }
 
@@ -773,6 +1229,12 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
         error = calculateLightError(light_error_sum, nc, reaction, norm_r);
         hasNotConverged = determine_convergence(error, tolerance, iter, options);
       }
+      else if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_NATURAL_MAP)
+      {
+        error = calculateNaturalMapError(nat_map_terms, nc, reaction,
+                                         norm_q, norm_r);
+        hasNotConverged = determine_convergence(error, tolerance, iter, options);
+      }
       else if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT_WITH_FULL_FINAL)
       {
         error = calculateLightError(light_error_sum, nc, reaction, norm_r);
@@ -791,12 +1253,26 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
       }
       else if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] == SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_FULL)
       {
-        error = calculateFullErrorAdaptiveInterval(problem, computeError, options,
-                iter, reaction, velocity,
+        error = calculateFullErrorAdaptiveInterval(problem,
+                incremental_velocity ?
+                (ComputeErrorPtr)&fc3d_compute_error_incremental : computeError,
+                options, iter, reaction, velocity,
                 tolerance, norm_q);
         hasNotConverged = determine_convergence(error, tolerance, iter, options);
+        /* guard against the accumulation of rounding in the maintained
+           velocity: confirm convergence on a fully recomputed product */
+        if(incremental_velocity && !hasNotConverged)
+        {
+          (*computeError)(problem, reaction, velocity, tolerance, options,
+                          norm_q, &error);
+          hasNotConverged = determine_convergence(error, tolerance, iter, options);
+        }
       }
 
+      if(options->stats)
+        solver_options_stats_push(options, iter, error, 0.0,
+                                  activeContacts(nc, reaction));
+
       statsIterationCallback(problem, options, reaction, velocity, error);
 
       /* if(iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] >0) */
@@ -828,17 +1304,33 @@ void fc3d_nsgs(FrictionContactProblem* problem, double *reaction,
 
   *info = hasNotConverged;
 
-
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_END, iter, error);
 
   /** return parameter values */
   /* dparam[SICONOS_DPARAM_TOL] = tolerance; */
   dparam[SICONOS_DPARAM_RESIDU] = error;
   iparam[SICONOS_IPARAM_ITER_DONE] = iter;
 
+  /** export freezing statistics */
+  if(iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] > 0)
+  {
+    unsigned int frozen_contacts = 0;
+    for(unsigned int i = 0 ; i < nc ; ++i)
+      if(freeze_contacts[i] > 0) ++frozen_contacts;
+    iparam[SICONOS_FRICTION_3D_NSGS_IPARAM_FROZEN_CONTACTS] = (int)frozen_contacts;
+    iparam[SICONOS_FRICTION_3D_NSGS_IPARAM_SKIPPED_LOCAL_SOLVES] = (int)skipped_local_solves;
+  }
+
   /** Free memory **/
   (*freeSolver)(problem,localproblem,localsolver_options);
   fc3d_local_problem_free(localproblem, problem);
   if(scontacts) free(scontacts);
+  /* persistent countdowns live in options->iWork and are freed with the options */
+  if(freeze_contacts && freeze_contacts != (unsigned int *) options->iWork)
+    free(freeze_contacts);
+  if(low_error_sweeps) free(low_error_sweeps);
+  if(nat_map_terms) free(nat_map_terms);
+  if(coarse_iters > 0) coarse_preconditioner_free(&coarse);
 }
 
 void fc3d_nsgs_set_default(SolverOptions* options)
@@ -850,8 +1342,10 @@ void fc3d_nsgs_set_default(SolverOptions* options)
   options->iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE] =  SICONOS_FRICTION_3D_NSGS_SHUFFLE_FALSE;
   options->iparam[SICONOS_FRICTION_3D_NSGS_SHUFFLE_SEED] = 0;
   options->iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] = 0;
+  options->iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION] = SICONOS_FRICTION_3D_NSGS_FREEZING_REACTIVATION_FALSE;
   options->iparam[SICONOS_FRICTION_3D_NSGS_FILTER_LOCAL_SOLUTION] = SICONOS_FRICTION_3D_NSGS_FILTER_LOCAL_SOLUTION_FALSE;
   options->iparam[SICONOS_FRICTION_3D_NSGS_RELAXATION] = SICONOS_FRICTION_3D_NSGS_RELAXATION_FALSE;
+  options->iparam[SICONOS_FRICTION_3D_NSGS_COARSE_PRECOND] = 0;
   options->iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION_FREQUENCY] = 0;
   options->dparam[SICONOS_DPARAM_TOL] = 1e-4;
   options->dparam[SICONOS_FRICTION_3D_DPARAM_INTERNAL_ERROR_RATIO] = 10.0;
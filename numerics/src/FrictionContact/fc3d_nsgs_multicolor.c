@@ -0,0 +1,355 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>                                    // for assert
+#include <float.h>                                     // for DBL_EPSILON
+#include <math.h>                                      // for fabs, sqrt, pow
+#include <stdio.h>                                     // for NULL
+#include <stdlib.h>                                    // for calloc, malloc
+#include <string.h>                                    // for memcpy
+#include "FrictionContactProblem.h"                    // for FrictionContac...
+#include "Friction_cst.h"                              // for SICONOS_FRICTI...
+#include "NumericsExecutionPolicy.h"                   // for numerics_execu...
+#include "NumericsNumaReplica.h"                       // for numerics_numa_...
+#include "NumericsFwd.h"                               // for SolverOptions
+#include "NumericsMatrix.h"                            // for NumericsMatrix
+#include "SolverOptions.h"                             // for SolverOptions
+#include "SparseBlockMatrix.h"                         // for SparseBlockStr...
+#include "fc3d_Solvers.h"                              // for SolverPtr, Upd...
+#include "fc3d_local_problem_tools.h"                  // for fc3d_local_pro...
+#include "numerics_verbose.h"                          // for numerics_printf
+#include "SiconosBlas.h"                               // for cblas_dnrm2
+/* #define DEBUG_STDOUT */
+/* #define DEBUG_MESSAGES */
+#include "siconos_debug.h"                             // for DEBUG_PRINTF
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* The coloring only looks at the block pattern of W, not at the block
+   contents, so it is shared with the rolling friction variant of the
+   solver (see the declaration in fc3d_Solvers.h). */
+unsigned int fc_nsgs_multicolor_coloring(const SparseBlockStructuredMatrix* W,
+                                         unsigned int nc,
+                                         unsigned int* colors)
+{
+  /* Build a symmetric adjacency in compressed form: first count, then fill. */
+  size_t* degree = (size_t*)calloc(nc + 1, sizeof(size_t));
+  size_t nnz_offdiag = 0;
+  for(unsigned int row = 0; row < W->filled1 - 1; ++row)
+  {
+    for(size_t blockNum = W->index1_data[row];
+        blockNum < W->index1_data[row + 1]; ++blockNum)
+    {
+      size_t col = W->index2_data[blockNum];
+      if(col == row) continue;
+      degree[row]++;
+      degree[col]++; /* symmetrize */
+      nnz_offdiag++;
+    }
+  }
+
+  /* A dense coupling pattern degenerates to one contact per color; the
+     caller falls back to the plain sequential sweep in that case. */
+  if(2 * nnz_offdiag > (size_t)nc * (nc - 1) / 2)
+  {
+    free(degree);
+    return 0;
+  }
+
+  size_t* adj_index = (size_t*)malloc((nc + 1) * sizeof(size_t));
+  adj_index[0] = 0;
+  for(unsigned int i = 0; i < nc; ++i)
+    adj_index[i + 1] = adj_index[i] + degree[i];
+
+  unsigned int* adj = (unsigned int*)malloc(2 * nnz_offdiag * sizeof(unsigned int));
+  size_t* fill = (size_t*)calloc(nc, sizeof(size_t));
+  for(unsigned int row = 0; row < W->filled1 - 1; ++row)
+  {
+    for(size_t blockNum = W->index1_data[row];
+        blockNum < W->index1_data[row + 1]; ++blockNum)
+    {
+      size_t col = W->index2_data[blockNum];
+      if(col == row) continue;
+      adj[adj_index[row] + fill[row]++] = (unsigned int)col;
+      adj[adj_index[col] + fill[col]++] = row;
+    }
+  }
+  free(fill);
+  free(degree);
+
+  /* Greedy first-fit coloring with a stamp array to mark forbidden colors. */
+  unsigned int* stamp = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i)
+  {
+    colors[i] = nc; /* uncolored */
+    stamp[i] = nc;
+  }
+  unsigned int number_of_colors = 0;
+  for(unsigned int i = 0; i < nc; ++i)
+  {
+    for(size_t k = adj_index[i]; k < adj_index[i + 1]; ++k)
+    {
+      unsigned int neighbor_color = colors[adj[k]];
+      if(neighbor_color < nc) stamp[neighbor_color] = i;
+    }
+    unsigned int c = 0;
+    while(stamp[c] == i) ++c;
+    colors[i] = c;
+    if(c + 1 > number_of_colors) number_of_colors = c + 1;
+  }
+  free(stamp);
+  free(adj);
+  free(adj_index);
+  return number_of_colors;
+}
+
+static double multicolor_light_error_squared(double localreaction[3],
+                                             double *oldreaction)
+{
+  return (pow(oldreaction[0] - localreaction[0], 2) +
+          pow(oldreaction[1] - localreaction[1], 2) +
+          pow(oldreaction[2] - localreaction[2], 2));
+}
+
+void fc3d_nsgs_multicolor(FrictionContactProblem* problem, double *reaction,
+                          double *velocity, int* info, SolverOptions* options)
+{
+  int* iparam = options->iparam;
+  double* dparam = options->dparam;
+
+  unsigned int nc = problem->numberOfContacts;
+  int itermax = iparam[SICONOS_IPARAM_MAX_ITER];
+  double tolerance = dparam[SICONOS_DPARAM_TOL];
+  double norm_q = cblas_dnrm2(nc * 3, problem->q, 1);
+
+  if(*info == 0)
+    return;
+
+  if(options->numberOfInternalSolvers < 1)
+  {
+    numerics_error("fc3d_nsgs_multicolor",
+                   "The NSGS method needs options for the internal solvers, "
+                   "options[0].numberOfInternalSolvers should be >= 1");
+  }
+
+  /* Coloring requires the block sparsity pattern of W. */
+  if(problem->M->storageType != NM_SPARSE_BLOCK || !problem->M->matrix1)
+  {
+    numerics_printf("fc3d_nsgs_multicolor - W is not sparse block, "
+                    "falling back on the sequential NSGS sweep");
+    fc3d_nsgs(problem, reaction, velocity, info, options);
+    return;
+  }
+
+  unsigned int* colors = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  unsigned int number_of_colors =
+    fc_nsgs_multicolor_coloring(problem->M->matrix1, nc, colors);
+
+  if(number_of_colors == 0 || number_of_colors > nc / 2 + 1)
+  {
+    numerics_printf("fc3d_nsgs_multicolor - contact graph is dense "
+                    "(%i colors for %i contacts), "
+                    "falling back on the sequential NSGS sweep",
+                    number_of_colors, nc);
+    free(colors);
+    fc3d_nsgs(problem, reaction, velocity, info, options);
+    return;
+  }
+
+  /* Group the contacts of each color class contiguously. */
+  unsigned int* color_offset = (unsigned int*)calloc(number_of_colors + 1, sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i)
+    color_offset[colors[i] + 1]++;
+  for(unsigned int c = 0; c < number_of_colors; ++c)
+    color_offset[c + 1] += color_offset[c];
+  unsigned int* color_member = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  unsigned int* color_fill = (unsigned int*)calloc(number_of_colors, sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i)
+    color_member[color_offset[colors[i]] + color_fill[colors[i]]++] = i;
+  free(color_fill);
+
+  numerics_printf("fc3d_nsgs_multicolor - %i contacts colored with %i colors",
+                  nc, number_of_colors);
+
+  /* Optional NUMA replication of the read-only problem data (W blocks,
+     q, mu): each worker then reads the replica of its own node instead
+     of hammering the node that first-touched the shared arrays. The set
+     is parked in solverData and refreshed in place while the topology
+     is unchanged, so over the calls of a simulation the replication is
+     paid once per topology, not once per call. */
+  NumericsNumaReplicaSet* replicas =
+    numerics_numa_replicate_fc3d((NumericsNumaReplicaSet*)options->solverData,
+                                 problem);
+  options->solverData = replicas;
+  if(replicas)
+    numerics_printf("fc3d_nsgs_multicolor - read-only data replicated on "
+                    "%i NUMA nodes", replicas->nnodes);
+
+  /* Per-thread local problem and solver options; thread 0 uses the caller
+     options so that statistics of the internal solver remain visible. */
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  FrictionContactProblem** localproblems =
+    (FrictionContactProblem**)malloc(nthreads * sizeof(FrictionContactProblem*));
+  SolverOptions** thread_options =
+    (SolverOptions**)malloc(nthreads * sizeof(SolverOptions*));
+  SolverPtr local_solver = NULL;
+  UpdatePtr update_localproblem = NULL;
+  FreeSolverNSGSPtr freeSolver = NULL;
+  ComputeErrorPtr computeError = NULL;
+
+  for(int t = 0; t < nthreads; ++t)
+  {
+    thread_options[t] = (t == 0) ? options : solver_options_copy(options);
+    localproblems[t] = fc3d_local_problem_allocate(problem);
+    fc3d_nsgs_initialize_local_solver(&local_solver, &update_localproblem,
+                                      &freeSolver, &computeError,
+                                      problem, localproblems[t],
+                                      thread_options[t]);
+  }
+
+  /* with deterministic reductions, the light error terms are stored per
+     contact and folded in a fixed order after the sweep */
+  double* light_error_terms = NULL;
+  if(numerics_execution_policy()->deterministic_reductions)
+    light_error_terms = (double*)malloc(nc * sizeof(double));
+
+  int iter = 0;
+  double error = 1.;
+  int hasNotConverged = 1;
+
+  while((iter < itermax) && (hasNotConverged > 0))
+  {
+    ++iter;
+    double light_error_sum = 0.0;
+
+    for(int t = 0; t < nthreads; ++t)
+      fc3d_set_internalsolver_tolerance(problem, thread_options[t],
+                                        thread_options[t]->internalSolvers[0],
+                                        error);
+
+    for(unsigned int c = 0; c < number_of_colors; ++c)
+    {
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 8) reduction(+:light_error_sum)
+#endif
+      for(unsigned int k = color_offset[c]; k < color_offset[c + 1]; ++k)
+      {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        unsigned int contact = color_member[k];
+        SolverOptions* localsolver_options = thread_options[tid]->internalSolvers[0];
+        double localreaction[3];
+        FrictionContactProblem* node_problem =
+          replicas ? numerics_numa_local_problem(replicas, tid) : problem;
+
+        (*update_localproblem)(contact, node_problem, localproblems[tid],
+                               reaction, localsolver_options);
+        localsolver_options->iparam[SICONOS_FRICTION_3D_CURRENT_CONTACT_NUMBER] = contact;
+        localreaction[0] = reaction[contact * 3 + 0];
+        localreaction[1] = reaction[contact * 3 + 1];
+        localreaction[2] = reaction[contact * 3 + 2];
+
+        (*local_solver)(localproblems[tid], localreaction, localsolver_options);
+
+        double light_error = multicolor_light_error_squared(localreaction,
+                                                            &reaction[contact * 3]);
+        if(light_error_terms)
+          light_error_terms[contact] = light_error;
+        else
+          light_error_sum += light_error;
+
+        if(!(isnan(localsolver_options->dparam[SICONOS_DPARAM_RESIDU])
+             || isinf(localsolver_options->dparam[SICONOS_DPARAM_RESIDU])
+             || localsolver_options->dparam[SICONOS_DPARAM_RESIDU] > 1.0))
+          memcpy(&reaction[contact * 3], localreaction, sizeof(double) * 3);
+      }
+    }
+
+    if(light_error_terms)
+      light_error_sum = numerics_fixed_order_sum(light_error_terms, nc);
+
+    double norm_r = cblas_dnrm2(nc * 3, reaction, 1);
+    error = sqrt(light_error_sum);
+    if(fabs(norm_r) > DBL_EPSILON)
+      error /= norm_r;
+
+    if(error < tolerance)
+    {
+      hasNotConverged = 0;
+      numerics_printf("--------------- FC3D - NSGS MULTICOLOR - Iteration %i "
+                      "Residual = %14.7e < %7.3e", iter, error, tolerance);
+    }
+    else
+    {
+      numerics_printf("--------------- FC3D - NSGS MULTICOLOR - Iteration %i "
+                      "Residual = %14.7e > %7.3e", iter, error, tolerance);
+    }
+
+    if(options->callback)
+    {
+      options->callback->collectStatsIteration(options->callback->env,
+                                               nc * 3, reaction, velocity,
+                                               error, NULL);
+    }
+  }
+
+  /* Full error of the final iterate, as in the
+     LIGHT_WITH_FULL_FINAL strategy of the sequential solver. */
+  if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] !=
+      SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT)
+  {
+    (*computeError)(problem, reaction, velocity, tolerance, options,
+                    norm_q, &error);
+    hasNotConverged = (error < tolerance) ? 0 : 1;
+  }
+
+  *info = hasNotConverged;
+  dparam[SICONOS_DPARAM_RESIDU] = error;
+  iparam[SICONOS_IPARAM_ITER_DONE] = iter;
+
+  for(int t = 0; t < nthreads; ++t)
+  {
+    (*freeSolver)(problem, localproblems[t], thread_options[t]->internalSolvers[0]);
+    fc3d_local_problem_free(localproblems[t], problem);
+    if(t > 0)
+    {
+      solver_options_delete(thread_options[t]);
+      free(thread_options[t]);
+    }
+  }
+  free(localproblems);
+  free(thread_options);
+  /* keep the replicas across calls only when the usual preallocation
+     option asks for it; the caller then releases them with
+     numerics_numa_replica_free before deleting the options */
+  if(replicas && !iparam[SICONOS_IPARAM_PREALLOC])
+  {
+    numerics_numa_replica_free(replicas);
+    options->solverData = NULL;
+  }
+  free(light_error_terms);
+  free(color_member);
+  free(color_offset);
+  free(colors);
+}
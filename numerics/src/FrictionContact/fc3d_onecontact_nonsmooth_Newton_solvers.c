@@ -36,6 +36,7 @@
 #include "fc3d_projection.h"                           // for fc3d_projectio...
 #include "numerics_verbose.h"                          // for numerics_print...
 #include "op3x3.h"                                     // for cpy3, mvp3x3
+#include "opNxN.h"                                     // for solve_3x3
 #include "SiconosBlas.h"                                     // for cblas_ddot
 #include "NSSTools.h"   // for max
 
@@ -509,9 +510,9 @@ int fc3d_onecontact_nonsmooth_Newton_solvers_solve_direct(FrictionContactProblem
 
     /* Solve the linear system */
     cpy3(F,dR);
-    info_solv3x3 = solve_3x3_gepp(AWplusB, dR);
+    info_solv3x3 = solve_3x3(AWplusB, dR);
 
-    /* if determinant is zero, replace dR=NaN with zero (i.e. don't modify R) and return early */
+    /* if determinant is zero, dR is left untouched: force a null direction (i.e. don't modify R) and return early */
     if(info_solv3x3)
     {
       dR[0] = 0;
@@ -807,9 +808,9 @@ int fc3d_onecontact_nonsmooth_Newton_solvers_solve_damped(FrictionContactProblem
 
     /* Solve the linear system */
     cpy3(F,dR);
-    info_solv3x3 = solve_3x3_gepp(AWplusB, dR);
+    info_solv3x3 = solve_3x3(AWplusB, dR);
 
-    /* if determinant is zero, replace dR=NaN with zero (i.e. don't modify R) and return early */
+    /* if determinant is zero, dR is left untouched: force a null direction (i.e. don't modify R) and return early */
     if(info_solv3x3)
     {
       dR[0] = 0;
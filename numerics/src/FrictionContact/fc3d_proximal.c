@@ -20,6 +20,7 @@
 #include <math.h>                                     // for fabs, pow
 #include <stdio.h>                                    // for printf, fprintf
 #include <stdlib.h>                                   // for exit, free, malloc
+#include <string.h>                                   // for memset
 #include "FrictionContactProblem.h"                   // for FrictionContact...
 #include "Friction_cst.h"                             // for SICONOS_FRICTIO...
 #include "NumericsFwd.h"                              // for SolverOptions
@@ -165,7 +166,24 @@ void fc3d_proximal(FrictionContactProblem* problem, double *reaction, double *ve
     numerics_error("fc3d_proximal", "The PROX method needs options for the internal solvers, soptions->internalSolvers should be different from NULL");
   }
 
-
+  /* adaptive schedule driven by the inner-solver iteration counts */
+  int adaptive_from_inner = iparam[SICONOS_FRICTION_3D_PROXIMAL_IPARAM_ADAPTIVE_FROM_INNER];
+  int internal_itermax = internalsolver_options->iparam[SICONOS_IPARAM_MAX_ITER];
+  if(internal_itermax < 1) internal_itermax = 1;
+
+  /* with an nsgs internal solver that freezes contacts, keep the frozen
+     set across the outer iterations: the regularized problems only
+     differ by a diagonal shift and a warm right-hand side, so thawing
+     every contact at each restart throws away most of the inner work */
+  if(internalsolver_options->solverId == SICONOS_FRICTION_3D_NSGS
+      && internalsolver_options->iparam[SICONOS_FRICTION_3D_NSGS_FREEZING_CONTACT] > 0)
+  {
+    internalsolver_options->iparam[SICONOS_FRICTION_3D_NSGS_KEEP_FREEZE_STATE] = 1;
+    /* start from a fully thawed set for this problem */
+    if(internalsolver_options->iWork)
+      memset(internalsolver_options->iWork, 0,
+             internalsolver_options->iWorkSize * sizeof(int));
+  }
 
   DEBUG_PRINTF("isVariable = %i\n",isVariable);
   DEBUG_PRINTF("options->iparam[SICONOS_FRICTION_3D_PROXIMAL_IPARAM_STRATEGY] = %i\n",options->iparam[SICONOS_FRICTION_3D_PROXIMAL_IPARAM_STRATEGY]);
@@ -233,6 +251,17 @@ void fc3d_proximal(FrictionContactProblem* problem, double *reaction, double *ve
         {
           alpha = alpha*5;
         }
+        else if(adaptive_from_inner)
+        {
+          /* relax the regularization according to the effort of the
+             inner solver: cheap inner solves mean alpha no longer helps
+             and can be dropped fast, inner solves close to their budget
+             mean the problem still needs it */
+          double effort = (double)iter_internalsolver / (double)internal_itermax;
+          if(effort < 0.25) alpha = alpha/10.0;
+          else if(effort < 0.75) alpha = alpha/5.0;
+          else alpha = alpha/2.0;
+        }
         else
         {
           alpha = alpha/10.0;
@@ -351,7 +380,16 @@ void fc3d_proximal(FrictionContactProblem* problem, double *reaction, double *ve
         }
         else
         {
-          alpha = sigma*pow(error,nu);
+          double alpha_schedule = sigma*pow(error,nu);
+          /* when the inner solver nearly exhausted its budget, keep the
+             current regularization rather than following the error-based
+             schedule down: a smaller alpha would only make the next
+             inner problem harder */
+          if(adaptive_from_inner
+              && (double)iter_internalsolver / (double)internal_itermax > 0.75)
+            alpha = fmax(alpha, alpha_schedule);
+          else
+            alpha = alpha_schedule;
         }
       }
       DEBUG_PRINTF("alpha = %8.4e\n",alpha);
@@ -398,6 +436,8 @@ void fc3d_proximal_set_default(SolverOptions* options)
   /* fixed regularization or proximal */
   options->iparam[SICONOS_FRICTION_3D_PROXIMAL_IPARAM_STRATEGY ] =
     SICONOS_FRICTION_3D_PROXIMAL_PROX;
+  /* drive the alpha updates with the inner-solver iteration counts */
+  options->iparam[SICONOS_FRICTION_3D_PROXIMAL_IPARAM_ADAPTIVE_FROM_INNER] = 1;
   options->dparam[SICONOS_FRICTION_3D_DPARAM_INTERNAL_ERROR_RATIO] =10.0;
   /* default value for proximal parameter alpha; */
   options->dparam[SICONOS_FRICTION_3D_PROXIMAL_DPARAM_ALPHA] = 1.e4;
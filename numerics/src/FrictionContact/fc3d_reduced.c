@@ -0,0 +1,248 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>                  // for assert
+#include <stdio.h>                   // for NULL
+#include <stdlib.h>                  // for calloc, malloc, free
+#include <string.h>                  // for memcpy, memset
+#include "FrictionContactProblem.h"  // for FrictionContactProblem
+#include "Friction_cst.h"            // for SICONOS_FRICTION_3D_REDUCED
+#include "NonSmoothDrivers.h"        // for fc3d_driver
+#include "NumericsFwd.h"             // for SolverOptions
+#include "NumericsMatrix.h"          // for NumericsMatrix, NM_new
+#include "SiconosBlas.h"             // for cblas_dnrm2
+#include "SolverOptions.h"           // for SolverOptions, solver_options_create
+#include "SparseBlockMatrix.h"       // for SparseBlockStructuredMatrix
+#include "fc3d_Solvers.h"            // for fc3d_reduced
+#include "fc3d_compute_error.h"      // for fc3d_compute_error
+#include "numerics_verbose.h"        // for numerics_printf
+/* #define DEBUG_STDOUT */
+/* #define DEBUG_MESSAGES */
+#include "siconos_debug.h"           // for DEBUG_PRINTF
+
+/* Build the sub-problem of the kept contacts. The local W shares the
+   block payloads of the global one (only the index arrays are remapped)
+   and drops the blocks whose column is eliminated: the eliminated
+   reactions are set to zero, so their contribution vanishes exactly.
+   The sub-problem must be released with fc3d_reduced_free_subproblem
+   and never with frictionContactProblem_free. */
+static FrictionContactProblem* fc3d_reduced_extract_subproblem(
+  FrictionContactProblem* problem,
+  const unsigned int* contacts, unsigned int nck,
+  const unsigned int* global_to_local, const char* keep)
+{
+  SparseBlockStructuredMatrix* W = problem->M->matrix1;
+
+  SparseBlockStructuredMatrix* subW = SBM_new();
+  subW->blocknumber0 = nck;
+  subW->blocknumber1 = nck;
+  subW->blocksize0 = (unsigned int*) malloc(nck * sizeof(unsigned int));
+  subW->blocksize1 = subW->blocksize0;
+  for(unsigned int r = 0; r < nck; ++r) subW->blocksize0[r] = 3 * (r + 1);
+
+  /* upper bound: every block of the kept rows */
+  size_t nblocks_max = 0;
+  for(unsigned int r = 0; r < nck; ++r)
+    nblocks_max += W->index1_data[contacts[r] + 1] - W->index1_data[contacts[r]];
+
+  subW->index1_data = (size_t*) malloc((nck + 1) * sizeof(size_t));
+  subW->index2_data = (size_t*) malloc(nblocks_max * sizeof(size_t));
+  subW->block = (double**) malloc(nblocks_max * sizeof(double*));
+
+  size_t pos = 0;
+  subW->index1_data[0] = 0;
+  for(unsigned int r = 0; r < nck; ++r)
+  {
+    unsigned int g = contacts[r];
+    for(size_t blockNum = W->index1_data[g];
+        blockNum < W->index1_data[g + 1]; ++blockNum)
+    {
+      size_t col = W->index2_data[blockNum];
+      if(!keep[col]) continue;
+      subW->index2_data[pos] = global_to_local[col];
+      subW->block[pos] = W->block[blockNum];
+      ++pos;
+    }
+    subW->index1_data[r + 1] = pos;
+  }
+  subW->nbblocks = pos;
+  subW->filled1 = nck + 1;
+  subW->filled2 = pos;
+
+  NumericsMatrix* subM = NM_new();
+  subM->storageType = NM_SPARSE_BLOCK;
+  subM->size0 = 3 * (int)nck;
+  subM->size1 = 3 * (int)nck;
+  subM->matrix1 = subW;
+
+  FrictionContactProblem* subproblem =
+    (FrictionContactProblem*) malloc(sizeof(FrictionContactProblem));
+  subproblem->dimension = problem->dimension;
+  subproblem->numberOfContacts = (int)nck;
+  subproblem->M = subM;
+  subproblem->q = (double*) malloc(3 * nck * sizeof(double));
+  subproblem->mu = (double*) malloc(nck * sizeof(double));
+  for(unsigned int r = 0; r < nck; ++r)
+  {
+    memcpy(&subproblem->q[3 * r], &problem->q[3 * contacts[r]], 3 * sizeof(double));
+    subproblem->mu[r] = problem->mu[contacts[r]];
+  }
+  return subproblem;
+}
+
+static void fc3d_reduced_free_subproblem(FrictionContactProblem* subproblem)
+{
+  SparseBlockStructuredMatrix* subW = subproblem->M->matrix1;
+  /* the block payloads belong to the global W */
+  free(subW->block);
+  free(subW->index1_data);
+  free(subW->index2_data);
+  free(subW->blocksize0);
+  free(subW);
+  subproblem->M->matrix1 = NULL;
+  NM_clear(subproblem->M);
+  free(subproblem->M);
+  free(subproblem->q);
+  free(subproblem->mu);
+  free(subproblem);
+}
+
+void fc3d_reduced(FrictionContactProblem* problem, double* reaction,
+                  double* velocity, int* info, SolverOptions* options)
+{
+  assert(options->numberOfInternalSolvers == 1);
+  SolverOptions* inner_options = options->internalSolvers[0];
+  unsigned int nc = problem->numberOfContacts;
+  double tolerance = options->dparam[SICONOS_DPARAM_TOL];
+
+  if(problem->M->storageType != NM_SPARSE_BLOCK || !problem->M->matrix1)
+  {
+    /* the reduced W is built as views into the sparse block storage */
+    numerics_printf("fc3d_reduced - W is not sparse block, "
+                    "falling back to the inner solver on the full problem");
+    *info = fc3d_driver(problem, reaction, velocity, inner_options);
+    options->dparam[SICONOS_DPARAM_RESIDU] = inner_options->dparam[SICONOS_DPARAM_RESIDU];
+    options->iparam[SICONOS_IPARAM_ITER_DONE] = inner_options->iparam[SICONOS_IPARAM_ITER_DONE];
+    return;
+  }
+
+  /* 1. screen the contacts: with every reaction at zero the velocity is
+     q, so a contact whose normal part of q is positive is opening and
+     its reaction is tentatively zero. This is a heuristic certificate
+     (couplings may still load the contact), made sound by the full
+     error post-check below. */
+  char* keep = (char*) malloc(nc * sizeof(char));
+  unsigned int nck = 0;
+  for(unsigned int i = 0; i < nc; ++i)
+  {
+    keep[i] = (problem->q[3 * i] <= 0.0);
+    if(keep[i]) ++nck;
+  }
+
+  numerics_printf("fc3d_reduced - %u contacts kept out of %u", nck, nc);
+
+  double norm_q = cblas_dnrm2(3 * nc, problem->q, 1);
+  double error = 0.0;
+
+  if(nck == 0)
+  {
+    /* every contact is opening: the trivial solution */
+    memset(reaction, 0, 3 * nc * sizeof(double));
+    memcpy(velocity, problem->q, 3 * nc * sizeof(double));
+    free(keep);
+    *info = 0;
+    options->dparam[SICONOS_DPARAM_RESIDU] = 0.0;
+    options->iparam[SICONOS_IPARAM_ITER_DONE] = 0;
+    return;
+  }
+
+  if(nck == nc)
+  {
+    free(keep);
+    *info = fc3d_driver(problem, reaction, velocity, inner_options);
+    options->dparam[SICONOS_DPARAM_RESIDU] = inner_options->dparam[SICONOS_DPARAM_RESIDU];
+    options->iparam[SICONOS_IPARAM_ITER_DONE] = inner_options->iparam[SICONOS_IPARAM_ITER_DONE];
+    return;
+  }
+
+  /* 2. extract and solve the reduced problem, warm-started from the
+     kept part of the incoming reaction */
+  unsigned int* contacts = (unsigned int*) malloc(nck * sizeof(unsigned int));
+  unsigned int* global_to_local = (unsigned int*) malloc(nc * sizeof(unsigned int));
+  unsigned int k = 0;
+  for(unsigned int i = 0; i < nc; ++i)
+  {
+    if(!keep[i]) continue;
+    global_to_local[i] = k;
+    contacts[k++] = i;
+  }
+
+  FrictionContactProblem* subproblem =
+    fc3d_reduced_extract_subproblem(problem, contacts, nck, global_to_local, keep);
+
+  double* subreaction = (double*) malloc(3 * nck * sizeof(double));
+  double* subvelocity = (double*) malloc(3 * nck * sizeof(double));
+  for(unsigned int r = 0; r < nck; ++r)
+  {
+    memcpy(&subreaction[3 * r], &reaction[3 * contacts[r]], 3 * sizeof(double));
+    memcpy(&subvelocity[3 * r], &velocity[3 * contacts[r]], 3 * sizeof(double));
+  }
+
+  int sub_info = fc3d_driver(subproblem, subreaction, subvelocity, inner_options);
+  int iter_done = inner_options->iparam[SICONOS_IPARAM_ITER_DONE];
+
+  /* 3. scatter back, zeros for the eliminated contacts */
+  memset(reaction, 0, 3 * nc * sizeof(double));
+  for(unsigned int r = 0; r < nck; ++r)
+    memcpy(&reaction[3 * contacts[r]], &subreaction[3 * r], 3 * sizeof(double));
+
+  free(subreaction);
+  free(subvelocity);
+  fc3d_reduced_free_subproblem(subproblem);
+  free(contacts);
+  free(global_to_local);
+  free(keep);
+
+  /* 4. post-check on the full problem (this also fills velocity with
+     W reaction + q, eliminated contacts included) */
+  fc3d_compute_error(problem, reaction, velocity, tolerance, options, norm_q, &error);
+
+  if(sub_info == 0 && error <= tolerance)
+  {
+    *info = 0;
+    options->dparam[SICONOS_DPARAM_RESIDU] = error;
+    options->iparam[SICONOS_IPARAM_ITER_DONE] = iter_done;
+    return;
+  }
+
+  /* an eliminated contact was loaded by the kept ones (or the reduced
+     solve failed): solve the full problem, warm-started from the
+     reduced solution */
+  numerics_printf("fc3d_reduced - post-check failed (error = %e), "
+                  "solving the full problem", error);
+  *info = fc3d_driver(problem, reaction, velocity, inner_options);
+  options->dparam[SICONOS_DPARAM_RESIDU] = inner_options->dparam[SICONOS_DPARAM_RESIDU];
+  options->iparam[SICONOS_IPARAM_ITER_DONE] =
+    iter_done + inner_options->iparam[SICONOS_IPARAM_ITER_DONE];
+}
+
+void fc3d_reduced_set_default(SolverOptions* options)
+{
+  options->dparam[SICONOS_DPARAM_TOL] = 1e-4;
+  assert(options->numberOfInternalSolvers == 1);
+  options->internalSolvers[0] = solver_options_create(SICONOS_FRICTION_3D_NSGS);
+}
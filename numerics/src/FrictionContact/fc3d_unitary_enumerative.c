@@ -27,6 +27,7 @@
 #include "SolverOptions.h"           // for SolverOptions, solver_options_nu...
 #include "numerics_verbose.h"        // for verbose, numerics_warning
 #include "op3x3.h"                   // for SET3, print3, print3x3, SET3X3
+#include "opNxN.h"                   // for solve_3x3
 #include "projectionOnCone.h"        // for projectionOnCone
 #include "quartic.h"                 // for BIQUADROOTS, CUBICROOTS, QUADROOTS
 //#define FC3D_UE_DEBUG
@@ -245,9 +246,9 @@ int fc3d_unitary_enumerative_test_non_sliding(FrictionContactProblem* problem, d
   reaction[0] = Q[0];
   reaction[1] = Q[1];
   reaction[2] = Q[2];
-  int info = solve_3x3_gepp(M, reaction);
+  int info = solve_3x3(M, reaction);
   if(info && (verbose > 0))
-    numerics_warning("fc3d_unitary_enumerative_test_non_sliding", "NaN output in solve_3x3_gepp");
+    numerics_warning("fc3d_unitary_enumerative_test_non_sliding", "singular 3x3 system in solve_3x3");
   M = M00;
   reaction = reaction0;
   Q = Q0;
@@ -377,9 +378,8 @@ int fc3d_unitary_enumerative_solve_sliding(FrictionContactProblem* problem, doub
   double NormD = sqrt(NormD2);
   double e = (*mu) * NormD / (*M00);
   double d, p;
-  double phi = NAN;
-  double cosphi = NAN;
-  double sinphi = NAN;
+  double cosphi = 0.0;
+  double sinphi = 0.0;
   FC3D_unitary_enum_factorize2x2(M11, M22, M12, &D1, &D2, V);
 
 #ifdef FC3D_UE_DEBUG
@@ -415,27 +415,19 @@ int fc3d_unitary_enumerative_solve_sliding(FrictionContactProblem* problem, doub
     }
     OD2[0] = (*V00) * OD[0] + (*V01) * OD[1];
     OD2[1] = (*V10) * OD[0] + (*V11) * OD[1];
-    if(!FC3D_UE_TEST_NULL(OD2[0]))
+    /* (cosphi,sinphi) is the direction of OD2: normalizing the vector
+       replaces the atan/cos/sin round trip through the angle phi */
+    double NormOD2 = sqrt(OD2[0] * OD2[0] + OD2[1] * OD2[1]);
+    if(!FC3D_UE_TEST_NULL(NormOD2))
     {
-      if(FC3D_UE_TEST_NULL(OD2[1]))
-      {
-        phi = 0;
-      }
-      else
-      {
-        phi = atan(OD2[1] / OD2[0]);
-      }
+      cosphi = OD2[0] / NormOD2;
+      sinphi = OD2[1] / NormOD2;
     }
     else
     {
-      phi = M_PI / 2.0;
-      if(OD2[1] < 0)
-        phi = -M_PI / 2.0;
+      cosphi = 0.0;
+      sinphi = 1.0;
     }
-    if(OD2[0] < 0)
-      phi += M_PI;
-    cosphi = cos(phi);
-    sinphi = sin(phi);
   }
   else  /*e is null*/
   {
@@ -471,27 +463,77 @@ int fc3d_unitary_enumerative_solve_sliding(FrictionContactProblem* problem, doub
   Poly4[4] = AA + EE;
   int nbRealRacines;
   double Racines[4];
-  double PossiblesTheta[8];
+  /* candidate angles, stored as (cos,sin) pairs: the roots come from the
+     substitution t = tan(theta/2), so cos(theta) = (1-t^2)/(1+t^2) and
+     sin(theta) = 2t/(1+t^2) and no trigonometric call is needed to come
+     back from them */
+  double ct[8], st[8], rad[8];
+  /* 0: generic root, 1: case RTb[0]==0, 2: case RTb[1]==0 */
+  int kind[8];
+  int order[8];
 
   compute_racines(Poly4, &nbRealRacines, Racines);
   for(int numR = 0; numR < nbRealRacines; numR++)
-    PossiblesTheta[numR] = 2 * atan(Racines[numR]);
+  {
+    double t = Racines[numR];
+    double w = 1.0 / (1.0 + t * t);
+    ct[numR] = (1.0 - t * t) * w;
+    st[numR] = 2.0 * t * w;
+    kind[numR] = 0;
+  }
   /*Case RTb[x]==0*/
-  PossiblesTheta[nbRealRacines] = -M_PI / 2;
-  PossiblesTheta[nbRealRacines + 1] = M_PI / 2;
-  PossiblesTheta[nbRealRacines + 2] = M_PI;
-  PossiblesTheta[nbRealRacines + 3] = 0;
-  for(int numR = 0; numR < nbRealRacines + 4; numR++)
+  ct[nbRealRacines] = 0.0;      /* theta = -pi/2 */
+  st[nbRealRacines] = -1.0;
+  kind[nbRealRacines] = 1;
+  ct[nbRealRacines + 1] = 0.0;  /* theta = pi/2 */
+  st[nbRealRacines + 1] = 1.0;
+  kind[nbRealRacines + 1] = 1;
+  ct[nbRealRacines + 2] = -1.0; /* theta = pi */
+  st[nbRealRacines + 2] = 0.0;
+  kind[nbRealRacines + 2] = 2;
+  ct[nbRealRacines + 3] = 1.0;  /* theta = 0 */
+  st[nbRealRacines + 3] = 0.0;
+  kind[nbRealRacines + 3] = 2;
+
+  int nbCandidates = nbRealRacines + 4;
+  for(int numR = 0; numR < nbCandidates; numR++)
+  {
+    rad[numR] = p / (1 + e * (ct[numR] * cosphi + st[numR] * sinphi));
+    order[numR] = numR;
+  }
+
+  /* try first the candidate closest to the incoming (warm started)
+     reaction: inside nsgs the previous solution of the same contact is a
+     good predictor of the active case, and the first candidate passing
+     the checks below is the one returned */
+  double prevRTb0 = (*V00) * (*reaction1) + (*V01) * (*reaction2);
+  double prevRTb1 = (*V10) * (*reaction1) + (*V11) * (*reaction2);
+  if(!FC3D_UE_TEST_NULL(prevRTb0 * prevRTb0 + prevRTb1 * prevRTb1))
+  {
+    double score[8];
+    for(int numR = 0; numR < nbCandidates; numR++)
+      score[numR] = rad[numR] * (ct[numR] * prevRTb0 + st[numR] * prevRTb1);
+    for(int i = 0; i < nbCandidates - 1; i++)
+    {
+      int best = i;
+      for(int j = i + 1; j < nbCandidates; j++)
+        if(score[order[j]] > score[order[best]]) best = j;
+      int swap = order[i];
+      order[i] = order[best];
+      order[best] = swap;
+    }
+  }
+
+  for(int numC = 0; numC < nbCandidates; numC++)
   {
+    int numR = order[numC];
 #ifdef FC3D_UE_DEBUG
-    if(numR >= nbRealRacines)
+    if(kind[numR] > 0)
       printf("FC3D_UE_DEBUG: The last attempt is R_T1 or R_T2 equal to 0?\n");
 #endif
-    //    double R=Racines[numR];
-    double theta = PossiblesTheta[numR]; //2*atan(R);
-    double costheta = cos(theta);
-    double sintheta = sin(theta);
-    double radius = p / (1 + e * cos(theta - phi));
+    double costheta = ct[numR];
+    double sintheta = st[numR];
+    double radius = rad[numR];
     double fabsradius = fabs(radius);
     RTb[0] = radius * costheta;
     RTb[1] = radius * sintheta;
@@ -500,10 +542,10 @@ int fc3d_unitary_enumerative_solve_sliding(FrictionContactProblem* problem, doub
     *reaction0 = sqrt((*reaction1) * (*reaction1) + (*reaction2) * (*reaction2)) / (*mu);
 
     //In particular case RTb[x]==0, then check :
-    if(numR >= nbRealRacines)
+    if(kind[numR] > 0)
     {
       //RTb[0]==0
-      if(numR < nbRealRacines + 2)
+      if(kind[numR] == 1)
       {
         alpha = (-Q2b[1] + a2 * fabsradius) / RTb[1] - D2;
         if(fabs(Q2b[0] - a1 * fabsradius) > tol)
@@ -526,10 +568,10 @@ int fc3d_unitary_enumerative_solve_sliding(FrictionContactProblem* problem, doub
 #ifdef FC3D_UE_DEBUG
     double alpha1 = 0.0;
     double alpha2 = 0.0;
-    if(numR >= nbRealRacines)
+    if(kind[numR] > 0)
     {
       //RTb[0]==0
-      if(numR < nbRealRacines + 2)
+      if(kind[numR] == 1)
         alpha1 = (-Q2b[1] + a2 * fabsradius) / RTb[1] - D2;
       else
         alpha2 = (-Q2b[0] + a1 * fabsradius) / RTb[0] - D1;
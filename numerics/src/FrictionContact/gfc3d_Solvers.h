@@ -174,6 +174,28 @@ extern "C"
   */
   void gfc3d_nsgs(GlobalFrictionContactProblem* problem, double *reaction , double *velocity, double* globalVelocity, int* info, SolverOptions* options);
 
+  /** Distributed-memory variant of gfc3d_nsgs() over the MPI communicator
+      attached to problem->M (see NM_MPI_set_comm()).
+
+      The contact constraint graph is partitioned with
+      gfc3d_partition_contact_graph(), one part per rank; each sweep
+      relaxes the owned contacts and exchanges only the boundary
+      reactions, which is exact when the mass matrix does not couple the
+      parts. Error evaluation gathers the full reaction vector so that
+      all the ranks take the same stopping decision. All the ranks of the
+      communicator must call the solver with the same problem and
+      options. Without MPI support or on a single rank, gfc3d_nsgs() is
+      called instead.
+
+      \param problem the global friction-contact 3D problem to solve
+      \param reaction global vector (n), in-out parameter
+      \param velocity global vector (n), in-out parameter
+      \param globalVelocity global vector
+      \param info return 0 if the solution is found
+      \param options the solver options
+  */
+  void gfc3d_nsgs_mpi(GlobalFrictionContactProblem* problem, double *reaction, double *velocity, double* globalVelocity, int* info, SolverOptions* options);
+
   /** 
       Solver based on the fixed-point iteration proposed by Cadoux for friction-contact 3D problem
       
@@ -26,6 +26,8 @@
 #include "siconos_debug.h"                         // for DEBUG_EXPR
 #include "gfc3d_Solvers.h"                 // for gfc3d_ACLMFixedPoint, gfc3...
 #include "numerics_verbose.h"              // for numerics_printf_verbose
+#include "NumericsPerfCounters.h"          // for perf_counters_begin
+#include "NumericsTrace.h"                 // for SN_TRACE
 #include "gfc3d_balancing.h"
 #include "gfc3d_compute_error.h"
 #include "SiconosBlas.h"                         // for cblas_dcopy, cblas_dscal
@@ -42,6 +44,7 @@ const char* const SICONOS_GLOBAL_FRICTION_3D_PROX_WR_STR = "GFC3D_PROX_WR";
 const char* const SICONOS_GLOBAL_FRICTION_3D_DSFP_WR_STR = "GFC3D_DSFP_WR";
 const char* const SICONOS_GLOBAL_FRICTION_3D_TFP_WR_STR = "GFC3D_TFP_WR";
 const char* const SICONOS_GLOBAL_FRICTION_3D_NSGS_STR = "GFC3D_NSGS";
+const char* const SICONOS_GLOBAL_FRICTION_3D_NSGS_MPI_STR = "GFC3D_NSGS_MPI";
 const char* const SICONOS_GLOBAL_FRICTION_3D_NSN_AC_STR = "GFC3D_NSN_AC";
 const char* const  SICONOS_GLOBAL_FRICTION_3D_GAMS_PATH_STR = "GFC3D_GAMS_PATH";
 const char* const  SICONOS_GLOBAL_FRICTION_3D_GAMS_PATHVI_STR = "GFC3D_GAMS_PATHVI";
@@ -118,6 +121,13 @@ int gfc3d_driver(GlobalFrictionContactProblem* problem, double *reaction, double
     return 0;
   }
 
+  PerfCountersHandle perf_handle;
+  int collect_perf = options->stats && options->stats->collect_perf;
+  if(collect_perf) perf_counters_begin(&perf_handle);
+
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_BEGIN, 0,
+           (double)problem->numberOfContacts);
+
   /* Non Smooth Gauss Seidel (NSGS) */
   switch(options->solverId)
   {
@@ -174,6 +184,13 @@ int gfc3d_driver(GlobalFrictionContactProblem* problem, double *reaction, double
                &info, options);
     break;
 
+  }
+  case SICONOS_GLOBAL_FRICTION_3D_NSGS_MPI:
+  {
+    gfc3d_nsgs_mpi(problem, reaction, velocity, globalVelocity,
+                   &info, options);
+    break;
+
   }
   case SICONOS_GLOBAL_FRICTION_3D_NSN_AC:
   {
@@ -263,6 +280,12 @@ int gfc3d_driver(GlobalFrictionContactProblem* problem, double *reaction, double
   }
   }
 
+  if(collect_perf) perf_counters_end(&perf_handle, &options->stats->perf);
+
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_END,
+           options->iparam[SICONOS_IPARAM_ITER_DONE],
+           options->dparam[SICONOS_DPARAM_RESIDU]);
+
   return info;
 
 }
@@ -33,6 +33,7 @@
 #include "JordanAlgebra.h"
 
 #include "NumericsSparseMatrix.h"
+#include "NumericsTrace.h"
 
 
 /* #define DEBUG_MESSAGES */
@@ -93,6 +94,12 @@ typedef struct
 
   double **tmp_vault_nd;
   double **tmp_vault_m;
+
+  /* cached symbolic analysis of the KKT matrix, carried from one linear
+     solve to the next while the contact topology is unchanged */
+  void* kkt_symbolic;
+  CS_INT kkt_symbolic_n;
+  CS_INT kkt_symbolic_nnz;
 }
 Gfc3d_IPM_init_data;
 
@@ -337,6 +344,18 @@ static double complemResidualNorm(const double * const velocity, const double *
   return norm2 / (double)varsCount;
 }
 
+/* Push one cone block strictly inside the second-order cone, so that a
+ * retained final iterate can serve as a feasible starting point:
+ * x0 >= (1 + margin) |x_t| + floor. */
+static void shiftIntoCone(double* x, unsigned int d)
+{
+  double nt = 0.0;
+  for(unsigned int k = 1; k < d; ++k) nt += x[k] * x[k];
+  nt = sqrt(nt);
+  double x0_min = 1.01 * nt + 1e-7;
+  if(x[0] < x0_min) x[0] = x0_min;
+}
+
 static void setErrorArray(double * error, const double pinfeas, const double dinfeas,
                           const double complem, const double barr_param)
 {
@@ -469,6 +488,11 @@ void gfc3d_IPM_init(GlobalFrictionContactProblem* problem, SolverOptions* option
   for(unsigned int i = 0; i < 2; ++i)
     data->tmp_vault_m[i] = (double*)calloc(m, sizeof(double));
 
+  /* no KKT symbolic analysis yet */
+  data->kkt_symbolic = NULL;
+  data->kkt_symbolic_n = 0;
+  data->kkt_symbolic_nnz = 0;
+
 }
 
 void gfc3d_IPM_free(GlobalFrictionContactProblem* problem, SolverOptions* options)
@@ -526,6 +550,12 @@ void gfc3d_IPM_free(GlobalFrictionContactProblem* problem, SolverOptions* option
     free(data->tmp_point);
 
     free(data->internal_params);
+
+    if(data->kkt_symbolic)
+    {
+      cs_sfree((css*)data->kkt_symbolic);
+      data->kkt_symbolic = NULL;
+    }
   }
 
 }
@@ -570,10 +600,21 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
     H_tilde = NM_transpose(problem->H);
   }
 
+  int warm_start = options->iparam[SICONOS_FRICTION_3D_IPM_IPARAM_WARM_START] ==
+                   SICONOS_FRICTION_3D_IPM_WARM_START_YES;
+
   // initialize solver if it is not set
   int internal_allocation=0;
   if(!options->dWork || (options->dWorkSize != (size_t)(m + nd + nd)))
   {
+    if(options->solverData)
+    {
+      /* state retained by a previous call, but the problem sizes have
+         changed: rebuild everything */
+      gfc3d_IPM_free(problem, options);
+      free(options->solverData);
+      options->solverData = NULL;
+    }
     gfc3d_IPM_init(problem, options);
     internal_allocation = 1;
   }
@@ -700,6 +741,7 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
   double norm_q = cblas_dnrm2(m, problem->q, 1);
   double norm_b = cblas_dnrm2(nd, problem->b, 1);
 
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_BEGIN, 0, (double)n);
 
   while(iteration < max_iter)
   {
@@ -719,6 +761,12 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
 
     setErrorArray(error, pinfeas, dinfeas, complem, barr_param);
 
+    SN_TRACE(options->solverId, NUMERICS_TRACE_ITERATION, iteration,
+             NV_max(error, 4));
+
+    if(options->stats)
+      solver_options_stats_push(options, iteration, NV_max(error, 4), alpha_primal, -1);
+
     numerics_printf_verbose(-1, "---- GFC3D - IPM - | %3i | %.2e | %.2e | %.2e | %.2e | %.2e | %.2e | %.2e |",
                             iteration, barr_param, pinfeas, dinfeas, complem, alpha_primal, alpha_dual, sigma);
 
@@ -761,6 +809,18 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
     NM_insert(J, minus_H, m + nd, 0);
     NM_insert(J, NM_eye(nd), m + nd, m);
 
+    /* hand the cached KKT symbolic analysis over to this J: the
+       sparsity pattern only changes with the contact topology, so the
+       LU factorization can skip the fill-reducing analysis */
+    if(data->kkt_symbolic)
+    {
+      NSM_linear_solver_params* Jp = NSM_linearSolverParams(J);
+      Jp->symbolic_analysis = data->kkt_symbolic;
+      Jp->symbolic_n = data->kkt_symbolic_n;
+      Jp->symbolic_nnz = data->kkt_symbolic_nnz;
+      data->kkt_symbolic = NULL;
+    }
+
     /* 2. ---- Predictor step of Mehrotra ---- */
 
     /*  2.1 Build predictor right-hand side */
@@ -862,6 +922,20 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
     // NM_gesv_expert(J, rhs, NM_KEEP_FACTORS);
     NM_LU_solve(J, rhs, 1);
 
+    /* take the symbolic analysis back before J is destroyed, for the
+       next KKT solve (and the next call when the state is retained) */
+    {
+      NSM_linear_solver_params* Jp = NSM_linearSolverParams(J);
+      if(Jp->symbolic_analysis)
+      {
+        if(data->kkt_symbolic) cs_sfree((css*)data->kkt_symbolic);
+        data->kkt_symbolic = Jp->symbolic_analysis;
+        data->kkt_symbolic_n = Jp->symbolic_n;
+        data->kkt_symbolic_nnz = Jp->symbolic_nnz;
+        Jp->symbolic_analysis = NULL;
+      }
+    }
+
     NM_clear(J);
     free(J);
 
@@ -926,6 +1000,27 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
 
   }
 
+  if(warm_start)
+  {
+    /* Retain the final iterate (in the scaled variables) as the
+       starting point of the next call, shifted strictly inside the
+       cones, and restart from a reduced barrier parameter instead of 1:
+       successive timesteps then only have to recover the centrality
+       lost by the shift. */
+    cblas_dcopy(m, globalVelocity, 1, data->starting_point->globalVelocity, 1);
+    cblas_dcopy(nd, velocity, 1, data->starting_point->velocity, 1);
+    cblas_dcopy(nd, reaction, 1, data->starting_point->reaction, 1);
+    for(unsigned int i = 0; i < nd; i += d)
+    {
+      shiftIntoCone(&data->starting_point->velocity[i], d);
+      shiftIntoCone(&data->starting_point->reaction[i], d);
+    }
+    data->internal_params->barr_param = fmax(10.0 * barr_param, sqrt(tol));
+    data->internal_params->sigma = sigma;
+    data->internal_params->alpha_primal = alpha_primal;
+    data->internal_params->alpha_dual = alpha_dual;
+  }
+
   /* ----- return to original variables ------ */
   NM_gemv(1.0, P_mu_inv, velocity, 0.0, data->tmp_point->t_velocity);
   cblas_dcopy(nd, data->tmp_point->t_velocity, 1, velocity, 1);
@@ -946,7 +1041,10 @@ void gfc3d_IPM(GlobalFrictionContactProblem* restrict problem, double* restrict
   options->dparam[SICONOS_DPARAM_RESIDU] = NV_max(error, 4);
   options->iparam[SICONOS_IPARAM_ITER_DONE] = iteration;
 
-  if(internal_allocation)
+  SN_TRACE(options->solverId, NUMERICS_TRACE_SOLVE_END, iteration,
+           NV_max(error, 4));
+
+  if(internal_allocation && !warm_start)
   {
     gfc3d_IPM_free(problem,options);
   }
@@ -970,6 +1068,9 @@ void gfc3d_ipm_set_default(SolverOptions* options)
 
   options->iparam[SICONOS_FRICTION_3D_IPM_IPARAM_NESTEROV_TODD_SCALING] = 1;
 
+  options->iparam[SICONOS_FRICTION_3D_IPM_IPARAM_WARM_START] =
+    SICONOS_FRICTION_3D_IPM_WARM_START_NO;
+
   options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_UPDATE_S]=
     SICONOS_FRICTION_3D_ADMM_UPDATE_S_NO;
 
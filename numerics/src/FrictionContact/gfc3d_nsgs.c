@@ -18,7 +18,9 @@
 #include <assert.h>                        // for assert
 #include <math.h>                          // for sqrt
 #include <stdio.h>                         // for fprintf, NULL, stderr
-#include <stdlib.h>                        // for exit, EXIT_FAILURE
+#include <stdlib.h>                        // for exit, EXIT_FAILURE, malloc
+#include <string.h>                        // for memcpy
+#include "CSparseMatrix_internal.h"        // for CSparseMatrix, CS_INT
 #include "Friction_cst.h"                  // for SICONOS_FRICTION_3D_IPARAM...
 #include "SiconosBlas.h"                         // for cblas_dcopy, cblas_dnrm2
 #include "GlobalFrictionContactProblem.h"  // for GlobalFrictionContactProblem
@@ -114,24 +116,105 @@ void gfc3d_nsgs(GlobalFrictionContactProblem* restrict problem, double* restrict
 
   double norm_q = cblas_dnrm2(n, problem->q, 1);
   double norm_b = cblas_dnrm2(m, problem->b, 1);
+
+  /* Incremental maintenance of the global velocity: the columns of
+     M^{-1}H are cached once, so that each contact can push its reaction
+     change into v with three saxpy instead of the full-size products
+     and resolution v = M^{-1}(H r + q) of every sweep. The local
+     velocity of a contact is read back through the columns of H it
+     touches, which also turns the sweep into a true Gauss-Seidel
+     iteration on fresh velocities. */
+  double* MinvH = NULL;
+  CSparseMatrix* Hcsc = NULL;
+  if(iparam[SICONOS_FRICTION_3D_NSGS_INCREMENTAL_GLOBAL_VELOCITY]
+      == SICONOS_FRICTION_3D_NSGS_INCREMENTAL_GLOBAL_VELOCITY_TRUE
+      && nc > 0)
+  {
+    MinvH = (double*)malloc((size_t)n * (size_t)m * sizeof(double));
+    if(MinvH)
+    {
+      NumericsMatrix* Hdense = NM_create(NM_DENSE, n, m);
+      NM_to_dense(H, Hdense);
+      memcpy(MinvH, Hdense->matrix0, (size_t)n * (size_t)m * sizeof(double));
+      NM_free(Hdense);
+      if(NM_LU_solve(problem->M, MinvH, m))
+      {
+        free(MinvH);
+        MinvH = NULL;
+      }
+    }
+    if(!MinvH)
+      numerics_warning("gfc3d_nsgs",
+                       "could not cache M^{-1}H, falling back on full products");
+    else if(H->storageType == NM_SPARSE)
+      Hcsc = NM_csc(H);
+  }
+
   /* verbose=1; */
   while((iter < itermax) && (hasNotConverged > 0))
   {
     ++iter;
     /* Solve the first part with the current reaction */
     DEBUG_PRINTF("--------- iter = %i\n", iter);
-    /* globalVelocity <--q */
-    cblas_dcopy_msan(n, q, 1, globalVelocity, 1);
-    /* globalVelocity = H reaction + globalVelocity */
-    if(nc > 0) NM_gemv(1., H, reaction, 1., globalVelocity);
+    if(!MinvH || iter == 1)
+    {
+      /* globalVelocity <--q */
+      cblas_dcopy_msan(n, q, 1, globalVelocity, 1);
+      /* globalVelocity = H reaction + globalVelocity */
+      if(nc > 0) NM_gemv(1., H, reaction, 1., globalVelocity);
 
-    // CHECK_RETURN(!NM_gesv_expert(problem->M, globalVelocity, NM_KEEP_FACTORS));
-    CHECK_RETURN(!NM_LU_solve(problem->M, globalVelocity, 1));
+      // CHECK_RETURN(!NM_gesv_expert(problem->M, globalVelocity, NM_KEEP_FACTORS));
+      CHECK_RETURN(!NM_LU_solve(problem->M, globalVelocity, 1));
+    }
 
     DEBUG_EXPR(NM_vector_display(reaction,m));
     DEBUG_EXPR(NM_vector_display(globalVelocity,n));
 
-    if(nc > 0)
+    if(nc > 0 && MinvH)
+    {
+      /* Loop through the contact points on the maintained velocity */
+      for(contact = 0 ; contact < nc ; ++contact)
+      {
+        int pos = contact * 3;
+        double uloc[3];
+        for(int k = 0 ; k < 3 ; ++k)
+        {
+          int col = pos + k;
+          double s = b[col];
+          if(Hcsc)
+          {
+            for(CS_INT idx = Hcsc->p[col] ; idx < Hcsc->p[col + 1] ; ++idx)
+              s += Hcsc->x[idx] * globalVelocity[Hcsc->i[idx]];
+          }
+          else
+            s += cblas_ddot(n, &H->matrix0[(size_t)col * n], 1,
+                            globalVelocity, 1);
+          uloc[k] = s;
+        }
+
+        double reaction_old[3] = { reaction[pos], reaction[pos + 1],
+                                   reaction[pos + 2] };
+        double normUT = sqrt(uloc[1] * uloc[1] + uloc[2] * uloc[2]);
+        double an = 1.0;
+        reaction[pos] -= an * (uloc[0] + mu[contact] * normUT);
+        reaction[pos + 1] -= an * uloc[1];
+        reaction[pos + 2] -= an * uloc[2];
+        projectionOnCone(&reaction[pos], mu[contact]);
+
+        for(int k = 0 ; k < 3 ; ++k)
+        {
+          double dr = reaction[pos + k] - reaction_old[k];
+          if(dr != 0.0)
+            cblas_daxpy(n, dr, &MinvH[(size_t)(pos + k) * n], 1,
+                        globalVelocity, 1);
+        }
+      }
+      /* refresh the local velocity vector for the error evaluation */
+      cblas_dcopy(m, b, 1, velocity, 1);
+      NM_tgemv(1., H, globalVelocity, 1., velocity);
+      DEBUG_EXPR(NM_vector_display(reaction,m););
+    }
+    else if(nc > 0)
     {
       /* Compute current local velocity */
       /*      velocity <--b */
@@ -152,8 +235,8 @@ void gfc3d_nsgs(GlobalFrictionContactProblem* restrict problem, double* restrict
 //      reaction[pos] -= an * mu[contact] * normUT;
         reaction[pos + 1] -= an * velocity[pos + 1];
         reaction[pos + 2] -= an * velocity[pos + 2];
-        projectionOnCone(&reaction[pos], mu[contact]);
       }
+      projectionOnCone_batch(nc, reaction, mu);
       DEBUG_EXPR(NM_vector_display(reaction,m););
     }
 
@@ -189,5 +272,6 @@ void gfc3d_nsgs(GlobalFrictionContactProblem* restrict problem, double* restrict
 
 
   /***** Free memory *****/
+  if(MinvH) free(MinvH);
   (*freeSolver)(problem);
 }
@@ -0,0 +1,244 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include <assert.h>                        // for assert
+#include <math.h>                          // for sqrt
+#include <stdio.h>                         // for fprintf, NULL, stderr
+#include <stdlib.h>                        // for exit, EXIT_FAILURE
+#include "Friction_cst.h"                  // for SICONOS_FRICTION_3D_IPARAM...
+#include "SiconosBlas.h"                   // for cblas_dcopy, cblas_dnrm2
+#include "GlobalFrictionContactProblem.h"  // for GlobalFrictionContactProblem
+#include "NumericsFwd.h"                   // for GlobalFrictionContactProblem
+#include "NumericsMatrix.h"                // for NumericsMatrix, NM_gemv
+#include "NM_MPI.h"                        // for NM_MPI_comm, CHECK_MPI
+#include "SolverOptions.h"                 // for SolverOptions, SICONOS_DPA...
+#include "gfc3d_Solvers.h"                 // for gfc3d_nsgs, gfc3d_checkTri...
+#include "gfc3d_compute_error.h"           // for gfc3d_compute_error
+#include "gfc3d_partition.h"               // for gfc3d_partition_contact_graph
+#include "numerics_verbose.h"              // for numerics_printf_verbose
+#include "projectionOnCone.h"              // for projectionOnCone
+#include "sanitizer.h"                     // for cblas_dcopy_msan
+
+#ifdef SICONOS_HAS_MPI
+
+/* Exchange plan over the communicator: each rank owns the contacts of its
+   part; per sweep only the reactions of the boundary contacts travel,
+   through an MPI_Allgatherv whose layout every rank derives independently
+   from the (deterministic) partition. The lists are ordered by owner rank,
+   then by contact index. */
+typedef struct
+{
+  unsigned int* list;  /**< contact indices, grouped by owner rank */
+  int* counts;         /**< number of doubles sent by each rank */
+  int* displs;         /**< displacements, in doubles */
+  double* buffer;      /**< gather buffer, 3 doubles per listed contact */
+  unsigned int total;  /**< total number of listed contacts */
+} gfc3d_exchange_plan;
+
+static void exchange_plan_build(gfc3d_exchange_plan* plan, unsigned int nc,
+                                const unsigned int* part, int nranks,
+                                const unsigned char* mask)
+{
+  plan->list = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  plan->counts = (int*)calloc(nranks, sizeof(int));
+  plan->displs = (int*)calloc(nranks, sizeof(int));
+  plan->total = 0;
+  for(int p = 0; p < nranks; ++p)
+  {
+    plan->displs[p] = 3 * (int)plan->total;
+    for(unsigned int c = 0; c < nc; ++c)
+    {
+      if((int)part[c] == p && (!mask || mask[c]))
+      {
+        plan->list[plan->total++] = c;
+        plan->counts[p] += 3;
+      }
+    }
+  }
+  plan->buffer = (double*)malloc(3 * (plan->total ? plan->total : 1) * sizeof(double));
+}
+
+static void exchange_plan_free(gfc3d_exchange_plan* plan)
+{
+  free(plan->list);
+  free(plan->counts);
+  free(plan->displs);
+  free(plan->buffer);
+}
+
+/* Gather the listed reactions of every rank and scatter them back into the
+   global reaction vector, so that all the ranks agree on the listed part. */
+static void exchange_plan_run(gfc3d_exchange_plan* plan, double* reaction,
+                              int rank, MPI_Comm comm)
+{
+  unsigned int first = (unsigned int)(plan->displs[rank] / 3);
+  unsigned int mine = (unsigned int)(plan->counts[rank] / 3);
+  double* sendbuf = plan->buffer + plan->displs[rank];
+  for(unsigned int k = 0; k < mine; ++k)
+    cblas_dcopy(3, &reaction[plan->list[first + k] * 3], 1, &sendbuf[3 * k], 1);
+  CHECK_MPI(comm, MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                                 plan->buffer, plan->counts, plan->displs,
+                                 MPI_DOUBLE, comm));
+  for(unsigned int k = 0; k < plan->total; ++k)
+    cblas_dcopy(3, &plan->buffer[3 * k], 1, &reaction[plan->list[k] * 3], 1);
+}
+
+#endif /* SICONOS_HAS_MPI */
+
+void gfc3d_nsgs_mpi(GlobalFrictionContactProblem* restrict problem, double* restrict reaction,
+                    double* restrict velocity, double* restrict globalVelocity,
+                    int* restrict info, SolverOptions* restrict options)
+{
+#ifdef SICONOS_HAS_MPI
+  MPI_Comm comm = NM_MPI_comm(problem->M);
+  int nranks, rank;
+  CHECK_MPI(comm, MPI_Comm_size(comm, &nranks));
+  CHECK_MPI(comm, MPI_Comm_rank(comm, &rank));
+
+  if(nranks < 2)
+  {
+    gfc3d_nsgs(problem, reaction, velocity, globalVelocity, info, options);
+    return;
+  }
+
+  int* iparam = options->iparam;
+  double* dparam = options->dparam;
+  int nc = problem->numberOfContacts;
+  int n = problem->M->size0;
+  int m = 3 * nc;
+  NumericsMatrix* M = problem->M;
+  NumericsMatrix* H = problem->H;
+  double* q = problem->q;
+  double* b = problem->b;
+  double* mu = problem->mu;
+
+  assert((int)H->size1 == problem->numberOfContacts * problem->dimension);
+  assert((int)M->size0 == M->size1);
+  assert((int)M->size0 == H->size0);
+
+  int itermax = iparam[SICONOS_IPARAM_MAX_ITER];
+  double tolerance = dparam[SICONOS_DPARAM_TOL];
+
+  /* Trivial case: deterministic, so every rank takes the same branch. */
+  *info = gfc3d_checkTrivialCaseGlobal(n, q, velocity, reaction, globalVelocity, options);
+  if(*info == 0)
+    return;
+
+  if(H->storageType != M->storageType)
+  {
+    fprintf(stderr, "Numerics, gfc3d_nsgs_mpi. H->storageType != M->storageType: This case is not taken into account.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /* Every rank computes the same partition; rank p owns part p. The
+     sweep only needs the reactions of the contacts it shares a degree of
+     freedom with, so between two sweeps only the boundary reactions are
+     exchanged: this is exact as long as M does not couple the parts (a
+     block diagonal mass matrix), which also ensures that the stale
+     interior reactions of the other ranks never reach the rows of the
+     owned contacts. Error evaluation gathers the full reaction vector
+     first, so that the criterion is the collective one. */
+  unsigned int* part = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  unsigned int nparts = gfc3d_partition_contact_graph(problem, nranks, part);
+  unsigned char* is_boundary = (unsigned char*)malloc(nc * sizeof(unsigned char));
+  unsigned int nb = gfc3d_partition_boundary(problem, part, is_boundary);
+
+  numerics_printf_verbose(1, "---- GFC3D - NSGS MPI - %i contacts in %i parts, "
+                          "%i on a boundary", nc, nparts, nb);
+
+  gfc3d_exchange_plan boundary_plan, full_plan;
+  exchange_plan_build(&boundary_plan, nc, part, nranks, is_boundary);
+  exchange_plan_build(&full_plan, nc, part, nranks, NULL);
+
+  int iter = 0;
+  double error = 1.;
+  int hasNotConverged = 1;
+
+  double norm_q = cblas_dnrm2(n, problem->q, 1);
+  double norm_b = cblas_dnrm2(m, problem->b, 1);
+
+  while((iter < itermax) && (hasNotConverged > 0))
+  {
+    ++iter;
+    /* globalVelocity <-- M^{-1} (q + H reaction) */
+    cblas_dcopy_msan(n, q, 1, globalVelocity, 1);
+    if(nc > 0) NM_gemv(1., H, reaction, 1., globalVelocity);
+    CHECK_RETURN(!NM_LU_solve(problem->M, globalVelocity, 1));
+
+    if(nc > 0)
+    {
+      /* velocity <-- b + H^T globalVelocity */
+      cblas_dcopy(m, b, 1, velocity, 1);
+      NM_tgemv(1., H, globalVelocity, 1., velocity);
+
+      /* Relax the owned contacts only. */
+      for(int contact = 0; contact < nc; ++contact)
+      {
+        if((int)part[contact] != rank) continue;
+        int pos = contact * 3;
+        double normUT = sqrt(velocity[pos + 1] * velocity[pos + 1] + velocity[pos + 2] * velocity[pos + 2]);
+        double an = 1.0;
+        reaction[pos] -= an * (velocity[pos] + mu[contact] * normUT);
+        reaction[pos + 1] -= an * velocity[pos + 1];
+        reaction[pos + 2] -= an * velocity[pos + 2];
+        projectionOnCone(&reaction[pos], mu[contact]);
+      }
+
+      /* Only the boundary reactions travel between the sweeps. */
+      exchange_plan_run(&boundary_plan, reaction, rank, comm);
+    }
+
+    /* **** Criterium convergence **** */
+    int evaluate = 1;
+    if(options->iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION_FREQUENCY] > 0)
+      evaluate = !(iter % options->iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION_FREQUENCY]);
+    if(evaluate)
+    {
+      /* The full error needs all the reactions; after the gather every
+         rank evaluates the same criterion on the same data, so the
+         stopping decision is collective without an extra reduction. */
+      exchange_plan_run(&full_plan, reaction, rank, comm);
+      gfc3d_compute_error(problem, reaction, velocity, globalVelocity,
+                          tolerance, options, norm_q, norm_b, &error);
+      numerics_printf_verbose(1, "---- GFC3D - NSGS MPI - Iteration %i Residual = %14.7e; Tol = %g", iter, error, tolerance);
+      if(error < tolerance) hasNotConverged = 0;
+    }
+    *info = hasNotConverged;
+  }
+
+  /* One last error computation in case we stopped on itermax. */
+  if(iter == itermax)
+  {
+    exchange_plan_run(&full_plan, reaction, rank, comm);
+    gfc3d_compute_error(problem, reaction, velocity, globalVelocity,
+                        tolerance, options, norm_q, norm_b, &error);
+  }
+
+  dparam[SICONOS_DPARAM_TOL] = tolerance;
+  dparam[SICONOS_DPARAM_RESIDU] = error;
+  iparam[SICONOS_IPARAM_ITER_DONE] = iter;
+
+  exchange_plan_free(&full_plan);
+  exchange_plan_free(&boundary_plan);
+  free(is_boundary);
+  free(part);
+#else
+  numerics_printf_verbose(0, "gfc3d_nsgs_mpi - Siconos was built without MPI, "
+                          "running the sequential NSGS sweep");
+  gfc3d_nsgs(problem, reaction, velocity, globalVelocity, info, options);
+#endif
+}
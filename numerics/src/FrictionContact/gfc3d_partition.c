@@ -0,0 +1,182 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "gfc3d_partition.h"
+
+#include <assert.h>                        // for assert
+#include <stdlib.h>                        // for calloc, malloc, free
+#include "CSparseMatrix_internal.h"        // for CSparseMatrix, CS_INT
+#include "GlobalFrictionContactProblem.h"  // for GlobalFrictionContactProblem
+#include "NumericsMatrix.h"                // for NumericsMatrix, NM_csc
+
+/* Bipartite incidence between the rows of H (degrees of freedom) and the
+   contacts: row_index/row_contact list, for each row, the contacts whose
+   column block touches it. The contact graph is never stored explicitly;
+   the neighbors of a contact are enumerated through the rows it touches. */
+static void build_row_incidence(GlobalFrictionContactProblem* problem,
+                                size_t** p_row_index,
+                                unsigned int** p_row_contact)
+{
+  CSparseMatrix* H = NM_csc(problem->H);
+  unsigned int d = problem->dimension;
+  size_t nrows = (size_t)H->m;
+  size_t nnz = (size_t)H->p[H->n];
+
+  size_t* row_index = (size_t*)calloc(nrows + 1, sizeof(size_t));
+  for(size_t k = 0; k < nnz; ++k)
+    row_index[H->i[k] + 1]++;
+  for(size_t i = 0; i < nrows; ++i)
+    row_index[i + 1] += row_index[i];
+
+  unsigned int* row_contact = (unsigned int*)malloc(nnz * sizeof(unsigned int));
+  size_t* fill = (size_t*)calloc(nrows, sizeof(size_t));
+  for(CS_INT col = 0; col < H->n; ++col)
+  {
+    unsigned int contact = (unsigned int)(col / d);
+    for(CS_INT k = H->p[col]; k < H->p[col + 1]; ++k)
+      row_contact[row_index[H->i[k]] + fill[H->i[k]]++] = contact;
+  }
+  free(fill);
+
+  *p_row_index = row_index;
+  *p_row_contact = row_contact;
+}
+
+unsigned int gfc3d_partition_contact_graph(GlobalFrictionContactProblem* problem,
+                                           unsigned int nparts,
+                                           unsigned int* part)
+{
+  unsigned int nc = problem->numberOfContacts;
+  unsigned int d = problem->dimension;
+
+  assert(nparts > 0);
+
+  if(nparts == 1 || nc <= nparts)
+  {
+    for(unsigned int c = 0; c < nc; ++c)
+      part[c] = (nparts == 1) ? 0 : c % nparts;
+    return (nparts == 1) ? 1 : ((nc < nparts) ? nc : nparts);
+  }
+
+  size_t* row_index;
+  unsigned int* row_contact;
+  build_row_incidence(problem, &row_index, &row_contact);
+  CSparseMatrix* H = NM_csc(problem->H);
+
+  for(unsigned int c = 0; c < nc; ++c)
+    part[c] = nparts; /* unassigned */
+
+  unsigned int* queue = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  unsigned int target = (nc + nparts - 1) / nparts;
+  unsigned int next_seed = 0;
+  unsigned int assigned = 0;
+  unsigned int p = 0;
+
+  while(assigned < nc)
+  {
+    unsigned int part_size = 0;
+    /* Grow part p with breadth-first traversals, reseeding on another
+       connected component whenever the frontier dries up early. */
+    while(part_size < target && assigned < nc)
+    {
+      while(next_seed < nc && part[next_seed] < nparts)
+        ++next_seed;
+      if(next_seed == nc)
+        break;
+      unsigned int head = 0, tail = 0;
+      queue[tail++] = next_seed;
+      part[next_seed] = p;
+      ++part_size;
+      ++assigned;
+      while(head < tail && part_size < target)
+      {
+        unsigned int c = queue[head++];
+        /* neighbors of c: the contacts of every row its columns touch */
+        for(unsigned int j = 0; j < d; ++j)
+        {
+          CS_INT col = (CS_INT)c * d + j;
+          for(CS_INT k = H->p[col]; k < H->p[col + 1]; ++k)
+          {
+            size_t row = (size_t)H->i[k];
+            for(size_t l = row_index[row]; l < row_index[row + 1]; ++l)
+            {
+              unsigned int neighbor = row_contact[l];
+              if(part[neighbor] == nparts && part_size < target)
+              {
+                part[neighbor] = p;
+                queue[tail++] = neighbor;
+                ++part_size;
+                ++assigned;
+              }
+            }
+          }
+        }
+      }
+    }
+    if(part_size > 0 && p < nparts - 1)
+      ++p;
+    else if(part_size == 0)
+      break;
+  }
+
+  free(queue);
+  free(row_contact);
+  free(row_index);
+  return p + 1;
+}
+
+unsigned int gfc3d_partition_boundary(GlobalFrictionContactProblem* problem,
+                                      const unsigned int* part,
+                                      unsigned char* is_boundary)
+{
+  unsigned int nc = problem->numberOfContacts;
+
+  size_t* row_index;
+  unsigned int* row_contact;
+  build_row_incidence(problem, &row_index, &row_contact);
+  CSparseMatrix* H = NM_csc(problem->H);
+  size_t nrows = (size_t)H->m;
+
+  for(unsigned int c = 0; c < nc; ++c)
+    is_boundary[c] = 0;
+
+  /* A row shared by contacts of different parts makes all of them
+     boundary contacts. */
+  for(size_t i = 0; i < nrows; ++i)
+  {
+    unsigned int first_part = 0;
+    int mixed = 0;
+    for(size_t l = row_index[i]; l < row_index[i + 1]; ++l)
+    {
+      if(l == row_index[i])
+        first_part = part[row_contact[l]];
+      else if(part[row_contact[l]] != first_part)
+        mixed = 1;
+    }
+    if(mixed)
+      for(size_t l = row_index[i]; l < row_index[i + 1]; ++l)
+        is_boundary[row_contact[l]] = 1;
+  }
+
+  unsigned int nb = 0;
+  for(unsigned int c = 0; c < nc; ++c)
+    nb += is_boundary[c];
+
+  free(row_contact);
+  free(row_index);
+  return nb;
+}
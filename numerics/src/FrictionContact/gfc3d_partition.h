@@ -0,0 +1,73 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef GFC3D_PARTITION_H
+#define GFC3D_PARTITION_H
+
+/*!\file gfc3d_partition.h
+  Partitioning of the contact constraint graph of a global friction-contact
+  3D problem, for distributed solvers. Two contacts are adjacent whenever
+  their column blocks of H share a row, i.e. whenever they act on a common
+  degree of freedom.
+*/
+
+#include "NumericsFwd.h"   // for GlobalFrictionContactProblem
+#include "SiconosConfig.h" // for BUILD_AS_CPP // IWYU pragma: keep
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** Partition the contact constraint graph into nparts balanced parts.
+   *
+   *  The part vector has the semantics of the part array of
+   *  METIS_PartGraphKway, so a METIS backend can be substituted without
+   *  touching the callers; the built-in partitioner grows connected parts
+   *  of balanced size with a breadth-first traversal, which keeps the
+   *  number of cut edges low on the banded contact graphs produced by
+   *  spatially coherent scenes. All the ranks of a distributed solver can
+   *  call it independently: the result is deterministic.
+   *
+   *  \param problem the global friction-contact 3D problem
+   *  \param nparts the requested number of parts
+   *  \param[out] part the part of each contact (size numberOfContacts)
+   *  \return the number of nonempty parts (<= nparts)
+   */
+  unsigned int gfc3d_partition_contact_graph(GlobalFrictionContactProblem* problem,
+                                             unsigned int nparts,
+                                             unsigned int* part);
+
+  /** Mark the boundary contacts of a partition: a contact is a boundary
+   *  one when it shares a degree of freedom with a contact of another
+   *  part. Only their reactions have to travel between parts during a
+   *  distributed Gauss-Seidel sweep.
+   *
+   *  \param problem the global friction-contact 3D problem
+   *  \param part the part of each contact, from gfc3d_partition_contact_graph()
+   *  \param[out] is_boundary nonzero for boundary contacts (size numberOfContacts)
+   *  \return the number of boundary contacts
+   */
+  unsigned int gfc3d_partition_boundary(GlobalFrictionContactProblem* problem,
+                                        const unsigned int* part,
+                                        unsigned char* is_boundary);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
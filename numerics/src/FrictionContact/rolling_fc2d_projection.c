@@ -25,7 +25,8 @@
 #include "NumericsFwd.h"                       // for SolverOptions, Rolling...
 #include "NumericsMatrix.h"                    // for NumericsMatrix
 #include "RollingFrictionContactProblem.h"     // for RollingFrictionContact...
-#include "SiconosLapack.h"                     // for DGETRF, DGETRS, LA_NOTRANS
+#include "op3x3.h"                            // for mv3x3
+#include "opNxN.h"                            // for inv_3x3
 #include "SolverOptions.h"                     // for SolverOptions, solver_...
 #include "siconos_debug.h"                             // for DEBUG_PRINTF, DEBUG_END
 #include "numerics_verbose.h"                  // for numerics_printf_verbose
@@ -148,16 +149,11 @@ void rolling_fc2d_projectionOnConeWithLocalIteration_initialize(
     if(localsolver_options->iparam[SICONOS_FRICTION_3D_NSGS_LOCALSOLVER_IPARAM_USE_TRIVIAL_SOLUTION] ==
         SICONOS_FRICTION_3D_NSGS_LOCALSOLVER_USE_TRIVIAL_SOLUTION_TRUE)
     {
-      /* nc for rho parameter + 30 * nc for inverse of diagonal matrix */
+      /* nc for rho parameter + 10 * nc for inverse of diagonal matrix */
       unsigned int d_size = nc + 10 *nc;
       localsolver_options->dWork = (double *)realloc(localsolver_options->dWork,
                                    d_size * sizeof(double));
       localsolver_options->dWorkSize = d_size ;
-      unsigned int i_size = 3 *nc;
-      localsolver_options->iWork = (int *)realloc(localsolver_options->iWork,
-                                   i_size * sizeof(int));
-      localsolver_options->iWorkSize = i_size ;
-
     }
     else
     {
@@ -180,11 +176,8 @@ void rolling_fc2d_projectionOnConeWithLocalIteration_initialize(
       rolling_fc2d_local_problem_fill_M(problem, localproblem, i);
       double * MLocal = localproblem->M->matrix0;
       unsigned int pos = i * 10 + nc;
-      double * MLocal_LU = &(localsolver_options->dWork[pos]);
-      memcpy(MLocal_LU, MLocal, 9*sizeof(double));
-      int * ipiv =  &(localsolver_options->iWork[i*3]);
-      int info =0;
-      DGETRF(3, 3, MLocal_LU, 3, ipiv, &info);
+      double * MLocal_inv = &(localsolver_options->dWork[pos]);
+      int info = inv_3x3(MLocal, MLocal_inv);
       assert(!info);
     }
   }
@@ -216,13 +209,9 @@ static int  rolling_fc2d_check_trivial_solution(
   }
 
   unsigned int pos = contact * 10 + nc;
-  double * MLocal_LU = &(localsolver_options->dWork[pos]);
-  int * ipiv = &(localsolver_options->iWork[3*contact]);
+  double * MLocal_inv = &(localsolver_options->dWork[pos]);
   /* double * tmp = localsolver_options->dWork[pos+25]; */
-  memcpy(reaction, q, 3*sizeof(double));
-  int info =0;
-  DGETRS(LA_NOTRANS, 3, 1, MLocal_LU, 3, ipiv, reaction, 3, &info);
-  assert(!info);
+  mv3x3(MLocal_inv, q, reaction);
 
   /* DEBUG_EXPR(NM_dense_display(M, 5,5,5);); */
   /* double * A =  (double * ) malloc(25*sizeof(double)); */
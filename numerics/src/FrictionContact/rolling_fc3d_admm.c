@@ -36,6 +36,7 @@
 #include "numerics_verbose.h"        // for numerics_printf_verbose, numeric...
 #include "projectionOnRollingCone.h"           // for projectionOnRollingCone
 #include "SiconosBlas.h"                   // for cblas_dcopy, cblas_daxpy, cblas_...
+#include "SparseBlockMatrix.h"       // for SBM_diagonal_block_index
 
 const char* const   SICONOS_ROLLING_FRICTION_3D_ADMM_STR = "RFC3D ADMM";
 
@@ -133,6 +134,48 @@ void rolling_fc3d_admm_free(RollingFrictionContactProblem* problem, SolverOption
 }
 
 
+/* W <- W + diag(rho_c), one penalty value per contact expanded on the five
+ * diagonal entries of its block (vector counterpart of NM_add_to_diag5) */
+static void rolling_fc3d_admm_add_rho_to_diag5(NumericsMatrix* W, const double* rho_c, int nc)
+{
+  size_t n = W->size0;
+  switch(W->storageType)
+  {
+  case NM_DENSE:
+  {
+    for(int contact = 0; contact < nc; ++contact)
+      for(size_t k = 0; k < 5; ++k)
+      {
+        size_t i = 5*contact + k;
+        W->matrix0[i + i*n] += rho_c[contact];
+      }
+    break;
+  }
+  case NM_SPARSE_BLOCK:
+  {
+    for(int contact = 0; contact < nc; ++contact)
+    {
+      int diagPos = SBM_diagonal_block_index(W->matrix1, contact);
+      W->matrix1->block[diagPos][0] += rho_c[contact];
+      W->matrix1->block[diagPos][6] += rho_c[contact];
+      W->matrix1->block[diagPos][12] += rho_c[contact];
+      W->matrix1->block[diagPos][18] += rho_c[contact];
+      W->matrix1->block[diagPos][24] += rho_c[contact];
+    }
+    break;
+  }
+  case NM_SPARSE:
+  {
+    CS_INT* diag_indices = NSM_diag_indices(W);
+    double* Wx = NSM_data(W->matrix2);
+    for(size_t i = 0; i < n; ++i) Wx[diag_indices[i]] += rho_c[i/5];
+    break;
+  }
+  default:
+    numerics_error("rolling_fc3d_admm_add_rho_to_diag5", "unsupported matrix storage %d", W->storageType);
+  }
+}
+
 static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict problem,
                                         double* restrict reaction,
                                         double* restrict velocity,
@@ -246,6 +289,21 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
   rho_k=rho;
   int has_rho_changed = 1;
 
+  /* one penalty per contact, updated from the per-contact scaled residuals;
+     the refactorization is triggered only when enough contacts drift */
+  int per_contact_rho = (iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
+                         SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING_PER_CONTACT);
+  double refactor_fraction = dparam[SICONOS_FRICTION_3D_ADMM_BALANCING_REFACTOR_FRACTION];
+  double *rho_c = NULL, *rho_c_new = NULL, *r_contact = NULL, *s_contact = NULL;
+  if(per_contact_rho)
+  {
+    rho_c = (double*)malloc(nc*sizeof(double));
+    rho_c_new = (double*)malloc(nc*sizeof(double));
+    r_contact = (double*)malloc(nc*sizeof(double));
+    s_contact = (double*)malloc(nc*sizeof(double));
+    for(contact = 0 ; contact < nc ; ++contact) rho_c[contact] = rho;
+  }
+
   while((iter < itermax) && (hasNotConverged > 0))
   {
     ++iter;
@@ -256,7 +314,10 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
       /* NM_clear(W); */
       /* W= NM_new(); */
       NM_copy(M,W);
-      NM_add_to_diag5(W, rho);
+      if(per_contact_rho)
+        rolling_fc3d_admm_add_rho_to_diag5(W, rho_c, nc);
+      else
+        NM_add_to_diag5(W, rho);
     }
 
     /********************/
@@ -295,7 +356,13 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
     /* -q_s - rho * (xi_hat - z_hat )--> reaction */
     cblas_dcopy(m, xi_hat, 1, tmp, 1);
     cblas_daxpy(m, -1.0, z_hat, 1, tmp, 1);
-    cblas_daxpy(m, -1.0*rho, tmp, 1, reaction, 1);
+    if(per_contact_rho)
+    {
+      for(contact = 0 ; contact < nc ; ++contact)
+        cblas_daxpy(5, -1.0*rho_c[contact], &tmp[5*contact], 1, &reaction[5*contact], 1);
+    }
+    else
+      cblas_daxpy(m, -1.0*rho, tmp, 1, reaction, 1);
 
     DEBUG_PRINT("rhs:");
     DEBUG_EXPR(NV_display(reaction,m));
@@ -318,11 +385,8 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
     DEBUG_PRINT("Before projection :");
     DEBUG_EXPR(NV_display(z,m));
 
-    /* Loop through the contact points */
-    for(contact = 0 ; contact < nc ; ++contact)
-    {
-      projectionOnRollingCone(&z[contact * 5], mu[contact],  mu_r[contact]);
-    }
+    /* Project all the contact points at once */
+    projectionOnRollingCone_batch(nc, z, mu, mu_r);
     DEBUG_PRINT("After projection :");
     DEBUG_EXPR(NV_display(z,m));
 
@@ -333,6 +397,11 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
     /* r - z --> residual  */
     cblas_dcopy(m, reaction, 1, xi, 1);
     cblas_daxpy(m, -1.0, z, 1, xi, 1);
+    if(per_contact_rho)
+    {
+      for(contact = 0 ; contact < nc ; ++contact)
+        r_contact[contact] = cblas_dnrm2(5, &xi[5*contact], 1);
+    }
     r = cblas_dnrm2(m, xi, 1);
 
     norm_r = cblas_dnrm2(m, reaction, 1);
@@ -352,8 +421,27 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
     cblas_dcopy(m, z_hat, 1, tmp, 1);
     cblas_daxpy(m, -1, z, 1, tmp, 1);
 
-    s = rho*cblas_dnrm2(m, tmp, 1);
-    double norm_rhoxi = rho*cblas_dnrm2(m, xi, 1);
+    double norm_rhoxi;
+    if(per_contact_rho)
+    {
+      /* rho-weighted norms, accumulated contact by contact */
+      double s_2 = 0.0, rhoxi_2 = 0.0;
+      for(contact = 0 ; contact < nc ; ++contact)
+      {
+        pos = contact * 5;
+        s_contact[contact] = rho_c[contact]*cblas_dnrm2(5, &tmp[pos], 1);
+        s_2 += s_contact[contact]*s_contact[contact];
+        double rhoxi_contact = rho_c[contact]*cblas_dnrm2(5, &xi[pos], 1);
+        rhoxi_2 += rhoxi_contact*rhoxi_contact;
+      }
+      s = sqrt(s_2);
+      norm_rhoxi = sqrt(rhoxi_2);
+    }
+    else
+    {
+      s = rho*cblas_dnrm2(m, tmp, 1);
+      norm_rhoxi = rho*cblas_dnrm2(m, xi, 1);
+    }
 
     e =r*r+s*s;
 
@@ -421,50 +509,100 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
 
     rho_k = rho ;
 
-    if(options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
-        SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING)
-    {
-      r_scaled = r / (fmax(norm_z,norm_r));
-      s_scaled = s / (norm_rhoxi);
-      numerics_printf_verbose(2, "rolling_fc3d_admm. scaling : norm_r  = %e, \t norm_z  = %e, \t norm_rhoxi = %e, \t", norm_r,  norm_z, norm_rhoxi);
-      numerics_printf_verbose(2, "rolling_fc3d_admm. residuals : r  = %e, \t  s = %e", r, s);
-      numerics_printf_verbose(2, "rolling_fc3d_admm. scaled residuals : r_scaled  = %e, \t  s_scaled = %e", r_scaled, s_scaled);
-    }
-    else
-    {
-      r_scaled = r;
-      s_scaled = s;
-    }
-
-    if(is_rho_variable)
+    if(per_contact_rho)
     {
-      if(r_scaled > br_phi * s_scaled)
+      /* each contact votes for a new penalty from its own scaled residuals;
+         the votes are applied (and W refactored) only when enough contacts
+         ask for a change, otherwise they are discarded and recomputed at
+         the next iteration from the fresher residuals */
+      double scale_r = fmax(norm_z,norm_r);
+      int nb_changed = 0;
+      for(contact = 0 ; contact < nc ; ++contact)
       {
-        rho = br_tau* rho_k;
-        has_rho_changed = 1;
+        double r_scaled_contact = r_contact[contact] / scale_r;
+        double s_scaled_contact = s_contact[contact] / norm_rhoxi;
+        if(r_scaled_contact > br_phi * s_scaled_contact)
+        {
+          rho_c_new[contact] = br_tau * rho_c[contact];
+          ++nb_changed;
+        }
+        else if(s_scaled_contact > br_phi * r_scaled_contact)
+        {
+          rho_c_new[contact] = rho_c[contact]/br_tau;
+          ++nb_changed;
+        }
+        else
+        {
+          /* keep the value of rho for this contact */
+          rho_c_new[contact] = rho_c[contact];
+        }
       }
-      else if(s_scaled > br_phi * r_scaled)
+      if(nb_changed > 0 && (double)nb_changed >= refactor_fraction * (double)nc)
       {
-        rho = rho_k/br_tau;
+        for(contact = 0 ; contact < nc ; ++contact)
+        {
+          pos = contact * 5;
+          double rho_ratio_contact = rho_c[contact]/rho_c_new[contact];
+          cblas_dscal(5, rho_ratio_contact, &xi[pos], 1);
+          cblas_dscal(5, rho_ratio_contact, &xi_hat[pos], 1);
+          rho_c[contact] = rho_c_new[contact];
+        }
         has_rho_changed = 1;
       }
       else
       {
-        /* keep the value of rho */
         has_rho_changed = 0;
       }
+      numerics_printf_verbose(2, "rolling_fc3d_admm. per-contact rho : %i/%i contacts asked for a change, refactorization : %s",
+                              nb_changed, nc, has_rho_changed ? "yes" : "no");
     }
     else
     {
-      has_rho_changed = 0;
-    }
-    numerics_printf_verbose(2, "rolling_fc3d_admm. rho = %5.2e\t, rho_k = %5.2e\t ", rho, rho_k);
-    rho_ratio = rho_k/rho;
+      if(options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
+          SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING)
+      {
+        r_scaled = r / (fmax(norm_z,norm_r));
+        s_scaled = s / (norm_rhoxi);
+        numerics_printf_verbose(2, "rolling_fc3d_admm. scaling : norm_r  = %e, \t norm_z  = %e, \t norm_rhoxi = %e, \t", norm_r,  norm_z, norm_rhoxi);
+        numerics_printf_verbose(2, "rolling_fc3d_admm. residuals : r  = %e, \t  s = %e", r, s);
+        numerics_printf_verbose(2, "rolling_fc3d_admm. scaled residuals : r_scaled  = %e, \t  s_scaled = %e", r_scaled, s_scaled);
+      }
+      else
+      {
+        r_scaled = r;
+        s_scaled = s;
+      }
 
-    DEBUG_PRINTF("rho =%e\t,rho_k =%e \n", rho, rho_k);
+      if(is_rho_variable)
+      {
+        if(r_scaled > br_phi * s_scaled)
+        {
+          rho = br_tau* rho_k;
+          has_rho_changed = 1;
+        }
+        else if(s_scaled > br_phi * r_scaled)
+        {
+          rho = rho_k/br_tau;
+          has_rho_changed = 1;
+        }
+        else
+        {
+          /* keep the value of rho */
+          has_rho_changed = 0;
+        }
+      }
+      else
+      {
+        has_rho_changed = 0;
+      }
+      numerics_printf_verbose(2, "rolling_fc3d_admm. rho = %5.2e\t, rho_k = %5.2e\t ", rho, rho_k);
+      rho_ratio = rho_k/rho;
+
+      DEBUG_PRINTF("rho =%e\t,rho_k =%e \n", rho, rho_k);
 
-    cblas_dscal(m, rho_ratio, xi,1);
-    cblas_dscal(m, rho_ratio, xi_hat,1);
+      cblas_dscal(m, rho_ratio, xi,1);
+      cblas_dscal(m, rho_ratio, xi_hat,1);
+    }
 
     /* Next step */
     cblas_dcopy(m, z, 1, z_k, 1);
@@ -536,6 +674,13 @@ static void rolling_fc3d_admm_symmetric(RollingFrictionContactProblem* restrict
     }
     numerics_printf_verbose(1,"---- RFC3D - ADMM  - Iteration %i rho = %14.7e \t full error = %14.7e", iter, rho, error);
   }
+  if(per_contact_rho)
+  {
+    free(rho_c);
+    free(rho_c_new);
+    free(r_contact);
+    free(s_contact);
+  }
   NM_clear(W);
   dparam[SICONOS_DPARAM_RESIDU] = error;
   iparam[SICONOS_IPARAM_ITER_DONE] = iter;
@@ -554,6 +699,11 @@ static void rolling_fc3d_admm_asymmetric(RollingFrictionContactProblem* restrict
   /* int and double parameters */
   int* iparam = options->iparam;
   double* dparam = options->dparam;
+
+  if(iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
+      SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING_PER_CONTACT)
+    numerics_error("rolling_fc3d_admm_asymmetric", "the per-contact rho strategy is only implemented in the symmetric variant");
+
   /* Number of contacts */
   int nc = problem->numberOfContacts;
   /* int n = problem->M->size0; */
@@ -745,10 +895,7 @@ static void rolling_fc3d_admm_asymmetric(RollingFrictionContactProblem* restrict
     {
       projectionOnDualRollingCone(&z[contact * 5], mu[contact], mu_r[contact]);
     }
-    for(contact = 0 ; contact < nc ; ++contact)
-    {
-      projectionOnRollingCone(&z[contact * 5+m], mu[contact],  mu_r[contact]);
-    }
+    projectionOnRollingCone_batch(nc, z + m, mu, mu_r);
 
     DEBUG_PRINT("After projection :");
     DEBUG_EXPR(NV_display(z,2*m));
@@ -993,7 +1140,9 @@ static double rolling_fc3d_admm_select_rho(NumericsMatrix* M, int * is_rho_varia
   if(options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
       SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_RESIDUAL_BALANCING ||
       options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
-      SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING)
+      SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING ||
+      options->iparam[SICONOS_FRICTION_3D_ADMM_IPARAM_RHO_STRATEGY] ==
+      SICONOS_FRICTION_3D_ADMM_RHO_STRATEGY_SCALED_RESIDUAL_BALANCING_PER_CONTACT)
   {
     *is_rho_variable = 1 ;
   }
@@ -1125,6 +1274,7 @@ void rolling_fc3d_admm_set_default(SolverOptions* options)
   options->dparam[SICONOS_FRICTION_3D_ADMM_RESTART_ETA] = 0.999;
   options->dparam[SICONOS_FRICTION_3D_ADMM_BALANCING_RESIDUAL_TAU]=2.0;
   options->dparam[SICONOS_FRICTION_3D_ADMM_BALANCING_RESIDUAL_PHI]=2.0;
+  options->dparam[SICONOS_FRICTION_3D_ADMM_BALANCING_REFACTOR_FRACTION]=0.05;
 
   options->iparam[SICONOS_FRICTION_3D_IPARAM_RESCALING]=SICONOS_FRICTION_3D_RESCALING_NO;
 }
@@ -34,6 +34,8 @@ const char* const  SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnConeWithLo
 
 const char* const  SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnCone_STR = "RFC3D_ProjectionOnCone";
 
+const char* const   SICONOS_ROLLING_FRICTION_3D_NSGS_MULTICOLOR_STR = "RFC3D_NSGS_MULTICOLOR";
+
 int rolling_fc3d_driver(RollingFrictionContactProblem* problem,
                         double *reaction, double *velocity,
                         SolverOptions* options)
@@ -80,6 +82,13 @@ int rolling_fc3d_driver(RollingFrictionContactProblem* problem,
     numerics_printf(" ========================== Call NSGS solver for Rolling Friction-Contact 3D problem ==========================\n");
     rolling_fc3d_nsgs(problem, reaction, velocity, &info, options);
     break;
+  }
+  /* NSGS with multi-color parallel sweeps */
+  case SICONOS_ROLLING_FRICTION_3D_NSGS_MULTICOLOR:
+  {
+    numerics_printf(" ========================== Call NSGS MULTICOLOR solver for Rolling Friction-Contact 3D problem ==========================\n");
+    rolling_fc3d_nsgs_multicolor(problem, reaction, velocity, &info, options);
+    break;
   }
    /* ADMM */
   case SICONOS_ROLLING_FRICTION_3D_ADMM:
@@ -0,0 +1,256 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>                            // for assert
+#include <float.h>                             // for DBL_EPSILON
+#include <math.h>                              // for fabs, sqrt, pow
+#include <stdio.h>                             // for NULL
+#include <stdlib.h>                            // for calloc, malloc
+#include <string.h>                            // for memcpy
+#include "Friction_cst.h"                      // for SICONOS_FRICTION_3D_IP...
+#include "NumericsExecutionPolicy.h"           // for numerics_execution_pol...
+#include "NumericsFwd.h"                       // for SolverOptions, Rolling...
+#include "NumericsMatrix.h"                    // for NumericsMatrix
+#include "RollingFrictionContactProblem.h"     // for RollingFrictionContact...
+#include "SolverOptions.h"                     // for SolverOptions
+#include "SparseBlockMatrix.h"                 // for SparseBlockStructuredM...
+#include "fc3d_Solvers.h"                      // for fc_nsgs_multicolor_col...
+#include "numerics_verbose.h"                  // for numerics_printf, numer...
+#include "rolling_fc_Solvers.h"                // for RollingComputeErrorPtr
+#include "rolling_fc3d_local_problem_tools.h"  // for rolling_fc3d_local_pro...
+#include "SiconosBlas.h"                       // for cblas_dnrm2
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static double multicolor_light_error_squared(double localreaction[5],
+                                             double *oldreaction)
+{
+  return (pow(oldreaction[0] - localreaction[0], 2) +
+          pow(oldreaction[1] - localreaction[1], 2) +
+          pow(oldreaction[2] - localreaction[2], 2) +
+          pow(oldreaction[3] - localreaction[3], 2) +
+          pow(oldreaction[4] - localreaction[4], 2));
+}
+
+void rolling_fc3d_nsgs_multicolor(RollingFrictionContactProblem* problem,
+                                  double *reaction, double *velocity,
+                                  int* info, SolverOptions* options)
+{
+  int* iparam = options->iparam;
+  double* dparam = options->dparam;
+
+  unsigned int nc = problem->numberOfContacts;
+  int itermax = iparam[SICONOS_IPARAM_MAX_ITER];
+  double tolerance = dparam[SICONOS_DPARAM_TOL];
+  double norm_q = cblas_dnrm2(nc * 5, problem->q, 1);
+
+  if(*info == 0)
+    return;
+
+  if(options->numberOfInternalSolvers < 1)
+  {
+    numerics_error("rolling_fc3d_nsgs_multicolor",
+                   "The NSGS method needs options for the internal solvers, "
+                   "options[0].numberOfInternalSolvers should be >= 1");
+  }
+
+  /* Coloring requires the block sparsity pattern of W; the coloring itself
+     only depends on that pattern and is shared with fc3d_nsgs_multicolor. */
+  if(problem->M->storageType != NM_SPARSE_BLOCK || !problem->M->matrix1)
+  {
+    numerics_printf("rolling_fc3d_nsgs_multicolor - W is not sparse block, "
+                    "falling back on the sequential NSGS sweep");
+    rolling_fc3d_nsgs(problem, reaction, velocity, info, options);
+    return;
+  }
+
+  unsigned int* colors = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  unsigned int number_of_colors =
+    fc_nsgs_multicolor_coloring(problem->M->matrix1, nc, colors);
+
+  if(number_of_colors == 0 || number_of_colors > nc / 2 + 1)
+  {
+    numerics_printf("rolling_fc3d_nsgs_multicolor - contact graph is dense "
+                    "(%i colors for %i contacts), "
+                    "falling back on the sequential NSGS sweep",
+                    number_of_colors, nc);
+    free(colors);
+    rolling_fc3d_nsgs(problem, reaction, velocity, info, options);
+    return;
+  }
+
+  /* Group the contacts of each color class contiguously. */
+  unsigned int* color_offset = (unsigned int*)calloc(number_of_colors + 1, sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i)
+    color_offset[colors[i] + 1]++;
+  for(unsigned int c = 0; c < number_of_colors; ++c)
+    color_offset[c + 1] += color_offset[c];
+  unsigned int* color_member = (unsigned int*)malloc(nc * sizeof(unsigned int));
+  unsigned int* color_fill = (unsigned int*)calloc(number_of_colors, sizeof(unsigned int));
+  for(unsigned int i = 0; i < nc; ++i)
+    color_member[color_offset[colors[i]] + color_fill[colors[i]]++] = i;
+  free(color_fill);
+
+  numerics_printf("rolling_fc3d_nsgs_multicolor - %i contacts colored with "
+                  "%i colors", nc, number_of_colors);
+
+  /* Per-thread local problem and solver options; thread 0 uses the caller
+     options so that statistics of the internal solver remain visible. */
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+  RollingFrictionContactProblem** localproblems =
+    (RollingFrictionContactProblem**)malloc(nthreads * sizeof(RollingFrictionContactProblem*));
+  SolverOptions** thread_options =
+    (SolverOptions**)malloc(nthreads * sizeof(SolverOptions*));
+  RollingSolverPtr local_solver = NULL;
+  RollingUpdatePtr update_localproblem = NULL;
+  RollingFreeSolverNSGSPtr freeSolver = NULL;
+  RollingComputeErrorPtr computeError = NULL;
+
+  for(int t = 0; t < nthreads; ++t)
+  {
+    thread_options[t] = (t == 0) ? options : solver_options_copy(options);
+    localproblems[t] = rolling_fc3d_local_problem_allocate(problem);
+    rolling_fc3d_nsgs_initialize_local_solver(&local_solver, &update_localproblem,
+        &freeSolver, &computeError,
+        problem, localproblems[t],
+        thread_options[t]);
+  }
+
+  /* with deterministic reductions, the light error terms are stored per
+     contact and folded in a fixed order after the sweep */
+  double* light_error_terms = NULL;
+  if(numerics_execution_policy()->deterministic_reductions)
+    light_error_terms = (double*)malloc(nc * sizeof(double));
+
+  int iter = 0;
+  double error = 1.;
+  int hasNotConverged = 1;
+
+  while((iter < itermax) && (hasNotConverged > 0))
+  {
+    ++iter;
+    double light_error_sum = 0.0;
+
+    for(int t = 0; t < nthreads; ++t)
+      rolling_fc3d_set_internalsolver_tolerance(problem, thread_options[t],
+          thread_options[t]->internalSolvers[0],
+          error);
+
+    for(unsigned int c = 0; c < number_of_colors; ++c)
+    {
+#ifdef _OPENMP
+      #pragma omp parallel for schedule(dynamic, 8) reduction(+:light_error_sum)
+#endif
+      for(unsigned int k = color_offset[c]; k < color_offset[c + 1]; ++k)
+      {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        unsigned int contact = color_member[k];
+        SolverOptions* localsolver_options = thread_options[tid]->internalSolvers[0];
+        double localreaction[5];
+
+        (*update_localproblem)(contact, problem, localproblems[tid],
+                               reaction, localsolver_options);
+        localsolver_options->iparam[SICONOS_FRICTION_3D_CURRENT_CONTACT_NUMBER] = contact;
+        localreaction[0] = reaction[contact * 5 + 0];
+        localreaction[1] = reaction[contact * 5 + 1];
+        localreaction[2] = reaction[contact * 5 + 2];
+        localreaction[3] = reaction[contact * 5 + 3];
+        localreaction[4] = reaction[contact * 5 + 4];
+
+        (*local_solver)(localproblems[tid], localreaction, localsolver_options);
+
+        double light_error = multicolor_light_error_squared(localreaction,
+                                                            &reaction[contact * 5]);
+        if(light_error_terms)
+          light_error_terms[contact] = light_error;
+        else
+          light_error_sum += light_error;
+
+        if(!(isnan(localsolver_options->dparam[SICONOS_DPARAM_RESIDU])
+             || isinf(localsolver_options->dparam[SICONOS_DPARAM_RESIDU])
+             || localsolver_options->dparam[SICONOS_DPARAM_RESIDU] > 1.0))
+          memcpy(&reaction[contact * 5], localreaction, sizeof(double) * 5);
+      }
+    }
+
+    if(light_error_terms)
+      light_error_sum = numerics_fixed_order_sum(light_error_terms, nc);
+
+    double norm_r = cblas_dnrm2(nc * 5, reaction, 1);
+    error = sqrt(light_error_sum);
+    if(fabs(norm_r) > DBL_EPSILON)
+      error /= norm_r;
+
+    if(error < tolerance)
+    {
+      hasNotConverged = 0;
+      numerics_printf("--------------- RFC3D - NSGS MULTICOLOR - Iteration %i "
+                      "Residual = %14.7e < %7.3e", iter, error, tolerance);
+    }
+    else
+    {
+      numerics_printf("--------------- RFC3D - NSGS MULTICOLOR - Iteration %i "
+                      "Residual = %14.7e > %7.3e", iter, error, tolerance);
+    }
+
+    if(options->callback)
+    {
+      options->callback->collectStatsIteration(options->callback->env,
+                                               nc * 5, reaction, velocity,
+                                               error, NULL);
+    }
+  }
+
+  /* Full error of the final iterate, as in the
+     LIGHT_WITH_FULL_FINAL strategy of the sequential solver. */
+  if(iparam[SICONOS_FRICTION_3D_IPARAM_ERROR_EVALUATION] !=
+      SICONOS_FRICTION_3D_NSGS_ERROR_EVALUATION_LIGHT)
+  {
+    (*computeError)(problem, reaction, velocity, tolerance, options,
+                    norm_q, &error);
+    hasNotConverged = (error < tolerance) ? 0 : 1;
+  }
+
+  *info = hasNotConverged;
+  dparam[SICONOS_DPARAM_RESIDU] = error;
+  iparam[SICONOS_IPARAM_ITER_DONE] = iter;
+
+  for(int t = 0; t < nthreads; ++t)
+  {
+    (*freeSolver)(problem, localproblems[t], thread_options[t]->internalSolvers[0]);
+    rolling_fc3d_local_problem_free(localproblems[t], problem);
+    if(t > 0)
+    {
+      solver_options_delete(thread_options[t]);
+      free(thread_options[t]);
+    }
+  }
+  free(localproblems);
+  free(thread_options);
+  free(light_error_terms);
+  free(color_member);
+  free(color_offset);
+  free(colors);
+}
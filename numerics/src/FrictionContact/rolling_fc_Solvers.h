@@ -122,6 +122,28 @@ extern "C" {
 void rolling_fc3d_nsgs(RollingFrictionContactProblem *problem, double *reaction,
                        double *velocity, int *info, SolverOptions *options);
 
+/**
+    Non-Smooth Gauss Seidel solver with multi-color parallel sweeps for
+    rolling friction-contact 3D problem.
+
+    The contact graph derived from the sparse block structure of W is
+    colored greedily (the coloring is shared with fc3d_nsgs_multicolor())
+    so that contacts of the same color class do not interact and can be
+    relaxed concurrently (with OpenMP when available). When W is dense or
+    not stored as sparse block, the solver falls back on the sequential
+    rolling_fc3d_nsgs() sweep. The options are those of
+    rolling_fc3d_nsgs().
+
+    \param problem the rolling friction-contact 3D problem to solve
+    \param velocity global vector (n), in-out parameter
+    \param reaction global vector (n), in-out parameters
+    \param info return 0 if the solution is found
+    \param options the solver options
+*/
+void rolling_fc3d_nsgs_multicolor(RollingFrictionContactProblem *problem,
+                                  double *reaction, double *velocity,
+                                  int *info, SolverOptions *options);
+
 void rolling_fc3d_nsgs_initialize_local_solver(
     RollingSolverPtr *solve, RollingUpdatePtr *update,
     RollingFreeSolverNSGSPtr *freeSolver, RollingComputeErrorPtr *computeError,
@@ -0,0 +1,129 @@
+#undef NDEBUG
+#include <assert.h>                       // for assert
+#include <math.h>                         // for fabs
+#include <stdio.h>                        // for fscanf, fclose, fopen, FILE
+#include <stdlib.h>                       // for free, malloc
+#include "fc3d_AlartCurnier_batch.h"      // for fc3d_AlartCurnierSTD_batch
+#include "fc3d_AlartCurnier_functions.h"  // for computeAlartCurnierSTD
+
+/* The batched structure-of-arrays kernel must reproduce the scalar
+   computeAlartCurnierSTD results on the reference inputs. */
+
+int main()
+{
+  int info = 0;
+  int r = -1;
+
+  FILE* file = fopen("./data/ACinputs.dat", "r");
+  unsigned int dim = 0;
+  double* reactions;
+  double* velocities;
+  double* mus;
+  double* rhos;
+
+  r = fscanf(file, "%d\n", &dim);
+  assert(r > 0);
+  if(r <= 0) return(r);
+
+  reactions = (double *) malloc(3 * dim * sizeof(double));
+  velocities = (double *) malloc(3 * dim * sizeof(double));
+  mus = (double *) malloc(dim * sizeof(double));
+  rhos = (double *) malloc(3 * dim * sizeof(double));
+
+  for(unsigned int i = 0; i < dim * 3 ; ++i)
+  {
+    r = fscanf(file, "%lf\n", &reactions[i]);
+    assert(r > 0);
+  };
+
+  for(unsigned int i = 0; i < dim * 3 ; ++i)
+  {
+    r = fscanf(file, "%lf\n", &velocities[i]);
+    assert(r > 0);
+  };
+
+  for(unsigned int k = 0; k < dim ; ++k)
+  {
+    r = fscanf(file, "%lf\n", &mus[k]);
+    assert(r > 0);
+  };
+
+  for(unsigned int i = 0; i < dim * 3 ; ++i)
+  {
+    r = fscanf(file, "%lf\n", &rhos[i]);
+    assert(r > 0);
+  };
+  fclose(file);
+
+  /* gather everything in one batch */
+  unsigned int* contacts = (unsigned int *) malloc(dim * sizeof(unsigned int));
+  for(unsigned int k = 0; k < dim; ++k) contacts[k] = k;
+
+  double* breaction = (double *) malloc(3 * dim * sizeof(double));
+  double* bvelocity = (double *) malloc(3 * dim * sizeof(double));
+  double* brho = (double *) malloc(3 * dim * sizeof(double));
+  double* bF = (double *) malloc(3 * dim * sizeof(double));
+  double* bA = (double *) malloc(9 * dim * sizeof(double));
+  double* bB = (double *) malloc(9 * dim * sizeof(double));
+
+  fc3d_batch_gather3(dim, contacts, reactions, breaction);
+  fc3d_batch_gather3(dim, contacts, velocities, bvelocity);
+  fc3d_batch_gather3(dim, contacts, rhos, brho);
+
+  fc3d_AlartCurnierSTD_batch(dim, breaction, bvelocity, mus, brho, bF, bA, bB);
+
+  double F[3], A[9], B[9];
+  for(unsigned int k = 0; k < dim; ++k)
+  {
+    computeAlartCurnierSTD(&reactions[3 * k], &velocities[3 * k],
+                           mus[k], &rhos[3 * k], F, A, B);
+
+    for(unsigned int c = 0; c < 3; ++c)
+    {
+      if(fabs(F[c] - bF[c * dim + k]) > 1e-14)
+      {
+        printf("contact %i : F[%i] scalar %g != batch %g\n",
+               k, c, F[c], bF[c * dim + k]);
+        info = 1;
+      }
+    }
+    for(unsigned int c = 0; c < 9; ++c)
+    {
+      if(fabs(A[c] - bA[c * dim + k]) > 1e-14)
+      {
+        printf("contact %i : A[%i] scalar %g != batch %g\n",
+               k, c, A[c], bA[c * dim + k]);
+        info = 1;
+      }
+      if(fabs(B[c] - bB[c * dim + k]) > 1e-14)
+      {
+        printf("contact %i : B[%i] scalar %g != batch %g\n",
+               k, c, B[c], bB[c * dim + k]);
+        info = 1;
+      }
+    }
+  }
+
+  /* scatter must be the inverse of gather */
+  double* back = (double *) malloc(3 * dim * sizeof(double));
+  fc3d_batch_scatter3(dim, contacts, breaction, back);
+  for(unsigned int i = 0; i < 3 * dim; ++i)
+  {
+    if(back[i] != reactions[i]) info = 1;
+  }
+
+  free(back);
+  free(bB);
+  free(bA);
+  free(bF);
+  free(brho);
+  free(bvelocity);
+  free(breaction);
+  free(contacts);
+  free(rhos);
+  free(mus);
+  free(velocities);
+  free(reactions);
+
+  return info;
+}
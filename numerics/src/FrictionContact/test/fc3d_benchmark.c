@@ -0,0 +1,193 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* Reproducible performance harness for the fc3d solvers.
+ *
+ * Usage: fc3d_benchmark [datafile] [solver name or id] [repetitions] [tolerance] [maxiter]
+ *
+ * The problem is read with frictionContact_new_from_filename (.dat, or
+ * .hdf5 when fclib is on), solved with any solver id of Friction_cst.h,
+ * and the harness reports per repetition: wall time, iterations,
+ * residual, a flop estimate of the dominant matrix-vector work and,
+ * on Linux when perf events are available, cache-miss and branch-miss
+ * counters around the solve.
+ *
+ * Without arguments it runs NSGS once on a small problem of the data
+ * collections, so that it doubles as a smoke test. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "NonSmoothDrivers.h"
+#include "SolverOptions.h"
+#include "FrictionContactProblem.h"
+#include "Friction_cst.h"
+#include "fc3d_Solvers.h"
+#include "NumericsMatrix.h"
+#include "numerics_verbose.h"
+
+#if defined(__linux__)
+#define BENCH_WITH_PERF_EVENTS 1
+#include <unistd.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* returns -1 when the counter is not available (no permission, VM, ...) */
+static int perf_counter_open(unsigned long long config)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.inherit = 1; /* include the OpenMP worker threads */
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_counter_start(int fd)
+{
+  if(fd < 0) return;
+  ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static long long perf_counter_stop(int fd)
+{
+  long long count = -1;
+  if(fd < 0) return count;
+  ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  if(read(fd, &count, sizeof(count)) != sizeof(count)) count = -1;
+  return count;
+}
+#endif /* __linux__ */
+
+static double wall_time(void)
+{
+#if defined(_WIN32)
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+  const char* datafile = argc > 1 ? argv[1] : "./data/FC3D_Example1.dat";
+  int solver_id = SICONOS_FRICTION_3D_NSGS;
+  if(argc > 2)
+  {
+    solver_id = atoi(argv[2]);
+    if(!solver_id) solver_id = solver_options_name_to_id(argv[2]);
+    if(!solver_id)
+    {
+      fprintf(stderr, "fc3d_benchmark: unknown solver %s\n", argv[2]);
+      return 1;
+    }
+  }
+  int repetitions = argc > 3 ? atoi(argv[3]) : 1;
+  double tolerance = argc > 4 ? atof(argv[4]) : 1e-8;
+  int maxiter = argc > 5 ? atoi(argv[5]) : 10000;
+
+  double t0 = wall_time();
+  FrictionContactProblem* problem = frictionContact_new_from_filename(datafile);
+  double load_time = wall_time() - t0;
+  if(!problem)
+  {
+    fprintf(stderr, "fc3d_benchmark: unable to read %s\n", datafile);
+    return 1;
+  }
+
+  int nc = problem->numberOfContacts;
+  size_t nnz = NM_nnz(problem->M);
+  printf("# problem    : %s\n", datafile);
+  printf("# solver     : %s (%d)\n", solver_options_id_to_name(solver_id), solver_id);
+  printf("# contacts   : %d, nnz(M): %zu, storage: %d\n", nc, nnz, problem->M->storageType);
+  printf("# load time  : %g s\n", load_time);
+  printf("# tolerance  : %g, maxiter: %d\n", tolerance, maxiter);
+
+#ifdef BENCH_WITH_PERF_EVENTS
+  int fd_cache = perf_counter_open(PERF_COUNT_HW_CACHE_MISSES);
+  int fd_branch = perf_counter_open(PERF_COUNT_HW_BRANCH_MISSES);
+  if(fd_cache < 0 || fd_branch < 0)
+    printf("# perf events unavailable (permissions?); counters reported as -1\n");
+#endif
+
+  printf("# rep  time(s)  iterations  residual  flop_estimate  cache_misses  branch_misses\n");
+
+  int info = 0;
+  double* reaction = (double*)calloc(3 * nc, sizeof(double));
+  double* velocity = (double*)calloc(3 * nc, sizeof(double));
+
+  for(int rep = 0; rep < repetitions; ++rep)
+  {
+    /* each repetition is a cold start: fresh options, zero guess */
+    SolverOptions* options = solver_options_create(solver_id);
+    options->dparam[SICONOS_DPARAM_TOL] = tolerance;
+    options->iparam[SICONOS_IPARAM_MAX_ITER] = maxiter;
+    memset(reaction, 0, 3 * nc * sizeof(double));
+    memset(velocity, 0, 3 * nc * sizeof(double));
+
+    long long cache_misses = -1;
+    long long branch_misses = -1;
+#ifdef BENCH_WITH_PERF_EVENTS
+    perf_counter_start(fd_cache);
+    perf_counter_start(fd_branch);
+#endif
+    double t1 = wall_time();
+    info = fc3d_driver(problem, reaction, velocity, options);
+    double solve_time = wall_time() - t1;
+#ifdef BENCH_WITH_PERF_EVENTS
+    cache_misses = perf_counter_stop(fd_cache);
+    branch_misses = perf_counter_stop(fd_branch);
+#endif
+
+    int iterations = options->iparam[SICONOS_IPARAM_ITER_DONE];
+    double residual = options->dparam[SICONOS_DPARAM_RESIDU];
+    /* estimate of the dominant matrix-vector work: one product with M
+       per iteration (2 flops per nonzero) */
+    double flop_estimate = 2.0 * (double)nnz * (double)iterations;
+
+    printf("%5d  %.6e  %10d  %.6e  %.6e  %12lld  %13lld\n",
+           rep, solve_time, iterations, residual, flop_estimate,
+           cache_misses, branch_misses);
+
+    solver_options_delete(options);
+    free(options);
+  }
+
+#ifdef BENCH_WITH_PERF_EVENTS
+  if(fd_cache >= 0) close(fd_cache);
+  if(fd_branch >= 0) close(fd_branch);
+#endif
+
+  free(reaction);
+  free(velocity);
+  frictionContactProblem_free(problem);
+
+  /* as a smoke test, failing to converge is a failure */
+  return info;
+}
@@ -0,0 +1,125 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* round trip through the binary corpus container: pack a few problems,
+   map them back and check that the views match the originals entry by
+   entry and can be used by the matrix kernels */
+
+#include <math.h>                    // for fabs
+#include <stdio.h>                   // for printf, remove
+#include <stdlib.h>                  // for free
+
+#include "FrictionContactCorpus.h"   // for frictionContact_corpus_open
+#include "FrictionContactProblem.h"  // for FrictionContactProblem
+#include "NumericsMatrix.h"          // for NM_create, NM_entry, NM_gemv
+
+static FrictionContactProblem* build_problem(int nc, double shift)
+{
+  int n = 3 * nc;
+  FrictionContactProblem* problem = frictionContactProblem_new();
+  problem->dimension = 3;
+  problem->numberOfContacts = nc;
+  problem->M = NM_create(NM_DENSE, n, n);
+  for(int i = 0; i < n; ++i)
+  {
+    NM_entry(problem->M, i, i, 2.0 + shift);
+    if(i + 3 < n)
+      NM_entry(problem->M, i, i + 3, -1.0);
+  }
+  problem->q = (double*)malloc(n * sizeof(double));
+  problem->mu = (double*)malloc(nc * sizeof(double));
+  for(int i = 0; i < n; ++i) problem->q[i] = -1.0 + shift + i;
+  for(int i = 0; i < nc; ++i) problem->mu[i] = 0.3 + 0.1 * i;
+  return problem;
+}
+
+static int compare_problems(FrictionContactProblem* expected,
+                            FrictionContactProblem* loaded)
+{
+  int n = 3 * expected->numberOfContacts;
+  if(loaded->dimension != expected->dimension
+      || loaded->numberOfContacts != expected->numberOfContacts)
+    return 1;
+  for(int i = 0; i < n; ++i)
+    for(int j = 0; j < n; ++j)
+      if(fabs(NM_get_value(loaded->M, i, j) - NM_get_value(expected->M, i, j)) > 0.0)
+        return 1;
+  for(int i = 0; i < n; ++i)
+    if(loaded->q[i] != expected->q[i])
+      return 1;
+  for(int i = 0; i < expected->numberOfContacts; ++i)
+    if(loaded->mu[i] != expected->mu[i])
+      return 1;
+  return 0;
+}
+
+int main(void)
+{
+  const char* filename = "fc_corpus_test.fcc";
+  int info = 0;
+
+  FrictionContactProblem* problems[3];
+  problems[0] = build_problem(2, 0.0);
+  problems[1] = build_problem(5, 0.5);
+  problems[2] = build_problem(1, 1.0);
+
+  FrictionContactCorpusWriter* writer = frictionContact_corpus_writer_open(filename);
+  if(!writer) return 1;
+  for(int k = 0; k < 3; ++k)
+    info += frictionContact_corpus_writer_add(writer, problems[k]);
+  info += frictionContact_corpus_writer_close(writer);
+  printf("corpus written, info = %i\n", info);
+
+  FrictionContactCorpus* corpus = frictionContact_corpus_open(filename);
+  if(!corpus) return 1;
+  if(frictionContact_corpus_size(corpus) != 3) info += 1;
+
+  /* random access, out of order on purpose */
+  for(int k = 2; k >= 0; --k)
+  {
+    FrictionContactProblem* loaded = frictionContact_corpus_get(corpus, k);
+    if(!loaded)
+    {
+      info += 1;
+      continue;
+    }
+    info += compare_problems(problems[k], loaded);
+
+    /* the mapped matrix must be usable by the kernels as it is */
+    int n = 3 * loaded->numberOfContacts;
+    double* y = (double*)calloc(n, sizeof(double));
+    double* y_ref = (double*)calloc(n, sizeof(double));
+    NM_gemv(1.0, loaded->M, loaded->q, 0.0, y);
+    NM_gemv(1.0, problems[k]->M, problems[k]->q, 0.0, y_ref);
+    for(int i = 0; i < n; ++i)
+      if(y[i] != y_ref[i]) info += 1;
+    free(y);
+    free(y_ref);
+
+    frictionContact_corpus_problem_free(loaded);
+  }
+  if(frictionContact_corpus_get(corpus, 3) != NULL) info += 1;
+
+  frictionContact_corpus_close(corpus);
+  for(int k = 0; k < 3; ++k)
+    frictionContactProblem_free(problems[k]);
+  remove(filename);
+
+  printf("fc_corpus_test: %s\n", info ? "failed" : "succeeded");
+  return info;
+}
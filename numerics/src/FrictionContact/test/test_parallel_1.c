@@ -0,0 +1,69 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>                      // for malloc
+#include "Friction_cst.h"                // for SICONOS_FRICTION_3D_NSGS_MUL...
+#include "NumericsFwd.h"                 // for SolverOptions
+#include "SolverOptions.h"               // for SolverOptions, solver_option...
+#include "frictionContact_test_utils.h"  // for build_test_collection
+#include "test_utils.h"                  // for TestCase
+
+/* Convergence tests for the parallel / decomposition solvers:
+   multicolor Gauss-Seidel, damped Jacobi, islands and active-set
+   reduction.  Each solver runs on three SBM problems of increasing
+   size and on one dense problem; the dense data point exercises the
+   documented fallback to the sequential path. */
+
+TestCase * build_test_collection(int n_data, const char ** data_collection, int* number_of_tests)
+{
+  int solvers[] = {SICONOS_FRICTION_3D_NSGS_MULTICOLOR,
+                   SICONOS_FRICTION_3D_JACOBI,
+                   SICONOS_FRICTION_3D_ISLANDS,
+                   SICONOS_FRICTION_3D_REDUCED};
+  int n_solvers = 4;
+  /* 0: FC3D_Example1_SBM.dat, 2: Confeti-ex13-4contact-Fc3D-SBM.dat,
+     5: Confeti-ex03-Fc3D-SBM.dat, 4: FC3D_Example1.dat (dense) */
+  int data[] = {0, 2, 5, 4};
+  int n_selected_data = 4;
+
+  *number_of_tests = n_solvers * n_selected_data;
+  TestCase * collection = (TestCase*)malloc((*number_of_tests) * sizeof(TestCase));
+
+  int current = 0;
+  for(int s = 0; s < n_solvers; s++)
+  {
+    for(int d = 0; d < n_selected_data; d++)
+    {
+      collection[current].filename = data_collection[data[d]];
+      collection[current].options = solver_options_create(solvers[s]);
+      collection[current].options->dparam[SICONOS_DPARAM_TOL] = 1e-5;
+      collection[current].options->iparam[SICONOS_IPARAM_MAX_ITER] = 10000;
+      if(solvers[s] == SICONOS_FRICTION_3D_ISLANDS ||
+         solvers[s] == SICONOS_FRICTION_3D_REDUCED)
+      {
+        /* the outer tolerance is not propagated to the inner solver */
+        collection[current].options->internalSolvers[0]->dparam[SICONOS_DPARAM_TOL] = 1e-5;
+        collection[current].options->internalSolvers[0]->iparam[SICONOS_IPARAM_MAX_ITER] = 10000;
+      }
+      current++;
+    }
+  }
+
+  return collection;
+
+}
@@ -232,6 +232,25 @@ int gmp_compute_error(GenericMechanicalProblem* pGMP, double *reaction, double *
 static int SScmp = 0;
 static int SScmpTotal = 0;
 #endif
+
+/* Per-block entry of the Gauss-Seidel sweep plan, built once per call of
+ * gmp_gauss_seidel: the structural data (position, diagonal block, local
+ * buffers) that the sweep otherwise re-derives on every pass.  The
+ * diagonal blocks of M are fixed during the solve, so dense storage is
+ * extracted a single time, and the equality blocks keep an owned copy of
+ * their diagonal block whose LU factors are computed at the first sweep
+ * and reused by all the following ones. */
+typedef struct
+{
+  listNumericsProblem * problem;
+  size_t size;
+  int posInX;
+  double * diagBlock;       /* borrowed (SBM block) or slice of the dense arena */
+  NumericsMatrix * equalityM; /* equality blocks only: owned copy of the
+                               * diagonal block, factored in place */
+  double * prevRhs;         /* equality blocks only: rhs of the previous sweep */
+  int prevRhsValid;
+} gmp_sweep_plan_entry;
 //#define GMP_WRITE_PRB
 //static double sCoefLS=1.0;
 void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double * velocity, int * info,
@@ -271,7 +290,6 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
   double * pBuffVelocity = NULL;
   int withLS = options->iparam[SICONOS_GENERIC_MECHANICAL_IPARAM_WITH_LINESEARCH];
   double * pCoefLS = &(options->dparam[SICONOS_DPARAM_GMP_COEFF_LS]);
-  double * bufForLocalProblemDense = (storageType == NM_DENSE) ? (double*) malloc(pGMP->maxLocalSize * pGMP->maxLocalSize * sizeof(double)) : 0;
 
   if(options->dWork)
   {
@@ -282,16 +300,77 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
     pPrevReaction = (double *) malloc(gmp_get_nb_dwork(pGMP, options) * sizeof(double));
   }
   pBuffVelocity = pPrevReaction + pGMP->size;
+
+  /* Build the sweep plan (see gmp_sweep_plan_entry). */
+  int nbBlocks = 0;
+  for(curProblem = pGMP->firstListElem; curProblem; curProblem = curProblem->nextProblem)
+    nbBlocks++;
+  gmp_sweep_plan_entry * plan = (gmp_sweep_plan_entry *) malloc(nbBlocks * sizeof(gmp_sweep_plan_entry));
+  double * diagArena = NULL;
+  if(storageType == NM_DENSE)
+  {
+    size_t arenaSize = 0;
+    for(curProblem = pGMP->firstListElem; curProblem; curProblem = curProblem->nextProblem)
+      arenaSize += (size_t)curProblem->size * curProblem->size;
+    diagArena = (double *) malloc(arenaSize * sizeof(double));
+  }
+  {
+    size_t arenaPos = 0;
+    int pos = 0, row = 0;
+    for(curProblem = pGMP->firstListElem; curProblem; curProblem = curProblem->nextProblem, ++row)
+    {
+      gmp_sweep_plan_entry * pe = &plan[row];
+      size_t sz = curProblem->size;
+      pe->problem = curProblem;
+      pe->size = sz;
+      pe->posInX = pos;
+      if(storageType == NM_DENSE)
+      {
+        pe->diagBlock = diagArena + arenaPos;
+        NM_extract_diag_block(numMat, row, pos, sz, &pe->diagBlock);
+        arenaPos += sz * sz;
+      }
+      else
+      {
+        pe->diagBlock = NULL;
+        NM_extract_diag_block(numMat, row, pos, sz, &pe->diagBlock);
+      }
+      pe->equalityM = NULL;
+      pe->prevRhs = NULL;
+      pe->prevRhsValid = 0;
+      switch(curProblem->type)
+      {
+      case SICONOS_NUMERICS_PROBLEM_EQUALITY:
+      {
+        pe->equalityM = NM_create(NM_DENSE, sz, sz);
+        memcpy(pe->equalityM->matrix0, pe->diagBlock, sz * sz * sizeof(double));
+        pe->prevRhs = (double *) malloc(sz * sizeof(double));
+        break;
+      }
+      /* the sub-problem matrices are views on the diagonal blocks, bound
+         here once instead of on every sweep */
+      case SICONOS_NUMERICS_PROBLEM_LCP:
+        ((LinearComplementarityProblem *)curProblem->problem)->M->matrix0 = pe->diagBlock;
+        break;
+      case SICONOS_NUMERICS_PROBLEM_RELAY:
+        ((RelayProblem *)curProblem->problem)->M->matrix0 = pe->diagBlock;
+        break;
+      case SICONOS_NUMERICS_PROBLEM_FC3D:
+      case SICONOS_NUMERICS_PROBLEM_FC2D:
+        ((FrictionContactProblem *)curProblem->problem)->M->matrix0 = pe->diagBlock;
+        break;
+      default:
+        break;
+      }
+      pos += sz;
+    }
+  }
   while(it < iterMax && tolViolate)
   {
 #ifdef GENERICMECHANICAL_DEBUG_CMP
     SScmpTotal++;
 #endif
     memcpy(pPrevReaction, reaction, pGMP->size * sizeof(double));
-    currentRowNumber = 0;
-    curProblem =  pGMP->firstListElem;
-    int  posInX = 0;
-    size_t curSize = 0;
 
     DEBUG_PRINTF("GS it %d, initial value:\n", it);
     DEBUG_EXPR(
@@ -299,29 +378,16 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
       numerics_printf("R[%i]=%e | V[%i]=%e ", ii, reaction[ii], ii, velocity[ii]);
     );
 
-    while(curProblem)
+    for(currentRowNumber = 0; currentRowNumber < nbBlocks; ++currentRowNumber)
     {
+      gmp_sweep_plan_entry * pe = &plan[currentRowNumber];
+      curProblem = pe->problem;
+      int posInX = pe->posInX;
+      size_t curSize = pe->size;
       numerics_printf_verbose(1,"Gauss-Seidel iteration %d. Problem (row) number %d ", it, currentRowNumber);
-      //if (currentRowNumber){
-      //  posInX = m->blocksize0[currentRowNumber-1];
-      //}
-      //curSize=m->blocksize0[currentRowNumber] - posInX;
-      curSize = curProblem->size;
       curProblem->error = 0;
-      /*about the diagonal block:*/
-      //diagBlockNumber = NM_extract_diag_blockPos(m,currentRowNumber);
-      //diagBlockNumber = NM_extract_diag_blockPos(numMat,currentRowNumber,posInX,size);
-      double * diagBlock = 0;
-      if(storageType == NM_DENSE)  /*dense*/
-      {
-        NM_extract_diag_block(numMat, currentRowNumber, posInX, curSize, &bufForLocalProblemDense);
-        diagBlock = bufForLocalProblemDense;
-      }
-      else
-      {
-        NM_extract_diag_block(numMat, currentRowNumber, posInX, curSize, &diagBlock);
-
-      }
+      /* the diagonal block was extracted once, at plan build */
+      double * diagBlock = pe->diagBlock;
 
       sol = reaction + posInX;
       w = velocity + posInX;
@@ -331,18 +397,23 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
       case SICONOS_NUMERICS_PROBLEM_EQUALITY:
       {
         numerics_printf_verbose(1, "solve SICONOS_NUMERICS_PROBLEM_EQUALITY");
-        NumericsMatrix M;
-        NM_fill(&M, NM_DENSE, curSize, curSize, diagBlock);
-
         memcpy(curProblem->q, &(pGMP->q[posInX]), curSize * sizeof(double));
         NM_row_prod_no_diag(pGMP->size, curSize, currentRowNumber, posInX, numMat, reaction, curProblem->q, NULL, 0);
+        /* the rhs did not move since the previous sweep: the block is
+           still satisfied, keep its reaction */
+        if(pe->prevRhsValid
+            && memcmp(curProblem->q, pe->prevRhs, curSize * sizeof(double)) == 0)
+        {
+          resLocalSolver = 0;
+          break;
+        }
+        memcpy(pe->prevRhs, curProblem->q, curSize * sizeof(double));
         for(size_t i = 0; i < curSize; ++i) sol[i] = -curProblem->q[i];
 
-        // resLocalSolver = NM_gesv(&M, sol, true);
-        resLocalSolver = NM_LU_solve(NM_preserve(&M), sol, 1);
-
-        M.matrix0 = NULL;
-        NM_clear(&M);
+        /* the LU factors of the (fixed) diagonal block are computed at
+           the first sweep and reused by all the following ones */
+        resLocalSolver = NM_LU_solve(pe->equalityM, sol, 1);
+        pe->prevRhsValid = (resLocalSolver == 0);
         break;
       }
       case SICONOS_NUMERICS_PROBLEM_LCP:
@@ -350,7 +421,7 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
         numerics_printf_verbose(1, "solve SICONOS_NUMERICS_PROBLEM_LCP");
         /*Mz*/
         LinearComplementarityProblem* lcpProblem = (LinearComplementarityProblem*) curProblem->problem;
-        lcpProblem->M->matrix0 = diagBlock;
+        assert(lcpProblem->M->matrix0 == diagBlock);
         /*about q.*/
         memcpy(curProblem->q, &(pGMP->q[posInX]), curSize * sizeof(double));
         NM_row_prod_no_diag(pGMP->size, curSize, currentRowNumber, posInX, numMat, reaction, lcpProblem->q, NULL, 0);
@@ -362,7 +433,7 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
         numerics_printf_verbose(1, "solve SICONOS_NUMERICS_PROBLEM_RELAY");
         /*Mz*/
         RelayProblem* relayProblem = (RelayProblem*) curProblem->problem;
-        relayProblem->M->matrix0 = diagBlock;
+        assert(relayProblem->M->matrix0 == diagBlock);
         /*about q.*/
         memcpy(curProblem->q, &(pGMP->q[posInX]), curSize * sizeof(double));
         NM_row_prod_no_diag(pGMP->size, curSize, currentRowNumber, posInX, numMat, reaction, relayProblem->q, NULL, 0);
@@ -376,7 +447,7 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
         assert(fcProblem);
         assert(fcProblem->M);
         assert(fcProblem->q);
-        fcProblem->M->matrix0 = diagBlock;
+        assert(fcProblem->M->matrix0 == diagBlock);
         memcpy(curProblem->q, &(pGMP->q[posInX]), curSize * sizeof(double));
 
         DEBUG_EXPR_WE(
@@ -405,7 +476,7 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
         assert(fcProblem);
         assert(fcProblem->M);
         assert(fcProblem->q);
-        fcProblem->M->matrix0 = diagBlock;
+        assert(fcProblem->M->matrix0 == diagBlock);
         memcpy(curProblem->q, &(pGMP->q[posInX]), curSize * sizeof(double));
 
         DEBUG_EXPR_WE(
@@ -441,9 +512,6 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
       /*            if (resLocalSolver) */
       /*              printf("Numerics:GenericMechanical_drivers Local solver failed\n"); */
       /*   ); */
-      posInX += curProblem->size;
-      curProblem = curProblem->nextProblem;
-      currentRowNumber++;
 
     }
     /*compute global error.*/
@@ -539,8 +607,16 @@ void gmp_gauss_seidel(GenericMechanicalProblem* pGMP, double * reaction, double
   if(! options->dWork)
     free(pPrevReaction);
   *info = tolViolate;
-  if(storageType == NM_DENSE)
-    free(bufForLocalProblemDense);
+  for(int b = 0; b < nbBlocks; ++b)
+  {
+    if(plan[b].equalityM)
+      NM_free(plan[b].equalityM);
+    if(plan[b].prevRhs)
+      free(plan[b].prevRhs);
+  }
+  free(plan);
+  if(diagArena)
+    free(diagArena);
   DEBUG_END("gmp_gauss_seidel(...)\n");
 }
 
@@ -29,6 +29,7 @@
 #include "siconos_debug.h"                         // for DEBUG_END, DEBUG_BEGIN
 #include "lcp_cst.h"                       // for SICONOS_LCP_IPARAM_PIVOTIN...
 #include "numerics_verbose.h"              // for numerics_error, verbose
+#include "NumericsPerfCounters.h"          // for perf_counters_begin
 
 const char* const   SICONOS_LCP_LEMKE_STR = "Lemke";
 const char* const   SICONOS_LCP_NSGS_SBM_STR = "NSGS_SBM";
@@ -356,6 +357,11 @@ int linearComplementarity_driver(LinearComplementarityProblem* problem, double *
 
   /* Output info. : 0: ok -  >0: problem (depends on solver) */
   int info = -1;
+
+  PerfCountersHandle perf_handle;
+  int collect_perf = options->stats && options->stats->collect_perf;
+  if(collect_perf) perf_counters_begin(&perf_handle);
+
   /* Switch to DenseMatrix or SparseBlockMatrix solver according to the type of storage for M */
   /* Storage type for the matrix M of the LCP */
 
@@ -370,6 +376,7 @@ int linearComplementarity_driver(LinearComplementarityProblem* problem, double *
   {
     info = lcp_driver_DenseMatrix(problem, z, w, options);
   }
+  if(collect_perf) perf_counters_end(&perf_handle, &options->stats->perf);
   DEBUG_END("linearComplementarity_driver(...)\n");
   return info;
 }
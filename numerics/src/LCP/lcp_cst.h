@@ -73,6 +73,9 @@ enum SICONOS_LCP_IPARAM
    SICONOS_LCP_IPARAM_ENUM_USE_DGELS =10,
    /** index in iparam to store to activate multiple solutions search */
    SICONOS_LCP_IPARAM_ENUM_MULTIPLE_SOLUTIONS =11,
+   /** index in iparam to let a pivoting solver try the complementary basis
+       suggested by the active set of the incoming z before cold starting */
+   SICONOS_LCP_IPARAM_WARM_START_FROM_Z =12,
   };
 
 enum SICONOS_LCP_DPARAM
@@ -31,12 +31,80 @@
 /* #define MAX_PIVOT */
 /* #define INV_PIVOT */
 #include "siconos_debug.h"                         // for DEBUG_EXPR_WE, DEBUG_PRINT
+#include "SiconosLapack.h"                 // for DGESV, lapack_int
 #include "lcp_cst.h"                       // for SICONOS_LCP_IPARAM_PIVOTIN...
 #include "numerics_verbose.h"              // for verbose
+#include "pivot-utils.h"                   // for do_pivot_driftless_rowmajor
+
+/* Try the complementary basis suggested by the incoming z (the active set
+ * of a previous, nearby solve): solve M_BB z_B = -q_B for the components
+ * where z > 0 and check that the resulting (z, w) is feasible.  When the
+ * guessed active set is the right one -- the common case for two adjacent
+ * events -- one linear solve replaces the whole pivot sequence.  Returns 1
+ * and fills zlem/wlem on success; on any failure the caller cold starts,
+ * so this is only a shortcut.
+ */
+static int lcp_lexicolemke_warm_basis(LinearComplementarityProblem* problem,
+                                      double *zlem, double *wlem, double tol)
+{
+  int dim = problem->size;
+  double * M = problem->M->matrix0;
+  double * q = problem->q;
 
-#ifdef DEBUG_MESSAGES
-#include "pivot-utils.h"
-#endif
+  int * active = (int *)malloc(dim * sizeof(int));
+  int nactive = 0;
+  for(int i = 0; i < dim; ++i)
+    if(zlem[i] > 0.) active[nactive++] = i;
+
+  /* an empty guess means z = 0, already rejected by the trivial-q test */
+  if(nactive == 0)
+  {
+    free(active);
+    return 0;
+  }
+
+  double * Mbb = (double *)malloc((size_t)nactive * nactive * sizeof(double));
+  double * zb = (double *)malloc(nactive * sizeof(double));
+  lapack_int * ipiv = (lapack_int *)malloc(nactive * sizeof(lapack_int));
+  lapack_int LAinfo = 0;
+
+  /* M->matrix0 is column-major */
+  for(int col = 0; col < nactive; ++col)
+    for(int row = 0; row < nactive; ++row)
+      Mbb[nactive * col + row] = M[dim * active[col] + active[row]];
+  for(int row = 0; row < nactive; ++row)
+    zb[row] = -q[active[row]];
+
+  DGESV(nactive, 1, Mbb, nactive, ipiv, zb, nactive, &LAinfo);
+
+  int ok = (LAinfo == 0);
+  for(int k = 0; ok && k < nactive; ++k)
+    if(zb[k] < -tol) ok = 0;
+
+  if(ok)
+  {
+    for(int i = 0; i < dim; ++i)
+    {
+      zlem[i] = 0.;
+      wlem[i] = q[i];
+    }
+    for(int k = 0; k < nactive; ++k)
+      zlem[active[k]] = zb[k] > 0. ? zb[k] : 0.;
+    for(int i = 0; i < dim; ++i)
+      for(int k = 0; k < nactive; ++k)
+        wlem[i] += M[dim * active[k] + i] * zlem[active[k]];
+    for(int k = 0; k < nactive; ++k)
+      wlem[active[k]] = 0.;
+    for(int i = 0; ok && i < dim; ++i)
+      if(wlem[i] < -tol) ok = 0;
+  }
+
+  free(active);
+  free(Mbb);
+  free(zb);
+  free(ipiv);
+  return ok;
+}
 
 void lcp_lexicolemke(LinearComplementarityProblem* problem, double *zlem, double *wlem, int *info, SolverOptions* options)
 {
@@ -80,9 +148,24 @@ void lcp_lexicolemke(LinearComplementarityProblem* problem, double *zlem, double
     return ;
   }
 
+  if(options->iparam[SICONOS_LCP_IPARAM_WARM_START_FROM_Z] == 1)
+  {
+    if(lcp_lexicolemke_warm_basis(problem, zlem, wlem,
+                                  options->dparam[SICONOS_DPARAM_TOL]))
+    {
+      *info = 0;
+      options->iparam[SICONOS_IPARAM_ITER_DONE] = 0;
+      options->dparam[SICONOS_DPARAM_RESIDU] = 0.0;
+      if(verbose > 0)
+        printf("lcp_lexicolemke: warm basis from the incoming z accepted. \n");
+      return ;
+    }
+    if(verbose > 0)
+      printf("lcp_lexicolemke: warm basis from the incoming z rejected, cold starting. \n");
+  }
+
   double z0, zb, delta_lexico;
-  double pivot, tovip, ratio;
-  double tmp;
+  double ratio;
   int *basis;
   double** A;
 
@@ -96,8 +179,12 @@ void lcp_lexicolemke(LinearComplementarityProblem* problem, double *zlem, double
   basis = (int *)malloc(dim * sizeof(int));
   A = (double **)malloc(dim * sizeof(double*));
 
+  /* The rows of A live in one contiguous allocation, in row order: the
+   * pivot update then streams through the tableau and vectorizes over
+   * the contiguous rows. */
+  double * Adata = (double *)malloc((size_t)dim * dim2 * sizeof(double));
   for(ic = 0 ; ic < dim; ++ic)
-    A[ic] = (double *)malloc(dim2 * sizeof(double));
+    A[ic] = &Adata[(size_t)ic * dim2];
 
   /* construction of A matrix such that
    * A = [ q | Id | -d | -M ] with d = (1,...1)
@@ -189,31 +276,28 @@ void lcp_lexicolemke(LinearComplementarityProblem* problem, double *zlem, double
   /* Stop research of argmin lexico */
   DEBUG_PRINTF("Pivoting %i and %i\n", block, drive);
 
-  pivot = A[block][drive];
-  tovip = 1.0 / pivot;
-
   /* Pivot < block , drive > */
 
 #ifdef INV_PIVOT
-  A[block][drive] = tovip;
-#else
-  A[block][drive] = 1.;
-#endif
-  for(ic = 0       ; ic < drive ; ++ic) A[block][ic] = A[block][ic] * tovip;
-  for(ic = drive + 1 ; ic < dim2  ; ++ic) A[block][ic] = A[block][ic] * tovip;
-
-  /* */
-
-  for(ic = 0 ; ic < block ; ++ic)
-  {
-    tmp = A[ic][drive];
-    for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
-  }
-  for(ic = block + 1 ; ic < dim ; ++ic)
   {
-    tmp = A[ic][drive];
-    for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
+    double tovip = 1.0 / A[block][drive];
+    A[block][drive] = tovip;
+    for(ic = 0       ; ic < drive ; ++ic) A[block][ic] = A[block][ic] * tovip;
+    for(ic = drive + 1 ; ic < dim2  ; ++ic) A[block][ic] = A[block][ic] * tovip;
+    for(ic = 0 ; ic < block ; ++ic)
+    {
+      double tmp = A[ic][drive];
+      for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
+    }
+    for(ic = block + 1 ; ic < dim ; ++ic)
+    {
+      double tmp = A[ic][drive];
+      for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
+    }
   }
+#else
+  do_pivot_driftless_rowmajor(Adata, dim, dim2, dim2, block, drive);
+#endif
 
   nobasis = basis[block];
   basis[block] = drive;
@@ -413,29 +497,26 @@ void lcp_lexicolemke(LinearComplementarityProblem* problem, double *zlem, double
 
     /* Pivot < block , drive > */
 
-    pivot = A[block][drive];
-    tovip = 1.0 / pivot;
 #ifdef INV_PIVOT
-    A[block][drive] = tovip;
-#else
-    A[block][drive] = 1.;
-#endif
-
-    for(ic = 0       ; ic < drive ; ++ic) A[block][ic] = A[block][ic] * tovip;
-    for(ic = drive + 1 ; ic < dim2  ; ++ic) A[block][ic] = A[block][ic] * tovip;
-
-    /* */
-
-    for(ic = 0 ; ic < block ; ++ic)
-    {
-      tmp = A[ic][drive];
-      for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
-    }
-    for(ic = block + 1 ; ic < dim ; ++ic)
     {
-      tmp = A[ic][drive];
-      for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
+      double tovip = 1.0 / A[block][drive];
+      A[block][drive] = tovip;
+      for(ic = 0       ; ic < drive ; ++ic) A[block][ic] = A[block][ic] * tovip;
+      for(ic = drive + 1 ; ic < dim2  ; ++ic) A[block][ic] = A[block][ic] * tovip;
+      for(ic = 0 ; ic < block ; ++ic)
+      {
+        double tmp = A[ic][drive];
+        for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
+      }
+      for(ic = block + 1 ; ic < dim ; ++ic)
+      {
+        double tmp = A[ic][drive];
+        for(jc = 0 ; jc < dim2 ; ++jc) A[ic][jc] -=  tmp * A[block][jc];
+      }
     }
+#else
+    do_pivot_driftless_rowmajor(Adata, dim, dim2, dim2, block, drive);
+#endif
 
     nobasis = basis[block];
     basis[block] = drive;
@@ -520,7 +601,7 @@ void lcp_lexicolemke(LinearComplementarityProblem* problem, double *zlem, double
 
   free(basis);
 
-  for(i = 0 ; i < dim ; ++i) free(A[i]);
+  free(Adata);
   free(A);
   free(candidate_pivots_indx);
 }
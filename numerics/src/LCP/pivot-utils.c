@@ -38,6 +38,10 @@
 #define LEXICO_TOL_DISPLAY 1e-10
 #define SIZE_CANDIDATE_PIVOT 5
 
+/* number of scalar updates under which a rank-1 pivot update is not
+   worth distributing over threads */
+#define PIVOT_PARALLEL_THRESHOLD (1 << 16)
+
 #define BASIS_OFFSET 1
 
 const char* basis_to_name(unsigned nb, unsigned n)
@@ -743,12 +747,18 @@ void do_pivot_driftless(double* mat, unsigned int dim, unsigned int dim2, unsign
   for(unsigned int i = drive + 1; i < dim2 ; ++i) mat[block + i*dim] *= pivot_inv;
 
   /* Update other columns*/
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(static) if(ncols > PIVOT_PARALLEL_THRESHOLD)
+#endif
   for(unsigned int i = 0; i < block; ++i)
   {
     double tmp = mat[i + drive*dim];
     /* nm_ij = m_ij + (m_ir/m_rs)m_rj = m_ij - m_is*nm_rj */
     for(unsigned int j = 0; j < ncols; j+=dim) mat[i + j] -= tmp*mat[block + j];
   }
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(static) if(ncols > PIVOT_PARALLEL_THRESHOLD)
+#endif
   for(unsigned int i = block + 1; i < dim; ++i)
   {
     double tmp = mat[i + drive*dim];
@@ -819,6 +829,36 @@ void do_pivot(double* mat, unsigned int dim, unsigned int dim2, unsigned int blo
   }
 }
 
+void do_pivot_driftless_rowmajor(double* mat, unsigned int dim, unsigned int dim2, unsigned int ld, unsigned int block, unsigned int drive)
+{
+  double* row_block = &mat[block * (size_t)ld];
+  if(fabs(row_block[drive]) < DBL_EPSILON)
+  {
+    printf("do_pivot_driftless_rowmajor :: pivot value too small %e; q[block] = %e; theta = %e\n", row_block[drive], row_block[0], row_block[0]/row_block[drive]);
+  }
+  double pivot_inv = 1.0/row_block[drive];
+
+  /* Update row mat[block, :] */
+  row_block[drive] = 1.; /* nm_rs = 1 */
+  /* nm_rj = m_rj/m_rs */
+  for(unsigned int j = 0        ; j < drive; ++j) row_block[j] *= pivot_inv;
+  for(unsigned int j = drive + 1; j < dim2 ; ++j) row_block[j] *= pivot_inv;
+
+  /* Update the other rows: nm_ij = m_ij - m_is*nm_rj. The loop over j
+     includes the driving column, where it yields m_is - m_is*1 = 0, so
+     each row is one unbroken streaming pass. */
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(static) if((size_t)dim * dim2 > PIVOT_PARALLEL_THRESHOLD)
+#endif
+  for(int i = 0; i < (int)dim; ++i)
+  {
+    if(i == (int)block) continue;
+    double* row = &mat[i * (size_t)ld];
+    double tmp = row[drive];
+    for(unsigned int j = 0; j < dim2; ++j) row[j] -= tmp*row_block[j];
+  }
+}
+
 void do_pivot_lumod(SN_lumod_dense_data* restrict lumod_data, NumericsMatrix* restrict M, double* restrict q_tilde, double* restrict lexico_mat, double* restrict col_drive, double* restrict col_tilde, unsigned* basis, unsigned block, unsigned drive)
 {
   unsigned n = lumod_data->n;
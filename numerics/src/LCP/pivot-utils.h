@@ -147,6 +147,21 @@ void do_pivot_driftless2(double* mat, unsigned int dim, unsigned int dim2, unsig
  */
 void do_pivot(double* mat, unsigned int dim, unsigned int dim2, unsigned int block, unsigned int drive);
 
+/** Do the pivot <block, drive> on a row-major tableau with contiguous
+ * rows, driftless version. This is the rank-1 update written so that
+ * the inner loop streams through one row: it vectorizes, and the rows
+ * are distributed over OpenMP threads when the tableau is large enough.
+ * The semantics are those of do_pivot_driftless on the column-major
+ * layout.
+ * \param mat the matrix to update, mat[i*ld + j] is entry (i,j)
+ * \param dim the number of rows
+ * \param dim2 the number of columns
+ * \param ld the leading dimension (>= dim2)
+ * \param block the blocking or leaving variable
+ * \param drive the driving or entering variable
+ */
+void do_pivot_driftless_rowmajor(double* mat, unsigned int dim, unsigned int dim2, unsigned int ld, unsigned int block, unsigned int drive);
+
 /** Do the pivot <block, drive> with block-LU updates
  * \param lumod_data lumod data
  * \param M the LCP matrix
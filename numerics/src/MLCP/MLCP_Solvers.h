@@ -192,6 +192,28 @@ void mlcp_path(MixedLinearComplementarityProblem *problem, double *z, double *w,
 void mlcp_enum(MixedLinearComplementarityProblem *problem, double *z, double *w,
                int *info, SolverOptions *options);
 
+/**
+   guided enumerative solver: the complementarity configurations are
+   visited by increasing Hamming distance from the pattern of the
+   incoming guess, candidates close to the guess are solved
+   incrementally against a single factorization and the candidates of
+   one distance level are searched in parallel (first hit wins).
+   Rectangular or DGELS problems fall back to mlcp_enum.
+
+   \param[in] problem structure that represents the MLCP (n,mM, q...)
+   \param[out] z a m+n-vector of doubles which contains the initial solution and
+   returns the solution of the problem.
+   \param[out] w a m+n-vector of doubles which returns the solution of the
+   problem.
+   \param[out] info an integer which returns the termination value:
+   0 : success,it found a solution
+   1 : failure,it did not find any solution
+   \param[in,out] options structure used to define the solver and its
+   parameters.
+*/
+void mlcp_enum_guided(MixedLinearComplementarityProblem *problem, double *z,
+                      double *w, int *info, SolverOptions *options);
+
 /**
    direct solver
 
@@ -364,6 +386,7 @@ void mlcp_rpsor_set_default(SolverOptions *options);
 void mlcp_direct_set_default(SolverOptions *options);
 void mlcp_direct_enum_set_default(SolverOptions *options);
 void mlcp_enum_set_default(SolverOptions *options);
+void mlcp_enum_guided_set_default(SolverOptions *options);
 /** @} */
 
 #if defined(__cplusplus) && !defined(BUILD_AS_CPP)
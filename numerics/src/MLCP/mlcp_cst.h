@@ -18,7 +18,8 @@ enum MLCP_SOLVER
   SICONOS_MLCP_FB = 112,
   SICONOS_MLCP_DIRECT_FB = 113,
   SICONOS_MLCP_PGS_SBM = 114,
-  SICONOS_MLCP_LCP_LEMKE = 115
+  SICONOS_MLCP_LCP_LEMKE = 115,
+  SICONOS_MLCP_ENUM_GUIDED = 116
 };
 
 enum SICONOS_IPARAM_MLCP
@@ -57,5 +58,6 @@ extern const char* const   SICONOS_MLCP_FB_STR;
 extern const char* const   SICONOS_MLCP_DIRECT_FB_STR;
 extern const char* const   SICONOS_MLCP_PGS_SBM_STR;
 extern const char* const   SICONOS_MLCP_LCP_LEMKE_STR;
+extern const char* const   SICONOS_MLCP_ENUM_GUIDED_STR;
 
 #endif
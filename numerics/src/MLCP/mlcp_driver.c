@@ -32,6 +32,7 @@
 #include "mlcp_direct_path_enum.h"              // for mlcp_direct_path_enum
 #include "mlcp_direct_simplex.h"                // for mlcp_direct_simplex_g...
 #include "mlcp_enum.h"                          // for mlcp_enum_alloc_worki...
+#include "mlcp_enum_guided.h"                   // for mlcp_enum_guided_getN...
 #include "mlcp_path_enum.h"                     // for mlcp_path_enum, mlcp_...
 #include "mlcp_simplex.h"                       // for mlcp_simplex_init
 #include "numerics_verbose.h"                   // for numerics_error, verbose
@@ -61,6 +62,7 @@ const char* const   SICONOS_MLCP_FB_STR = "MLCP_FB";
 const char* const   SICONOS_MLCP_DIRECT_FB_STR = "MLCP_DIRECT_FB";
 const char* const   SICONOS_MLCP_PGS_SBM_STR = "MLCP_PGS_SBM";
 const char* const   SICONOS_MLCP_LCP_LEMKE_STR = "MLCP_LCP_LEMKE";
+const char* const   SICONOS_MLCP_ENUM_GUIDED_STR = "MLCP_ENUM_GUIDED";
 
 
 
@@ -98,6 +100,10 @@ static void mlcp_driver_allocate_work_arrays(MixedLinearComplementarityProblem*
     iwsize = mlcp_enum_getNbIWork(problem, options);
     dwsize = mlcp_enum_getNbDWork(problem, options);
     break;
+  case SICONOS_MLCP_ENUM_GUIDED:
+    iwsize = mlcp_enum_guided_getNbIWork(problem, options);
+    dwsize = mlcp_enum_guided_getNbDWork(problem, options);
+    break;
   case SICONOS_MLCP_DIRECT_SIMPLEX:
     iwsize = mlcp_direct_getNbIWork(problem, options);
     dwsize = mlcp_direct_getNbDWork(problem, options);
@@ -281,6 +287,13 @@ int mlcp_driver(MixedLinearComplementarityProblem* problem, double *z, double *w
     mlcp_enum(problem, z, w, &info, options);
     break;
   }
+  /****** GUIDED ENUM algorithm ******/
+  case  SICONOS_MLCP_ENUM_GUIDED:
+  {
+    numerics_printf(" ========================== Call ENUM GUIDED solver for Mixed Linear Complementarity Problem (MLCP )===========");
+    mlcp_enum_guided(problem, z, w, &info, options);
+    break;
+  }
   /****** SIMPLEX algorithm ******/
   case SICONOS_MLCP_SIMPLEX:
     mlcp_simplex(problem, z, w, &info, options);
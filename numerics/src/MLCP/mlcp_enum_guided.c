@@ -0,0 +1,391 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+|A C| |u| |a| |0|
+|   |*| |+| |=| |
+|D B| |v| |b| |w|
+0<z*v>0
+dim(u)=mm
+dim(v)=nn
+
+Guided variant of the enumerative solver (see mlcp_enum.c).
+
+mlcp_enum visits the 2^m complementarity configurations in counter
+order, so its cost is blind to the quality of the incoming guess; on the
+medium problems produced by time-stepping the solution pattern barely
+moves between two successive calls and the counter order makes exactly
+those calls pay the worst case.  Here:
+
+- the configurations are visited by increasing Hamming distance from the
+  pattern read off the incoming (z, w) guess, so a warm-started call
+  tries the previous pattern first and its small perturbations next;
+
+- flipping one configuration bit replaces one column of the linear
+  system: a candidate at distance k from the guess is solved against the
+  single factorization of the guess configuration with the
+  Sherman-Morrison-Woodbury formula -- k+1 triangular solves and one
+  k x k dense solve instead of a fresh O((n+m)^3) factorization;
+
+- the candidates of one distance level are independent and searched in
+  parallel, every thread polling a shared flag so that the first hit
+  stops the others.
+**************************************************************************/
+
+#include <assert.h>                             // for assert
+#include <limits.h>                             // for ULLONG_MAX
+#ifndef __cplusplus
+#include <stdbool.h>                       // for false
+#endif
+#include <stdlib.h>                             // for malloc, free
+#include <string.h>                             // for memcpy
+
+#include "MLCP_Solvers.h"                       // for mlcp_compute_error
+#include "MixedLinearComplementarityProblem.h"  // for MixedLinearComplement...
+#include "NumericsMatrix.h"                     // for NumericsMatrix
+#include "SiconosBlas.h"                        // for cblas_dgemv
+#include "SiconosLapack.h"                      // for DGETRF, DGETRS, DGESV
+#include "SolverOptions.h"                      // for SolverOptions, SICONO...
+#include "mlcp_cst.h"                           // for SICONOS_IPARAM_MLCP_E...
+#include "enum_tool.h"                          // for enum_compute_nb_cases
+#include "mlcp_enum.h"                          // for mlcp_enum (fallback)
+#include "mlcp_enum_tool.h"                     // for mlcp_enum_build_M, ...
+#include "mlcp_enum_guided.h"
+#include "numerics_verbose.h"                   // for numerics_printf_verbose
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* #define DEBUG_MESSAGES */
+#include "siconos_debug.h"
+
+/** Local, static functions **/
+
+/* binomial coefficient, saturating at ULLONG_MAX: the counts are only
+ * compared with the (much smaller) iteration budget */
+static unsigned long long guided_binomial(int mm, int kk)
+{
+  if(kk < 0 || kk > mm) return 0;
+  if(kk > mm - kk) kk = mm - kk;
+  unsigned long long result = 1;
+  for(int i = 1; i <= kk; i++)
+  {
+    if(result > ULLONG_MAX / (unsigned long long)(mm - kk + i))
+      return ULLONG_MAX;
+    /* exact: result * (mm-kk+i) is always divisible by i here */
+    result = result * (unsigned long long)(mm - kk + i) / (unsigned long long)i;
+  }
+  return result;
+}
+
+/* fill pos[0] < ... < pos[k-1] with the combination of k positions out
+ * of m of lexicographic rank r; this is what makes the candidates of a
+ * distance level addressable by a plain (parallel) loop index */
+static void guided_unrank(unsigned long long r, int m, int k, int * pos)
+{
+  int j = 0;
+  for(int i = 0; i < k; i++)
+  {
+    unsigned long long count = guided_binomial(m - j - 1, k - i - 1);
+    while(r >= count)
+    {
+      r -= count;
+      j++;
+      count = guided_binomial(m - j - 1, k - i - 1);
+    }
+    pos[i] = j++;
+  }
+}
+
+/** End of static functions **/
+
+int mlcp_enum_guided_getNbIWork(MixedLinearComplementarityProblem* problem, SolverOptions* options)
+{
+  return mlcp_enum_getNbIWork(problem, options);
+}
+
+int mlcp_enum_guided_getNbDWork(MixedLinearComplementarityProblem* problem, SolverOptions* options)
+{
+  return mlcp_enum_getNbDWork(problem, options);
+}
+
+void mlcp_enum_guided(MixedLinearComplementarityProblem* problem, double *z, double *w, int *info, SolverOptions* options)
+{
+  assert(problem->M);
+  assert(problem->q);
+
+  int n = problem->n;
+  int m = problem->m;
+  int npm = n + m;
+  int n_row = problem->M->size0;
+
+  /* the incremental updates need the square, dense formulation; the
+     rectangular (DGELS) problems keep the exhaustive path */
+  if(!problem->M->matrix0 || n_row != npm
+      || options->iparam[SICONOS_IPARAM_MLCP_ENUM_USE_DGELS])
+  {
+    numerics_printf_verbose(1, "mlcp_enum_guided, rectangular or DGELS problem: falling back to mlcp_enum");
+    mlcp_enum(problem, z, w, info, options);
+    return;
+  }
+
+  double tol = options->dparam[SICONOS_DPARAM_TOL];
+  long long budget = options->iparam[SICONOS_IPARAM_MAX_ITER];
+  *info = 1;
+
+  numerics_printf_verbose(1, "mlcp_enum_guided BEGIN, n %d m %d tol %lf", n, m, tol);
+
+  /* shared work areas, carved out of the (mlcp_enum sized) options
+     arrays: the factors of the guess configuration, the right hand side
+     and its base solution */
+  double * M_base = options->dWork;                        /* npm x npm */
+  double * q_ref = M_base + (size_t)npm * npm;             /* npm */
+  double * y = q_ref + npm;                                /* npm */
+
+  int * zw_seed = options->iWork;                          /* m */
+  lapack_int * ipiv_base = (lapack_int *)(zw_seed + m);    /* npm */
+  int * indexInBlock = (int *)(ipiv_base + npm);           /* m */
+
+  for(int row = 0; row < npm; row++)
+    q_ref[row] = - problem->q[row];
+
+  /* cIdx[j] is the column (and row) of the j-th complementarity
+     variable; NULL means the plain formulation, where it is n + j */
+  int * cIdx = NULL;
+  if(problem->blocksRows)
+  {
+    mlcp_enum_build_indexInBlock(problem, indexInBlock);
+    cIdx = indexInBlock;
+  }
+
+  /* seed pattern from the incoming guess: bit j = 0 keeps z_j basic
+     (w_j = 0), bit j = 1 keeps w_j basic (z_j = 0); on a warm-started
+     call this is the pattern of the previous solution */
+  for(int j = 0; j < m; j++)
+  {
+    int cj = cIdx ? cIdx[j] : n + j;
+    zw_seed[j] = (z[cj] > w[cj]) ? 0 : 1;
+  }
+
+  /* factorize the guess configuration once; every nearby candidate is
+     then solved against these factors */
+  double * Mref = problem->M->matrix0;
+  if(cIdx)
+    mlcp_enum_build_M_Block(zw_seed, M_base, Mref, n, m, npm, indexInBlock);
+  else
+    mlcp_enum_build_M(zw_seed, M_base, Mref, n, m, npm);
+  lapack_int LAinfo = 0;
+  DGETRF(npm, npm, M_base, npm, ipiv_base, &LAinfo);
+  int base_ok = (LAinfo == 0);
+  if(base_ok)
+  {
+    memcpy(y, q_ref, npm * sizeof(double));
+    DGETRS(LA_NOTRANS, npm, 1, M_base, npm, ipiv_base, y, npm, &LAinfo);
+    base_ok = (LAinfo == 0);
+  }
+  if(!base_ok)
+    numerics_printf_verbose(1, "mlcp_enum_guided, the guess configuration is singular: every candidate pays a fresh factorization");
+
+  if((unsigned long long)budget < enum_compute_nb_cases(m))
+    numerics_warning("mlcp_enum_guided", "all the cases will not be enumerated since itermax < nbCase)");
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  /* per-thread scratch: update columns, capacitance system, candidate
+     solution, fresh-factorization matrix and a local (z, w) pair for
+     the error check */
+  int mz = (m > 0) ? m : 1;
+  size_t dsize = (size_t)npm * mz          /* Z */
+                 + (size_t)mz * mz         /* S */
+                 + mz                      /* t */
+                 + npm                     /* q candidate */
+                 + (size_t)npm * npm       /* M candidate */
+                 + 2 * (size_t)npm;        /* z, w local */
+  size_t isize = 2 * (size_t)mz + npm;     /* pos, zw candidate, ipiv */
+  double ** dscratch = (double **)malloc(nthreads * sizeof(double *));
+  int ** iscratch = (int **)malloc(nthreads * sizeof(int *));
+  for(int t = 0; t < nthreads; t++)
+  {
+    dscratch[t] = (double *)malloc(dsize * sizeof(double));
+    iscratch[t] = (int *)malloc(isize * sizeof(int));
+  }
+
+  int found = 0;
+  double found_err = 0.;
+
+  for(int level = 0; level <= m && !found && budget > 0; level++)
+  {
+    unsigned long long count = guided_binomial(m, level);
+    long long level_iters = (count > (unsigned long long)budget) ? budget : (long long)count;
+    budget -= level_iters;
+    numerics_printf_verbose(2, "mlcp_enum_guided, distance %d: %lld candidates", level, level_iters);
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for(long long r = 0; r < level_iters; r++)
+    {
+      if(found) continue; /* early termination broadcast */
+      int tid = 0;
+#ifdef _OPENMP
+      tid = omp_get_thread_num();
+#endif
+      double * Zc = dscratch[tid];
+      double * Sc = Zc + (size_t)npm * mz;
+      double * tc = Sc + (size_t)mz * mz;
+      double * qc = tc + mz;
+      double * Mc = qc + npm;
+      double * zloc = Mc + (size_t)npm * npm;
+      double * wloc = zloc + npm;
+      int * pos = iscratch[tid];
+      int * zw_cand = pos + mz;
+      lapack_int * ipiv = (lapack_int *)(zw_cand + mz);
+
+      guided_unrank((unsigned long long)r, m, level, pos);
+      memcpy(zw_cand, zw_seed, m * sizeof(int));
+      for(int i = 0; i < level; i++)
+        zw_cand[pos[i]] = !zw_cand[pos[i]];
+
+      lapack_int li = 0;
+      int solved = 0;
+      if(base_ok && level == 0)
+      {
+        /* the guess configuration itself: already solved */
+        memcpy(qc, y, npm * sizeof(double));
+        solved = 1;
+      }
+      else if(base_ok && 3 * level < npm)
+      {
+        /* the candidate matrix is the base one with `level` columns
+           replaced: A_cand = A_base + sum_i u_i e_{c_i}^T with
+           u_i = +-(Mref column c_i + e_{c_i}), the sign depending on
+           the flip direction.  Sherman-Morrison-Woodbury against the
+           base factors: x = y - Z (I + V^T Z)^{-1} V^T y, worth it as
+           long as `level` stays well under npm/3 */
+        for(int i = 0; i < level; i++)
+        {
+          int ci = cIdx ? cIdx[pos[i]] : n + pos[i];
+          double sign = zw_cand[pos[i]] ? -1.0 : 1.0;
+          double * col = Zc + (size_t)i * npm;
+          double * mcol = Mref + (size_t)ci * npm;
+          for(int row = 0; row < npm; row++)
+            col[row] = sign * mcol[row];
+          col[ci] += sign;
+        }
+        DGETRS(LA_NOTRANS, npm, level, M_base, npm, ipiv_base, Zc, npm, &li);
+        if(!li)
+        {
+          for(int a = 0; a < level; a++)
+          {
+            int ca = cIdx ? cIdx[pos[a]] : n + pos[a];
+            tc[a] = y[ca];
+            for(int b = 0; b < level; b++)
+              Sc[a + b * level] = ((a == b) ? 1.0 : 0.0) + Zc[ca + (size_t)b * npm];
+          }
+          DGESV(level, 1, Sc, level, ipiv, tc, level, &li);
+          if(!li)
+          {
+            memcpy(qc, y, npm * sizeof(double));
+            cblas_dgemv(CblasColMajor, CblasNoTrans, npm, level, -1.0, Zc, npm, tc, 1, 1.0, qc, 1);
+            solved = 1;
+          }
+        }
+      }
+      if(!solved)
+      {
+        /* far from the guess, singular base or singular update: fresh
+           factorization, as in mlcp_enum */
+        if(cIdx)
+          mlcp_enum_build_M_Block(zw_cand, Mc, Mref, n, m, npm, cIdx);
+        else
+          mlcp_enum_build_M(zw_cand, Mc, Mref, n, m, npm);
+        memcpy(qc, q_ref, npm * sizeof(double));
+        li = 0;
+        DGESV(npm, 1, Mc, npm, ipiv, qc, npm, &li);
+        if(li) continue; /* this configuration is singular */
+      }
+
+      /* solution in the cone? */
+      int check = 1;
+      for(int row = 0; row < m; row++)
+      {
+        int cr = cIdx ? cIdx[row] : n + row;
+        if(qc[cr] < - tol)
+        {
+          check = 0;
+          break;/*out of the cone!*/
+        }
+      }
+      if(!check) continue;
+
+      if(cIdx)
+        mlcp_enum_fill_solution_Block(zloc, wloc, n, m, npm, zw_cand, qc, cIdx);
+      else
+        mlcp_enum_fill_solution(zloc, zloc + n, wloc, wloc + n, n, m, npm, zw_cand, qc);
+      double err = 0.;
+      mlcp_compute_error(problem, zloc, wloc, tol, &err);
+      /*because it happens the LU leads to an wrong solution witout raise any error.*/
+      if(err > 10 * tol)
+      {
+        numerics_printf_verbose(1, "mlcp_enum_guided, LU no-error, but mlcp_compute_error out of tol: %e!", err);
+        continue;
+      }
+
+      /* first hit wins */
+#ifdef _OPENMP
+      #pragma omp critical (mlcp_enum_guided_commit)
+#endif
+      if(!found)
+      {
+        memcpy(z, zloc, npm * sizeof(double));
+        memcpy(w, wloc, npm * sizeof(double));
+        found_err = err;
+        found = 1;
+      }
+    }
+  }
+
+  for(int t = 0; t < nthreads; t++)
+  {
+    free(dscratch[t]);
+    free(iscratch[t]);
+  }
+  free(dscratch);
+  free(iscratch);
+
+  if(found)
+  {
+    *info = 0;
+    options->dparam[SICONOS_DPARAM_RESIDU] = found_err;
+    numerics_printf_verbose(1, "mlcp_enum_guided find a solution, err=%e !", found_err);
+    numerics_printf_verbose(1, "mlcp_enum_guided END");
+  }
+  else
+    numerics_printf_verbose(1, "mlcp_enum_guided failed!");
+}
+
+void mlcp_enum_guided_set_default(SolverOptions* options)
+{
+  options->iparam[SICONOS_IPARAM_MAX_ITER] = 10000000;
+  options->iparam[SICONOS_IPARAM_MLCP_ENUM_USE_DGELS] = 0;
+  options->filterOn = false;
+}
@@ -0,0 +1,10 @@
+#ifndef MLCP_ENUM_GUIDED_H
+#define MLCP_ENUM_GUIDED_H
+
+#include "NumericsFwd.h"  // for MixedLinearComplementarityProblem, SolverOp...
+/* The guided solver shares the work areas (and the sizes) of the
+   exhaustive one, so that its rectangular/DGELS fallback to mlcp_enum
+   always fits. */
+int mlcp_enum_guided_getNbIWork(MixedLinearComplementarityProblem* problem, SolverOptions* options);
+int mlcp_enum_guided_getNbDWork(MixedLinearComplementarityProblem* problem, SolverOptions* options);
+#endif // MLCP_ENUM_GUIDED_H
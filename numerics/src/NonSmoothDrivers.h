@@ -113,6 +113,30 @@ extern "C"
   */
   int fc3d_driver(FrictionContactProblem* problem, double *reaction , double *velocity, SolverOptions* options);
 
+  /**
+     Batched interface to solvers for many small independent
+     friction-contact 3D problems (typically the islands of a
+     decomposed step). The options are validated once; the problems are
+     scheduled over the available threads largest first, each worker
+     solving on a private copy of the options so that the solver
+     workspaces allocated there are reused across all the problems the
+     worker picks up.
+
+     \param[in] problems array of nproblems Friction-Contact problems
+     \param[in] nproblems number of problems
+     \param[in,out] reactions per-problem reaction vectors (3*nc each)
+     \param[in,out] velocities per-problem velocity vectors (3*nc each)
+     \param[out] infos per-problem termination status
+     \param[in,out] options structure used to define the solver(s) and
+     their parameters; on return the dparam/iparam outputs hold the worst
+     residual and iteration count over the batch
+     \return aggregate result (0 if every problem was solved, otherwise
+     the largest per-problem status).
+  */
+  int fc3d_driver_batch(FrictionContactProblem** problems, unsigned int nproblems,
+                        double** reactions, double** velocities,
+                        int* infos, SolverOptions* options);
+
   /**
      General interface to solvers for rolling friction-contact 3D problem
   
@@ -283,6 +307,71 @@ extern "C"
                                    int freq_output,
                                    int ndof);
 
+  /** Persistent coupling session for fc3d_LmgcDriver-style external
+      couplings (co-simulation loops calling the solver at every step of
+      the external code). The block structure of W is registered once at
+      creation; each solve then only passes the values that changed, and
+      the solver-side caches (matrix structure, solver workspaces, warm
+      starts carried by the reaction/velocity vectors) stay alive across
+      the calls. */
+  typedef struct fc3d_lmgc_session fc3d_lmgc_session;
+
+  /**
+     Open a persistent coupling session: register the block structure of
+     W and create the solver options once.
+
+     \param[in] nc number of contacts
+     \param[in] nb number of 3x3 blocks of W
+     \param[in] row 1-based block row of each block (copied)
+     \param[in] column 1-based block column of each block (copied)
+     \param[in] W the 3x3 blocks, row major inside a block (copied)
+     \param[in] mu the friction coefficients (nc, not copied: the array
+     must stay valid for the whole session)
+     \param[in] solver_id id an int to be mapped to actual solver in Numerics
+     \param[in] tolerance threshold used to validate the solution
+     \param[in] itermax the maximum number of iteration
+     \return the session handle, to be released with
+     fc3d_LmgcDriver_session_destroy()
+  */
+  fc3d_lmgc_session* fc3d_LmgcDriver_session_create(unsigned int nc,
+                                                    unsigned int nb,
+                                                    unsigned int *row,
+                                                    unsigned int *column,
+                                                    double *W,
+                                                    double *mu,
+                                                    int solver_id,
+                                                    double tolerance,
+                                                    int itermax);
+
+  /**
+     Solve with the registered structure, updating only the changed
+     values of W.
+
+     \param[in,out] session the session handle
+     \param[in,out] reaction global vector (nc*3), warm start in, solution out
+     \param[in,out] velocity global vector (nc*3)
+     \param[in] q global vector (nc*3), read during the solve
+     \param[in] W the 3x3 blocks, same order as at registration, or NULL
+     when no block changed since the previous call
+     \param[in] changed_rows bitmap of the block rows whose blocks
+     changed (bit i set when block row i changed, array of
+     (nc + 7) / 8 bytes), or NULL to copy every block of W
+     \return result (0 if successful otherwise 1)
+  */
+  int fc3d_LmgcDriver_session_solve(fc3d_lmgc_session* session,
+                                    double *reaction,
+                                    double *velocity,
+                                    double *q,
+                                    const double *W,
+                                    const unsigned char *changed_rows);
+
+  /**
+     Close a coupling session and release every solver-side cache.
+
+     \param[in,out] session the session handle
+  */
+  void fc3d_LmgcDriver_session_destroy(fc3d_lmgc_session* session);
+
   /**
      LMGC interface to solvers for global friction-contact 3D problem
      
@@ -18,7 +18,6 @@
 #include "NonSmoothNewton.h"
 #include <stdlib.h>            // for free, malloc, NULL, calloc
 #include "Newton_methods.h"    // for SICONOS_IPARAM_STOPPING_CRITERION, SIC...
-#include "NumericsMatrix.h"    // for NM_create, NM_clear, NM_DENSE, Numerics...
 #include "SolverOptions.h"     // for SolverOptions, SICONOS_DPARAM_RESIDU
 #include "math.h"              // for fmax, pow
 #include "numerics_verbose.h"  // for numerics_printf, numerics_printf_verbose
@@ -31,16 +30,13 @@
 #include "siconos_debug.h"
 
 
-void linesearch_Armijo(int n, double *z, double* dir, double psi_k,
-                       double descentCondition, NewtonFunctionPtr* phi)
+/* Same as linesearch_Armijo below, with a caller-provided buffer (of
+   size n) for the phi evaluations, so the inner Newton loops do not
+   allocate per linesearch */
+static void linesearch_Armijo_work(int n, double *z, double* dir, double psi_k,
+                                   double descentCondition, NewtonFunctionPtr* phi,
+                                   double * phiVector)
 {
-  double * phiVector = (double*)malloc((size_t)n * sizeof(*phiVector));
-  if(phiVector == NULL)
-  {
-    fprintf(stderr, "NonSmoothNewton: linesearch_Armijo, memory allocation failed for phiVector\n");
-    exit(EXIT_FAILURE);
-  }
-
   /* IN :
      psi_k (merit function for current iteration)
      jacobian_psi_k (jacobian of the merit function)
@@ -72,7 +68,6 @@ void linesearch_Armijo(int n, double *z, double* dir, double psi_k,
     warning: (-tk) because we need to start from z0 at each step while z_k+1 is saved in place of z_k ...*/
     cblas_daxpy(n, -tk, dir, incx, z, incy);
   }
-  free(phiVector);
   if(tk <= tmin)
     numerics_printf("Non Smooth Newton:\t\t linesearch_Armijo warning, resulting tk < tmin, linesearch stopped.");
   else
@@ -80,6 +75,19 @@ void linesearch_Armijo(int n, double *z, double* dir, double psi_k,
 
 }
 
+void linesearch_Armijo(int n, double *z, double* dir, double psi_k,
+                       double descentCondition, NewtonFunctionPtr* phi)
+{
+  double * phiVector = (double*)malloc((size_t)n * sizeof(*phiVector));
+  if(phiVector == NULL)
+  {
+    fprintf(stderr, "NonSmoothNewton: linesearch_Armijo, memory allocation failed for phiVector\n");
+    exit(EXIT_FAILURE);
+  }
+  linesearch_Armijo_work(n, z, dir, psi_k, descentCondition, phi, phiVector);
+  free(phiVector);
+}
+
 int nonSmoothNewton(
   int n,
   double* z,
@@ -108,19 +116,48 @@ int nonSmoothNewton(
 
   lapack_int infoDGESV;
 
-  /* Memory allocation for phi and its jacobian */
-  double * phiVector = (double*)malloc((size_t)n * sizeof(double));
+  /* Workspace: phi, the gradient of the merit function, the linesearch
+     buffer and the (dense) jacobian, plus the pivots. With
+     SICONOS_IPARAM_PREALLOC it is allocated once in the SolverOptions
+     and reused by all the following calls on a same-size problem. */
+  double psi;
+  double * phiVector, * gradient_psi, * lsVector, * jacobianPhiMatrix;
+  lapack_int * ipiv;
 
+  size_t dWorkNeeded = (size_t)(3 + n) * (size_t)n;
 
-  NumericsMatrix * H = NM_create(NM_DENSE, n, n);
-  double * jacobianPhiMatrix = H->matrix0;
+  if(iparam[SICONOS_IPARAM_PREALLOC] && options->dWork == NULL)
+  {
+    options->dWork = (double *)calloc(dWorkNeeded, sizeof(double));
+    options->dWorkSize = dWorkNeeded;
+    options->iWork = (int *)calloc((size_t)n, sizeof(int));
+    options->iWorkSize = (size_t)n;
+  }
 
-  /** Memory allocation for the merit function and its gradient */
-  double psi;
-  double * gradient_psi = (double*)malloc((size_t)n * sizeof(*gradient_psi));
+  /* Only reuse a workspace with our own layout (sizes recorded above):
+     some callers (e.g. mcp_old_FischerBurmeister) park their own buffers
+     in dWork, with iWork left NULL. */
+  int use_dWork = options->dWork && options->dWorkSize == dWorkNeeded
+                  && options->iWork && options->iWorkSize == (size_t)n;
 
-  lapack_int* ipiv = (lapack_int *)malloc((size_t)n * sizeof(lapack_int));
-  if(phiVector == NULL || jacobianPhiMatrix == NULL ||  gradient_psi == NULL || ipiv == NULL)
+  if(use_dWork)
+  {
+    phiVector = options->dWork;
+    gradient_psi = phiVector + n;
+    lsVector = gradient_psi + n;
+    jacobianPhiMatrix = lsVector + n;
+    ipiv = (lapack_int *)options->iWork;
+  }
+  else
+  {
+    phiVector = (double*)malloc((size_t)n * sizeof(*phiVector));
+    gradient_psi = (double*)malloc((size_t)n * sizeof(*gradient_psi));
+    lsVector = (double*)malloc((size_t)n * sizeof(*lsVector));
+    jacobianPhiMatrix = (double*)malloc((size_t)n * (size_t)n * sizeof(*jacobianPhiMatrix));
+    ipiv = (lapack_int *)malloc((size_t)n * sizeof(lapack_int));
+  }
+  if(phiVector == NULL || jacobianPhiMatrix == NULL || gradient_psi == NULL
+      || lsVector == NULL || ipiv == NULL)
   {
     fprintf(stderr, "NonSmoothNewton, memory allocation failed.\n");
     exit(EXIT_FAILURE);
@@ -150,7 +187,6 @@ int nonSmoothNewton(
 
     cblas_dgemv(CblasColMajor, CblasTrans, n, n, 1.0, jacobianPhiMatrix, n,
                 phiVector, incx, 0.0, gradient_psi, incx);
-    DEBUG_PRINTF("norm 1 of jacobianPhiMatrix = %e\n", NM_norm_1(H));
 
     norm_gradient_psi = cblas_dnrm2(n, gradient_psi, 1);
 
@@ -207,7 +243,7 @@ int nonSmoothNewton(
     }
 
     /* Step-3 Line search: computes z_k+1 */
-    linesearch_Armijo(n, z, phiVector, psi, descentCondition, phi);
+    linesearch_Armijo_work(n, z, phiVector, psi, descentCondition, phi, lsVector);
 
     numerics_printf("Non Smooth Newton: iteration number %i, norm merit function = %e, norm grad. merit function = %14.7e .", niter, normPhi, norm_gradient_psi);
   }
@@ -217,11 +253,15 @@ int nonSmoothNewton(
   /* Final error */
   dparam[SICONOS_DPARAM_RESIDU] = terminationCriterion;
 
-  /** Free memory*/
-  free(phiVector);
-  NM_clear(H);
-  free(gradient_psi);
-  free(ipiv);
+  /** Free memory (kept in the SolverOptions when preallocated) */
+  if(!use_dWork)
+  {
+    free(phiVector);
+    free(gradient_psi);
+    free(lsVector);
+    free(jacobianPhiMatrix);
+    free(ipiv);
+  }
 
 
   if(dparam[SICONOS_DPARAM_RESIDU] > tolerance)
@@ -261,12 +301,43 @@ int nonSmoothDirectNewton(
   int incx = 1;
   lapack_int infoDGESV = 0;
   int n2 = n*n;
-  /* Memory allocation for phi and its jacobian */
-  double * phiVector = (double*)malloc((size_t)n * sizeof(*phiVector));
-  double *jacobianPhiMatrix = (double*)malloc((size_t)n2 * sizeof(*jacobianPhiMatrix));
-  /** merit function and its jacobian */
-  double *gradient_psi = (double*)malloc((size_t)n * sizeof(*gradient_psi));
-  lapack_int* ipiv = (lapack_int *)malloc((size_t)n * sizeof(lapack_int));
+
+  /* Workspace, kept in the SolverOptions across calls when
+     SICONOS_IPARAM_PREALLOC is set (same layout as nonSmoothNewton,
+     whose linesearch slot is simply unused here) */
+  double * phiVector, * gradient_psi, * jacobianPhiMatrix;
+  lapack_int * ipiv;
+
+  size_t dWorkNeeded = (size_t)(3 + n) * (size_t)n;
+
+  if(iparam[SICONOS_IPARAM_PREALLOC] && options->dWork == NULL)
+  {
+    options->dWork = (double *)calloc(dWorkNeeded, sizeof(double));
+    options->dWorkSize = dWorkNeeded;
+    options->iWork = (int *)calloc((size_t)n, sizeof(int));
+    options->iWorkSize = (size_t)n;
+  }
+
+  /* Same guard as nonSmoothNewton: reuse only a workspace with our own
+     layout, never a caller-owned dWork. */
+  int use_dWork = options->dWork && options->dWorkSize == dWorkNeeded
+                  && options->iWork && options->iWorkSize == (size_t)n;
+
+  if(use_dWork)
+  {
+    phiVector = options->dWork;
+    gradient_psi = phiVector + n;
+    jacobianPhiMatrix = gradient_psi + 2*n;
+    ipiv = (lapack_int *)options->iWork;
+  }
+  else
+  {
+    phiVector = (double*)malloc((size_t)n * sizeof(*phiVector));
+    jacobianPhiMatrix = (double*)malloc((size_t)n2 * sizeof(*jacobianPhiMatrix));
+    /** merit function and its jacobian */
+    gradient_psi = (double*)malloc((size_t)n * sizeof(*gradient_psi));
+    ipiv = (lapack_int *)malloc((size_t)n * sizeof(lapack_int));
+  }
   if(phiVector == NULL || jacobianPhiMatrix == NULL ||  gradient_psi == NULL || ipiv == NULL)
   {
     fprintf(stderr, "NonSmoothNewton, memory allocation failed.\n");
@@ -322,11 +393,14 @@ int nonSmoothDirectNewton(
   /* Final error */
   dparam[SICONOS_DPARAM_RESIDU] = terminationCriterion;
 
-  /** Free memory*/
-  free(phiVector);
-  free(jacobianPhiMatrix);
-  free(gradient_psi);
-  free(ipiv);
+  /** Free memory (kept in the SolverOptions when preallocated) */
+  if(!use_dWork)
+  {
+    free(phiVector);
+    free(jacobianPhiMatrix);
+    free(gradient_psi);
+    free(ipiv);
+  }
 
   if(dparam[SICONOS_DPARAM_RESIDU] > tolerance)
     numerics_printf("Non Smooth Newton:  warning. no convergence after %i iterations", niter);
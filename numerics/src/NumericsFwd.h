@@ -35,6 +35,7 @@ TYPEDEF_STRUCT(SparseBlockCoordinateMatrix)
 
 // Nonsmooth solvers
 TYPEDEF_STRUCT(SolverOptions)
+TYPEDEF_STRUCT(AndersonAcceleration)
 
 // Nonsmooth problems 
 TYPEDEF_STRUCT(SecondOrderConeLinearComplementarityProblem)
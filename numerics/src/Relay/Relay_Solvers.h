@@ -111,6 +111,24 @@ extern "C"
    */
   void relay_avi_caoferris_test(RelayProblem* problem, double* restrict z, double* restrict w, int *info, SolverOptions* options);
 
+  /** relay_small_enum is a direct solver for small (size <= 4) dense relay
+   * problems: it enumerates the 3^n sign patterns (each component at its
+   * lower bound, free, or at its upper bound), solving the <= 4x4 linear
+   * system of the free components for each candidate. The sign pattern of
+   * the last solution is kept in options->iWork and tried first, so a
+   * sequence of calls on a slowly varying problem usually costs a single
+   * tiny linear solve. Problems that are too large or not dense fall back
+   * on relay_avi_caoferris().
+   * \param[in] problem structure that represents the Relay (M, q...)
+   * \param[in,out] z a n-vector of doubles which returns the solution of the problem.
+   * \param[in,out] w a n-vector of doubles which returns the solution of the problem.
+   * \param options struct used to define the solver(s) and its (their) parameters
+   * \param[out] info an integer which returns the termination value:
+   0 = convergence,
+   1 = no convergence,
+  */
+  void relay_small_enum(RelayProblem* problem, double *z, double *w, int *info, SolverOptions* options);
+
   /** dr_latin is a specific latin (LArge Time INcrement)solver for dual relay problems.
    * \param[in] problem structure that represents the Relay (M, q...)
    * \param[in,out] z a n-vector of doubles which contains the initial solution and returns the solution of the problem.
@@ -35,6 +35,7 @@ const char* const   SICONOS_RELAY_ENUM_STR = "RELAY_ENUM";
 const char* const   SICONOS_RELAY_LEMKE_STR = "RELAY_LEMKE";
 const char* const   SICONOS_RELAY_AVI_CAOFERRIS_STR = "RELAY_AVI_CAOFERRIS";
 const char* const   SICONOS_RELAY_AVI_CAOFERRIS_TEST_STR = "test version of the solver by Cao & Ferris; DO NOT USE!";
+const char* const   SICONOS_RELAY_SMALL_ENUM_STR = "RELAY_SMALL_ENUM";
 
 int relay_driver(RelayProblem* problem, double *z, double *w,
                  SolverOptions* options)
@@ -115,6 +116,11 @@ int relay_driver(RelayProblem* problem, double *z, double *w,
   {
     relay_avi_caoferris_test(problem, z, w, &info, options);
     break;
+  }
+  case SICONOS_RELAY_SMALL_ENUM:
+  {
+    relay_small_enum(problem, z, w, &info, options);
+    break;
   }
     /* /\*error *\/ */
     // what should we do for case like SICONOS_RELAY_LEMKE (id) when the real solver is SICONOS_LCP_LEMKE ? Add case above ? No error ?
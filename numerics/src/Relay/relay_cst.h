@@ -29,7 +29,8 @@ enum RELAY_SOLVER
   SICONOS_RELAY_PATH = 302,
   SICONOS_RELAY_LEMKE = 303,
   SICONOS_RELAY_AVI_CAOFERRIS = 306,
-  SICONOS_RELAY_AVI_CAOFERRIS_TEST = 307
+  SICONOS_RELAY_AVI_CAOFERRIS_TEST = 307,
+  SICONOS_RELAY_SMALL_ENUM = 308
 };
 
 
@@ -41,4 +42,5 @@ extern const char* const   SICONOS_RELAY_ENUM_STR;
 extern const char* const   SICONOS_RELAY_LEMKE_STR;
 extern const char* const   SICONOS_RELAY_AVI_CAOFERRIS_STR;
 extern const char* const   SICONOS_RELAY_AVI_CAOFERRIS_TEST_STR;
+extern const char* const   SICONOS_RELAY_SMALL_ENUM_STR;
 #endif
@@ -0,0 +1,193 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include <assert.h>            // for assert
+#include <float.h>             // for DBL_EPSILON
+#include <math.h>              // for fabs
+#include <stdlib.h>            // for calloc
+
+#include "NumericsMatrix.h"    // for NumericsMatrix, NM_DENSE
+#include "RelayProblem.h"      // for RelayProblem
+#include "Relay_Solvers.h"     // for relay_small_enum, relay_avi_caoferris
+#include "SolverOptions.h"     // for SolverOptions, SICONOS_DPARAM_TOL
+#include "numerics_verbose.h"  // for numerics_warning
+
+/** Largest problem size handled by the direct enumeration. 3^4 = 81
+ * candidate patterns at most, each costing a <= 4x4 linear solve. */
+#define RELAY_SMALL_ENUM_MAXSIZE 4
+
+/* Try one sign pattern. state[i] is -1 (z_i = lb_i, w_i >= 0), 0
+ * (lb_i < z_i < ub_i, w_i = 0) or +1 (z_i = ub_i, w_i <= 0). The free
+ * components solve M_FF z_F = -(q_F + M_FB z_B); the pattern is accepted
+ * when the free components stay inside their bounds and the w of the
+ * components at a bound has the right sign, all within tol.
+ * M is the dense, column-major matrix of the problem.
+ * \return 0 if the pattern yields a solution, 1 otherwise
+ */
+static int relay_small_try_pattern(int n, const double* M, const double* q,
+                                   const double* lb, const double* ub,
+                                   const int* state, double tol,
+                                   double* z, double* w)
+{
+  int free_idx[RELAY_SMALL_ENUM_MAXSIZE];
+  int nf = 0;
+
+  for(int i = 0; i < n; ++i)
+  {
+    if(state[i] < 0) z[i] = lb[i];
+    else if(state[i] > 0) z[i] = ub[i];
+    else free_idx[nf++] = i;
+  }
+
+  if(nf > 0)
+  {
+    /* reduced system A x = b over the free components */
+    double A[RELAY_SMALL_ENUM_MAXSIZE * RELAY_SMALL_ENUM_MAXSIZE];
+    double b[RELAY_SMALL_ENUM_MAXSIZE];
+
+    for(int r = 0; r < nf; ++r)
+    {
+      int i = free_idx[r];
+      b[r] = -q[i];
+      for(int j = 0; j < n; ++j)
+      {
+        if(state[j] != 0) b[r] -= M[i + j * n] * z[j];
+      }
+      for(int c = 0; c < nf; ++c)
+        A[r + c * nf] = M[i + free_idx[c] * n];
+    }
+
+    /* Gaussian elimination with partial pivoting, size <= 4 */
+    int perm[RELAY_SMALL_ENUM_MAXSIZE] = {0, 1, 2, 3};
+    for(int k = 0; k < nf; ++k)
+    {
+      int piv = k;
+      for(int r = k + 1; r < nf; ++r)
+        if(fabs(A[perm[r] + k * nf]) > fabs(A[perm[piv] + k * nf])) piv = r;
+      int tmp = perm[k];
+      perm[k] = perm[piv];
+      perm[piv] = tmp;
+      double akk = A[perm[k] + k * nf];
+      if(fabs(akk) < 100. * DBL_EPSILON) return 1;  /* singular sub-block */
+      for(int r = k + 1; r < nf; ++r)
+      {
+        double f = A[perm[r] + k * nf] / akk;
+        for(int c = k + 1; c < nf; ++c)
+          A[perm[r] + c * nf] -= f * A[perm[k] + c * nf];
+        b[perm[r]] -= f * b[perm[k]];
+      }
+    }
+    for(int k = nf - 1; k >= 0; --k)
+    {
+      double s = b[perm[k]];
+      for(int c = k + 1; c < nf; ++c)
+        s -= A[perm[k] + c * nf] * b[perm[c]];
+      b[perm[k]] = s / A[perm[k] + k * nf];
+    }
+
+    for(int r = 0; r < nf; ++r)
+    {
+      int i = free_idx[r];
+      z[i] = b[perm[r]];
+      if(z[i] < lb[i] - tol || z[i] > ub[i] + tol) return 1;
+    }
+  }
+
+  /* w = M z + q, and sign check on the components at a bound */
+  for(int i = 0; i < n; ++i)
+  {
+    double s = q[i];
+    for(int j = 0; j < n; ++j) s += M[i + j * n] * z[j];
+    w[i] = s;
+    if(state[i] < 0 && s < -tol) return 1;
+    if(state[i] > 0 && s > tol) return 1;
+  }
+  return 0;
+}
+
+/* decode a base-3 pattern code into states in {-1, 0, 1} */
+static void relay_small_decode(int code, int n, int* state)
+{
+  for(int i = 0; i < n; ++i)
+  {
+    state[i] = code % 3 - 1;
+    code /= 3;
+  }
+}
+
+void relay_small_enum(RelayProblem* problem, double *z, double *w, int *info, SolverOptions* options)
+{
+  int n = problem->size;
+
+  if(n > RELAY_SMALL_ENUM_MAXSIZE || problem->M->storageType != NM_DENSE)
+  {
+    numerics_warning("relay_small_enum",
+                     "problem size %d > %d or non-dense storage, falling back on relay_avi_caoferris\n",
+                     n, RELAY_SMALL_ENUM_MAXSIZE);
+    relay_avi_caoferris(problem, z, w, info, options);
+    return;
+  }
+
+  double* M = problem->M->matrix0;
+  double tol = options->dparam[SICONOS_DPARAM_TOL];
+  int npatterns = 1;
+  for(int i = 0; i < n; ++i) npatterns *= 3;
+
+  /* iWork keeps the last successful pattern across calls: iWork[0] is
+   * the pattern code + 1 (0 when none), iWork[1] the problem size it
+   * was recorded for. */
+  if(!options->iWork || options->iWorkSize < 2)
+  {
+    options->iWork = (int*)calloc(2, sizeof(int));
+    options->iWorkSize = 2;
+  }
+  int warm_code = (options->iWork[1] == n) ? options->iWork[0] - 1 : -1;
+
+  int state[RELAY_SMALL_ENUM_MAXSIZE];
+
+  if(warm_code >= 0)
+  {
+    relay_small_decode(warm_code, n, state);
+    if(relay_small_try_pattern(n, M, problem->q, problem->lb, problem->ub,
+                               state, tol, z, w) == 0)
+    {
+      *info = 0;
+      options->dparam[SICONOS_DPARAM_RESIDU] = 0.0;
+      return;
+    }
+  }
+
+  for(int code = 0; code < npatterns; ++code)
+  {
+    if(code == warm_code) continue;  /* already tried */
+    relay_small_decode(code, n, state);
+    if(relay_small_try_pattern(n, M, problem->q, problem->lb, problem->ub,
+                               state, tol, z, w) == 0)
+    {
+      *info = 0;
+      options->dparam[SICONOS_DPARAM_RESIDU] = 0.0;
+      options->iWork[0] = code + 1;
+      options->iWork[1] = n;
+      return;
+    }
+  }
+
+  numerics_warning("relay_small_enum", "no sign pattern yields a solution\n");
+  *info = 1;
+  options->iWork[0] = 0;
+}
@@ -49,13 +49,7 @@ void Projection_VI_SOCLCP(void *viIn, double *x, double *PX)
   SecondOrderConeLinearComplementarityProblem * soclcp = pb->soclcp;
   //SecondOrderConeLinearComplementarityProblem_display(soclcp);
 
-  int cone =0;
   int n = soclcp->n;
   cblas_dcopy(n, x, 1, PX, 1);
-  int dim;
-  for(cone = 0 ; cone < soclcp->nc  ; ++cone)
-  {
-    dim=soclcp->coneIndex[cone+1]-soclcp->coneIndex[cone];
-    projectionOnSecondOrderCone(&PX[soclcp->coneIndex[cone]], soclcp->tau[cone], dim);
-  }
+  projectionOnSecondOrderCone_batch(soclcp->nc, PX, soclcp->coneIndex, soclcp->tau);
 }
@@ -255,46 +255,35 @@ void soclcp_nsgs(SecondOrderConeLinearComplementarityProblem* problem, double *r
   ComputeError_soclcp_Ptr computeError = NULL;
 
   unsigned int cone ;
-  int isConeDimensionsEqual=1;
-  /* Connect local solver and local problem*/
+  /* Connect local solver and local problem. The local problem buffers are
+     sized for the largest cone; soclcp_nsgs_update shrinks localproblem->n
+     to the dimension of the current cone on each sweep, so mixed cone
+     dimensions only cost the (dim_max - dim) slack in the buffers. */
   unsigned int dim_max = problem->coneIndex[1]-problem->coneIndex[0];
   for(cone = 1; cone < nc; cone++)
   {
-    if(dim_max !=problem->coneIndex[cone+1]-problem->coneIndex[cone])
-    {
-      isConeDimensionsEqual=0;
-      dim_max = max(dim_max,problem->coneIndex[cone+1]-problem->coneIndex[cone]);
-    }
-
+    dim_max = max(dim_max,problem->coneIndex[cone+1]-problem->coneIndex[cone]);
   }
 
   SecondOrderConeLinearComplementarityProblem* localproblem;
 
-  if(isConeDimensionsEqual)
+  localproblem = (SecondOrderConeLinearComplementarityProblem*)malloc(sizeof(SecondOrderConeLinearComplementarityProblem));
+  localproblem->nc = 1;
+  localproblem->n = dim_max;
+  localproblem->q = (double*)malloc(dim_max * sizeof(double));
+  localproblem->tau = (double*)malloc(sizeof(double));
+  localproblem->coneIndex = (unsigned int*)malloc(2*sizeof(unsigned int));
+  localproblem->coneIndex[0]=0;
+  localproblem->coneIndex[1]=dim_max;
+
+  if(problem->M->storageType != NM_SPARSE_BLOCK)
   {
-    localproblem = (SecondOrderConeLinearComplementarityProblem*)malloc(sizeof(SecondOrderConeLinearComplementarityProblem));
-    localproblem->nc = 1;
-    localproblem->n = dim_max;
-    localproblem->q = (double*)malloc(dim_max * sizeof(double));
-    localproblem->tau = (double*)malloc(sizeof(double));
-    localproblem->coneIndex = (unsigned int*)malloc(2*sizeof(unsigned int));
-    localproblem->coneIndex[0]=0;
-    localproblem->coneIndex[1]=dim_max;
-
-    if(problem->M->storageType != NM_SPARSE_BLOCK)
-    {
-      localproblem->M = NM_create_from_data(NM_DENSE, dim_max, dim_max,
-                                            malloc(dim_max*dim_max* sizeof(double)));
-    }
-    else
-    {
-      localproblem->M = NM_new();
-    }
+    localproblem->M = NM_create_from_data(NM_DENSE, dim_max, dim_max,
+                                          malloc(dim_max*dim_max* sizeof(double)));
   }
   else
   {
-    fprintf(stderr, "soclcp_nsgs error: not yet implemented.\n");
-    exit(EXIT_FAILURE);
+    localproblem->M = NM_new();
   }
 
   soclcp_initializeLocalSolver_nsgs(&local_solver, &update_localproblem,
@@ -323,7 +312,7 @@ void soclcp_nsgs(SecondOrderConeLinearComplementarityProblem* problem, double *r
       iparam[SICONOS_IPARAM_ERROR_EVALUATION] == SICONOS_ERROR_LIGHT_EVALUATION_NO_UPDATE)
   {
     int n =problem->n;
-    double * rold = (double*)malloc(n*sizeof(double)); // save memory if isConeDimensionsEqual
+    double * rold = (double*)malloc(n*sizeof(double));
     while((iter < itermax) && (hasNotConverged > 0))
     {
       ++iter;
@@ -385,7 +374,7 @@ void soclcp_nsgs(SecondOrderConeLinearComplementarityProblem* problem, double *r
       if(withRelaxation)
       {
         int n = problem->n;
-        double * rold = (double*)malloc(n*sizeof(double)); // save memory if isConeDimensionsEqual
+        double * rold = (double*)malloc(n*sizeof(double));
         double omega = dparam[SICONOS_DPARAM_SOCLCP_NSGS_RELAXATION];
         unsigned int dim;
         while((iter < itermax) && (hasNotConverged > 0))
@@ -477,7 +466,7 @@ void soclcp_nsgs(SecondOrderConeLinearComplementarityProblem* problem, double *r
       {
         int n = problem->n;
         unsigned int dim;
-        double * rold = (double*)malloc(n*sizeof(double)); // save memory if isConeDimensionsEqual
+        double * rold = (double*)malloc(n*sizeof(double));
         double omega = dparam[SICONOS_DPARAM_SOCLCP_NSGS_RELAXATION];
         while((iter < itermax) && (hasNotConverged > 0))
         {
@@ -86,8 +86,14 @@ void soclcp_projection_free(SecondOrderConeLinearComplementarityProblem * proble
 }
 void soclcp_projection_initialize_with_regularization(SecondOrderConeLinearComplementarityProblem * problem, SecondOrderConeLinearComplementarityProblem * localproblem)
 {
+  int nc = problem->nc;
+  unsigned int dim_max=0;
+  for(int i =0; i <nc; i++)
+  {
+    dim_max=max(dim_max,problem->coneIndex[i+1]-problem->coneIndex[i]);
+  }
   if(!localproblem->M->matrix0)
-    localproblem->M->matrix0 = (double*)malloc(9 * sizeof(double));
+    localproblem->M->matrix0 = (double*)malloc(dim_max * dim_max * sizeof(double));
 }
 
 void soclcp_projection_update_with_regularization(int cone, SecondOrderConeLinearComplementarityProblem * problem, SecondOrderConeLinearComplementarityProblem * localproblem, double* reaction, SolverOptions* options)
@@ -105,22 +111,24 @@ void soclcp_projection_update_with_regularization(int cone, SecondOrderConeLinea
 
   /* The part of MGlobal which corresponds to the current block is copied into MLocal */
   int coneStart = problem->coneIndex[cone];
-  NM_extract_diag_block(problem->M, cone, coneStart, problem->coneIndex[cone+1] - coneStart, &localproblem->M->matrix0);
+  int dim = problem->coneIndex[cone+1] - coneStart;
+  NM_extract_diag_block(problem->M, cone, coneStart, dim, &localproblem->M->matrix0);
+
+  /* dimension and index of the current cone */
+  localproblem->n = dim;
+  localproblem->coneIndex[0] = 0;
 
   /****  Computation of qLocal = qBlock + sum over a row of blocks in MGlobal of the products MLocal.reactionBlock,
      excluding the block corresponding to the current cone. ****/
   soclcp_nsgs_computeqLocal(problem, localproblem, reaction, cone, options);
 
   double rho = options->dparam[SICONOS_DPARAM_SOCLCP_PROJECTION_RHO];
-  for(int i = 0 ; i < 3 ; i++) localproblem->M->matrix0[i + 3 * i] += rho ;
+  for(int i = 0 ; i < dim ; i++) localproblem->M->matrix0[i + dim * i] += rho ;
 
   double *qLocal = localproblem->q;
-  int in = 3 * cone, it = in + 1, is = it + 1;
 
   /* qLocal computation*/
-  qLocal[0] -= rho * reaction[in];
-  qLocal[1] -= rho * reaction[it];
-  qLocal[2] -= rho * reaction[is];
+  for(int i = 0 ; i < dim ; i++) qLocal[i] -= rho * reaction[coneStart + i];
 
   /* coefficient for current block*/
   localproblem->tau[0] = problem->tau[cone];
@@ -241,9 +249,8 @@ int soclcp_projectionOnConeWithLocalIteration_solve(SecondOrderConeLinearComplem
     {
 
       rho_k = rho * pow(tau,ls_iter);
-      r[0] = r_k[0] - rho_k * v_k[0];
-      r[1] = r_k[1] - rho_k * v_k[1];
-      r[2] = r_k[2] - rho_k * v_k[2];
+      for(int i = 0; i < nLocal; i++)
+        r[i] = r_k[i] - rho_k * v_k[i];
 
       projectionOnSecondOrderCone(&r[0], mu_i, nLocal);
 
@@ -253,13 +260,15 @@ int soclcp_projectionOnConeWithLocalIteration_solve(SecondOrderConeLinearComplem
       /* v <- q + M * r  */
       cblas_dgemv(CblasColMajor,CblasNoTrans, nLocal, nLocal, 1.0, MLocal, nLocal, r, incx, 1.0, v, incy);
 
-      a1 = sqrt((v_k[0] - v[0]) * (v_k[0] - v[0]) +
-                (v_k[1] - v[1]) * (v_k[1] - v[1]) +
-                (v_k[2] - v[2]) * (v_k[2] - v[2]));
-
-      a2 = sqrt((r_k[0] - r[0]) * (r_k[0] - r[0]) +
-                (r_k[1] - r[1]) * (r_k[1] - r[1]) +
-                (r_k[2] - r[2]) * (r_k[2] - r[2]));
+      a1 = 0.0;
+      a2 = 0.0;
+      for(int i = 0; i < nLocal; i++)
+      {
+        a1 += (v_k[i] - v[i]) * (v_k[i] - v[i]);
+        a2 += (r_k[i] - r[i]) * (r_k[i] - r[i]);
+      }
+      a1 = sqrt(a1);
+      a2 = sqrt(a2);
 
 
 
@@ -72,6 +72,7 @@ SICONOS_SOLVER_MACRO(SICONOS_MLCP_FB); \
 SICONOS_SOLVER_MACRO(SICONOS_MLCP_DIRECT_FB); \
 SICONOS_SOLVER_MACRO(SICONOS_MLCP_PGS_SBM); \
 SICONOS_SOLVER_MACRO(SICONOS_MLCP_LCP_LEMKE); \
+SICONOS_SOLVER_MACRO(SICONOS_MLCP_ENUM_GUIDED); \
 SICONOS_SOLVER_MACRO(SICONOS_NCP_NEWTON_FB_FBLSA); \
 SICONOS_SOLVER_MACRO(SICONOS_NCP_NEWTON_MIN_FBLSA); \
 SICONOS_SOLVER_MACRO(SICONOS_NCP_PATHSEARCH); \
@@ -82,6 +83,7 @@ SICONOS_SOLVER_MACRO(SICONOS_RELAY_PATH); \
 SICONOS_SOLVER_MACRO(SICONOS_RELAY_LEMKE); \
 SICONOS_SOLVER_MACRO(SICONOS_RELAY_AVI_CAOFERRIS); \
 SICONOS_SOLVER_MACRO(SICONOS_RELAY_AVI_CAOFERRIS_TEST); \
+SICONOS_SOLVER_MACRO(SICONOS_RELAY_SMALL_ENUM); \
 SICONOS_SOLVER_MACRO(SICONOS_VI_EG); \
 SICONOS_SOLVER_MACRO(SICONOS_VI_FPP); \
 SICONOS_SOLVER_MACRO(SICONOS_VI_HP); \
@@ -93,6 +95,10 @@ SICONOS_SOLVER_MACRO(SICONOS_FRICTION_2D_ENUM);\
 SICONOS_SOLVER_MACRO(SICONOS_FRICTION_2D_LEMKE);\
 SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_NSGS);\
 SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_NSGSV);\
+SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_NSGS_MULTICOLOR);\
+SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_JACOBI);\
+SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_ISLANDS);\
+SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_REDUCED);\
 SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_PROX);\
 SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_TFP);\
 SICONOS_SOLVER_MACRO(SICONOS_FRICTION_3D_PFP);\
@@ -133,6 +139,7 @@ SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_3D_NSGS);\
 SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnConeWithLocalIteration);\
 SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_3D_ONECONTACT_ProjectionOnCone);\
 SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_3D_ADMM);\
+SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_3D_NSGS_MULTICOLOR);\
 SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_2D_NSGS);\
 SICONOS_SOLVER_MACRO(SICONOS_ROLLING_FRICTION_2D_ONECONTACT_ProjectionOnConeWithLocalIteration);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_NSGS_WR);\
@@ -141,6 +148,7 @@ SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_PROX_WR);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_DSFP_WR);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_TFP_WR);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_NSGS);\
+SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_NSGS_MPI);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_NSN_AC_WR);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_NSN_AC);\
 SICONOS_SOLVER_MACRO(SICONOS_GLOBAL_FRICTION_3D_GAMS_PATH);\
@@ -0,0 +1,158 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include "AndersonAcceleration.h"
+
+#include <assert.h>           // for assert
+#include <math.h>             // for isfinite, fabs
+#include <stdlib.h>           // for malloc, free, NULL
+#include <string.h>           // for memmove
+
+#include "SiconosBlas.h"      // for cblas_dcopy, cblas_daxpy, cblas_dgemv
+#include "SiconosLapack.h"    // for DGELS, lapack_int
+#include "numerics_verbose.h" // for numerics_printf_verbose
+
+/* Restart when the 1-norm of the mixing coefficients exceeds this bound:
+   a huge gamma means the residual differences are (nearly) linearly
+   dependent and the extrapolation is dominated by noise. */
+#define ANDERSON_GAMMA_MAX 1e4
+
+struct AndersonAcceleration
+{
+  unsigned int n;      /**< size of the iterates */
+  unsigned int depth;  /**< maximum history depth m */
+  unsigned int mk;     /**< current number of stored difference columns */
+  int has_previous;    /**< 1 once f_prev/g_prev hold the previous step */
+  double* dF;          /**< n x depth, columns of successive residual differences */
+  double* dG;          /**< n x depth, columns of successive image differences */
+  double* f;           /**< current residual g(x) - x */
+  double* f_prev;      /**< residual of the previous step */
+  double* g_prev;      /**< image of the previous step */
+  double* ls_A;        /**< n x depth scratch, dgels overwrites its input */
+  double* ls_b;        /**< right-hand side / solution of the mixing problem */
+};
+
+AndersonAcceleration* anderson_acceleration_new(unsigned int n, unsigned int depth)
+{
+  assert(n > 0);
+  assert(depth > 0);
+  AndersonAcceleration* aa = (AndersonAcceleration*)malloc(sizeof(AndersonAcceleration));
+  aa->n = n;
+  aa->depth = depth;
+  aa->mk = 0;
+  aa->has_previous = 0;
+  aa->dF = (double*)malloc((size_t)n * depth * sizeof(double));
+  aa->dG = (double*)malloc((size_t)n * depth * sizeof(double));
+  aa->f = (double*)malloc(n * sizeof(double));
+  aa->f_prev = (double*)malloc(n * sizeof(double));
+  aa->g_prev = (double*)malloc(n * sizeof(double));
+  aa->ls_A = (double*)malloc((size_t)n * depth * sizeof(double));
+  aa->ls_b = (double*)malloc(n * sizeof(double));
+  return aa;
+}
+
+void anderson_acceleration_free(AndersonAcceleration* aa)
+{
+  if(!aa) return;
+  free(aa->dF);
+  free(aa->dG);
+  free(aa->f);
+  free(aa->f_prev);
+  free(aa->g_prev);
+  free(aa->ls_A);
+  free(aa->ls_b);
+  free(aa);
+}
+
+void anderson_acceleration_restart(AndersonAcceleration* aa)
+{
+  aa->mk = 0;
+  aa->has_previous = 0;
+}
+
+int anderson_acceleration_step(AndersonAcceleration* aa, const double* x,
+                               const double* gx, double* x_next)
+{
+  unsigned int n = aa->n;
+
+  /* current residual f = g(x) - x */
+  cblas_dcopy(n, gx, 1, aa->f, 1);
+  cblas_daxpy(n, -1.0, x, 1, aa->f, 1);
+
+  if(aa->has_previous)
+  {
+    /* append the new difference columns, dropping the oldest when full */
+    if(aa->mk == aa->depth)
+    {
+      memmove(aa->dF, &aa->dF[n], (size_t)n * (aa->depth - 1) * sizeof(double));
+      memmove(aa->dG, &aa->dG[n], (size_t)n * (aa->depth - 1) * sizeof(double));
+      aa->mk--;
+    }
+    double* dF_col = &aa->dF[(size_t)n * aa->mk];
+    double* dG_col = &aa->dG[(size_t)n * aa->mk];
+    cblas_dcopy(n, aa->f, 1, dF_col, 1);
+    cblas_daxpy(n, -1.0, aa->f_prev, 1, dF_col, 1);
+    cblas_dcopy(n, gx, 1, dG_col, 1);
+    cblas_daxpy(n, -1.0, aa->g_prev, 1, dG_col, 1);
+    aa->mk++;
+  }
+
+  /* remember this step for the next difference column */
+  cblas_dcopy(n, aa->f, 1, aa->f_prev, 1);
+  cblas_dcopy(n, gx, 1, aa->g_prev, 1);
+  aa->has_previous = 1;
+
+  if(aa->mk == 0)
+  {
+    /* no history yet: plain fixed-point step */
+    if(x_next != gx) cblas_dcopy(n, gx, 1, x_next, 1);
+    return 0;
+  }
+
+  /* solve min || dF gamma - f || for the mixing coefficients; dgels
+     overwrites its input so the history is solved on a scratch copy */
+  lapack_int info = 0;
+  unsigned int mk = aa->mk;
+  cblas_dcopy(n * mk, aa->dF, 1, aa->ls_A, 1);
+  cblas_dcopy(n, aa->f, 1, aa->ls_b, 1);
+  DGELS(LA_NOTRANS, n, mk, 1, aa->ls_A, n, aa->ls_b, n, &info);
+
+  double gamma_norm1 = 0.0;
+  int breakdown = (info != 0);
+  for(unsigned int j = 0; j < mk && !breakdown; ++j)
+  {
+    if(!isfinite(aa->ls_b[j])) breakdown = 1;
+    gamma_norm1 += fabs(aa->ls_b[j]);
+  }
+  if(breakdown || gamma_norm1 > ANDERSON_GAMMA_MAX)
+  {
+    /* safeguard: keep the plain iterate and restart the history */
+    numerics_printf_verbose(2, "anderson_acceleration_step :: breakdown (info = %i, |gamma|_1 = %e), restart", (int)info, gamma_norm1);
+    anderson_acceleration_restart(aa);
+    /* the dropped step stays valid as the previous one */
+    cblas_dcopy(n, aa->f, 1, aa->f_prev, 1);
+    cblas_dcopy(n, gx, 1, aa->g_prev, 1);
+    aa->has_previous = 1;
+    if(x_next != gx) cblas_dcopy(n, gx, 1, x_next, 1);
+    return 0;
+  }
+
+  /* x_next = g(x) - dG gamma */
+  if(x_next != gx) cblas_dcopy(n, gx, 1, x_next, 1);
+  cblas_dgemv(CblasColMajor, CblasNoTrans, n, mk, -1.0, aa->dG, n, aa->ls_b, 1, 1.0, x_next, 1);
+  return 1;
+}
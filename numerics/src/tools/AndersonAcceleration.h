@@ -0,0 +1,75 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef AndersonAcceleration_h
+#define AndersonAcceleration_h
+
+/*!\file AndersonAcceleration.h
+  \brief Anderson acceleration of fixed-point iterations.
+
+  Wraps any iteration \f$ x_{k+1} = g(x_k) \f$: the caller keeps running
+  its plain fixed-point loop and, once per iteration, hands the pair
+  \f$ (x_k, g(x_k)) \f$ to anderson_acceleration_step() which replaces the
+  next iterate by a least-squares mixing of the last m images. All the
+  storage (history and least-squares workspace) is preallocated at
+  creation, so the per-iteration cost is one small dgels solve plus a few
+  vector operations. When the mixing problem breaks down (rank deficiency,
+  non-finite or huge coefficients) the step falls back to the plain
+  iterate and the history restarts, so the wrapped solver is never worse
+  than its unaccelerated form.
+*/
+
+#include "NumericsFwd.h"  // for AndersonAcceleration
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** Allocate an accelerator for iterates of size n with an m-deep history.
+      \param n size of the iterate vectors
+      \param depth history depth m (number of previous residual differences
+      kept); typical values are 3 to 10
+      \return the accelerator, to be released with anderson_acceleration_free()
+  */
+  AndersonAcceleration* anderson_acceleration_new(unsigned int n, unsigned int depth);
+
+  /** Release an accelerator and all its storage. */
+  void anderson_acceleration_free(AndersonAcceleration* aa);
+
+  /** Drop the accumulated history; the next step is a plain fixed-point
+      step again. Call it when the underlying map changes (restart,
+      modified problem data). */
+  void anderson_acceleration_restart(AndersonAcceleration* aa);
+
+  /** Produce the next iterate from one fixed-point evaluation.
+      \param aa the accelerator
+      \param x the iterate the evaluation started from, \f$ x_k \f$
+      \param gx the fixed-point image \f$ g(x_k) \f$
+      \param x_next output, the accelerated iterate (may alias gx)
+      \return 1 when the mixed iterate was produced, 0 when the plain
+      image gx was kept (history still filling up, or safeguarded
+      breakdown of the least-squares problem)
+  */
+  int anderson_acceleration_step(AndersonAcceleration* aa, const double* x,
+                                 const double* gx, double* x_next);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
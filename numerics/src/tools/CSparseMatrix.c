@@ -252,6 +252,34 @@ int CSparseMatrix_lu_factorization(CS_INT order, const cs *A, double tol, CSpars
 
   return (S && cs_lu_A->N);
 }
+
+css* CSparseMatrix_copy_lu_symbolic(const css* S, CS_INT n)
+{
+  /* cs_sqr with qr=0 only fills q, lnz and unz; the remaining members
+     are specific to QR/Cholesky and stay NULL. */
+  css* C = (css*) cs_calloc(1, sizeof(css));
+  if(!C) return NULL;
+  if(S->q)
+  {
+    C->q = (CS_INT*) cs_malloc(n, sizeof(CS_INT));
+    if(!C->q) return (css*) cs_sfree(C);
+    memcpy(C->q, S->q, n * sizeof(CS_INT));
+  }
+  C->lnz = S->lnz;
+  C->unz = S->unz;
+  return C;
+}
+
+int CSparseMatrix_lu_factorization_reuse_symbolic(const cs *A, double tol, const css* S, CSparseMatrix_factors * cs_lu_A)
+{
+  assert(A);
+  assert(S);
+  cs_lu_A->n = A->n;
+  cs_lu_A->S = CSparseMatrix_copy_lu_symbolic(S, A->n);
+  cs_lu_A->N = cs_lu(A, cs_lu_A->S, tol);
+
+  return (cs_lu_A->S && cs_lu_A->N);
+}
 int CSparseMatrix_chol_factorization(CS_INT order, const cs *A,  CSparseMatrix_factors * cs_chol_A)
 {
   assert(A);
@@ -265,6 +293,75 @@ int CSparseMatrix_chol_factorization(CS_INT order, const cs *A,  CSparseMatrix_f
 
   return (S && cs_chol_A->N);
 }
+int CSparseMatrix_chol_refactorization(const cs *A, CSparseMatrix_factors * cs_chol_A)
+{
+  assert(A);
+  assert(cs_chol_A->S);
+  /* the pattern of A did not change: the ordering, elimination tree and
+     column counts of the stored symbolic analysis still apply, only the
+     numerical factorization is redone */
+  if(cs_chol_A->N) cs_nfree(cs_chol_A->N);
+  cs_chol_A->N = cs_chol(A, cs_chol_A->S);
+
+  return (cs_chol_A->N != NULL);
+}
+
+CS_INT CSparseMatrix_chol_updown(CSparseMatrix_factors* cs_chol_A, int sigma, const double* w)
+{
+  assert(cs_chol_A);
+  assert(cs_chol_A->S);
+  assert(cs_chol_A->N);
+  assert(w);
+
+  CS_INT n = cs_chol_A->n;
+  const CS_INT* pinv = cs_chol_A->S->pinv;
+  const CS_INT* parent = cs_chol_A->S->parent;
+  cs* L = cs_chol_A->N->L;
+
+  /* sparse view of w in the row ordering of the factor */
+  cs* C = cs_spalloc(n, 1, n, 1, 0);
+  if(!C) return 0;
+  CS_INT nz = 0;
+  for(CS_INT i = 0; i < n; ++i)
+  {
+    if(w[i] == 0.) continue;
+    C->i[nz] = pinv ? pinv[i] : i;
+    C->x[nz] = w[i];
+    ++nz;
+  }
+  C->p[0] = 0;
+  C->p[1] = nz;
+
+  CS_INT ok = 1;
+  if(nz > 0)
+  {
+    /* cs_updown cannot create fill: the update is exact only when the
+       pattern of the permuted w fits in the pattern of the factor
+       column it starts in (whose rows are the ancestors of f in the
+       elimination tree). Reject w otherwise, the factors are untouched
+       and the caller refactorizes instead. */
+    CS_INT f = C->i[0];
+    for(CS_INT p = 1; p < nz; ++p) f = CS_MIN(f, C->i[p]);
+    char* in_column = (char*)cs_calloc(n, sizeof(char));
+    if(!in_column)
+    {
+      cs_spfree(C);
+      return 0;
+    }
+    in_column[f] = 1;
+    for(CS_INT p = L->p[f]; p < L->p[f + 1]; ++p) in_column[L->i[p]] = 1;
+    for(CS_INT p = 0; p < nz && ok; ++p)
+      if(!in_column[C->i[p]]) ok = 0;
+    cs_free(in_column);
+
+    /* a downdate may still find the result not positive definite; in
+       that case cs_updown stops mid-path and the factors are spoiled */
+    if(ok) ok = cs_updown(L, sigma, C, parent);
+  }
+  cs_spfree(C);
+  return ok;
+}
+
 int CSparseMatrix_ldlt_factorization(CS_INT order, const cs *A,  CSparseMatrix_factors * cs_ldlt_A)
 {
   assert(A);
@@ -375,6 +472,92 @@ CS_INT CSparseMatrix_solve(CSparseMatrix_factors* cs_lu_A, double* x, double *b)
   return (ok);
 }
 
+/* Solve AX = B for several dense right-hand sides with the factorization of
+ * A stored in cs_lu_A. The RHS are processed by panels of up to
+ * CSPARSEMATRIX_NRHS_BLOCK columns stored with the RHS index fastest, so
+ * that the factors are read once per panel and the innermost loops are
+ * unit-stride over the panel. */
+CS_INT CSparseMatrix_solve_multi(CSparseMatrix_factors* cs_lu_A, double* x, double *b, CS_INT nrhs)
+{
+  assert(cs_lu_A);
+
+  CS_INT ok;
+  CS_INT n = cs_lu_A->n;
+  css* S = cs_lu_A->S;
+  csn* N = cs_lu_A->N;
+  ok = (S && N && x) ;
+  if(ok)
+  {
+    cs* L = N->L;
+    cs* U = N->U;
+    for(CS_INT r0 = 0; r0 < nrhs; r0 += CSPARSEMATRIX_NRHS_BLOCK)
+    {
+      CS_INT nb = CS_MIN(CSPARSEMATRIX_NRHS_BLOCK, nrhs - r0);
+      /* gather the panel with the row permutation: x(p,:) = b */
+      for(CS_INT k = 0; k < n; k++)
+      {
+        double* xk = x + (N->pinv ? N->pinv[k] : k) * nb;
+        for(CS_INT r = 0; r < nb; r++) xk[r] = b[(r0 + r) * n + k];
+      }
+      /* blocked forward substitution x = L\x */
+      for(CS_INT j = 0; j < n; j++)
+      {
+        double* xj = x + j * nb;
+        double d = L->x[L->p[j]];
+        for(CS_INT r = 0; r < nb; r++) xj[r] /= d;
+        for(CS_INT p = L->p[j] + 1; p < L->p[j+1]; p++)
+        {
+          double lx = L->x[p];
+          double* xi = x + L->i[p] * nb;
+          for(CS_INT r = 0; r < nb; r++) xi[r] -= lx * xj[r];
+        }
+      }
+      /* blocked backward substitution x = U\x */
+      for(CS_INT j = n - 1; j >= 0; j--)
+      {
+        double* xj = x + j * nb;
+        double d = U->x[U->p[j+1] - 1];
+        for(CS_INT r = 0; r < nb; r++) xj[r] /= d;
+        for(CS_INT p = U->p[j]; p < U->p[j+1] - 1; p++)
+        {
+          double ux = U->x[p];
+          double* xi = x + U->i[p] * nb;
+          for(CS_INT r = 0; r < nb; r++) xi[r] -= ux * xj[r];
+        }
+      }
+      /* scatter the panel with the column permutation: b(q) = x */
+      for(CS_INT k = 0; k < n; k++)
+      {
+        double* xk = x + k * nb;
+        CS_INT dest = S->q ? S->q[k] : k;
+        for(CS_INT r = 0; r < nb; r++) b[(r0 + r) * n + dest] = xk[r];
+      }
+    }
+  }
+  return (ok);
+}
+
+/* Solve A^T x = b with the factorization of A stored in the cs_lu_A:
+ * with A = P L U Q this is x = P' (L' \ (U' \ (Q b))). */
+CS_INT CSparseMatrix_solve_trans(CSparseMatrix_factors* cs_lu_A, double* x, double *b)
+{
+  assert(cs_lu_A);
+
+  CS_INT ok;
+  CS_INT n = cs_lu_A->n;
+  css* S = cs_lu_A->S;
+  csn* N = cs_lu_A->N;
+  ok = (S && N && x) ;
+  if(ok)
+  {
+    cs_pvec(S->q, b, x, n) ;            /* x = b(q) */
+    cs_utsolve(N->U, x) ;               /* x = U'\x */
+    cs_ltsolve(N->L, x) ;               /* x = L'\x */
+    cs_pvec(N->pinv, x, b, n) ;         /* b = x(p) */
+  }
+  return (ok);
+}
+
 /* Solve Ax = B with the factorization of A stored in the cs_lu_A
  * B is a sparse matrix (CSparseMatrix_factors)
  * This is extracted from cs_lusol, you need to synchronize any changes! */
@@ -1088,6 +1271,150 @@ void CSparseMatrix_copy(const CSparseMatrix* const A, CSparseMatrix* B)
   memcpy(B->p, A->p, size_cpy * sizeof(CS_INT));
 }
 
+int CSparseMatrix_transpose_workspace(const CSparseMatrix* const A,
+                                      CSparseMatrix* AT, CS_INT* work)
+{
+  CS_INT p, q, j, n, m, nnz, *Ap, *Ai, *ATp, *ATi;
+  CS_ENTRY *Ax, *ATx;
+
+  if(!CS_CSC(A) || !A->x || !AT || !work) return (-1);  /* check inputs */
+  m = A->m ; n = A->n ; Ap = A->p ; Ai = A->i ; Ax = A->x ;
+  nnz = Ap[n];
+  if(!CS_CSC(AT) || AT->m != n || AT->n != m || AT->nzmax < nnz || !AT->x)
+    return (-1);
+  ATp = AT->p ; ATi = AT->i ; ATx = AT->x ;
+
+  for(j = 0 ; j < m ; j++) work[j] = 0;
+  for(p = 0 ; p < nnz ; p++) work[Ai[p]]++;      /* row counts of A */
+  cs_cumsum(ATp, work, m);                       /* row pointers */
+  for(j = 0 ; j < n ; j++)
+  {
+    for(p = Ap[j] ; p < Ap[j+1] ; p++)
+    {
+      ATi[q = work[Ai[p]]++] = j;                /* place A(i,j) as AT(j,i) */
+      ATx[q] = Ax[p];
+    }
+  }
+  return 0;
+}
+
+CSparseMatrix* CSparseMatrix_symmetrize(const CSparseMatrix* const A)
+{
+  CSparseMatrix *AT, *S;
+
+  if(!CS_CSC(A) || !A->x || A->m != A->n) return NULL;  /* check inputs */
+  AT = cs_transpose(A, 1);
+  if(!AT) return NULL;
+  S = cs_add(A, AT, 0.5, 0.5);
+  cs_spfree(AT);
+  return S;
+}
+
+CS_INT* CSparseMatrix_rcm(const CSparseMatrix* const A)
+{
+  CS_INT n, k, nv, seed, *Bp, *Bi, *deg, *perm, *queue;
+  CSparseMatrix *AT, *B;
+
+  if(!CS_CSC(A) || A->m != A->n) return NULL;          /* check inputs */
+  n = A->n;
+
+  /* work on the symmetrized pattern A + A^T so that an unsymmetric input
+   * still yields an undirected adjacency graph */
+  AT = cs_transpose(A, 0);
+  if(!AT) return NULL;
+  B = cs_add(A, AT, 1.0, 1.0);
+  cs_spfree(AT);
+  if(!B) return NULL;
+  Bp = B->p; Bi = B->i;
+
+  deg = (CS_INT*)cs_malloc(n, sizeof(CS_INT));
+  perm = (CS_INT*)cs_malloc(n, sizeof(CS_INT));
+  queue = (CS_INT*)cs_malloc(n, sizeof(CS_INT));
+  if(!deg || !perm || !queue)
+  {
+    cs_spfree(B);
+    cs_free(deg); cs_free(perm); cs_free(queue);
+    return NULL;
+  }
+
+  for(k = 0; k < n; k++) deg[k] = Bp[k+1] - Bp[k];
+  for(k = 0; k < n; k++) perm[k] = -1;                 /* -1 = not visited */
+
+  /* Cuthill-McKee: breadth-first traversal from a minimum degree seed of
+   * each connected component, visiting the neighbours of each node by
+   * increasing degree */
+  nv = 0;
+  seed = 0;
+  while(nv < n)
+  {
+    CS_INT node, head, tail;
+    /* unvisited node of minimum degree as the component seed */
+    while(perm[seed] >= 0) seed++;
+    node = seed;
+    for(k = seed + 1; k < n; k++)
+      if(perm[k] < 0 && deg[k] < deg[node]) node = k;
+    queue[head = tail = 0] = node;
+    perm[node] = nv++;
+    tail++;
+    while(head < tail)
+    {
+      CS_INT p, first;
+      node = queue[head++];
+      first = tail;
+      for(p = Bp[node]; p < Bp[node+1]; p++)
+      {
+        CS_INT i = Bi[p];
+        if(i != node && perm[i] < 0)
+        {
+          perm[i] = 0;                                 /* mark visited */
+          queue[tail++] = i;
+        }
+      }
+      /* insertion sort of the new level by increasing degree */
+      for(p = first + 1; p < tail; p++)
+      {
+        CS_INT i = queue[p], q = p;
+        while(q > first && deg[queue[q-1]] > deg[i])
+        {
+          queue[q] = queue[q-1];
+          q--;
+        }
+        queue[q] = i;
+      }
+      for(p = first; p < tail; p++) perm[queue[p]] = nv++;
+    }
+  }
+  cs_spfree(B);
+  cs_free(deg);
+
+  /* reverse the Cuthill-McKee order; return it as a permutation vector:
+   * perm[k] = node numbered k in the new ordering */
+  for(k = 0; k < n; k++) queue[n - 1 - perm[k]] = k;
+  cs_free(perm);
+  return queue;
+}
+
+size_t CSparseMatrix_bytes(const CSparseMatrix* A)
+{
+  if(!A) return 0;
+
+  size_t bytes = sizeof(CSparseMatrix);
+  if(A->nz >= 0)
+  {
+    /* triplet: row and column index plus value per entry */
+    bytes += (size_t)A->nzmax * (2 * sizeof(CS_INT) + sizeof(double));
+  }
+  else
+  {
+    /* compressed column (nz == -1) or row (nz == -2): one index and one
+     * value per entry plus the pointer array */
+    CS_INT np = (A->nz == -2 ? A->m : A->n) + 1;
+    bytes += (size_t)A->nzmax * (sizeof(CS_INT) + sizeof(double));
+    bytes += (size_t)np * sizeof(CS_INT);
+  }
+  return bytes;
+}
+
 int CSparseMatrix_max_by_columns(const CSparseMatrix *A, double * max)
 {
   CS_INT p, j, n, *Ap ;
@@ -87,6 +87,10 @@ typedef struct cs_dl_sparse CSparseMatrix;
 typedef struct cs_di_sparse CSparseMatrix;
 #endif
 
+/** number of right-hand-side columns processed per pass by
+ * CSparseMatrix_solve_multi */
+#define CSPARSEMATRIX_NRHS_BLOCK 8
+
 
 /*  we use csparse from Timothy Davis
 
@@ -142,6 +146,26 @@ extern "C"
   */
   int CSparseMatrix_lu_factorization(CS_INT order, const CSparseMatrix *A, double tol, CSparseMatrix_factors * cs_lu_A);
 
+  /** Compute the LU factorization of A, reusing a previously computed
+   *  symbolic analysis. Only the numeric factorization is performed.
+   *
+   * \param A the sparse matrix
+   * \param tol the tolerance
+   * \param S the symbolic analysis of a matrix with the same pattern as A
+   * \param cs_lu_A the parameter structure that eventually holds the factors
+   * \return 1 if the factorization was successful, 1 otherwise
+   */
+  int CSparseMatrix_lu_factorization_reuse_symbolic(const CSparseMatrix *A, double tol, const css* S, CSparseMatrix_factors * cs_lu_A);
+
+  /** Deep copy of the symbolic analysis part needed for an LU
+   *  factorization (column permutation and fill estimates).
+   *
+   * \param S the symbolic analysis to copy
+   * \param n the dimension of the analyzed matrix
+   * \return a newly allocated copy, to be freed with cs_sfree
+   */
+  css* CSparseMatrix_copy_lu_symbolic(const css* S, CS_INT n);
+
   /** compute a Cholesky factorization of A and store it in a workspace
    * 
    *  \param order control if ordering is used
@@ -151,6 +175,38 @@ extern "C"
    */
   int CSparseMatrix_chol_factorization(CS_INT order, const CSparseMatrix *A,  CSparseMatrix_factors * cs_chol_A);
 
+  /** redo the numerical Cholesky factorization of a matrix whose values
+   *  changed but whose sparsity pattern did not (e.g. a diagonal shift):
+   *  the symbolic analysis stored in cs_chol_A (ordering, elimination
+   *  tree, column counts) is reused as is, only the numerical factor is
+   *  recomputed.
+   *
+   *  \param A the sparse matrix, same pattern as when the symbolic
+   *  analysis was done
+   *  \param cs_chol_A holds the symbolic analysis on input, the new
+   *  factors on output
+   *  \return 1 if the factorization was successful, 0 otherwise
+   */
+  int CSparseMatrix_chol_refactorization(const CSparseMatrix *A, CSparseMatrix_factors * cs_chol_A);
+
+  /** rank-one update (sigma = +1) or downdate (sigma = -1) of stored
+   *  Cholesky factors: on success the factors are those of A + sigma w w^T.
+   *  The matrix itself is not touched.
+   *
+   *  The factor pattern cannot change, so the update is only accepted
+   *  when the permuted pattern of w fits in the pattern of the column of
+   *  the factor it starts in; otherwise 0 is returned and the factors
+   *  are left untouched, the caller is expected to fall back on
+   *  CSparseMatrix_chol_refactorization.
+   *
+   *  \param cs_chol_A contains the Cholesky factors of A
+   *  \param sigma +1 for an update, -1 for a downdate
+   *  \param w dense vector of size n, in the original (unpermuted)
+   *  ordering
+   *  \return 1 if the factors were updated, 0 otherwise
+   */
+  CS_INT CSparseMatrix_chol_updown(CSparseMatrix_factors* cs_chol_A, int sigma, const double* w);
+
   /** compute a LDLT factorization of A and store it in a workspace
    * 
    *  \param order control if ordering is used
@@ -168,6 +224,32 @@ extern "C"
    *  \return 0 if failed, 1 otherwise*/
   CS_INT CSparseMatrix_solve(CSparseMatrix_factors* cs_lu_A, double* x, double *b);
 
+  /** reuse a LU factorization (stored in the cs_lu_A) to solve a linear system
+   *  AX = B with several dense right-hand sides.
+   *
+   *  The right-hand sides are processed by blocks of up to
+   *  CSPARSEMATRIX_NRHS_BLOCK columns: the factors are traversed once per
+   *  block and the innermost loops run over the columns of the block, so
+   *  the throughput is much better than nrhs successive calls to
+   *  CSparseMatrix_solve.
+   *
+   *  \param cs_lu_A contains the LU factors of A, permutation information
+   *  \param x workspace of size at least n * min(nrhs, CSPARSEMATRIX_NRHS_BLOCK)
+   *  \param[in,out] b on input the nrhs RHS columns, stored contiguously;
+   *  on output the solutions
+   *  \param nrhs number of right-hand sides
+   *  \return 0 if failed, 1 otherwise*/
+  CS_INT CSparseMatrix_solve_multi(CSparseMatrix_factors* cs_lu_A, double* x, double *b, CS_INT nrhs);
+
+  /** reuse a LU factorization (stored in the cs_lu_A) to solve the transposed
+   *  linear system A^T x = b
+   *
+   *  \param cs_lu_A contains the LU factors of A, permutation information
+   *  \param x workspace
+   *  \param[in,out] b on input RHS of the linear system; on output the solution
+   *  \return 0 if failed, 1 otherwise*/
+  CS_INT CSparseMatrix_solve_trans(CSparseMatrix_factors* cs_lu_A, double* x, double *b);
+
   /** reuse a LU factorization (stored in the cs_lu_A) to solve a linear system Ax = B
    *  with a sparse r.h.s
    *
@@ -321,6 +403,45 @@ extern "C"
    */
   void CSparseMatrix_copy(const CSparseMatrix* const A, CSparseMatrix* B);
 
+  /** Compute the transpose of a csc matrix into caller-provided storage,
+   *  without any allocation. Unlike cs_transpose, the result and the
+   *  workspace can be reused across calls, which avoids the malloc/free
+   *  traffic when the same transpose is refreshed at every iteration.
+   *
+   *  \param[in] A a csc matrix
+   *  \param[in,out] AT a csc matrix with AT->m == A->n, AT->n == A->m and
+   *         AT->nzmax large enough to hold the entries of A
+   *  \param work workspace of size A->m
+   *  \return 0 on success, -1 if the inputs are inconsistent
+   */
+  int CSparseMatrix_transpose_workspace(const CSparseMatrix* const A,
+                                        CSparseMatrix* AT, CS_INT* work);
+
+  /** Compute the symmetric part (A + A^T)/2 of a square csc matrix.
+   *
+   *  \param[in] A a square csc matrix
+   *  \return a newly allocated csc matrix, or NULL on failure
+   */
+  CSparseMatrix* CSparseMatrix_symmetrize(const CSparseMatrix* const A);
+
+  /** Compute a reverse Cuthill-McKee (bandwidth reducing) ordering of a
+   *  square csc matrix, on the symmetrized pattern of A.
+   *
+   *  \param[in] A a square csc matrix
+   *  \return a newly allocated permutation vector of size A->n (perm[k] is
+   *          the original index of the node numbered k in the new
+   *          ordering), or NULL on failure
+   */
+  CS_INT* CSparseMatrix_rcm(const CSparseMatrix* const A);
+
+  /** Number of bytes held by the storage of a matrix (index and value
+   *  arrays plus the struct itself), for the memory accounting API.
+   *
+   *  \param A a CSparseMatrix in triplet, csc or csr form
+   *  \return the storage size in bytes
+   */
+  size_t CSparseMatrix_bytes(const CSparseMatrix* A);
+
   /** Multiply a matrix with a double alpha*A --> A
    * 
    *  \param alpha the  coefficient
@@ -0,0 +1,248 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#include "CSparseMatrix_internal.h" // for CSparseMatrix, CS_INT
+#include "FiniteDifferenceJacobian.h"
+
+#include <assert.h>          // for assert
+#include <float.h>           // for DBL_EPSILON
+#include <math.h>            // for fabs, sqrt
+#include <stdlib.h>          // for malloc, calloc, free
+#include <string.h>          // for memcpy, memset
+
+#include "NumericsMatrix.h"  // for NumericsMatrix, NM_entry, NM_triplet
+#include "numerics_verbose.h" // for numerics_error
+
+/* greedy distance-2 coloring of the columns (Curtis-Powell-Reid):
+   two columns may share a color iff they have no row in common. */
+static void fd_jacobian_color(FiniteDifferenceJacobian* fd)
+{
+  CSparseMatrix* P = fd->pattern;
+  int n = fd->n;
+
+  /* row -> columns structure of the pattern, used only here */
+  CS_INT m = P->m;
+  CS_INT* rp = (CS_INT*)calloc(m + 1, sizeof(CS_INT));
+  CS_INT* rj = (CS_INT*)malloc(P->p[n] * sizeof(CS_INT));
+  for(CS_INT k = 0; k < P->p[n]; ++k)
+    rp[P->i[k] + 1]++;
+  for(CS_INT i = 0; i < m; ++i)
+    rp[i + 1] += rp[i];
+  for(CS_INT j = 0; j < n; ++j)
+    for(CS_INT k = P->p[j]; k < P->p[j + 1]; ++k)
+      rj[rp[P->i[k]]++] = j;
+  for(CS_INT i = m; i > 0; --i)
+    rp[i] = rp[i - 1];
+  rp[0] = 0;
+
+  /* forbidden[c] == j means color c is taken by a neighbour of j */
+  int* forbidden = (int*)malloc(n * sizeof(int));
+  for(int c = 0; c < n; ++c) forbidden[c] = -1;
+
+  fd->nb_colors = 0;
+  for(CS_INT j = 0; j < n; ++j)
+  {
+    for(CS_INT k = P->p[j]; k < P->p[j + 1]; ++k)
+    {
+      CS_INT i = P->i[k];
+      for(CS_INT l = rp[i]; l < rp[i + 1]; ++l)
+      {
+        CS_INT other = rj[l];
+        if(other != j && fd->colors[other] >= 0)
+          forbidden[fd->colors[other]] = (int)j;
+      }
+    }
+    int c = 0;
+    while(forbidden[c] == (int)j) ++c;
+    fd->colors[j] = c;
+    if(c + 1 > fd->nb_colors) fd->nb_colors = c + 1;
+  }
+
+  free(forbidden);
+  free(rj);
+  free(rp);
+}
+
+FiniteDifferenceJacobian* fd_jacobian_new(int n, const CSparseMatrix* pattern,
+                                          fd_jacobian_fn compute_F, void* env)
+{
+  assert(n > 0);
+  assert(compute_F);
+
+  FiniteDifferenceJacobian* fd =
+    (FiniteDifferenceJacobian*)calloc(1, sizeof(FiniteDifferenceJacobian));
+
+  fd->n = n;
+  fd->h = sqrt(DBL_EPSILON);
+  fd->compute_F = compute_F;
+  fd->compute_F_batch = NULL;
+  fd->env = env;
+  fd->colors = (int*)malloc(n * sizeof(int));
+  fd->Fbase = (double*)malloc(n * sizeof(double));
+  fd->steps = (double*)malloc(n * sizeof(double));
+
+  if(pattern)
+  {
+    if(pattern->nz != -1 || pattern->n != n)
+      numerics_error("fd_jacobian_new", "the pattern must be a csc matrix with n columns");
+
+    /* structure-only copy, the values of the pattern are ignored */
+    CSparseMatrix* P = (CSparseMatrix*)calloc(1, sizeof(CSparseMatrix));
+    P->m = pattern->m;
+    P->n = pattern->n;
+    P->nz = -1;
+    P->nzmax = pattern->p[n];
+    P->p = (CS_INT*)malloc((n + 1) * sizeof(CS_INT));
+    P->i = (CS_INT*)malloc(P->nzmax * sizeof(CS_INT));
+    P->x = NULL;
+    memcpy(P->p, pattern->p, (n + 1) * sizeof(CS_INT));
+    memcpy(P->i, pattern->i, P->nzmax * sizeof(CS_INT));
+    fd->pattern = P;
+
+    for(int j = 0; j < n; ++j) fd->colors[j] = -1;
+    fd_jacobian_color(fd);
+  }
+  else
+  {
+    /* dense fallback: every column its own color */
+    fd->pattern = NULL;
+    fd->nb_colors = n;
+    for(int j = 0; j < n; ++j) fd->colors[j] = j;
+  }
+
+  /* one point per call; fd_jacobian_set_batch grows these */
+  fd->points = (double*)malloc(n * sizeof(double));
+  fd->values = (double*)malloc(n * sizeof(double));
+
+  return fd;
+}
+
+void fd_jacobian_set_batch(FiniteDifferenceJacobian* fd,
+                           fd_jacobian_batch_fn compute_F_batch)
+{
+  fd->compute_F_batch = compute_F_batch;
+  if(compute_F_batch)
+  {
+    /* all the colors are submitted in one call */
+    fd->points = (double*)realloc(fd->points,
+                                  (size_t)fd->nb_colors * fd->n * sizeof(double));
+    fd->values = (double*)realloc(fd->values,
+                                  (size_t)fd->nb_colors * fd->n * sizeof(double));
+  }
+}
+
+/* write the columns of one color from the perturbed evaluation Fp */
+static void fd_jacobian_scatter(FiniteDifferenceJacobian* fd, int color,
+                                const double* Fp, NumericsMatrix* jacF)
+{
+  int n = fd->n;
+  if(fd->pattern)
+  {
+    CSparseMatrix* P = fd->pattern;
+    for(CS_INT j = 0; j < n; ++j)
+    {
+      if(fd->colors[j] != color) continue;
+      for(CS_INT k = P->p[j]; k < P->p[j + 1]; ++k)
+      {
+        CS_INT i = P->i[k];
+        NM_entry(jacF, (int)i, (int)j, (Fp[i] - fd->Fbase[i]) / fd->steps[j]);
+      }
+    }
+  }
+  else
+  {
+    int j = color;  /* dense: color c holds column c only */
+    for(int i = 0; i < n; ++i)
+      NM_entry(jacF, i, j, (Fp[i] - fd->Fbase[i]) / fd->steps[j]);
+  }
+}
+
+void fd_jacobian_compute(FiniteDifferenceJacobian* fd, double* z,
+                         NumericsMatrix* jacF)
+{
+  int n = fd->n;
+
+  assert(jacF->size0 == n && jacF->size1 == n);
+
+  fd->compute_F(fd->env, n, z, fd->Fbase);
+
+  for(int j = 0; j < n; ++j)
+    fd->steps[j] = fd->h * (1.0 + fabs(z[j]));
+
+  /* only the entries of the pattern are written below */
+  if(jacF->storageType == NM_DENSE)
+    memset(jacF->matrix0, 0, (size_t)n * n * sizeof(double));
+  else if(jacF->storageType == NM_SPARSE)
+  {
+    /* Reset the triplet in place and drop the derived storages; a full
+       NM_clearSparseStorage would leave the origin unknown, which
+       NM_triplet cannot rebuild from. */
+    if(!numericsSparseMatrix(jacF)->triplet)
+      NM_triplet_alloc(jacF, 0);
+    else
+      NM_triplet(jacF)->nz = 0;
+    numericsSparseMatrix(jacF)->origin = NSM_TRIPLET;
+    NM_clearHalfTriplet(jacF);
+    NM_clearCSC(jacF);
+    NM_clearCSCTranspose(jacF);
+    NM_clearCSR(jacF);
+  }
+
+  if(fd->compute_F_batch)
+  {
+    for(int c = 0; c < fd->nb_colors; ++c)
+      memcpy(fd->points + (size_t)c * n, z, n * sizeof(double));
+    for(int j = 0; j < n; ++j)
+      fd->points[(size_t)fd->colors[j] * n + j] += fd->steps[j];
+
+    fd->compute_F_batch(fd->env, n, fd->nb_colors, fd->points, fd->values);
+
+    for(int c = 0; c < fd->nb_colors; ++c)
+      fd_jacobian_scatter(fd, c, fd->values + (size_t)c * n, jacF);
+  }
+  else
+  {
+    for(int c = 0; c < fd->nb_colors; ++c)
+    {
+      memcpy(fd->points, z, n * sizeof(double));
+      for(int j = 0; j < n; ++j)
+        if(fd->colors[j] == c) fd->points[j] += fd->steps[j];
+
+      fd->compute_F(fd->env, n, fd->points, fd->values);
+
+      fd_jacobian_scatter(fd, c, fd->values, jacF);
+    }
+  }
+}
+
+void fd_jacobian_free(FiniteDifferenceJacobian* fd)
+{
+  if(!fd) return;
+  if(fd->pattern)
+  {
+    free(fd->pattern->p);
+    free(fd->pattern->i);
+    free(fd->pattern);
+  }
+  free(fd->colors);
+  free(fd->Fbase);
+  free(fd->steps);
+  free(fd->points);
+  free(fd->values);
+  free(fd);
+}
@@ -0,0 +1,129 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef FiniteDifferenceJacobian_h
+#define FiniteDifferenceJacobian_h
+
+/*!\file FiniteDifferenceJacobian.h
+ * \brief colored finite-difference approximation of sparse Jacobians
+ *
+ * A naive forward-difference Jacobian costs n evaluations of F. When
+ * the sparsity pattern of the Jacobian is known, columns that share no
+ * row are structurally orthogonal and can be perturbed together
+ * (Curtis-Powell-Reid): a greedy distance-2 coloring of the columns
+ * reduces the cost to one evaluation per color, typically a small
+ * constant for banded or locally-coupled problems. The coloring, the
+ * compressed pattern and the workspaces are computed once and reused
+ * across Newton iterations.
+ *
+ * The evaluation callback has the signature of the NCP/MCP user
+ * functions (ptrFunctionNCP / ptrFunctionMCP2), so the natural use is
+ * to keep a FiniteDifferenceJacobian handle in the problem env and
+ * call fd_jacobian_compute() from compute_nabla_F / compute_nabla_Fmcp:
+ *
+ *   struct my_env { FiniteDifferenceJacobian* fd; ... };
+ *   void my_nabla(void* env, int n, double* z, NumericsMatrix* nabla)
+ *   {
+ *     fd_jacobian_compute(((struct my_env*)env)->fd, z, nabla);
+ *   }
+ */
+
+#include "CSparseMatrix.h" // for CSparseMatrix
+#include "NumericsFwd.h"   // for NumericsMatrix
+#include "SiconosConfig.h" // for BUILD_AS_CPP // IWYU pragma: keep
+
+/** evaluation of F at one point, same signature as the NCP/MCP user
+    callbacks */
+typedef void (*fd_jacobian_fn)(void *env, int n, double *z, double *F);
+
+/** batched evaluation: z and F hold npoints contiguous vectors of size
+    n each; one call replaces npoints calls of the plain callback, so a
+    vectorized or offloaded user function amortizes its entry cost */
+typedef void (*fd_jacobian_batch_fn)(void *env, int n, int npoints,
+                                     double *z, double *F);
+
+typedef struct FiniteDifferenceJacobian
+{
+  int n;                   /**< problem size */
+  int nb_colors;           /**< number of column groups (n when dense) */
+  int *colors;             /**< column j is perturbed in group colors[j] */
+  CSparseMatrix *pattern;  /**< csc sparsity pattern, owned copy; NULL
+                              means dense (every column its own color) */
+  double h;                /**< base step; the step of column j is
+                              h*(1+|z_j|) */
+  fd_jacobian_fn compute_F;            /**< evaluation of F, mandatory */
+  fd_jacobian_batch_fn compute_F_batch;/**< optional batched evaluation,
+                                          used instead of compute_F for
+                                          the perturbed points */
+  void *env;               /**< user env forwarded to the callbacks */
+  double *Fbase;           /**< workspace: F at the current point */
+  double *steps;           /**< workspace: per-column step */
+  double *points;          /**< workspace: perturbed point(s) */
+  double *values;          /**< workspace: F at the perturbed point(s) */
+} FiniteDifferenceJacobian;
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** create a colored finite-difference Jacobian evaluator.
+   *
+   *  \param n size of the problem
+   *  \param pattern sparsity pattern of the Jacobian as a csc matrix
+   *  (only the structure is read, the values may be anything); the
+   *  pattern is copied. NULL for a dense Jacobian: the evaluator then
+   *  falls back to one evaluation per column.
+   *  \param compute_F evaluation callback
+   *  \param env user env forwarded to the callbacks
+   *  \return the evaluator, to be released with fd_jacobian_free()
+   */
+  FiniteDifferenceJacobian *fd_jacobian_new(int n, const CSparseMatrix *pattern,
+                                            fd_jacobian_fn compute_F, void *env);
+
+  /** register a batched evaluation callback: all the perturbed points
+   *  of one Jacobian computation are then submitted in a single call.
+   *
+   *  \param fd the evaluator
+   *  \param compute_F_batch batched callback, NULL to unregister
+   */
+  void fd_jacobian_set_batch(FiniteDifferenceJacobian *fd,
+                             fd_jacobian_batch_fn compute_F_batch);
+
+  /** approximate the Jacobian of F at z by forward differences, one
+   *  evaluation of F per color. Only the entries of the pattern are
+   *  written; for a dense output the matrix is zeroed first, for a
+   *  sparse output the storage is reset and refilled.
+   *
+   *  \param fd the evaluator
+   *  \param z the current point, size n
+   *  \param jacF output matrix, n x n, dense or sparse storage
+   */
+  void fd_jacobian_compute(FiniteDifferenceJacobian *fd, double *z,
+                           NumericsMatrix *jacF);
+
+  /** release an evaluator and its workspaces
+   *
+   *  \param fd the evaluator
+   */
+  void fd_jacobian_free(FiniteDifferenceJacobian *fd);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
@@ -117,33 +117,51 @@ NumericsMatrix* Quad_repr(const double* const vec, const unsigned int vecSize, c
 }
 
 
+/* Quadratic representation applied to a vector, one cone at a time:
+ * Q_x y = 2 (x.y) x - det(x) R y, with R the reflection matrix. This is
+ * the closed form of Quad_repr(x) * y without assembling the matrix. */
+static inline void quad_prod_store(const double * const x, const double * const y,
+                                   const unsigned int dimension, double * out)
+{
+  double xy = cblas_ddot(dimension, x, 1, y, 1);
+  double det = x[0] * x[0] - cblas_ddot(dimension - 1, x + 1, 1, x + 1, 1);
+  out[0] = 2. * xy * x[0] - det * y[0];
+  for(unsigned int j = 1; j < dimension; ++j)
+    out[j] = 2. * xy * x[j] + det * y[j];
+}
+
 void NesterovToddVector(const double* const vec1, const double* const vec2,
                         const unsigned int vecSize, const size_t varsCount, double * out)
 {
   DEBUG_BEGIN("NesterovToddVector(...)\n");
-  NumericsMatrix* quad_repr;
-  double * x05 = (double*)calloc(vecSize, sizeof(double));
-  double * Qx05y = (double*)calloc(vecSize, sizeof(double));
-  double * Qx05yi = (double*)calloc(vecSize, sizeof(double));
-  double * _p = (double*)calloc(vecSize, sizeof(double));
+  /* p = (Q_{x^{1/2}} (Q_{x^{1/2}} y)^{-1/2})^{-1/2}, cone by cone. Each
+   * step is a closed-form spectral map or quadratic product, so only
+   * three cone-sized temporaries are needed; the typical dimensions (3
+   * for friction, a few more for rolling) live on the stack. */
+  unsigned int dimension = (int)(vecSize / varsCount);
+  double buf[3 * 32];
+  double * tmp = (3 * dimension <= (unsigned int)(sizeof(buf) / sizeof(double))) ?
+                 buf : (double*)malloc(3 * dimension * sizeof(double));
+  double * x05 = tmp;
+  double * q = tmp + dimension;
+  double * qi = tmp + 2 * dimension;
 
   assert(!NV_isnan(vec1,vecSize));
   assert(!NV_isnan(vec2,vecSize));
 
-  JA_sqrt(vec1, vecSize, varsCount, x05);
-  quad_repr = Quad_repr(x05, vecSize, varsCount);
-  NM_gemv(1.0, quad_repr, vec2, 0.0, Qx05y);
-  JA_sqrt_inv(Qx05y, vecSize, varsCount, Qx05yi);
-  NM_gemv(1.0, quad_repr, Qx05yi, 0.0, _p);
-  JA_sqrt_inv(_p, vecSize, varsCount, out);
+  for(size_t i = 0; i < varsCount; ++i)
+  {
+    size_t pos = i * dimension;
+    JA_sqrt(vec1 + pos, dimension, 1, x05);
+    quad_prod_store(x05, vec2 + pos, dimension, q);
+    JA_sqrt_inv(q, dimension, 1, qi);
+    quad_prod_store(x05, qi, dimension, q);
+    JA_sqrt_inv(q, dimension, 1, out + pos);
+  }
 
   assert(!NV_isnan(out,vecSize));
 
-
-  free(_p);
-  free(Qx05yi);
-  free(Qx05y);
-  free(x05);
+  if(tmp != buf) free(tmp);
   DEBUG_END("NesterovToddVector(...)\n");
 }
 
@@ -229,146 +247,84 @@ void JA_eigenvecs(const double * const vec, const unsigned int vecSize, const si
   }
 }
 
+/* Closed-form spectral map f(x) = f(lambda_1) u_1 + f(lambda_2) u_2 of
+ * one cone element x = (x0, x_bar), written directly into out:
+ *
+ *   out0    = (f(lambda_1) + f(lambda_2)) / 2
+ *   out_bar = (f(lambda_1) - f(lambda_2)) / (2 |x_bar| + EPS) * x_bar
+ *
+ * with lambda_{1,2} = x0 +- |x_bar| and the same EPS regularization of
+ * the eigenvectors as JA_eigenvecs. f1 (resp. f2) is f(lambda_1) (resp.
+ * f(lambda_2)). Keeping the whole map in one loop body lets the
+ * compiler vectorize over the cones and avoids any temporary. */
+static inline void spectral_map_store(const double * const x, const unsigned int dimension,
+                                      const double f1, const double f2, double * out)
+{
+  const double EPS = 1e-12;
+  double xi_bar_norm = NV_norm_2(x + 1, dimension - 1);
+  double coeff = (f1 - f2) / (2. * xi_bar_norm + EPS);
+  out[0] = 0.5 * (f1 + f2);
+  for(unsigned int j = 1; j < dimension; ++j)
+    out[j] = coeff * x[j];
+}
+
 void JA_sqrt(const double * const vec, const unsigned int vecSize, const size_t varsCount, double * out)
 {
-  unsigned int pos;
   unsigned int dimension = (int)(vecSize / varsCount);
-  double * eigenvals = (double*)malloc(2 * varsCount * sizeof(double));
-  double ** eigenvecs = (double**)malloc(2 * varsCount * sizeof(double*));
-  for(unsigned int i = 0; i < 2 * varsCount; ++i)
-    eigenvecs[i] = (double*)calloc(dimension, sizeof(double));
-
-  double *tmp_vec1 = (double*)malloc(dimension * sizeof(double));
-  double *tmp_vec2 = (double*)malloc(dimension * sizeof(double));
-  double sqrt_eigenval1, sqrt_eigenval2;
-
-  JA_eigenvals(vec, vecSize, varsCount, eigenvals);
-  JA_eigenvecs(vec, vecSize, varsCount, eigenvecs);
-
-  for(size_t i = 0; i < 2 * varsCount; i += 2)
+  for(size_t i = 0; i < varsCount; ++i)
   {
-    assert(eigenvals[i] >=0);
-    assert(eigenvals[i+1] >=0);
-    sqrt_eigenval1 = sqrt(eigenvals[i]);
-    sqrt_eigenval2 = sqrt(eigenvals[i + 1]);
-    pos = (i / 2) * dimension;
-    NV_const_add(eigenvecs[i], dimension, sqrt_eigenval1, 0, tmp_vec1);
-    NV_const_add(eigenvecs[i + 1], dimension, sqrt_eigenval2, 0, tmp_vec2);
-    NV_add(tmp_vec1, tmp_vec2, dimension, out + pos);
+    const double * x = vec + i * dimension;
+    double xi_bar_norm = NV_norm_2(x + 1, dimension - 1);
+    assert(x[0] + xi_bar_norm >= 0);
+    assert(x[0] - xi_bar_norm >= 0);
+    spectral_map_store(x, dimension,
+                       sqrt(x[0] + xi_bar_norm), sqrt(x[0] - xi_bar_norm),
+                       out + i * dimension);
   }
-
-  free(eigenvals);
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    free(eigenvecs[i]);
-  free(eigenvecs);
-  free(tmp_vec1);
-  free(tmp_vec2);
 }
 
 
 void JA_sqrt_inv(const double * const vec, const unsigned int vecSize, const size_t varsCount, double * out)
 {
-  unsigned int pos;
   unsigned int dimension = (int)(vecSize / varsCount);
-  double * eigenvals = (double*)malloc(2 * varsCount * sizeof(double));
-  double ** eigenvecs = (double**)malloc(2 * varsCount * sizeof(double*));
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    eigenvecs[i] = (double*)calloc(dimension, sizeof(double));
-
-  double *tmp_vec1 = (double*)malloc(dimension * sizeof(double));
-  double *tmp_vec2 = (double*)malloc(dimension * sizeof(double));
-  double sqrt_eigenval1, sqrt_eigenval2;
-
-  JA_eigenvals(vec, vecSize, varsCount, eigenvals);
-  JA_eigenvecs(vec, vecSize, varsCount, eigenvecs);
-
-  for(size_t i = 0; i < 2 * varsCount; i += 2)
+  for(size_t i = 0; i < varsCount; ++i)
   {
-    //printf("eigenvals[i] = %e \t, eigenvals[i+1] = %e\n ", eigenvals[i], eigenvals[i + 1]);
-    assert(eigenvals[i]>0);
-    assert(eigenvals[i+1]>0);
-    sqrt_eigenval1 = 1. / sqrt(eigenvals[i]);
-    sqrt_eigenval2 = 1. / sqrt(eigenvals[i + 1]);
-    pos = (i / 2) * dimension;
-    NV_const_add(eigenvecs[i], dimension, sqrt_eigenval1, 0, tmp_vec1);
-    NV_const_add(eigenvecs[i + 1], dimension, sqrt_eigenval2, 0, tmp_vec2);
-    NV_add(tmp_vec1, tmp_vec2, dimension, out + pos);
+    const double * x = vec + i * dimension;
+    double xi_bar_norm = NV_norm_2(x + 1, dimension - 1);
+    assert(x[0] + xi_bar_norm > 0);
+    assert(x[0] - xi_bar_norm > 0);
+    spectral_map_store(x, dimension,
+                       1. / sqrt(x[0] + xi_bar_norm), 1. / sqrt(x[0] - xi_bar_norm),
+                       out + i * dimension);
   }
-
-  free(eigenvals);
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    free(eigenvecs[i]);
-  free(eigenvecs);
-  free(tmp_vec1);
-  free(tmp_vec2);
 }
 
 void JA_power2(const double * const vec, const unsigned int vecSize, const size_t varsCount, double * out)
 {
-  unsigned int pos;
   unsigned int dimension = (int)(vecSize / varsCount);
-  double * eigenvals = (double*)malloc(2 * varsCount * sizeof(double));
-  double ** eigenvecs = (double**)malloc(2 * varsCount * sizeof(double*));
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    eigenvecs[i] = (double*)calloc(dimension, sizeof(double));
-
-  double *tmp_vec1 = (double*)malloc(dimension * sizeof(double));
-  double *tmp_vec2 = (double*)malloc(dimension * sizeof(double));
-  double sqrt_eigenval1, sqrt_eigenval2;
-
-  JA_eigenvals(vec, vecSize, varsCount, eigenvals);
-  JA_eigenvecs(vec, vecSize, varsCount, eigenvecs);
-
-  for(size_t i = 0; i < 2 * varsCount; i += 2)
+  for(size_t i = 0; i < varsCount; ++i)
   {
-    sqrt_eigenval1 = eigenvals[i] * eigenvals[i];
-    sqrt_eigenval2 = eigenvals[i + 1] * eigenvals[i + 1];
-    pos = (i / 2) * dimension;
-    NV_const_add(eigenvecs[i], dimension, sqrt_eigenval1, 0, tmp_vec1);
-    NV_const_add(eigenvecs[i + 1], dimension, sqrt_eigenval2, 0, tmp_vec2);
-    NV_add(tmp_vec1, tmp_vec2, dimension, out + pos);
+    const double * x = vec + i * dimension;
+    double xi_bar_norm = NV_norm_2(x + 1, dimension - 1);
+    double eigenval1 = x[0] + xi_bar_norm;
+    double eigenval2 = x[0] - xi_bar_norm;
+    spectral_map_store(x, dimension,
+                       eigenval1 * eigenval1, eigenval2 * eigenval2,
+                       out + i * dimension);
   }
-
-  free(eigenvals);
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    free(eigenvecs[i]);
-  free(eigenvecs);
-  free(tmp_vec1);
-  free(tmp_vec2);
 }
 
 void JA_inv(const double * const vec, const unsigned int vecSize, const size_t varsCount, double * out)
 {
-  unsigned int pos;
   unsigned int dimension = (int)(vecSize / varsCount);
-  double * eigenvals = (double*)malloc(2 * varsCount * sizeof(double));
-  double ** eigenvecs = (double**)malloc(2 * varsCount * sizeof(double*));
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    eigenvecs[i] = (double*)calloc(dimension, sizeof(double));
-
-  double *tmp_vec1 = (double*)malloc(dimension * sizeof(double));
-  double *tmp_vec2 = (double*)malloc(dimension * sizeof(double));
-  double sqrt_eigenval1, sqrt_eigenval2;
-
-  JA_eigenvals(vec, vecSize, varsCount, eigenvals);
-  JA_eigenvecs(vec, vecSize, varsCount, eigenvecs);
-
-  for(size_t i = 0; i < 2 * varsCount; i += 2)
+  for(size_t i = 0; i < varsCount; ++i)
   {
-    sqrt_eigenval1 = 1. / eigenvals[i];
-    sqrt_eigenval2 = 1. / eigenvals[i + 1];
-    pos = (i / 2) * dimension;
-    NV_const_add(eigenvecs[i], dimension, sqrt_eigenval1, 0, tmp_vec1);
-    NV_const_add(eigenvecs[i + 1], dimension, sqrt_eigenval2, 0, tmp_vec2);
-    NV_add(tmp_vec1, tmp_vec2, dimension, out + pos);
+    const double * x = vec + i * dimension;
+    double xi_bar_norm = NV_norm_2(x + 1, dimension - 1);
+    spectral_map_store(x, dimension,
+                       1. / (x[0] + xi_bar_norm), 1. / (x[0] - xi_bar_norm),
+                       out + i * dimension);
   }
-
-  free(eigenvals);
-  for(size_t i = 0; i < 2 * varsCount; ++i)
-    free(eigenvecs[i]);
-  free(eigenvecs);
-  free(tmp_vec1);
-  free(tmp_vec2);
 }
 
 void JA_det(const double * const vec, const unsigned int vecSize, const size_t varsCount, double * out)
@@ -18,6 +18,7 @@
 
 #include "NM_MUMPS.h"
 #ifdef WITH_MUMPS
+#include <assert.h> // for assert
 #include <string.h> // for memcpy
 #include "CSparseMatrix_internal.h"
 #include "NumericsMatrix_internal.h"
@@ -29,6 +30,75 @@
 /*#define DEBUG_MESSAGES*/
 #include "siconos_debug.h"
 
+#if !defined(_WIN32) && !defined(SICONOS_HAS_MPI)
+/* the asynchronous factorization needs a worker thread; with MPI the
+ * job broadcast protocol of NM_MUMPS is not thread safe, so the async
+ * entry points silently fall back to synchronous calls */
+#define NM_MUMPS_HAS_ASYNC 1
+#include <pthread.h>
+#endif
+
+/* A small per-process pool of initialized MUMPS instances.  Instead of
+ * dropping the instance of a destroyed matrix (and with it the MUMPS
+ * setup and the symbolic analysis), NM_MUMPS_free parks it here and
+ * NM_MUMPS_acquire_pooled_id hands it back to the next matrix with the
+ * same structure.  The structure key (symmetry, dimension, number of
+ * nonzeros) is the same heuristic as the in-matrix analysis reuse of
+ * NM_LU_factorize: it assumes the triplet entries of the new matrix are
+ * produced in the same order, which holds when the matrices are rebuilt
+ * the same way on every step. */
+#define NM_MUMPS_INSTANCE_POOL_SIZE 4
+static DMUMPS_STRUC_C* NM_MUMPS_instance_pool[NM_MUMPS_INSTANCE_POOL_SIZE] = {NULL};
+static int NM_MUMPS_instance_pooling = 0;
+
+void NM_MUMPS_set_instance_pooling(int enabled)
+{
+  if(!enabled)
+  {
+    for(int i = 0; i < NM_MUMPS_INSTANCE_POOL_SIZE; i++)
+    {
+      if(NM_MUMPS_instance_pool[i])
+      {
+#ifndef SICONOS_HAS_MPI
+        NM_MUMPS_instance_pool[i]->job = -2;
+        dmumps_c(NM_MUMPS_instance_pool[i]);
+#endif
+        free(NM_MUMPS_instance_pool[i]);
+        NM_MUMPS_instance_pool[i] = NULL;
+      }
+    }
+  }
+  NM_MUMPS_instance_pooling = enabled;
+}
+
+int NM_MUMPS_acquire_pooled_id(NumericsMatrix* A)
+{
+  DMUMPS_STRUC_C* mumps_id = NM_MUMPS_id(A);
+  CSparseMatrix* triplet;
+  if(mumps_id->sym)
+  {
+    triplet = NM_half_triplet(A);
+  }
+  else
+  {
+    triplet = NM_triplet(A);
+  }
+  for(int i = 0; i < NM_MUMPS_INSTANCE_POOL_SIZE; i++)
+  {
+    DMUMPS_STRUC_C* pooled = NM_MUMPS_instance_pool[i];
+    if(pooled && pooled->sym == mumps_id->sym
+        && pooled->n == (MUMPS_INT)triplet->n
+        && pooled->nz == (MUMPS_INT)triplet->nz)
+    {
+      NM_MUMPS_instance_pool[i] = NULL;
+      free(mumps_id); /* the freshly allocated, uninitialized instance */
+      NM_MUMPS_set_id(A, pooled);
+      return 1;
+    }
+  }
+  return 0;
+}
+
 void NM_MUMPS_free(void* p)
 {
   NSM_linear_solver_params* params = (NSM_linear_solver_params*) p;
@@ -44,6 +114,20 @@ void NM_MUMPS_free(void* p)
     mumps_id->irhs_sparse = NULL;
     mumps_id->rhs = NULL;
   }
+  if(NM_MUMPS_instance_pooling && mumps_id->job > 0)
+  {
+    /* the instance holds a usable setup and analysis: park it for the
+     * next matrix with the same structure */
+    for(int i = 0; i < NM_MUMPS_INSTANCE_POOL_SIZE; i++)
+    {
+      if(!NM_MUMPS_instance_pool[i])
+      {
+        NM_MUMPS_instance_pool[i] = mumps_id;
+        params->linear_solver_data = NULL;
+        return;
+      }
+    }
+  }
   free(params->linear_solver_data);
   params->linear_solver_data = NULL;
 }
@@ -334,6 +418,50 @@ void NM_MUMPS_set_sym(NumericsMatrix* A, int sym)
 {
   NM_MUMPS_id(A)->sym = sym;
 }
+
+#ifdef NM_MUMPS_HAS_ASYNC
+/* at most one asynchronous factorization is outstanding at a time */
+static pthread_t NM_MUMPS_async_thread;
+static NumericsMatrix* NM_MUMPS_async_matrix = NULL;
+
+static void* NM_MUMPS_async_worker(void* arg)
+{
+  NM_MUMPS((NumericsMatrix*) arg, 2); /* factorization, reusing the analysis */
+  return NULL;
+}
+#endif
+
+void NM_MUMPS_factorize_async(NumericsMatrix* A)
+{
+  /* the analysis must already be inside the instance (at least one
+   * synchronous factorization has been performed) */
+  assert(NM_MUMPS_id(A)->job >= 2);
+
+  NM_MUMPS_set_matrix(A);
+#ifdef NM_MUMPS_HAS_ASYNC
+  if(!NM_MUMPS_async_matrix
+      && pthread_create(&NM_MUMPS_async_thread, NULL,
+                        &NM_MUMPS_async_worker, A) == 0)
+  {
+    NM_MUMPS_async_matrix = A;
+    return;
+  }
+#endif
+  /* no thread support, MPI, or a worker already busy: factorize now */
+  NM_MUMPS(A, 2);
+}
+
+int NM_MUMPS_factorize_async_wait(NumericsMatrix* A)
+{
+#ifdef NM_MUMPS_HAS_ASYNC
+  if(NM_MUMPS_async_matrix == A)
+  {
+    pthread_join(NM_MUMPS_async_thread, NULL);
+    NM_MUMPS_async_matrix = NULL;
+  }
+#endif
+  return NM_MUMPS_id(A)->info[0];
+}
 #endif
 
 void NM_MUMPS_copy(const NumericsMatrix* A, NumericsMatrix* B)
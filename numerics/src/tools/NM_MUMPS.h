@@ -168,6 +168,46 @@ extern "C"
    */
   void NM_MUMPS_free(void* p);
 
+  /** Enable or disable the pooling of MUMPS instances.  With pooling
+   *  enabled, NM_MUMPS_free keeps the instance of a destroyed matrix
+   *  alive (with its setup and symbolic analysis) so that the next
+   *  matrix with the same structure can reuse it and go straight to the
+   *  numerical factorization.  Disabling the pooling drains the pool.
+   *
+   *  \param enabled 0 to disable, anything else to enable.
+   */
+  void NM_MUMPS_set_instance_pooling(int enabled);
+
+  /** Try to recycle a pooled MUMPS instance whose structure (symmetry,
+   *  dimension, number of nonzeros) matches the matrix.  The triplet
+   *  entries of the matrix must be produced in the same order as those
+   *  of the matrix the instance comes from.
+   *
+   *  \param A the matrix in need of a MUMPS instance
+   *  \return 1 if a pooled instance has been installed on A (its
+   *  analysis is directly reusable), 0 otherwise.
+   */
+  int NM_MUMPS_acquire_pooled_id(NumericsMatrix* A);
+
+  /** Start the numerical factorization of A on a worker thread and
+   *  return immediately, so that the factorization of a predictable
+   *  next-step matrix overlaps with the current computation.  The
+   *  matrix must have been factorized at least once (the analysis is
+   *  reused) and only its numerical values may have changed; the values
+   *  must not be modified until NM_MUMPS_factorize_async_wait.  Without
+   *  thread support, or with MPI (the job broadcast protocol is not
+   *  thread safe), the factorization is done synchronously.
+   *
+   *  \param A the matrix to factorize
+   */
+  void NM_MUMPS_factorize_async(NumericsMatrix* A);
+
+  /** Wait for the completion of NM_MUMPS_factorize_async.
+   *
+   *  \param A the matrix being factorized
+   *  \return the MUMPS info(1) of the factorization, 0 if ok.
+   */
+  int NM_MUMPS_factorize_async_wait(NumericsMatrix* A);
 
 #endif /* WITH_MUMPS */
   /** copy MUMPS id if compiled WITH_MUMPS, otherwise do nothing.
@@ -37,6 +37,85 @@ typedef double (*linesearch_fptr)(int n, double theta, double preRHS, search_dat
 
 const char* const SICONOS_NEWTON_LSA_STR  = "Newton method LSA";
 
+broyden_updates* broyden_updates_new(unsigned int n, unsigned int max_age)
+{
+  broyden_updates* qn = (broyden_updates*)calloc(1, sizeof(broyden_updates));
+  qn->n = n;
+  qn->max_age = max_age;
+  qn->s = (double*)malloc(max_age * (size_t)n * sizeof(double));
+  qn->w = (double*)malloc(max_age * (size_t)n * sizeof(double));
+  qn->denom = (double*)malloc(max_age * sizeof(double));
+  qn->z_prev = (double*)malloc(n * sizeof(double));
+  qn->F_prev = (double*)malloc(n * sizeof(double));
+  qn->tmp = (double*)malloc(n * sizeof(double));
+  qn->tau = 1.0;
+  return qn;
+}
+
+void broyden_updates_reset(broyden_updates* qn)
+{
+  qn->nb_updates = 0;
+}
+
+void broyden_updates_free(broyden_updates* qn)
+{
+  if(!qn) return;
+  free(qn->s);
+  free(qn->w);
+  free(qn->denom);
+  free(qn->z_prev);
+  free(qn->F_prev);
+  free(qn->tmp);
+  free(qn);
+}
+
+void broyden_updates_record(broyden_updates* qn, const double* z, const double* F)
+{
+  cblas_dcopy((int)qn->n, z, 1, qn->z_prev, 1);
+  cblas_dcopy((int)qn->n, F, 1, qn->F_prev, 1);
+}
+
+void broyden_updates_apply(const broyden_updates* qn, double* x)
+{
+  int n = (int)qn->n;
+  for(unsigned int j = 0; j < qn->nb_updates; ++j)
+  {
+    const double* s = &qn->s[j * qn->n];
+    const double* w = &qn->w[j * qn->n];
+    cblas_daxpy(n, -cblas_ddot(n, s, 1, x, 1) / qn->denom[j], w, 1, x, 1);
+  }
+}
+
+int broyden_updates_add(broyden_updates* qn, NumericsMatrix* H,
+                        const double* z, const double* F)
+{
+  if(qn->nb_updates >= qn->max_age) return 1;
+
+  int n = (int)qn->n;
+  double* s = &qn->s[qn->nb_updates * qn->n];
+  double* w = &qn->w[qn->nb_updates * qn->n];
+
+  /* secant pair: s = z - z_prev, u = y - B s = F - (1 - tau) F_prev */
+  cblas_dcopy(n, z, 1, s, 1);
+  cblas_daxpy(n, -1.0, qn->z_prev, 1, s, 1);
+  double sts = cblas_ddot(n, s, 1, s, 1);
+  if(!(sts > 0.)) return 1;
+
+  cblas_dcopy(n, F, 1, w, 1);
+  cblas_daxpy(n, -(1.0 - qn->tau), qn->F_prev, 1, w, 1);
+
+  /* w = B^{-1} u with the current corrected operator */
+  if(NM_LU_solve(NM_preserve(H), w, 1)) return 1;
+  broyden_updates_apply(qn, w);
+
+  double denom = sts + cblas_ddot(n, s, 1, w, 1);
+  if(fabs(denom) < 1e-12 * sts) return 1;
+
+  qn->denom[qn->nb_updates] = denom;
+  ++qn->nb_updates;
+  return 0;
+}
+
 
 
 void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverOptions* options, functions_LSA* functions)
@@ -81,15 +160,16 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
   // Maybe there is a better way to initialize
 //  for (unsigned int i = 0; i < n; i++) z[i] = 0.0;
 
-  // if we keep the work space across calls
-  if(options->iparam[SICONOS_IPARAM_PREALLOC] && (options->dWork == NULL))
-  {
-    options->dWork = (double *)calloc(4*n, sizeof(double));
-    options->iWork = (int *)calloc(n, sizeof(int));
-  }
+  assert(options->solverData);
+  newton_LSA_param* params = (newton_LSA_param*)options->solverParameters;
+  newton_LSA_data* sd = (newton_LSA_data*)options->solverData;
+  NumericsMatrix* H = sd->H;
+  assert(params);
+  assert(H);
 
   if(options->dWork)
   {
+    /* caller-provided workspace */
     F_merit = options->dWork;
     workV1 = F_merit + n;
     workV2 = workV1 + n;
@@ -97,24 +177,52 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
   }
   else
   {
-    F_merit = (double *)calloc(n,  sizeof(double));
-    JacThetaF_merit = (double *)calloc(n, sizeof(double));
-    workV1 = (double *)calloc(n, sizeof(double));
-    workV2 = (double *)calloc(n, sizeof(double));
+    /* vector temporaries live in the solver workspace: sized on first
+     * use and then reused, so with SICONOS_IPARAM_PREALLOC repeated
+     * calls on a same-size problem do not allocate at all */
+    if(sd->n < n)
+    {
+      free(sd->dwork);
+      sd->dwork = (double *)calloc(4 * (size_t)n, sizeof(double));
+      sd->n = n;
+    }
+    F_merit = sd->dwork;
+    workV1 = F_merit + n;
+    workV2 = workV1 + n;
+    JacThetaF_merit = workV2 + n;
   }
 
+  /* quasi-Newton mode: keep H and its factors for several iterations,
+   * correcting the solves with Broyden rank-1 updates; only meaningful
+   * on the plain compute_H path, where newton_LSA owns the solve */
+  unsigned int qn_max_age = options->iparam[SICONOS_IPARAM_LSA_QUASI_NEWTON_MAX_AGE];
+  if(qn_max_age > 0 && (functions->compute_descent_direction || functions->compute_RHS_desc))
+  {
+    numerics_printf_verbose(1,"--- newton_LSA :: quasi-Newton mode requires the plain compute_H path, ignored");
+    qn_max_age = 0;
+  }
+  broyden_updates* qn = NULL;
+  if(qn_max_age > 0)
+  {
+    if(sd->qn && ((broyden_updates*)sd->qn)->n != n)
+    {
+      broyden_updates_free((broyden_updates*)sd->qn);
+      sd->qn = NULL;
+    }
+    if(!sd->qn)
+      sd->qn = broyden_updates_new(n, qn_max_age);
+    qn = (broyden_updates*)sd->qn;
+    broyden_updates_reset(qn);
+  }
+  unsigned int H_age = 0;  /* iterations since H was last rebuilt */
+  bool qn_refresh = false; /* convergence degraded: rebuild H */
+
   newton_stats stats_iteration;
   if(options->callback)
   {
     stats_iteration.id = NEWTON_STATS_ITERATION;
   }
 
-  assert(options->solverData);
-  newton_LSA_param* params = (newton_LSA_param*)options->solverParameters;
-  NumericsMatrix* H = ((newton_LSA_data*)options->solverData)->H;
-  assert(params);
-  assert(H);
-
   // Is this really still in use ???
   char* solver_opt = getenv("SICONOS_SPARSE_SOLVER");
   if(solver_opt)
@@ -141,9 +249,15 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
   ls_data.searchtype = LINESEARCH;
   ls_data.extra_params = NULL;
 
+  /* linesearch extra parameters are part of the reusable workspace;
+   * the buffer is large enough for any of the variants */
+  if(!sd->ls_extra_params)
+    sd->ls_extra_params = malloc(sizeof(goldstein_extra_params) > sizeof(armijo_extra_params) ?
+                                 sizeof(goldstein_extra_params) : sizeof(armijo_extra_params));
+
   if(options->iparam[SICONOS_IPARAM_LSA_SEARCH_CRITERION] == SICONOS_LSA_GOLDSTEIN)
   {
-    goldstein_extra_params* pG = (goldstein_extra_params*)malloc(sizeof(goldstein_extra_params));
+    goldstein_extra_params* pG = (goldstein_extra_params*)sd->ls_extra_params;
     ls_data.extra_params = (void*) pG;
     search_Goldstein_params_init(pG);
 
@@ -163,7 +277,7 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
   }
   else if(options->iparam[SICONOS_IPARAM_LSA_SEARCH_CRITERION] == SICONOS_LSA_ARMIJO)
   {
-    armijo_extra_params* pG = (armijo_extra_params*)malloc(sizeof(armijo_extra_params));
+    armijo_extra_params* pG = (armijo_extra_params*)sd->ls_extra_params;
     ls_data.extra_params = (void*) pG;
     search_Armijo_params_init(pG);
     linesearch_algo = &linesearch_Armijo2;
@@ -260,7 +374,21 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
       else
       {
         DEBUG_PRINT("Compute JacThetaF_merit. use merit function as descent computation. \n");
-        functions->compute_H(data, z, F, workV1, workV2, H);
+        /* quasi-Newton: while H is frozen, the accepted step provides
+         * one Broyden correction; H is rebuilt whenever the correction
+         * is rejected or convergence degraded */
+        bool qn_frozen = qn && H_age > 0 && !qn_refresh
+                         && !broyden_updates_add(qn, H, z, F_merit);
+        if(!qn_frozen)
+        {
+          functions->compute_H(data, z, F, workV1, workV2, H);
+          if(qn)
+          {
+            broyden_updates_reset(qn);
+            H_age = 0;
+            qn_refresh = false;
+          }
+        }
         //functions->compute_F_merit(data, z, F, F_merit);
         NM_tgemv(1., H, F_merit, 0., JacThetaF_merit);
         if(log_hdf5)
@@ -275,8 +403,23 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
       cblas_dcopy((int)n, F_merit, incx, workV1, incy);
       cblas_dscal((int)n, -1.0, workV1, incx);
       // info_dir_search = NM_gesv(H, workV1, params->keep_H);
-      NM_set_LU_factorized(H, false);
-      info_dir_search = NM_LU_solve(params->keep_H ? NM_preserve(H) : H, workV1, 1);
+      if(qn)
+      {
+        /* H itself must stay intact (NM_preserve) for the NM_tgemv
+         * above; the factors are reused while H is frozen */
+        if(H_age == 0)
+          NM_set_LU_factorized(H, false);
+        broyden_updates_record(qn, z, F_merit);
+        info_dir_search = NM_LU_solve(NM_preserve(H), workV1, 1);
+        if(!info_dir_search)
+          broyden_updates_apply(qn, workV1);
+        ++H_age;
+      }
+      else
+      {
+        NM_set_LU_factorized(H, false);
+        info_dir_search = NM_LU_solve(params->keep_H ? NM_preserve(H) : H, workV1, 1);
+      }
     }
     /**************************************************************************
      * END COMPUTATION DESCENT DIRECTION
@@ -368,6 +511,8 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
       cblas_dcopy((int)n, JacThetaF_merit, incx, workV1, incy);
       cblas_dscal((int)n, -1.0, workV1, incx);
       theta_iter = INFINITY;
+      /* the gradient step breaks the secant relation */
+      qn_refresh = true;
     }
 
     tau = 1.0;
@@ -381,6 +526,9 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
 
       numerics_printf_verbose(2,"--- newton_LSA :: pure Newton direction not acceptable theta_iter = %g > %g = theta", theta_iter, theta);
 
+      /* convergence degraded: the frozen H is not good enough anymore */
+      qn_refresh = true;
+
       // Computations for the line search
       // preRHS = <JacThetaF_merit, d>
       // TODO: find a better name for this variable
@@ -419,6 +567,8 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
     else
       cblas_daxpy((int)n, 1., workV1, incx, z, incy);           // hack (restart)
 
+    if(qn) qn->tau = isfinite(tau) ? tau : 1.0;
+
     // Construction of the RHS for the next iterate
     /* VA : What happens if we use  functions->compute_RHS_desc(data, z, F, F_merit); above */
     functions->compute_F(data, z, F);
@@ -495,13 +645,9 @@ void newton_LSA(unsigned n, double *z, double *F, int *info, void* data, SolverO
 
 newton_LSA_free:
 
-  if(!options->dWork)
-  {
-    free(JacThetaF_merit);
-    free(F_merit);
-    free(workV1);
-    free(workV2);
-  }
+  /* the vector temporaries and extra_params belong to the solver
+   * workspace (options->solverData), not to ls_data */
+  ls_data.extra_params = NULL;
   free_ls_data(&ls_data);
 
   if(log_hdf5)
@@ -512,7 +658,11 @@ newton_LSA_free:
     SN_logh5_end(logger_s);
   }
 
-  newton_LSA_free_solverOptions(options);
+  /* with SICONOS_IPARAM_PREALLOC the workspace is kept for the next
+   * call (same-size solves are then allocation-free and H keeps its
+   * sparse structure); the caller does the final cleanup */
+  if(!options->iparam[SICONOS_IPARAM_PREALLOC])
+    newton_LSA_free_solverOptions(options);
 }
 
 void newton_lsa_set_default(SolverOptions* options)
@@ -551,10 +701,25 @@ void set_lsa_params_data(SolverOptions* options, NumericsMatrix* mat)
 
   if(!options->solverData)
   {
-    options->solverData = malloc(sizeof(newton_LSA_data));
+    options->solverData = calloc(1, sizeof(newton_LSA_data));
     newton_LSA_data* sd = (newton_LSA_data*) options->solverData;
     sd->H = NM_duplicate(mat);
   }
+  else
+  {
+    /* workspace kept from a previous call (SICONOS_IPARAM_PREALLOC):
+     * rebuild H only if the problem changed shape or storage, so its
+     * sparse structure is reused by same-size solves */
+    newton_LSA_data* sd = (newton_LSA_data*) options->solverData;
+    assert(sd->H);
+    if(sd->H->size0 != mat->size0 || sd->H->size1 != mat->size1
+        || sd->H->storageType != mat->storageType)
+    {
+      NM_clear(sd->H);
+      free(sd->H);
+      sd->H = NM_duplicate(mat);
+    }
+  }
 }
 
 void newton_LSA_free_solverOptions(SolverOptions* options)
@@ -571,6 +736,9 @@ void newton_LSA_free_solverOptions(SolverOptions* options)
     assert(sd->H);
     NM_clear(sd->H);
     free(sd->H);
+    free(sd->dwork);
+    free(sd->ls_extra_params);
+    broyden_updates_free((broyden_updates*)sd->qn);
     free(sd);
     options->solverData = NULL;
   }
@@ -104,11 +104,97 @@ typedef struct {
                              (Eqn 9.1.6 p. 805 in Facchinei & Pang)*/
 } newton_LSA_param;
 
-/** \struct newton_LSA_data Newton_methods.h*/
+/** \struct newton_LSA_data Newton_methods.h
+ *
+ *  Workspace of newton_LSA(), stored in SolverOptions.solverData and
+ *  sized once from the problem dimension. By default it is released at
+ *  the end of each newton_LSA() call; when
+ *  iparam[SICONOS_IPARAM_PREALLOC] is set it is kept across calls, so
+ *  repeated Newton solves on a problem of the same size (the common
+ *  case inside a time step) are allocation-free and the (sparse)
+ *  structure of H is reused instead of being rebuilt. The caller is
+ *  then responsible for the final newton_LSA_free_solverOptions() call.
+ */
 typedef struct {
   NumericsMatrix *H; /**< matrix */
+  size_t n;     /**< dimension the workspace below was sized for */
+  double *dwork; /**< scratch for F_merit, workV1, workV2 and
+                   JacThetaF_merit (4*n) */
+  void *ls_extra_params; /**< linesearch extra parameters, reused across
+                           calls */
+  void *qn; /**< quasi-Newton (Broyden) state, see broyden_updates; only
+              allocated when iparam[SICONOS_IPARAM_LSA_QUASI_NEWTON_MAX_AGE]
+              is positive */
 } newton_LSA_data;
 
+/** \struct broyden_updates Newton_methods.h
+ *
+ *  Rank-1 (Broyden) corrections of a factorized Newton matrix, applied
+ *  to the solves with the Sherman-Morrison formula. While the matrix and
+ *  its factors are kept frozen, each accepted step contributes one
+ *  update B <- B + u s^T / (s^T s) built from the secant pair
+ *  (s = z_{k+1} - z_k, y = F_{k+1} - F_k); since the step satisfies
+ *  B s = -tau F_k, the numerator u = y - B s = F_{k+1} - (1 - tau) F_k
+ *  costs no matrix-vector product. A solve with the corrected matrix is
+ *  a solve with the frozen factors followed by broyden_updates_apply().
+ */
+typedef struct {
+  unsigned int n;         /**< problem size */
+  unsigned int max_age;   /**< maximal number of stored corrections */
+  unsigned int nb_updates; /**< number of corrections currently stored */
+  double* s;      /**< steps, max_age contiguous vectors of length n */
+  double* w;      /**< B^{-1} u vectors, same layout as s */
+  double* denom;  /**< Sherman-Morrison denominators s^T s + s^T w */
+  double* z_prev; /**< iterate recorded at the last direction computation */
+  double* F_prev; /**< residual recorded at the last direction computation */
+  double* tmp;    /**< scratch vector */
+  double tau;     /**< step length actually taken from z_prev */
+} broyden_updates;
+
+/** allocate a Broyden update structure
+ *
+ *  \param n the problem size
+ *  \param max_age the maximal number of stored corrections
+ *  \return the allocated structure
+ */
+broyden_updates* broyden_updates_new(unsigned int n, unsigned int max_age);
+
+/** drop all stored corrections (to be called when the matrix is rebuilt) */
+void broyden_updates_reset(broyden_updates* qn);
+
+void broyden_updates_free(broyden_updates* qn);
+
+/** record the current iterate and residual; to be called at each
+ *  direction computation, after broyden_updates_add(). The step length
+ *  must then be stored in qn->tau once the line search has accepted it.
+ *
+ *  \param qn the Broyden updates
+ *  \param z the current iterate
+ *  \param F the residual at z (the right-hand side of the Newton solve)
+ */
+void broyden_updates_record(broyden_updates* qn, const double* z, const double* F);
+
+/** add the correction built from the last recorded step
+ *
+ *  \param qn the Broyden updates
+ *  \param H the frozen, factorized Newton matrix
+ *  \param z the current iterate
+ *  \param F the residual at z
+ *  \return 0 on success, 1 when the update must be rejected (storage
+ *  full, null step or near-singular denominator): the caller then
+ *  rebuilds the matrix
+ */
+int broyden_updates_add(broyden_updates* qn, NumericsMatrix* H,
+                        const double* z, const double* F);
+
+/** apply the stored corrections to x, after the solve with the frozen
+ *  factors
+ *
+ *  \param qn the Broyden updates
+ *  \param x the solution of the factorized solve, corrected in place
+ */
+void broyden_updates_apply(const broyden_updates* qn, double* x);
+
 enum NEWTON_SOLVER { SICONOS_NEWTON_LSA = 10000 };
 
 extern const char *const SICONOS_NEWTON_LSA_STR;
@@ -119,7 +205,12 @@ enum SICONOS_NEWTON_IPARAM {
   SICONOS_IPARAM_LSA_NONMONOTONE_LS_M = 4,
   SICONOS_IPARAM_LSA_FORCE_ARCSEARCH = 5,
   SICONOS_IPARAM_LSA_SEARCH_CRITERION = 6,
-  SICONOS_IPARAM_STOPPING_CRITERION = 10
+  SICONOS_IPARAM_STOPPING_CRITERION = 10,
+  /** quasi-Newton: keep the Newton matrix and its factors for up to this
+      many iterations, correcting the solves with Broyden rank-1 updates
+      (Sherman-Morrison); the matrix is rebuilt as soon as convergence
+      degrades. 0 (the default) rebuilds every iteration. */
+  SICONOS_IPARAM_LSA_QUASI_NEWTON_MAX_AGE = 11
 };
 
 enum SICONOS_STOPPING_CRITERION {
@@ -0,0 +1,101 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NumericsArena.h"
+#include <assert.h>            // for assert
+#include <stdlib.h>            // for malloc, free
+#include <string.h>            // for memset
+#include "numerics_verbose.h"  // for numerics_error
+
+#define NUMERICS_ARENA_DEFAULT_CAPACITY ((size_t)(1 << 20))
+#define NUMERICS_ARENA_ALIGNMENT (sizeof(double))
+
+static NumericsArenaChunk* numerics_arena_chunk_new(size_t capacity)
+{
+  NumericsArenaChunk* chunk =
+    (NumericsArenaChunk*) malloc(sizeof(NumericsArenaChunk) + capacity);
+  if(!chunk)
+    numerics_error("numerics_arena_chunk_new", "memory allocation failed");
+  chunk->next = NULL;
+  chunk->capacity = capacity;
+  chunk->used = 0;
+  return chunk;
+}
+
+NumericsArena* numerics_arena_new(size_t capacity)
+{
+  if(capacity == 0) capacity = NUMERICS_ARENA_DEFAULT_CAPACITY;
+
+  NumericsArena* arena = (NumericsArena*) malloc(sizeof(NumericsArena));
+  if(!arena)
+    numerics_error("numerics_arena_new", "memory allocation failed");
+  arena->default_capacity = capacity;
+  arena->head = numerics_arena_chunk_new(capacity);
+  return arena;
+}
+
+void* numerics_arena_alloc(NumericsArena* arena, size_t size)
+{
+  assert(arena);
+  assert(arena->head);
+
+  /* keep every allocation double-aligned */
+  size = (size + NUMERICS_ARENA_ALIGNMENT - 1) & ~(NUMERICS_ARENA_ALIGNMENT - 1);
+
+  NumericsArenaChunk* chunk = arena->head;
+  if(chunk->capacity - chunk->used < size)
+  {
+    /* grow: chain a fresh chunk large enough for this request */
+    size_t capacity = arena->default_capacity;
+    if(capacity < size) capacity = size;
+    NumericsArenaChunk* fresh = numerics_arena_chunk_new(capacity);
+    fresh->next = chunk;
+    arena->head = fresh;
+    chunk = fresh;
+  }
+
+  void* p = (char*)(chunk + 1) + chunk->used;
+  chunk->used += size;
+  return p;
+}
+
+void* numerics_arena_calloc(NumericsArena* arena, size_t nmemb, size_t size)
+{
+  void* p = numerics_arena_alloc(arena, nmemb * size);
+  memset(p, 0, nmemb * size);
+  return p;
+}
+
+void numerics_arena_reset(NumericsArena* arena)
+{
+  assert(arena);
+  for(NumericsArenaChunk* chunk = arena->head; chunk; chunk = chunk->next)
+    chunk->used = 0;
+}
+
+void numerics_arena_free(NumericsArena* arena)
+{
+  if(!arena) return;
+  NumericsArenaChunk* chunk = arena->head;
+  while(chunk)
+  {
+    NumericsArenaChunk* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  free(arena);
+}
@@ -0,0 +1,90 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NumericsArena_H
+#define NumericsArena_H
+
+/*!\file NumericsArena.h
+  \brief Region (arena) allocator for solver-scoped workspaces.
+
+  A NumericsArena hands out memory by bumping a pointer inside large
+  pre-allocated chunks; individual allocations are never freed, the whole
+  region is released (or recycled with numerics_arena_reset) at once.
+  Solvers that allocate many temporary vectors per driver call can park an
+  arena in their SolverOptions::solverData so that after the first call no
+  transient malloc/free traffic is left on the iteration path.
+
+  All allocations are aligned for double storage.
+*/
+
+#include <stddef.h>  // for size_t
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** One chunk of arena storage; chunks are chained when the arena grows. */
+  typedef struct NumericsArenaChunk
+  {
+    struct NumericsArenaChunk* next; /**< next (older) chunk or NULL */
+    size_t capacity;                 /**< usable bytes in this chunk */
+    size_t used;                     /**< bytes already handed out */
+    /* payload follows the header in the same malloc block */
+  } NumericsArenaChunk;
+
+  /** Solver-scoped region allocator. */
+  typedef struct NumericsArena
+  {
+    NumericsArenaChunk* head;  /**< current chunk, allocations come from here */
+    size_t default_capacity;   /**< size of newly grown chunks, in bytes */
+  } NumericsArena;
+
+  /** Create an arena.
+      \param capacity initial capacity in bytes (also the growth granularity);
+      pass 0 for a default size.
+      \return the arena, to be released with numerics_arena_free */
+  NumericsArena* numerics_arena_new(size_t capacity);
+
+  /** Allocate size bytes from the arena, growing it if needed.
+      The memory is valid until numerics_arena_reset or numerics_arena_free.
+      \param arena the arena
+      \param size requested size in bytes
+      \return pointer to uninitialized, double-aligned storage */
+  void* numerics_arena_alloc(NumericsArena* arena, size_t size);
+
+  /** Allocate and zero-fill nmemb elements of the given size, calloc-style.
+      \param arena the arena
+      \param nmemb number of elements
+      \param size size of one element in bytes
+      \return pointer to zeroed, double-aligned storage */
+  void* numerics_arena_calloc(NumericsArena* arena, size_t nmemb, size_t size);
+
+  /** Recycle the arena: mark all chunks empty without returning them to the
+      system, so the next round of allocations is malloc-free.
+      \param arena the arena */
+  void numerics_arena_reset(NumericsArena* arena);
+
+  /** Release the arena and all its chunks.
+      \param arena the arena (may be NULL) */
+  void numerics_arena_free(NumericsArena* arena);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
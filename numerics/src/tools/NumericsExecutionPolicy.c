@@ -0,0 +1,52 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NumericsExecutionPolicy.h"
+
+#include <stdlib.h>  // for getenv, strtol, NULL
+
+NumericsExecutionPolicy *numerics_execution_policy(void)
+{
+  static NumericsExecutionPolicy policy;
+  static int initialized = 0;
+  if(!initialized)
+  {
+    const char *env = getenv("SICONOS_DETERMINISTIC_REDUCTIONS");
+    policy.deterministic_reductions = (env && strtol(env, NULL, 10) != 0);
+    env = getenv("SICONOS_TASK_POOL_THREADS");
+    policy.nthreads = env ? (unsigned int)strtol(env, NULL, 10) : 0;
+    env = getenv("SICONOS_NUMA_NODES");
+    policy.numa_nodes = env ? (unsigned int)strtol(env, NULL, 10) : 0;
+    initialized = 1;
+  }
+  return &policy;
+}
+
+double numerics_fixed_order_sum(const double *values, size_t n)
+{
+  /* pairwise tree with a short running-sum base case: the recursion
+     depth stays logarithmic and the order depends on n only */
+  if(n <= 8)
+  {
+    double sum = 0.0;
+    for(size_t i = 0; i < n; ++i) sum += values[i];
+    return sum;
+  }
+  size_t half = n / 2;
+  return numerics_fixed_order_sum(values, half)
+         + numerics_fixed_order_sum(&values[half], n - half);
+}
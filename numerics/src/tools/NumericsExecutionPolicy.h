@@ -0,0 +1,86 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NumericsExecutionPolicy_H
+#define NumericsExecutionPolicy_H
+
+/*!\file NumericsExecutionPolicy.h
+ * \brief process-wide knobs for the parallel execution of the solvers.
+ *
+ * The policy gathers in one place what validation runs need to control:
+ * the number of worker threads handed to the default task pool, and
+ * whether the parallel floating-point sums are performed in a fixed
+ * order. With deterministic_reductions set, every parallel sum stores
+ * its per-element terms and folds them with numerics_fixed_order_sum(),
+ * so the result is bitwise identical whatever the thread count or
+ * schedule; the plain OpenMP reductions sum the partial results in
+ * whatever order the threads finish. Order-independent reductions (max,
+ * min, bitwise or) are unaffected, they are already reproducible.
+ */
+
+#include <stddef.h>        // for size_t
+
+#include "SiconosConfig.h" // for BUILD_AS_CPP // IWYU pragma: keep
+
+/** process-wide execution policy, read by the parallel solvers */
+typedef struct NumericsExecutionPolicy
+{
+  /** fold parallel sums in a fixed order, for bitwise reproducibility
+      across thread counts; seeded from the
+      SICONOS_DETERMINISTIC_REDUCTIONS environment variable */
+  int deterministic_reductions;
+  /** number of workers of the default task pool, 0 for the number of
+      online processors; seeded from SICONOS_TASK_POOL_THREADS and read
+      when the pool is first used */
+  unsigned int nthreads;
+  /** number of NUMA nodes the parallel solvers replicate their
+      read-only problem data on (see NumericsNumaReplica.h); 0 or 1
+      disables replication; seeded from SICONOS_NUMA_NODES */
+  unsigned int numa_nodes;
+} NumericsExecutionPolicy;
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C" {
+#endif
+
+/** The process-wide policy, seeded from the environment on first use.
+ *
+ *  Mutating the fields is allowed and takes effect on the next solve
+ *  (nthreads only before the default pool is created).
+ *
+ *  \return the policy
+ */
+NumericsExecutionPolicy *numerics_execution_policy(void);
+
+/** Sum n values in a fixed pairwise order.
+ *
+ *  The folding order only depends on n, never on thread count or
+ *  schedule, and the pairwise tree also carries a smaller rounding
+ *  error than a running sum.
+ *
+ *  \param values the terms, ordered by the caller (e.g. by contact index)
+ *  \param n number of terms
+ *  \return the sum
+ */
+double numerics_fixed_order_sum(const double *values, size_t n);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
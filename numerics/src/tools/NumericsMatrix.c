@@ -23,6 +23,7 @@
 #include <stdio.h>                    // for printf, fprintf, size_t, fscanf
 #include <stdlib.h>                   // for exit, malloc, free, EXIT_FAILURE
 #include <string.h>                   // for memcpy, memset
+#include <time.h>                     // for clock_gettime, timespec (NSM_AUTO benchmark)
 #include "CSparseMatrix_internal.h"            // for CSparseMatrix, CS_INT, cs_dl_sp...
 #include "NM_MPI.h"                   // for NM_MPI_copy
 #include "NM_MUMPS.h"                 // for NM_MUMPS_copy
@@ -85,8 +86,13 @@ void NM_internalData_new(NumericsMatrix* M)
   M->internalData->iWorkSize = 0;
   M->internalData->dWork = NULL;
   M->internalData->dWorkSize = 0;
+  M->internalData->sWork = NULL;
+  M->internalData->sWorkSize = 0;
+  M->internalData->colNonzero = NULL;
+  M->internalData->colNonzeroSize = 0;
   M->internalData->isInversed = false ;
   M->internalData->isLUfactorized = false ;
+  M->internalData->isSLUfactorized = false ;
   M->internalData->isCholeskyfactorized = false ;
   M->internalData->isLDLTfactorized = false ;
 #ifdef SICONOS_HAS_MPI
@@ -98,6 +104,266 @@ void NM_internalData_new(NumericsMatrix* M)
 }
 
 
+/* ============ Memory accounting ============ */
+
+/* registry of the matrices currently alive, maintained by NM_new and the
+ * NM_free variants. Matrices are created and freed inside OpenMP regions
+ * (per-island and per-batch drivers, the NSGS local problems), so every
+ * access to the registry arrays goes through the NM_mem_registry named
+ * critical section; the pragmas compile away in a serial build. */
+static NumericsMatrix** NM_mem_registry = NULL;
+static size_t NM_mem_registry_size = 0;
+static size_t NM_mem_registry_capacity = 0;
+
+static size_t NM_mem_budget_limit = 0;
+static NM_mem_budget_cb NM_mem_budget_callback = NULL;
+static void* NM_mem_budget_callback_data = NULL;
+static int NM_mem_in_budget_callback = 0;
+
+static void NM_mem_register(NumericsMatrix* M)
+{
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    if(NM_mem_registry_size == NM_mem_registry_capacity)
+    {
+      NM_mem_registry_capacity = NM_mem_registry_capacity ? 2 * NM_mem_registry_capacity : 64;
+      NM_mem_registry = (NumericsMatrix**)realloc(NM_mem_registry,
+                        NM_mem_registry_capacity * sizeof(NumericsMatrix*));
+      assert(NM_mem_registry);
+    }
+    NM_mem_registry[NM_mem_registry_size++] = M;
+  }
+}
+
+static void NM_mem_unregister(NumericsMatrix* M)
+{
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    /* matrices are mostly freed in reverse creation order, so scan backwards */
+    for(size_t i = NM_mem_registry_size; i > 0; i--)
+    {
+      if(NM_mem_registry[i-1] == M)
+      {
+        NM_mem_registry[i-1] = NM_mem_registry[--NM_mem_registry_size];
+        break;
+      }
+    }
+  }
+}
+
+size_t NM_sizeof_tag(const NumericsMatrix* A, NM_mem_tag tag)
+{
+  assert(A);
+
+  size_t bytes = 0;
+  switch(tag)
+  {
+  case NM_MEM_DENSE:
+  {
+    if(A->matrix0)
+      bytes += (size_t)A->size0 * (size_t)A->size1 * sizeof(double);
+    break;
+  }
+  case NM_MEM_SPARSE:
+  {
+    if(A->matrix1)
+    {
+      SparseBlockStructuredMatrix* B = A->matrix1;
+      for(size_t row = 0; row + 1 < B->filled1; row++)
+      {
+        size_t nbRows = B->blocksize0[row] - (row ? B->blocksize0[row-1] : 0);
+        for(size_t b = B->index1_data[row]; b < B->index1_data[row+1]; b++)
+        {
+          size_t col = B->index2_data[b];
+          size_t nbCols = B->blocksize1[col] - (col ? B->blocksize1[col-1] : 0);
+          bytes += nbRows * nbCols * sizeof(double);
+        }
+      }
+      bytes += (size_t)B->nbblocks * sizeof(double*);
+      bytes += ((size_t)B->blocknumber0 + (size_t)B->blocknumber1) * sizeof(unsigned int);
+      bytes += (B->filled1 + B->filled2) * sizeof(size_t);
+      if(B->diagonal_blocks) bytes += (size_t)B->blocknumber0 * sizeof(unsigned int);
+    }
+    if(A->matrix2)
+    {
+      NumericsSparseMatrix* S = A->matrix2;
+      bytes += CSparseMatrix_bytes(S->triplet);
+      bytes += CSparseMatrix_bytes(S->half_triplet);
+      bytes += CSparseMatrix_bytes(S->csc);
+      bytes += CSparseMatrix_bytes(S->trans_csc);
+      bytes += CSparseMatrix_bytes(S->csr);
+      if(S->diag_indx) bytes += (size_t)A->size0 * sizeof(CS_INT);
+      if(S->reorder_perm) bytes += (size_t)A->size0 * sizeof(CS_INT);
+    }
+    break;
+  }
+  case NM_MEM_FACTORS:
+  {
+    if(A->matrix2 && A->matrix2->linearSolverParams)
+    {
+      NSM_linear_solver_params* p = A->matrix2->linearSolverParams;
+      if(p->linear_solver_data && p->solver == NSM_CSPARSE)
+      {
+        CSparseMatrix_factors* F = (CSparseMatrix_factors*)p->linear_solver_data;
+        if(F->N)
+        {
+          bytes += CSparseMatrix_bytes(F->N->L);
+          bytes += CSparseMatrix_bytes(F->N->U);
+          if(F->N->pinv) bytes += (size_t)F->n * sizeof(CS_INT);
+          if(F->N->B) bytes += (size_t)F->n * sizeof(double);
+        }
+        /* symbolic analysis: pinv, q, parent, cp, leftmost */
+        if(F->S) bytes += 5 * (size_t)F->n * sizeof(CS_INT);
+      }
+    }
+    break;
+  }
+  case NM_MEM_WORKSPACE:
+  {
+    if(A->internalData)
+    {
+      bytes += A->internalData->iWorkSize; /* already in bytes */
+      bytes += A->internalData->dWorkSize * sizeof(double);
+      bytes += A->internalData->sWorkSize * sizeof(float);
+      bytes += (size_t)A->internalData->colNonzeroSize * sizeof(unsigned int);
+    }
+    if(A->matrix2 && A->matrix2->linearSolverParams)
+    {
+      NSM_linear_solver_params* p = A->matrix2->linearSolverParams;
+      bytes += (size_t)p->iWorkSize * sizeof(int);
+      bytes += (size_t)p->dWorkSize * sizeof(double);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  return bytes;
+}
+
+size_t NM_sizeof(const NumericsMatrix* A)
+{
+  size_t bytes = sizeof(NumericsMatrix);
+  for(int tag = 0; tag < NM_MEM_NB_TAGS; tag++)
+    bytes += NM_sizeof_tag(A, (NM_mem_tag)tag);
+  return bytes;
+}
+
+size_t NM_mem_bytes(NM_mem_tag tag)
+{
+  size_t bytes = 0;
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    for(size_t i = 0; i < NM_mem_registry_size; i++)
+      bytes += NM_sizeof_tag(NM_mem_registry[i], tag);
+  }
+  return bytes;
+}
+
+size_t NM_mem_total(void)
+{
+  size_t bytes = 0;
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    for(size_t i = 0; i < NM_mem_registry_size; i++)
+      bytes += NM_sizeof(NM_mem_registry[i]);
+  }
+  return bytes;
+}
+
+void NM_mem_report(void)
+{
+  static const char* const names[NM_MEM_NB_TAGS] =
+  { "dense", "sparse", "factors", "workspace" };
+
+  size_t alive = 0;
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    alive = NM_mem_registry_size;
+  }
+  numerics_printf("NM_mem_report: %zu matrices alive", alive);
+  for(int tag = 0; tag < NM_MEM_NB_TAGS; tag++)
+    numerics_printf("NM_mem_report: %-10s %zu bytes", names[tag],
+                    NM_mem_bytes((NM_mem_tag)tag));
+  numerics_printf("NM_mem_report: %-10s %zu bytes", "total", NM_mem_total());
+}
+
+void NM_mem_set_budget(size_t budget, NM_mem_budget_cb callback, void* user_data)
+{
+  NM_mem_budget_limit = budget;
+  NM_mem_budget_callback = callback;
+  NM_mem_budget_callback_data = user_data;
+}
+
+void NM_mem_check_budget(void)
+{
+  if(!NM_mem_budget_limit || !NM_mem_budget_callback)
+    return;
+
+  /* guard against the callback triggering a nested check through NM_csc
+   * or a factorization, and against two threads running it at once; the
+   * callback itself runs outside the critical section so that it can
+   * call NM_mem_evict_factors and the totals */
+  int entered = 0;
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    if(!NM_mem_in_budget_callback)
+    {
+      NM_mem_in_budget_callback = 1;
+      entered = 1;
+    }
+  }
+  if(!entered)
+    return;
+
+  size_t total = NM_mem_total();
+  if(total > NM_mem_budget_limit)
+    NM_mem_budget_callback(total, NM_mem_budget_limit, NM_mem_budget_callback_data);
+
+  NM_mem_in_budget_callback = 0;
+}
+
+unsigned int NM_mem_evict_factors(const NumericsMatrix* keep)
+{
+  unsigned int evicted = 0;
+#ifdef _OPENMP
+  #pragma omp critical (NM_mem_registry)
+#endif
+  {
+    for(size_t i = 0; i < NM_mem_registry_size; i++)
+    {
+      NumericsMatrix* A = NM_mem_registry[i];
+      if(A == keep || (keep && A == keep->destructible)) continue;
+      if(A->matrix2 && A->matrix2->linearSolverParams)
+      {
+        A->matrix2->linearSolverParams =
+          NSM_linearSolverParams_free(A->matrix2->linearSolverParams);
+        if(A->internalData)
+        {
+          A->internalData->isLUfactorized = false;
+          A->internalData->isSLUfactorized = false;
+          A->internalData->isCholeskyfactorized = false;
+          A->internalData->isLDLTfactorized = false;
+        }
+        evicted++;
+      }
+    }
+  }
+  return evicted;
+}
+
 static version_t NM_version(const NumericsMatrix* M, NM_types id)
 {
   switch (id)
@@ -687,6 +953,17 @@ void NM_internalData_free(NumericsMatrix* m)
       free(m->internalData->dWork);
     }
     m->internalData->dWork = NULL;
+    if(m->internalData->sWork)
+    {
+      assert(m->internalData->sWorkSize > 0);
+      free(m->internalData->sWork);
+    }
+    m->internalData->sWork = NULL;
+    if(m->internalData->colNonzero)
+    {
+      free(m->internalData->colNonzero);
+    }
+    m->internalData->colNonzero = NULL;
     free(m->internalData);
     m->internalData = NULL;
   }
@@ -767,7 +1044,38 @@ void NM_internalData_copy(const NumericsMatrix* const A, NumericsMatrix* B)
         free(B->internalData->dWork);
       B->internalData->dWorkSize=0;
     }
+    if(A->internalData->sWork)
+    {
+      if(! B->internalData->sWork)
+      {
+        B->internalData->sWork = (float*)malloc(A->internalData->sWorkSize*sizeof(float));
+        B->internalData->sWorkSize = A->internalData->sWorkSize;
+      }
+      else
+      {
+        if(A->internalData->sWorkSize != B->internalData->sWorkSize)
+        {
+          B->internalData->sWorkSize = A->internalData->sWorkSize;
+          B->internalData->sWork = realloc(B->internalData->sWork,A->internalData->sWorkSize*sizeof(float));
+        }
+      }
+      memcpy(B->internalData->sWork, A->internalData->sWork, A->internalData->sWorkSize*sizeof(float));
+    }
+    else
+    {
+      if(B->internalData->sWork)
+        free(B->internalData->sWork);
+      B->internalData->sWork = NULL;
+      B->internalData->sWorkSize=0;
+    }
+    /* the column pattern is a per-product workspace: drop it in B rather
+     * than copying, it is rebuilt on the next product if needed */
+    if(B->internalData->colNonzero)
+      free(B->internalData->colNonzero);
+    B->internalData->colNonzero = NULL;
+    B->internalData->colNonzeroSize = 0;
     B->internalData->isLUfactorized = A->internalData->isLUfactorized;
+    B->internalData->isSLUfactorized = A->internalData->isSLUfactorized;
     B->internalData->isCholeskyfactorized = A->internalData->isCholeskyfactorized;
     B->internalData->isLDLTfactorized = A->internalData->isLDLTfactorized;
     B->internalData->isInversed = A->internalData->isInversed;
@@ -791,6 +1099,9 @@ void NM_clear(NumericsMatrix* m)
     m->destructible = m;
   }
 
+  /* a cleared matrix is usually about to be freed, possibly with a bare
+   * free(): drop it from the memory accounting registry now */
+  NM_mem_unregister(m);
 }
 
 NumericsMatrix*  NM_free(NumericsMatrix* m)
@@ -819,6 +1130,7 @@ void  NM_clear_not_dense(NumericsMatrix* m)
     NM_clear(m->destructible);
     m->destructible = m;
   }
+  NM_mem_unregister(m);
   DEBUG_END("NM_clear_not_dense(NumericsMatrix* m)\n");
 }
 NumericsMatrix*  NM_free_not_dense(NumericsMatrix* m)
@@ -843,6 +1155,7 @@ void  NM_clear_not_SBM(NumericsMatrix* m)
     NM_clear(m->destructible);
     m->destructible = m;
   }
+  NM_mem_unregister(m);
 }
 
 NumericsMatrix*  NM_free_not_SBM(NumericsMatrix* m)
@@ -2241,6 +2554,7 @@ NumericsMatrix* NM_new(void)
   M->size0 = 0;
   M->size1 = 0;
   NM_null(M);
+  NM_mem_register(M);
   DEBUG_END("NumericsMatrix* NM_new(void)\n");
   return M;
 }
@@ -2533,8 +2847,10 @@ void NM_clearCSCTranspose(NumericsMatrix* A)
       cs_spfree(A->matrix2->trans_csc);
     }
     A->matrix2->trans_csc = NULL;
+    /* the transpose is a terminal format: its version only records the csc
+     * version it was computed from, see NM_csc_trans */
+    NDV_reset(&(A->matrix2->trans_csc_version));
   }
-  /* no version for csc transpose as it is a terminal format */
 }
 
 void NM_clearCSR(NumericsMatrix* A)
@@ -2567,6 +2883,107 @@ void NM_clearSparseStorage(NumericsMatrix *A)
   /* reset version done in NM_clear* */
 }
 
+int NM_reorder(NumericsMatrix* A, NM_reorder_method method)
+{
+  assert(A);
+  if(A->storageType != NM_SPARSE)
+    numerics_error("NM_reorder", "only implemented for NM_SPARSE storage");
+  if(A->size0 != A->size1)
+    numerics_error("NM_reorder", "the matrix must be square");
+
+  CSparseMatrix* csc = NM_csc(A);
+  CS_INT n = csc->n;
+  CS_INT* p = NULL;
+  switch(method)
+  {
+  case NM_REORDER_AMD:
+  {
+    p = cs_amd(1, csc);  /* ordering 1: minimum degree of the pattern C+C' */
+    break;
+  }
+  case NM_REORDER_RCM:
+  {
+    p = CSparseMatrix_rcm(csc);
+    break;
+  }
+  default:
+    numerics_error("NM_reorder", "unknown reordering method %d", method);
+  }
+  if(!p) return 1;
+
+  CS_INT* pinv = cs_pinv(p, n);
+  CSparseMatrix* C = pinv ? cs_permute(csc, pinv, p, 1) : NULL;
+  cs_free(pinv);
+  if(!C)
+  {
+    cs_free(p);
+    return 1;
+  }
+  /* cs_permute leaves the row indices of each column unsorted; a double
+   * transpose sorts them */
+  CSparseMatrix* CT = cs_transpose(C, 1);
+  cs_spfree(C);
+  C = cs_transpose(CT, 1);
+  cs_spfree(CT);
+  if(!C)
+  {
+    cs_free(p);
+    return 1;
+  }
+
+  NumericsSparseMatrix* S = A->matrix2;
+  version_t version = NM_max_version(A);
+
+  /* every storage and factorization derived from the old ordering is stale */
+  if(S->linearSolverParams)
+    S->linearSolverParams = NSM_linearSolverParams_free(S->linearSolverParams);
+  if(S->diag_indx)
+  {
+    free(S->diag_indx);
+    S->diag_indx = NULL;
+  }
+  NM_clearTriplet(A);
+  NM_clearHalfTriplet(A);
+  NM_clearCSC(A);
+  NM_clearCSCTranspose(A);
+  NM_clearCSR(A);
+
+  S->csc = C;
+  S->origin = NSM_CSC;
+  NSM_set_version(S, NSM_CSC, version);
+  NSM_inc_version(S, NSM_CSC);
+
+  /* compose with a previous reordering so that reorder_perm always maps
+   * back to the ordering the caller started from */
+  if(S->reorder_perm)
+  {
+    CS_INT* composed = (CS_INT*)cs_malloc(n, sizeof(CS_INT));
+    for(CS_INT k = 0; k < n; k++) composed[k] = S->reorder_perm[p[k]];
+    cs_free(S->reorder_perm);
+    cs_free(p);
+    S->reorder_perm = composed;
+  }
+  else
+    S->reorder_perm = p;
+
+  return 0;
+}
+
+void NM_reorder_rhs(const NumericsMatrix* A, const double* b, double* pb)
+{
+  assert(A->matrix2);
+  assert(A->matrix2->reorder_perm);
+  const CS_INT* p = A->matrix2->reorder_perm;
+  for(CS_INT i = 0; i < A->size0; i++) pb[i] = b[p[i]];
+}
+
+void NM_reorder_solution(const NumericsMatrix* A, const double* px, double* x)
+{
+  assert(A->matrix2);
+  assert(A->matrix2->reorder_perm);
+  const CS_INT* p = A->matrix2->reorder_perm;
+  for(CS_INT i = 0; i < A->size0; i++) x[p[i]] = px[i];
+}
 
 void NM_dense_to_sparse(const NumericsMatrix* const A, NumericsMatrix* B, double threshold)
 {
@@ -2889,56 +3306,84 @@ CSparseMatrix* NM_triplet(NumericsMatrix* A)
     case NM_SPARSE_BLOCK:
     {
 
-      /* Invalidation of previously constructed csc storage. */
-      /* If we want to avoid this -> rewrite cs_compress with reallocation. */
-      NM_clearCSC(A);
-      NM_clearCSR(A);
-      NM_clearCSCTranspose(A);
+      /* Invalidate previously constructed csc/csr storages only when
+         they are stale: a version equal to the source means they were
+         built from the same data, so they stay valid next to the
+         rebuilt triplet and a later NM_csc() reuses them as they are. */
+      {
+        version_t src_version = NM_version(A, A->storageType);
+        if(A->matrix2->csc && NSM_version(A->matrix2, NSM_CSC) < src_version)
+        {
+          NM_clearCSC(A);
+          NM_clearCSCTranspose(A);
+        }
+        if(A->matrix2->csr && NSM_version(A->matrix2, NSM_CSR) < src_version)
+          NM_clearCSR(A);
+      }
 
       A->matrix2->origin = NSM_TRIPLET;
 
-      A->matrix2->triplet = cs_spalloc(0,0,1,1,1);
-
       if(A->matrix1)
       {
+        SparseBlockStructuredMatrix* B = A->matrix1;
 
-        /* iteration on row, cr : current row */
-        for(unsigned int cr = 0; cr < A->matrix1->filled1-1; ++cr)
+        /* Count the entries once so the triplet is allocated at its
+           final size: appending through CSparseMatrix_entry reallocates
+           repeatedly and keeps the fill sequential. blocknnz[bn] is
+           the offset of block bn in the triplet arrays. */
+        size_t nblocks = B->filled1 > 1 ? B->index1_data[B->filled1 - 1] : 0;
+        size_t* blocknnz = (size_t*)malloc((nblocks + 1) * sizeof(size_t));
+        size_t nnz = 0;
+        for(unsigned int cr = 0; cr + 1 < B->filled1; ++cr)
         {
-          for(size_t bn = A->matrix1->index1_data[cr];
-              bn < A->matrix1->index1_data[cr + 1]; ++bn)
+          size_t inbr = B->blocksize0[cr] - (cr != 0 ? B->blocksize0[cr - 1] : 0);
+          for(size_t bn = B->index1_data[cr]; bn < B->index1_data[cr + 1]; ++bn)
           {
-            /* cc : current column */
-            size_t cc = A->matrix1->index2_data[bn];
-            unsigned int inbr = A->matrix1->blocksize0[cr];
-            unsigned int roffset = 0;
-            unsigned int coffset = 0;
-            if(cr != 0)
-            {
-              roffset = A->matrix1->blocksize0[cr - 1];
-              inbr -= roffset;
-            }
-            unsigned int inbc = A->matrix1->blocksize1[cc];
-            if(cc != 0)
-            {
-              coffset = A->matrix1->blocksize1[cc - 1];
-              inbc -= coffset;
-            }
+            size_t cc = B->index2_data[bn];
+            size_t inbc = B->blocksize1[cc] - (cc != 0 ? B->blocksize1[cc - 1] : 0);
+            blocknnz[bn] = nnz;
+            nnz += inbr * inbc;
+          }
+        }
+        blocknnz[nblocks] = nnz;
+
+        A->matrix2->triplet = cs_spalloc(A->size0, A->size1, nnz > 0 ? nnz : 1, 1, 1);
+        CSparseMatrix* triplet = A->matrix2->triplet;
+
+        /* block rows are independent once the offsets are known */
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static) if(nnz > (size_t)(1 << 16))
+#endif
+        for(int cr = 0; cr < (int)B->filled1 - 1; ++cr)
+        {
+          unsigned int roffset = cr != 0 ? B->blocksize0[cr - 1] : 0;
+          unsigned int inbr = B->blocksize0[cr] - roffset;
+          for(size_t bn = B->index1_data[cr]; bn < B->index1_data[cr + 1]; ++bn)
+          {
+            size_t cc = B->index2_data[bn];
+            unsigned int coffset = cc != 0 ? B->blocksize1[cc - 1] : 0;
+            unsigned int inbc = B->blocksize1[cc] - coffset;
+            size_t pos = blocknnz[bn];
             for(unsigned j = 0; j < inbc; ++j)
             {
-              for(unsigned i = 0; i < inbr; ++i)
+              for(unsigned i = 0; i < inbr; ++i, ++pos)
               {
-                CHECK_RETURN(CSparseMatrix_entry(A->matrix2->triplet, i + roffset, j + coffset,
-                                                  A->matrix1->block[bn][i + j*inbr]));
+                triplet->i[pos] = (CS_INT)(i + roffset);
+                triplet->p[pos] = (CS_INT)(j + coffset);
+                triplet->x[pos] = B->block[bn][i + j * inbr];
               }
             }
           }
         }
+        triplet->nz = (CS_INT)nnz;
+        free(blocknnz);
+
         NSM_set_version(A->matrix2, NSM_TRIPLET, NM_version(A,
                                                             NM_SPARSE_BLOCK));
       }
       else if(A->matrix0)
       {
+        A->matrix2->triplet = cs_spalloc(0,0,1,1,1);
         /* version set in NM_dense_to_sparse */
         NM_dense_to_sparse(A, A, DBL_EPSILON);
       }
@@ -2947,6 +3392,10 @@ CSparseMatrix* NM_triplet(NumericsMatrix* A)
         fprintf(stderr, "NM_triplet: sparse matrix cannot be constructed.\n");
         exit(EXIT_FAILURE);
       }
+      else
+      {
+        A->matrix2->triplet = cs_spalloc(0,0,1,1,1);
+      }
       break;
     }
     case NM_SPARSE:
@@ -3169,13 +3618,38 @@ CSparseMatrix* NM_csc(NumericsMatrix *A)
 
 CSparseMatrix* NM_csc_trans(NumericsMatrix* A)
 {
-  if(!numericsSparseMatrix(A)->trans_csc)
+  /* refresh an out-of-date csc first; a rebuild drops the cached
+   * transpose through NM_clearCSCTranspose */
+  CSparseMatrix* csc = NM_csc(A);
+  assert(A->matrix2);
+  version_t csc_version = NSM_version(A->matrix2, NSM_CSC);
+
+  if(A->matrix2->trans_csc &&
+      NDV_value(&A->matrix2->trans_csc_version) != csc_version)
   {
-    assert(A->matrix2);
-    A->matrix2->trans_csc = cs_transpose(NM_csc(A), 1); /* value = 1
-                                                         * ->
-                                                         * allocation */
+    /* csc was updated in place: recompute the transpose, reusing the
+     * cached storage when it still fits */
+    if(A->matrix2->trans_csc->m == csc->n &&
+        A->matrix2->trans_csc->n == csc->m &&
+        A->matrix2->trans_csc->nzmax >= csc->p[csc->n])
+    {
+      CS_INT* work = (CS_INT*)malloc((size_t)csc->m * sizeof(CS_INT));
+      CSparseMatrix_transpose_workspace(csc, A->matrix2->trans_csc, work);
+      free(work);
+    }
+    else
+    {
+      NM_clearCSCTranspose(A);
+    }
+  }
+
+  if(!A->matrix2->trans_csc)
+  {
+    A->matrix2->trans_csc = cs_transpose(csc, 1); /* value = 1
+                                                   * ->
+                                                   * allocation */
   }
+  NDV_set_value(&A->matrix2->trans_csc_version, csc_version);
 
   return A->matrix2->trans_csc;
 }
@@ -3232,6 +3706,48 @@ CSparseMatrix* NM_csr(NumericsMatrix *A)
 }
 
 /* Numerics Matrix wrapper  for y <- alpha A x + beta y */
+/* Per-column nonzero pattern of the dense storage, used by NM_gemv and
+ * NM_tgemv to skip structurally zero columns.  Matrices assembled dense
+ * from single-contact interactions (MLCP, OSNS assembly) are often mostly
+ * empty but below the density where a sparse conversion pays off.  The
+ * pattern is recomputed on every call: much of the tree writes matrix0
+ * in place without going through NM_entry, so the version counter is not
+ * reliable for dense storage and cannot key a cache.  Only the buffer is
+ * kept in the internal data.  The scan leaves each nonzero column at its
+ * first nonzero entry, so it stays cheap exactly when the skip cannot pay
+ * off.  The number of nonzero columns is returned in nzcols. */
+static unsigned char* NM_dense_colNonzero(NumericsMatrix* A, size_t* nzcols)
+{
+  NumericsMatrixInternalData* internalData = NM_internalData(A);
+  size_t n = (size_t)A->size1;
+  size_t m = (size_t)A->size0;
+
+  if(internalData->colNonzeroSize != n || !internalData->colNonzero)
+  {
+    internalData->colNonzero = (unsigned char*)realloc(internalData->colNonzero, n * sizeof(unsigned char));
+    internalData->colNonzeroSize = n;
+  }
+  size_t count = 0;
+  for(size_t j = 0; j < n; ++j)
+  {
+    const double* col = &A->matrix0[j * m];
+    unsigned char nz = 0;
+    for(size_t i = 0; i < m; ++i)
+    {
+      if(col[i] != 0.0)
+      {
+        nz = 1;
+        break;
+      }
+    }
+    internalData->colNonzero[j] = nz;
+    count += nz;
+  }
+
+  *nzcols = count;
+  return internalData->colNonzero;
+}
+
 void NM_gemv(const double alpha, NumericsMatrix* A, const double *x,
              const double beta, double *y)
 {
@@ -3243,8 +3759,25 @@ void NM_gemv(const double alpha, NumericsMatrix* A, const double *x,
   {
   case NM_DENSE:
   {
-    cblas_dgemv(CblasColMajor, CblasNoTrans, A->size0, A->size1,
-                alpha, A->matrix0, A->size0, x, 1, beta, y, 1);
+    /* when enough columns are structurally zero, accumulate only the
+       nonzero ones instead of calling the full dgemv */
+    size_t nzcols = 0;
+    unsigned char* colnz = NM_dense_colNonzero(A, &nzcols);
+    if(4 * nzcols <= 3 * (size_t)A->size1)
+    {
+      if(beta == 0.0)
+        memset(y, 0, A->size0 * sizeof(double));
+      else if(beta != 1.0)
+        cblas_dscal(A->size0, beta, y, 1);
+      for(int j = 0; j < A->size1; ++j)
+      {
+        if(colnz[j] && x[j] != 0.0)
+          cblas_daxpy(A->size0, alpha * x[j], &A->matrix0[j * A->size0], 1, y, 1);
+      }
+    }
+    else
+      cblas_dgemv(CblasColMajor, CblasNoTrans, A->size0, A->size1,
+                  alpha, A->matrix0, A->size0, x, 1, beta, y, 1);
 
     break;
   }
@@ -3277,8 +3810,23 @@ void NM_tgemv(const double alpha, NumericsMatrix* A, const double *x,
   {
   case NM_DENSE:
   {
-    cblas_dgemv(CblasColMajor, CblasTrans, A->size0, A->size1,
-                alpha, A->matrix0, A->size0, x, 1, beta, y, 1);
+    /* same column pattern as NM_gemv: a structurally zero column only
+       contributes the beta scaling to its output entry */
+    size_t nzcols = 0;
+    unsigned char* colnz = NM_dense_colNonzero(A, &nzcols);
+    if(4 * nzcols <= 3 * (size_t)A->size1)
+    {
+      for(int j = 0; j < A->size1; ++j)
+      {
+        double yj = (beta == 0.0) ? 0.0 : beta * y[j];
+        if(colnz[j])
+          yj += alpha * cblas_ddot(A->size0, &A->matrix0[j * A->size0], 1, x, 1);
+        y[j] = yj;
+      }
+    }
+    else
+      cblas_dgemv(CblasColMajor, CblasTrans, A->size0, A->size1,
+                  alpha, A->matrix0, A->size0, x, 1, beta, y, 1);
     break;
   }
   case NM_SPARSE_BLOCK:
@@ -3747,6 +4295,7 @@ int NM_LU_factorize(NumericsMatrix* Ao)
 
   if (!NM_LU_factorized(Ao))
   {
+    NM_mem_check_budget();
     DEBUG_PRINT("NM_LU_factorize. The Factorization is performed\n");
 #ifdef FACTORIZATION_DEBUG
     if (NM_internalData(Ao)->values_sha1_count > 0)
@@ -3814,7 +4363,30 @@ int NM_LU_factorize(NumericsMatrix* Ao)
         CSparseMatrix_factors* cs_lu_A = (CSparseMatrix_factors*) malloc(sizeof(CSparseMatrix_factors));
         numerics_printf_verbose(2,"NM_LU_factorize, we compute factors and keep them" );
         //DEBUG_EXPR(cs_print(NM_csc(A),0));
-        info = !CSparseMatrix_lu_factorization(1, NM_csc(A), DBL_EPSILON, cs_lu_A);
+        CSparseMatrix* Acsc = NM_csc(A);
+        /* Reuse the cached symbolic analysis when the pattern is
+           unchanged (same dimension and same nnz), the common case in a
+           Newton loop over a fixed contact topology. */
+        if (p->symbolic_analysis
+            && p->symbolic_n == Acsc->n
+            && p->symbolic_nnz == Acsc->p[Acsc->n])
+        {
+          numerics_printf_verbose(2,"NM_LU_factorize, reusing cached symbolic analysis" );
+          info = !CSparseMatrix_lu_factorization_reuse_symbolic(Acsc, DBL_EPSILON,
+                                                                (css*)p->symbolic_analysis,
+                                                                cs_lu_A);
+        }
+        else
+        {
+          info = !CSparseMatrix_lu_factorization(1, Acsc, DBL_EPSILON, cs_lu_A);
+          if (!info)
+          {
+            if (p->symbolic_analysis) cs_sfree((css*)p->symbolic_analysis);
+            p->symbolic_analysis = CSparseMatrix_copy_lu_symbolic(cs_lu_A->S, Acsc->n);
+            p->symbolic_n = Acsc->n;
+            p->symbolic_nnz = Acsc->p[Acsc->n];
+          }
+        }
         if (info)
         {
           numerics_printf_verbose(2, "NM_LU_factorize: csparse factorization failed.");
@@ -3831,6 +4403,16 @@ int NM_LU_factorize(NumericsMatrix* Ao)
         }
         if(!NM_MUMPS_id(A)->job || (NM_MUMPS_id(A)->job == -2))
         {
+          if(NM_MUMPS_acquire_pooled_id(A))
+          {
+            /* a recycled instance with the same structure: its setup and
+               analysis are directly reusable, only the numerical
+               factorization remains to be done */
+            p->symbolic_n = (CS_INT)NM_MUMPS_id(A)->n;
+            p->symbolic_nnz = (CS_INT)NM_MUMPS_id(A)->nz;
+          }
+          else
+          {
           /* the mumps instance is initialized (call with job=-1) */
           NM_MUMPS_set_control_params(A);
           NM_MUMPS(A, -1);
@@ -3847,11 +4429,29 @@ int NM_LU_factorize(NumericsMatrix* Ao)
           }
           NM_MUMPS_set_icntl(A, 24, 1); // Null pivot row detection
           NM_MUMPS_set_cntl(A, 5, 1.e20); // Fixation, recommended value
-        }
+
+          /* fresh instance: any previous symbolic analysis is lost */
+          p->symbolic_n = 0;
+          p->symbolic_nnz = 0;
+          }
+        }
 
         NM_MUMPS_set_matrix(A);
 
-        NM_MUMPS(A, 4); /* analyzis,factorization */
+        /* The analysis is kept inside the MUMPS instance; when the
+           pattern is unchanged (same dimension and same nnz), run the
+           numeric factorization only. */
+        if(p->symbolic_n == (CS_INT)NM_MUMPS_id(A)->n
+            && p->symbolic_nnz == (CS_INT)NM_MUMPS_id(A)->nz)
+        {
+          NM_MUMPS(A, 2); /* factorization, reusing the analysis */
+        }
+        else
+        {
+          NM_MUMPS(A, 4); /* analyzis,factorization */
+          p->symbolic_n = (CS_INT)NM_MUMPS_id(A)->n;
+          p->symbolic_nnz = (CS_INT)NM_MUMPS_id(A)->nz;
+        }
 
         DMUMPS_STRUC_C* mumps_id = NM_MUMPS_id(A);
 
@@ -3955,19 +4555,27 @@ int NM_LU_solve(NumericsMatrix* Ao, double *b, unsigned int nrhs)
       case NSM_CSPARSE:
       {
 
-        if (!p->dWork)
+        /* the blocked multi-rhs solve needs a panel of up to
+         * CSPARSEMATRIX_NRHS_BLOCK columns as workspace */
+        unsigned int nb = nrhs < CSPARSEMATRIX_NRHS_BLOCK ? nrhs : CSPARSEMATRIX_NRHS_BLOCK;
+        int needed = A->size1 * (int)nb;
+        if (!p->dWork || p->dWorkSize < needed)
         {
-          assert(!NSM_workspace(p));
-          p->dWork = (double*) malloc(A->size1 * sizeof(double));
-          p->dWorkSize = A->size1;
+          free(p->dWork);
+          p->dWork = (double*) malloc(needed * sizeof(double));
+          p->dWorkSize = needed;
         };
 
 
         numerics_printf_verbose(2,"NM_LU_solve, using CSparse" );
         numerics_printf_verbose(2,"NM_LU_solve, we solve with given factors" );
-        for(unsigned int j=0; j < nrhs ; j++ )
+        if (nrhs == 1)
+        {
+          info = !CSparseMatrix_solve((CSparseMatrix_factors *)NSM_linear_solver_data(p), NSM_workspace(p), b);
+        }
+        else
         {
-          info = !CSparseMatrix_solve((CSparseMatrix_factors *)NSM_linear_solver_data(p), NSM_workspace(p), &b[j*A->size1]);
+          info = !CSparseMatrix_solve_multi((CSparseMatrix_factors *)NSM_linear_solver_data(p), NSM_workspace(p), b, (CS_INT)nrhs);
         }
         if (info < 0)
         {
@@ -4032,6 +4640,235 @@ int NM_LU_solve(NumericsMatrix* Ao, double *b, unsigned int nrhs)
 
   return info;
 }
+
+int NM_LU_solve_trans(NumericsMatrix* Ao, double *b, unsigned int nrhs)
+{
+
+  lapack_int info = 1;
+
+  /* factorization is done on destructible part only if
+   * !A->internalData->isLUfactorized */
+  NM_LU_factorize(Ao);
+
+  /* get the destructible part of the matrix */
+  NumericsMatrix *A = Ao->destructible;
+
+  if (NM_LU_factorized(A))
+  {
+
+    DEBUG_BEGIN("NM_LU_solve_trans(NumericsMatrix* A, double *b, unsigned int nrhs)\n");
+    assert(A->size0 == A->size1);
+
+    switch (A->storageType)
+    {
+    case NM_DENSE:
+    {
+      assert(A->matrix0);
+
+      numerics_printf_verbose(2, "NM_LU_solve_trans, using LAPACK" );
+
+      /* dgetrf is called in NM_LU_factorize */
+      lapack_int* ipiv = (lapack_int*)NM_iWork(A, A->size0, sizeof(lapack_int));
+
+      DGETRS(LA_TRANS, A->size0, nrhs, A->matrix0, A->size0, ipiv, b, A->size0, &info);
+
+      if (info < 0)
+      {
+        numerics_printf_verbose(2,"NM_LU_solve_trans: dense LU solve DGETRS failed. The %d-th argument has an illegal value\n", -info);
+      }
+      break;
+    }
+
+    case NM_SPARSE_BLOCK: /* sparse block -> triplet -> csc */
+    case NM_SPARSE:
+    {
+      NSM_linear_solver_params* p = NSM_linearSolverParams(A);
+      switch (p->solver)
+      {
+      case NSM_CSPARSE:
+      {
+
+        if (!p->dWork)
+        {
+          assert(!NSM_workspace(p));
+          p->dWork = (double*) malloc(A->size1 * sizeof(double));
+          p->dWorkSize = A->size1;
+        };
+
+        numerics_printf_verbose(2,"NM_LU_solve_trans, using CSparse" );
+        numerics_printf_verbose(2,"NM_LU_solve_trans, we solve with given factors" );
+        for(unsigned int j=0; j < nrhs ; j++ )
+        {
+          info = !CSparseMatrix_solve_trans((CSparseMatrix_factors *)NSM_linear_solver_data(p), NSM_workspace(p), &b[j*A->size1]);
+        }
+        break;
+      }
+#ifdef WITH_MUMPS
+      case NSM_MUMPS:
+      {
+        if(verbose >= 2)
+        {
+          printf("NM_LU_solve_trans: using MUMPS\n");
+        }
+
+        assert (NM_MUMPS_id(A)->job); /* this means that least a
+                                       * factorization has already been
+                                       * done */
+
+        DMUMPS_STRUC_C* mumps_id = NM_MUMPS_id(A);
+
+        NM_MUMPS_set_icntl(A, 9, 0); /* solve with the transposed matrix */
+        NM_MUMPS_set_dense_rhs(A, nrhs, b);
+
+        NM_MUMPS(A, 3); /* solve */
+        info = mumps_id->info[0];
+        NM_MUMPS_set_icntl(A, 9, 1); /* restore the default */
+
+        if(info)
+        {
+          if(verbose > 0)
+          {
+            fprintf(stderr,"NM_LU_solve_trans: MUMPS fails : info(1)=%d, info(2)=%d\n", info, mumps_id->info[1]);
+          }
+        }
+        break;
+      }
+#endif /* WITH_MUMPS */
+      default:
+      {
+        fprintf(stderr, "NM_LU_solve_trans: unknown sparse linearsolver %d\n", p->solver);
+        exit(EXIT_FAILURE);
+      }
+      break;
+      }
+      break;
+    }
+    default:
+      assert (0 && "NM_LU_solve_trans unknown storageType");
+    }
+
+    DEBUG_END("NM_LU_solve_trans(NumericsMatrix* A, double *b, unsigned int nrhs)\n");
+  }
+
+  return info;
+}
+
+int NM_LU_solve_mixed(NumericsMatrix* Ao, double *b, unsigned int nrhs)
+{
+  assert(Ao->destructible); /* by default Ao->destructible == Ao */
+  NumericsMatrix* A = Ao->destructible;
+
+  /* the single precision factorization is only available with LAPACK on
+   * the dense storage; sparse storages, and matrices already factorized
+   * in double, go through the usual solve */
+  if (A->storageType != NM_DENSE || NM_LU_factorized(Ao))
+    return NM_LU_solve(Ao, b, nrhs);
+
+  DEBUG_BEGIN("NM_LU_solve_mixed(NumericsMatrix* A, double *b, unsigned int nrhs)\n");
+  assert(A->matrix0);
+  assert(A->size0 == A->size1);
+
+  lapack_int info = 0;
+  lapack_int n = (lapack_int)A->size0;
+  NumericsMatrixInternalData* internalData = NM_internalData(A);
+  lapack_int* ipiv = (lapack_int*)NM_iWork(A, A->size0, sizeof(lapack_int));
+
+  if (!internalData->isSLUfactorized)
+  {
+    numerics_printf_verbose(2,"NM_LU_solve_mixed, using LAPACK (SGETRF)" );
+    size_t nn = (size_t)A->size0 * (size_t)A->size1;
+    if (!internalData->sWork || internalData->sWorkSize < nn)
+    {
+      internalData->sWork = (float*)realloc(internalData->sWork, nn * sizeof(float));
+      internalData->sWorkSize = nn;
+    }
+    for (size_t i = 0; i < nn; ++i)
+      internalData->sWork[i] = (float)A->matrix0[i];
+
+    SGETRF(n, n, internalData->sWork, n, ipiv, &info);
+    if (info)
+    {
+      /* singular to single precision: full double factorization */
+      numerics_printf_verbose(1,"NM_LU_solve_mixed: SGETRF failed (info = %d), falling back to double precision", (int)info);
+      return NM_LU_solve(Ao, b, nrhs);
+    }
+    internalData->isSLUfactorized = true;
+  }
+
+  double* x = (double*)malloc(A->size0 * sizeof(double));
+  double* r = (double*)malloc(A->size0 * sizeof(double));
+  float* rs = (float*)malloc(A->size0 * sizeof(float));
+
+  /* infinity norm of A, for the stopping test */
+  double anorm = 0.0;
+  for (int i = 0; i < A->size0; ++i)
+  {
+    double s = 0.0;
+    for (int j = 0; j < A->size1; ++j)
+      s += fabs(A->matrix0[i + j*A->size0]);
+    if (s > anorm) anorm = s;
+  }
+
+  for (unsigned int k = 0; k < nrhs; ++k)
+  {
+    double* bk = &b[k * A->size1];
+
+    /* first solve, entirely in single precision */
+    for (int i = 0; i < n; ++i) rs[i] = (float)bk[i];
+    SGETRS(LA_NOTRANS, n, 1, internalData->sWork, n, ipiv, rs, n, &info);
+    for (int i = 0; i < n; ++i) x[i] = (double)rs[i];
+
+    /* iterative refinement: residuals and updates in double, the
+     * triangular solves in single */
+    double rnorm_prev = DBL_MAX;
+    bool refined = false;
+    for (int it = 0; it < 10 && !info; ++it)
+    {
+      cblas_dcopy(n, bk, 1, r, 1);
+      cblas_dgemv(CblasColMajor, CblasNoTrans, n, n, -1.0, A->matrix0, n, x, 1, 1.0, r, 1);
+
+      double rnorm = 0.0, xnorm = 0.0;
+      for (int i = 0; i < n; ++i)
+      {
+        if (fabs(r[i]) > rnorm) rnorm = fabs(r[i]);
+        if (fabs(x[i]) > xnorm) xnorm = fabs(x[i]);
+      }
+      if (rnorm <= 2.0 * n * DBL_EPSILON * (anorm * xnorm + 1.0))
+      {
+        refined = true;
+        break;
+      }
+      if (rnorm >= 0.5 * rnorm_prev) break; /* stalled */
+      rnorm_prev = rnorm;
+
+      for (int i = 0; i < n; ++i) rs[i] = (float)r[i];
+      SGETRS(LA_NOTRANS, n, 1, internalData->sWork, n, ipiv, rs, n, &info);
+      for (int i = 0; i < n; ++i) x[i] += (double)rs[i];
+    }
+
+    if (!refined || info)
+    {
+      /* the matrix is too ill-conditioned for a float factorization:
+       * redo everything in double (this overwrites ipiv, so the float
+       * factors are dropped) */
+      numerics_printf_verbose(1,"NM_LU_solve_mixed: refinement stalled, falling back to double precision");
+      internalData->isSLUfactorized = false;
+      free(x);
+      free(r);
+      free(rs);
+      return NM_LU_solve(Ao, bk, nrhs - k);
+    }
+
+    cblas_dcopy(n, x, 1, bk, 1);
+  }
+
+  free(x);
+  free(r);
+  free(rs);
+  DEBUG_END("NM_LU_solve_mixed(NumericsMatrix* A, double *b, unsigned int nrhs)\n");
+  return 0;
+}
+
 int NM_LU_solve_matrix_rhs(NumericsMatrix* Ao, NumericsMatrix* B)
 {
 
@@ -4247,6 +5084,74 @@ NumericsMatrix* NM_LU_inv(NumericsMatrix* A)
 
 }
 
+/* wall clock for the NSM_AUTO backend benchmark, in seconds */
+static double NM_benchmark_now(void)
+{
+#ifdef _WIN32
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+/* Benchmark-guided backend selection for NSM_AUTO: time one full
+ * analysis + factorization + solve with every backend compiled in, on a
+ * copy of the right-hand side, and replace p->solver by the winner.
+ * Backend ranking depends strongly on the sparsity structure, so the
+ * choice made on the first solve is kept for the whole life of the
+ * matrix (same structure). */
+static void NM_gesv_autoselect(NumericsMatrix* A, double* b)
+{
+  static const NSM_linear_solver candidates[] =
+  {
+    NSM_CSPARSE,
+#ifdef WITH_MUMPS
+    NSM_MUMPS,
+#endif
+#ifdef WITH_UMFPACK
+    NSM_UMFPACK,
+#endif
+#ifdef WITH_SUPERLU
+    NSM_SUPERLU,
+#endif
+#ifdef WITH_SUPERLU_MT
+    NSM_SUPERLU_MT,
+#endif
+#ifdef WITH_MKL_PARDISO
+    NSM_MKL_PARDISO,
+#endif
+  };
+  size_t nb_candidates = sizeof(candidates) / sizeof(candidates[0]);
+
+  NSM_linear_solver_params* p = NSM_linearSolverParams(A);
+  double* btmp = (double*)malloc((size_t)A->size0 * sizeof(double));
+  NSM_linear_solver best = candidates[0];
+  double best_time = DBL_MAX;
+
+  for(size_t k = 0; k < nb_candidates; ++k)
+  {
+    cblas_dcopy(A->size0, b, 1, btmp, 1);
+    p->solver = candidates[k];
+    double t0 = NM_benchmark_now();
+    int cinfo = NM_gesv_expert(A, btmp, NM_NONE);
+    double elapsed = NM_benchmark_now() - t0;
+    numerics_printf_verbose(1, "NM_gesv: NSM_AUTO candidate %d: %g s (info = %d)",
+                            candidates[k], elapsed, cinfo);
+    if(cinfo == 0 && elapsed < best_time)
+    {
+      best_time = elapsed;
+      best = candidates[k];
+    }
+  }
+  free(btmp);
+
+  /* sticks for all subsequent solves on this matrix */
+  p->solver = best;
+  numerics_printf_verbose(1, "NM_gesv: NSM_AUTO selected backend %d", best);
+}
+
 int NM_gesv_expert(NumericsMatrix* A, double *b, unsigned keep)
 {
 
@@ -4335,6 +5240,14 @@ int NM_gesv_expert(NumericsMatrix* A, double *b, unsigned keep)
   case NM_SPARSE:
   {
     NSM_linear_solver_params* p = NSM_linearSolverParams(A);
+
+    if(p->solver == NSM_AUTO)
+    {
+      /* benchmark once, then solve below with the selected backend
+         under the requested keep mode */
+      NM_gesv_autoselect(A, b);
+    }
+
     switch(p->solver)
     {
     case NSM_CSPARSE:
@@ -5558,6 +6471,7 @@ int NM_Cholesky_factorize(NumericsMatrix* Ao)
 
   if (!NM_Cholesky_factorized(Ao))
   {
+    NM_mem_check_budget();
 
 #ifdef FACTORIZATION_DEBUG
     if (NM_internalData(Ao)->values_sha1_count > 0)
@@ -5829,6 +6743,137 @@ int NM_Cholesky_solve(NumericsMatrix* Ao, double *b, unsigned int nrhs)
   return info;
 }
 
+int NM_Cholesky_refactorize(NumericsMatrix* Ao)
+{
+  DEBUG_BEGIN("int NM_Cholesky_refactorize(NumericsMatrix* Ao)\n");
+  lapack_int info = 1;
+  NumericsMatrix* A = Ao->destructible;
+
+  if(!NM_Cholesky_factorized(Ao))
+    return NM_Cholesky_factorize(Ao);
+
+  switch(A->storageType)
+  {
+  case NM_DENSE:
+  {
+    /* the in-place DPOTRF factorization left nothing of the previous
+       factor to reuse: redo a plain factorization */
+    NM_internalData(A)->isCholeskyfactorized = false;
+    return NM_Cholesky_factorize(Ao);
+  }
+  case NM_SPARSE_BLOCK:
+  case NM_SPARSE:
+  {
+    NSM_linear_solver_params* p = NSM_linearSolverParams(A);
+    switch(p->solver)
+    {
+    case NSM_CSPARSE:
+      numerics_printf_verbose(2, "NM_Cholesky_refactorize, using CSparse (chol_refactorization)");
+      info = !CSparseMatrix_chol_refactorization(NM_csc(A),
+                                                 (CSparseMatrix_factors*)NSM_linear_solver_data(p));
+      if(info)
+        numerics_printf_verbose(2, "NM_Cholesky_refactorize: csparse refactorization failed.");
+      break;
+#ifdef WITH_MUMPS
+    case NSM_MUMPS:
+    {
+      if(verbose >= 2)
+        printf("NM_Cholesky_refactorize: using MUMPS\n");
+      NM_MUMPS_set_matrix(A);
+      NM_MUMPS(A, 2); /* numerical factorization only, the analysis is kept */
+      info = NM_MUMPS_id(A)->info[0];
+      break;
+    }
+#endif /* WITH_MUMPS */
+    default:
+    {
+      numerics_printf_verbose(0, "NM_Cholesky_refactorize, Unknown solver in NM_SPARSE case.");
+      info = 1;
+    }
+    }
+    break;
+  }
+  default:
+    assert(0 && "NM_Cholesky_refactorize: unknown storageType");
+  }
+
+  if(info)
+    NM_internalData(A)->isCholeskyfactorized = false;
+  DEBUG_END("int NM_Cholesky_refactorize(NumericsMatrix* Ao)\n");
+  return info;
+}
+
+int NM_Cholesky_rank_update(NumericsMatrix* Ao, const double* w, int sigma)
+{
+  assert(sigma == 1 || sigma == -1);
+  NumericsMatrix* A = Ao->destructible;
+  lapack_int info = 1;
+
+  if(!NM_Cholesky_factorized(Ao))
+  {
+    numerics_warning("NM_Cholesky_rank_update", "the matrix is not factorized");
+    return info;
+  }
+
+  switch(A->storageType)
+  {
+  case NM_DENSE:
+  {
+    /* Givens (update) / hyperbolic (downdate) sweeps on the upper
+       factor R left in place by DPOTRF: R'^T R' = R^T R + sigma w w^T */
+    int n = A->size0;
+    double* R = A->matrix0;
+    double* v = (double*)malloc(n * sizeof(double));
+    memcpy(v, w, n * sizeof(double));
+    info = 0;
+    for(int k = 0; k < n; ++k)
+    {
+      double Rkk = R[k + k * n];
+      double r2 = Rkk * Rkk + sigma * v[k] * v[k];
+      if(r2 <= 0.)
+      {
+        /* the downdated matrix is not positive definite */
+        info = 1;
+        break;
+      }
+      double r = sqrt(r2);
+      double c = r / Rkk;
+      double s = v[k] / Rkk;
+      R[k + k * n] = r;
+      for(int j = k + 1; j < n; ++j)
+      {
+        R[k + j * n] = (R[k + j * n] + sigma * s * v[j]) / c;
+        v[j] = c * v[j] - s * R[k + j * n];
+      }
+    }
+    free(v);
+    break;
+  }
+  case NM_SPARSE_BLOCK:
+  case NM_SPARSE:
+  {
+    NSM_linear_solver_params* p = NSM_linearSolverParams(A);
+    switch(p->solver)
+    {
+    case NSM_CSPARSE:
+      info = !CSparseMatrix_chol_updown((CSparseMatrix_factors*)NSM_linear_solver_data(p),
+                                        sigma, w);
+      break;
+    default:
+      numerics_printf_verbose(0, "NM_Cholesky_rank_update, Unknown solver in NM_SPARSE case.");
+      info = 1;
+    }
+    break;
+  }
+  default:
+    assert(0 && "NM_Cholesky_rank_update: unknown storageType");
+  }
+
+  if(info)
+    numerics_printf_verbose(2, "NM_Cholesky_rank_update: update rejected, refactorize instead");
+  return info;
+}
+
 int NM_Cholesky_solve_matrix_rhs(NumericsMatrix* Ao, NumericsMatrix* B)
 {
 
@@ -5966,6 +7011,7 @@ int NM_LDLT_factorize(NumericsMatrix* Ao)
 
   if (!NM_LDLT_factorized(Ao))
   {
+    NM_mem_check_budget();
 
 #ifdef FACTORIZATION_DEBUG
     if (NM_internalData(Ao)->values_sha1_count > 0)
@@ -50,10 +50,19 @@ typedef struct
   size_t sizeof_elt ; /**< sizeof_elt of an element in bytes (result of sizeof for instance)*/
   size_t dWorkSize; /**< size of dWork */
   double *dWork; /**< double workspace */
+  size_t sWorkSize; /**< size of sWork */
+  float *sWork; /**< single precision workspace (LU factors of the mixed-precision solve) */
   bool isLUfactorized; /**<  true if the matrix has already been LU-factorized */
+  bool isSLUfactorized; /**<  true if sWork holds single precision LU factors */
   bool isCholeskyfactorized; /**<  true if the matrix has already been Cholesky factorized */
   bool isLDLTfactorized; /**<  true if the matrix has already been LDLT factorized */
   bool isInversed; /**<  true if the matrix contains its inverse (in place inversion) */
+  unsigned char *colNonzero; /**< per-column nonzero pattern of the dense
+                              * storage, workspace of NM_gemv/NM_tgemv for
+                              * skipping the structurally zero columns of
+                              * mostly-empty dense matrices; recomputed on
+                              * each product */
+  size_t colNonzeroSize; /**< number of columns covered by colNonzero */
 #ifdef SICONOS_HAS_MPI
   MPI_Comm mpi_comm; /**< optional mpi communicator */
 #endif
@@ -235,6 +244,126 @@ extern "C"
    */
   CSparseMatrix* NM_csr(NumericsMatrix *A);
 
+  /**\enum NM_reorder_method NumericsMatrix.h
+   * available orderings for NM_reorder */
+  typedef enum { NM_REORDER_AMD, NM_REORDER_RCM } NM_reorder_method;
+
+  /** Reorder a square sparse matrix symmetrically, A <- A(p,p), with a
+   *  fill/bandwidth reducing permutation p (AMD from CXSparse or reverse
+   *  Cuthill-McKee), so that the iterative solvers sweep the matrix with
+   *  better locality. The permutation is kept in
+   *  A->matrix2->reorder_perm: use NM_reorder_rhs() to carry a right hand
+   *  side into the new ordering and NM_reorder_solution() to return a
+   *  solution in the original one.
+   *
+   *  \param[in,out] A a square NumericsMatrix with NM_SPARSE storage
+   *  \param method the ordering, NM_REORDER_AMD or NM_REORDER_RCM
+   *  \return 0 on success, 1 if no permutation could be computed (the
+   *          matrix is then left untouched)
+   */
+  int NM_reorder(NumericsMatrix* A, NM_reorder_method method);
+
+  /** Permute a right hand side into the ordering of a matrix reordered by
+   *  NM_reorder, pb[i] = b[p[i]].
+   *
+   *  \param[in] A a NumericsMatrix reordered by NM_reorder
+   *  \param[in] b the right hand side in the original ordering (size n)
+   *  \param[out] pb the right hand side in the matrix ordering (size n)
+   */
+  void NM_reorder_rhs(const NumericsMatrix* A, const double* b, double* pb);
+
+  /** Permute a solution computed in the ordering of a matrix reordered by
+   *  NM_reorder back to the original ordering, x[p[i]] = px[i].
+   *
+   *  \param[in] A a NumericsMatrix reordered by NM_reorder
+   *  \param[in] px the solution in the matrix ordering (size n)
+   *  \param[out] x the solution in the original ordering (size n)
+   */
+  void NM_reorder_solution(const NumericsMatrix* A, const double* px, double* x);
+
+  /**\enum NM_mem_tag NumericsMatrix.h
+   * categories of memory held by a NumericsMatrix, for the accounting API */
+  typedef enum
+  {
+    NM_MEM_DENSE,     /**< dense storage (matrix0) */
+    NM_MEM_SPARSE,    /**< sparse block and CSparse storages */
+    NM_MEM_FACTORS,   /**< cached factorizations (CSparse solver only; memory
+                       * held inside external solvers is not visible here) */
+    NM_MEM_WORKSPACE, /**< internal and linear solver work arrays */
+    NM_MEM_NB_TAGS
+  } NM_mem_tag;
+
+  /** Number of bytes held by a matrix in one category.
+   *
+   *  \param A a NumericsMatrix
+   *  \param tag the category, see NM_mem_tag
+   *  \return the size in bytes
+   */
+  size_t NM_sizeof_tag(const NumericsMatrix* A, NM_mem_tag tag);
+
+  /** Number of bytes held by a matrix, all categories together.
+   *
+   *  \param A a NumericsMatrix
+   *  \return the size in bytes
+   */
+  size_t NM_sizeof(const NumericsMatrix* A);
+
+  /** Number of bytes held in one category by all the matrices currently
+   *  alive (allocated with NM_new and not yet freed).
+   *
+   *  \param tag the category, see NM_mem_tag
+   *  \return the size in bytes
+   */
+  size_t NM_mem_bytes(NM_mem_tag tag);
+
+  /** Number of bytes held by all the matrices currently alive.
+   *
+   *  \return the size in bytes
+   */
+  size_t NM_mem_total(void);
+
+  /** Print the per-category memory usage of all the matrices currently
+   *  alive, when verbose is on.
+   */
+  void NM_mem_report(void);
+
+  /** Callback invoked by NM_mem_check_budget() when the total memory
+   *  held by NumericsMatrix objects exceeds the budget. A typical
+   *  callback calls NM_mem_evict_factors() to drop cached
+   *  factorizations instead of running out of memory.
+   *
+   *  \param total the current total in bytes
+   *  \param budget the budget in bytes
+   *  \param user_data the pointer given to NM_mem_set_budget()
+   */
+  typedef void (*NM_mem_budget_cb)(size_t total, size_t budget, void* user_data);
+
+  /** Set a memory budget for all NumericsMatrix objects. The budget is
+   *  checked before each factorization; give a zero budget or a NULL
+   *  callback to disable the check.
+   *
+   *  \param budget the budget in bytes
+   *  \param callback function called when the budget is exceeded
+   *  \param user_data opaque pointer passed to the callback
+   */
+  void NM_mem_set_budget(size_t budget, NM_mem_budget_cb callback, void* user_data);
+
+  /** Invoke the budget callback if the total memory held by
+   *  NumericsMatrix objects exceeds the budget. Called before each
+   *  factorization; it may also be called at any user checkpoint.
+   */
+  void NM_mem_check_budget(void);
+
+  /** Free the cached factorizations and linear solver workspaces of all
+   *  the matrices currently alive, except the one given. The matrices
+   *  stay valid and are simply refactorized on their next solve.
+   *
+   *  \param keep a matrix to spare, e.g. the one about to be solved
+   *         with, or NULL to evict everything
+   *  \return the number of matrices whose factors were freed
+   */
+  unsigned int NM_mem_evict_factors(const NumericsMatrix* keep);
+
   /** fill an existing NumericsMatrix struct
    *
    *  \param[in,out] M the struct to fill
@@ -864,11 +993,80 @@ extern "C"
    *  \return 0 if the solve succeeded.
    */
   int NM_LU_solve(NumericsMatrix* A,  double *b, unsigned int nrhs);
+
+  /** Solve the transposed linear system A^T x = b with multiple right
+   *  hand sides, reusing the LU factorization of A. A call to
+   *  NM_LU_factorize is done at the beginning.
+
+   *  \param[in] A the NumericsMatrix. A is not destroyed if it has
+   *  been preserved by a call to NM_preserve(A).
+
+   *  \param[in,out] b the right hand size which is a pointer on a
+   *  matrix of double. It is replaced by the solutions
+
+   *  \param[in] nrhs the number of right hand side.
+   *  \return 0 if the solve succeeded.
+   */
+  int NM_LU_solve_trans(NumericsMatrix* A, double *b, unsigned int nrhs);
+
+  /** Solve linear system with multiple right hand sides, using a single
+   *  precision LU factorization refined to double precision accuracy
+   *  (mixed-precision iterative refinement). The float factorization is
+   *  roughly twice as fast as DGETRF and takes half the memory; the
+   *  matrix itself is kept in double and left untouched, since it is
+   *  needed to compute the refinement residuals. Dense storage only: for
+   *  sparse storages, or when the matrix is already factorized in
+   *  double, this is a plain call to NM_LU_solve. When the matrix is
+   *  singular to single precision or the refinement stalls (the matrix
+   *  is too ill-conditioned for a float factorization), the method falls
+   *  back to the full double precision solve.
+
+   *  \param[in] A the NumericsMatrix.
+
+   *  \param[in,out] b the right hand side which is a pointer on a
+   *  matrix of double. It is replaced by the solutions
+
+   *  \param[in] nrhs the number of right hand sides.
+   *  \return 0 if the solve succeeded.
+   */
+  int NM_LU_solve_mixed(NumericsMatrix* A, double *b, unsigned int nrhs);
   int NM_LU_solve_matrix_rhs(NumericsMatrix* Ao, NumericsMatrix* B);
   int NM_Cholesky_solve(NumericsMatrix* A,  double *b, unsigned int nrhs);
   int NM_Cholesky_solve_matrix_rhs(NumericsMatrix* Ao, NumericsMatrix* B);
   int NM_LDLT_solve(NumericsMatrix* A,  double *b, unsigned int nrhs);
 
+  /** Redo the Cholesky factorization of an SPD matrix whose values
+   *  changed but whose sparsity pattern did not (the typical case is a
+   *  diagonal shift when the ADMM rho is adapted, or a few refreshed
+   *  blocks of an iteration matrix): the symbolic analysis of the first
+   *  NM_Cholesky_factorize call (ordering, elimination tree, column
+   *  counts) is reused and only the numerical factorization is redone.
+   *  Falls back on a plain factorization when the matrix is not
+   *  factorized yet, or for the dense storage whose in-place
+   *  factorization keeps nothing reusable.
+   *
+   *  \param[in] A the NumericsMatrix, with its values updated in place
+   *  \return 0 if the matrix has been factorized
+   */
+  int NM_Cholesky_refactorize(NumericsMatrix* A);
+
+  /** Rank-one update (sigma = +1) or downdate (sigma = -1) of the
+   *  Cholesky factors of A: on success the stored factors are those of
+   *  A + sigma w w^T and subsequent NM_Cholesky_solve calls solve with
+   *  the updated matrix. The matrix entries themselves are not modified.
+   *  With sparse storage the update is only accepted when the pattern of
+   *  w fits in the pattern of the factor (no fill may be created); when
+   *  the call returns a failure the caller is expected to update the
+   *  matrix values and use NM_Cholesky_refactorize instead.
+   *
+   *  \param[in] A the NumericsMatrix, already factorized by
+   *  NM_Cholesky_factorize
+   *  \param[in] w dense vector of size A->size0
+   *  \param[in] sigma +1 for an update, -1 for a downdate
+   *  \return 0 if the factors have been updated
+   */
+  int NM_Cholesky_rank_update(NumericsMatrix* A, const double* w, int sigma);
+
 
   int NM_gesv_expert(NumericsMatrix* A, double *b, unsigned keep);
   int NM_posv_expert(NumericsMatrix* A, double *b, unsigned keep);
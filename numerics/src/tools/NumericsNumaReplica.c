@@ -0,0 +1,289 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NumericsNumaReplica.h"
+
+#include <stdlib.h>                   // for calloc, free, NULL
+#include <string.h>                   // for memcpy
+
+#include "FrictionContactProblem.h"   // for FrictionContactProblem
+#include "NumericsArena.h"            // for numerics_arena_alloc
+#include "NumericsDataVersion.h"      // for NDV_value
+#include "NumericsExecutionPolicy.h"  // for numerics_execution_policy
+#include "NumericsMatrix.h"           // for NumericsMatrix, NM_SPARSE_BLOCK
+#include "SparseBlockMatrix.h"        // for SparseBlockStructuredMatrix
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+unsigned int numerics_numa_nodes(void)
+{
+  unsigned int nnodes = numerics_execution_policy()->numa_nodes;
+#ifdef _OPENMP
+  unsigned int nthreads = (unsigned int)omp_get_max_threads();
+  if(nnodes > nthreads) nnodes = nthreads;
+#else
+  nnodes = 1;
+#endif
+  return nnodes;
+}
+
+/* thread -> node map: contiguous thread ranges share a node, matching a
+   compact binding where consecutive threads sit on the same socket */
+static inline unsigned int numa_node_of(int tid, unsigned int nnodes,
+                                        unsigned int nthreads)
+{
+  unsigned int node = (unsigned int)((size_t)tid * nnodes / nthreads);
+  return node < nnodes ? node : nnodes - 1;
+}
+
+static inline int numa_is_first_of_node(int tid, unsigned int node,
+                                        unsigned int nnodes,
+                                        unsigned int nthreads)
+{
+  return numa_node_of(tid, nnodes, nthreads) == node
+         && (tid == 0 || numa_node_of(tid - 1, nnodes, nthreads) != node);
+}
+
+/* total scalar entries of the stored blocks of W */
+static size_t numa_payload_size(const SparseBlockStructuredMatrix* W)
+{
+  size_t payload = 0;
+  for(unsigned int row = 0; row < W->filled1 - 1; ++row)
+  {
+    size_t nrows = W->blocksize0[row] - (row ? W->blocksize0[row - 1] : 0);
+    for(size_t blockNum = W->index1_data[row];
+        blockNum < W->index1_data[row + 1]; ++blockNum)
+    {
+      size_t col = W->index2_data[blockNum];
+      payload += nrows * (W->blocksize1[col] - (col ? W->blocksize1[col - 1] : 0));
+    }
+  }
+  return payload;
+}
+
+/* Build the replica of one node inside its arena. Called by a thread of
+   that node so that the pages are first-touched locally. */
+static FrictionContactProblem* numa_replica_build(struct NumericsArena* arena,
+                                                  FrictionContactProblem* problem,
+                                                  size_t payload)
+{
+  SparseBlockStructuredMatrix* W = problem->M->matrix1;
+  unsigned int nc = (unsigned int)problem->numberOfContacts;
+  unsigned int n = (unsigned int)(nc * problem->dimension);
+
+  SparseBlockStructuredMatrix* C = (SparseBlockStructuredMatrix*)
+    numerics_arena_calloc(arena, 1, sizeof(SparseBlockStructuredMatrix));
+  C->nbblocks = W->nbblocks;
+  C->blocknumber0 = W->blocknumber0;
+  C->blocknumber1 = W->blocknumber1;
+  C->filled1 = W->filled1;
+  C->filled2 = W->filled2;
+
+  C->blocksize0 = (unsigned int*)
+    numerics_arena_alloc(arena, W->blocknumber0 * sizeof(unsigned int));
+  memcpy(C->blocksize0, W->blocksize0, W->blocknumber0 * sizeof(unsigned int));
+  C->blocksize1 = (unsigned int*)
+    numerics_arena_alloc(arena, W->blocknumber1 * sizeof(unsigned int));
+  memcpy(C->blocksize1, W->blocksize1, W->blocknumber1 * sizeof(unsigned int));
+
+  C->index1_data = (size_t*)numerics_arena_alloc(arena, W->filled1 * sizeof(size_t));
+  memcpy(C->index1_data, W->index1_data, W->filled1 * sizeof(size_t));
+  C->index2_data = (size_t*)numerics_arena_alloc(arena, W->filled2 * sizeof(size_t));
+  memcpy(C->index2_data, W->index2_data, W->filled2 * sizeof(size_t));
+
+  /* the diagonal cache was forced on the source before replication, so
+     no worker ever builds it lazily (and racily) on a replica */
+  C->diagonal_blocks = (unsigned int*)
+    numerics_arena_alloc(arena, W->blocknumber0 * sizeof(unsigned int));
+  memcpy(C->diagonal_blocks, W->diagonal_blocks,
+         W->blocknumber0 * sizeof(unsigned int));
+
+  /* one compact payload, with the block pointers rebuilt inside it */
+  C->block_arena = (double*)numerics_arena_alloc(arena, payload * sizeof(double));
+  C->block = (double**)numerics_arena_alloc(arena, W->nbblocks * sizeof(double*));
+  size_t offset = 0;
+  for(unsigned int row = 0; row < W->filled1 - 1; ++row)
+  {
+    size_t nrows = W->blocksize0[row] - (row ? W->blocksize0[row - 1] : 0);
+    for(size_t blockNum = W->index1_data[row];
+        blockNum < W->index1_data[row + 1]; ++blockNum)
+    {
+      size_t col = W->index2_data[blockNum];
+      size_t nb = nrows * (W->blocksize1[col] - (col ? W->blocksize1[col - 1] : 0));
+      C->block[blockNum] = C->block_arena + offset;
+      offset += nb;
+    }
+  }
+  C->version = W->version;
+
+  NumericsMatrix* M = (NumericsMatrix*)
+    numerics_arena_calloc(arena, 1, sizeof(NumericsMatrix));
+  M->storageType = NM_SPARSE_BLOCK;
+  M->size0 = (int)n;
+  M->size1 = (int)n;
+  M->matrix1 = C;
+
+  FrictionContactProblem* replica = (FrictionContactProblem*)
+    numerics_arena_calloc(arena, 1, sizeof(FrictionContactProblem));
+  replica->dimension = problem->dimension;
+  replica->numberOfContacts = problem->numberOfContacts;
+  replica->M = M;
+  replica->q = (double*)numerics_arena_alloc(arena, n * sizeof(double));
+  replica->mu = (double*)numerics_arena_alloc(arena, nc * sizeof(double));
+  return replica;
+}
+
+/* copy the current values into an existing replica */
+static void numa_replica_refresh(FrictionContactProblem* replica,
+                                 FrictionContactProblem* problem,
+                                 size_t payload, int copy_W)
+{
+  unsigned int nc = (unsigned int)problem->numberOfContacts;
+  unsigned int n = (unsigned int)(nc * problem->dimension);
+  if(copy_W)
+  {
+    SparseBlockStructuredMatrix* W = problem->M->matrix1;
+    SparseBlockStructuredMatrix* C = replica->M->matrix1;
+    if(W->block_arena)
+      memcpy(C->block_arena, W->block_arena, payload * sizeof(double));
+    else
+    {
+      /* scattered source blocks: copy block by block */
+      for(unsigned int row = 0; row < W->filled1 - 1; ++row)
+      {
+        size_t nrows = W->blocksize0[row] - (row ? W->blocksize0[row - 1] : 0);
+        for(size_t blockNum = W->index1_data[row];
+            blockNum < W->index1_data[row + 1]; ++blockNum)
+        {
+          size_t col = W->index2_data[blockNum];
+          size_t nb = nrows *
+            (W->blocksize1[col] - (col ? W->blocksize1[col - 1] : 0));
+          memcpy(C->block[blockNum], W->block[blockNum], nb * sizeof(double));
+        }
+      }
+    }
+    C->version = W->version;
+  }
+  memcpy(replica->q, problem->q, n * sizeof(double));
+  memcpy(replica->mu, problem->mu, nc * sizeof(double));
+}
+
+NumericsNumaReplicaSet* numerics_numa_replicate_fc3d(NumericsNumaReplicaSet* set,
+                                                     FrictionContactProblem* problem)
+{
+  unsigned int nnodes = numerics_numa_nodes();
+  if(nnodes <= 1 || !problem->M
+     || problem->M->storageType != NM_SPARSE_BLOCK || !problem->M->matrix1)
+  {
+    numerics_numa_replica_free(set);
+    return NULL;
+  }
+
+  SparseBlockStructuredMatrix* W = problem->M->matrix1;
+  /* force the diagonal-block cache on the source once, sequentially */
+  SBM_diagonal_block_indices(W);
+  size_t payload = numa_payload_size(W);
+
+  int rebuild = !set || set->nnodes != nnodes
+                || set->nc != problem->numberOfContacts
+                || set->filled2 != W->filled2 || set->payload != payload;
+  if(rebuild)
+  {
+    numerics_numa_replica_free(set);
+    set = (NumericsNumaReplicaSet*)calloc(1, sizeof(NumericsNumaReplicaSet));
+    set->nnodes = nnodes;
+#ifdef _OPENMP
+    set->nthreads = (unsigned int)omp_get_max_threads();
+#else
+    set->nthreads = 1;
+#endif
+    set->nc = problem->numberOfContacts;
+    set->filled2 = W->filled2;
+    set->payload = payload;
+    set->arenas = (struct NumericsArena**)calloc(nnodes, sizeof(struct NumericsArena*));
+    set->problems = (FrictionContactProblem**)
+      calloc(nnodes, sizeof(FrictionContactProblem*));
+  }
+
+  /* values are rewritten unless the version stamp of W proves they did
+     not change since the last refresh (0 means no tracking: copy) */
+  uint64_t W_version = NDV_value(&W->version);
+  int copy_W = rebuild || W_version == 0 || W_version != set->W_version;
+  set->W_version = W_version;
+
+  size_t arena_capacity =
+    (payload + 4 * (size_t)problem->numberOfContacts
+     * (size_t)problem->dimension) * sizeof(double)
+    + (W->filled1 + W->filled2) * sizeof(size_t)
+    + (W->blocknumber0 * 2 + W->blocknumber1) * sizeof(unsigned int)
+    + W->nbblocks * sizeof(double*) + 1024;
+
+  /* each node is built/refreshed by the first thread mapped to it, so
+     the pages of the replica are first-touched on the right node */
+  char* touched = (char*)calloc(set->nnodes, sizeof(char));
+#ifdef _OPENMP
+  #pragma omp parallel
+  {
+    int tid = omp_get_thread_num();
+    unsigned int nth = (unsigned int)omp_get_num_threads();
+    for(unsigned int node = 0; node < set->nnodes; ++node)
+    {
+      if(!numa_is_first_of_node(tid, node, set->nnodes, nth)) continue;
+      if(!set->problems[node])
+      {
+        set->arenas[node] = numerics_arena_new(arena_capacity);
+        set->problems[node] = numa_replica_build(set->arenas[node], problem,
+                                                 payload);
+      }
+      numa_replica_refresh(set->problems[node], problem, payload, copy_W);
+      touched[node] = 1;
+    }
+  }
+#endif
+  /* nodes no thread of the (possibly smaller) team was mapped to */
+  for(unsigned int node = 0; node < set->nnodes; ++node)
+  {
+    if(touched[node]) continue;
+    if(!set->problems[node])
+    {
+      set->arenas[node] = numerics_arena_new(arena_capacity);
+      set->problems[node] = numa_replica_build(set->arenas[node], problem,
+                                               payload);
+    }
+    numa_replica_refresh(set->problems[node], problem, payload, copy_W);
+  }
+  free(touched);
+  return set;
+}
+
+FrictionContactProblem* numerics_numa_local_problem(NumericsNumaReplicaSet* set,
+                                                    int thread_id)
+{
+  return set->problems[numa_node_of(thread_id, set->nnodes, set->nthreads)];
+}
+
+void numerics_numa_replica_free(NumericsNumaReplicaSet* set)
+{
+  if(!set) return;
+  for(unsigned int node = 0; node < set->nnodes; ++node)
+    numerics_arena_free(set->arenas[node]);
+  free(set->arenas);
+  free(set->problems);
+  free(set);
+}
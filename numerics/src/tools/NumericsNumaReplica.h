@@ -0,0 +1,112 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NumericsNumaReplica_H
+#define NumericsNumaReplica_H
+
+/*!\file NumericsNumaReplica.h
+  \brief Per-NUMA-node replicas of read-only problem data.
+
+  On large multi-socket machines the parallel Gauss-Seidel sweeps stop
+  scaling once every core reads the shared problem arrays (the W blocks,
+  q and mu) from the node that happened to first-touch them. A
+  NumericsNumaReplicaSet clones those read-only arrays once per node;
+  worker threads then read the replica of their own node and the
+  interconnect only carries the shared mutable iterate.
+
+  No NUMA library is required: each replica lives in its own
+  NumericsArena and is first-touched (allocated and copied) by a thread
+  of the node it serves, relying on the usual first-touch page placement
+  of the OS. The node of a thread is derived from its index, assuming a
+  compact thread binding (OMP_PROC_BIND=close or equivalent), which is
+  how the many-core runs are launched anyway. The number of replicas is
+  read from NumericsExecutionPolicy::numa_nodes (environment variable
+  SICONOS_NUMA_NODES); 0 or 1 disables replication entirely.
+
+  Refreshing an existing set with an unchanged topology rewrites the
+  values in place, without any allocation: over the calls of a
+  simulation the replication cost is paid once per topology, and the
+  per-call cost is a few memcpy, amortized over the sweeps of the solve.
+*/
+
+#include <stddef.h>          // for size_t
+#include <stdint.h>          // for uint64_t
+
+#include "NumericsFwd.h"     // for FrictionContactProblem
+#include "SiconosConfig.h"   // for BUILD_AS_CPP // IWYU pragma: keep
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** Per-node replicas of the read-only data of one problem. */
+  typedef struct NumericsNumaReplicaSet
+  {
+    unsigned int nnodes;      /**< number of replicas */
+    unsigned int nthreads;    /**< thread count the thread->node map was
+                                 built for */
+    struct NumericsArena** arenas; /**< one region per node, holding the
+                                      whole replica */
+    FrictionContactProblem** problems; /**< per-node replicas; M, q and mu
+                                          point inside the node arena */
+    /* topology key of the replicated problem: a refresh with matching
+       key rewrites the values in place, anything else rebuilds */
+    int nc;                   /**< number of contacts */
+    size_t filled2;           /**< number of stored blocks of W */
+    size_t payload;           /**< total scalar entries of the W blocks */
+    uint64_t W_version;       /**< version of W the payloads were last
+                                 copied from (0: unknown, always copy) */
+  } NumericsNumaReplicaSet;
+
+  /** Effective number of NUMA replicas, from the execution policy
+      clamped to the number of worker threads.
+      \return the replica count; <= 1 means replication is disabled */
+  unsigned int numerics_numa_nodes(void);
+
+  /** Create or refresh the per-node replicas of a friction-contact
+      problem whose matrix is sparse block.
+
+      When the given set matches the topology of the problem, only the
+      values (W block payloads, q, mu) are rewritten, in place and
+      first-touched by a thread of each node; otherwise the set is
+      rebuilt. The W payload copy is skipped when the version stamp of W
+      shows it unchanged since the last refresh.
+
+      \param set the set of a previous call, or NULL
+      \param problem the problem to replicate
+      \return the set, or NULL when replication is disabled or the
+      matrix storage is not sparse block (the given set is then freed) */
+  NumericsNumaReplicaSet* numerics_numa_replicate_fc3d(NumericsNumaReplicaSet* set,
+                                                       FrictionContactProblem* problem);
+
+  /** The replica a worker thread should read.
+      \param set the replica set
+      \param thread_id the worker index (omp_get_thread_num)
+      \return the problem replica of the thread's node */
+  FrictionContactProblem* numerics_numa_local_problem(NumericsNumaReplicaSet* set,
+                                                      int thread_id);
+
+  /** Release a replica set and all its arenas.
+      \param set the set (may be NULL) */
+  void numerics_numa_replica_free(NumericsNumaReplicaSet* set);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "NumericsPerfCounters.h"
+
+#include <math.h>    // for NAN
+#include <time.h>    // for clock_gettime, timespec
+
+#if defined(__linux__)
+#include <linux/perf_event.h>  // for perf_event_attr, PERF_COUNT_HW_...
+#include <string.h>            // for memset
+#include <sys/ioctl.h>         // for ioctl
+#include <sys/syscall.h>       // for SYS_perf_event_open
+#include <unistd.h>            // for close, read, syscall
+#endif
+
+/* estimated bytes moved from/to memory per last-level cache miss */
+#define PERF_COUNTERS_LINE_SIZE 64.0
+
+static double perf_now(void)
+{
+#ifdef _WIN32
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+#if defined(__linux__)
+static int perf_open(unsigned int type, unsigned long long config, int group_fd)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = type;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = (group_fd == -1);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  /* self, any cpu, no flags */
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+static double perf_read(int fd)
+{
+  unsigned long long value;
+  if(fd == -1 || read(fd, &value, sizeof(value)) != sizeof(value))
+    return NAN;
+  return (double)value;
+}
+#endif
+
+void perf_counters_begin(PerfCountersHandle* handle)
+{
+  handle->fd_cycles = -1;
+  handle->fd_instructions = -1;
+  handle->fd_llc_misses = -1;
+
+#if defined(__linux__)
+  /* the cycle counter leads the group so that all three events are
+   * enabled and disabled together; any of them may be refused by the
+   * kernel without preventing the others from being read */
+  handle->fd_cycles =
+    perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+  if(handle->fd_cycles != -1)
+  {
+    handle->fd_instructions =
+      perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, handle->fd_cycles);
+    handle->fd_llc_misses =
+      perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, handle->fd_cycles);
+    ioctl(handle->fd_cycles, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(handle->fd_cycles, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+
+  handle->t0 = perf_now();
+}
+
+void perf_counters_end(PerfCountersHandle* handle, SolverPerfCounters* record)
+{
+  record->seconds = perf_now() - handle->t0;
+  record->available = 0;
+  record->cycles = NAN;
+  record->instructions = NAN;
+  record->ipc = NAN;
+  record->llc_misses = NAN;
+  record->dram_bytes = NAN;
+
+#if defined(__linux__)
+  if(handle->fd_cycles != -1)
+  {
+    ioctl(handle->fd_cycles, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    record->cycles = perf_read(handle->fd_cycles);
+    record->instructions = perf_read(handle->fd_instructions);
+    record->llc_misses = perf_read(handle->fd_llc_misses);
+
+    record->available = !isnan(record->cycles);
+    if(record->cycles > 0.) record->ipc = record->instructions / record->cycles;
+    record->dram_bytes = record->llc_misses * PERF_COUNTERS_LINE_SIZE;
+
+    if(handle->fd_llc_misses != -1) close(handle->fd_llc_misses);
+    if(handle->fd_instructions != -1) close(handle->fd_instructions);
+    close(handle->fd_cycles);
+    handle->fd_cycles = -1;
+    handle->fd_instructions = -1;
+    handle->fd_llc_misses = -1;
+  }
+#endif
+}
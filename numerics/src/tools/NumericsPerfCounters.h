@@ -0,0 +1,65 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef NumericsPerfCounters_H
+#define NumericsPerfCounters_H
+
+/*!\file NumericsPerfCounters.h
+  \brief Thin hardware-counter wrapper used by the top-level drivers.
+
+  On Linux the counters are read through perf_event_open (cycles,
+  retired instructions, last-level cache misses), with no library
+  dependency; memory traffic is estimated from the miss count and the
+  cache line size. On other platforms, or when the kernel refuses the
+  events (perf_event_paranoid, containers), only the wall-clock time is
+  recorded and SolverPerfCounters::available stays 0 -- the drivers can
+  therefore call begin/end unconditionally.
+*/
+
+#include "SolverOptions.h"  // for SolverPerfCounters
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** In-flight measurement; opaque to the drivers. */
+  typedef struct
+  {
+    int fd_cycles;        /**< group leader, -1 when counters are off */
+    int fd_instructions;  /**< -1 when the event could not be opened */
+    int fd_llc_misses;    /**< -1 when the event could not be opened */
+    double t0;            /**< wall-clock origin of the measurement */
+  } PerfCountersHandle;
+
+  /** Start a per-solve measurement; never fails (unavailable counters
+      only degrade the record filled by perf_counters_end).
+      \param handle the measurement to start */
+  void perf_counters_begin(PerfCountersHandle* handle);
+
+  /** Stop a measurement and fill the record; counters that could not be
+      read are NaN and `available` is 0 when no hardware value at all
+      was obtained.
+      \param handle the measurement started with perf_counters_begin
+      \param record the per-solve record to fill */
+  void perf_counters_end(PerfCountersHandle* handle, SolverPerfCounters* record);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
@@ -151,8 +151,10 @@ void NSM_null(NumericsSparseMatrix* A)
   A->csr = NULL;
   A->diag_indx = NULL;
   A->origin = NSM_UNKNOWN;
+  A->reorder_perm = NULL;
 
   NSM_reset_versions(A);
+  NDV_reset(&(A->trans_csc_version));
 }
 
 double* NSM_data(NumericsSparseMatrix* A)
@@ -241,6 +243,11 @@ NumericsSparseMatrix* NSM_clear(NumericsSparseMatrix* A)
     free(A->diag_indx);
     A->diag_indx = NULL;
   }
+  if(A->reorder_perm)
+  {
+    cs_free(A->reorder_perm);
+    A->reorder_perm = NULL;
+  }
 
   NSM_reset_versions(A);
 
@@ -434,6 +441,10 @@ NSM_linear_solver_params* NSM_linearSolverParams_new(void)
   p->dWork = NULL;
   p->linalg_data = NULL;
 
+  p->symbolic_analysis = NULL;
+  p->symbolic_n = 0;
+  p->symbolic_nnz = 0;
+
   return p;
 }
 
@@ -488,6 +499,12 @@ NSM_linear_solver_params* NSM_linearSolverParams_free(NSM_linear_solver_params*
     p->linalg_data = NULL;
   }
 
+  if(p->symbolic_analysis)
+  {
+    cs_sfree((css*)p->symbolic_analysis);
+    p->symbolic_analysis = NULL;
+  }
+
   free(p);
   return NULL;
 }
@@ -49,8 +49,11 @@ extern "C"
 
 
   /** \enum NSM_linear_solver NumericsSparseMatrix.h
-   * id for linear algebra solvers */
-  typedef enum { NSM_CSPARSE, NSM_MUMPS, NSM_UMFPACK, NSM_MKL_PARDISO, NSM_SUPERLU, NSM_SUPERLU_MT, NSM_HSL } NSM_linear_solver;
+   * id for linear algebra solvers. NSM_AUTO is not a backend: on the
+   * first solve every backend compiled in is timed on the system at
+   * hand and the solver id is replaced by the fastest one, which is
+   * then kept for all subsequent solves sharing the matrix structure. */
+  typedef enum { NSM_CSPARSE, NSM_MUMPS, NSM_UMFPACK, NSM_MKL_PARDISO, NSM_SUPERLU, NSM_SUPERLU_MT, NSM_HSL, NSM_AUTO } NSM_linear_solver;
 
   typedef void (*freeNSLSP)(void* p);
 
@@ -74,6 +77,15 @@ extern "C"
     int dWorkSize;
 
     linalg_data_t* linalg_data; /**< data for the linear algebra */
+
+    void* symbolic_analysis; /**< cached symbolic analysis (CSparse: css*),
+                                  reused across factorizations while the
+                                  sparsity pattern is unchanged */
+    CS_INT symbolic_n;   /**< dimension of the matrix when the symbolic
+                              analysis was performed */
+    CS_INT symbolic_nnz; /**< number of non zeros when the symbolic analysis
+                              was performed; together with symbolic_n it
+                              validates the pattern */
   };
 
   /**\enum NumericsSparseOrigin NumericsSparseMatrix.h
@@ -99,6 +111,13 @@ extern "C"
                                     /**< solver-specific parameters */
 
     NumericsDataVersion versions[5];
+
+    NumericsDataVersion trans_csc_version; /**< version of the csc storage from
+                                                which trans_csc was computed */
+
+    CS_INT* reorder_perm;           /**< symmetric reordering permutation
+                                         applied by NM_reorder, NULL when the
+                                         matrix is in its original ordering */
   };
 
 
@@ -0,0 +1,391 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // for pthread_setaffinity_np, cpu_set_t
+#endif
+
+#include "NumericsTaskPool.h"
+
+#include <stdlib.h>  // for malloc, free, getenv, strtol
+#include <string.h>  // for memset
+
+#include "NumericsExecutionPolicy.h"  // for numerics_execution_policy
+
+#ifndef _WIN32
+
+#include <pthread.h>  // for pthread_t, pthread_mutex_t, pthread_cond_t
+#include <unistd.h>   // for sysconf, _SC_NPROCESSORS_ONLN
+#if defined(__linux__)
+#include <sched.h>    // for cpu_set_t, CPU_ZERO, CPU_SET
+#endif
+
+/* One queued task. The deques are doubly linked lists: the owner pops
+   from the tail, thieves take from the head. */
+typedef struct NTP_task
+{
+  NTP_task_fn fn;
+  void *ctx;
+  struct NTP_task *prev;
+  struct NTP_task *next;
+} NTP_task;
+
+typedef struct NTP_worker
+{
+  pthread_t thread;
+  pthread_mutex_t lock; /**< protects head/tail of this deque */
+  NTP_task *head;
+  NTP_task *tail;
+  NumericsTaskPool *pool;
+  unsigned int id;
+} NTP_worker;
+
+struct NumericsTaskPool
+{
+  unsigned int nworkers;
+  NTP_worker *workers;
+  pthread_mutex_t lock;      /**< protects the counters below */
+  pthread_cond_t work_cond;  /**< signaled when a task is queued */
+  pthread_cond_t done_cond;  /**< signaled when pending drops to 0 */
+  unsigned int pending;      /**< submitted and not yet completed */
+  unsigned int queued;       /**< submitted and not yet picked up */
+  unsigned int next_worker;  /**< round-robin cursor for submissions */
+  int shutdown;
+};
+
+static void NTP_deque_push_back(NTP_worker *w, NTP_task *task)
+{
+  pthread_mutex_lock(&w->lock);
+  task->next = NULL;
+  task->prev = w->tail;
+  if(w->tail) w->tail->next = task;
+  else w->head = task;
+  w->tail = task;
+  pthread_mutex_unlock(&w->lock);
+}
+
+static NTP_task *NTP_deque_pop_back(NTP_worker *w)
+{
+  pthread_mutex_lock(&w->lock);
+  NTP_task *task = w->tail;
+  if(task)
+  {
+    w->tail = task->prev;
+    if(w->tail) w->tail->next = NULL;
+    else w->head = NULL;
+  }
+  pthread_mutex_unlock(&w->lock);
+  return task;
+}
+
+static NTP_task *NTP_deque_pop_front(NTP_worker *w)
+{
+  pthread_mutex_lock(&w->lock);
+  NTP_task *task = w->head;
+  if(task)
+  {
+    w->head = task->next;
+    if(w->head) w->head->prev = NULL;
+    else w->tail = NULL;
+  }
+  pthread_mutex_unlock(&w->lock);
+  return task;
+}
+
+/* Own deque first (back, newest: still warm), then steal from the front
+   of the others, starting after self so thieves spread out. */
+static NTP_task *NTP_find_work(NTP_worker *self)
+{
+  NumericsTaskPool *pool = self->pool;
+  NTP_task *task = NTP_deque_pop_back(self);
+  for(unsigned int k = 1; !task && k < pool->nworkers; ++k)
+  {
+    task = NTP_deque_pop_front(&pool->workers[(self->id + k) % pool->nworkers]);
+  }
+  return task;
+}
+
+static void *NTP_worker_main(void *arg)
+{
+  NTP_worker *self = (NTP_worker *)arg;
+  NumericsTaskPool *pool = self->pool;
+  for(;;)
+  {
+    NTP_task *task = NTP_find_work(self);
+    if(task)
+    {
+      pthread_mutex_lock(&pool->lock);
+      pool->queued--;
+      pthread_mutex_unlock(&pool->lock);
+
+      task->fn(task->ctx);
+      free(task);
+
+      pthread_mutex_lock(&pool->lock);
+      pool->pending--;
+      if(pool->pending == 0) pthread_cond_broadcast(&pool->done_cond);
+      pthread_mutex_unlock(&pool->lock);
+      continue;
+    }
+    pthread_mutex_lock(&pool->lock);
+    /* queued may have become nonzero between the failed scan and taking
+       the lock; in that case loop again instead of sleeping */
+    while(pool->queued == 0 && !pool->shutdown)
+      pthread_cond_wait(&pool->work_cond, &pool->lock);
+    int stop = pool->shutdown && pool->queued == 0;
+    pthread_mutex_unlock(&pool->lock);
+    if(stop) break;
+  }
+  return NULL;
+}
+
+NumericsTaskPool *NTP_create(unsigned int nthreads)
+{
+  if(nthreads == 0)
+  {
+    const char *env = getenv("SICONOS_TASK_POOL_THREADS");
+    if(env) nthreads = (unsigned int)strtol(env, NULL, 10);
+  }
+  if(nthreads == 0)
+  {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    nthreads = n > 0 ? (unsigned int)n : 1;
+  }
+
+  NumericsTaskPool *pool =
+    (NumericsTaskPool *)calloc(1, sizeof(NumericsTaskPool));
+  if(!pool) return NULL;
+  pool->nworkers = nthreads;
+  pool->workers = (NTP_worker *)calloc(nthreads, sizeof(NTP_worker));
+  if(!pool->workers)
+  {
+    free(pool);
+    return NULL;
+  }
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+#if defined(__linux__)
+  const char *bind_env = getenv("SICONOS_TASK_POOL_BIND");
+  int bind_workers = bind_env && bind_env[0] != '0';
+  long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  for(unsigned int i = 0; i < nthreads; ++i)
+  {
+    NTP_worker *w = &pool->workers[i];
+    w->pool = pool;
+    w->id = i;
+    pthread_mutex_init(&w->lock, NULL);
+    if(pthread_create(&w->thread, NULL, &NTP_worker_main, w))
+    {
+      /* keep only the workers that did start */
+      pool->nworkers = i;
+      break;
+    }
+#if defined(__linux__)
+    if(bind_workers && ncpus > 0)
+    {
+      /* round-robin pinning: with the usual node-major CPU numbering a
+         worker stays on one socket, which makes first-touch placement
+         (NTP_first_touch) and the affinity hints agree; best effort, a
+         failure leaves the worker unbound */
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(i % (unsigned long)ncpus, &cpus);
+      pthread_setaffinity_np(w->thread, sizeof(cpu_set_t), &cpus);
+    }
+#endif
+  }
+  if(pool->nworkers == 0)
+  {
+    NTP_destroy(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+void NTP_destroy(NumericsTaskPool *pool)
+{
+  if(!pool) return;
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = 1;
+  pthread_cond_broadcast(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+  for(unsigned int i = 0; i < pool->nworkers; ++i)
+    pthread_join(pool->workers[i].thread, NULL);
+  for(unsigned int i = 0; i < pool->nworkers; ++i)
+    pthread_mutex_destroy(&pool->workers[i].lock);
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->work_cond);
+  pthread_cond_destroy(&pool->done_cond);
+  free(pool->workers);
+  free(pool);
+}
+
+NumericsTaskPool *NTP_default(void)
+{
+  static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;
+  static NumericsTaskPool *default_pool = NULL;
+  static int initialized = 0;
+  pthread_mutex_lock(&init_lock);
+  if(!initialized)
+  {
+    default_pool = NTP_create(numerics_execution_policy()->nthreads);
+    initialized = 1;
+  }
+  pthread_mutex_unlock(&init_lock);
+  return default_pool;
+}
+
+unsigned int NTP_num_workers(const NumericsTaskPool *pool)
+{
+  return pool ? pool->nworkers : 0;
+}
+
+void NTP_submit_hint(NumericsTaskPool *pool, NTP_task_fn fn, void *ctx,
+                     int hint)
+{
+  if(!pool)
+  {
+    fn(ctx);
+    return;
+  }
+  NTP_task *task = (NTP_task *)malloc(sizeof(NTP_task));
+  if(!task)
+  {
+    fn(ctx);
+    return;
+  }
+  task->fn = fn;
+  task->ctx = ctx;
+
+  pthread_mutex_lock(&pool->lock);
+  unsigned int target = hint >= 0 ? (unsigned int)hint % pool->nworkers
+                        : pool->next_worker++ % pool->nworkers;
+  pool->pending++;
+  pool->queued++;
+  pthread_mutex_unlock(&pool->lock);
+
+  NTP_deque_push_back(&pool->workers[target], task);
+
+  pthread_mutex_lock(&pool->lock);
+  pthread_cond_signal(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void NTP_submit(NumericsTaskPool *pool, NTP_task_fn fn, void *ctx)
+{
+  NTP_submit_hint(pool, fn, ctx, -1);
+}
+
+void NTP_wait(NumericsTaskPool *pool)
+{
+  if(!pool) return;
+  pthread_mutex_lock(&pool->lock);
+  while(pool->pending > 0)
+    pthread_cond_wait(&pool->done_cond, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+#define NTP_PAGE_SIZE ((size_t)4096)
+
+typedef struct
+{
+  char *data;
+  size_t size;
+} NTP_touch_chunk;
+
+static void NTP_touch_task(void *ctx)
+{
+  NTP_touch_chunk *chunk = (NTP_touch_chunk *)ctx;
+  memset(chunk->data, 0, chunk->size);
+}
+
+void NTP_first_touch(NumericsTaskPool *pool, void *data, size_t size)
+{
+  unsigned int nworkers = NTP_num_workers(pool);
+  /* below one page per worker the placement cannot be improved */
+  if(nworkers <= 1 || size < (size_t)nworkers * NTP_PAGE_SIZE)
+  {
+    memset(data, 0, size);
+    return;
+  }
+  NTP_touch_chunk *chunks =
+    (NTP_touch_chunk *)malloc(nworkers * sizeof(NTP_touch_chunk));
+  if(!chunks)
+  {
+    memset(data, 0, size);
+    return;
+  }
+  /* page-aligned chunk length so every page has a single toucher */
+  size_t chunk = (size + nworkers - 1) / nworkers;
+  chunk = (chunk + NTP_PAGE_SIZE - 1) & ~(NTP_PAGE_SIZE - 1);
+  size_t pos = 0;
+  for(unsigned int i = 0; i < nworkers && pos < size; ++i)
+  {
+    chunks[i].data = (char *)data + pos;
+    chunks[i].size = size - pos < chunk ? size - pos : chunk;
+    NTP_submit_hint(pool, &NTP_touch_task, &chunks[i], (int)i);
+    pos += chunks[i].size;
+  }
+  NTP_wait(pool);
+  free(chunks);
+}
+
+#else /* _WIN32: no pthreads, degrade to inline execution */
+
+NumericsTaskPool *NTP_create(unsigned int nthreads)
+{
+  (void)nthreads;
+  return NULL;
+}
+void NTP_destroy(NumericsTaskPool *pool)
+{
+  (void)pool;
+}
+NumericsTaskPool *NTP_default(void)
+{
+  return NULL;
+}
+unsigned int NTP_num_workers(const NumericsTaskPool *pool)
+{
+  (void)pool;
+  return 0;
+}
+void NTP_submit(NumericsTaskPool *pool, NTP_task_fn fn, void *ctx)
+{
+  (void)pool;
+  fn(ctx);
+}
+void NTP_submit_hint(NumericsTaskPool *pool, NTP_task_fn fn, void *ctx,
+                     int hint)
+{
+  (void)pool;
+  (void)hint;
+  fn(ctx);
+}
+void NTP_wait(NumericsTaskPool *pool)
+{
+  (void)pool;
+}
+void NTP_first_touch(NumericsTaskPool *pool, void *data, size_t size)
+{
+  (void)pool;
+  memset(data, 0, size);
+}
+
+#endif
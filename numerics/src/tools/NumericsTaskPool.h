@@ -0,0 +1,128 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NumericsTaskPool_H
+#define NumericsTaskPool_H
+
+/*!\file NumericsTaskPool.h
+ * \brief a small task pool with persistent worker threads, shared by the
+ * numerics C solvers and the kernel.
+ *
+ * Unlike an OpenMP parallel region, the workers are created once and kept
+ * alive, so submitting work from a 1 kHz stepping loop does not pay the
+ * fork/join cost on every step. Each worker owns a deque: it pops its own
+ * work from the back and steals from the front of the others when idle.
+ * Submissions may carry a worker hint to keep related tasks (and their
+ * data) on the same thread.
+ */
+
+#include <stddef.h>        // for size_t
+
+#include "SiconosConfig.h" // for BUILD_AS_CPP // IWYU pragma: keep
+
+/** opaque pool handle */
+typedef struct NumericsTaskPool NumericsTaskPool;
+
+/** task entry point */
+typedef void (*NTP_task_fn)(void *ctx);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C" {
+#endif
+
+/** Create a pool with persistent worker threads.
+ *
+ *  \param nthreads number of workers; 0 picks the number of online
+ *  processors, overridable with the SICONOS_TASK_POOL_THREADS environment
+ *  variable. With SICONOS_TASK_POOL_BIND set (and nonzero) each worker is
+ *  pinned to one CPU, round-robin over the online processors; on NUMA
+ *  nodes this keeps a worker on one socket for the lifetime of the pool,
+ *  so memory placed by NTP_first_touch() stays local to the worker the
+ *  affinity hints address.
+ *  \return the pool, or NULL when threads are not available (submissions
+ *  on a NULL pool run inline)
+ */
+NumericsTaskPool *NTP_create(unsigned int nthreads);
+
+/** Stop the workers (after draining the queues) and free the pool.
+ *
+ *  \param pool the pool, may be NULL
+ */
+void NTP_destroy(NumericsTaskPool *pool);
+
+/** The process-wide pool, created on first use and kept for the lifetime
+ *  of the process.
+ *
+ *  \return the default pool, NULL when threads are not available
+ */
+NumericsTaskPool *NTP_default(void);
+
+/** Number of worker threads.
+ *
+ *  \param pool the pool, may be NULL
+ *  \return the number of workers, 0 for a NULL pool
+ */
+unsigned int NTP_num_workers(const NumericsTaskPool *pool);
+
+/** Submit a task. The call never blocks; the task runs on some worker.
+ *  On a NULL pool the task is executed inline instead.
+ *
+ *  \param pool the pool, may be NULL
+ *  \param fn the task entry point
+ *  \param ctx argument passed to fn
+ */
+void NTP_submit(NumericsTaskPool *pool, NTP_task_fn fn, void *ctx);
+
+/** Submit a task with an affinity hint: the task is pushed on the deque
+ *  of worker (hint modulo number of workers), although an idle worker may
+ *  still steal it. A negative hint behaves like NTP_submit.
+ *
+ *  \param pool the pool, may be NULL
+ *  \param fn the task entry point
+ *  \param ctx argument passed to fn
+ *  \param hint preferred worker, or negative for no preference
+ */
+void NTP_submit_hint(NumericsTaskPool *pool, NTP_task_fn fn, void *ctx,
+                     int hint);
+
+/** Wait until every task submitted so far has completed.
+ *
+ *  \param pool the pool, may be NULL (no-op)
+ */
+void NTP_wait(NumericsTaskPool *pool);
+
+/** Zero a freshly allocated buffer in parallel, one page-aligned
+ *  contiguous chunk per worker, each chunk on its own worker. Under the
+ *  first-touch policy of the OS the pages of chunk i then reside on the
+ *  NUMA node running worker i: later submissions hinted to worker i
+ *  operate on local memory (pin the workers with SICONOS_TASK_POOL_BIND
+ *  to make the worker/node mapping stable). Falls back to a plain memset
+ *  on a NULL pool or a small buffer. Blocks until every chunk is
+ *  touched.
+ *
+ *  \param pool the pool, may be NULL
+ *  \param data start of the buffer
+ *  \param size buffer size in bytes
+ */
+void NTP_first_touch(NumericsTaskPool *pool, void *data, size_t size);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
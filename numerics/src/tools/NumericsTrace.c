@@ -0,0 +1,270 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include "NumericsTrace.h"
+
+#include <pthread.h>          // for pthread_create, pthread_mutex_lock
+#include <stdlib.h>           // for getenv, calloc, free, atexit
+#include <string.h>           // for memcmp, memcpy
+#include <time.h>             // for clock_gettime, nanosleep, timespec
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>        // for __rdtsc
+#endif
+
+#include "SolverOptions.h"    // for solver_options_id_to_name
+#include "numerics_verbose.h" // for numerics_printf_verbose, numerics_warning
+#include "tlsdef.h"           // for tlsvar
+
+/* The ring size is a power of two so that the sequence counters can be
+   mapped to slots with a mask. 8192 records = 256 kB per thread, enough
+   for several milliseconds of the densest trace points (one record per
+   contact sweep) between two passes of the drainer. */
+#define TRACE_RING_SIZE 8192
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+
+/* drainer wake-up period, nanoseconds */
+#define TRACE_DRAIN_PERIOD_NS 10000000L
+
+static const char trace_magic[8] = "SNTRACE1";
+
+/* single-producer (owning solver thread) / single-consumer (drainer)
+   ring. head and tail are free-running sequence counters; the producer
+   publishes head with a release store, the consumer publishes tail with
+   a release store, so records are fully written before they become
+   visible and slots are fully read before they are reused. */
+typedef struct NumericsTraceRing
+{
+  NumericsTraceRecord records[TRACE_RING_SIZE];
+  uint64_t head;     /* next sequence to write; owner writes, drainer reads */
+  uint64_t tail;     /* next sequence to read; drainer writes, owner reads */
+  uint64_t dropped;  /* records lost to overflow; owner only, read at shutdown */
+  uint32_t thread;   /* trace-local thread number */
+  struct NumericsTraceRing* next;
+} NumericsTraceRing;
+
+int numerics_trace_on = -1;
+
+static tlsvar NumericsTraceRing* trace_ring = NULL;
+
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+static NumericsTraceRing* trace_rings = NULL; /* all registered rings */
+static uint32_t trace_nb_threads = 0;
+static FILE* trace_file = NULL;
+static pthread_t trace_drainer;
+static int trace_drainer_stop = 0;
+
+static inline uint64_t trace_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* drain one ring; called from the drainer thread (and, after it has been
+   joined, from the shutdown handler). trace_file is never NULL here. */
+static void trace_drain_ring(NumericsTraceRing* ring)
+{
+  uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  uint64_t tail = ring->tail;
+  while(tail < head)
+  {
+    /* write the contiguous run up to the end of the array in one go */
+    uint64_t slot = tail & TRACE_RING_MASK;
+    uint64_t run = head - tail;
+    if(run > TRACE_RING_SIZE - slot) run = TRACE_RING_SIZE - slot;
+    fwrite(&ring->records[slot], sizeof(NumericsTraceRecord), (size_t)run,
+           trace_file);
+    tail += run;
+  }
+  __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+}
+
+static void trace_drain_all(void)
+{
+  pthread_mutex_lock(&trace_mutex);
+  for(NumericsTraceRing* ring = trace_rings; ring; ring = ring->next)
+    trace_drain_ring(ring);
+  fflush(trace_file);
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+static void* trace_drainer_main(void* unused)
+{
+  struct timespec period = { 0, TRACE_DRAIN_PERIOD_NS };
+  while(!__atomic_load_n(&trace_drainer_stop, __ATOMIC_ACQUIRE))
+  {
+    nanosleep(&period, NULL);
+    trace_drain_all();
+  }
+  return unused;
+}
+
+/* atexit handler: stop the drainer, drain whatever is left and record
+   the overflow counts, then close the file. */
+static void trace_shutdown(void)
+{
+  __atomic_store_n(&trace_drainer_stop, 1, __ATOMIC_RELEASE);
+  pthread_join(trace_drainer, NULL);
+  pthread_mutex_lock(&trace_mutex);
+  for(NumericsTraceRing* ring = trace_rings; ring; ring = ring->next)
+  {
+    trace_drain_ring(ring);
+    if(ring->dropped)
+    {
+      NumericsTraceRecord record =
+        { trace_now(), 0, NUMERICS_TRACE_DROPPED, 0, ring->thread,
+          (double)ring->dropped };
+      fwrite(&record, sizeof(record), 1, trace_file);
+    }
+  }
+  fclose(trace_file);
+  trace_file = NULL;
+  numerics_trace_on = 0;
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+/* lazy one-time initialization, triggered by the first trace point */
+static void trace_init(void)
+{
+  pthread_mutex_lock(&trace_mutex);
+  if(numerics_trace_on < 0)
+  {
+    int on = 0;
+    const char* path = getenv("SICONOS_TRACE_FILE");
+    if(path && path[0])
+    {
+      trace_file = fopen(path, "wb");
+      if(trace_file)
+      {
+        uint32_t header[2] = { 1u, (uint32_t)sizeof(NumericsTraceRecord) };
+        fwrite(trace_magic, sizeof(trace_magic), 1, trace_file);
+        fwrite(header, sizeof(header), 1, trace_file);
+        if(pthread_create(&trace_drainer, NULL, &trace_drainer_main, NULL) == 0)
+        {
+          atexit(&trace_shutdown);
+          numerics_printf_verbose(1, "numerics_trace :: writing trace to %s",
+                                  path);
+          on = 1;
+        }
+        else
+        {
+          fclose(trace_file);
+          trace_file = NULL;
+          numerics_warning("numerics_trace", "cannot start drainer thread, "
+                           "tracing disabled\n");
+        }
+      }
+      else
+        numerics_warning("numerics_trace", "cannot open %s, tracing "
+                         "disabled\n", path);
+    }
+    numerics_trace_on = on;
+  }
+  pthread_mutex_unlock(&trace_mutex);
+}
+
+/* allocate and register the calling thread's ring. The registry list is
+   only ever prepended to, so the drainer can traverse it while holding
+   the mutex without invalidating the owners' tlsvar pointers. */
+static NumericsTraceRing* trace_register_thread(void)
+{
+  NumericsTraceRing* ring =
+    (NumericsTraceRing*)calloc(1, sizeof(NumericsTraceRing));
+  if(!ring) return NULL;
+  pthread_mutex_lock(&trace_mutex);
+  ring->thread = trace_nb_threads++;
+  ring->next = trace_rings;
+  trace_rings = ring;
+  pthread_mutex_unlock(&trace_mutex);
+  trace_ring = ring;
+  return ring;
+}
+
+void numerics_trace_event(uint32_t solver_id, uint32_t event,
+                          uint32_t iteration, double value)
+{
+  if(numerics_trace_on < 0) trace_init();
+  if(!numerics_trace_on) return;
+
+  NumericsTraceRing* ring = trace_ring;
+  if(!ring)
+  {
+    ring = trace_register_thread();
+    if(!ring) return;
+  }
+
+  uint64_t head = ring->head;
+  if(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= TRACE_RING_SIZE)
+  {
+    /* full: dropping is cheaper than blocking the solver */
+    ++ring->dropped;
+    return;
+  }
+  NumericsTraceRecord* record = &ring->records[head & TRACE_RING_MASK];
+  record->timestamp = trace_now();
+  record->solver_id = solver_id;
+  record->event = event;
+  record->iteration = iteration;
+  record->thread = ring->thread;
+  record->value = value;
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+void numerics_trace_flush(void)
+{
+  if(numerics_trace_on > 0) trace_drain_all();
+}
+
+static const char* trace_event_name(uint32_t event)
+{
+  switch(event)
+  {
+  case NUMERICS_TRACE_SOLVE_BEGIN: return "begin";
+  case NUMERICS_TRACE_ITERATION: return "iteration";
+  case NUMERICS_TRACE_SOLVE_END: return "end";
+  case NUMERICS_TRACE_DROPPED: return "dropped";
+  default: return "unknown";
+  }
+}
+
+int numerics_trace_decode(FILE* input, FILE* output)
+{
+  char magic[sizeof(trace_magic)];
+  uint32_t header[2];
+  if(fread(magic, sizeof(magic), 1, input) != 1
+      || memcmp(magic, trace_magic, sizeof(magic)) != 0
+      || fread(header, sizeof(header), 1, input) != 1
+      || header[0] != 1u
+      || header[1] != (uint32_t)sizeof(NumericsTraceRecord))
+    return 1;
+
+  fprintf(output, "timestamp,thread,solver,event,iteration,value\n");
+  NumericsTraceRecord record;
+  while(fread(&record, sizeof(record), 1, input) == 1)
+  {
+    const char* solver = record.event == NUMERICS_TRACE_DROPPED ?
+                         "" : solver_options_id_to_name((int)record.solver_id);
+    fprintf(output, "%llu,%u,%s,%s,%u,%.17g\n",
+            (unsigned long long)record.timestamp, record.thread, solver,
+            trace_event_name(record.event), record.iteration, record.value);
+  }
+  return 0;
+}
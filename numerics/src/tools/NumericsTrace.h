@@ -0,0 +1,129 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef NumericsTrace_h
+#define NumericsTrace_h
+
+/*!\file NumericsTrace.h
+ * \brief low-overhead binary event tracing for the numerics solvers.
+ *
+ * Unlike the printf-based verbosity of numerics_verbose.h, which formats
+ * text on the solver thread and is too expensive to leave enabled in
+ * production, this facility appends fixed-size binary records to a
+ * per-thread ring buffer. A background thread drains the rings to a file
+ * every few milliseconds, so the cost on the solver thread is one branch
+ * when tracing is off and one 32-byte store when it is on. When the ring
+ * is full records are dropped (and counted) rather than blocking the
+ * solver.
+ *
+ * Tracing is activated at run time by setting the environment variable
+ * SICONOS_TRACE_FILE to the path of the output file. The trace points
+ * themselves are compiled in only when WITH_NUMERICS_TRACE is defined
+ * (cmake option), so release builds that do not want even the branch can
+ * compile them out entirely.
+ *
+ * Trace files are decoded to CSV with the numerics_trace_decoder tool
+ * (built with the library) or programmatically with
+ * numerics_trace_decode().
+ */
+
+#include <stdint.h>         // for uint32_t, uint64_t
+#include <stdio.h>          // for FILE
+#include "NumericsFwd.h"    // IWYU pragma: keep
+#include "SiconosConfig.h"  // for WITH_NUMERICS_TRACE // IWYU pragma: keep
+
+/** kind of event stored in a trace record */
+enum NUMERICS_TRACE_EVENT
+{
+  /** a solver (or driver) starts; value = problem size (e.g. number of contacts) */
+  NUMERICS_TRACE_SOLVE_BEGIN = 0,
+  /** one iteration of the solver loop completed; value = current residual */
+  NUMERICS_TRACE_ITERATION = 1,
+  /** the solver returns; value = final residual */
+  NUMERICS_TRACE_SOLVE_END = 2,
+  /** emitted at shutdown for each thread that overflowed its ring;
+      value = number of records lost */
+  NUMERICS_TRACE_DROPPED = 3
+};
+
+/** one binary trace record (32 bytes, written verbatim to the trace file) */
+typedef struct
+{
+  uint64_t timestamp; /**< time-stamp counter ticks on x86, monotonic
+                           nanoseconds elsewhere; only differences within
+                           one trace are meaningful */
+  uint32_t solver_id; /**< solver id (SICONOS_..., see the *_cst.h headers) */
+  uint32_t event;     /**< a NUMERICS_TRACE_EVENT value */
+  uint32_t iteration; /**< iteration count, 0 for begin/end events */
+  uint32_t thread;    /**< trace-local thread number (registration order) */
+  double value;       /**< event-dependent payload, see NUMERICS_TRACE_EVENT */
+} NumericsTraceRecord;
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** tri-state tracing flag: -1 until the first event triggers the lazy
+      initialization, then 1 if SICONOS_TRACE_FILE was set and the output
+      file could be opened, 0 otherwise. Not meant to be written by
+      users; exposed only so that the SN_TRACE macro costs a single load
+      and branch once tracing is known to be off. */
+  extern int numerics_trace_on;
+
+  /** append one record to the calling thread's ring buffer.
+      Initializes the tracing machinery (output file, drainer thread) on
+      the first call; a no-op when tracing is disabled. Never blocks: if
+      the ring is full the record is dropped and counted.
+      \param solver_id solver id of the emitting solver
+      \param event a NUMERICS_TRACE_EVENT value
+      \param iteration iteration count (0 for begin/end events)
+      \param value event-dependent payload */
+  void numerics_trace_event(uint32_t solver_id, uint32_t event,
+                            uint32_t iteration, double value);
+
+  /** drain all ring buffers to the trace file immediately, instead of
+      waiting for the next pass of the background thread. Useful before
+      forking or when correlating the trace with external output. */
+  void numerics_trace_flush(void);
+
+  /** decode a binary trace file to CSV, one record per line
+      (timestamp, thread, solver name, event name, iteration, value).
+      \param input the trace file, opened for binary reading
+      \param output destination of the CSV text
+      \return 0 on success, 1 if input is not a trace file or is of an
+      unsupported version */
+  int numerics_trace_decode(FILE* input, FILE* output);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+/** \def SN_TRACE(solver_id, event, iteration, value)
+    trace point. Expands to nothing unless WITH_NUMERICS_TRACE is
+    defined; when tracing is compiled in but not activated by the
+    environment the cost is one global load and branch. */
+#ifdef WITH_NUMERICS_TRACE
+#define SN_TRACE(solver_id, event, iteration, value)                    \
+  do { if(numerics_trace_on)                                            \
+      numerics_trace_event((uint32_t)(solver_id), (event),              \
+                           (uint32_t)(iteration), (value)); } while(0)
+#else
+#define SN_TRACE(solver_id, event, iteration, value)
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include <stdlib.h>               // for getenv
+#include <string.h>               // for strcmp
+#include "SiconosCpuFeatures.h"
+#include "numerics_verbose.h"     // for numerics_printf_verbose
+
+const char* siconos_simd_level_name(int level)
+{
+  switch(level)
+  {
+  case SICONOS_SIMD_GENERIC:
+    return "generic";
+  case SICONOS_SIMD_AVX2:  /* == SICONOS_SIMD_NEON */
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return "neon";
+#else
+    return "avx2";
+#endif
+  case SICONOS_SIMD_AVX512:
+    return "avx512";
+  default:
+    return "unknown";
+  }
+}
+
+static int siconos_simd_detect(void)
+{
+  const char* env = getenv("SICONOS_SIMD_LEVEL");
+  if(env)
+  {
+    if(strcmp(env, "generic") == 0)
+      return SICONOS_SIMD_GENERIC;
+    if(strcmp(env, "avx2") == 0)
+      return SICONOS_SIMD_AVX2;
+    if(strcmp(env, "neon") == 0)
+      return SICONOS_SIMD_NEON;
+    if(strcmp(env, "avx512") == 0)
+      return SICONOS_SIMD_AVX512;
+    numerics_printf_verbose(0, "siconos_simd_level: unknown SICONOS_SIMD_LEVEL value \"%s\", falling back to detection", env);
+  }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+  /* NEON is part of the aarch64 baseline */
+  return SICONOS_SIMD_NEON;
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  /* the builtins check both cpuid and the xsave state */
+  if(__builtin_cpu_supports("avx512f"))
+    return SICONOS_SIMD_AVX512;
+  if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return SICONOS_SIMD_AVX2;
+  return SICONOS_SIMD_GENERIC;
+#else
+  return SICONOS_SIMD_GENERIC;
+#endif
+}
+
+int siconos_simd_level(void)
+{
+  /* benign race: detection is idempotent */
+  static int level = -1;
+  if(level < 0)
+  {
+    level = siconos_simd_detect();
+    numerics_printf_verbose(1, "siconos_simd_level: %s kernels selected", siconos_simd_level_name(level));
+  }
+  return level;
+}
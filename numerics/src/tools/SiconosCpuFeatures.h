@@ -0,0 +1,88 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#ifndef SiconosCpuFeatures_h
+#define SiconosCpuFeatures_h
+
+/*!\file SiconosCpuFeatures.h
+  \brief Runtime cpu feature detection and kernel variant dispatch.
+
+  With WITH_SIMD_DISPATCH enabled at configure time, selected kernel
+  sources are compiled several times, once per instruction set (see
+  numerics/CMakeLists.txt).  Each variant takes its suffix from the
+  SICONOS_SIMD_VARIANT_SUFFIX definition through the SICONOS_SIMD_KERNEL
+  macro, so a kernel written as
+
+      void SICONOS_SIMD_KERNEL(my_kernel)(...) { ... }
+
+  is emitted as my_kernel_generic in the regular build and as
+  my_kernel_avx2, my_kernel_avx512 ... in the per-ISA object libraries.
+  The public entry point (compiled only in the regular build, guard it
+  with #ifndef SICONOS_SIMD_VARIANT) picks a variant on first call from
+  siconos_simd_level(), so a single binary runs with the best kernels
+  the host supports.
+
+  The environment variable SICONOS_SIMD_LEVEL (generic, avx2, avx512,
+  neon) overrides the detection, which is handy to compare kernels on
+  the same machine.
+ */
+#include "SiconosConfig.h" // for BUILD_AS_CPP // IWYU pragma: keep
+
+/** ladder of simd levels; the meaning of each step depends on the
+    architecture the binary was built for */
+enum SICONOS_SIMD_LEVEL_ENUM
+{
+  /** baseline of the build (SSE2 on x86-64, scalar elsewhere) */
+  SICONOS_SIMD_GENERIC = 0,
+  /** x86: AVX2 and FMA */
+  SICONOS_SIMD_AVX2 = 1,
+  /** aarch64: NEON (always available, reported for completeness) */
+  SICONOS_SIMD_NEON = 1,
+  /** x86: AVX-512 foundation */
+  SICONOS_SIMD_AVX512 = 2
+};
+
+/** token pasting helpers for the per-ISA kernel names */
+#define SICONOS_SIMD_CONCAT_(name, suffix) name##suffix
+#define SICONOS_SIMD_CONCAT(name, suffix) SICONOS_SIMD_CONCAT_(name, suffix)
+
+#if defined(SICONOS_SIMD_VARIANT)
+#define SICONOS_SIMD_KERNEL(name) SICONOS_SIMD_CONCAT(name, SICONOS_SIMD_VARIANT_SUFFIX)
+#else
+#define SICONOS_SIMD_KERNEL(name) SICONOS_SIMD_CONCAT(name, _generic)
+#endif
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+extern "C"
+{
+#endif
+
+  /** detect the simd level of the host, honouring the SICONOS_SIMD_LEVEL
+      environment variable; the result is cached after the first call
+      \return a SICONOS_SIMD_LEVEL_ENUM value
+  */
+  int siconos_simd_level(void);
+
+  /** \param level a SICONOS_SIMD_LEVEL_ENUM value
+      \return a printable name for the level */
+  const char* siconos_simd_level_name(int level);
+
+#if defined(__cplusplus) && !defined(BUILD_AS_CPP)
+}
+#endif
+
+#endif
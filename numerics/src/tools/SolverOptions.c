@@ -23,6 +23,7 @@
 #include <stdio.h>                          // for NULL, size_t, printf
 #include <stdlib.h>                         // for free, calloc, malloc
 #include <string.h>                         // for strcmp
+#include <time.h>                           // for clock_gettime, timespec
 #include "AVI_cst.h"                        // for SICONOS_AVI_CAOFERRIS_STR
 #include "ConvexQP_Solvers.h"               // for convexQP_ADMM_set_default
 #include "ConvexQP_cst.h"                   // for SICONOS_CONVEXQP_ADMM_STR
@@ -103,11 +104,104 @@ static SolverOptions* solver_options_initialize(int solver_id, int iter_max, dou
   options->internalSolvers = calloc(options->numberOfInternalSolvers, sizeof(SolverOptions*));
   options->solverData = NULL;
   options->solverParameters = NULL;
+  options->stats = NULL;
 
   options->isSet = true;
   return options;
 }
 
+/* monotonic-ish wall clock for the convergence trace, in seconds */
+static double stats_now(void)
+{
+#ifdef _WIN32
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+void solver_options_enable_stats(SolverOptions* options, unsigned int capacity)
+{
+  assert(options);
+  assert(capacity > 0);
+  solver_options_disable_stats(options);
+  options->stats = (SolverStats*)malloc(sizeof(SolverStats));
+  options->stats->capacity = capacity;
+  options->stats->count = 0;
+  options->stats->t0 = stats_now();
+  options->stats->samples =
+    (SolverStatsSample*)calloc(capacity, sizeof(SolverStatsSample));
+  options->stats->collect_perf = 0;
+  memset(&options->stats->perf, 0, sizeof(SolverPerfCounters));
+}
+
+void solver_options_disable_stats(SolverOptions* options)
+{
+  assert(options);
+  if(options->stats)
+  {
+    free(options->stats->samples);
+    free(options->stats);
+    options->stats = NULL;
+  }
+}
+
+void solver_options_stats_reset(SolverOptions* options)
+{
+  assert(options);
+  if(options->stats)
+  {
+    options->stats->count = 0;
+    options->stats->t0 = stats_now();
+  }
+}
+
+void solver_options_stats_push(SolverOptions* options, int iter,
+                               double residual, double step_length,
+                               int active_set_size)
+{
+  SolverStats* stats = options->stats;
+  if(!stats) return;
+  SolverStatsSample* sample =
+    &stats->samples[stats->count % stats->capacity];
+  sample->iter = iter;
+  sample->residual = residual;
+  sample->step_length = step_length;
+  sample->active_set_size = active_set_size;
+  sample->time = stats_now() - stats->t0;
+  stats->count++;
+}
+
+unsigned long long solver_options_stats_count(const SolverOptions* options)
+{
+  return options->stats ? options->stats->count : 0;
+}
+
+const SolverStatsSample* solver_options_stats_get(const SolverOptions* options,
+                                                  unsigned long long k)
+{
+  const SolverStats* stats = options->stats;
+  if(!stats || k >= stats->count) return NULL;
+  unsigned long long kept =
+    stats->count < stats->capacity ? stats->count : stats->capacity;
+  if(k < stats->count - kept) return NULL; /* evicted from the ring */
+  return &stats->samples[k % stats->capacity];
+}
+
+void solver_options_enable_perf_counters(SolverOptions* options)
+{
+  assert(options);
+  if(!options->stats) solver_options_enable_stats(options, 1);
+  options->stats->collect_perf = 1;
+}
+
+const SolverPerfCounters* solver_options_perf_counters(const SolverOptions* options)
+{
+  return options->stats ? &options->stats->perf : NULL;
+}
+
 /** */
 static void recursive_solver_options_print(SolverOptions* options, int level)
 {
@@ -208,6 +302,9 @@ void solver_options_delete(SolverOptions* op)
 
     op->callback = NULL;
 
+    // Clear the convergence trace
+    solver_options_disable_stats(op);
+
     // Clear internal solver(s)
     if(op->internalSolvers)
     {
@@ -283,6 +380,10 @@ SolverOptions * solver_options_copy(SolverOptions* source)
   if(source->solverParameters)
     options->solverParameters =source->solverParameters;
 
+  // a copy gets its own (empty) trace with the same capacity
+  if(source->stats)
+    solver_options_enable_stats(options, source->stats->capacity);
+
   return options;
 }
 
@@ -457,6 +558,12 @@ SolverOptions * solver_options_create(int solverId)
     break;
   }
 
+  case SICONOS_RELAY_SMALL_ENUM:
+  {
+    options = solver_options_initialize(solverId, 0, 1e-10, 0);
+    break;
+  }
+
   case SICONOS_LCP_ENUM:
   case SICONOS_RELAY_ENUM:
   case SICONOS_FRICTION_2D_ENUM:
@@ -577,6 +684,12 @@ SolverOptions * solver_options_create(int solverId)
     mlcp_enum_set_default(options);
     break;
   }
+  case SICONOS_MLCP_ENUM_GUIDED:
+  {
+    options = solver_options_initialize(solverId, 10000, 1e-12, 0);
+    mlcp_enum_guided_set_default(options);
+    break;
+  }
   case SICONOS_MLCP_DIRECT_ENUM:
   {
     options = solver_options_initialize(solverId, 10000, 1e-12, 0);
@@ -684,7 +797,9 @@ SolverOptions * solver_options_create(int solverId)
     break;
   }
   case SICONOS_FRICTION_3D_NSGS:
+  case SICONOS_FRICTION_3D_NSGS_MULTICOLOR:
   case SICONOS_GLOBAL_FRICTION_3D_NSGS:
+  case SICONOS_GLOBAL_FRICTION_3D_NSGS_MPI:
   case SICONOS_GLOBAL_FRICTION_3D_NSGS_WR:
   {
     options = solver_options_initialize(solverId, 1000, 1e-4, 1);
@@ -692,7 +807,29 @@ SolverOptions * solver_options_create(int solverId)
     break;
   }
 
+  case SICONOS_FRICTION_3D_JACOBI:
+  {
+    options = solver_options_initialize(solverId, 1000, 1e-4, 1);
+    fc3d_jacobi_set_default(options);
+    break;
+  }
+
+  case SICONOS_FRICTION_3D_ISLANDS:
+  {
+    options = solver_options_initialize(solverId, 1000, 1e-4, 1);
+    fc3d_islands_set_default(options);
+    break;
+  }
+
+  case SICONOS_FRICTION_3D_REDUCED:
+  {
+    options = solver_options_initialize(solverId, 1000, 1e-4, 1);
+    fc3d_reduced_set_default(options);
+    break;
+  }
+
   case SICONOS_ROLLING_FRICTION_3D_NSGS:
+  case SICONOS_ROLLING_FRICTION_3D_NSGS_MULTICOLOR:
   {
     options = solver_options_initialize(solverId, 1000, 1e-4, 1);
     rfc3d_nsgs_set_default(options);
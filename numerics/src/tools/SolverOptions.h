@@ -41,6 +41,57 @@ typedef struct {
 			    * this makes sense) and an extra data structure */
 } Callback;
 
+/**
+    One record of the optional per-iteration convergence trace
+*/
+typedef struct {
+  int iter;            /**< iteration number */
+  double residual;     /**< residual/error at the end of the iteration */
+  double step_length;  /**< step length (or penalty, solver-dependent), 0 when
+                          meaningless */
+  int active_set_size; /**< number of active constraints, -1 when not
+                          computed */
+  double time;         /**< seconds elapsed since the trace was (re)enabled */
+} SolverStatsSample;
+
+/**
+    Per-solve hardware-counter record, filled by the top-level drivers
+    (fc3d, gfc3d, lcp) when solver_options_enable_perf_counters() was
+    called. Quantities the host cannot measure are NaN; `available` is 0
+    when no hardware counter at all could be read (the wall-clock time
+    is still valid). The bandwidth/arithmetic ratio of a solve is the
+    usual input for choosing between bandwidth-bound (projection) and
+    compute-bound (Newton, IPM) solvers.
+*/
+typedef struct {
+  int available;       /**< 1 when hardware counters were actually read */
+  double seconds;      /**< wall-clock duration of the driver call */
+  double cycles;       /**< unhalted cpu cycles */
+  double instructions; /**< retired instructions */
+  double ipc;          /**< instructions per cycle */
+  double llc_misses;   /**< last-level cache misses */
+  double dram_bytes;   /**< llc_misses times the cache line size: estimated
+                          traffic to memory */
+} SolverPerfCounters;
+
+/**
+    Fixed-size ring buffer holding the last `capacity` per-iteration
+    records of a solve. The buffer is allocated once when enabled, so
+    recording does not allocate during the solve, and it is polled after
+    (or during) the solve without registering any callback.
+*/
+typedef struct {
+  unsigned int capacity;    /**< number of slots */
+  unsigned long long count; /**< samples pushed since the last reset; the
+                               buffer keeps the last min(count, capacity) */
+  double t0;                /**< reference instant for the time field */
+  SolverStatsSample *samples; /**< the slots (sample k lives in slot
+                                 k % capacity) */
+  int collect_perf;         /**< when 1 the drivers record hardware counters
+                               over the whole solve into `perf` */
+  SolverPerfCounters perf;  /**< record of the last driver call */
+} SolverStats;
+
 // length of iparam/dparam arrays in solver options.
 #define OPTIONS_PARAM_SIZE 20
 
@@ -86,6 +137,9 @@ struct SolverOptions {
   void *solverParameters; /**< additional parameters specific to the solver
                              (GAMS and NewtonMethod only) */
   void *solverData;       /**< additional data specific to the solver */
+  SolverStats *stats;     /**< optional convergence-trace ring buffer; NULL
+                             unless solver_options_enable_stats() was
+                             called */
 };
 
 /** Some value for iparam index */
@@ -174,6 +228,87 @@ void solver_options_update_internal(SolverOptions *parent,
                                     size_t internal_solver_number,
                                     int solver_id);
 
+/**
+   Attach a convergence-trace ring buffer to the options. The buffer is
+   allocated here, once; the solvers that support tracing (fc3d_nsgs,
+   fc3d_admm, gfc3d_ipm, ...) then record one sample per iteration with
+   no further allocation. Re-enabling resizes and resets the trace.
+
+   \param options the options to instrument
+   \param capacity number of per-iteration records to keep (the last
+   `capacity` iterations are available after the solve)
+*/
+void solver_options_enable_stats(SolverOptions *options,
+                                 unsigned int capacity);
+
+/**
+   Free the convergence trace and stop recording.
+
+   \param options the instrumented options
+*/
+void solver_options_disable_stats(SolverOptions *options);
+
+/**
+   Forget the recorded samples (the buffer stays allocated) and restart
+   the time origin.
+
+   \param options the instrumented options
+*/
+void solver_options_stats_reset(SolverOptions *options);
+
+/**
+   Record one per-iteration sample; no-op when no trace is attached, so
+   the call can stay unconditionally in solver loops.
+
+   \param options the (possibly) instrumented options
+   \param iter the iteration number
+   \param residual the residual at the end of the iteration
+   \param step_length the step length, 0 when meaningless
+   \param active_set_size the active set size, -1 when not computed
+*/
+void solver_options_stats_push(SolverOptions *options, int iter,
+                               double residual, double step_length,
+                               int active_set_size);
+
+/**
+   Number of samples recorded since the last reset (may exceed the
+   capacity; only the last min(count, capacity) can be retrieved).
+
+   \param options the instrumented options
+   \return the number of recorded samples
+*/
+unsigned long long solver_options_stats_count(const SolverOptions *options);
+
+/**
+   Poll one recorded sample.
+
+   \param options the instrumented options
+   \param k absolute sample index, in [count - min(count, capacity), count)
+   \return a pointer to the sample, or NULL when k was evicted from the
+   ring (or no trace is attached)
+*/
+const SolverStatsSample *solver_options_stats_get(const SolverOptions *options,
+                                                  unsigned long long k);
+
+/**
+   Ask the top-level drivers to record hardware counters (cycles,
+   instructions, cache misses, estimated memory traffic) over each
+   driver call. Attaches a minimal stats area when none is present; the
+   record is polled with solver_options_perf_counters() after the solve.
+
+   \param options the options to instrument
+*/
+void solver_options_enable_perf_counters(SolverOptions *options);
+
+/**
+   Poll the hardware-counter record of the last driver call.
+
+   \param options the instrumented options
+   \return the record, or NULL when perf counters were never enabled
+*/
+const SolverPerfCounters *
+solver_options_perf_counters(const SolverOptions *options);
+
 /** return the id of a solver based on its name
  *
  *  \param pName the name of the solver
@@ -25,6 +25,7 @@
 #include <stdint.h>            // for SIZE_MAX
 #include <string.h>            // for memcpy
 #include "NumericsArrays.h"    // for NA_merge_and_sort_sorted_arrays
+#include "NumericsTaskPool.h"  // for NTP_first_touch, NTP_default
 #include "SiconosBlas.h"       // for cblas_dscal, cblas_dgemv, CblasNoTrans, max
 #include "SiconosCompat.h"     // for SN_SIZE_T_Fn
 #include "SiconosLapack.h"     // for lapack_int, DGETRF, DGETRI
@@ -35,6 +36,9 @@
 #include "numerics_verbose.h"  // for CHECK_IO, numerics_error, numerics_war...
 #include "op3x3.h"             // for mvp3x3, mvp_alpha3x3
 #include "NSSTools.h"     // for min, max
+#ifdef _OPENMP
+#include <omp.h>               // for omp_get_max_threads
+#endif
 
 
 
@@ -52,6 +56,8 @@
 #endif
 #endif
 
+static struct SBM_index_by_column* SBM_index_by_column_free(struct SBM_index_by_column* p);
+
 static void SBM_inc_version(SparseBlockStructuredMatrix* M)
 {
   NDV_inc(&(M->version));
@@ -70,6 +76,9 @@ void SBM_null(SparseBlockStructuredMatrix* sbm)
   sbm->index1_data = NULL;
   sbm->index2_data = NULL;
   sbm->diagonal_blocks = NULL;
+  sbm->row_schedule = NULL;
+  sbm->column_index = NULL;
+  sbm->block_arena = NULL;
 
   NDV_reset(&(sbm->version));
 }
@@ -84,6 +93,66 @@ SparseBlockStructuredMatrix* SBM_new(void)
   return sbm;
 }
 
+void SBM_compactify(SparseBlockStructuredMatrix * A)
+{
+  assert(A);
+  if(A->block_arena || !A->block || A->filled1 < 2) return;
+
+  /* Total payload size. The blocks are visited by increasing blockNum,
+     which is the row-major order followed by the products: the arena is
+     then read sequentially by SBM_gemv. */
+  size_t total = 0;
+  for(unsigned int currentRowNumber = 0; currentRowNumber < A->filled1 - 1; ++currentRowNumber)
+  {
+    size_t nbRows = A->blocksize0[currentRowNumber];
+    if(currentRowNumber != 0)
+      nbRows -= A->blocksize0[currentRowNumber - 1];
+    for(size_t blockNum = A->index1_data[currentRowNumber];
+        blockNum < A->index1_data[currentRowNumber + 1]; ++blockNum)
+    {
+      size_t colNumber = A->index2_data[blockNum];
+      size_t nbColumns = A->blocksize1[colNumber];
+      if(colNumber != 0)
+        nbColumns -= A->blocksize1[colNumber - 1];
+      total += nbRows * nbColumns;
+    }
+  }
+
+  double * arena = (double *) malloc(total * sizeof(double));
+  assert(arena);
+
+  /* on large payloads, spread the arena pages over the task-pool workers
+     (first-touch NUMA placement) before filling it, so that row-chunked
+     products hinted to the same workers read mostly local memory */
+  if(total * sizeof(double) > (size_t)(1 << 22))
+    NTP_first_touch(NTP_default(), arena, total * sizeof(double));
+
+  /* move each payload into the arena and release its own allocation */
+  size_t pos = 0;
+  for(unsigned int currentRowNumber = 0; currentRowNumber < A->filled1 - 1; ++currentRowNumber)
+  {
+    size_t nbRows = A->blocksize0[currentRowNumber];
+    if(currentRowNumber != 0)
+      nbRows -= A->blocksize0[currentRowNumber - 1];
+    for(size_t blockNum = A->index1_data[currentRowNumber];
+        blockNum < A->index1_data[currentRowNumber + 1]; ++blockNum)
+    {
+      size_t colNumber = A->index2_data[blockNum];
+      size_t nbColumns = A->blocksize1[colNumber];
+      if(colNumber != 0)
+        nbColumns -= A->blocksize1[colNumber - 1];
+      size_t blockSize = nbRows * nbColumns;
+      memcpy(&arena[pos], A->block[blockNum], blockSize * sizeof(double));
+      free(A->block[blockNum]);
+      A->block[blockNum] = &arena[pos];
+      pos += blockSize;
+    }
+  }
+  assert(pos == total);
+
+  A->block_arena = arena;
+}
+
 void SBM_clear(SparseBlockStructuredMatrix *sbm)
 {
   /* Free memory for SparseBlockStructuredMatrix */
@@ -112,12 +181,23 @@ void SBM_clear(SparseBlockStructuredMatrix *sbm)
     sbm->blocksize1 = NULL;
   }
 
-  for(unsigned int i = 0 ; i < sbm->nbblocks ; i++)
+  if(sbm->block_arena)
   {
-    if(sbm->block[i])
-    {
-      free(sbm->block[i]);
+    /* the blocks all point inside the arena, a single allocation */
+    for(unsigned int i = 0 ; i < sbm->nbblocks ; i++)
       sbm->block[i] = NULL;
+    free(sbm->block_arena);
+    sbm->block_arena = NULL;
+  }
+  else
+  {
+    for(unsigned int i = 0 ; i < sbm->nbblocks ; i++)
+    {
+      if(sbm->block[i])
+      {
+        free(sbm->block[i]);
+        sbm->block[i] = NULL;
+      }
     }
   }
 
@@ -145,6 +225,17 @@ void SBM_clear(SparseBlockStructuredMatrix *sbm)
     free(sbm->diagonal_blocks);
     sbm->diagonal_blocks = NULL;
   }
+  if(sbm->row_schedule)
+  {
+    if(sbm->row_schedule->chunk_offsets)
+      free(sbm->row_schedule->chunk_offsets);
+    free(sbm->row_schedule);
+    sbm->row_schedule = NULL;
+  }
+  if(sbm->column_index)
+  {
+    sbm->column_index = SBM_index_by_column_free(sbm->column_index);
+  }
   sbm->filled1 = 0;
   sbm->filled2 = 0;
   sbm->blocknumber0 = 0;
@@ -379,6 +470,155 @@ void SBM_gemv(unsigned int sizeX, unsigned int sizeY, double alpha, const Sparse
     }
   }
 }
+/* Inspector for SBM_gemv_parallel: partition the block rows into nchunks
+   ranges of roughly equal work, the work of a block row being its total
+   number of scalar entries. */
+static void SBM_build_row_schedule(SparseBlockStructuredMatrix* A,
+                                   unsigned int nchunks)
+{
+  if(A->row_schedule)
+  {
+    if(A->row_schedule->chunk_offsets)
+      free(A->row_schedule->chunk_offsets);
+    free(A->row_schedule);
+  }
+
+  unsigned int nrows = (unsigned int)(A->filled1 - 1);
+  if(nchunks > nrows) nchunks = nrows;
+
+  struct SBM_row_schedule* schedule =
+    (struct SBM_row_schedule*) malloc(sizeof(struct SBM_row_schedule));
+  schedule->nchunks = nchunks;
+  schedule->chunk_offsets = (unsigned int*) malloc((nchunks + 1) * sizeof(unsigned int));
+  schedule->filled2 = A->filled2;
+
+  /* per block-row cost and total cost */
+  size_t total_cost = 0;
+  size_t* cost = (size_t*) malloc(nrows * sizeof(size_t));
+  for(unsigned int row = 0; row < nrows; ++row)
+  {
+    unsigned int nbRows = A->blocksize0[row];
+    if(row != 0) nbRows -= A->blocksize0[row - 1];
+    cost[row] = 0;
+    for(size_t blockNum = A->index1_data[row];
+        blockNum < A->index1_data[row + 1]; ++blockNum)
+    {
+      size_t colNumber = A->index2_data[blockNum];
+      unsigned int nbColumns = A->blocksize1[colNumber];
+      if(colNumber != 0) nbColumns -= A->blocksize1[colNumber - 1];
+      cost[row] += (size_t)nbRows * nbColumns;
+    }
+    total_cost += cost[row];
+  }
+
+  /* greedy prefix partition: close a chunk once its cost reaches the
+     average remaining cost per chunk */
+  schedule->chunk_offsets[0] = 0;
+  unsigned int chunk = 0;
+  size_t chunk_cost = 0;
+  size_t remaining_cost = total_cost;
+  for(unsigned int row = 0; row < nrows; ++row)
+  {
+    chunk_cost += cost[row];
+    remaining_cost -= cost[row];
+    unsigned int chunks_left = nchunks - chunk;
+    if(chunk_cost * chunks_left >= chunk_cost + remaining_cost
+        && chunk + 1 < nchunks
+        && nrows - row - 1 >= nchunks - chunk - 1)
+    {
+      schedule->chunk_offsets[++chunk] = row + 1;
+      chunk_cost = 0;
+    }
+  }
+  while(chunk < nchunks)
+    schedule->chunk_offsets[++chunk] = nrows;
+
+  free(cost);
+  A->row_schedule = schedule;
+}
+
+/* product of the block rows [row_begin, row_end) with x, accumulated
+   into beta*y; the shared inner loop of SBM_gemv restricted to a range */
+static void SBM_gemv_row_range(unsigned int row_begin, unsigned int row_end,
+                               double alpha,
+                               const SparseBlockStructuredMatrix* const restrict A,
+                               const double* restrict x, double beta,
+                               double* restrict y)
+{
+  for(unsigned int currentRowNumber = row_begin; currentRowNumber < row_end;
+      ++currentRowNumber)
+  {
+    unsigned int nbRows = A->blocksize0[currentRowNumber];
+    unsigned int posInY = 0;
+    if(currentRowNumber != 0)
+    {
+      posInY = A->blocksize0[currentRowNumber - 1];
+      nbRows -= posInY;
+    }
+    cblas_dscal(nbRows, beta, &y[posInY], 1);
+    for(size_t blockNum = A->index1_data[currentRowNumber];
+        blockNum < A->index1_data[currentRowNumber + 1]; ++blockNum)
+    {
+      size_t colNumber = A->index2_data[blockNum];
+      unsigned int nbColumns = A->blocksize1[colNumber];
+      unsigned int posInX = 0;
+      if(colNumber != 0)
+      {
+        posInX = A->blocksize1[colNumber - 1];
+        nbColumns -= posInX;
+      }
+      if(nbRows == 3 && nbColumns == 3)
+      {
+        mvp_alpha3x3(alpha, A->block[blockNum], &x[posInX], &y[posInY]);
+      }
+      else
+      {
+        cblas_dgemv(CblasColMajor, CblasNoTrans, nbRows, nbColumns, alpha,
+                    A->block[blockNum], nbRows, &x[posInX], 1, 1.0, &y[posInY], 1);
+      }
+    }
+  }
+}
+
+void SBM_gemv_parallel(unsigned int sizeX, unsigned int sizeY, double alpha,
+                       SparseBlockStructuredMatrix* A,
+                       const double* restrict x, double beta,
+                       double* restrict y)
+{
+  assert(A);
+  assert(x);
+  assert(y);
+
+#ifdef _OPENMP
+  unsigned int nrows = (unsigned int)(A->filled1 - 1);
+  unsigned int nthreads = (unsigned int)omp_get_max_threads();
+
+  /* parallelism does not pay off on small matrices */
+  if(nthreads <= 1 || nrows < 4 * nthreads)
+  {
+    SBM_gemv(sizeX, sizeY, alpha, A, x, beta, y);
+    return;
+  }
+
+  if(!A->row_schedule || A->row_schedule->filled2 != A->filled2
+      || A->row_schedule->nchunks != nthreads)
+  {
+    SBM_build_row_schedule(A, nthreads);
+  }
+
+  struct SBM_row_schedule* schedule = A->row_schedule;
+  #pragma omp parallel for schedule(static, 1)
+  for(unsigned int chunk = 0; chunk < schedule->nchunks; ++chunk)
+  {
+    SBM_gemv_row_range(schedule->chunk_offsets[chunk],
+                       schedule->chunk_offsets[chunk + 1],
+                       alpha, A, x, beta, y);
+  }
+#else
+  SBM_gemv(sizeX, sizeY, alpha, A, x, beta, y);
+#endif
+}
+
 void SBM_gemv_3x3(unsigned int sizeX, unsigned int sizeY, const SparseBlockStructuredMatrix* const restrict A,  double* const restrict x, double* restrict y)
 {
   /* Product SparseMat - vector, y = vector product y += alpha*A*x  for block of size 3x3 */
@@ -521,6 +761,87 @@ void SBM_extract_component_3x3(const SparseBlockStructuredMatrix* const restrict
   DEBUG_EXPR(SBM_print(B));
 }
 
+SparseBlockStructuredMatrix* SBM_extract_principal_submatrix(
+  const SparseBlockStructuredMatrix* const A,
+  const unsigned int* block_indices, unsigned int block_indices_size)
+{
+  assert(A);
+  assert(A->blocknumber0 == A->blocknumber1);
+  assert(block_indices);
+  assert(block_indices_size > 0);
+  assert(block_indices[block_indices_size - 1] < A->blocknumber0);
+
+  SparseBlockStructuredMatrix* S = SBM_new();
+  S->blocknumber0 = block_indices_size;
+  S->blocknumber1 = block_indices_size;
+  S->blocksize0 = (unsigned int*)malloc(block_indices_size * sizeof(unsigned int));
+  S->blocksize1 = (unsigned int*)malloc(block_indices_size * sizeof(unsigned int));
+
+  /* map from block column of A to block column of S, -1 for discarded */
+  long* col_of = (long*)malloc(A->blocknumber1 * sizeof(long));
+  for(unsigned int j = 0; j < A->blocknumber1; ++j) col_of[j] = -1;
+
+  unsigned int sum = 0;
+  for(unsigned int i = 0; i < block_indices_size; ++i)
+  {
+    unsigned int b = block_indices[i];
+    col_of[b] = (long)i;
+    sum += A->blocksize0[b] - (b ? A->blocksize0[b - 1] : 0);
+    S->blocksize0[i] = sum;
+    S->blocksize1[i] = sum; /* principal: row and column cuts coincide */
+  }
+
+  /* count the retained blocks, then fill the index structure; the
+     blocks themselves are shared with A */
+  S->filled1 = block_indices_size + 1;
+  S->index1_data = (size_t*)malloc(S->filled1 * sizeof(size_t));
+  S->index1_data[0] = 0;
+  size_t nb = 0;
+  for(unsigned int i = 0; i < block_indices_size; ++i)
+  {
+    unsigned int row = block_indices[i];
+    if(row + 1 < A->filled1)
+      for(size_t k = A->index1_data[row]; k < A->index1_data[row + 1]; ++k)
+        if(col_of[A->index2_data[k]] >= 0) ++nb;
+    S->index1_data[i + 1] = nb;
+  }
+  S->nbblocks = (unsigned int)nb;
+  S->filled2 = nb;
+  S->index2_data = (size_t*)malloc(nb * sizeof(size_t));
+  S->block = (double**)malloc(nb * sizeof(double*));
+  nb = 0;
+  for(unsigned int i = 0; i < block_indices_size; ++i)
+  {
+    unsigned int row = block_indices[i];
+    if(row + 1 < A->filled1)
+      for(size_t k = A->index1_data[row]; k < A->index1_data[row + 1]; ++k)
+      {
+        long col = col_of[A->index2_data[k]];
+        if(col >= 0)
+        {
+          S->index2_data[nb] = (size_t)col;
+          S->block[nb] = A->block[k];
+          ++nb;
+        }
+      }
+  }
+  free(col_of);
+  return S;
+}
+
+void SBM_free_principal_submatrix(SparseBlockStructuredMatrix* sbm)
+{
+  assert(sbm);
+  /* the payloads belong to the source matrix: detach them so that
+     SBM_clear only releases the index structure built by the
+     extraction (and whatever diagonal index or row schedule was cached
+     on the submatrix afterwards) */
+  for(unsigned int i = 0; i < sbm->nbblocks; ++i)
+    sbm->block[i] = NULL;
+  SBM_clear(sbm);
+  free(sbm);
+}
+
 static int SBM_check_compatibility_for_add(const SparseBlockStructuredMatrix* const A, const SparseBlockStructuredMatrix* const B)
 {
   DEBUG_BEGIN(" SBM_check_compatibility_for_add(...)\n");
@@ -822,41 +1143,65 @@ static  struct SBM_index_by_column*  SBM_index_by_column_free(struct SBM_index_b
 
 static void SBM_index_by_column_compute(const SparseBlockStructuredMatrix* const M, struct SBM_index_by_column * SBM_index_by_column_M)
 {
-
+  /* Counting sort over the columns: one pass counts the blocks of each
+     column, a prefix sum turns the counts into column pointers, and a
+     second pass over the rows (in order, so each column comes out sorted
+     by row) scatters the blocks. O(nbblocks + blocknumber1), where the
+     previous column-by-column scan was O(nbblocks * blocknumber1). */
   SBM_index_by_column_M->filled3 = M->blocknumber1 + 1;
-  SBM_index_by_column_M->index3_data = (size_t *)malloc(SBM_index_by_column_M->filled3 * sizeof(size_t));;
+  SBM_index_by_column_M->index3_data = (size_t *)malloc(SBM_index_by_column_M->filled3 * sizeof(size_t));
 
   SBM_index_by_column_M->filled4 =  M->nbblocks;
-  SBM_index_by_column_M->index4_data = (size_t *)malloc(SBM_index_by_column_M->filled4 * sizeof(size_t));;
-
-  size_t blockNumM = 0;
-  SBM_index_by_column_M->index3_data[0] = 0;
+  SBM_index_by_column_M->index4_data = (size_t *)malloc(SBM_index_by_column_M->filled4 * sizeof(size_t));
   SBM_index_by_column_M->blockMap  = (size_t *)malloc(SBM_index_by_column_M->filled4 * sizeof(size_t));
-  unsigned int currentRowNumberofM;
-  unsigned int currentColNumberofM;
-  size_t colNumberofM ;
-  for(currentColNumberofM = 0 ; currentColNumberofM < SBM_index_by_column_M->filled3 - 1; ++currentColNumberofM)
+  SBM_index_by_column_M->filled1 = M->filled1;
+
+  size_t * index3_data = SBM_index_by_column_M->index3_data;
+  for(size_t col = 0; col < SBM_index_by_column_M->filled3; ++col)
+    index3_data[col] = 0;
+  for(size_t blockNum = 0; blockNum < M->filled2; ++blockNum)
   {
-    SBM_index_by_column_M->index3_data[currentColNumberofM + 1] = SBM_index_by_column_M->index3_data[currentColNumberofM];
+    assert(M->index2_data[blockNum] + 1 < SBM_index_by_column_M->filled3);
+    index3_data[M->index2_data[blockNum] + 1]++;
+  }
+  for(size_t col = 0; col < SBM_index_by_column_M->filled3 - 1; ++col)
+    index3_data[col + 1] += index3_data[col];
 
-    for(currentRowNumberofM = 0 ; currentRowNumberofM < M->filled1 - 1; ++currentRowNumberofM)
+  size_t * fill = (size_t *)calloc(M->blocknumber1, sizeof(size_t));
+  for(unsigned int currentRowNumberofM = 0;
+      currentRowNumberofM < M->filled1 - 1; ++currentRowNumberofM)
+  {
+    for(size_t blockNum = M->index1_data[currentRowNumberofM];
+        blockNum < M->index1_data[currentRowNumberofM + 1]; ++blockNum)
     {
-      for(size_t blockNum = M->index1_data[currentRowNumberofM];
-          blockNum < M->index1_data[currentRowNumberofM + 1]; ++blockNum)
-      {
-        assert(blockNum < M->filled2);
-        colNumberofM = M->index2_data[blockNum];
-        if(colNumberofM == currentColNumberofM)
-        {
-          assert(blockNumM < M->nbblocks);
-          SBM_index_by_column_M->index3_data[currentColNumberofM + 1]++;
-          SBM_index_by_column_M->index4_data[blockNumM] = currentRowNumberofM;
-          SBM_index_by_column_M->blockMap[blockNumM] = blockNum;
-          blockNumM++;
-        }
-      }
+      assert(blockNum < M->filled2);
+      size_t colNumberofM = M->index2_data[blockNum];
+      size_t blockNumM = index3_data[colNumberofM] + fill[colNumberofM]++;
+      assert(blockNumM < M->nbblocks);
+      SBM_index_by_column_M->index4_data[blockNumM] = currentRowNumberofM;
+      SBM_index_by_column_M->blockMap[blockNumM] = blockNum;
     }
   }
+  free(fill);
+}
+
+struct SBM_index_by_column * SBM_column_index(const SparseBlockStructuredMatrix* const M)
+{
+  /* the cache is part of the matrix, mutating it keeps M logically const */
+  SparseBlockStructuredMatrix * m = (SparseBlockStructuredMatrix *)M;
+  struct SBM_index_by_column * index = m->column_index;
+  if(index
+     && index->filled1 == M->filled1
+     && index->filled3 == M->blocknumber1 + 1
+     && index->filled4 == M->nbblocks)
+    return index;
+
+  if(index)
+    SBM_index_by_column_free(index);
+  index = SBM_index_by_column_new();
+  SBM_index_by_column_compute(M, index);
+  m->column_index = index;
+  return index;
 }
 
 static int SBM_check_compatibility_for_multiply(const SparseBlockStructuredMatrix* const A, const SparseBlockStructuredMatrix* const B)
@@ -998,13 +1343,12 @@ SparseBlockStructuredMatrix*  SBM_zero_matrix_for_multiply(const SparseBlockStru
   }
 
   /* indexation of B by column */
-  struct SBM_index_by_column* B_index_by_column = SBM_index_by_column_new();
-  SBM_index_by_column_compute(B, B_index_by_column);
+  /* cached on B, rebuilt only when its block structure changed */
+  struct SBM_index_by_column* B_index_by_column = SBM_column_index(B);
 
   /* allocation of C */
   SparseBlockStructuredMatrix*  C = SBM_calloc_multiply(A, B, B_index_by_column);
 
-  SBM_index_by_column_free(B_index_by_column);
 
   DEBUG_END("SBM_zero_matrix_for_multiply\n");
 
@@ -1013,6 +1357,19 @@ SparseBlockStructuredMatrix*  SBM_zero_matrix_for_multiply(const SparseBlockStru
 
 
 
+/* hand-unrolled C += A*B on column-major 3x3 blocks */
+static inline void SBM_gemm_3x3_block(const double* restrict a, const double* restrict b,
+                                      double* restrict c)
+{
+  for(int j = 0; j < 3; ++j)
+  {
+    double b0 = b[3*j], b1 = b[3*j+1], b2 = b[3*j+2];
+    c[3*j]   += a[0]*b0 + a[3]*b1 + a[6]*b2;
+    c[3*j+1] += a[1]*b0 + a[4]*b1 + a[7]*b2;
+    c[3*j+2] += a[2]*b0 + a[5]*b1 + a[8]*b2;
+  }
+}
+
 SparseBlockStructuredMatrix*  SBM_multiply(const SparseBlockStructuredMatrix* const A, const SparseBlockStructuredMatrix* const B)
 {
   DEBUG_BEGIN("SBM_multiply\(...)\n");
@@ -1029,8 +1386,8 @@ SparseBlockStructuredMatrix*  SBM_multiply(const SparseBlockStructuredMatrix* co
   }
 
   /* indexation of B by column */
-  struct SBM_index_by_column* B_index_by_column = SBM_index_by_column_new();
-  SBM_index_by_column_compute(B, B_index_by_column);
+  /* cached on B, rebuilt only when its block structure changed */
+  struct SBM_index_by_column* B_index_by_column = SBM_column_index(B);
 
   /* allocation of C */
   SparseBlockStructuredMatrix*  C = SBM_calloc_multiply(A, B, B_index_by_column);
@@ -1044,35 +1401,42 @@ SparseBlockStructuredMatrix*  SBM_multiply(const SparseBlockStructuredMatrix* co
   double alpha = 1.0;
   double beta =  1.0; /* We assume that C is zero */
 
-  size_t colNumberAA;
-  size_t rowNumberBB;
-
-  int Cnbblocks = -1;
-
-  for(size_t currentRowNumberofA = 0 ; currentRowNumberofA < A->filled1 - 1; ++currentRowNumberofA)
+  /* The structure of C (index1_data, index2_data, zeroed blocks) is
+     entirely known after the symbolic pass done in SBM_calloc_multiply,
+     so the block rows of C are independent and computed in parallel.
+     Within one row, the blocks of C are numbered from
+     C->index1_data[row] onwards, in increasing block-column order, the
+     order in which the loop below visits them. */
+  int nrowsA = (int)(A->filled1 - 1);
+#if defined(_OPENMP)
+  #pragma omp parallel for schedule(dynamic) if(nrowsA > 16)
+#endif
+  for(int currentRowNumberofA = 0 ; currentRowNumberofA < nrowsA; ++currentRowNumberofA)
   {
+    size_t Cblocknum = C->index1_data[currentRowNumberofA];
     int Ablocksize0 = A->blocksize0[currentRowNumberofA];
     if(currentRowNumberofA != 0)
       Ablocksize0  -= A->blocksize0[currentRowNumberofA - 1];
     for(size_t currentColNumberofB = 0 ; currentColNumberofB < Bfilled3 - 1; ++currentColNumberofB)
     {
-      DEBUG_PRINTF("\n computation of the block of C(%zu,%zu)\n",currentRowNumberofA,currentColNumberofB);
+      DEBUG_PRINTF("\n computation of the block of C(%i,%zu)\n",currentRowNumberofA,currentColNumberofB);
       int Bblocksize1 = B->blocksize1[currentColNumberofB];
       if(currentColNumberofB != 0)
         Bblocksize1 -= B->blocksize1[currentColNumberofB - 1];
       /*           printf("of size %dX%d\n",Ablocksize0,Bblocksize1  ); */
       int CblockPassed = 1;
+      double * Cblock = NULL;
       for(size_t blockNumAA = A->index1_data[currentRowNumberofA];
           blockNumAA < A->index1_data[currentRowNumberofA + 1]; ++blockNumAA)
       {
         assert(blockNumAA < A->filled2);
-        colNumberAA = A->index2_data[blockNumAA];
+        size_t colNumberAA = A->index2_data[blockNumAA];
         DEBUG_PRINTF("blockNumAA = %zu, colNumberAA = %zu\n",blockNumAA,colNumberAA);
 
         for(size_t blockNumBB = Bindex3_data[currentColNumberofB];
             blockNumBB < Bindex3_data[currentColNumberofB + 1]; ++blockNumBB)
         {
-          rowNumberBB = Bindex4_data[blockNumBB];
+          size_t rowNumberBB = Bindex4_data[blockNumBB];
           DEBUG_PRINTF("blockNumBB = %zu, rowNumberBB = %zu\n",blockNumBB,rowNumberBB);
           DEBUG_PRINTF("blocMap[blockNumBB] = %zu, rowNumberBB = %zu\n",blockMap[blockNumBB],rowNumberBB);
 
@@ -1080,11 +1444,13 @@ SparseBlockStructuredMatrix*  SBM_multiply(const SparseBlockStructuredMatrix* co
           {
             if(CblockPassed)
             {
-              Cnbblocks++; /* Find the right C block number*/
+              /* Find the right C block number*/
+              assert(Cblocknum < C->index1_data[currentRowNumberofA + 1]);
+              assert(C->index2_data[Cblocknum] == currentColNumberofB);
+              Cblock = C->block[Cblocknum];
+              Cblocknum++;
               CblockPassed = 0;
             }
-            assert(Cnbblocks < (int) C->nbblocks);
-            /*           printf("Compute C block number %i for %i %i ", Cnbblocks,currentRowNumberofA, currentColNumberofB ); */
 
             int Ablocksize1 = A->blocksize1[colNumberAA];
             if(colNumberAA != 0)
@@ -1095,29 +1461,31 @@ SparseBlockStructuredMatrix*  SBM_multiply(const SparseBlockStructuredMatrix* co
               Bblocksize0 -= B->blocksize0[rowNumberBB - 1];
 
 
-            DEBUG_PRINTF("Contribution of the product of blocks matrices A(%zu,%zu) (block number %zu) and B(%zu,%zu) (block number %zu) of  sizes %dX%d by %dX%d\n",
+            DEBUG_PRINTF("Contribution of the product of blocks matrices A(%i,%zu) (block number %zu) and B(%zu,%zu) (block number %zu) of  sizes %dX%d by %dX%d\n",
                          currentRowNumberofA,colNumberAA, blockNumAA, rowNumberBB, currentColNumberofB, blockMap[blockNumBB],
                          Ablocksize0,Ablocksize1,Bblocksize0,Bblocksize1);
 
 
             assert(Ablocksize1 == Bblocksize0);
 
-            /*            printf("DGEMM call\n"); */
-            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans,
-                        Ablocksize0, Bblocksize1, Ablocksize1, alpha, A->block[blockNumAA],
-                        Ablocksize0, B->block[blockMap[blockNumBB]], Bblocksize0,
-                        beta, C->block[Cnbblocks], Ablocksize0);
+            if(Ablocksize0 == 3 && Ablocksize1 == 3 && Bblocksize1 == 3)
+            {
+              /* the ubiquitous 3x3 blocks of the friction-contact
+                 matrices: the unrolled kernel beats a cblas_dgemm call
+                 at this size */
+              SBM_gemm_3x3_block(A->block[blockNumAA], B->block[blockMap[blockNumBB]], Cblock);
+            }
+            else
+            {
+              cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans,
+                          Ablocksize0, Bblocksize1, Ablocksize1, alpha, A->block[blockNumAA],
+                          Ablocksize0, B->block[blockMap[blockNumBB]], Bblocksize0,
+                          beta, Cblock, Ablocksize0);
+            }
 
             DEBUG_EXPR(NM_dense_display(A->block[blockNumAA], Ablocksize0, Ablocksize1, 0););
             DEBUG_EXPR(NM_dense_display(B->block[blockMap[blockNumBB]], Bblocksize0, Bblocksize1, 0););
-            DEBUG_EXPR(NM_dense_display(C->block[Cnbblocks], Ablocksize0, Bblocksize1, 0););
-
-            /*           for (i=0;i<Ablocksize0;i++) */
-            /*        { */
-            /*            for (j=0;j<Bblocksize1;j++)  { */
-            /*         printf("C->block[%i](%i,%i) = %f\n",Cnbblocks,i,j, C->block[Cnbblocks][i+j*Ablocksize0]); */
-            /*            } */
-            /*        } */
+            DEBUG_EXPR(NM_dense_display(Cblock, Ablocksize0, Bblocksize1, 0););
 
           }
           ; /* printf("\n"); */
@@ -1127,11 +1495,9 @@ SparseBlockStructuredMatrix*  SBM_multiply(const SparseBlockStructuredMatrix* co
       }
 
     }
+    assert(Cblocknum == C->index1_data[currentRowNumberofA + 1]);
   }
 
-  assert((Cnbblocks + 1) == (int) C->nbblocks);
-
-  SBM_index_by_column_free(B_index_by_column);
 
   /* SBM_print(C); */
 
@@ -1282,8 +1648,8 @@ void SBM_gemm_without_allocation(double alpha, const SparseBlockStructuredMatrix
   /*  Check the compatibility of the number and the sizes of blocks */
   assert(SBM_check_compatibility_for_multiply(A,B));
 
-  struct SBM_index_by_column* B_index_by_column = SBM_index_by_column_new();
-  SBM_index_by_column_compute(B, B_index_by_column);
+  /* cached on B, rebuilt only when its block structure changed */
+  struct SBM_index_by_column* B_index_by_column = SBM_column_index(B);
 
 
   /*  Check the memory allocation in C */
@@ -1384,7 +1750,6 @@ void SBM_gemm_without_allocation(double alpha, const SparseBlockStructuredMatrix
     }
   }
 
-  SBM_index_by_column_free(B_index_by_column);
 
   DEBUG_END("SBM_gemm_without_allocation\(...)\n")
 }
@@ -2302,10 +2667,21 @@ int SBM_copy(const SparseBlockStructuredMatrix* const A, SparseBlockStructuredMa
   if(B->nbblocks < A->nbblocks)
   {
     need_blocks = 1;
-    for(unsigned i=0; i<B->nbblocks; ++i)
+    if(B->block_arena)
     {
-      free(B->block [i]);
-      B->block [i] = NULL;
+      /* compacted target: the blocks live in a single allocation */
+      free(B->block_arena);
+      B->block_arena = NULL;
+      for(unsigned i=0; i<B->nbblocks; ++i)
+        B->block [i] = NULL;
+    }
+    else
+    {
+      for(unsigned i=0; i<B->nbblocks; ++i)
+      {
+        free(B->block [i]);
+        B->block [i] = NULL;
+      }
     }
     B->block = (double **) realloc(B->block, A->nbblocks * sizeof(double *));
   }
@@ -2426,39 +2802,14 @@ int SBM_transpose(const SparseBlockStructuredMatrix* const A, SparseBlockStructu
   B->index2_data = (size_t *)malloc(B->filled2 * sizeof(size_t));
 
 
-  unsigned int currentRowNumberofA;
-  unsigned int currentColNumberofA ;
-  size_t colNumberofA;
-
-  size_t * blockMap  = (size_t *)malloc(B->filled2 * sizeof(size_t));
-
-
-
-  int blockNumB = -1;
-  B->index1_data[0] = 0;
-  for(currentColNumberofA = 0 ; currentColNumberofA < A->blocknumber1; ++currentColNumberofA)
-  {
-    assert(currentColNumberofA + 1 < B->filled1);
-    B->index1_data[currentColNumberofA + 1] = B->index1_data[currentColNumberofA];
-    for(currentRowNumberofA = 0 ; currentRowNumberofA < A->blocknumber0; ++currentRowNumberofA)
-    {
-      for(size_t blockNum = A->index1_data[currentRowNumberofA];
-          blockNum < A->index1_data[currentRowNumberofA + 1]; ++blockNum)
-      {
-        assert(blockNum < B->filled2);
-        colNumberofA = A->index2_data[blockNum];
-        if(colNumberofA == currentColNumberofA)
-        {
-          blockNumB++;
-          assert(blockNumB < (int) B->nbblocks && blockNumB >= 0);
-          B->index1_data[currentColNumberofA + 1]++;
-          B->index2_data[blockNumB] = currentRowNumberofA;
-          blockMap[blockNumB] = blockNum;
-
-        }
-      }
-    }
-  }
+  /* the structure of the transpose is exactly the column-major view of
+     A: column pointers, row numbers, and the map back to the row-major
+     block storage; the view is cached on A and reused across calls */
+  struct SBM_index_by_column* A_by_column = SBM_column_index(A);
+  memcpy(B->index1_data, A_by_column->index3_data, B->filled1 * sizeof(size_t));
+  for(size_t blockNum = 0; blockNum < B->filled2; ++blockNum)
+    B->index2_data[blockNum] = A_by_column->index4_data[blockNum];
+  size_t * blockMap = A_by_column->blockMap;
 
 #ifdef VERBOSE_DEBUG
   printf("----------------- blockMap ---------------\n");
@@ -2492,27 +2843,130 @@ int SBM_transpose(const SparseBlockStructuredMatrix* const A, SparseBlockStructu
       int lengthblock = nbRows * nbColumns;
       B->block[blockNum] = (double*)malloc(lengthblock * sizeof(double));
 
-
-
-
-      for(unsigned int i = 0; i < nbRows; i++)
+      const double * Ablock = A->block[blockMap[blockNum]];
+      double * Bblock = B->block[blockNum];
+      if(nbRows > 32 || nbColumns > 32)
       {
-        for(unsigned int j = 0; j < nbColumns; j++)
+        /* blocked transpose for large blocks: reads and writes both stay
+           inside one tile at a time instead of one of them striding the
+           whole block between consecutive accesses */
+        for(unsigned int jj = 0; jj < nbColumns; jj += 32)
         {
-          assert(i + j * nbRows < nbRows * nbColumns);
-          assert(j + i * nbColumns < nbRows * nbColumns);
-
-          B->block[blockNum] [i + j * nbRows ] = A->block[blockMap[blockNum]] [j + i * nbColumns] ;
+          unsigned int jmax = jj + 32 < nbColumns ? jj + 32 : nbColumns;
+          for(unsigned int ii = 0; ii < nbRows; ii += 32)
+          {
+            unsigned int imax = ii + 32 < nbRows ? ii + 32 : nbRows;
+            for(unsigned int i = ii; i < imax; i++)
+              for(unsigned int j = jj; j < jmax; j++)
+                Bblock[i + j * nbRows] = Ablock[j + i * nbColumns];
+          }
         }
       }
+      else
+      {
+        for(unsigned int i = 0; i < nbRows; i++)
+        {
+          for(unsigned int j = 0; j < nbColumns; j++)
+          {
+            assert(i + j * nbRows < nbRows * nbColumns);
+            assert(j + i * nbColumns < nbRows * nbColumns);
 
+            Bblock[i + j * nbRows] = Ablock[j + i * nbColumns];
+          }
+        }
+      }
     }
   }
-  free(blockMap);
 
+  return 0;
+}
+/* Closed-form inverse of a 3x3 block (column-major storage), by cofactor
+ * expansion.
+ * \return 0 if ok, 1 if the block is numerically singular (the block is
+ * then left untouched) */
+static int SBM_block_inverse_3x3(double* a)
+{
+  double c00 = a[4] * a[8] - a[7] * a[5];
+  double c01 = a[7] * a[2] - a[1] * a[8];
+  double c02 = a[1] * a[5] - a[4] * a[2];
+  double det = a[0] * c00 + a[3] * c01 + a[6] * c02;
+  if(fabs(det) < DBL_EPSILON) return 1;
+  double idet = 1.0 / det;
+  double b[9];
+  b[0] = c00 * idet;
+  b[1] = c01 * idet;
+  b[2] = c02 * idet;
+  b[3] = (a[6] * a[5] - a[3] * a[8]) * idet;
+  b[4] = (a[0] * a[8] - a[6] * a[2]) * idet;
+  b[5] = (a[3] * a[2] - a[0] * a[5]) * idet;
+  b[6] = (a[3] * a[7] - a[6] * a[4]) * idet;
+  b[7] = (a[6] * a[1] - a[0] * a[7]) * idet;
+  b[8] = (a[0] * a[4] - a[3] * a[1]) * idet;
+  memcpy(a, b, 9 * sizeof(double));
+  return 0;
+}
+
+/* Inverse of a 6x6 block (column-major storage) by Gauss--Jordan
+ * elimination with partial pivoting. All loops have fixed bounds on
+ * stack storage, so the compiler can fully unroll them.
+ * \return 0 if ok, 1 if the block is numerically singular (the block is
+ * then left untouched) */
+static int SBM_block_inverse_6x6(double* a)
+{
+  double w[36];
+  double inv[36] = {0.};
+  memcpy(w, a, 36 * sizeof(double));
+  for(int i = 0; i < 6; i++) inv[i * 6 + i] = 1.0;
 
+  for(int col = 0; col < 6; col++)
+  {
+    /* partial pivoting on column col */
+    int piv = col;
+    double pmax = fabs(w[col * 6 + col]);
+    for(int row = col + 1; row < 6; row++)
+    {
+      double v = fabs(w[col * 6 + row]);
+      if(v > pmax)
+      {
+        pmax = v;
+        piv = row;
+      }
+    }
+    if(pmax < DBL_EPSILON) return 1;
+    if(piv != col)
+    {
+      for(int c = 0; c < 6; c++)
+      {
+        double t = w[c * 6 + col];
+        w[c * 6 + col] = w[c * 6 + piv];
+        w[c * 6 + piv] = t;
+        t = inv[c * 6 + col];
+        inv[c * 6 + col] = inv[c * 6 + piv];
+        inv[c * 6 + piv] = t;
+      }
+    }
+    double scale = 1.0 / w[col * 6 + col];
+    for(int c = 0; c < 6; c++)
+    {
+      w[c * 6 + col] *= scale;
+      inv[c * 6 + col] *= scale;
+    }
+    for(int row = 0; row < 6; row++)
+    {
+      if(row == col) continue;
+      double f = w[col * 6 + row];
+      if(f == 0.0) continue;
+      for(int c = 0; c < 6; c++)
+      {
+        w[c * 6 + row] -= f * w[c * 6 + col];
+        inv[c * 6 + row] -= f * inv[c * 6 + col];
+      }
+    }
+  }
+  memcpy(a, inv, 36 * sizeof(double));
   return 0;
 }
+
 int SBM_inverse_diagonal_block_matrix_in_place(const SparseBlockStructuredMatrix*  M,  int* ipiv)
 {
   for(unsigned int i = 0; i < M->filled1 - 1; i++)
@@ -2533,6 +2987,42 @@ int SBM_inverse_diagonal_block_matrix_in_place(const SparseBlockStructuredMatrix
     }
   }
 
+  /* Fast path: diagonal blocks of size 3 (frictional contact) or 6
+   * (Newton--Euler linearisations) are inverted with size-specialized
+   * kernels, in one pass over the contiguous block array without any
+   * LAPACK call overhead, and in parallel since the blocks are
+   * independent. Other block sizes take the LAPACK path below. */
+  int specialized = 1;
+  for(unsigned int i = 0; i < M->filled1 - 1; i++)
+  {
+    unsigned int nb = M->blocksize0[i];
+    if(i != 0) nb -= M->blocksize0[i - 1];
+    if(nb != 3 && nb != 6)
+    {
+      specialized = 0;
+      break;
+    }
+  }
+  if(specialized)
+  {
+    int singular = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(|:singular)
+#endif
+    for(int blockNum = 0; blockNum < (int)M->filled2; ++blockNum)
+    {
+      /* diagonal structure (checked above): blockNum is the row number */
+      unsigned int nb = M->blocksize0[blockNum];
+      if(blockNum != 0) nb -= M->blocksize0[blockNum - 1];
+      if(nb == 3)
+        singular |= SBM_block_inverse_3x3(M->block[blockNum]);
+      else
+        singular |= SBM_block_inverse_6x6(M->block[blockNum]);
+    }
+    assert(!singular);
+    return singular ? 1 : 0;
+  }
+
   unsigned int currentRowNumber ;
   size_t colNumber;
   unsigned int nbRows, nbColumns;
@@ -3288,8 +3778,16 @@ void SBMfree(SparseBlockStructuredMatrix* A, unsigned int level)
 
   if(level & NUMERICS_SBM_FREE_BLOCK)
   {
-    for(unsigned int i = 0; i < A->nbblocks; i++)
-      free(A->block[i]);
+    if(A->block_arena)
+    {
+      free(A->block_arena);
+      A->block_arena = NULL;
+    }
+    else
+    {
+      for(unsigned int i = 0; i < A->nbblocks; i++)
+        free(A->block[i]);
+    }
   }
   free(A->block);
   free(A->blocksize0);
@@ -134,9 +134,39 @@ struct SparseBlockStructuredMatrix
   /* the indices of the diagonal blocks */
   unsigned int * diagonal_blocks;
 
+  /* inspector-built schedule for parallel products over block rows
+     (built lazily by SBM_gemv_parallel, freed by SBM_clear) */
+  struct SBM_row_schedule * row_schedule;
+
+  /* cached column-major view over the block structure (built lazily by
+     SBM_column_index, freed by SBM_clear) */
+  struct SBM_index_by_column * column_index;
+
+  /* if not NULL, single allocation holding every block payload in
+     traversal (blockNum) order; the entries of block then point inside
+     it (see SBM_compactify) */
+  double * block_arena;
+
   NumericsDataVersion version; /**< version of storage */
 };
 
+/** \struct SBM_row_schedule SparseBlockMatrix.h
+    Partition of the block rows of a SparseBlockStructuredMatrix into
+    chunks of roughly equal work (number of scalar entries), used to
+    load-balance parallel products. The schedule is reused while the
+    block structure is unchanged. */
+struct SBM_row_schedule
+{
+  /** number of chunks */
+  unsigned int nchunks;
+  /** block-row ranges: chunk c covers rows
+      [chunk_offsets[c], chunk_offsets[c+1]) */
+  unsigned int * chunk_offsets;
+  /** filled2 of the matrix when the schedule was built, to detect
+      structural changes */
+  size_t filled2;
+};
+
 struct SparseBlockCoordinateMatrix
 {
   /** number of blocks */
@@ -181,16 +211,25 @@ struct SparseBlockStructuredMatrixPred
   double **workspace;
 };
 
+/** CSC-like view over the block structure of a SparseBlockStructuredMatrix:
+    the stored blocks listed column by column, sorted by row inside each
+    column, with blockMap giving the position of each listed block in the
+    row-major storage. Built by SBM_column_index() (cached on the matrix)
+    or filled directly with SBM_index_by_column_compute-style passes. */
 struct SBM_index_by_column
 {
-  /* the index of the last non empty line + 1 */
+  /* the index of the last non empty column + 1 */
   size_t filled3;
-  /* the size of index2_data that corresponds of the number of non null blocks*/
+  /* the size of index4_data that corresponds of the number of non null blocks*/
   size_t filled4;
 
   size_t * index3_data;
   size_t * index4_data;
   size_t * blockMap;
+
+  /* filled1 of the matrix when the index was built, to detect structural
+     changes together with filled3/filled4 (see SBM_column_index) */
+  size_t filled1;
 };
 
 
@@ -230,6 +269,27 @@ extern "C"
                double alpha, const SparseBlockStructuredMatrix* const A,
                const double* x, double beta, double* y);
 
+  /**
+     SparseMatrix - vector product y = alpha*A*x + beta*y with the block
+     rows distributed over OpenMP threads. Each block row writes a
+     disjoint segment of y, so the result is identical to SBM_gemv. The
+     block rows are partitioned into chunks of roughly equal numbers of
+     scalar entries by a one-time inspector; the schedule is kept in the
+     matrix and reused while the block structure is unchanged. Falls back
+     on SBM_gemv when OpenMP is not enabled or the matrix is small.
+
+     \param[in] sizeX dim of the vectors x
+     \param[in] sizeY dim of the vectors y
+     \param[in] alpha coefficient
+     \param[in] A the matrix to be multiplied
+     \param[in] x the vector to be multiplied
+     \param[in] beta coefficient
+     \param[in,out] y the resulting vector
+  */
+  void SBM_gemv_parallel(unsigned int sizeX, unsigned int sizeY,
+                         double alpha, SparseBlockStructuredMatrix* A,
+                         const double* x, double beta, double* y);
+
   /**
      SparseMatrix - vector product y = A*x + y for block of size 3x3
 
@@ -360,9 +420,48 @@ extern "C"
                                  unsigned int *row_components, unsigned int row_components_size,
                                  unsigned int *col_components, unsigned int col_components_size);
 
-  /** 
+  /** Build the principal submatrix of A restricted to a subset of its
+   *  block rows/columns. The returned matrix shares the block payloads
+   *  of A (no values are copied), only the index structure is
+   *  allocated, so it stays valid exactly as long as A does and must be
+   *  released with SBM_free_principal_submatrix, never with SBM_clear.
+   *
+   *  \param A the source matrix (square in terms of blocks)
+   *  \param block_indices the selected block indices, sorted in
+   *  increasing order
+   *  \param block_indices_size number of selected blocks
+   *  \return the submatrix
+   */
+  SparseBlockStructuredMatrix* SBM_extract_principal_submatrix(
+    const SparseBlockStructuredMatrix* const A,
+    const unsigned int* block_indices, unsigned int block_indices_size);
+
+  /** Release a matrix obtained with SBM_extract_principal_submatrix:
+   *  frees the index structure but leaves the shared block payloads to
+   *  their owner.
+   *
+   *  \param sbm the submatrix
+   */
+  void SBM_free_principal_submatrix(SparseBlockStructuredMatrix* sbm);
+
+  /** Move every block payload into one contiguous arena, ordered by the
+   *  row-major traversal order of the products, and free the individual
+   *  allocations. To be called once, after assembly: the block pointers
+   *  are updated in place, so the compacted matrix is used exactly as
+   *  before (SBM_gemv, SBM_gemm_without_allocation,
+   *  SBM_extract_component_3x3, ...) but the products read the values
+   *  from one sequential area instead of chasing scattered allocations.
+   *  The arena is released by SBM_clear or by SBMfree with
+   *  NUMERICS_SBM_FREE_BLOCK. Does nothing on an already compacted
+   *  matrix.
+   *
+   *  \param A the matrix to be compacted
+   */
+  void SBM_compactify(SparseBlockStructuredMatrix * A);
+
+  /**
       Destructor for SparseBlockStructuredMatrix objects
-    
+
       \param blmat SparseBlockStructuredMatrix the matrix to be destroyed.
    */
   void SBM_clear(SparseBlockStructuredMatrix * blmat);
@@ -454,6 +553,20 @@ extern "C"
   */
   unsigned int SBM_diagonal_block_index(SparseBlockStructuredMatrix* const M, unsigned int row);
 
+  /**
+      Column-major view over the block structure, cached on the matrix.
+
+      The view is rebuilt when the block structure changed (detected from
+      filled1/filled2/blocknumber1, like the parallel row schedule) and
+      reused otherwise, so the column-striding operations (transpose,
+      products against a right factor) do not pay a structure pass per
+      call. The matrix owns the view: do not free it, SBM_clear does.
+
+      \param M the SparseBlockStructuredMatrix matrix
+      \return the column index of M
+  */
+  struct SBM_index_by_column * SBM_column_index(const SparseBlockStructuredMatrix* const M);
+
   /** 
       insert an entry into a SparseBlockStructuredMatrix.
       This method is expensive in terms of memory management. For a lot of entries, use
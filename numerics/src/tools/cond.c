@@ -16,10 +16,14 @@
  * limitations under the License.
 */
 #include "cond.h"
+#include <assert.h>         // for assert
+#include <math.h>           // for fabs, INFINITY
 #include <stdio.h>          // for printf, NULL, size_t
 #include <stdlib.h>         // for free, malloc
-#include <string.h>         // for memcpy
+#include <string.h>         // for memcpy, memset
 #include "NSSTools.h"  // for min
+#include "NumericsMatrix.h" // for NM_LU_factorize, NM_Cholesky_solve, ...
+#include "SiconosBlas.h"    // for cblas_dasum, cblas_ddot, cblas_dnrm2
 #include "SiconosLapack.h"  // for DGESVD, lapack_int
 
 double cond(double * A, int n, int m)
@@ -77,3 +81,138 @@ double cond(double * A, int n, int m)
   /* #endif */
 
 }
+
+double cond_estimate_1norm(NumericsMatrix* A)
+{
+  assert(A);
+  assert(A->size0 == A->size1);
+  int n = A->size0;
+  if(n == 0) return 1.0;
+
+  /* ||A||_1 must be read before the factors overwrite the entries */
+  double norm_A = NM_norm_1(A);
+
+  if(NM_LU_factorize(A) != 0)
+    return INFINITY;
+
+  double* work = (double*)malloc(3 * (size_t)n * sizeof(double));
+  double* x = work;
+  double* y = work + n;
+  double* z = work + 2 * n;
+
+  /* Hager's algorithm: maximize ||inv(A) x||_1 over the unit 1-norm
+   * ball, starting from the barycenter of its vertices.  Each step is
+   * one solve with A and one with A^T; in practice it converges in 2
+   * or 3 steps. */
+  for(int i = 0; i < n; ++i) x[i] = 1.0 / n;
+
+  double est = 0.0, est_old = 0.0;
+  for(int iter = 0; iter < 5; ++iter)
+  {
+    cblas_dcopy(n, x, 1, y, 1);
+    NM_LU_solve(A, y, 1);                 /* y = inv(A) x */
+    est = cblas_dasum(n, y, 1);
+
+    if(iter > 0 && est <= est_old)
+    {
+      est = est_old;
+      break;
+    }
+    est_old = est;
+
+    for(int i = 0; i < n; ++i) z[i] = (y[i] >= 0.) ? 1.0 : -1.0;
+    NM_LU_solve_trans(A, z, 1);           /* z = inv(A)^T sign(y) */
+
+    int j = 0;
+    for(int i = 1; i < n; ++i)
+      if(fabs(z[i]) > fabs(z[j])) j = i;
+
+    /* optimality test: the subgradient cannot be improved */
+    if(fabs(z[j]) <= cblas_ddot(n, z, 1, x, 1))
+      break;
+
+    memset(x, 0, (size_t)n * sizeof(double));
+    x[j] = 1.0;
+  }
+
+  free(work);
+  return norm_A * est;
+}
+
+/* Power iteration for the dominant eigenvalue of A (or of inv(A)
+ * through Cholesky solves when inverse is set).  v and w are work
+ * vectors of size n; v holds the start vector on entry. */
+static double cond_power_iteration(NumericsMatrix* A, int inverse,
+                                   unsigned int itermax, double tol,
+                                   double* v, double* w, int n)
+{
+  double nv = cblas_dnrm2(n, v, 1);
+  if(nv == 0.) return 0.0;
+  cblas_dscal(n, 1.0 / nv, v, 1);
+
+  double lambda = 0.0, lambda_old = 0.0;
+  for(unsigned int iter = 0; iter < itermax; ++iter)
+  {
+    if(inverse)
+    {
+      cblas_dcopy(n, v, 1, w, 1);
+      NM_Cholesky_solve(A, w, 1);         /* w = inv(A) v */
+    }
+    else
+      NM_gemv(1.0, A, v, 0.0, w);         /* w = A v */
+
+    lambda = cblas_ddot(n, v, 1, w, 1);   /* Rayleigh quotient */
+
+    double nw = cblas_dnrm2(n, w, 1);
+    if(nw == 0.) return 0.0;
+    cblas_dcopy(n, w, 1, v, 1);
+    cblas_dscal(n, 1.0 / nw, v, 1);
+
+    if(iter > 0 && fabs(lambda - lambda_old) <= tol * fabs(lambda))
+      break;
+    lambda_old = lambda;
+  }
+  return lambda;
+}
+
+int cond_extreme_eigenvalues_spd(NumericsMatrix* A, unsigned int itermax,
+                                 double tol, double* eig_max, double* eig_min)
+{
+  assert(A);
+  assert(A->size0 == A->size1);
+  int n = A->size0;
+  *eig_max = 0.0;
+  *eig_min = 0.0;
+  if(n == 0) return 0;
+
+  double* work = (double*)malloc(2 * (size_t)n * sizeof(double));
+  double* v = work;
+  double* w = work + n;
+
+  /* largest eigenvalue first: the products must happen before the
+   * Cholesky factors possibly overwrite a dense storage */
+  for(int i = 0; i < n; ++i) v[i] = 1.0;
+  *eig_max = cond_power_iteration(A, 0, itermax, tol, v, w, n);
+
+  if(NM_Cholesky_factorize(A) != 0)
+  {
+    free(work);
+    return 1;
+  }
+
+  for(int i = 0; i < n; ++i) v[i] = 1.0;
+  double mu = cond_power_iteration(A, 1, itermax, tol, v, w, n);
+  *eig_min = (mu > 0.) ? 1.0 / mu : 0.0;
+
+  free(work);
+  return 0;
+}
+
+double cond_estimate_spd(NumericsMatrix* A, unsigned int itermax, double tol)
+{
+  double eig_max, eig_min;
+  if(cond_extreme_eigenvalues_spd(A, itermax, tol, &eig_max, &eig_min) != 0
+      || eig_min <= 0.)
+    return INFINITY;
+  return eig_max / eig_min;
+}
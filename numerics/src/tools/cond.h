@@ -23,6 +23,8 @@
  * \brief condition number computation
  */
 
+#include "NumericsFwd.h"  // for NumericsMatrix
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -35,6 +37,52 @@ extern "C"
   */
   double cond(double * A, int n, int m);
 
+  /** Estimate the 1-norm condition number of a square matrix from its
+   *  LU factors (Hager/Higham estimator), in O(a few solves) instead
+   *  of the O(n^3) SVD of cond().  The matrix is factorized with
+   *  NM_LU_factorize() if it is not already; the factors are kept, so
+   *  solver heuristics can query the conditioning of a matrix they
+   *  solve with anyway at almost no extra cost.  Note that, as with
+   *  any call to NM_LU_factorize(), the original entries of a dense
+   *  matrix are overwritten by the factors unless NM_preserve() was
+   *  called first.
+   *
+   *  \param A the matrix, square
+   *  \return an estimate (a lower bound) of the 1-norm condition
+   *  number, or INFINITY if the factorization fails
+   */
+  double cond_estimate_1norm(NumericsMatrix* A);
+
+  /** Estimate the extreme eigenvalues of a symmetric positive
+   *  definite matrix by power iteration: the largest with products
+   *  (NM_gemv), the smallest with inverse iteration on the Cholesky
+   *  factors (NM_Cholesky_factorize / NM_Cholesky_solve), each in
+   *  O(itermax) products or solves.
+   *
+   *  \param A the matrix, assumed SPD
+   *  \param itermax maximum number of power iterations (e.g. 20)
+   *  \param tol relative stagnation tolerance on the Rayleigh
+   *  quotient (e.g. 1e-2, conditioning signals do not need digits)
+   *  \param eig_max output, estimate of the largest eigenvalue
+   *  \param eig_min output, estimate of the smallest eigenvalue
+   *  \return 0 on success, 1 if the Cholesky factorization fails
+   *  (matrix not SPD)
+   */
+  int cond_extreme_eigenvalues_spd(NumericsMatrix* A, unsigned int itermax,
+                                   double tol, double* eig_max, double* eig_min);
+
+  /** Estimate the 2-norm condition number of a symmetric positive
+   *  definite matrix, as the ratio of the extreme eigenvalue
+   *  estimates of cond_extreme_eigenvalues_spd().
+   *
+   *  \param A the matrix, assumed SPD
+   *  \param itermax maximum number of power iterations
+   *  \param tol relative stagnation tolerance on the Rayleigh quotient
+   *  \return the condition number estimate, or INFINITY if A is not
+   *  SPD (or numerically singular)
+   */
+  double cond_estimate_spd(NumericsMatrix* A, unsigned int itermax, double tol);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,447 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!\file opNxN.h
+ * \brief fully unrolled, branch-minimized kernels for the small dense
+ * systems solved by the local FrictionContact solvers (3x3, 4x4, 6x6).
+ *
+ * The solve and inverse kernels use cofactor (Cramer) formulas: apart
+ * from a single singularity test per factorization there is no
+ * data-dependent branch, so the code pipelines well inside the local
+ * Newton loops where these systems are solved millions of times. The
+ * Cholesky kernels are for the symmetric positive definite Delassus
+ * blocks; they accumulate a validity flag instead of branching per
+ * column. See op3x3.h for the historical 3x3 helpers; all matrices are
+ * column-major as everywhere else in numerics.
+ */
+
+#ifndef _opNxN_h_
+#define _opNxN_h_
+
+#include "op3x3.h"
+
+/** compile-time size dispatch: SOLVE_NXN(3, a, b) expands to
+ * solve_3x3(a, b), etc. N must be a literal among 3, 4, 6. */
+#define SOLVE_NXN(N, A, B) solve_##N##x##N(A, B)
+#define INV_NXN(N, A, B) inv_##N##x##N(A, B)
+#define CHOL_NXN(N, A) chol_##N##x##N(A)
+#define CHOL_SOLVE_NXN(N, A, B) chol_solve_##N##x##N(A, B)
+
+/** system resolution by Cramer formulas : b <- sol(Ax = b).
+ * Branch-free except for the singularity test; on the local 3x3
+ * systems this is measurably faster than the pivoted elimination of
+ * solve_3x3_gepp and than LAPACK.
+ * \param a column-major a[9] (not modified)
+ * \param[in,out] b on input the right-hand side, on output the
+ *  solution; left untouched when the matrix is singular
+ * \return 0 if success, 1 if the determinant is below DBL_EPSILON
+ */
+WARN_RESULT_IGNORED
+static inline int solve_3x3(double* restrict a, double* restrict b)
+{
+  double a00 = a[0], a10 = a[1], a20 = a[2];
+  double a01 = a[3], a11 = a[4], a21 = a[5];
+  double a02 = a[6], a12 = a[7], a22 = a[8];
+
+  /* cofactors of the first column */
+  double c00 = a11 * a22 - a21 * a12;
+  double c10 = a21 * a02 - a01 * a22;
+  double c20 = a01 * a12 - a11 * a02;
+
+  double det = a00 * c00 + a10 * c10 + a20 * c20;
+  if(fabs(det) <= DBL_EPSILON) return 1;
+  double idet = 1.0 / det;
+
+  double b0 = b[0], b1 = b[1], b2 = b[2];
+  b[0] = idet * (c00 * b0 + c10 * b1 + c20 * b2);
+  b[1] = idet * ((a20 * a12 - a10 * a22) * b0 +
+                 (a00 * a22 - a20 * a02) * b1 +
+                 (a10 * a02 - a00 * a12) * b2);
+  b[2] = idet * ((a10 * a21 - a20 * a11) * b0 +
+                 (a20 * a01 - a00 * a21) * b1 +
+                 (a00 * a11 - a10 * a01) * b2);
+  return 0;
+}
+
+/** inverse by cofactors : b <- inv(a)
+ * \param a column-major a[9] (not modified)
+ * \param[out] b column-major b[9], untouched when a is singular
+ * \return 0 if success, 1 if the determinant is below DBL_EPSILON
+ */
+WARN_RESULT_IGNORED
+static inline int inv_3x3(double* restrict a, double* restrict b)
+{
+  double a00 = a[0], a10 = a[1], a20 = a[2];
+  double a01 = a[3], a11 = a[4], a21 = a[5];
+  double a02 = a[6], a12 = a[7], a22 = a[8];
+
+  double c00 = a11 * a22 - a21 * a12;
+  double c10 = a21 * a02 - a01 * a22;
+  double c20 = a01 * a12 - a11 * a02;
+
+  double det = a00 * c00 + a10 * c10 + a20 * c20;
+  if(fabs(det) <= DBL_EPSILON) return 1;
+  double idet = 1.0 / det;
+
+  b[0] = idet * c00;
+  b[1] = idet * (a20 * a12 - a10 * a22);
+  b[2] = idet * (a10 * a21 - a20 * a11);
+  b[3] = idet * c10;
+  b[4] = idet * (a00 * a22 - a20 * a02);
+  b[5] = idet * (a20 * a01 - a00 * a21);
+  b[6] = idet * c20;
+  b[7] = idet * (a10 * a02 - a00 * a12);
+  b[8] = idet * (a00 * a11 - a10 * a01);
+  return 0;
+}
+
+/** matrix vector multiplication
+ * \param[in] a 4 by 4 matrix in col-major
+ * \param[in] v 4 dimensional vector
+ * \param[out] r \f$r = a*v\f$
+ */
+static inline void mv4x4(double* restrict a, double* restrict v, double* restrict r)
+{
+  double v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+  r[0] = a[0] * v0 + a[4] * v1 + a[8] * v2 + a[12] * v3;
+  r[1] = a[1] * v0 + a[5] * v1 + a[9] * v2 + a[13] * v3;
+  r[2] = a[2] * v0 + a[6] * v1 + a[10] * v2 + a[14] * v3;
+  r[3] = a[3] * v0 + a[7] * v1 + a[11] * v2 + a[15] * v3;
+}
+
+/** inverse by the 2x2-subdeterminant cofactor expansion : b <- inv(a)
+ * \param a column-major a[16] (not modified)
+ * \param[out] b column-major b[16], untouched when a is singular
+ * \return 0 if success, 1 if the determinant is below DBL_EPSILON
+ */
+WARN_RESULT_IGNORED
+static inline int inv_4x4(double* restrict a, double* restrict b)
+{
+  /* a(i,j) = a[i + 4j] ; sK and cK are the 2x2 determinants built on
+   * rows (0,1) and rows (2,3) respectively */
+  double s0 = a[0] * a[5] - a[1] * a[4];
+  double s1 = a[0] * a[9] - a[1] * a[8];
+  double s2 = a[0] * a[13] - a[1] * a[12];
+  double s3 = a[4] * a[9] - a[5] * a[8];
+  double s4 = a[4] * a[13] - a[5] * a[12];
+  double s5 = a[8] * a[13] - a[9] * a[12];
+
+  double c5 = a[10] * a[15] - a[11] * a[14];
+  double c4 = a[6] * a[15] - a[7] * a[14];
+  double c3 = a[6] * a[11] - a[7] * a[10];
+  double c2 = a[2] * a[15] - a[3] * a[14];
+  double c1 = a[2] * a[11] - a[3] * a[10];
+  double c0 = a[2] * a[7] - a[3] * a[6];
+
+  double det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  if(fabs(det) <= DBL_EPSILON) return 1;
+  double idet = 1.0 / det;
+
+  b[0] = idet * (a[5] * c5 - a[9] * c4 + a[13] * c3);
+  b[1] = idet * (-a[1] * c5 + a[9] * c2 - a[13] * c1);
+  b[2] = idet * (a[1] * c4 - a[5] * c2 + a[13] * c0);
+  b[3] = idet * (-a[1] * c3 + a[5] * c1 - a[9] * c0);
+
+  b[4] = idet * (-a[4] * c5 + a[8] * c4 - a[12] * c3);
+  b[5] = idet * (a[0] * c5 - a[8] * c2 + a[12] * c1);
+  b[6] = idet * (-a[0] * c4 + a[4] * c2 - a[12] * c0);
+  b[7] = idet * (a[0] * c3 - a[4] * c1 + a[8] * c0);
+
+  b[8] = idet * (a[7] * s5 - a[11] * s4 + a[15] * s3);
+  b[9] = idet * (-a[3] * s5 + a[11] * s2 - a[15] * s1);
+  b[10] = idet * (a[3] * s4 - a[7] * s2 + a[15] * s0);
+  b[11] = idet * (-a[3] * s3 + a[7] * s1 - a[11] * s0);
+
+  b[12] = idet * (-a[6] * s5 + a[10] * s4 - a[14] * s3);
+  b[13] = idet * (a[2] * s5 - a[10] * s2 + a[14] * s1);
+  b[14] = idet * (-a[2] * s4 + a[6] * s2 - a[14] * s0);
+  b[15] = idet * (a[2] * s3 - a[6] * s1 + a[10] * s0);
+  return 0;
+}
+
+/** system resolution : b <- sol(Ax = b), through inv_4x4
+ * \param a column-major a[16] (not modified)
+ * \param[in,out] b on input the right-hand side, on output the
+ *  solution; left untouched when the matrix is singular
+ * \return 0 if success, 1 if the determinant is below DBL_EPSILON
+ */
+WARN_RESULT_IGNORED
+static inline int solve_4x4(double* restrict a, double* restrict b)
+{
+  double ainv[16], x[4];
+  if(inv_4x4(a, ainv)) return 1;
+  mv4x4(ainv, b, x);
+  b[0] = x[0];
+  b[1] = x[1];
+  b[2] = x[2];
+  b[3] = x[3];
+  return 0;
+}
+
+/** system resolution by a 3x3-block Schur complement : b <- sol(Ax = b).
+ * Both the leading 3x3 block and its Schur complement must be regular,
+ * which holds for the Delassus-type blocks of the local solvers; for an
+ * arbitrary 6x6 matrix use solve_nxn_gepp.
+ * \param a column-major a[36] (not modified)
+ * \param[in,out] b on input the right-hand side, on output the solution
+ * \return 0 if success, 1 if the leading block is singular, 2 if the
+ *  Schur complement is singular (b may then hold NaN)
+ */
+WARN_RESULT_IGNORED
+static inline int solve_6x6(double* restrict a, double* restrict b)
+{
+  double A11[9], A12[9], A21[9], A22[9], A11inv[9], T[9];
+  double b1[3], x1[3], x2[3];
+
+  extract3x3(6, 0, 0, a, A11);
+  extract3x3(6, 0, 3, a, A12);
+  extract3x3(6, 3, 0, a, A21);
+  extract3x3(6, 3, 3, a, A22);
+
+  if(inv_3x3(A11, A11inv)) return 1;
+
+  mm3x3(A21, A11inv, T);     /* T = A21 inv(A11) */
+  mmm3x3(T, A12, A22);       /* A22 <- S = A22 - T A12 */
+
+  cpy3(b, b1);
+  mvm3x3(T, b1, b + 3);      /* b2 <- b2 - T b1 */
+  if(solv3x3(A22, x2, b + 3)) return 2;
+
+  mvm3x3(A12, x2, b1);       /* b1 <- b1 - A12 x2 */
+  mv3x3(A11inv, b1, x1);
+
+  cpy3(x1, b);
+  cpy3(x2, b + 3);
+  return 0;
+}
+
+/** in-place Cholesky factorization of a symmetric positive definite
+ * matrix; the lower triangle is overwritten by L with A = L L^T, the
+ * strict upper triangle is untouched. The factor is computed without
+ * branching; non positive pivots only flip the returned flag (and leave
+ * NaN on the diagonal).
+ * \param[in,out] a column-major a[9]
+ * \return 0 if success, 1 if a pivot is non positive
+ */
+WARN_RESULT_IGNORED
+static inline int chol_3x3(double* a)
+{
+  int ok;
+  double d0 = a[0];
+  ok = d0 > 0.;
+  double l00 = sqrt(d0);
+  double i0 = 1.0 / l00;
+  double l10 = a[1] * i0;
+  double l20 = a[2] * i0;
+
+  double d1 = a[4] - l10 * l10;
+  ok &= d1 > 0.;
+  double l11 = sqrt(d1);
+  double l21 = (a[5] - l20 * l10) / l11;
+
+  double d2 = a[8] - l20 * l20 - l21 * l21;
+  ok &= d2 > 0.;
+
+  a[0] = l00;
+  a[1] = l10;
+  a[2] = l20;
+  a[4] = l11;
+  a[5] = l21;
+  a[8] = sqrt(d2);
+  return !ok;
+}
+
+/** triangular solves with a chol_3x3 factor : b <- sol(L L^T x = b)
+ * \param a column-major a[9] holding L in its lower triangle
+ * \param[in,out] b on input the right-hand side, on output the solution
+ */
+static inline void chol_solve_3x3(double* restrict a, double* restrict b)
+{
+  double y0 = b[0] / a[0];
+  double y1 = (b[1] - a[1] * y0) / a[4];
+  double y2 = (b[2] - a[2] * y0 - a[5] * y1) / a[8];
+  double x2 = y2 / a[8];
+  double x1 = (y1 - a[5] * x2) / a[4];
+  b[0] = (y0 - a[1] * x1 - a[2] * x2) / a[0];
+  b[1] = x1;
+  b[2] = x2;
+}
+
+/** in-place Cholesky factorization, 4x4 flavour of chol_3x3
+ * \param[in,out] a column-major a[16]
+ * \return 0 if success, 1 if a pivot is non positive
+ */
+WARN_RESULT_IGNORED
+static inline int chol_4x4(double* a)
+{
+  int ok;
+  double d0 = a[0];
+  ok = d0 > 0.;
+  double l00 = sqrt(d0);
+  double i0 = 1.0 / l00;
+  double l10 = a[1] * i0;
+  double l20 = a[2] * i0;
+  double l30 = a[3] * i0;
+
+  double d1 = a[5] - l10 * l10;
+  ok &= d1 > 0.;
+  double l11 = sqrt(d1);
+  double i1 = 1.0 / l11;
+  double l21 = (a[6] - l20 * l10) * i1;
+  double l31 = (a[7] - l30 * l10) * i1;
+
+  double d2 = a[10] - l20 * l20 - l21 * l21;
+  ok &= d2 > 0.;
+  double l22 = sqrt(d2);
+  double l32 = (a[11] - l30 * l20 - l31 * l21) / l22;
+
+  double d3 = a[15] - l30 * l30 - l31 * l31 - l32 * l32;
+  ok &= d3 > 0.;
+
+  a[0] = l00;
+  a[1] = l10;
+  a[2] = l20;
+  a[3] = l30;
+  a[5] = l11;
+  a[6] = l21;
+  a[7] = l31;
+  a[10] = l22;
+  a[11] = l32;
+  a[15] = sqrt(d3);
+  return !ok;
+}
+
+/** triangular solves with a chol_4x4 factor : b <- sol(L L^T x = b)
+ * \param a column-major a[16] holding L in its lower triangle
+ * \param[in,out] b on input the right-hand side, on output the solution
+ */
+static inline void chol_solve_4x4(double* restrict a, double* restrict b)
+{
+  double y0 = b[0] / a[0];
+  double y1 = (b[1] - a[1] * y0) / a[5];
+  double y2 = (b[2] - a[2] * y0 - a[6] * y1) / a[10];
+  double y3 = (b[3] - a[3] * y0 - a[7] * y1 - a[11] * y2) / a[15];
+  double x3 = y3 / a[15];
+  double x2 = (y2 - a[11] * x3) / a[10];
+  double x1 = (y1 - a[6] * x2 - a[7] * x3) / a[5];
+  b[0] = (y0 - a[1] * x1 - a[2] * x2 - a[3] * x3) / a[0];
+  b[1] = x1;
+  b[2] = x2;
+  b[3] = x3;
+}
+
+/** in-place Cholesky factorization, 6x6 flavour of chol_3x3
+ * \param[in,out] a column-major a[36]
+ * \return 0 if success, 1 if a pivot is non positive
+ */
+WARN_RESULT_IGNORED
+static inline int chol_6x6(double* a)
+{
+  int ok;
+  double d0 = a[0];
+  ok = d0 > 0.;
+  double l00 = sqrt(d0);
+  double i0 = 1.0 / l00;
+  double l10 = a[1] * i0;
+  double l20 = a[2] * i0;
+  double l30 = a[3] * i0;
+  double l40 = a[4] * i0;
+  double l50 = a[5] * i0;
+
+  double d1 = a[7] - l10 * l10;
+  ok &= d1 > 0.;
+  double l11 = sqrt(d1);
+  double i1 = 1.0 / l11;
+  double l21 = (a[8] - l20 * l10) * i1;
+  double l31 = (a[9] - l30 * l10) * i1;
+  double l41 = (a[10] - l40 * l10) * i1;
+  double l51 = (a[11] - l50 * l10) * i1;
+
+  double d2 = a[14] - l20 * l20 - l21 * l21;
+  ok &= d2 > 0.;
+  double l22 = sqrt(d2);
+  double i2 = 1.0 / l22;
+  double l32 = (a[15] - l30 * l20 - l31 * l21) * i2;
+  double l42 = (a[16] - l40 * l20 - l41 * l21) * i2;
+  double l52 = (a[17] - l50 * l20 - l51 * l21) * i2;
+
+  double d3 = a[21] - l30 * l30 - l31 * l31 - l32 * l32;
+  ok &= d3 > 0.;
+  double l33 = sqrt(d3);
+  double i3 = 1.0 / l33;
+  double l43 = (a[22] - l40 * l30 - l41 * l31 - l42 * l32) * i3;
+  double l53 = (a[23] - l50 * l30 - l51 * l31 - l52 * l32) * i3;
+
+  double d4 = a[28] - l40 * l40 - l41 * l41 - l42 * l42 - l43 * l43;
+  ok &= d4 > 0.;
+  double l44 = sqrt(d4);
+  double l54 = (a[29] - l50 * l40 - l51 * l41 - l52 * l42 - l53 * l43) / l44;
+
+  double d5 = a[35] - l50 * l50 - l51 * l51 - l52 * l52 - l53 * l53 - l54 * l54;
+  ok &= d5 > 0.;
+
+  a[0] = l00;
+  a[1] = l10;
+  a[2] = l20;
+  a[3] = l30;
+  a[4] = l40;
+  a[5] = l50;
+  a[7] = l11;
+  a[8] = l21;
+  a[9] = l31;
+  a[10] = l41;
+  a[11] = l51;
+  a[14] = l22;
+  a[15] = l32;
+  a[16] = l42;
+  a[17] = l52;
+  a[21] = l33;
+  a[22] = l43;
+  a[23] = l53;
+  a[28] = l44;
+  a[29] = l54;
+  a[35] = sqrt(d5);
+  return !ok;
+}
+
+/** triangular solves with a chol_6x6 factor : b <- sol(L L^T x = b)
+ * \param a column-major a[36] holding L in its lower triangle
+ * \param[in,out] b on input the right-hand side, on output the solution
+ */
+static inline void chol_solve_6x6(double* restrict a, double* restrict b)
+{
+  double y0 = b[0] / a[0];
+  double y1 = (b[1] - a[1] * y0) / a[7];
+  double y2 = (b[2] - a[2] * y0 - a[8] * y1) / a[14];
+  double y3 = (b[3] - a[3] * y0 - a[9] * y1 - a[15] * y2) / a[21];
+  double y4 = (b[4] - a[4] * y0 - a[10] * y1 - a[16] * y2 - a[22] * y3) / a[28];
+  double y5 = (b[5] - a[5] * y0 - a[11] * y1 - a[17] * y2 - a[23] * y3 - a[29] * y4) / a[35];
+  double x5 = y5 / a[35];
+  double x4 = (y4 - a[29] * x5) / a[28];
+  double x3 = (y3 - a[22] * x4 - a[23] * x5) / a[21];
+  double x2 = (y2 - a[15] * x3 - a[16] * x4 - a[17] * x5) / a[14];
+  double x1 = (y1 - a[8] * x2 - a[9] * x3 - a[10] * x4 - a[11] * x5) / a[7];
+  b[0] = (y0 - a[1] * x1 - a[2] * x2 - a[3] * x3 - a[4] * x4 - a[5] * x5) / a[0];
+  b[1] = x1;
+  b[2] = x2;
+  b[3] = x3;
+  b[4] = x4;
+  b[5] = x5;
+}
+
+#endif
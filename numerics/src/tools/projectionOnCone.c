@@ -17,8 +17,6 @@
 */
 #include "projectionOnCone.h"
 #include <math.h>    // for sqrt
-#include <stdio.h>   // for fprintf, stderr
-#include <stdlib.h>  // for exit, EXIT_FAILURE
 
 unsigned projectionOnCone(double* r, double  mu)
 {
@@ -45,6 +43,51 @@ unsigned projectionOnCone(double* r, double  mu)
     return PROJCONE_BOUNDARY;
   }
 }
+/* Branchless transcription of projectionOnCone: the three cases of the
+   scalar kernel become lane-wise selects so that the loop vectorizes
+   across cones. */
+void projectionOnCone_SoA(unsigned int n, double* restrict rn,
+                          double* restrict rt1, double* restrict rt2,
+                          const double* restrict mu)
+{
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    double normT = sqrt(rt1[i] * rt1[i] + rt2[i] * rt2[i]);
+    int dual = mu[i] * normT <= - rn[i];
+    int inside = normT <= mu[i] * rn[i];
+    double pn = (mu[i] * normT + rn[i]) / (mu[i] * mu[i] + 1.0);
+    /* 1/normT is only consumed on the boundary lanes, where normT > 0 */
+    double s = mu[i] * pn / normT;
+    rn[i] = dual ? 0.0 : (inside ? rn[i] : pn);
+    rt1[i] = dual ? 0.0 : (inside ? rt1[i] : s * rt1[i]);
+    rt2[i] = dual ? 0.0 : (inside ? rt2[i] : s * rt2[i]);
+  }
+}
+
+/* Same branchless kernel on the interleaved layout: cone i lives in
+   r[3i .. 3i+2]. Saves the gather/scatter of the SoA variant for the
+   solvers that keep their reactions interleaved. */
+void projectionOnCone_batch(unsigned int n, double* restrict r,
+                            const double* restrict mu)
+{
+  /* contacts are independent: thread the stream on large batches, the
+   * fixed-point solvers call this with the full contact set */
+  #pragma omp parallel for schedule(static) if(n > (1 << 12))
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    double* ri = &r[3 * i];
+    double normT = sqrt(ri[1] * ri[1] + ri[2] * ri[2]);
+    int dual = mu[i] * normT <= - ri[0];
+    int inside = normT <= mu[i] * ri[0];
+    double pn = (mu[i] * normT + ri[0]) / (mu[i] * mu[i] + 1.0);
+    /* 1/normT is only consumed on the boundary lanes, where normT > 0 */
+    double s = mu[i] * pn / normT;
+    ri[0] = dual ? 0.0 : (inside ? ri[0] : pn);
+    ri[1] = dual ? 0.0 : (inside ? ri[1] : s * ri[1]);
+    ri[2] = dual ? 0.0 : (inside ? ri[2] : s * ri[2]);
+  }
+}
+
 unsigned projectionOnDualCone(double* u, double  mu)
 {
 
@@ -78,16 +121,69 @@ unsigned projectionOnDualCone(double* u, double  mu)
 }
 
 
-void projectionOnSecondOrderCone(double* r, double  mu, int size)
+/* Projection on the second order cone of R^size, any size >= 1. Kept
+   static so that the fixed-size calls below inline with a constant trip
+   count and the compiler fully unrolls the component loops. */
+static inline unsigned projectionOnSOC(double* r, double mu, int size)
 {
-  if(size ==3)
+  double normT2 = 0.0;
+  for(int i = 1; i < size; ++i)
+    normT2 += r[i] * r[i];
+  double normT = sqrt(normT2);
+  if(mu * normT <= - r[0])
   {
-    projectionOnCone(r, mu);
+    for(int i = 0; i < size; ++i)
+      r[i] = 0.0;
+    return PROJCONE_DUAL;
+  }
+  else if(normT <= mu * r[0])
+  {
+    return PROJCONE_INSIDE;
   }
   else
   {
-    fprintf(stderr, "Numerics, projectionOnSecondOrderCone f not yet implementes for size != 3 \n");
-    exit(EXIT_FAILURE);
+    double mu2 = mu * mu;
+    r[0] = (mu * normT + r[0]) / (mu2 + 1.0);
+    double s = mu * r[0] / normT;
+    for(int i = 1; i < size; ++i)
+      r[i] = s * r[i];
+    return PROJCONE_BOUNDARY;
+  }
+}
+
+void projectionOnSecondOrderCone(double* r, double  mu, int size)
+{
+  /* dispatch on the cone dimension: the common sizes get a kernel with
+     fixed trip counts (2 = planar cone, 3 = Coulomb friction, 5 = rolling
+     friction), everything else falls through to the generic loop */
+  switch(size)
+  {
+  case 3:
+    projectionOnCone(r, mu);
+    break;
+  case 2:
+    projectionOnSOC(r, mu, 2);
+    break;
+  case 5:
+    projectionOnSOC(r, mu, 5);
+    break;
+  default:
+    projectionOnSOC(r, mu, size);
+    break;
   }
+}
 
+void projectionOnSecondOrderCone_batch(unsigned int nc, double* r,
+                                       const unsigned int* coneIndex,
+                                       const double* mu)
+{
+  /* cones are independent: thread the sweep on large sets, as in
+   * projectionOnCone_batch; coneIndex[nc] is the total vector size so
+   * mixed cone dimensions are handled per cone */
+  #pragma omp parallel for schedule(static) if(nc > (1 << 12))
+  for(unsigned int cone = 0; cone < nc; ++cone)
+  {
+    projectionOnSecondOrderCone(&r[coneIndex[cone]], mu[cone],
+                                (int)(coneIndex[cone + 1] - coneIndex[cone]));
+  }
 }
@@ -41,6 +41,35 @@ extern "C" {
 */
 unsigned projectionOnCone(double *r, double mu);
 
+/**
+   projectionOnCone_SoA Projection on second Order Cones in \f$ R^3 \f$ for a
+   whole set of cones stored in structure-of-arrays form: the normal and the
+   two tangential components live in separate contiguous arrays, so that the
+   loop vectorizes across cones. Equivalent to calling projectionOnCone() on
+   each cone of the interleaved layout.
+
+   \param[in] n the number of cones
+   \param[in,out] rn the normal components (size n)
+   \param[in,out] rt1 the first tangential components (size n)
+   \param[in,out] rt2 the second tangential components (size n)
+   \param[in] mu the angles of the cones (size n)
+*/
+void projectionOnCone_SoA(unsigned int n, double *rn, double *rt1, double *rt2,
+                          const double *mu);
+
+/**
+   projectionOnCone_batch Projection on second Order Cones in \f$ R^3 \f$ for
+   a whole set of cones stored in the interleaved layout of the friction
+   contact solvers (cone i occupies r[3i], r[3i+1], r[3i+2]). Branchless
+   transcription of projectionOnCone() so that the loop vectorizes across
+   cones. Equivalent to calling projectionOnCone() on each cone.
+
+   \param[in] n the number of cones
+   \param[in,out] r the vectors to be projected (size 3n)
+   \param[in] mu the angles of the cones (size n)
+*/
+void projectionOnCone_batch(unsigned int n, double *r, const double *mu);
+
 /**
     projectionOnDualCone Projection on the second Order Cone in \f$ R^3 \f$,
     \f$ K \{ r, r_1 \geq 0, 0 mu \sqrt(u_2^2+u_3^2) \geq u_1  \} \f$
@@ -61,6 +90,22 @@ unsigned projectionOnDualCone(double *u, double mu);
 */
 void projectionOnSecondOrderCone(double *r, double mu, int size);
 
+/**
+   projectionOnSecondOrderCone_batch Projection on a whole set of second
+   Order Cones of possibly different dimensions, stored back to back as in
+   SecondOrderConeLinearComplementarityProblem: cone i occupies
+   r[coneIndex[i] .. coneIndex[i+1]-1]. Dispatches on each cone dimension
+   and is equivalent to calling projectionOnSecondOrderCone() on each cone.
+
+   \param[in] nc the number of cones
+   \param[in,out] r the vectors to be projected (size coneIndex[nc])
+   \param[in] coneIndex the cone start indices (size nc+1)
+   \param[in] mu the angles of the cones (size nc)
+*/
+void projectionOnSecondOrderCone_batch(unsigned int nc, double *r,
+                                       const unsigned int *coneIndex,
+                                       const double *mu);
+
 #if defined(__cplusplus) && !defined(BUILD_AS_CPP)
 }
 #endif
@@ -82,6 +82,51 @@ unsigned int projectionOnRollingCone(double* r, double  mu, double mur)
       return 20;
   }
 }
+/* Branch-reduced transcription of projectionOnRollingCone() on the
+   interleaved layout of the rolling friction solvers (cone i occupies
+   r[5i .. 5i+4]), so that the loop vectorizes across cones. The
+   projection statuses are not reported. */
+void projectionOnRollingCone_batch(unsigned int n, double* restrict r,
+                                   const double* restrict mu,
+                                   const double* restrict mur)
+{
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    double* ri = &r[5 * i];
+    double normT = sqrt(ri[1] * ri[1] + ri[2] * ri[2]);
+    double normMT = sqrt(ri[3] * ri[3] + ri[4] * ri[4]);
+    double mu2 = mu[i] * mu[i];
+    double mur2 = mur[i] * mur[i];
+
+    int dual = (mu[i] * normT + mur[i] * normMT <= - ri[0]);
+    int inside = (normT <= mu[i] * ri[0]) && (normMT <= mur[i] * ri[0]);
+
+    double trial_fr = (mu[i] * normT + mur[i] * normMT + ri[0]) / (mur2 + mu2 + 1.0);
+    double trial_f = (mu[i] * normT + ri[0]) / (mu2 + 1.0);
+    double trial_r = (mur[i] * normMT + ri[0]) / (mur2 + 1.0);
+
+    int both = (normT > mu[i] * trial_fr) && (normMT > mur[i] * trial_fr);
+    int fonly = (normT > mu[i] * trial_f) && (normMT <= mur[i] * trial_f);
+    int ronly = (normT <= mu[i] * trial_r) && (normMT > mur[i] * trial_r);
+
+    /* when no sub-case applies (the scalar version returns 20 there),
+       the reaction is left untouched */
+    double rn = both ? trial_fr : (fonly ? trial_f : (ronly ? trial_r : ri[0]));
+    /* the scales are only consumed on lanes where the matching norm
+       is positive */
+    double sT = mu[i] * rn / normT;
+    double sMT = mur[i] * rn / normMT;
+    int scaleT = both || fonly;
+    int scaleMT = both || ronly;
+
+    ri[0] = dual ? 0.0 : (inside ? ri[0] : rn);
+    ri[1] = dual ? 0.0 : ((inside || !scaleT) ? ri[1] : sT * ri[1]);
+    ri[2] = dual ? 0.0 : ((inside || !scaleT) ? ri[2] : sT * ri[2]);
+    ri[3] = dual ? 0.0 : ((inside || !scaleMT) ? ri[3] : sMT * ri[3]);
+    ri[4] = dual ? 0.0 : ((inside || !scaleMT) ? ri[4] : sMT * ri[4]);
+  }
+}
+
 unsigned int projectionOn2DRollingCone(double* r, double  mu, double mur)
 {
 
@@ -46,6 +46,23 @@ extern "C" {
 */
 unsigned int projectionOnRollingCone(double *r, double mu, double mur);
 
+/**
+   projectionOnRollingCone_batch Projection on rolling friction cones in
+   \f$ R^5 \f$ for a whole set of cones stored in the interleaved layout
+   of the rolling friction contact solvers (cone i occupies
+   r[5i .. 5i+4]). Branch-reduced transcription of
+   projectionOnRollingCone() so that the loop vectorizes across cones;
+   equivalent to calling it on each cone, except that the projection
+   statuses are not reported.
+
+   \param[in] n the number of cones
+   \param[in,out] r the vectors to be projected (size 5n)
+   \param[in] mu the friction coefficients (size n)
+   \param[in] mur the rolling friction coefficients (size n)
+*/
+void projectionOnRollingCone_batch(unsigned int n, double *r, const double *mu,
+                                   const double *mur);
+
 /**
    projectionOnCone Projection on the second Order Cone in \f$ R^3 \f$, \f$ K \{
    r, r_1 \geq 0, 0 \sqrt(r_2^2+r_3^2) \geq mu r_1  \} \f$
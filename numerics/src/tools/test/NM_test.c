@@ -1493,6 +1493,35 @@ static int NM_gemv_test(NumericsMatrix** MM)
     goto free_and_return;
   }
 
+  /* mostly-zero dense matrix: exercises the column-skipping path of
+   * NM_gemv (and the cached column pattern) */
+  NumericsMatrix * Mz = NM_create(NM_DENSE, n, n);
+  for(i = 0; i < n; i++)
+    Mz->matrix0[i] = i + 1.0; /* only the first column is nonzero */
+  for(i = 0; i < n; i++)
+  {
+    yref[i] = 0.1 * i;
+    y[i] = yref[i];
+  }
+  cblas_dgemv(CblasColMajor, CblasNoTrans, n, n, alpha, Mz->matrix0, n, x, incx, beta, yref, incy);
+  NM_gemv(alpha, Mz, x, beta, y);
+  /* run it twice, the second product uses the cached pattern */
+  cblas_dgemv(CblasColMajor, CblasNoTrans, n, n, alpha, Mz->matrix0, n, x, incx, beta, yref, incy);
+  NM_gemv(alpha, Mz, x, beta, y);
+  int z_ok = NV_equal(y, yref, n, tol);
+  NM_free(Mz);
+  if(z_ok)
+    printf("Step 0 ( y = alpha*A*x + beta*y, mostly-zero double* storage) ok ...\n");
+  else
+  {
+    printf("Step 0 ( y = alpha*A*x + beta*y, mostly-zero double* storage) failed ...\n");
+    info=1;
+    goto free_and_return;
+  }
+  for(i = 0; i < n; i++)
+    yref[i] = 0.1 * i;
+  cblas_dgemv(CblasColMajor, CblasNoTrans, n, n, alpha, M1->matrix0, n, x, incx, beta, yref, incy);
+
   /* sparse storage test for M1 */
   for(i=0; i<n; i++) y[i]=0.1*i;
   NM_csc(M1);
@@ -2845,6 +2874,62 @@ static int test_NM_LU_solve(void)
   printf("========= End Numerics tests for NumericsMatrix  (test_NM_LU_solve) ========= \n");
   return info;
 }
+
+static int test_NM_LU_solve_multi(void)
+{
+  printf("========= Starts Numerics tests for NumericsMatrix (test_NM_LU_solve_multi) ========= \n");
+  int info = 0;
+
+  /* 11 rhs so that the blocked csparse path runs a partial panel */
+  int nrhs = 11;
+
+  NumericsMatrix * M1 = test_matrix_5();
+  int n = M1->size0;
+
+  double * b = (double*)malloc(n*nrhs*sizeof(double));
+  double * y = (double*)malloc(n*nrhs*sizeof(double));
+  for(int j=0; j < n*nrhs; j++)
+    b[j] = cos((double)j);
+  for(int j=0; j < n*nrhs; j++)
+    y[j] = b[j];
+
+  NM_LU_solve(NM_preserve(M1), b, nrhs);
+
+  /* each column must solve its own system */
+  for(int k=0; k < nrhs; k++)
+  {
+    NM_gemv(-1.0, M1, &b[k*n], 1.0, &y[k*n]);
+    double res = cblas_dnrm2(n, &y[k*n], 1);
+    printf("test_NM_LU_solve_multi: residual of rhs %i = %e\n", k, res);
+    if(fabs(res) >= sqrt(DBL_EPSILON))
+      info = 1;
+  }
+
+  /* transposed solve: A^T x = b */
+  for(int j=0; j < n*nrhs; j++)
+    b[j] = cos((double)j);
+  for(int j=0; j < n*nrhs; j++)
+    y[j] = b[j];
+
+  NM_LU_solve_trans(M1, b, nrhs);
+
+  for(int k=0; k < nrhs; k++)
+  {
+    NM_tgemv(-1.0, M1, &b[k*n], 1.0, &y[k*n]);
+    double res = cblas_dnrm2(n, &y[k*n], 1);
+    printf("test_NM_LU_solve_multi: residual of transposed rhs %i = %e\n", k, res);
+    if(fabs(res) >= sqrt(DBL_EPSILON))
+      info = 1;
+  }
+
+  free(b);
+  free(y);
+  NM_unpreserve(M1);
+  NM_free(M1);
+  printf("========= End Numerics tests for NumericsMatrix  (test_NM_LU_solve_multi) ========= \n");
+  return info;
+}
+
 static int test_NM_LU_solve_matrix_rhs_unit(NumericsMatrix * M1, NumericsMatrix * B )
 {
   int n = M1->size0;
@@ -3347,6 +3432,131 @@ static int test_NM_Cholesky_solve_vs_posv_expert(void)
   return info;
 
 }
+/* SPD tridiagonal test matrix (diag 4, off-diag 1) */
+static NumericsMatrix * chol_update_test_matrix(int storageType, int n)
+{
+  NumericsMatrix * M = NM_create(storageType, n, n);
+  if(storageType == NM_SPARSE)
+  {
+    NM_triplet_alloc(M, 3 * n);
+    M->matrix2->origin = NSM_TRIPLET;
+  }
+  for(int i = 0; i < n; ++i)
+  {
+    NM_entry(M, i, i, 4.0);
+    if(i > 0)
+    {
+      NM_entry(M, i, i - 1, 1.0);
+      NM_entry(M, i - 1, i, 1.0);
+    }
+  }
+  return M;
+}
+
+/* bump one entry of the csc values in place, without going through the
+   version machinery (the pattern must already hold the entry) */
+static void chol_update_csc_add(NumericsMatrix * M, CS_INT i, CS_INT j, double delta)
+{
+  CSparseMatrix * c = NM_csc(M);
+  for(CS_INT p = c->p[j]; p < c->p[j + 1]; ++p)
+    if(c->i[p] == i)
+    {
+      c->x[p] += delta;
+      return;
+    }
+}
+
+/* solve M x = b through the stored factors and check the residual
+   against the reference matrix */
+static int chol_update_check(NumericsMatrix * M, NumericsMatrix * M_ref, double * b)
+{
+  int n = M->size0;
+  double * x = (double*)malloc(n * sizeof(double));
+  double * y = (double*)malloc(n * sizeof(double));
+  for(int j = 0; j < n; j++)
+  {
+    x[j] = b[j];
+    y[j] = b[j];
+  }
+  int info = NM_Cholesky_solve(M, x, 1);
+  NM_gemv(-1.0, M_ref, x, 1.0, y);
+  double res = cblas_dnrm2(n, y, 1);
+  printf("residual = %e\n", res);
+  if(info || fabs(res) >= sqrt(DBL_EPSILON)) info = 1;
+  free(x);
+  free(y);
+  return info;
+}
+
+static int test_NM_Cholesky_refactorize_update(void)
+{
+  printf("========= Starts Numerics tests for NumericsMatrix (test_NM_Cholesky_refactorize_update)  ========= \n");
+  int n = 10;
+  int info = 0;
+  double * b = (double*)malloc(n * sizeof(double));
+  for(int j = 0; j < n; j++) b[j] = 1.0 + j;
+
+  /* sparse storage: shifted refactorization, then rank-one
+     update/downdate of the factors */
+  NumericsMatrix * M = chol_update_test_matrix(NM_SPARSE, n);
+  NumericsMatrix * M_ref = chol_update_test_matrix(NM_SPARSE, n);
+  NSM_linearSolverParams(M)->solver = NSM_CSPARSE;
+
+  printf("sparse Cholesky solve\n");
+  info += chol_update_check(M, M_ref, b);
+
+  printf("sparse refactorization after a diagonal shift\n");
+  for(CS_INT j = 0; j < n; ++j)
+  {
+    chol_update_csc_add(M, j, j, 0.5);
+    chol_update_csc_add(M_ref, j, j, 0.5);
+  }
+  info += NM_Cholesky_refactorize(M);
+  info += chol_update_check(M, M_ref, b);
+
+  printf("sparse rank-one update then downdate\n");
+  double * w = (double*)calloc(n, sizeof(double));
+  w[2] = 0.7;
+  info += NM_Cholesky_rank_update(M, w, 1);
+  chol_update_csc_add(M_ref, 2, 2, 0.49);
+  info += chol_update_check(M, M_ref, b);
+
+  info += NM_Cholesky_rank_update(M, w, -1);
+  chol_update_csc_add(M_ref, 2, 2, -0.49);
+  info += chol_update_check(M, M_ref, b);
+
+  NM_clear(M);
+  free(M);
+  NM_clear(M_ref);
+  free(M_ref);
+
+  /* dense storage: rank-one update/downdate of the in-place factor */
+  M = chol_update_test_matrix(NM_DENSE, n);
+  M_ref = chol_update_test_matrix(NM_DENSE, n);
+
+  printf("dense Cholesky solve\n");
+  info += chol_update_check(M, M_ref, b);
+
+  printf("dense rank-one update then downdate\n");
+  info += NM_Cholesky_rank_update(M, w, 1);
+  NM_entry(M_ref, 2, 2, 4.0 + 0.49);
+  info += chol_update_check(M, M_ref, b);
+
+  info += NM_Cholesky_rank_update(M, w, -1);
+  NM_entry(M_ref, 2, 2, 4.0);
+  info += chol_update_check(M, M_ref, b);
+
+  NM_clear(M);
+  free(M);
+  NM_clear(M_ref);
+  free(M_ref);
+  free(w);
+  free(b);
+
+  printf("========= End Numerics tests for NumericsMatrix (test_NM_Cholesky_refactorize_update), info = %d ========= \n", info);
+  return info;
+}
+
 static int test_NM_LDLT_solve_unit(NumericsMatrix * M, double * b)
 {
   int n = M->size0;
@@ -3753,6 +3963,124 @@ static int test_NM_max_by_columns_and_rows(void)
 
 
 
+static int test_NM_reorder_method(NM_reorder_method method)
+{
+  int size = 8;
+  int info = 0;
+  NumericsMatrix * A  = NM_create(NM_SPARSE, size, size);
+  NM_triplet_alloc(A,0);
+  A->matrix2->origin= NSM_TRIPLET;
+  /* arrow matrix: full first row and column plus the diagonal, the worst
+     pattern for the natural ordering */
+  for(int i =0; i < size; i++)
+  {
+    NM_entry(A, i, i, 4.0 + i);
+    if(i > 0)
+    {
+      NM_entry(A, 0, i, 1.0);
+      NM_entry(A, i, 0, 1.0);
+    }
+  }
+
+  double x[8], y_ref[8], px[8], py[8], y[8];
+  for(int i =0; i < size; i++)
+  {
+    x[i] = i + 1.0;
+    y_ref[i] = 0.0;
+    py[i] = 0.0;
+  }
+  NM_gemv(1.0, A, x, 0.0, y_ref);
+
+  info = NM_reorder(A, method);
+  if(info) return info;
+  if(!A->matrix2->reorder_perm) return 1;
+
+  /* A(p,p) x(p) must be (A x)(p): carry x into the new ordering, multiply
+     and come back */
+  NM_reorder_rhs(A, x, px);
+  NM_gemv(1.0, A, px, 0.0, py);
+  NM_reorder_solution(A, py, y);
+  for(int i =0; i < size; i++)
+  {
+    if(fabs(y[i] - y_ref[i]) > 1e-12)
+    {
+      printf("test_NM_reorder: y[%i] = %e != %e\n", i, y[i], y_ref[i]);
+      info = 1;
+    }
+  }
+  NM_clear(A);
+  free(A);
+  return info;
+}
+
+static int test_NM_reorder(void)
+{
+  printf("== Numerics tests: NM_reorder == \n");
+  int info = test_NM_reorder_method(NM_REORDER_AMD);
+  info += test_NM_reorder_method(NM_REORDER_RCM);
+  printf("== End of test NM_reorder, result = %d\n", info);
+  return info;
+}
+
+static int test_NM_mem_callback_count = 0;
+
+static void test_NM_mem_callback(size_t total, size_t budget, void* user_data)
+{
+  test_NM_mem_callback_count++;
+  NM_mem_evict_factors((NumericsMatrix*)user_data);
+}
+
+static int test_NM_mem(void)
+{
+  printf("== Numerics tests: NM_mem == \n");
+  int size = 8;
+  int info = 0;
+
+  NumericsMatrix * A  = NM_create(NM_SPARSE, size, size);
+  NM_triplet_alloc(A,0);
+  A->matrix2->origin= NSM_TRIPLET;
+  for(int i =0; i < size; i++)
+  {
+    NM_entry(A, i, i, 4.0 + i);
+    if(i > 0)
+    {
+      NM_entry(A, 0, i, 1.0);
+      NM_entry(A, i, 0, 1.0);
+    }
+  }
+
+  /* all the checks below are per-matrix: the registry behind
+     NM_mem_total() is process-global and other sections of this binary
+     leave matrices behind, so global totals are not reproducible here */
+  if(NM_sizeof_tag(A, NM_MEM_SPARSE) == 0) info = 1;
+  if(NM_mem_total() < NM_sizeof(A)) info = 1;
+
+  double b[8];
+  for(int i =0; i < size; i++) b[i] = 1.0;
+  info += NM_LU_factorize(A);
+  if(NM_sizeof_tag(A, NM_MEM_FACTORS) == 0) info = 1;
+
+  /* a one byte budget must fire the callback, which drops the factors */
+  NM_mem_set_budget(1, &test_NM_mem_callback, NULL);
+  NM_mem_check_budget();
+  if(test_NM_mem_callback_count != 1) info = 1;
+  if(NM_sizeof_tag(A, NM_MEM_FACTORS) != 0) info = 1;
+  NM_mem_set_budget(0, NULL, NULL);
+
+  /* the matrix must still be usable: factors are rebuilt on demand */
+  info += NM_LU_solve(A, b, 1);
+
+  /* clearing A must release exactly its own bytes from the total */
+  size_t total_before_clear = NM_mem_total();
+  size_t a_bytes = NM_sizeof(A);
+  if(a_bytes == 0) info = 1;
+  NM_clear(A);
+  free(A);
+  if(NM_mem_total() != total_before_clear - a_bytes) info = 1;
+  printf("== End of test NM_mem, result = %d\n", info);
+  return info;
+}
+
 int main(int argc, char *argv[])
 {
 
@@ -3800,11 +4128,15 @@ int main(int argc, char *argv[])
   info += test_NM_posv_expert();
 
   info += test_NM_LU_solve();
+  info += test_NM_LU_solve_multi();
   info += test_NM_LU_solve_matrix_rhs();
   info += test_NM_Cholesky_solve_matrix_rhs();
   info += test_NM_Cholesky_solve();
   info += test_NM_Cholesky_solve_vs_posv_expert();
+  info += test_NM_Cholesky_refactorize_update();
   info += test_NM_LDLT_solve();
+  info += test_NM_reorder();
+  info += test_NM_mem();
 
 #ifdef WITH_OPENSSL
   info += test_NM_compute_values_sha1();
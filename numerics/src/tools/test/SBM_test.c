@@ -23,6 +23,7 @@
  */
 
 #include "SBM_test.h"
+#include <math.h>                        // for fabs
 #include <stdio.h>                       // for printf, fclose, fopen, FILE
 #include <stdlib.h>                      // for free, malloc, calloc
 #include "CSparseMatrix_internal.h"               // for CSparseMatrix_spfree_on_stack
@@ -1263,6 +1264,132 @@ int SBM_entry_all(void)
 }
 
 
+static int SBM_compactify_test1(double tol)
+{
+  int info = 0;
+  FILE *file = fopen("data/SBM1.dat", "r");
+  SparseBlockStructuredMatrix * M = SBM_new_from_file(file);
+  fclose(file);
+
+  unsigned int sizeY = M->blocksize0[M->blocknumber0 - 1];
+  unsigned int sizeX = M->blocksize1[M->blocknumber1 - 1];
+
+  double * x = (double *) malloc(sizeX * sizeof(double));
+  double * y = (double *) malloc(sizeY * sizeof(double));
+  double * yref = (double *) malloc(sizeY * sizeof(double));
+  for(unsigned int i = 0; i < sizeX; i++) x[i] = i + 1.0;
+  for(unsigned int i = 0; i < sizeY; i++)
+  {
+    y[i] = 1.0;
+    yref[i] = 1.0;
+  }
+
+  SBM_gemv(sizeX, sizeY, 2.0, M, x, 0.5, yref);
+
+  SBM_compactify(M);
+  if(!M->block_arena) info = 1;
+
+  /* compacting twice must be harmless */
+  SBM_compactify(M);
+
+  /* the product on the compacted matrix must not change */
+  SBM_gemv(sizeX, sizeY, 2.0, M, x, 0.5, y);
+  for(unsigned int i = 0; i < sizeY; i++)
+  {
+    if(fabs(y[i] - yref[i]) > tol) info = 1;
+  }
+
+  free(x);
+  free(y);
+  free(yref);
+  SBM_clear(M);
+  return info;
+}
+
+int SBM_compactify_all(void)
+{
+
+  double tol = 1e-14;
+
+  printf("========= Starts SBM tests SBM_compactify  ========= \n");
+
+  int info = SBM_compactify_test1(tol);
+  if(info == 1)
+  {
+    printf("========= Ends SBM tests SBM_compactify  :  Unsuccessfull ========= \n");
+    return info;
+  }
+  printf("========= Ends SBM tests SBM_compactify  :  successfull ========= \n");
+
+  return info;
+
+}
+
+
+static int SBM_column_index_test1(double tol)
+{
+  int info = 0;
+
+  FILE *file = fopen("data/SBM1.dat", "r");
+  SparseBlockStructuredMatrix * M = SBM_new_from_file(file);
+  fclose(file);
+
+  /* the cached view must be reused while the structure is unchanged */
+  struct SBM_index_by_column * index = SBM_column_index(M);
+  if(SBM_column_index(M) != index) info = 1;
+  if(index->filled3 != M->blocknumber1 + 1) info = 1;
+  if(index->filled4 != M->nbblocks) info = 1;
+
+  /* each column lists its blocks sorted by row, mapped back to the
+     row-major storage */
+  for(size_t col = 0; col + 1 < index->filled3; ++col)
+  {
+    for(size_t k = index->index3_data[col]; k < index->index3_data[col + 1]; ++k)
+    {
+      size_t blockNum = index->blockMap[k];
+      if(M->index2_data[blockNum] != col) info = 1;
+      if(k > index->index3_data[col]
+         && index->index4_data[k - 1] >= index->index4_data[k]) info = 1;
+    }
+  }
+
+  /* the transpose built from the view agrees with the dense transpose */
+  SparseBlockStructuredMatrix * T = SBM_new();
+  SBM_transpose(M, T);
+
+  int n = M->blocksize0[M->blocknumber0 - 1];
+  int m = M->blocksize1[M->blocknumber1 - 1];
+  double * M_dense = (double *) malloc(n * m * sizeof(double));
+  SBM_to_dense(M, M_dense);
+  double * Mt_dense = (double *) malloc(n * m * sizeof(double));
+  for(int i = 0; i < n; ++i)
+    for(int j = 0; j < m; ++j)
+      Mt_dense[j + i * m] = M_dense[i + j * n];
+
+  info += SBM_dense_equal(T, Mt_dense, tol);
+
+  free(M_dense);
+  free(Mt_dense);
+  SBM_clear(T);
+  SBM_clear(M);
+  return info;
+}
+
+int SBM_column_index_all(void)
+{
+  double tol = 1e-14;
+
+  printf("========= Starts SBM tests SBM_column_index  ========= \n");
+  int info = SBM_column_index_test1(tol);
+  if(info)
+  {
+    printf("========= Ends SBM tests SBM_column_index  :  Unsuccessfull ========= \n");
+    return info;
+  }
+  printf("========= Ends SBM tests SBM_column_index  :  successfull ========= \n");
+  return info;
+}
+
 int main()
 {
 
@@ -1286,5 +1413,9 @@ int main()
 
   info += SBM_extract_component_3x3_all();
 
+  info += SBM_compactify_all();
+
+  info += SBM_column_index_all();
+
   return info;
 }
@@ -0,0 +1,84 @@
+#include <math.h>                  // for fabs, sqrt
+#include <stdio.h>                 // for printf
+#include "AndersonAcceleration.h"  // for anderson_acceleration_step
+
+#define N 4
+
+/* contractive affine map g(x) = B x + c, fixed point solves (I - B) x = c */
+static void g_affine(const double* x, double* gx)
+{
+  static const double B[N][N] = {{0.50, 0.10, 0.00, 0.05},
+    {0.10, 0.40, 0.10, 0.00},
+    {0.00, 0.10, 0.60, 0.10},
+    {0.05, 0.00, 0.10, 0.30}
+  };
+  static const double c[N] = {1.0, -2.0, 0.5, 3.0};
+  for(int i = 0; i < N; ++i)
+  {
+    gx[i] = c[i];
+    for(int j = 0; j < N; ++j)
+      gx[i] += B[i][j] * x[j];
+  }
+}
+
+static double residual(const double* x)
+{
+  double gx[N];
+  double r = 0.0;
+  g_affine(x, gx);
+  for(int i = 0; i < N; ++i)
+    r += (gx[i] - x[i]) * (gx[i] - x[i]);
+  return sqrt(r);
+}
+
+static int iterate(AndersonAcceleration* aa, int itermax, double tol)
+{
+  double x[N] = {0.0, 0.0, 0.0, 0.0};
+  double gx[N];
+  int iter = 0;
+  while(residual(x) > tol && iter < itermax)
+  {
+    ++iter;
+    g_affine(x, gx);
+    if(aa)
+      anderson_acceleration_step(aa, x, gx, x);
+    else
+      for(int i = 0; i < N; ++i) x[i] = gx[i];
+  }
+  return iter;
+}
+
+int main(void)
+{
+  int info = 0;
+  double tol = 1e-12;
+  int itermax = 500;
+
+  int iter_plain = iterate(NULL, itermax, tol);
+  printf("plain fixed point: %i iterations\n", iter_plain);
+  if(iter_plain >= itermax) info = 1;
+
+  /* on an affine map, a history at least as deep as the dimension makes
+     the mixing exact: convergence in a handful of steps */
+  AndersonAcceleration* aa = anderson_acceleration_new(N, N);
+  int iter_aa = iterate(aa, itermax, tol);
+  printf("anderson (m = %i):  %i iterations\n", N, iter_aa);
+  if(iter_aa > N + 2 || iter_aa >= iter_plain) info = 1;
+
+  /* after a restart the accelerator behaves like a fresh one */
+  anderson_acceleration_restart(aa);
+  int iter_restart = iterate(aa, itermax, tol);
+  printf("after restart:     %i iterations\n", iter_restart);
+  if(iter_restart != iter_aa) info = 1;
+  anderson_acceleration_free(aa);
+
+  /* a shallow history still accelerates */
+  aa = anderson_acceleration_new(N, 2);
+  int iter_shallow = iterate(aa, itermax, tol);
+  printf("anderson (m = 2):  %i iterations\n", iter_shallow);
+  if(iter_shallow >= iter_plain) info = 1;
+  anderson_acceleration_free(aa);
+
+  printf("test_anderson: %s\n", info ? "failed" : "succeeded");
+  return info;
+}
@@ -0,0 +1,103 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+#include <math.h>            // for fabs
+#include <stdio.h>           // for printf
+#include "NumericsMatrix.h"  // for NM_create, NM_free, NM_DENSE
+#include "cond.h"            // for cond_estimate_1norm, cond_estimate_spd
+
+/* diag(1, 10, 100): both condition numbers are exactly 100 */
+static NumericsMatrix * build_diag(void)
+{
+  NumericsMatrix * A = NM_create(NM_DENSE, 3, 3);
+  A->matrix0[0 + 0 * 3] = 1.0;
+  A->matrix0[1 + 1 * 3] = 10.0;
+  A->matrix0[2 + 2 * 3] = 100.0;
+  return A;
+}
+
+static int test_cond_estimate_1norm(void)
+{
+  NumericsMatrix * A = build_diag();
+  double est = cond_estimate_1norm(A);
+  NM_free(A);
+
+  printf("cond_estimate_1norm(diag(1,10,100)) = %g\n", est);
+  /* the Hager estimator is exact on a diagonal matrix; accept a
+   * factor 2 of slack anyway */
+  if(est < 50.0 || est > 200.0) return 1;
+  return 0;
+}
+
+static int test_cond_estimate_spd(void)
+{
+  int info = 0;
+  NumericsMatrix * A = build_diag();
+
+  double eig_max = 0.0, eig_min = 0.0;
+  info = cond_extreme_eigenvalues_spd(A, 100, 1e-10, &eig_max, &eig_min);
+  printf("extreme eigenvalues of diag(1,10,100): max = %g, min = %g\n",
+         eig_max, eig_min);
+  if(info != 0) return 1;
+  if(fabs(eig_max - 100.0) > 10.0) info += 1;
+  if(fabs(eig_min - 1.0) > 0.1) info += 1;
+
+  NM_free(A);
+
+  A = build_diag();
+  double est = cond_estimate_spd(A, 100, 1e-10);
+  NM_free(A);
+
+  printf("cond_estimate_spd(diag(1,10,100)) = %g\n", est);
+  if(fabs(est - 100.0) > 10.0) info += 1;
+  return info;
+}
+
+static int test_cond_estimate_spd_tridiag(void)
+{
+  /* tridiag(-1, 2, -1) of order 10: eigenvalues 2 - 2 cos(k pi / 11),
+   * so eig_max ~ 3.91899 and eig_min ~ 0.0810141 */
+  int n = 10;
+  NumericsMatrix * A = NM_create(NM_DENSE, n, n);
+  for(int i = 0; i < n; ++i)
+  {
+    A->matrix0[i + i * n] = 2.0;
+    if(i > 0) A->matrix0[i + (i - 1) * n] = -1.0;
+    if(i < n - 1) A->matrix0[i + (i + 1) * n] = -1.0;
+  }
+
+  double eig_max = 0.0, eig_min = 0.0;
+  int info = cond_extreme_eigenvalues_spd(A, 500, 1e-8, &eig_max, &eig_min);
+  NM_free(A);
+
+  printf("extreme eigenvalues of tridiag(-1,2,-1): max = %g, min = %g\n",
+         eig_max, eig_min);
+  if(info != 0) return 1;
+  if(fabs(eig_max - 3.91899) > 0.4) info += 1;
+  if(fabs(eig_min - 0.0810141) > 0.01) info += 1;
+  return info;
+}
+
+int main(void)
+{
+  int info = 0;
+  info += test_cond_estimate_1norm();
+  info += test_cond_estimate_spd();
+  info += test_cond_estimate_spd_tridiag();
+  printf("test_cond: info = %d\n", info);
+  return info;
+}
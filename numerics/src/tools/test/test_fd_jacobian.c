@@ -0,0 +1,158 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* test of the colored finite-difference Jacobian: a tridiagonal
+   nonlinear map whose Jacobian is known analytically. The coloring of
+   a tridiagonal pattern must use a small number of colors (3 for n
+   large enough), not n. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CSparseMatrix_internal.h"
+#include "FiniteDifferenceJacobian.h"
+#include "NumericsMatrix.h"
+
+#define N 17
+#define TOL 1e-6
+
+/* F_i(z) = z_i^2 + z_{i-1} - 2 z_{i+1}; dF_i/dz_i = 2 z_i */
+static void F_tridiag(void* env, int n, double* z, double* F)
+{
+  int* calls = (int*)env;
+  if(calls) (*calls)++;
+  for(int i = 0; i < n; ++i)
+  {
+    F[i] = z[i] * z[i];
+    if(i > 0) F[i] += z[i - 1];
+    if(i < n - 1) F[i] -= 2.0 * z[i + 1];
+  }
+}
+
+static void F_tridiag_batch(void* env, int n, int npoints, double* z, double* F)
+{
+  int* calls = (int*)env;
+  if(calls) (*calls)++;
+  for(int p = 0; p < npoints; ++p)
+    F_tridiag(NULL, n, z + (size_t)p * n, F + (size_t)p * n);
+}
+
+static double jac_entry(int i, int j, double* z)
+{
+  if(i == j) return 2.0 * z[i];
+  if(j == i - 1) return 1.0;
+  if(j == i + 1) return -2.0;
+  return 0.0;
+}
+
+static int check_dense_jacobian(NumericsMatrix* jacF, double* z)
+{
+  int info = 0;
+  for(int j = 0; j < N; ++j)
+    for(int i = 0; i < N; ++i)
+      if(fabs(jacF->matrix0[i + j * N] - jac_entry(i, j, z)) > TOL)
+      {
+        printf("entry (%i,%i): %g != %g\n", i, j,
+               jacF->matrix0[i + j * N], jac_entry(i, j, z));
+        info = 1;
+      }
+  return info;
+}
+
+int main(void)
+{
+  int info = 0;
+
+  /* tridiagonal csc pattern */
+  CSparseMatrix* pattern = cs_spalloc(N, N, 3 * N, 0, 1);
+  for(int j = 0; j < N; ++j)
+    for(int i = (j > 0 ? j - 1 : 0); i <= (j < N - 1 ? j + 1 : N - 1); ++i)
+      cs_entry(pattern, i, j, 1.0);
+  CSparseMatrix* P = cs_compress(pattern);
+  cs_spfree(pattern);
+
+  double z[N];
+  for(int i = 0; i < N; ++i) z[i] = 0.5 + 0.1 * i;
+
+  int calls = 0;
+  FiniteDifferenceJacobian* fd = fd_jacobian_new(N, P, &F_tridiag, &calls);
+  cs_spfree(P);
+
+  printf("tridiagonal pattern: %i colors\n", fd->nb_colors);
+  if(fd->nb_colors > 4)
+  {
+    printf("coloring failure: %i colors for a tridiagonal pattern\n",
+           fd->nb_colors);
+    info = 1;
+  }
+
+  NumericsMatrix* jacF = NM_create(NM_DENSE, N, N);
+
+  calls = 0;
+  fd_jacobian_compute(fd, z, jacF);
+  info += check_dense_jacobian(jacF, z);
+  if(calls != fd->nb_colors + 1)
+  {
+    printf("expected %i calls of F, got %i\n", fd->nb_colors + 1, calls);
+    info = 1;
+  }
+
+  /* batched evaluation: one call for the base point, one for all the
+     perturbed points */
+  fd_jacobian_set_batch(fd, &F_tridiag_batch);
+  calls = 0;
+  fd_jacobian_compute(fd, z, jacF);
+  info += check_dense_jacobian(jacF, z);
+  if(calls != 2)
+  {
+    printf("expected 2 calls with batching, got %i\n", calls);
+    info = 1;
+  }
+
+  /* sparse output storage */
+  NumericsMatrix* jacFs = NM_create(NM_SPARSE, N, N);
+  NM_triplet_alloc(jacFs, 3 * N);
+  fd_jacobian_compute(fd, z, jacFs);
+  for(int j = 0; j < N; ++j)
+    for(int i = 0; i < N; ++i)
+      if(fabs(NM_get_value(jacFs, i, j) - jac_entry(i, j, z)) > TOL)
+      {
+        printf("sparse entry (%i,%i) mismatch\n", i, j);
+        info = 1;
+      }
+
+  fd_jacobian_free(fd);
+
+  /* dense fallback: no pattern, one color per column */
+  FiniteDifferenceJacobian* fdd = fd_jacobian_new(N, NULL, &F_tridiag, NULL);
+  if(fdd->nb_colors != N)
+  {
+    printf("dense fallback: expected %i colors, got %i\n", N, fdd->nb_colors);
+    info = 1;
+  }
+  fd_jacobian_compute(fdd, z, jacF);
+  info += check_dense_jacobian(jacF, z);
+  fd_jacobian_free(fdd);
+
+  NM_free(jacF);
+  NM_free(jacFs);
+
+  printf("test_fd_jacobian: %s\n", info == 0 ? "success" : "failure");
+  return info;
+}
@@ -0,0 +1,169 @@
+/* random is POSIX but not C99...
+ * we don't define _BSD_SOURCE but rather _XOPEN_SOURCE */
+#define _XOPEN_SOURCE 700
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <math.h>
+
+#include "opNxN.h"
+
+#ifdef _WIN32
+#define random rand
+#define srandom srand
+#endif
+
+static double drand(void)
+{
+  return (double) random() / RAND_MAX - 0.5;
+}
+
+/* residual || a x - b || for a column-major n x n matrix */
+static double residual(unsigned int n, double* a, double* x, double* b)
+{
+  double r = 0.;
+  for(unsigned int i = 0; i < n; ++i)
+  {
+    double ri = -b[i];
+    for(unsigned int j = 0; j < n; ++j)
+      ri += a[i + n * j] * x[j];
+    r += ri * ri;
+  }
+  return sqrt(r);
+}
+
+int main(void)
+{
+  unsigned int i, j, k;
+  int info;
+
+  srandom(1);
+
+  /* solve and inverse kernels on random (well conditioned enough in
+   * practice) matrices */
+  for(k = 0; k < 1000; ++k)
+  {
+    double a3[9], b3[3], x3[3], i3[9];
+    for(i = 0; i < 9; ++i) a3[i] = drand();
+    for(i = 0; i < 3; ++i) b3[i] = x3[i] = drand();
+
+    info = SOLVE_NXN(3, a3, x3);
+    if(!info)
+    {
+      assert(residual(3, a3, x3, b3) < 1e-6);
+
+      info = INV_NXN(3, a3, i3);
+      assert(!info);
+      for(j = 0; j < 3; ++j)
+      {
+        double e[3] = {0., 0., 0.};
+        e[j] = 1.;
+        assert(residual(3, a3, i3 + 3 * j, e) < 1e-6);
+      }
+    }
+
+    double a4[16], b4[4], x4[4], i4[16];
+    for(i = 0; i < 16; ++i) a4[i] = drand();
+    for(i = 0; i < 4; ++i) b4[i] = x4[i] = drand();
+
+    info = SOLVE_NXN(4, a4, x4);
+    if(!info)
+    {
+      assert(residual(4, a4, x4, b4) < 1e-6);
+
+      info = INV_NXN(4, a4, i4);
+      assert(!info);
+      for(j = 0; j < 4; ++j)
+      {
+        double e[4] = {0., 0., 0., 0.};
+        e[j] = 1.;
+        assert(residual(4, a4, i4 + 4 * j, e) < 1e-6);
+      }
+    }
+  }
+
+  /* solve_3x3 against the historical pivoted elimination */
+  for(k = 0; k < 1000; ++k)
+  {
+    double a[9], x1[3], x2[3];
+    for(i = 0; i < 9; ++i) a[i] = drand();
+    for(i = 0; i < 3; ++i) x1[i] = x2[i] = drand();
+
+    int info1 = solve_3x3(a, x1);
+    int info2 = solve_3x3_gepp(a, x2);
+    if(!info1 && !info2)
+      for(i = 0; i < 3; ++i)
+        assert(fabs(x1[i] - x2[i]) < 1e-6 * (1. + fabs(x2[i])));
+  }
+
+  /* singular matrices must be reported and leave b untouched */
+  {
+    double a[9] = {1., 2., 3., 2., 4., 6., 0., 1., 0.};
+    double b[3] = {1., 1., 1.};
+    info = solve_3x3(a, b);
+    assert(info);
+    assert(b[0] == 1. && b[1] == 1. && b[2] == 1.);
+  }
+
+  /* Cholesky kernels on random symmetric positive definite matrices
+   * a = c c^T + n I, and the 6x6 Schur solve on the same matrices */
+  for(k = 0; k < 1000; ++k)
+  {
+    double c[36], a[36], f[36], b[6], x[6];
+
+    for(unsigned int n = 3; n <= 6; ++n)
+    {
+      if(n == 5) continue;
+
+      for(i = 0; i < n * n; ++i) c[i] = drand();
+      for(i = 0; i < n; ++i)
+        for(j = 0; j < n; ++j)
+        {
+          a[i + n * j] = (i == j) ? (double) n : 0.;
+          for(unsigned int l = 0; l < n; ++l)
+            a[i + n * j] += c[i + n * l] * c[j + n * l];
+        }
+      for(i = 0; i < n; ++i) b[i] = x[i] = drand();
+      for(i = 0; i < n * n; ++i) f[i] = a[i];
+
+      switch(n)
+      {
+      case 3:
+        info = CHOL_NXN(3, f);
+        assert(!info);
+        CHOL_SOLVE_NXN(3, f, x);
+        break;
+      case 4:
+        info = CHOL_NXN(4, f);
+        assert(!info);
+        CHOL_SOLVE_NXN(4, f, x);
+        break;
+      default:
+        info = CHOL_NXN(6, f);
+        assert(!info);
+        CHOL_SOLVE_NXN(6, f, x);
+        break;
+      }
+      assert(residual(n, a, x, b) < 1e-6);
+
+      if(n == 6)
+      {
+        for(i = 0; i < 6; ++i) x[i] = b[i];
+        info = SOLVE_NXN(6, a, x);
+        assert(!info);
+        assert(residual(6, a, x, b) < 1e-6);
+      }
+    }
+  }
+
+  /* a non positive definite matrix must be reported */
+  {
+    double a[9] = {1., 0., 0., 0., -1., 0., 0., 0., 1.};
+    info = chol_3x3(a);
+    assert(info);
+  }
+
+  printf("test_opNxN: ok\n");
+  return 0;
+}
@@ -2,6 +2,15 @@
 #include "VariationalInequality.h"
 #include <open_lib.h>
 
+/* hold the GIL while running a Python callback: the drivers may be
+   called with the GIL released (see the %exception blocks in numerics.i) */
+struct SN_gil_guard
+{
+  PyGILState_STATE state;
+  SN_gil_guard() : state(PyGILState_Ensure()) {}
+  ~SN_gil_guard() { PyGILState_Release(state); }
+};
+
 static PyObject *my_callback_NablaFmcp = NULL;
 
 static PyObject * set_my_callback_NablaFmcp(PyObject *o)
@@ -24,6 +33,7 @@ static PyObject * set_my_callback_NablaFmcp(PyObject *o)
 
 static void  my_call_to_callback_NablaFmcp (int size, double *z, double *nablaF)
 {
+    SN_gil_guard gil_guard;
 //  printf("I am in my_call_to_callback_NablaFmcp (int size, double *z, double *NablaF)\n");
 
   npy_intp this_matrix_dim[1];
@@ -119,6 +129,7 @@ static PyObject * set_my_callback_Fmcp(PyObject *o1)
 
 static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 {
+    SN_gil_guard gil_guard;
 
 //  printf("I am in my_call_to_callback_Fmcp (int size, double *z, double *F)\n");
 
@@ -187,6 +198,7 @@ static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 
   static void call_py_compute_Fmcp(void *env, int n, double* z, double* Fmcp)
   {
+    SN_gil_guard gil_guard;
     npy_intp dim[1];
     dim[0] = n;
 
@@ -205,6 +217,7 @@ static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 
   static void call_py_compute_nabla_Fmcp(void *env, int n, double* z, NumericsMatrix* nabla_Fmcp)
   {
+    SN_gil_guard gil_guard;
     npy_intp dim[1];
     dim[0] = n;
 
@@ -228,6 +241,7 @@ static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 
   static void call_py_compute_Fvi(void *problem, int n, double* z, double* F)
   {
+    SN_gil_guard gil_guard;
     npy_intp dim[1];
     dim[0] = n;
 
@@ -247,6 +261,7 @@ static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 
   static void call_py_compute_nabla_Fvi(void * problem, int n, double* z, NumericsMatrix* nabla_F)
   {
+    SN_gil_guard gil_guard;
     npy_intp dim[1];
     dim[0] = n;
 
@@ -271,6 +286,7 @@ static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 
   static void call_py_compute_Fncp(void* env, int n, double* z, double* F)
   {
+    SN_gil_guard gil_guard;
     npy_intp dim[1];
     dim[0] = n;
 
@@ -288,6 +304,7 @@ static void  my_call_to_callback_Fmcp (int size, double *z, double *F)
 
   static void call_py_compute_nabla_Fncp(void* env, int n, double* z, NumericsMatrix* nabla_F)
   {
+    SN_gil_guard gil_guard;
     npy_intp dim[1];
     dim[0] = n;
 
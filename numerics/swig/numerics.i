@@ -95,6 +95,68 @@ static char* format_msg_concat(const char* msg1, const char* msg2)
 
 }
 
+// Same error handling as above, but with the GIL released around the
+// driver call, so that other Python threads can run during a long
+// solve. The python callbacks (solver options callback, mcp/ncp/vi
+// function objects) re-acquire the GIL with PyGILState_Ensure before
+// calling back into the interpreter.
+%define %GIL_RELEASED_DRIVER(FUNC)
+%exception FUNC {
+  PyThreadState* _save = PyEval_SaveThread();
+  switch (SN_SETJMP_EXTERNAL_START)
+  {
+  case SN_NO_ERROR:
+  {
+    $action
+    SN_SETJMP_EXTERNAL_STOP
+    PyEval_RestoreThread(_save);
+    break;
+  }
+  case SN_MEMORY_ALLOC_ERROR:
+  {
+    PyEval_RestoreThread(_save);
+    SWIG_exception(SWIG_MemoryError, format_exception_msg("Out of memory:"));
+    break;
+  }
+  case SN_UNSUPPORTED_LINALG_OP:
+  {
+    PyEval_RestoreThread(_save);
+    SWIG_exception(SWIG_RuntimeError, format_exception_msg("Unsupported linear algebra operation:"));
+    break;
+  }
+  case SN_PROBLEM_NOT_PROCESSABLE:
+  {
+    PyEval_RestoreThread(_save);
+    SWIG_exception(SWIG_RuntimeError, format_exception_msg("The given problem is not processable:"));
+    break;
+  }
+  default:
+  {
+    PyEval_RestoreThread(_save);
+    SWIG_exception(SWIG_UnknownError, format_exception_msg("Unknown error! Hopefully more info follow:"));
+    break;
+  }
+  }
+}
+%enddef
+
+%GIL_RELEASED_DRIVER(linearComplementarity_driver)
+%GIL_RELEASED_DRIVER(mlcp_driver)
+%GIL_RELEASED_DRIVER(relay_driver)
+%GIL_RELEASED_DRIVER(fc2d_driver)
+%GIL_RELEASED_DRIVER(fc3d_driver)
+%GIL_RELEASED_DRIVER(rolling_fc2d_driver)
+%GIL_RELEASED_DRIVER(rolling_fc3d_driver)
+%GIL_RELEASED_DRIVER(gfc2d_driver)
+%GIL_RELEASED_DRIVER(gfc3d_driver)
+%GIL_RELEASED_DRIVER(g_rolling_fc3d_driver)
+%GIL_RELEASED_DRIVER(variationalInequality_driver)
+%GIL_RELEASED_DRIVER(avi_driver)
+%GIL_RELEASED_DRIVER(mcp_driver)
+%GIL_RELEASED_DRIVER(mcp_old_driver)
+%GIL_RELEASED_DRIVER(ncp_driver)
+%GIL_RELEASED_DRIVER(soclcp_driver)
+
 // generated docstrings from doxygen xml output
 // %include numerics-docstrings.i
 
@@ -0,0 +1,366 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* Compare fc3d solver configurations over a whole problem corpus
+   (see FrictionContactCorpus.h):
+
+     fc_corpus_bench [-t tol] [-m maxiter] [-j workers] <corpus.fcc> \
+                     <solver>[,iparamK=V][,dparamK=V]... ...
+
+   Each solver argument is a solver name or id of Friction_cst.h,
+   optionally followed by iparam/dparam overrides, e.g.
+
+     fc_corpus_bench corpus.fcc NSGS NSGS,iparam14=1 ADMM,dparam3=0.1
+
+   The problems are solved in parallel, one problem per worker; within a
+   problem the configurations run one after the other on private copies
+   of the mapped view. The tool prints one row per problem (status,
+   iterations, wall time and the recomputed residual of every
+   configuration) followed by a Dolan-More performance profile on the
+   wall times, which is what we read to pick a production configuration:
+   rho(tau) is the fraction of the corpus a configuration solves within
+   tau times the best time of that problem. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FrictionContactCorpus.h"
+#include "FrictionContactProblem.h"
+#include "Friction_cst.h"
+#include "NonSmoothDrivers.h"
+#include "NumericsTaskPool.h"
+#include "SiconosBlas.h"
+#include "SolverOptions.h"
+#include "fc3d_compute_error.h"
+#include "numerics_verbose.h"
+
+#define BENCH_MAX_OVERRIDES 16
+
+typedef struct
+{
+  int iparam;     /* 1 for an iparam override, 0 for dparam */
+  int index;
+  double value;
+} SolverOverride;
+
+typedef struct
+{
+  const char* spec;  /* the command line argument, for the report */
+  int solver_id;
+  int n_overrides;
+  SolverOverride overrides[BENCH_MAX_OVERRIDES];
+} SolverSpec;
+
+typedef struct
+{
+  int info;
+  int iterations;
+  double time;
+  double error;
+} SolveResult;
+
+typedef struct
+{
+  FrictionContactCorpus* corpus;
+  unsigned int problem;
+  const SolverSpec* specs;
+  int n_specs;
+  double tolerance;
+  int maxiter;
+  SolveResult* results;  /* row of n_specs results for this problem */
+} BenchTask;
+
+static double wall_time(void)
+{
+#if defined(_WIN32)
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+#endif
+}
+
+static int parse_spec(char* argument, SolverSpec* spec)
+{
+  spec->spec = argument;
+  spec->n_overrides = 0;
+
+  char* saveptr = NULL;
+  char* buffer = strdup(argument);
+  char* token = strtok_r(buffer, ",", &saveptr);
+  if(!token)
+  {
+    free(buffer);
+    return 1;
+  }
+
+  spec->solver_id = atoi(token);
+  if(!spec->solver_id) spec->solver_id = solver_options_name_to_id(token);
+  if(!spec->solver_id)
+  {
+    fprintf(stderr, "fc_corpus_bench: unknown solver %s\n", token);
+    free(buffer);
+    return 1;
+  }
+
+  while((token = strtok_r(NULL, ",", &saveptr)))
+  {
+    if(spec->n_overrides == BENCH_MAX_OVERRIDES)
+    {
+      fprintf(stderr, "fc_corpus_bench: too many overrides in %s\n", argument);
+      free(buffer);
+      return 1;
+    }
+    SolverOverride* override = &spec->overrides[spec->n_overrides];
+    if(sscanf(token, "iparam%d=%lf", &override->index, &override->value) == 2)
+      override->iparam = 1;
+    else if(sscanf(token, "dparam%d=%lf", &override->index, &override->value) == 2)
+      override->iparam = 0;
+    else
+    {
+      fprintf(stderr, "fc_corpus_bench: cannot parse override %s\n", token);
+      free(buffer);
+      return 1;
+    }
+    if(override->index < 0 || override->index >= OPTIONS_PARAM_SIZE)
+    {
+      fprintf(stderr, "fc_corpus_bench: override index out of range in %s\n", token);
+      free(buffer);
+      return 1;
+    }
+    ++spec->n_overrides;
+  }
+  free(buffer);
+  return 0;
+}
+
+static void bench_task(void* context)
+{
+  BenchTask* task = (BenchTask*)context;
+
+  FrictionContactProblem* view =
+    frictionContact_corpus_get(task->corpus, task->problem);
+  if(!view)
+  {
+    for(int s = 0; s < task->n_specs; ++s)
+    {
+      task->results[s].info = -1;
+      task->results[s].time = INFINITY;
+      task->results[s].error = INFINITY;
+    }
+    return;
+  }
+
+  int nc = view->numberOfContacts;
+  double norm_q = cblas_dnrm2(nc * 3, view->q, 1);
+
+  for(int s = 0; s < task->n_specs; ++s)
+  {
+    const SolverSpec* spec = &task->specs[s];
+    SolveResult* result = &task->results[s];
+
+    /* the view points into the read-only mapping and some solvers
+       rescale the problem in place: solve a private copy */
+    FrictionContactProblem* problem = frictionContact_copy(view);
+    double* reaction = (double*)calloc(nc * 3, sizeof(double));
+    double* velocity = (double*)calloc(nc * 3, sizeof(double));
+
+    SolverOptions* options = solver_options_create(spec->solver_id);
+    options->dparam[SICONOS_DPARAM_TOL] = task->tolerance;
+    options->iparam[SICONOS_IPARAM_MAX_ITER] = task->maxiter;
+    for(int o = 0; o < spec->n_overrides; ++o)
+    {
+      if(spec->overrides[o].iparam)
+        options->iparam[spec->overrides[o].index] = (int)spec->overrides[o].value;
+      else
+        options->dparam[spec->overrides[o].index] = spec->overrides[o].value;
+    }
+
+    double t0 = wall_time();
+    result->info = fc3d_driver(problem, reaction, velocity, options);
+    result->time = wall_time() - t0;
+    result->iterations = options->iparam[SICONOS_IPARAM_ITER_DONE];
+
+    /* recompute the residual with the common error function, so the
+       accuracy column compares like with like whatever the internal
+       criterion of the solver */
+    result->error = INFINITY;
+    fc3d_compute_error(problem, reaction, velocity, task->tolerance, options,
+                       norm_q, &result->error);
+
+    solver_options_delete(options);
+    free(options);
+    free(reaction);
+    free(velocity);
+    frictionContactProblem_free(problem);
+  }
+
+  frictionContact_corpus_problem_free(view);
+}
+
+int main(int argc, char* argv[])
+{
+  double tolerance = 1e-8;
+  int maxiter = 10000;
+  unsigned int workers = 0;  /* 0: one per online processor */
+
+  int argp = 1;
+  while(argp < argc && argv[argp][0] == '-')
+  {
+    if(!strcmp(argv[argp], "-t") && argp + 1 < argc)
+      tolerance = atof(argv[++argp]);
+    else if(!strcmp(argv[argp], "-m") && argp + 1 < argc)
+      maxiter = atoi(argv[++argp]);
+    else if(!strcmp(argv[argp], "-j") && argp + 1 < argc)
+      workers = (unsigned int)atoi(argv[++argp]);
+    else
+    {
+      fprintf(stderr, "fc_corpus_bench: unknown option %s\n", argv[argp]);
+      return 2;
+    }
+    ++argp;
+  }
+
+  if(argc - argp < 2)
+  {
+    fprintf(stderr,
+            "usage: %s [-t tol] [-m maxiter] [-j workers] <corpus.fcc> "
+            "<solver>[,iparamK=V][,dparamK=V]... ...\n", argv[0]);
+    return 2;
+  }
+
+  const char* corpus_file = argv[argp++];
+  int n_specs = argc - argp;
+  SolverSpec* specs = (SolverSpec*)calloc(n_specs, sizeof(SolverSpec));
+  for(int s = 0; s < n_specs; ++s)
+    if(parse_spec(argv[argp + s], &specs[s]))
+    {
+      free(specs);
+      return 2;
+    }
+
+  FrictionContactCorpus* corpus = frictionContact_corpus_open(corpus_file);
+  if(!corpus)
+  {
+    fprintf(stderr, "fc_corpus_bench: cannot open corpus %s\n", corpus_file);
+    free(specs);
+    return 2;
+  }
+  unsigned int n_problems = frictionContact_corpus_size(corpus);
+
+  printf("# corpus    : %s (%u problems)\n", corpus_file, n_problems);
+  printf("# tolerance : %g, maxiter: %d\n", tolerance, maxiter);
+  for(int s = 0; s < n_specs; ++s)
+    printf("# solver %-2d : %s (%s)\n", s, specs[s].spec,
+           solver_options_id_to_name(specs[s].solver_id));
+
+  SolveResult* results =
+    (SolveResult*)calloc((size_t)n_problems * n_specs, sizeof(SolveResult));
+  BenchTask* tasks = (BenchTask*)calloc(n_problems, sizeof(BenchTask));
+
+  /* a pool of our own: the solvers may submit their inner work to the
+     default pool, and mixing both in one set of queues could have a
+     bench task wait on work parked behind other bench tasks */
+  NumericsTaskPool* pool = NTP_create(workers);
+  double t0 = wall_time();
+  for(unsigned int p = 0; p < n_problems; ++p)
+  {
+    tasks[p].corpus = corpus;
+    tasks[p].problem = p;
+    tasks[p].specs = specs;
+    tasks[p].n_specs = n_specs;
+    tasks[p].tolerance = tolerance;
+    tasks[p].maxiter = maxiter;
+    tasks[p].results = &results[(size_t)p * n_specs];
+    NTP_submit(pool, &bench_task, &tasks[p]);
+  }
+  NTP_wait(pool);
+  double total_time = wall_time() - t0;
+  NTP_destroy(pool);
+
+  /* per-problem table */
+  printf("#\n# problem");
+  for(int s = 0; s < n_specs; ++s)
+    printf("  | s%-2d info iters     time    error", s);
+  printf("\n");
+  for(unsigned int p = 0; p < n_problems; ++p)
+  {
+    printf("%9u", p);
+    for(int s = 0; s < n_specs; ++s)
+    {
+      const SolveResult* result = &results[(size_t)p * n_specs + s];
+      printf("  |     %4d %5d %8.3g %8.3g", result->info,
+             result->iterations, result->time, result->error);
+    }
+    printf("\n");
+  }
+
+  /* Dolan-More performance profile on the wall times; a failed solve
+     gets an infinite ratio and never enters rho */
+  double* ratios = (double*)malloc((size_t)n_problems * n_specs * sizeof(double));
+  for(unsigned int p = 0; p < n_problems; ++p)
+  {
+    double best = INFINITY;
+    for(int s = 0; s < n_specs; ++s)
+    {
+      const SolveResult* result = &results[(size_t)p * n_specs + s];
+      if(result->info == 0 && result->time < best) best = result->time;
+    }
+    for(int s = 0; s < n_specs; ++s)
+    {
+      const SolveResult* result = &results[(size_t)p * n_specs + s];
+      ratios[(size_t)p * n_specs + s] =
+        (result->info == 0 && best > 0.) ? result->time / best : INFINITY;
+    }
+  }
+
+  static const double taus[] = {1., 1.5, 2., 4., 8., 16., 64.};
+  const int n_taus = (int)(sizeof(taus) / sizeof(taus[0]));
+
+  printf("#\n# performance profile rho(tau)\n");
+  printf("# %-24s solved", "configuration");
+  for(int t = 0; t < n_taus; ++t) printf("  tau=%-4g", taus[t]);
+  printf("\n");
+  for(int s = 0; s < n_specs; ++s)
+  {
+    unsigned int solved = 0;
+    for(unsigned int p = 0; p < n_problems; ++p)
+      if(results[(size_t)p * n_specs + s].info == 0) ++solved;
+    printf("# %-24s %3u/%-3u", specs[s].spec, solved, n_problems);
+    for(int t = 0; t < n_taus; ++t)
+    {
+      unsigned int within = 0;
+      for(unsigned int p = 0; p < n_problems; ++p)
+        if(ratios[(size_t)p * n_specs + s] <= taus[t]) ++within;
+      printf("  %7.3f", n_problems ? (double)within / n_problems : 0.);
+    }
+    printf("\n");
+  }
+  printf("# total wall time: %g s\n", total_time);
+
+  free(ratios);
+  free(tasks);
+  free(results);
+  free(specs);
+  frictionContact_corpus_close(corpus);
+  return 0;
+}
@@ -0,0 +1,66 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* Pack friction-contact problems stored as ASCII dumps (the format of
+   frictionContact_printInFile) into one binary corpus file (see
+   FrictionContactCorpus.h):
+
+     fc_corpus_builder corpus.fcc problem1.dat problem2.dat ...
+*/
+
+#include <stdio.h>                   // for fprintf, stderr
+
+#include "FrictionContactCorpus.h"   // for frictionContact_corpus_writer_open
+#include "FrictionContactProblem.h"  // for frictionContact_new_from_filename
+
+int main(int argc, char* argv[])
+{
+  if(argc < 3)
+  {
+    fprintf(stderr, "usage: %s <corpus file> <problem.dat> ...\n", argv[0]);
+    return 2;
+  }
+
+  FrictionContactCorpusWriter* writer = frictionContact_corpus_writer_open(argv[1]);
+  if(!writer)
+  {
+    fprintf(stderr, "%s: cannot create %s\n", argv[0], argv[1]);
+    return 2;
+  }
+
+  int packed = 0;
+  for(int k = 2; k < argc; ++k)
+  {
+    FrictionContactProblem* problem = frictionContact_new_from_filename(argv[k]);
+    if(!problem)
+    {
+      fprintf(stderr, "%s: cannot read %s, skipped\n", argv[0], argv[k]);
+      continue;
+    }
+    if(frictionContact_corpus_writer_add(writer, problem))
+      fprintf(stderr, "%s: cannot pack %s, skipped\n", argv[0], argv[k]);
+    else
+      ++packed;
+    frictionContactProblem_free(problem);
+  }
+
+  int info = frictionContact_corpus_writer_close(writer);
+  if(!info)
+    fprintf(stderr, "%s: %i problems packed into %s\n", argv[0], packed, argv[1]);
+  return info;
+}
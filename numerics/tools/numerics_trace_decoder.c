@@ -0,0 +1,49 @@
+/* Siconos is a program dedicated to modeling, simulation and control
+ * of non smooth dynamical systems.
+ *
+ * Copyright 2022 INRIA.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/* Decode a binary solver trace (see NumericsTrace.h, produced by running
+   with SICONOS_TRACE_FILE set) to CSV on stdout:
+
+     numerics_trace_decoder trace.bin > trace.csv
+*/
+
+#include <stdio.h>          // for fopen, fprintf, stdout
+#include <string.h>         // for strcmp
+#include "NumericsTrace.h"  // for numerics_trace_decode
+
+int main(int argc, char* argv[])
+{
+  if(argc != 2)
+  {
+    fprintf(stderr, "usage: %s <trace file | ->\n", argv[0]);
+    return 2;
+  }
+
+  FILE* input = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "rb");
+  if(!input)
+  {
+    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+    return 2;
+  }
+
+  int info = numerics_trace_decode(input, stdout);
+  if(info)
+    fprintf(stderr, "%s: %s is not a readable trace file\n", argv[0], argv[1]);
+  if(input != stdin) fclose(input);
+  return info;
+}
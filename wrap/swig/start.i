@@ -2,6 +2,15 @@
 // docstrings are generated from doxygen using swig option -doxygen.
 // Do not use %feature("autodoc", 3) !!
 
+// Enable the python thread machinery: some long-running calls (the
+// simulation stepping in kernel.i, the drivers in numerics.i) release
+// the GIL, and the director glue then re-acquires it before any
+// callback into Python. This define must come before the swig runtime,
+// hence the "begin" section.
+%insert("begin") %{
+#define SWIG_PYTHON_THREADS
+%}
+
 // named parameters (broken with overloaded function)
 // %feature("kwargs");
 